@@ -46,7 +46,7 @@ LOG_MODULE_REGISTER(LOG_MODULE_NAME);
 #endif
 
 struct eth_context {
-	uint8_t recv[NET_ETH_MTU + ETH_HDR_LEN];
+	uint8_t recv[CONFIG_ETH_NATIVE_POSIX_RX_BATCH][NET_ETH_MTU + ETH_HDR_LEN];
 	uint8_t send[NET_ETH_MTU + ETH_HDR_LEN];
 	uint8_t mac_addr[6];
 	struct net_linkaddr ll_addr;
@@ -66,6 +66,10 @@ struct eth_context {
 #if defined(CONFIG_ETH_NATIVE_POSIX_PTP_CLOCK)
 	const struct device *ptp_clock;
 #endif
+#if defined(CONFIG_ETH_NATIVE_POSIX_VNET_HDR)
+	struct eth_vnet_hdr recv_vnet[CONFIG_ETH_NATIVE_POSIX_RX_BATCH];
+	struct eth_vnet_hdr send_vnet;
+#endif
 };
 
 #define DEFINE_RX_THREAD(x, _)						\
@@ -178,6 +182,192 @@ static void update_gptp(struct net_if *iface, struct net_pkt *pkt,
 #define update_gptp(iface, pkt, send)
 #endif /* CONFIG_NET_GPTP */
 
+#if defined(CONFIG_ETH_NATIVE_POSIX_VNET_HDR)
+static uint32_t vnet_csum_add(uint32_t sum, const uint8_t *data, size_t len)
+{
+	while (len > 1) {
+		sum += sys_get_be16(data);
+		data += 2;
+		len -= 2;
+	}
+
+	if (len) {
+		sum += (uint32_t)data[0] << 8;
+	}
+
+	return sum;
+}
+
+static uint16_t vnet_csum_fold(uint32_t sum)
+{
+	while (sum >> 16) {
+		sum = (sum & 0xffff) + (sum >> 16);
+	}
+
+	return sum;
+}
+
+/* As the interface advertises TX checksum offload, the IP stack leaves
+ * the IPv4 header and the upper layer checksums empty. Calculate the
+ * IPv4 header checksum here (it is short) and let the host kernel do
+ * the expensive part: seed the upper layer checksum field with the
+ * pseudo header sum and describe where the checksum lives in the
+ * virtio-net header.
+ */
+static void vnet_prepare_tx(uint8_t *frame, size_t len,
+			    struct eth_vnet_hdr *vnet)
+{
+	struct net_eth_hdr *eth_hdr = (struct net_eth_hdr *)frame;
+	size_t l3 = sizeof(struct net_eth_hdr);
+	uint16_t type = ntohs(eth_hdr->type);
+	size_t l4, l4_len;
+	uint32_t sum;
+	uint8_t proto;
+
+	(void)memset(vnet, 0, sizeof(*vnet));
+
+#if defined(CONFIG_NET_VLAN)
+	if (type == NET_ETH_PTYPE_VLAN) {
+		struct net_eth_vlan_hdr *vlan_hdr =
+			(struct net_eth_vlan_hdr *)frame;
+
+		l3 = sizeof(struct net_eth_vlan_hdr);
+		type = ntohs(vlan_hdr->type);
+	}
+#endif
+
+	if (IS_ENABLED(CONFIG_NET_IPV4) && type == NET_ETH_PTYPE_IP) {
+		struct net_ipv4_hdr *hdr = (struct net_ipv4_hdr *)(frame + l3);
+		size_t hdr_len;
+
+		if (len < l3 + sizeof(struct net_ipv4_hdr)) {
+			return;
+		}
+
+		hdr_len = (hdr->vhl & 0x0f) * 4U;
+		if (hdr_len < sizeof(struct net_ipv4_hdr) ||
+		    len < l3 + hdr_len || ntohs(hdr->len) < hdr_len) {
+			return;
+		}
+
+		hdr->chksum = 0U;
+		hdr->chksum = htons(~vnet_csum_fold(
+				vnet_csum_add(0, (uint8_t *)hdr, hdr_len)));
+
+		/* Fragments cannot be checksummed by the host */
+		if (sys_get_be16(hdr->offset) & 0x3fff) {
+			return;
+		}
+
+		proto = hdr->proto;
+		l4 = l3 + hdr_len;
+		l4_len = ntohs(hdr->len) - hdr_len;
+
+		if (proto == IPPROTO_ICMP) {
+			sum = 0U;
+		} else {
+			sum = vnet_csum_add(proto + l4_len, hdr->src,
+					    2 * sizeof(struct in_addr));
+		}
+	} else if (IS_ENABLED(CONFIG_NET_IPV6) && type == NET_ETH_PTYPE_IPV6) {
+		struct net_ipv6_hdr *hdr = (struct net_ipv6_hdr *)(frame + l3);
+
+		if (len < l3 + sizeof(struct net_ipv6_hdr)) {
+			return;
+		}
+
+		proto = hdr->nexthdr;
+		l4 = l3 + sizeof(struct net_ipv6_hdr);
+		l4_len = ntohs(hdr->len);
+
+		/* Skip the extension headers, give up on fragments */
+		while (proto == NET_IPV6_NEXTHDR_HBHO ||
+		       proto == NET_IPV6_NEXTHDR_DESTO ||
+		       proto == NET_IPV6_NEXTHDR_ROUTING) {
+			size_t ext_len;
+
+			if (len < l4 + 2) {
+				return;
+			}
+
+			ext_len = (frame[l4 + 1] + 1U) * 8U;
+			if (ext_len > l4_len) {
+				return;
+			}
+
+			proto = frame[l4];
+			l4 += ext_len;
+			l4_len -= ext_len;
+		}
+
+		sum = vnet_csum_add(proto + l4_len, hdr->src,
+				    2 * sizeof(struct in6_addr));
+	} else {
+		return;
+	}
+
+	switch (proto) {
+	case IPPROTO_TCP:
+		vnet->csum_offset = offsetof(struct net_tcp_hdr, chksum);
+		break;
+	case IPPROTO_UDP:
+		vnet->csum_offset = offsetof(struct net_udp_hdr, chksum);
+		break;
+	case IPPROTO_ICMP:
+	case IPPROTO_ICMPV6:
+		vnet->csum_offset = offsetof(struct net_icmp_hdr, chksum);
+		break;
+	default:
+		return;
+	}
+
+	if (len < l4 + vnet->csum_offset + sizeof(uint16_t)) {
+		vnet->csum_offset = 0U;
+		return;
+	}
+
+	sys_put_be16(vnet_csum_fold(sum), frame + l4 + vnet->csum_offset);
+
+	vnet->flags = ETH_VNET_HDR_F_NEEDS_CSUM;
+	vnet->csum_start = l4;
+}
+
+/* Frames generated on the host may arrive with only the pseudo header sum
+ * in the checksum field, finish the checksum from csum_start to the end
+ * of the frame. Returns true if the checksum of the frame can be trusted.
+ */
+static bool vnet_prepare_rx(uint8_t *frame, size_t len,
+			    const struct eth_vnet_hdr *vnet)
+{
+	size_t start = vnet->csum_start;
+	size_t offset = start + vnet->csum_offset;
+	uint16_t sum;
+
+	if (vnet->flags & ETH_VNET_HDR_F_DATA_VALID) {
+		return true;
+	}
+
+	if (!(vnet->flags & ETH_VNET_HDR_F_NEEDS_CSUM)) {
+		return false;
+	}
+
+	if (len < offset + sizeof(uint16_t)) {
+		return false;
+	}
+
+	sum = ~vnet_csum_fold(vnet_csum_add(0, frame + start, len - start));
+	if (sum == 0U &&
+	    vnet->csum_offset == offsetof(struct net_udp_hdr, chksum)) {
+		/* Zero means no checksum for UDP */
+		sum = 0xffff;
+	}
+
+	sys_put_be16(sum, frame + offset);
+
+	return true;
+}
+#endif /* CONFIG_ETH_NATIVE_POSIX_VNET_HDR */
+
 static int eth_send(const struct device *dev, struct net_pkt *pkt)
 {
 	struct eth_context *ctx = dev->data;
@@ -193,7 +383,14 @@ static int eth_send(const struct device *dev, struct net_pkt *pkt)
 
 	LOG_DBG("Send pkt %p len %d", pkt, count);
 
+#if defined(CONFIG_ETH_NATIVE_POSIX_VNET_HDR)
+	vnet_prepare_tx(ctx->send, count, &ctx->send_vnet);
+
+	ret = eth_write_vnet_data(ctx->dev_fd, &ctx->send_vnet, ctx->send,
+				  count);
+#else
 	ret = eth_write_data(ctx->dev_fd, ctx->send, count);
+#endif
 	if (ret < 0) {
 		LOG_DBG("Cannot send pkt %p (%d)", pkt, ret);
 	}
@@ -228,24 +425,30 @@ static inline struct net_if *get_iface(struct eth_context *ctx,
 #endif
 }
 
-#if defined(CONFIG_NET_VLAN)
-static struct net_pkt *prepare_vlan_pkt(struct eth_context *ctx,
-					int count, uint16_t *vlan_tag, int *status)
+/* Length of the packet built from a received frame */
+static int rx_pkt_len(const uint8_t *frame, int count)
 {
-	struct net_eth_vlan_hdr *hdr = (struct net_eth_vlan_hdr *)ctx->recv;
-	struct net_pkt *pkt;
-	uint8_t pos;
+#if defined(CONFIG_NET_VLAN)
+	const struct net_eth_hdr *hdr = (const struct net_eth_hdr *)frame;
 
-	if (IS_ENABLED(CONFIG_ETH_NATIVE_POSIX_VLAN_TAG_STRIP)) {
-		count -= NET_ETH_VLAN_HDR_SIZE;
+	if (IS_ENABLED(CONFIG_ETH_NATIVE_POSIX_VLAN_TAG_STRIP) &&
+	    ntohs(hdr->type) == NET_ETH_PTYPE_VLAN) {
+		return count - NET_ETH_VLAN_HDR_SIZE;
 	}
+#else
+	ARG_UNUSED(frame);
+#endif
 
-	pkt = net_pkt_rx_alloc_with_buffer(ctx->iface, count,
-					   AF_UNSPEC, 0, NET_BUF_TIMEOUT);
-	if (!pkt) {
-		*status = -ENOMEM;
-		return NULL;
-	}
+	return count;
+}
+
+#if defined(CONFIG_NET_VLAN)
+static int prepare_vlan_pkt(struct net_pkt *pkt, const uint8_t *frame,
+			    int count, uint16_t *vlan_tag)
+{
+	const struct net_eth_vlan_hdr *hdr =
+		(const struct net_eth_vlan_hdr *)frame;
+	uint8_t pos;
 
 	net_pkt_set_vlan_tci(pkt, ntohs(hdr->vlan.tci));
 	*vlan_tag = net_pkt_vlan_tag(pkt);
@@ -253,17 +456,17 @@ static struct net_pkt *prepare_vlan_pkt(struct eth_context *ctx,
 	pos = 0;
 
 	if (IS_ENABLED(CONFIG_ETH_NATIVE_POSIX_VLAN_TAG_STRIP)) {
-		if (net_pkt_write(pkt, ctx->recv,
+		if (net_pkt_write(pkt, frame,
 				  2 * sizeof(struct net_eth_addr))) {
-			goto error;
+			return -ENOBUFS;
 		}
 
 		pos = (2 * sizeof(struct net_eth_addr)) + NET_ETH_VLAN_HDR_SIZE;
-		count -= (2 * sizeof(struct net_eth_addr));
+		count -= pos;
 	}
 
-	if (net_pkt_write(pkt, ctx->recv + pos, count)) {
-		goto error;
+	if (net_pkt_write(pkt, frame + pos, count)) {
+		return -ENOBUFS;
 	}
 
 #if CONFIG_NET_TC_RX_COUNT > 1
@@ -275,93 +478,128 @@ static struct net_pkt *prepare_vlan_pkt(struct eth_context *ctx,
 	}
 #endif
 
-	*status = 0;
-
 	LOG_DBG("Recv pkt %p len %d", pkt, count);
 
-	return pkt;
-
-error:
-	net_pkt_unref(pkt);
-	*status = -ENOBUFS;
-	return NULL;
+	return 0;
 }
 #endif
 
-static struct net_pkt *prepare_non_vlan_pkt(struct eth_context *ctx,
-					    int count, int *status)
+static int prepare_non_vlan_pkt(struct net_pkt *pkt, const uint8_t *frame,
+				int count)
 {
-	struct net_pkt *pkt;
-
-	pkt = net_pkt_rx_alloc_with_buffer(ctx->iface, count,
-					   AF_UNSPEC, 0, NET_BUF_TIMEOUT);
-	if (!pkt) {
-		*status = -ENOMEM;
-		return NULL;
-	}
-
-	if (net_pkt_write(pkt, ctx->recv, count)) {
-		net_pkt_unref(pkt);
-		*status = -ENOBUFS;
-		return NULL;
+	if (net_pkt_write(pkt, frame, count)) {
+		return -ENOBUFS;
 	}
 
-	*status = 0;
-
 	LOG_DBG("Recv pkt %p len %d", pkt, count);
 
-	return pkt;
+	return 0;
 }
 
-static int read_data(struct eth_context *ctx, int fd)
+/* Fill the packet allocated for frame number idx and pass it to the stack */
+static int recv_frame(struct eth_context *ctx, struct net_pkt *pkt, int idx,
+		      int count)
 {
 	uint16_t vlan_tag = NET_VLAN_TAG_UNSPEC;
+	uint8_t *frame = ctx->recv[idx];
+	bool chksum_valid = false;
 	struct net_if *iface;
-	struct net_pkt *pkt = NULL;
 	int status;
-	int count;
 
-	count = eth_read_data(fd, ctx->recv, sizeof(ctx->recv));
-	if (count <= 0) {
-		return 0;
-	}
+#if defined(CONFIG_ETH_NATIVE_POSIX_VNET_HDR)
+	chksum_valid = vnet_prepare_rx(frame, count, &ctx->recv_vnet[idx]);
+#endif
 
 #if defined(CONFIG_NET_VLAN)
 	{
-		struct net_eth_hdr *hdr = (struct net_eth_hdr *)(ctx->recv);
+		const struct net_eth_hdr *hdr = (const struct net_eth_hdr *)frame;
 
 		if (ntohs(hdr->type) == NET_ETH_PTYPE_VLAN) {
-			pkt = prepare_vlan_pkt(ctx, count, &vlan_tag, &status);
-			if (!pkt) {
-				return status;
-			}
+			status = prepare_vlan_pkt(pkt, frame, count, &vlan_tag);
 		} else {
-			pkt = prepare_non_vlan_pkt(ctx, count, &status);
-			if (!pkt) {
-				return status;
-			}
-
+			status = prepare_non_vlan_pkt(pkt, frame, count);
 			net_pkt_set_vlan_tci(pkt, 0);
 		}
 	}
 #else
-	{
-		pkt = prepare_non_vlan_pkt(ctx, count, &status);
-		if (!pkt) {
-			return status;
-		}
-	}
+	status = prepare_non_vlan_pkt(pkt, frame, count);
 #endif
+	if (status < 0) {
+		net_pkt_unref(pkt);
+		return status;
+	}
 
 	iface = get_iface(ctx, vlan_tag);
 
+	net_pkt_set_chksum_valid(pkt, chksum_valid);
+
 	update_gptp(iface, pkt, false);
 
 	if (net_recv_data(iface, pkt) < 0) {
 		net_pkt_unref(pkt);
 	}
 
-	return 0;
+	return count;
+}
+
+/* Read up to CONFIG_ETH_NATIVE_POSIX_RX_BATCH frames and allocate their
+ * packets with a single bulk allocation. Returns the number of frames read.
+ */
+static int read_data(struct eth_context *ctx, int fd)
+{
+	struct net_pkt *pkts[CONFIG_ETH_NATIVE_POSIX_RX_BATCH];
+	size_t sizes[CONFIG_ETH_NATIVE_POSIX_RX_BATCH];
+	int counts[CONFIG_ETH_NATIVE_POSIX_RX_BATCH];
+	int allocated;
+	int frames;
+	int count;
+	int i;
+
+	for (frames = 0; frames < CONFIG_ETH_NATIVE_POSIX_RX_BATCH; frames++) {
+#if defined(CONFIG_ETH_NATIVE_POSIX_VNET_HDR)
+		count = eth_read_vnet_data(fd, &ctx->recv_vnet[frames],
+					   ctx->recv[frames],
+					   sizeof(ctx->recv[frames]));
+#else
+		count = eth_read_data(fd, ctx->recv[frames],
+				      sizeof(ctx->recv[frames]));
+#endif
+		if (count <= 0) {
+			break;
+		}
+
+		counts[frames] = count;
+		sizes[frames] = rx_pkt_len(ctx->recv[frames], count);
+	}
+
+	if (!frames) {
+		return 0;
+	}
+
+	allocated = net_pkt_rx_alloc_bulk_with_buffer(ctx->iface, pkts, sizes,
+						      frames, AF_UNSPEC, 0,
+						      NET_BUF_TIMEOUT);
+
+	/* The bulk allocation waits only for the first packet, give the
+	 * rest the same time to get a packet as a single frame would get.
+	 */
+	for (i = allocated; i < frames; i++) {
+		pkts[i] = net_pkt_rx_alloc_with_buffer(ctx->iface, sizes[i],
+						       AF_UNSPEC, 0,
+						       NET_BUF_TIMEOUT);
+	}
+
+	for (i = 0; i < frames; i++) {
+		if (!pkts[i]) {
+			LOG_DBG("Dropping frame %d, out of packets", i);
+			eth_stats_update_errors_rx(ctx->iface);
+			continue;
+		}
+
+		(void)recv_frame(ctx, pkts[i], i, counts[i]);
+	}
+
+	return frames;
 }
 
 static void eth_rx(struct eth_context *ctx)
@@ -371,7 +609,12 @@ static void eth_rx(struct eth_context *ctx)
 	while (1) {
 		if (net_if_is_up(ctx->iface)) {
 			while (!eth_wait_data(ctx->dev_fd)) {
-				read_data(ctx, ctx->dev_fd);
+				/* Drain several frames before letting the
+				 * other threads run, this way we do not need
+				 * to poll the host for every single frame.
+				 */
+				(void)read_data(ctx, ctx->dev_fd);
+
 				k_yield();
 			}
 		}
@@ -505,6 +748,9 @@ enum ethernet_hw_caps eth_posix_native_get_capabilities(const struct device *dev
 #endif
 #if defined(CONFIG_NET_LLDP)
 		| ETHERNET_LLDP
+#endif
+#if defined(CONFIG_ETH_NATIVE_POSIX_VNET_HDR)
+		| ETHERNET_HW_TX_CHKSUM_OFFLOAD
 #endif
 		;
 }
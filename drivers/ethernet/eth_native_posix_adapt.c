@@ -23,12 +23,14 @@
 #include <sys/ioctl.h>
 #include <sys/socket.h>
 #include <sys/select.h>
+#include <sys/uio.h>
 #include <net/if.h>
 #include <time.h>
 #include <zephyr/arch/posix/posix_trace.h>
 
 #ifdef __linux
 #include <linux/if_tun.h>
+#include <linux/virtio_net.h>
 #endif
 
 /* Zephyr include files. Be very careful here and only include minimum
@@ -49,6 +51,13 @@ LOG_MODULE_REGISTER(LOG_MODULE_NAME);
 
 #include "eth_native_posix_priv.h"
 
+#if defined(CONFIG_ETH_NATIVE_POSIX_VNET_HDR) && defined(__linux)
+BUILD_ASSERT(sizeof(struct eth_vnet_hdr) == sizeof(struct virtio_net_hdr),
+	     "eth_vnet_hdr does not match virtio_net_hdr");
+BUILD_ASSERT(ETH_VNET_HDR_F_NEEDS_CSUM == VIRTIO_NET_HDR_F_NEEDS_CSUM);
+BUILD_ASSERT(ETH_VNET_HDR_F_DATA_VALID == VIRTIO_NET_HDR_F_DATA_VALID);
+#endif
+
 /* Note that we cannot create the TUN/TAP device from the setup script
  * as we need to get a file descriptor to communicate with the interface.
  */
@@ -67,6 +76,10 @@ int eth_iface_create(const char *if_name, bool tun_only)
 #ifdef __linux
 	ifr.ifr_flags = (tun_only ? IFF_TUN : IFF_TAP) | IFF_NO_PI;
 
+	if (IS_ENABLED(CONFIG_ETH_NATIVE_POSIX_VNET_HDR)) {
+		ifr.ifr_flags |= IFF_VNET_HDR;
+	}
+
 	strncpy(ifr.ifr_name, if_name, IFNAMSIZ - 1);
 
 	ret = ioctl(fd, TUNSETIFF, (void *)&ifr);
@@ -75,6 +88,41 @@ int eth_iface_create(const char *if_name, bool tun_only)
 		close(fd);
 		return ret;
 	}
+
+	/* When reading several frames per wakeup, the last read must
+	 * not block the whole process if there is no more data.
+	 */
+	if (CONFIG_ETH_NATIVE_POSIX_RX_BATCH > 1) {
+		ret = fcntl(fd, F_GETFL);
+		if (ret < 0 || fcntl(fd, F_SETFL, ret | O_NONBLOCK) < 0) {
+			ret = -errno;
+			close(fd);
+			return ret;
+		}
+	}
+
+#if defined(CONFIG_ETH_NATIVE_POSIX_VNET_HDR)
+	{
+		int hdr_len = sizeof(struct eth_vnet_hdr);
+
+		ret = ioctl(fd, TUNSETVNETHDRSZ, &hdr_len);
+		if (ret < 0) {
+			ret = -errno;
+			close(fd);
+			return ret;
+		}
+
+		/* Allow the host to pass us frames with partial checksum.
+		 * This is not fatal, the host will then checksum the frames
+		 * itself before handing them to us.
+		 */
+		ret = ioctl(fd, TUNSETOFFLOAD, TUN_F_CSUM);
+		if (ret < 0) {
+			LOG_WRN("Cannot enable checksum offload on %s (%d)",
+				if_name, -errno);
+		}
+	}
+#endif
 #endif
 
 	return fd;
@@ -175,6 +223,42 @@ ssize_t eth_write_data(int fd, void *buf, size_t buf_len)
 	return write(fd, buf, buf_len);
 }
 
+#if defined(CONFIG_ETH_NATIVE_POSIX_VNET_HDR)
+ssize_t eth_read_vnet_data(int fd, struct eth_vnet_hdr *hdr,
+			   void *buf, size_t buf_len)
+{
+	struct iovec iov[2] = {
+		{ .iov_base = hdr, .iov_len = sizeof(*hdr) },
+		{ .iov_base = buf, .iov_len = buf_len },
+	};
+	ssize_t ret;
+
+	ret = readv(fd, iov, 2);
+	if (ret < (ssize_t)sizeof(*hdr)) {
+		return ret < 0 ? ret : 0;
+	}
+
+	return ret - sizeof(*hdr);
+}
+
+ssize_t eth_write_vnet_data(int fd, struct eth_vnet_hdr *hdr,
+			    void *buf, size_t buf_len)
+{
+	struct iovec iov[2] = {
+		{ .iov_base = hdr, .iov_len = sizeof(*hdr) },
+		{ .iov_base = buf, .iov_len = buf_len },
+	};
+	ssize_t ret;
+
+	ret = writev(fd, iov, 2);
+	if (ret < (ssize_t)sizeof(*hdr)) {
+		return ret;
+	}
+
+	return ret - sizeof(*hdr);
+}
+#endif /* CONFIG_ETH_NATIVE_POSIX_VNET_HDR */
+
 #if defined(CONFIG_NET_GPTP)
 int eth_clock_gettime(struct net_ptp_time *time)
 {
@@ -25,6 +25,28 @@
 #define ETH_NATIVE_POSIX_STARTUP_SCRIPT_USER ""
 #endif
 
+#if defined(CONFIG_ETH_NATIVE_POSIX_VNET_HDR)
+/* Same layout as struct virtio_net_hdr of the host. It precedes every
+ * frame read from or written to the TAP device.
+ */
+struct eth_vnet_hdr {
+	uint8_t flags;
+	uint8_t gso_type;
+	uint16_t hdr_len;
+	uint16_t gso_size;
+	uint16_t csum_start;
+	uint16_t csum_offset;
+};
+
+#define ETH_VNET_HDR_F_NEEDS_CSUM 1
+#define ETH_VNET_HDR_F_DATA_VALID 2
+
+ssize_t eth_read_vnet_data(int fd, struct eth_vnet_hdr *hdr,
+			   void *buf, size_t buf_len);
+ssize_t eth_write_vnet_data(int fd, struct eth_vnet_hdr *hdr,
+			    void *buf, size_t buf_len);
+#endif
+
 int eth_iface_create(const char *if_name, bool tun_only);
 int eth_iface_remove(int fd);
 int eth_setup_host(const char *if_name);
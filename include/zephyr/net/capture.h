@@ -192,8 +192,170 @@ static inline int net_capture_send(const struct device *dev, struct net_if *ifac
 #endif
 }
 
+/**
+ * @brief Statistics of the capture ring
+ */
+struct net_capture_ring_stats {
+	/** Number of packets stored in the ring */
+	uint32_t captured;
+	/** Number of packets rejected by the capture filter */
+	uint32_t filtered;
+	/** Number of packets dropped because the ring was full */
+	uint32_t dropped;
+	/** Number of captured packets truncated to the snapshot length */
+	uint32_t truncated;
+};
+
+/**
+ * @typedef net_capture_ring_write_cb_t
+ * @brief Callback receiving the pcapng data drained from the capture ring.
+ *
+ * @param data Pointer to one or more complete pcapng blocks
+ * @param len Length of the data
+ * @param user_data A valid pointer to user data or NULL
+ *
+ * @return 0 if ok, <0 to stop draining the ring
+ */
+typedef int (*net_capture_ring_write_cb_t)(const void *data, size_t len, void *user_data);
+
+struct npf_rule_list;
+
+/**
+ * @brief Start capturing network packets to the capture ring.
+ *
+ * @details The captured packets are stored as pcapng Enhanced Packet Blocks
+ * in a ring buffer, without cloning the network packets. Any data left
+ * in the ring from a previous capture is discarded.
+ *
+ * @param iface Network interface we are starting to capture packets.
+ * @param filter Packet filter rule list selecting the packets to capture,
+ *        or NULL to capture all the packets. The rule list is evaluated
+ *        before the packet is copied and must stay valid until the
+ *        capture is disabled. Requires CONFIG_NET_PKT_FILTER.
+ *
+ * @return 0 if ok, <0 if the capture ring could not be enabled
+ */
+#if defined(CONFIG_NET_CAPTURE_RING)
+int net_capture_ring_enable(struct net_if *iface, struct npf_rule_list *filter);
+#else
+static inline int net_capture_ring_enable(struct net_if *iface,
+					  struct npf_rule_list *filter)
+{
+	ARG_UNUSED(iface);
+	ARG_UNUSED(filter);
+
+	return -ENOTSUP;
+}
+#endif
+
+/**
+ * @brief Stop capturing network packets to the capture ring.
+ *
+ * @details The packets already in the ring can still be drained.
+ *
+ * @return 0 if ok, <0 if the capture ring could not be disabled
+ */
+#if defined(CONFIG_NET_CAPTURE_RING)
+int net_capture_ring_disable(void);
+#else
+static inline int net_capture_ring_disable(void)
+{
+	return -ENOTSUP;
+}
+#endif
+
+/**
+ * @brief Drain the capture ring.
+ *
+ * @details The pcapng Section Header and Interface Description blocks are
+ * passed to the callback first after the capture ring has been enabled,
+ * followed by one Enhanced Packet Block per captured packet. There can be
+ * only one reader of the capture ring at a time.
+ *
+ * @param cb Callback receiving the pcapng data
+ * @param user_data User supplied data
+ *
+ * @return Number of bytes passed to the callback, <0 if the callback
+ *         failed
+ */
+#if defined(CONFIG_NET_CAPTURE_RING)
+int net_capture_ring_drain(net_capture_ring_write_cb_t cb, void *user_data);
+#else
+static inline int net_capture_ring_drain(net_capture_ring_write_cb_t cb,
+					 void *user_data)
+{
+	ARG_UNUSED(cb);
+	ARG_UNUSED(user_data);
+
+	return -ENOTSUP;
+}
+#endif
+
+/**
+ * @brief Get the statistics of the capture ring.
+ *
+ * @details The statistics are reset when the capture ring is enabled.
+ *
+ * @param stats Statistics of the capture ring. Filled by the function.
+ *
+ * @return 0 if ok, <0 if the statistics are not available
+ */
+#if defined(CONFIG_NET_CAPTURE_RING)
+int net_capture_ring_get_stats(struct net_capture_ring_stats *stats);
+#else
+static inline int net_capture_ring_get_stats(struct net_capture_ring_stats *stats)
+{
+	ARG_UNUSED(stats);
+
+	return -ENOTSUP;
+}
+#endif
+
+/**
+ * @brief Start writing the capture ring to a pcapng file.
+ *
+ * @details The capture ring is periodically drained to the file from the
+ * system work queue, so the application must not drain it itself until
+ * net_capture_ring_file_close() is called. An existing file is overwritten.
+ *
+ * @param path Path of the capture file
+ *
+ * @return 0 if ok, <0 if the file could not be opened
+ */
+#if defined(CONFIG_NET_CAPTURE_RING_FILE)
+int net_capture_ring_file_open(const char *path);
+#else
+static inline int net_capture_ring_file_open(const char *path)
+{
+	ARG_UNUSED(path);
+
+	return -ENOTSUP;
+}
+#endif
+
+/**
+ * @brief Stop writing the capture ring to the pcapng file.
+ *
+ * @details The data left in the capture ring is written to the file before
+ * it is closed.
+ *
+ * @return 0 if ok, <0 if writing or closing the file failed
+ */
+#if defined(CONFIG_NET_CAPTURE_RING_FILE)
+int net_capture_ring_file_close(void);
+#else
+static inline int net_capture_ring_file_close(void)
+{
+	return -ENOTSUP;
+}
+#endif
+
 /** @cond INTERNAL_HIDDEN */
 
+#if defined(CONFIG_NET_CAPTURE_RING)
+void net_capture_ring_pkt(struct net_if *iface, struct net_pkt *pkt);
+#endif
+
 /**
  * @brief Check if the network packet needs to be captured or not.
  *        This is called for every network packet being sent.
@@ -525,6 +525,116 @@ int coap_handle_request(struct coap_packet *cpkt,
 			uint8_t opt_num,
 			struct sockaddr *addr, socklen_t addr_len);
 
+/**
+ * @brief Node of a CoAP resource trie.
+ *
+ * The nodes are kept in an open addressing hash table indexed by the
+ * parent node and the path segment, so that every level of the trie
+ * is found with a single lookup. The fields are internal to the trie.
+ */
+struct coap_resource_trie_node {
+	/** Path segment of the node, NULL if the slot is free */
+	const char *segment;
+	/** Length of the path segment */
+	uint16_t len;
+	/** Slot of the parent node, or COAP_RESOURCE_TRIE_ROOT */
+	uint16_t parent;
+	/** Index of the resource ending at this node plus one, or 0 */
+	uint16_t resource;
+};
+
+/** Parent of the nodes for the first path segment */
+#define COAP_RESOURCE_TRIE_ROOT UINT16_MAX
+
+/**
+ * @brief Number of trie nodes to allocate for a resource tree.
+ *
+ * Keeps the hash table at most half full, for short probe sequences.
+ *
+ * @param segments Number of distinct path prefixes of all resources,
+ *        at most the total number of path segments.
+ */
+#define COAP_RESOURCE_TRIE_NODES(segments) (2 * (segments) + 1)
+
+/**
+ * @brief Prebuilt index of an array of CoAP resources.
+ *
+ * Lookups take time in proportion to the depth of the requested path,
+ * instead of the number of resources.
+ */
+struct coap_resource_trie {
+	/** Indexed resources, terminated by an entry with a NULL path */
+	struct coap_resource *resources;
+	/** Hash table of the nodes */
+	struct coap_resource_trie_node *nodes;
+	/** Size of the hash table */
+	uint16_t max_nodes;
+	/** Number of used nodes */
+	uint16_t num_nodes;
+	/** Index of the resource with the empty path plus one, or 0 */
+	uint16_t root_resource;
+	/** Set if any resource path contains a wildcard */
+	bool wildcards;
+};
+
+/**
+ * @brief Build the trie of an array of resources.
+ *
+ * The resources must not be added, removed or change their paths while the
+ * trie is used. When several resources match a request, the trie selects
+ * the first one in the array, as coap_handle_request() does.
+ *
+ * @param trie Trie to build
+ * @param resources Array of resources, terminated by an entry with a NULL path
+ * @param nodes Storage for the trie nodes
+ * @param max_nodes Number of nodes in the storage, see COAP_RESOURCE_TRIE_NODES()
+ *
+ * @retval 0 in case of success.
+ * @retval -EINVAL in case of invalid parameters or too many resources.
+ * @retval -ENOMEM in case the node storage is too small.
+ */
+int coap_resource_trie_init(struct coap_resource_trie *trie,
+			    struct coap_resource *resources,
+			    struct coap_resource_trie_node *nodes,
+			    size_t max_nodes);
+
+/**
+ * @brief Find the resource matching the Uri-Path options of a request.
+ *
+ * @param trie Trie built by coap_resource_trie_init()
+ * @param options Parsed options from coap_packet_parse()
+ * @param opt_num Number of options
+ *
+ * @return Matching resource, or NULL if no resource matches.
+ */
+struct coap_resource *coap_resource_trie_lookup(const struct coap_resource_trie *trie,
+						const struct coap_option *options,
+						uint8_t opt_num);
+
+/**
+ * @brief When a request is received, call the appropriate method of
+ * the matching resource, looked up in a resource trie.
+ *
+ * Equivalent to coap_handle_request() on the resources of the trie.
+ *
+ * @param cpkt Packet received
+ * @param trie Trie built by coap_resource_trie_init()
+ * @param options Parsed options from coap_packet_parse()
+ * @param opt_num Number of options
+ * @param addr Peer address
+ * @param addr_len Peer address length
+ *
+ * @retval 0 in case of success.
+ * @retval -ENOTSUP in case of invalid request code.
+ * @retval -EPERM in case resource handler is not implemented.
+ * @retval -ENOENT in case the resource is not found.
+ */
+int coap_handle_request_trie(struct coap_packet *cpkt,
+			     const struct coap_resource_trie *trie,
+			     struct coap_option *options,
+			     uint8_t opt_num,
+			     struct sockaddr *addr, socklen_t addr_len);
+
 /**
  * Represents the size of each block that will be transferred using
  * block-wise transfers [RFC7959]:
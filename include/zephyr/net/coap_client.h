@@ -78,12 +78,16 @@ struct coap_client_option {
 
 /** @cond INTERNAL_HIDDEN */
 struct coap_client_internal_request {
+	sys_snode_t queue_node;
 	uint8_t request_token[COAP_TOKEN_MAX_LEN];
 	uint32_t offset;
 	uint32_t last_id;
+	uint32_t send_time;
 	uint8_t request_tkl;
 	uint8_t retry_count;
+	uint8_t backoff;
 	bool request_ongoing;
+	bool outstanding;
 	struct coap_block_context recv_blk_ctx;
 	struct coap_block_context send_blk_ctx;
 	struct coap_pending pending;
@@ -100,6 +104,15 @@ struct coap_client {
 	uint8_t send_buf[MAX_COAP_MSG_LEN];
 	uint8_t recv_buf[MAX_COAP_MSG_LEN];
 	struct coap_client_internal_request requests[CONFIG_COAP_CLIENT_MAX_REQUESTS];
+	sys_slist_t send_queue;
+#if defined(CONFIG_COAP_CLIENT_COCOA)
+	struct coap_client_rtt_estimator {
+		uint32_t srtt;
+		uint32_t rttvar;
+	} strong, weak;
+	uint32_t rto;
+	uint32_t rto_updated;
+#endif
 };
 /** @endcond */
 
@@ -122,6 +135,8 @@ int coap_client_init(struct coap_client *client, const char *info);
  * otherwise the address should be set as NULL.
  * Once the callback is called with last block set as true, socket can be closed or
  * used for another query.
+ * A client keeps at most CONFIG_COAP_CLIENT_NSTART requests outstanding, further
+ * requests are queued and sent in order as the outstanding ones complete.
  *
  * @param client Client instance.
  * @param sock Open socket file descriptor.
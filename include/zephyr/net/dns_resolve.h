@@ -148,7 +148,8 @@ enum dns_resolve_status {
  *                     this case
  *  DNS_EAI_CANCELED   if the query was canceled manually or timeout happened
  *  DNS_EAI_FAIL       if the name cannot be resolved by the server
- *  DNS_EAI_NODATA     if there is no such name
+ *  DNS_EAI_NONAME     if there is no such name
+ *  DNS_EAI_NODATA     if the name has no address of the queried type
  *  other values means that an error happened.
  * @param info Query results are stored here.
  * @param user_data The user data given in dns_resolve_name() call.
@@ -446,6 +447,95 @@ static inline int dns_cancel_addr_info(uint16_t dns_id)
 	return dns_resolve_cancel(dns_resolve_get_default(), dns_id);
 }
 
+/**
+ * DNS answer cache statistics.
+ */
+struct dns_cache_stats {
+	/** Lookups answered from the cache, including negative answers */
+	uint32_t hits;
+	/** Lookups that were sent to a DNS server */
+	uint32_t misses;
+	/** Lookups answered by a cached negative answer */
+	uint32_t negative_hits;
+	/** Valid entries removed to make room for new answers */
+	uint32_t evictions;
+	/** Number of entries currently in the cache */
+	uint32_t entries;
+};
+
+/**
+ * Information about one cached DNS answer.
+ */
+struct dns_cache_info {
+	/** The name that was resolved */
+	const char *name;
+	/** Type of the query */
+	enum dns_query_type query_type;
+	/** 0 for a positive answer, DNS_EAI_NONAME or DNS_EAI_NODATA for a
+	 *  negative one
+	 */
+	int status;
+	/** Seconds until the answer expires */
+	uint32_t ttl;
+	/** Resolved addresses */
+	const struct sockaddr *addrs;
+	/** Number of resolved addresses */
+	int addr_count;
+};
+
+/**
+ * @typedef dns_cache_cb_t
+ * @brief Callback used while iterating over the DNS cache.
+ *
+ * @param info Cached answer.
+ * @param user_data A valid pointer to user data or NULL
+ */
+typedef void (*dns_cache_cb_t)(const struct dns_cache_info *info,
+			       void *user_data);
+
+#if defined(CONFIG_DNS_RESOLVER_CACHE) || defined(__DOXYGEN__)
+/**
+ * @brief Remove all the answers from the DNS cache.
+ *
+ * @details The cache is flushed automatically when the DNS servers of
+ * a context are changed with dns_resolve_reconfigure().
+ */
+void dns_cache_flush(void);
+
+/**
+ * @brief Go through all the valid answers in the DNS cache.
+ *
+ * @details The callback is called with the cache locked, so it must not
+ * call the DNS resolver.
+ *
+ * @param cb User-supplied callback function to call
+ * @param user_data User specified data
+ */
+void dns_cache_foreach(dns_cache_cb_t cb, void *user_data);
+
+/**
+ * @brief Get the DNS cache statistics.
+ *
+ * @param stats The statistics are copied here.
+ */
+void dns_cache_stats_get(struct dns_cache_stats *stats);
+#else
+static inline void dns_cache_flush(void)
+{
+}
+
+static inline void dns_cache_foreach(dns_cache_cb_t cb, void *user_data)
+{
+	ARG_UNUSED(cb);
+	ARG_UNUSED(user_data);
+}
+
+static inline void dns_cache_stats_get(struct dns_cache_stats *stats)
+{
+	memset(stats, 0, sizeof(*stats));
+}
+#endif /* CONFIG_DNS_RESOLVER_CACHE */
+
 /**
  * @}
  */
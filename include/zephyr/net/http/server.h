@@ -0,0 +1,169 @@
+/** @file
+ * @brief HTTP server API
+ *
+ * An API for applications to serve resources over HTTP/1.1
+ */
+
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef ZEPHYR_INCLUDE_NET_HTTP_SERVER_H_
+#define ZEPHYR_INCLUDE_NET_HTTP_SERVER_H_
+
+/**
+ * @brief HTTP server API
+ * @defgroup http_server HTTP server API
+ * @ingroup networking
+ * @{
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <zephyr/sys/util.h>
+#include <zephyr/net/http/method.h>
+#include <zephyr/net/http/service.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Types of the resources served by the HTTP server */
+enum http_resource_type {
+	/** Constant data, see @ref http_resource_detail_static */
+	HTTP_RESOURCE_TYPE_STATIC,
+	/** File of a file system, see @ref http_resource_detail_fs */
+	HTTP_RESOURCE_TYPE_FS,
+	/** Data produced at runtime, see @ref http_resource_detail_dynamic */
+	HTTP_RESOURCE_TYPE_DYNAMIC,
+};
+
+/**
+ * @brief Common part of the detail of every HTTP resource.
+ *
+ * The @p _detail of @ref HTTP_RESOURCE_DEFINE must point to one of the
+ * resource type specific structures, which all start with this one.
+ */
+struct http_resource_detail {
+	/** Bitmask of the methods allowed for the resource, BIT(HTTP_GET)... */
+	uint32_t bitmask_of_supported_http_methods;
+
+	/** Type of the resource */
+	enum http_resource_type type;
+
+	/** Value of the Content-Type header, or NULL to omit it */
+	const char *content_type;
+
+	/** Value of the Content-Encoding header, or NULL to omit it */
+	const char *content_encoding;
+};
+
+/**
+ * @brief Resource whose content is known at build time.
+ *
+ * The content is sent straight from @a static_data, it is never copied
+ * into an intermediate buffer of the server.
+ */
+struct http_resource_detail_static {
+	/** Common resource detail */
+	struct http_resource_detail common;
+
+	/** Content of the resource */
+	const void *static_data;
+
+	/** Length of the content */
+	size_t static_data_len;
+};
+
+/**
+ * @brief Resource read from a file system.
+ *
+ * The file is sent in chunks of CONFIG_HTTP_SERVER_CHUNK_SIZE bytes, so
+ * files of any size can be served.
+ */
+struct http_resource_detail_fs {
+	/** Common resource detail */
+	struct http_resource_detail common;
+
+	/** Path of the file, e.g. "/lfs/index.html" */
+	const char *fs_path;
+};
+
+/** Request received by the HTTP server */
+struct http_server_request {
+	/** Request method */
+	enum http_method method;
+
+	/** Requested path, without the query */
+	const char *url;
+
+	/** Query of the request, empty when there is none */
+	const char *query;
+};
+
+/**
+ * @typedef http_resource_dynamic_cb_t
+ * @brief Produce the content of a dynamic resource.
+ *
+ * The callback is invoked repeatedly, each time the server is ready to send
+ * the next part of the response. The part is sent as one chunk of a
+ * response with chunked transfer coding.
+ *
+ * @param req The request being answered.
+ * @param offset Number of content bytes produced so far for this request.
+ * @param buf Buffer to write the next part of the content to.
+ * @param len Size of the buffer.
+ * @param user_data User data of the resource.
+ *
+ * @return Number of bytes written to @p buf, 0 when the content is
+ *         complete, or a negative error code to close the connection.
+ */
+typedef int (*http_resource_dynamic_cb_t)(
+	const struct http_server_request *req, size_t offset, uint8_t *buf,
+	size_t len, void *user_data);
+
+/** Resource produced at runtime by a callback. */
+struct http_resource_detail_dynamic {
+	/** Common resource detail */
+	struct http_resource_detail common;
+
+	/** Callback producing the content */
+	http_resource_dynamic_cb_t cb;
+
+	/** User data passed to the callback */
+	void *user_data;
+};
+
+/**
+ * @brief Start the HTTP server.
+ *
+ * Start listening to all the services defined with @ref HTTP_SERVICE_DEFINE
+ * and @ref HTTP_SERVICE_DEFINE_EMPTY. All the clients are served by a
+ * single thread, which multiplexes the sockets with poll().
+ *
+ * Connections are persistent unless the client asks otherwise, and
+ * pipelined requests are answered in order.
+ *
+ * @return 0 on success, a negative error code otherwise.
+ */
+int http_server_start(void);
+
+/**
+ * @brief Stop the HTTP server.
+ *
+ * Close all the client connections and the listening sockets.
+ *
+ * @return 0 on success, a negative error code otherwise.
+ */
+int http_server_stop(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif /* ZEPHYR_INCLUDE_NET_HTTP_SERVER_H_ */
@@ -220,6 +220,17 @@ struct lwm2m_ctx {
 	 *  copied into the actual resource buffer.
 	 */
 	uint8_t validate_buf[CONFIG_LWM2M_ENGINE_VALIDATION_BUFFER_SIZE];
+
+#if defined(CONFIG_LWM2M_SEND_BATCH) || defined(__DOXYGEN__)
+	/** Paths queued by lwm2m_send_batch() for the next Send operation.
+	 * This is an LwM2M Engine private field.
+	 */
+	struct lwm2m_obj_path send_batch[CONFIG_LWM2M_COMPOSITE_PATH_LIST_SIZE];
+	/** Number of queued paths */
+	uint8_t send_batch_len;
+	/** Sends the queued paths once the batch delay elapsed */
+	struct k_work_delayable send_batch_work;
+#endif
 };
 
 /**
@@ -1993,6 +2004,46 @@ int lwm2m_engine_stop(struct lwm2m_ctx *client_ctx);
  */
 int lwm2m_engine_start(struct lwm2m_ctx *client_ctx);
 
+/**
+ * @brief Statistics of the notifications sent by the LwM2M engine.
+ *
+ * The latency of a notification is the time between the moment it was due,
+ * according to the pmin/pmax attributes or to a resource update, and the
+ * moment the engine generated it.
+ */
+struct lwm2m_notification_stats {
+	/** Number of notifications generated */
+	uint32_t notifications;
+	/** Highest notification latency in ms */
+	uint32_t max_latency_ms;
+	/** Sum of the notification latencies in ms */
+	uint64_t total_latency_ms;
+	/** Number of observations with a notification currently scheduled */
+	uint32_t scheduled;
+	/** Number of due notifications postponed because the observation
+	 * was busy
+	 */
+	uint32_t deferred;
+};
+
+/**
+ * @brief Get the notification statistics of the LwM2M engine.
+ *
+ * Available when CONFIG_LWM2M_ENGINE_NOTIFICATION_STATS is enabled.
+ *
+ * @param[out] stats Statistics of all the LwM2M contexts
+ *
+ * @return 0 for success or negative in case of error.
+ */
+int lwm2m_engine_get_notification_stats(struct lwm2m_notification_stats *stats);
+
+/**
+ * @brief Reset the notification statistics of the LwM2M engine.
+ *
+ * Available when CONFIG_LWM2M_ENGINE_NOTIFICATION_STATS is enabled.
+ */
+void lwm2m_engine_reset_notification_stats(void);
+
 /**
  * @brief Acknowledge the currently processed request with an empty ACK.
  *
@@ -2196,6 +2247,41 @@ int lwm2m_send(struct lwm2m_ctx *ctx, const struct lwm2m_obj_path path_list[],
 int lwm2m_send_cb(struct lwm2m_ctx *ctx, const struct lwm2m_obj_path path_list[],
 			  uint8_t path_list_size, lwm2m_send_cb_t reply_cb);
 
+/**
+ * @brief Queue paths for a batched LwM2M SEND operation
+ *
+ * The paths queued by successive calls are reported together in one composite
+ * SEND operation, CONFIG_LWM2M_SEND_BATCH_DELAY_MS after the first of them was
+ * queued, or as soon as the queue is full. A path already queued is not added
+ * again. If the queue is full and cannot be sent, the remaining paths are not
+ * queued and the error is returned.
+ *
+ * Available when CONFIG_LWM2M_SEND_BATCH is enabled.
+ *
+ * @param ctx LwM2M context
+ * @param path_list LwM2M path struct list
+ * @param path_list_size Length of path list
+ *
+ * @return 0 for success or negative in case of error.
+ */
+int lwm2m_send_batch(struct lwm2m_ctx *ctx, const struct lwm2m_obj_path path_list[],
+		     uint8_t path_list_size);
+
+/**
+ * @brief Send the paths queued by lwm2m_send_batch() right away
+ *
+ * If the SEND operation fails, the paths stay queued and are sent with the
+ * next batch.
+ *
+ * Available when CONFIG_LWM2M_SEND_BATCH is enabled.
+ *
+ * @param ctx LwM2M context
+ * @param reply_cb Callback triggered with confirmation state or NULL if not used
+ *
+ * @return 0 for success, -ENODATA if no path is queued or negative in case of error.
+ */
+int lwm2m_send_batch_flush(struct lwm2m_ctx *ctx, lwm2m_send_cb_t reply_cb);
+
 /** 
  * @brief Returns LwM2M client context
  *
@@ -79,6 +79,12 @@ enum mqtt_evt_type {
 
 	/** Ping Response from server. */
 	MQTT_EVT_PINGRESP,
+
+	/** Message of the in-flight window dropped unacknowledged, as the
+	 *  broker did not resume the session. Notified for each message of
+	 *  the window before the MQTT_EVT_CONNACK event.
+	 */
+	MQTT_EVT_INFLIGHT_DROPPED,
 };
 
 /** @brief MQTT version protocol level. */
@@ -236,6 +242,11 @@ struct mqtt_unsuback_param {
 	uint16_t message_id;
 };
 
+/** @brief Parameters for a message dropped from the in-flight window. */
+struct mqtt_inflight_dropped_param {
+	uint16_t message_id;
+};
+
 /** @brief Parameters for a publish message. */
 struct mqtt_publish_param {
 	/** Messages including topic, QoS and its payload (if any)
@@ -302,6 +313,9 @@ union mqtt_evt_param {
 
 	/** Parameters accompanying MQTT_EVT_UNSUBACK event. */
 	struct mqtt_unsuback_param unsuback;
+
+	/** Parameters accompanying MQTT_EVT_INFLIGHT_DROPPED event. */
+	struct mqtt_inflight_dropped_param inflight_dropped;
 };
 
 /** @brief Defines MQTT asynchronous event notified to the application. */
@@ -462,6 +476,38 @@ struct mqtt_internal {
 
 	/** Internal. Remaining payload length to read. */
 	uint32_t remaining_payload;
+
+	/** Internal. Number of messages in the in-flight window. */
+	uint8_t inflight_count;
+};
+
+/**
+ * @brief QoS 1 or QoS 2 PUBLISH message awaiting acknowledgment from the
+ *        broker. Entry of the in-flight window of a client.
+ */
+struct mqtt_inflight {
+	/** Internal. Topic and QoS of the message. */
+	struct mqtt_topic topic;
+
+	/** Internal. Payload of a message published with @ref mqtt_publish. */
+	struct iovec payload;
+
+	/** Internal. Payload buffers of a message published with
+	 *  @ref mqtt_publish_iov, NULL if published with @ref mqtt_publish.
+	 */
+	const struct iovec *payload_iov;
+
+	/** Internal. Number of payload buffers. */
+	size_t payload_count;
+
+	/** Internal. Message id. */
+	uint16_t message_id;
+
+	/** Internal. Retain flag of the message. */
+	uint8_t retain_flag : 1;
+
+	/** Internal. PUBREC received, the message awaits PUBCOMP. */
+	uint8_t released : 1;
 };
 
 /**
@@ -518,6 +564,19 @@ struct mqtt_client {
 	/** Size of transmit buffer. */
 	uint32_t tx_buf_size;
 
+	/** In-flight window, tracking the QoS 1 and QoS 2 messages published
+	 *  until the broker acknowledges them. The messages of the window are
+	 *  retransmitted when the broker resumes the session on reconnection,
+	 *  otherwise they are dropped with MQTT_EVT_INFLIGHT_DROPPED events.
+	 *  May be NULL to leave the tracking of the acks to the application.
+	 */
+	struct mqtt_inflight *inflight;
+
+	/** Number of entries of the in-flight window, i.e. the maximum number
+	 *  of QoS 1 and QoS 2 messages published and not acknowledged yet.
+	 */
+	uint8_t inflight_size;
+
 	/** Keepalive interval for this client in seconds.
 	 *  Default is CONFIG_MQTT_KEEPALIVE.
 	 */
@@ -596,11 +655,41 @@ int mqtt_connect(struct mqtt_client *client);
  * @param[in] param Parameters to be used for the publish message.
  *                  Shall not be NULL.
  *
+ * @note With an in-flight window, the topic and the payload of QoS 1 and
+ *       QoS 2 messages shall stay valid until the message is acknowledged.
+ *
  * @return 0 or a negative error code (errno.h) indicating reason of failure.
+ *         -EAGAIN if the in-flight window is full.
  */
 int mqtt_publish(struct mqtt_client *client,
 		 const struct mqtt_publish_param *param);
 
+/**
+ * @brief API to publish a message made of several payload buffers.
+ *
+ * The topic and the payload buffers are sent straight from the application
+ * memory with a single sendmsg() call, they are not copied to the transmit
+ * buffer of the client.
+ *
+ * @param[in] client Client instance for which the procedure is requested.
+ *                   Shall not be NULL.
+ * @param[in] param Parameters to be used for the publish message.
+ *                  Shall not be NULL. The payload of the message is ignored.
+ * @param[in] payload Buffers making up the payload of the message.
+ * @param[in] payload_count Number of payload buffers, at most
+ *                          @kconfig{CONFIG_MQTT_PUBLISH_MAX_PAYLOAD_IOV}.
+ *
+ * @note With an in-flight window, the topic, the payload buffers and the
+ *       @p payload array of QoS 1 and QoS 2 messages shall stay valid until
+ *       the message is acknowledged.
+ *
+ * @return 0 or a negative error code (errno.h) indicating reason of failure.
+ *         -EAGAIN if the in-flight window is full.
+ */
+int mqtt_publish_iov(struct mqtt_client *client,
+		     const struct mqtt_publish_param *param,
+		     const struct iovec *payload, size_t payload_count);
+
 /**
  * @brief API used by client to send acknowledgment on receiving QoS1 publish
  *        message. Should be called on reception of @ref MQTT_EVT_PUBLISH with
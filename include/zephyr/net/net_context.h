@@ -1000,6 +1000,39 @@ int net_context_sendmsg(struct net_context *context,
 			k_timeout_t timeout,
 			void *user_data);
 
+/**
+ * @brief Send the data of a network buffer to a peer without copying it.
+ *
+ * @details This function has the same semantics as net_context_send()
+ * but instead of copying the data to newly allocated network buffers, the
+ * fragments of @p buf are attached to the outgoing packets as they are.
+ * The buffers are typically allocated with net_buf_alloc_with_data() so
+ * that they refer to application memory, which must not be modified until
+ * the buffer is freed. The destroy callback of the buffer pool can be used
+ * to get a completion notification: for UDP the buffer is freed when the
+ * packet has been transmitted, for TCP when the data has been acknowledged
+ * by the peer and all the segments referring to it have been transmitted.
+ * The destroy callback is called from the network stack threads.
+ *
+ * Only TCP and UDP contexts are supported, and the destination address
+ * must have been set by the call to net_context_connect().
+ *
+ * @param context The network context to use.
+ * @param buf The network buffer to send. On success the reference of the
+ *        caller is passed to the network stack, on error it is still owned
+ *        by the caller.
+ * @param cb Caller-supplied callback function.
+ * @param timeout Timeout for the network packet allocation.
+ * @param user_data Caller-supplied user data.
+ *
+ * @return numbers of bytes sent on success, a negative errno otherwise
+ */
+int net_context_send_buf(struct net_context *context,
+			 struct net_buf *buf,
+			 net_context_send_cb_t cb,
+			 k_timeout_t timeout,
+			 void *user_data);
+
 /**
  * @brief Receive network data from a peer specified by context.
  *
@@ -128,6 +128,11 @@ struct net_pkt {
 	uint64_t txtime;
 #endif /* CONFIG_NET_PKT_TXTIME */
 
+#if defined(CONFIG_NET_TC_TX_FQ_CODEL)
+	/** Time in cycles when the packet was put to the TX queue */
+	uint32_t tx_queue_time;
+#endif /* CONFIG_NET_TC_TX_FQ_CODEL */
+
 	/** Reference counter */
 	atomic_t atomic_ref;
 
@@ -193,6 +198,12 @@ struct net_pkt {
 	uint8_t l2_processed : 1; /* Set to 1 if this packet has already been
 				   * processed by the L2
 				   */
+	uint8_t chksum_valid : 1; /* Set to 1 if the upper layer (TCP, UDP,
+				   * ICMP) checksum of this received packet
+				   * has already been validated, e.g. by the
+				   * device, so the IP stack does not need
+				   * to verify it again.
+				   */
 
 	/* bitfield byte alignment boundary */
 
@@ -266,6 +277,15 @@ struct net_pkt {
 	uint16_t vlan_tci;
 #endif /* CONFIG_NET_VLAN */
 
+#if defined(CONFIG_NET_UDP_CHECKSUM_COPY)
+	/* Checksum of the UDP payload, calculated while the payload was
+	 * copied into the packet. Only used if udp_payload_chksum_valid
+	 * is set.
+	 */
+	uint16_t udp_payload_chksum;
+	uint8_t udp_payload_chksum_valid : 1;
+#endif /* CONFIG_NET_UDP_CHECKSUM_COPY */
+
 #if defined(NET_PKT_HAS_CONTROL_BLOCK)
 	/* TODO: Evolve this into a union of orthogonal
 	 *       control block declarations if further L2
@@ -397,6 +417,67 @@ static inline void net_pkt_set_l2_processed(struct net_pkt *pkt,
 	pkt->l2_processed = is_l2_processed;
 }
 
+static inline bool net_pkt_is_chksum_valid(struct net_pkt *pkt)
+{
+	return !!(pkt->chksum_valid);
+}
+
+static inline void net_pkt_set_chksum_valid(struct net_pkt *pkt,
+					    bool is_chksum_valid)
+{
+	pkt->chksum_valid = is_chksum_valid;
+}
+
+#if defined(CONFIG_NET_UDP_CHECKSUM_COPY)
+static inline bool net_pkt_is_udp_payload_chksum_valid(struct net_pkt *pkt)
+{
+	return !!(pkt->udp_payload_chksum_valid);
+}
+
+static inline uint16_t net_pkt_udp_payload_chksum(struct net_pkt *pkt)
+{
+	return pkt->udp_payload_chksum;
+}
+
+static inline void net_pkt_set_udp_payload_chksum(struct net_pkt *pkt,
+						  uint16_t chksum)
+{
+	pkt->udp_payload_chksum = chksum;
+	pkt->udp_payload_chksum_valid = 1U;
+}
+
+static inline void net_pkt_clear_udp_payload_chksum(struct net_pkt *pkt)
+{
+	pkt->udp_payload_chksum_valid = 0U;
+}
+#else
+static inline bool net_pkt_is_udp_payload_chksum_valid(struct net_pkt *pkt)
+{
+	ARG_UNUSED(pkt);
+
+	return false;
+}
+
+static inline uint16_t net_pkt_udp_payload_chksum(struct net_pkt *pkt)
+{
+	ARG_UNUSED(pkt);
+
+	return 0U;
+}
+
+static inline void net_pkt_set_udp_payload_chksum(struct net_pkt *pkt,
+						  uint16_t chksum)
+{
+	ARG_UNUSED(pkt);
+	ARG_UNUSED(chksum);
+}
+
+static inline void net_pkt_clear_udp_payload_chksum(struct net_pkt *pkt)
+{
+	ARG_UNUSED(pkt);
+}
+#endif /* CONFIG_NET_UDP_CHECKSUM_COPY */
+
 static inline uint8_t net_pkt_ip_hdr_len(struct net_pkt *pkt)
 {
 #if defined(CONFIG_NET_IP)
@@ -1023,6 +1104,33 @@ static inline void net_pkt_set_txtime(struct net_pkt *pkt, uint64_t txtime)
 }
 #endif /* CONFIG_NET_PKT_TXTIME */
 
+#if defined(CONFIG_NET_TC_TX_FQ_CODEL)
+static inline uint32_t net_pkt_tx_queue_time(struct net_pkt *pkt)
+{
+	return pkt->tx_queue_time;
+}
+
+static inline void net_pkt_set_tx_queue_time(struct net_pkt *pkt,
+					     uint32_t tx_queue_time)
+{
+	pkt->tx_queue_time = tx_queue_time;
+}
+#else
+static inline uint32_t net_pkt_tx_queue_time(struct net_pkt *pkt)
+{
+	ARG_UNUSED(pkt);
+
+	return 0U;
+}
+
+static inline void net_pkt_set_tx_queue_time(struct net_pkt *pkt,
+					     uint32_t tx_queue_time)
+{
+	ARG_UNUSED(pkt);
+	ARG_UNUSED(tx_queue_time);
+}
+#endif /* CONFIG_NET_TC_TX_FQ_CODEL */
+
 #if defined(CONFIG_NET_PKT_TXTIME_STATS_DETAIL) || \
 	defined(CONFIG_NET_PKT_RXTIME_STATS_DETAIL)
 static inline uint32_t *net_pkt_stats_tick(struct net_pkt *pkt)
@@ -1659,6 +1767,36 @@ struct net_pkt *net_pkt_rx_alloc_with_buffer_debug(struct net_if *iface,
 	net_pkt_rx_alloc_with_buffer_debug(_iface, _size, _family,	\
 					   _proto, _timeout,		\
 					   __func__, __LINE__)
+
+int net_pkt_alloc_bulk_with_buffer_debug(struct net_if *iface,
+					 struct net_pkt **pkts,
+					 const size_t *sizes,
+					 int count,
+					 sa_family_t family,
+					 enum net_ip_protocol proto,
+					 k_timeout_t timeout,
+					 const char *caller,
+					 int line);
+#define net_pkt_alloc_bulk_with_buffer(_iface, _pkts, _sizes, _count,	\
+				       _family, _proto, _timeout)	\
+	net_pkt_alloc_bulk_with_buffer_debug(_iface, _pkts, _sizes,	\
+					     _count, _family, _proto,	\
+					     _timeout, __func__, __LINE__)
+
+int net_pkt_rx_alloc_bulk_with_buffer_debug(struct net_if *iface,
+					    struct net_pkt **pkts,
+					    const size_t *sizes,
+					    int count,
+					    sa_family_t family,
+					    enum net_ip_protocol proto,
+					    k_timeout_t timeout,
+					    const char *caller,
+					    int line);
+#define net_pkt_rx_alloc_bulk_with_buffer(_iface, _pkts, _sizes, _count, \
+					  _family, _proto, _timeout)	\
+	net_pkt_rx_alloc_bulk_with_buffer_debug(_iface, _pkts, _sizes,	\
+						_count, _family, _proto, \
+						_timeout, __func__, __LINE__)
 #endif /* NET_PKT_DEBUG_ENABLED */
 /** @endcond */
 
@@ -1774,6 +1912,57 @@ struct net_pkt *net_pkt_rx_alloc_with_buffer(struct net_if *iface,
 					     k_timeout_t timeout);
 #endif
 
+/**
+ * @brief Allocate several network packets and their buffers at once
+ *
+ * @details Meant for drivers and protocols handling packets in bursts.
+ *          The packet structures are taken from the slab first and the
+ *          buffers are attached afterwards. Only the first allocation may
+ *          wait for @p timeout, the remaining ones use whatever is readily
+ *          available so that a partial burst is returned rather than
+ *          blocking.
+ *
+ * @param iface   The network interface the packets are supposed to go through.
+ * @param pkts    Array of at least @p count entries receiving the packets.
+ * @param sizes   Array of @p count buffer sizes, one per packet.
+ * @param count   Number of packets to allocate.
+ * @param family  The family to which the packets belong.
+ * @param proto   The IP protocol type (can be 0 for none).
+ * @param timeout Maximum time to wait for the first allocation.
+ *
+ * @return Number of packets allocated, stored in the first entries of
+ *         @p pkts. The remaining entries are set to NULL.
+ */
+#if !defined(NET_PKT_DEBUG_ENABLED)
+int net_pkt_alloc_bulk_with_buffer(struct net_if *iface,
+				   struct net_pkt **pkts,
+				   const size_t *sizes,
+				   int count,
+				   sa_family_t family,
+				   enum net_ip_protocol proto,
+				   k_timeout_t timeout);
+
+/* Same as above but specifically for RX packets */
+int net_pkt_rx_alloc_bulk_with_buffer(struct net_if *iface,
+				      struct net_pkt **pkts,
+				      const size_t *sizes,
+				      int count,
+				      sa_family_t family,
+				      enum net_ip_protocol proto,
+				      k_timeout_t timeout);
+#endif
+
+/**
+ * @brief Release several network packets at once
+ *
+ * @details NULL entries are skipped, so the array filled by
+ *          net_pkt_alloc_bulk_with_buffer() can be given back as is.
+ *
+ * @param pkts  Array of network packets to release.
+ * @param count Number of entries in @p pkts.
+ */
+void net_pkt_unref_bulk(struct net_pkt **pkts, int count);
+
 /**
  * @brief Append a buffer in packet
  *
@@ -57,10 +57,13 @@ extern struct npf_rule npf_default_ok;
 /** @brief Default rule list termination for rejecting a packet */
 extern struct npf_rule npf_default_drop;
 
+struct npf_program;
+
 /** @brief rule set for a given test location */
 struct npf_rule_list {
 	sys_slist_t rule_head;
 	struct k_spinlock lock;
+	struct npf_program *program;	/**< compiled rules, see npf_compile_rules() */
 };
 
 /** @brief  rule list applied to outgoing packets */
@@ -101,6 +104,22 @@ bool npf_remove_rule(struct npf_rule_list *rules, struct npf_rule *rule);
  */
 bool npf_remove_all_rules(struct npf_rule_list *rules);
 
+/**
+ * @brief Evaluate a rule list against a network packet
+ *
+ * The first rule in the list for which all conditions are true determines
+ * the fate of the packet. An empty rule list accepts every packet, while a
+ * non-empty rule list without any matching rule rejects it.
+ *
+ * This allows rule lists other than the send and receive ones to be used
+ * as packet selectors, e.g. by the network packet capture.
+ *
+ * @param rules the rule list to evaluate
+ * @param pkt the network packet to test
+ * @retval true if the packet is accepted by the rule list
+ */
+bool npf_rules_ok(struct npf_rule_list *rules, struct net_pkt *pkt);
+
 /* convenience shortcuts */
 #define npf_insert_send_rule(rule) npf_insert_rule(&npf_send_rules, rule)
 #define npf_insert_recv_rule(rule) npf_insert_rule(&npf_recv_rules, rule)
@@ -462,6 +481,387 @@ extern npf_test_fn_t npf_eth_type_unmatch;
 
 /** @} */
 
+/**
+ * @defgroup npf_ip_cond IP Filter Conditions
+ * @ingroup net_pkt_filter
+ * @{
+ *
+ * These conditions look for the IP header at the beginning of outgoing
+ * packets, and after the link layer header of incoming packets that were
+ * not processed by the L2 yet. The header of incoming packets is only found
+ * on Ethernet and on the L2s without link layer header, the incoming packets
+ * of other L2s like IEEE 802.15.4, Bluetooth or PPP are not IP packets for
+ * these conditions. Packets that are not IP packets never match.
+ * The IPv6 extension headers are skipped, and the ports are only available
+ * for the UDP and TCP packets that are not a subsequent fragment.
+ */
+
+/** @cond INTERNAL_HIDDEN */
+
+struct npf_test_ip_proto {
+	struct npf_test test;
+	uint8_t proto;
+};
+
+struct npf_test_ip_addr {
+	struct npf_test test;
+	sa_family_t family;
+	uint8_t prefix_len;
+	unsigned int nb_addresses;
+	const void *addresses;
+};
+
+struct npf_test_port_range {
+	struct npf_test test;
+	uint16_t min;			/* host order */
+	uint16_t max;			/* host order */
+};
+
+extern npf_test_fn_t npf_ip_proto_match;
+extern npf_test_fn_t npf_ip_proto_unmatch;
+extern npf_test_fn_t npf_ip_src_addr_match;
+extern npf_test_fn_t npf_ip_src_addr_unmatch;
+extern npf_test_fn_t npf_ip_dst_addr_match;
+extern npf_test_fn_t npf_ip_dst_addr_unmatch;
+extern npf_test_fn_t npf_src_port_inrange;
+extern npf_test_fn_t npf_dst_port_inrange;
+
+#define Z_NPF_IP_ADDR(_name, _family, _addr_array, _prefix_len, _fn) \
+	struct npf_test_ip_addr _name = { \
+		.family = (_family), \
+		.prefix_len = (_prefix_len), \
+		.addresses = (_addr_array), \
+		.nb_addresses = ARRAY_SIZE(_addr_array), \
+		.test.fn = (_fn), \
+	}; \
+	BUILD_ASSERT((_prefix_len) <= ((_family) == AF_INET6 ? 128 : 32), \
+		     "Prefix length longer than the address")
+
+/** @endcond */
+
+/**
+ * @brief Statically define an "IP protocol match" packet filter condition
+ *
+ * @param _name Name of the condition
+ * @param _proto IP protocol to match, e.g. <tt>IPPROTO_UDP</tt>
+ */
+#define NPF_IP_PROTO_MATCH(_name, _proto) \
+	struct npf_test_ip_proto _name = { \
+		.proto = (_proto), \
+		.test.fn = npf_ip_proto_match, \
+	}
+
+/**
+ * @brief Statically define an "IP protocol unmatch" packet filter condition
+ *
+ * @param _name Name of the condition
+ * @param _proto IP protocol to exclude
+ */
+#define NPF_IP_PROTO_UNMATCH(_name, _proto) \
+	struct npf_test_ip_proto _name = { \
+		.proto = (_proto), \
+		.test.fn = npf_ip_proto_unmatch, \
+	}
+
+/**
+ * @brief Statically define an "IPv4 source address match" packet filter condition
+ *
+ * This tests if the packet source address matches any of the IPv4
+ * addresses contained in the provided set.
+ *
+ * @param _name Name of the condition
+ * @param _addr_array Array of <tt>struct in_addr</tt> items to test against
+ */
+#define NPF_IPV4_SRC_ADDR_MATCH(_name, _addr_array) \
+	Z_NPF_IP_ADDR(_name, AF_INET, _addr_array, 32, npf_ip_src_addr_match)
+
+/**
+ * @brief Statically define an "IPv4 source address unmatch" packet filter condition
+ *
+ * @param _name Name of the condition
+ * @param _addr_array Array of <tt>struct in_addr</tt> items to test against
+ */
+#define NPF_IPV4_SRC_ADDR_UNMATCH(_name, _addr_array) \
+	Z_NPF_IP_ADDR(_name, AF_INET, _addr_array, 32, npf_ip_src_addr_unmatch)
+
+/**
+ * @brief Statically define an "IPv4 destination address match" packet filter condition
+ *
+ * @param _name Name of the condition
+ * @param _addr_array Array of <tt>struct in_addr</tt> items to test against
+ */
+#define NPF_IPV4_DST_ADDR_MATCH(_name, _addr_array) \
+	Z_NPF_IP_ADDR(_name, AF_INET, _addr_array, 32, npf_ip_dst_addr_match)
+
+/**
+ * @brief Statically define an "IPv4 destination address unmatch" packet filter condition
+ *
+ * @param _name Name of the condition
+ * @param _addr_array Array of <tt>struct in_addr</tt> items to test against
+ */
+#define NPF_IPV4_DST_ADDR_UNMATCH(_name, _addr_array) \
+	Z_NPF_IP_ADDR(_name, AF_INET, _addr_array, 32, npf_ip_dst_addr_unmatch)
+
+/**
+ * @brief Statically define an "IPv4 source prefix match" packet filter condition
+ *
+ * This tests if the packet source address belongs to any of the IPv4
+ * prefixes contained in the provided set.
+ *
+ * @param _name Name of the condition
+ * @param _addr_array Array of <tt>struct in_addr</tt> prefixes
+ * @param _prefix_len Length of the prefixes in bits
+ */
+#define NPF_IPV4_SRC_PREFIX_MATCH(_name, _addr_array, _prefix_len) \
+	Z_NPF_IP_ADDR(_name, AF_INET, _addr_array, _prefix_len, npf_ip_src_addr_match)
+
+/**
+ * @brief Statically define an "IPv4 destination prefix match" packet filter condition
+ *
+ * @param _name Name of the condition
+ * @param _addr_array Array of <tt>struct in_addr</tt> prefixes
+ * @param _prefix_len Length of the prefixes in bits
+ */
+#define NPF_IPV4_DST_PREFIX_MATCH(_name, _addr_array, _prefix_len) \
+	Z_NPF_IP_ADDR(_name, AF_INET, _addr_array, _prefix_len, npf_ip_dst_addr_match)
+
+/**
+ * @brief Statically define an "IPv6 source address match" packet filter condition
+ *
+ * This tests if the packet source address matches any of the IPv6
+ * addresses contained in the provided set.
+ *
+ * @param _name Name of the condition
+ * @param _addr_array Array of <tt>struct in6_addr</tt> items to test against
+ */
+#define NPF_IPV6_SRC_ADDR_MATCH(_name, _addr_array) \
+	Z_NPF_IP_ADDR(_name, AF_INET6, _addr_array, 128, npf_ip_src_addr_match)
+
+/**
+ * @brief Statically define an "IPv6 source address unmatch" packet filter condition
+ *
+ * @param _name Name of the condition
+ * @param _addr_array Array of <tt>struct in6_addr</tt> items to test against
+ */
+#define NPF_IPV6_SRC_ADDR_UNMATCH(_name, _addr_array) \
+	Z_NPF_IP_ADDR(_name, AF_INET6, _addr_array, 128, npf_ip_src_addr_unmatch)
+
+/**
+ * @brief Statically define an "IPv6 destination address match" packet filter condition
+ *
+ * @param _name Name of the condition
+ * @param _addr_array Array of <tt>struct in6_addr</tt> items to test against
+ */
+#define NPF_IPV6_DST_ADDR_MATCH(_name, _addr_array) \
+	Z_NPF_IP_ADDR(_name, AF_INET6, _addr_array, 128, npf_ip_dst_addr_match)
+
+/**
+ * @brief Statically define an "IPv6 destination address unmatch" packet filter condition
+ *
+ * @param _name Name of the condition
+ * @param _addr_array Array of <tt>struct in6_addr</tt> items to test against
+ */
+#define NPF_IPV6_DST_ADDR_UNMATCH(_name, _addr_array) \
+	Z_NPF_IP_ADDR(_name, AF_INET6, _addr_array, 128, npf_ip_dst_addr_unmatch)
+
+/**
+ * @brief Statically define an "IPv6 source prefix match" packet filter condition
+ *
+ * @param _name Name of the condition
+ * @param _addr_array Array of <tt>struct in6_addr</tt> prefixes
+ * @param _prefix_len Length of the prefixes in bits
+ */
+#define NPF_IPV6_SRC_PREFIX_MATCH(_name, _addr_array, _prefix_len) \
+	Z_NPF_IP_ADDR(_name, AF_INET6, _addr_array, _prefix_len, npf_ip_src_addr_match)
+
+/**
+ * @brief Statically define an "IPv6 destination prefix match" packet filter condition
+ *
+ * @param _name Name of the condition
+ * @param _addr_array Array of <tt>struct in6_addr</tt> prefixes
+ * @param _prefix_len Length of the prefixes in bits
+ */
+#define NPF_IPV6_DST_PREFIX_MATCH(_name, _addr_array, _prefix_len) \
+	Z_NPF_IP_ADDR(_name, AF_INET6, _addr_array, _prefix_len, npf_ip_dst_addr_match)
+
+/**
+ * @brief Statically define a "source port match" packet filter condition
+ *
+ * @param _name Name of the condition
+ * @param _port UDP or TCP port to match, in host order
+ */
+#define NPF_SRC_PORT_MATCH(_name, _port) \
+	struct npf_test_port_range _name = { \
+		.min = (_port), \
+		.max = (_port), \
+		.test.fn = npf_src_port_inrange, \
+	}
+
+/**
+ * @brief Statically define a "destination port match" packet filter condition
+ *
+ * @param _name Name of the condition
+ * @param _port UDP or TCP port to match, in host order
+ */
+#define NPF_DST_PORT_MATCH(_name, _port) \
+	struct npf_test_port_range _name = { \
+		.min = (_port), \
+		.max = (_port), \
+		.test.fn = npf_dst_port_inrange, \
+	}
+
+/**
+ * @brief Statically define a "source port range" packet filter condition
+ *
+ * @param _name Name of the condition
+ * @param _min_port Lower bound of the source port, in host order
+ * @param _max_port Higher bound of the source port, in host order
+ */
+#define NPF_SRC_PORT_RANGE(_name, _min_port, _max_port) \
+	struct npf_test_port_range _name = { \
+		.min = (_min_port), \
+		.max = (_max_port), \
+		.test.fn = npf_src_port_inrange, \
+	}
+
+/**
+ * @brief Statically define a "destination port range" packet filter condition
+ *
+ * @param _name Name of the condition
+ * @param _min_port Lower bound of the destination port, in host order
+ * @param _max_port Higher bound of the destination port, in host order
+ */
+#define NPF_DST_PORT_RANGE(_name, _min_port, _max_port) \
+	struct npf_test_port_range _name = { \
+		.min = (_min_port), \
+		.max = (_max_port), \
+		.test.fn = npf_dst_port_inrange, \
+	}
+
+/** @} */
+
+/**
+ * @defgroup npf_compile Compiled Rule Lists
+ * @ingroup net_pkt_filter
+ * @{
+ *
+ * Evaluating a rule list calls the test function of every condition of
+ * every rule until one rule matches, and the IP conditions parse the packet
+ * headers each time. A rule list can instead be compiled into a program
+ * where the conditions known to the compiler are evaluated by a small
+ * interpreter, with the packet headers parsed only once. The rules matching
+ * an exact IP 5-tuple, i.e. made of an IP protocol match, single source and
+ * destination address matches, and single source and destination port
+ * matches, are placed in a hash table and found with a single lookup.
+ *
+ * The compiled program refers to the filter conditions, except for the
+ * values of the hashed 5-tuples which are copied into the hash table.
+ * Modifying the rule list discards its compiled program, the rule list
+ * must be compiled again for the new rules to be evaluated faster.
+ *
+ * @code{.c}
+ *
+ *     NPF_PROGRAM_DEFINE(recv_program, 256, 128);
+ *
+ *     void install_my_filter(void)
+ *     {
+ *         ... insert or append the receive rules ...
+ *
+ *         npf_compile_rules(&npf_recv_rules, &recv_program);
+ *     }
+ *
+ * @endcode
+ */
+
+/** @cond INTERNAL_HIDDEN */
+
+struct npf_insn {
+	uint8_t op;
+	uint8_t flags;
+	uint16_t rule;			/* index of the rule in the list */
+	uint16_t next_rule;		/* jump target if the test is false */
+	uint8_t result;			/* verdict of the return instruction */
+	struct npf_test *test;
+};
+
+struct npf_exact_entry {
+	uint8_t src_addr[16];
+	uint8_t dst_addr[16];
+	uint16_t src_port;
+	uint16_t dst_port;
+	uint16_t rule;
+	uint8_t family;
+	uint8_t proto;
+	uint8_t result;
+	bool in_use;
+};
+
+/** @endcond */
+
+/** @brief compiled rule list */
+struct npf_program {
+	/** Instructions of the rules that are not hashed */
+	struct npf_insn *insns;
+	/** Hash table of the exact 5-tuple rules */
+	struct npf_exact_entry *table;
+	/** Maximum number of instructions */
+	uint16_t max_insns;
+	/** Number of hash table entries, a power of two */
+	uint16_t table_size;
+	/** Number of instructions in use */
+	uint16_t nb_insns;
+	/** Number of hashed rules */
+	uint16_t nb_entries;
+	/** Verdict when no rule matches */
+	enum net_verdict no_match;
+};
+
+/**
+ * @brief Statically define storage for a compiled rule list
+ *
+ * A rule uses one instruction per condition, plus one. The hash table
+ * is filled up to three quarters of its size, the remaining 5-tuple rules
+ * are compiled to instructions.
+ *
+ * @param _name Name of the program
+ * @param _max_insns Maximum number of instructions
+ * @param _table_size Number of hash table entries, 0 or a power of two
+ */
+#define NPF_PROGRAM_DEFINE(_name, _max_insns, _table_size) \
+	BUILD_ASSERT((_table_size) == 0 || IS_POWER_OF_TWO(_table_size), \
+		     "Hash table size must be a power of two"); \
+	static struct npf_insn _name##_insns[_max_insns]; \
+	static struct npf_exact_entry _name##_table[MAX(_table_size, 1)]; \
+	static struct npf_program _name = { \
+		.insns = _name##_insns, \
+		.table = _name##_table, \
+		.max_insns = (_max_insns), \
+		.table_size = (_table_size), \
+	}
+
+/**
+ * @brief Compile a rule list
+ *
+ * The rule list is evaluated with the compiled program until the rule list
+ * is modified or npf_uncompile_rules() is called.
+ *
+ * @param rules the rule list to compile
+ * @param program storage for the compiled program, defined with
+ *                NPF_PROGRAM_DEFINE()
+ * @retval 0 if the rule list was compiled
+ * @retval -ENOMEM if the program has not enough instructions
+ */
+int npf_compile_rules(struct npf_rule_list *rules, struct npf_program *program);
+
+/**
+ * @brief Go back to evaluating a rule list rule by rule
+ *
+ * @param rules the rule list
+ */
+void npf_uncompile_rules(struct npf_rule_list *rules);
+
+/** @} */
+
 #ifdef __cplusplus
 }
 #endif
@@ -275,6 +275,46 @@ struct net_stats_tc {
 };
 
 
+/**
+ * @brief FQ-CoDel TX queue statistics
+ */
+struct net_stats_fq_codel {
+	/** Packets dropped because they stayed too long in the queue */
+	net_stats_t codel_drops;
+
+	/** Packets dropped because the queue limit was reached */
+	net_stats_t overlimit_drops;
+
+	/** Number of times a flow queue became active */
+	net_stats_t new_flows;
+};
+
+/**
+ * @brief Network packet allocation statistics
+ */
+struct net_stats_pkt_alloc {
+	/** Number of packets allocated with a buffer */
+	net_stats_t allocs;
+
+	/** Allocation requests that could not be fully served */
+	net_stats_t failures;
+
+	/** Number of bulk allocation requests */
+	net_stats_t bulk_allocs;
+
+	/** Total time spent in allocation requests, in microseconds */
+	uint64_t time_sum;
+
+	/** Number of allocation requests accounted in time_sum */
+	net_stats_t time_count;
+
+	/** Longest allocation request, in microseconds */
+	uint32_t time_max;
+
+	/** Highest number of packets in use seen after an allocation */
+	net_stats_t max_used;
+};
+
 /**
  * @brief Power management statistics
  */
@@ -347,6 +387,19 @@ struct net_stats {
 	struct net_stats_tc tc;
 #endif
 
+#if defined(CONFIG_NET_TC_TX_FQ_CODEL)
+	/** FQ-CoDel TX queue statistics */
+	struct net_stats_fq_codel fq_codel;
+#endif
+
+#if defined(CONFIG_NET_STATISTICS_PKT_ALLOC)
+	/** RX packet allocation statistics */
+	struct net_stats_pkt_alloc rx_alloc;
+
+	/** TX packet allocation statistics */
+	struct net_stats_pkt_alloc tx_alloc;
+#endif
+
 #if defined(CONFIG_NET_PKT_TXTIME_STATS)
 	/** Network packet TX time statistics */
 	struct net_stats_tx_time tx_time;
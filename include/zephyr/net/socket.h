@@ -29,6 +29,7 @@
 #include <zephyr/net/socket_select.h>
 #include <zephyr/sys/iterable_sections.h>
 #include <stdlib.h>
+#include <errno.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -164,6 +165,34 @@ struct zsock_pollfd {
  *  This option accepts any value.
  */
 #define TLS_SESSION_CACHE_PURGE 13
+/** Read-only socket option to read the handshake counters of TLS/DTLS
+ *  server sockets. It returns a struct tls_handshake_stats. The counters
+ *  are shared by all the sockets, so any TLS/DTLS socket can be used.
+ */
+#define TLS_HANDSHAKE_STATS 14
+/** Socket option to control the DTLS Connection ID extension (RFC 9146),
+ *  which lets a DTLS connection survive a change of the peer address, e.g.
+ *  after a NAT rebinding. It must be set before the handshake, and is
+ *  rejected with EINVAL on stream (TLS) sockets. Accepted values:
+ *  - 0 - Disabled.
+ *  - 1 - Supported, the records sent carry the Connection ID of the peer,
+ *        but the peer is not asked to use one.
+ *  - 2 - Enabled, the peer is also asked to add our Connection ID to the
+ *        records it sends, so that they are accepted from any address.
+ */
+#define TLS_DTLS_CID 15
+/** Socket option to set or read our DTLS Connection ID. It accepts and
+ *  returns an array of bytes. If not set, a random Connection ID is used.
+ */
+#define TLS_DTLS_CID_VALUE 16
+/** Read-only socket option to read the DTLS Connection ID of the peer. It
+ *  returns an array of bytes, empty if the peer does not use one.
+ */
+#define TLS_DTLS_PEER_CID_VALUE 17
+/** Read-only socket option to read the status of the DTLS Connection ID
+ *  negotiation. It returns one of the TLS_DTLS_CID_STATUS_* values.
+ */
+#define TLS_DTLS_CID_STATUS 18
 
 /** @} */
 
@@ -180,10 +209,33 @@ struct zsock_pollfd {
 #define TLS_CERT_NOCOPY_NONE 0     /**< Cert duplicated in heap */
 #define TLS_CERT_NOCOPY_OPTIONAL 1 /**< Cert not copied in heap if DER */
 
+/* Valid values for TLS_DTLS_CID option */
+#define TLS_DTLS_CID_DISABLED 0  /**< Connection ID not used. */
+#define TLS_DTLS_CID_SUPPORTED 1 /**< Connection ID of the peer only. */
+#define TLS_DTLS_CID_ENABLED 2   /**< Connection IDs of both peers. */
+
+/* Values returned by TLS_DTLS_CID_STATUS option */
+#define TLS_DTLS_CID_STATUS_DISABLED 0      /**< No Connection ID in use. */
+#define TLS_DTLS_CID_STATUS_DOWNLINK 1      /**< Received records carry ours. */
+#define TLS_DTLS_CID_STATUS_UPLINK 2        /**< Sent records carry the peer's. */
+#define TLS_DTLS_CID_STATUS_BIDIRECTIONAL 3 /**< Both directions. */
+
 /* Valid values for TLS_SESSION_CACHE option */
 #define TLS_SESSION_CACHE_DISABLED 0 /**< Disable TLS session caching. */
 #define TLS_SESSION_CACHE_ENABLED 1 /**< Enable TLS session caching. */
 
+/** Handshake counters returned by the TLS_HANDSHAKE_STATS option. */
+struct tls_handshake_stats {
+	/** Handshakes which established a new session. */
+	uint32_t full;
+	/** Handshakes which resumed a session, either from the server
+	 *  session cache or from a session ticket.
+	 */
+	uint32_t resumed;
+	/** Handshakes which failed. */
+	uint32_t failed;
+};
+
 struct zsock_addrinfo {
 	struct zsock_addrinfo *ai_next;
 	int ai_flags;
@@ -404,6 +456,27 @@ static inline ssize_t zsock_send(int sock, const void *buf, size_t len,
 __syscall ssize_t zsock_sendmsg(int sock, const struct msghdr *msg,
 				int flags);
 
+/**
+ * @brief Send multiple messages on a socket with one call
+ *
+ * @details
+ * @rst
+ * See `Linux man page
+ * <https://man7.org/linux/man-pages/man2/sendmmsg.2.html>`__
+ * for normative description.
+ * All the messages are sent while holding the socket lock once, and in case
+ * of userspace threads, with a single system call. On return, the
+ * ``msg_len`` field of each sent message contains the number of bytes sent.
+ * This function is also exposed as ``sendmmsg()``
+ * if :kconfig:option:`CONFIG_NET_SOCKETS_POSIX_NAMES` is defined.
+ * @endrst
+ *
+ * @return Number of messages sent, or -1 and errno set if the first message
+ *         could not be sent.
+ */
+__syscall int zsock_sendmmsg(int sock, struct mmsghdr *msgvec,
+			     unsigned int vlen, int flags);
+
 /**
  * @brief Receive data from an arbitrary network address
  *
@@ -438,6 +511,141 @@ static inline ssize_t zsock_recv(int sock, void *buf, size_t max_len,
 	return zsock_recvfrom(sock, buf, max_len, flags, NULL, NULL);
 }
 
+/**
+ * @brief Receive multiple datagrams from a socket with one call
+ *
+ * @details
+ * @rst
+ * See `Linux man page
+ * <https://man7.org/linux/man-pages/man2/recvmmsg.2.html>`__
+ * for normative description.
+ * Only datagram sockets are supported. The call waits, according to the
+ * socket blocking mode and the ``SO_RCVTIMEO`` option, for the first
+ * datagram only. The rest of the messages are filled with datagrams that
+ * are already queued to the socket, i.e. the call behaves as if
+ * ``MSG_WAITFORONE`` was set in Linux. On return, the ``msg_len`` field
+ * of each received message contains the length of the datagram and
+ * ``msg_flags`` contains ``ZSOCK_MSG_TRUNC`` if it did not fit to the
+ * given buffers. Ancillary data is not supported.
+ * This function is also exposed as ``recvmmsg()``
+ * if :kconfig:option:`CONFIG_NET_SOCKETS_POSIX_NAMES` is defined. The
+ * ``timeout`` argument of ``recvmmsg()`` is not supported, it must be NULL
+ * or the call fails with ``EINVAL``.
+ * @endrst
+ *
+ * @return Number of messages received, or -1 and errno set if no message
+ *         could be received.
+ */
+__syscall int zsock_recvmmsg(int sock, struct mmsghdr *msgvec,
+			     unsigned int vlen, int flags);
+
+struct net_pkt;
+struct net_buf;
+
+/**
+ * @brief Received data loaned to the application by
+ *        @ref zsock_recv_zerocopy
+ */
+struct zsock_rx_loan {
+	/** Network packet owning the loaned buffers, for internal use */
+	struct net_pkt *pkt;
+	/** First fragment of the received data. The data of this fragment
+	 *  starts at the payload, the rest of the payload is found by
+	 *  following the fragment chain. NULL if no data was received.
+	 */
+	struct net_buf *buf;
+	/** Total length of the received data */
+	size_t len;
+};
+
+/**
+ * @brief Receive data without copying it to an application buffer
+ *
+ * @details
+ * The network buffers holding the received data are handed over to the
+ * caller instead of copying the data, which saves one copy of the payload
+ * per packet. For datagram sockets one call returns exactly one datagram.
+ * For stream sockets one call returns the data of one received segment,
+ * the receive window is opened as soon as the data is dequeued.
+ *
+ * The loaned buffers must not be modified and must be returned with
+ * @ref zsock_recv_zerocopy_release after use. Until then they are not
+ * available for receiving new packets, so the loans should be short lived.
+ *
+ * This function is only available to kernel threads and only for native
+ * (non-offloaded) sockets. @c ZSOCK_MSG_PEEK is not supported.
+ *
+ * @param sock Socket descriptor
+ * @param loan Loan descriptor filled on success
+ * @param flags @c ZSOCK_MSG_DONTWAIT or 0
+ * @param src_addr Source address of a datagram, or NULL
+ * @param addrlen Length of @p src_addr, value-result argument
+ *
+ * On end of stream 0 is returned and nothing is loaned, @p loan is left
+ * empty. A zero length datagram is loaned like any other datagram and must
+ * be released. Releasing an empty loan is a no-op, so the caller may always
+ * call @ref zsock_recv_zerocopy_release after a successful call.
+ *
+ * @return Number of bytes loaned, 0 on end of stream, or -1 and errno set
+ *         on error. EPERM is returned if called from user mode and
+ *         EOPNOTSUPP if the socket does not support loaning.
+ */
+ssize_t zsock_recv_zerocopy(int sock, struct zsock_rx_loan *loan, int flags,
+			    struct sockaddr *src_addr, socklen_t *addrlen);
+
+/**
+ * @brief Return buffers loaned by @ref zsock_recv_zerocopy
+ *
+ * @param loan Loan descriptor. It is cleared on return, so releasing an
+ *        empty descriptor is a no-op.
+ */
+void zsock_recv_zerocopy_release(struct zsock_rx_loan *loan);
+
+/**
+ * @brief Callback called when the data of @ref zsock_send_zerocopy
+ *        is not used by the network stack anymore
+ *
+ * @param data Data pointer given to @ref zsock_send_zerocopy
+ * @param len Data length given to @ref zsock_send_zerocopy
+ * @param user_data User data given to @ref zsock_send_zerocopy
+ */
+typedef void (*zsock_send_zerocopy_cb_t)(const void *data, size_t len,
+					 void *user_data);
+
+/**
+ * @brief Send data to a connected peer without copying it
+ *
+ * @details
+ * The data is attached to the outgoing packets as it is, instead of
+ * copying it to network buffers. The data must not be modified until
+ * @p cb is called, which happens once the network stack does not need
+ * the data anymore: for datagram sockets after the datagram has been
+ * transmitted, for stream sockets after all of the data has been
+ * acknowledged by the peer. The callback is called from the network
+ * stack threads, so it must not block.
+ *
+ * All of the data is sent or none of it, the call waits for room in the
+ * send window according to the socket blocking mode and the
+ * ``SO_SNDTIMEO`` option. The number of sends in progress is limited by
+ * :kconfig:option:`CONFIG_NET_SOCKETS_SEND_ZEROCOPY_COUNT`.
+ *
+ * This function is only available to kernel threads and only for native
+ * TCP and UDP sockets.
+ *
+ * @param sock Socket descriptor
+ * @param data Data to send
+ * @param len Length of the data
+ * @param flags @c ZSOCK_MSG_DONTWAIT or 0
+ * @param cb Completion callback, called only if the call succeeded
+ * @param user_data User data passed to @p cb
+ *
+ * @return Number of bytes sent, or -1 and errno set on error. EPERM is
+ *         returned if called from user mode and EOPNOTSUPP if the socket
+ *         does not support zero-copy sends.
+ */
+ssize_t zsock_send_zerocopy(int sock, const void *data, size_t len, int flags,
+			    zsock_send_zerocopy_cb_t cb, void *user_data);
+
 /**
  * @brief Control blocking/non-blocking mode of a socket
  *
@@ -778,6 +986,28 @@ static inline ssize_t sendmsg(int sock, const struct msghdr *message,
 	return zsock_sendmsg(sock, message, flags);
 }
 
+/** POSIX wrapper for @ref zsock_sendmmsg */
+static inline int sendmmsg(int sock, struct mmsghdr *msgvec,
+			   unsigned int vlen, int flags)
+{
+	return zsock_sendmmsg(sock, msgvec, vlen, flags);
+}
+
+struct timespec;
+
+/** POSIX wrapper for @ref zsock_recvmmsg, only a NULL timeout is supported */
+static inline int recvmmsg(int sock, struct mmsghdr *msgvec,
+			   unsigned int vlen, int flags,
+			   struct timespec *timeout)
+{
+	if (timeout != NULL) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	return zsock_recvmmsg(sock, msgvec, vlen, flags);
+}
+
 /** POSIX wrapper for @ref zsock_recvfrom */
 static inline ssize_t recvfrom(int sock, void *buf, size_t max_len, int flags,
 			       struct sockaddr *src_addr, socklen_t *addrlen)
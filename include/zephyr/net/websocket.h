@@ -103,6 +103,12 @@ struct websocket_request {
 
 	/** Length of the user supplied temp buffer */
 	size_t tmp_buf_len;
+
+	/** Offer the permessage-deflate extension (RFC 7692) to the server.
+	 * Data messages are then compressed if the server accepts it. Only
+	 * used if CONFIG_WEBSOCKET_DEFLATE is enabled.
+	 */
+	bool permessage_deflate;
 };
 
 /**
@@ -169,6 +175,8 @@ int websocket_send_msg(int ws_sock, const uint8_t *payload, size_t payload_len,
  * @retval >=0 amount of bytes received.
  * @retval -EAGAIN on timeout.
  * @retval -ENOTCONN on socket close.
+ * @retval -EMSGSIZE if a compressed message was too long to be decompressed,
+ *         the message is dropped.
  * @retval -errno other negative errno value in case of failure.
  */
 int websocket_recv_msg(int ws_sock, uint8_t *buf, size_t buf_len,
@@ -26,7 +26,8 @@ extern "C" {
 enum zperf_status {
 	ZPERF_SESSION_STARTED,
 	ZPERF_SESSION_FINISHED,
-	ZPERF_SESSION_ERROR
+	ZPERF_SESSION_ERROR,
+	ZPERF_SESSION_STREAM_FINISHED,
 } __packed;
 
 struct zperf_upload_params {
@@ -38,6 +39,10 @@ struct zperf_upload_params {
 		uint8_t tos;
 		int tcp_nodelay;
 	} options;
+	/** Number of parallel streams, 0 or 1 for a single stream. At most
+	 *  CONFIG_NET_ZPERF_MAX_STREAMS streams can be used.
+	 */
+	uint8_t num_streams;
 };
 
 struct zperf_download_params {
@@ -55,11 +60,25 @@ struct zperf_results {
 	uint32_t client_time_in_us;
 	uint32_t packet_size;
 	uint32_t nb_packets_errors;
+	/** CPU utilization during the upload in 1/1000, only measured with
+	 *  CONFIG_NET_ZPERF_CPU_USAGE.
+	 */
+	uint32_t cpu_usage_permille;
+	/** Stream the results belong to, for ZPERF_SESSION_STREAM_FINISHED */
+	uint8_t stream_id;
+	/** Number of streams the results were gathered from */
+	uint8_t nb_streams;
 };
 
 /**
  * @brief Zperf callback function used for asynchronous operations.
  *
+ * An upload with several parallel streams reports the results of each
+ * stream with ZPERF_SESSION_STREAM_FINISHED, followed by the aggregate
+ * results with ZPERF_SESSION_FINISHED. The aggregate packet and byte
+ * counts are the sums of those of the streams, the durations and the
+ * jitter are the largest ones.
+ *
  * @param status Session status.
  * @param result Session results. May be NULL for certain events.
  * @param user_data A pointer to the user provided data.
@@ -73,7 +92,7 @@ typedef void (*zperf_callback)(enum zperf_status status,
  *        is complete.
  *
  * @param param Upload parameters.
- * @param result Session results.
+ * @param result Session results, aggregated over all streams.
  *
  * @return 0 if session completed successfully, a negative error code otherwise.
  */
@@ -85,7 +104,7 @@ int zperf_udp_upload(const struct zperf_upload_params *param,
  *        is complete.
  *
  * @param param Upload parameters.
- * @param result Session results.
+ * @param result Session results, aggregated over all streams.
  *
  * @return 0 if session completed successfully, a negative error code otherwise.
  */
@@ -45,6 +45,7 @@ void dns_result_cb(enum dns_resolve_status status,
 	case DNS_EAI_FAIL:
 		LOG_INF("DNS resolve failed");
 		return;
+	case DNS_EAI_NONAME:
 	case DNS_EAI_NODATA:
 		LOG_INF("Cannot resolve address");
 		return;
@@ -94,6 +95,7 @@ void mdns_result_cb(enum dns_resolve_status status,
 	case DNS_EAI_FAIL:
 		LOG_INF("mDNS resolve failed");
 		return;
+	case DNS_EAI_NONAME:
 	case DNS_EAI_NODATA:
 		LOG_INF("Cannot resolve address using mDNS");
 		return;
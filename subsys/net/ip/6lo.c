@@ -59,6 +59,58 @@ static const uint8_t da_inline_size_table[] = {
 	16, 8, 2, 0, 0, 8, 2, 0, 16, 6, 4, 1, 6
 	};
 
+/* Address bytes carried in-line, indexed like the size tables above.
+ * Multicast addresses are carried in two chunks: the flags/scope byte
+ * followed by the last bytes of the address.
+ */
+struct addr_inline {
+	uint8_t pos[2];
+	uint8_t len[2];
+};
+
+static const struct addr_inline sa_inline_table[] = {
+	{ {0}, {16} }, { {8}, {8} }, { {14}, {2} }, { {0}, {0} },
+	{ {0}, {0} }, { {8}, {8} }, { {14}, {2} }, { {0}, {0} },
+};
+
+/* M=1 DAC=1 (Unicast-Prefix based multicast) is never compressed */
+static const struct addr_inline da_inline_table[] = {
+	{ {0}, {16} }, { {8}, {8} }, { {14}, {2} }, { {0}, {0} },
+	{ {0}, {0} }, { {8}, {8} }, { {14}, {2} }, { {0}, {0} },
+	{ {0}, {16} }, { {1, 11}, {1, 5} }, { {1, 13}, {1, 3} }, { {15}, {1} },
+};
+
+static const uint8_t ll_prefix[8] = { 0xFE, 0x80 };
+
+/* Interface identifier of 16 bit compressible addresses: 0000:00ff:fe00:XXXX */
+static const uint8_t iid_16_bit[8] = { 0x00, 0x00, 0x00, 0xFF, 0xFE };
+
+#define NET_6LO_IPHC_ADDR_MASK (NET_6LO_IPHC_CID_MASK | NET_6LO_IPHC_SA_MASK | \
+				NET_6LO_IPHC_DA_MASK)
+
+#if CONFIG_NET_6LO_IPHC_CACHE_SIZE > 0
+/* Address compression selected for the last packets sent to a neighbor. The
+ * result only depends on the IPv6 and link layer addresses of the packet, and
+ * on the contexts, so it can be reused until the contexts change.
+ */
+struct iphc_cache_entry {
+	struct net_if *iface;
+	uint8_t src[NET_IPV6_ADDR_SIZE];
+	uint8_t dst[NET_IPV6_ADDR_SIZE];
+	uint8_t lladdr_src[NET_LINK_ADDR_MAX_LENGTH];
+	uint8_t lladdr_dst[NET_LINK_ADDR_MAX_LENGTH];
+	uint8_t lladdr_src_len;
+	uint8_t lladdr_dst_len;
+	uint16_t iphc;
+	uint8_t cid;
+};
+
+static struct iphc_cache_entry iphc_cache[CONFIG_NET_6LO_IPHC_CACHE_SIZE];
+static struct k_spinlock iphc_cache_lock;
+/* Incremented on each flush, a result computed before a flush is not cached */
+static uint32_t iphc_cache_gen;
+#endif
+
 static int get_udp_nhc_inlined_size(uint8_t nhc)
 {
 	int size = 0;
@@ -155,6 +207,149 @@ static inline bool net_6lo_maddr_48_bit_compressible(struct in6_addr *addr)
 		 (addr->s6_addr[10] == 0x00));
 }
 
+#if CONFIG_NET_6LO_IPHC_CACHE_SIZE > 0
+static bool iphc_cache_key_valid(struct net_pkt *pkt)
+{
+	return net_pkt_lladdr_src(pkt)->addr &&
+	       net_pkt_lladdr_dst(pkt)->addr &&
+	       net_pkt_lladdr_src(pkt)->len <= NET_LINK_ADDR_MAX_LENGTH &&
+	       net_pkt_lladdr_dst(pkt)->len <= NET_LINK_ADDR_MAX_LENGTH;
+}
+
+static struct iphc_cache_entry *iphc_cache_entry(struct net_pkt *pkt,
+						 const uint8_t *src,
+						 const uint8_t *dst)
+{
+	struct net_linkaddr *lladdr_dst = net_pkt_lladdr_dst(pkt);
+	uint8_t hash = src[15] ^ dst[15];
+
+	if (lladdr_dst->len > 0U) {
+		hash ^= lladdr_dst->addr[lladdr_dst->len - 1];
+	}
+
+	return &iphc_cache[hash % CONFIG_NET_6LO_IPHC_CACHE_SIZE];
+}
+
+static bool iphc_cache_match(struct iphc_cache_entry *entry,
+			     struct net_pkt *pkt, const uint8_t *src,
+			     const uint8_t *dst)
+{
+	struct net_linkaddr *lladdr_src = net_pkt_lladdr_src(pkt);
+	struct net_linkaddr *lladdr_dst = net_pkt_lladdr_dst(pkt);
+
+	return entry->iface == net_pkt_iface(pkt) &&
+	       entry->lladdr_src_len == lladdr_src->len &&
+	       entry->lladdr_dst_len == lladdr_dst->len &&
+	       net_ipv6_addr_cmp_raw(entry->dst, dst) &&
+	       net_ipv6_addr_cmp_raw(entry->src, src) &&
+	       !memcmp(entry->lladdr_dst, lladdr_dst->addr, lladdr_dst->len) &&
+	       !memcmp(entry->lladdr_src, lladdr_src->addr, lladdr_src->len);
+}
+
+static bool iphc_cache_get(struct net_pkt *pkt, struct net_ipv6_hdr *ipv6,
+			   uint16_t *iphc, uint8_t *cid)
+{
+	struct iphc_cache_entry *entry;
+	k_spinlock_key_t key;
+	bool found = false;
+
+	if (!iphc_cache_key_valid(pkt)) {
+		return false;
+	}
+
+	entry = iphc_cache_entry(pkt, ipv6->src, ipv6->dst);
+
+	key = k_spin_lock(&iphc_cache_lock);
+
+	if (iphc_cache_match(entry, pkt, ipv6->src, ipv6->dst)) {
+		*iphc |= entry->iphc;
+		*cid = entry->cid;
+		found = true;
+	}
+
+	k_spin_unlock(&iphc_cache_lock, key);
+
+	return found;
+}
+
+static uint32_t iphc_cache_gen_get(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&iphc_cache_lock);
+	uint32_t gen = iphc_cache_gen;
+
+	k_spin_unlock(&iphc_cache_lock, key);
+
+	return gen;
+}
+
+static void iphc_cache_set(struct net_pkt *pkt, const uint8_t *src,
+			   const uint8_t *dst, uint16_t iphc, uint8_t cid,
+			   uint32_t gen)
+{
+	struct net_linkaddr *lladdr_src = net_pkt_lladdr_src(pkt);
+	struct net_linkaddr *lladdr_dst = net_pkt_lladdr_dst(pkt);
+	struct iphc_cache_entry *entry;
+	k_spinlock_key_t key;
+
+	if (!iphc_cache_key_valid(pkt)) {
+		return;
+	}
+
+	entry = iphc_cache_entry(pkt, src, dst);
+
+	key = k_spin_lock(&iphc_cache_lock);
+
+	/* The contexts changed while the addresses were compressed */
+	if (gen != iphc_cache_gen) {
+		k_spin_unlock(&iphc_cache_lock, key);
+		return;
+	}
+
+	entry->iface = net_pkt_iface(pkt);
+	net_ipv6_addr_copy_raw(entry->src, src);
+	net_ipv6_addr_copy_raw(entry->dst, dst);
+	memcpy(entry->lladdr_src, lladdr_src->addr, lladdr_src->len);
+	memcpy(entry->lladdr_dst, lladdr_dst->addr, lladdr_dst->len);
+	entry->lladdr_src_len = lladdr_src->len;
+	entry->lladdr_dst_len = lladdr_dst->len;
+	entry->iphc = iphc & NET_6LO_IPHC_ADDR_MASK;
+	entry->cid = cid;
+
+	k_spin_unlock(&iphc_cache_lock, key);
+}
+
+static inline void iphc_cache_flush(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&iphc_cache_lock);
+
+	memset(iphc_cache, 0, sizeof(iphc_cache));
+	iphc_cache_gen++;
+
+	k_spin_unlock(&iphc_cache_lock, key);
+}
+#else
+static inline bool iphc_cache_get(struct net_pkt *pkt, struct net_ipv6_hdr *ipv6,
+				  uint16_t *iphc, uint8_t *cid)
+{
+	return false;
+}
+
+static inline uint32_t iphc_cache_gen_get(void)
+{
+	return 0;
+}
+
+static inline void iphc_cache_set(struct net_pkt *pkt, const uint8_t *src,
+				  const uint8_t *dst, uint16_t iphc, uint8_t cid,
+				  uint32_t gen)
+{
+}
+
+static inline void iphc_cache_flush(void)
+{
+}
+#endif /* CONFIG_NET_6LO_IPHC_CACHE_SIZE > 0 */
+
 #if defined(CONFIG_NET_6LO_CONTEXT)
 /* RFC 6775, 4.2, 5.4.2, 5.4.3 and 7.2*/
 static inline void set_6lo_context(struct net_if *iface, uint8_t index,
@@ -172,8 +367,8 @@ static inline void set_6lo_context(struct net_if *iface, uint8_t index,
 	net_ipv6_addr_copy_raw((uint8_t *)&ctx_6co[index].prefix, context->prefix);
 }
 
-void net_6lo_set_context(struct net_if *iface,
-			 struct net_icmpv6_nd_opt_6co *context)
+static void update_6lo_context(struct net_if *iface,
+			       struct net_icmpv6_nd_opt_6co *context)
 {
 	int unused = -1;
 	uint8_t i;
@@ -210,6 +405,18 @@ void net_6lo_set_context(struct net_if *iface,
 	NET_DBG("Either no free slots in the table or exceeds limit");
 }
 
+void net_6lo_set_context(struct net_if *iface,
+			 struct net_icmpv6_nd_opt_6co *context)
+{
+	update_6lo_context(iface, context);
+
+	/* Cached compression results may depend on the old contexts. Results
+	 * computed before this point are not cached anymore, see
+	 * iphc_cache_set().
+	 */
+	iphc_cache_flush();
+}
+
 /* Get the context by matching cid */
 static inline struct net_6lo_context *
 get_6lo_context_by_cid(struct net_if *iface, uint8_t cid)
@@ -717,72 +924,52 @@ static struct net_6lo_context *get_dst_addr_ctx(struct net_pkt *pkt,
 }
 #endif /* CONFIG_NET_6LO_CONTEXT */
 
-/* RFC 6282 LOWPAN IPHC Encoding format (3.1)
- *  Base Format
- *   0                                       1
- *   0   1   2   3   4   5   6   7   8   9   0   1   2   3   4   5
- * +---+---+---+---+---+---+---+---+---+---+---+---+---+---+---+---+
- * | 0 | 1 | 1 |  TF   |NH | HLIM  |CID|SAC|  SAM  | M |DAC|  DAM  |
- * +---+---+---+---+---+---+---+---+---+---+---+---+---+---+---+---+
- */
-static inline int compress_IPHC_header(struct net_pkt *pkt)
+/* Helper to copy the in-line bytes of an address selected by the tables */
+static inline uint8_t *set_addr_inline(const uint8_t *addr, uint8_t *inline_ptr,
+				       const struct addr_inline *chunks)
+{
+	inline_ptr -= chunks->len[1];
+	memmove(inline_ptr, &addr[chunks->pos[1]], chunks->len[1]);
+
+	inline_ptr -= chunks->len[0];
+	memmove(inline_ptr, &addr[chunks->pos[0]], chunks->len[0]);
+
+	return inline_ptr;
+}
+
+/* Helper to select the compression of the Source and Destination Address */
+static uint8_t *compress_addr(struct net_pkt *pkt, struct net_ipv6_hdr *ipv6,
+			      uint8_t *inline_pos, uint16_t *iphc, uint8_t *cid)
 {
 #if defined(CONFIG_NET_6LO_CONTEXT)
 	struct net_6lo_context *src_ctx = NULL;
 	struct net_6lo_context *dst_ctx = NULL;
 #endif
-	uint8_t compressed = 0;
-	uint16_t iphc = (NET_6LO_DISPATCH_IPHC << 8);
-	struct net_ipv6_hdr *ipv6 = NET_IPV6_HDR(pkt);
-	struct net_udp_hdr *udp;
-	uint8_t *inline_pos;
-
-	if (pkt->frags->len < NET_IPV6H_LEN) {
-		NET_ERR("Invalid length %d, min %d",
-			pkt->frags->len, NET_IPV6H_LEN);
-		return -EINVAL;
-	}
-
-	if (ipv6->nexthdr == IPPROTO_UDP &&
-	    pkt->frags->len < NET_IPV6UDPH_LEN) {
-		NET_ERR("Invalid length %d, min %d",
-			pkt->frags->len, NET_IPV6UDPH_LEN);
-		return -EINVAL;
-	}
-
-	inline_pos = pkt->buffer->data + NET_IPV6H_LEN;
-
-	if (ipv6->nexthdr == IPPROTO_UDP) {
-		udp = (struct net_udp_hdr *)inline_pos;
-		inline_pos += NET_UDPH_LEN;
-
-		inline_pos = compress_nh_udp(udp, inline_pos, false);
-	}
 
 	if (net_6lo_ll_prefix_padded_with_zeros((struct in6_addr *)ipv6->dst)) {
-		inline_pos = compress_da(ipv6, pkt, inline_pos, &iphc);
+		inline_pos = compress_da(ipv6, pkt, inline_pos, iphc);
 		goto da_end;
 	}
 
 	if (net_ipv6_is_addr_mcast((struct in6_addr *)ipv6->dst)) {
-		inline_pos = compress_da_mcast(ipv6, inline_pos, &iphc);
+		inline_pos = compress_da_mcast(ipv6, inline_pos, iphc);
 		goto da_end;
 	}
 
 #if defined(CONFIG_NET_6LO_CONTEXT)
 	dst_ctx = get_dst_addr_ctx(pkt, ipv6);
 	if (dst_ctx) {
-		iphc |= NET_6LO_IPHC_CID_1;
-		inline_pos = compress_da_ctx(ipv6, inline_pos, pkt, &iphc,
+		*iphc |= NET_6LO_IPHC_CID_1;
+		inline_pos = compress_da_ctx(ipv6, inline_pos, pkt, iphc,
 					     dst_ctx);
 		goto da_end;
 	}
 #endif
-	inline_pos = set_da_inline(ipv6, inline_pos, &iphc);
+	inline_pos = set_da_inline(ipv6, inline_pos, iphc);
 da_end:
 
 	if (net_6lo_ll_prefix_padded_with_zeros((struct in6_addr *)ipv6->src)) {
-		inline_pos = compress_sa(ipv6, pkt, inline_pos, &iphc);
+		inline_pos = compress_sa(ipv6, pkt, inline_pos, iphc);
 		goto sa_end;
 	}
 
@@ -790,41 +977,107 @@ da_end:
 		NET_DBG("SAM_00, SAC_1 unspecified src address");
 
 		/* Unspecified IPv6 src address */
-		iphc |= NET_6LO_IPHC_SAC_1;
-		iphc |= NET_6LO_IPHC_SAM_00;
+		*iphc |= NET_6LO_IPHC_SAC_1;
+		*iphc |= NET_6LO_IPHC_SAM_00;
 		goto sa_end;
 	}
 
 #if defined(CONFIG_NET_6LO_CONTEXT)
 	src_ctx = get_src_addr_ctx(pkt, ipv6);
 	if (src_ctx) {
-		inline_pos = compress_sa_ctx(ipv6, inline_pos, pkt, &iphc,
+		inline_pos = compress_sa_ctx(ipv6, inline_pos, pkt, iphc,
 					     src_ctx);
-		iphc |= NET_6LO_IPHC_CID_1;
+		*iphc |= NET_6LO_IPHC_CID_1;
 		goto sa_end;
 	}
 #endif
-	inline_pos = set_sa_inline(ipv6, inline_pos, &iphc);
+	inline_pos = set_sa_inline(ipv6, inline_pos, iphc);
 sa_end:
 
+	*cid = 0U;
+
+#if defined(CONFIG_NET_6LO_CONTEXT)
+	if (src_ctx) {
+		*cid = src_ctx->cid << 4;
+	}
+
+	if (dst_ctx) {
+		*cid |= dst_ctx->cid & 0x0F;
+	}
+#endif
+
+	return inline_pos;
+}
+
+/* RFC 6282 LOWPAN IPHC Encoding format (3.1)
+ *  Base Format
+ *   0                                       1
+ *   0   1   2   3   4   5   6   7   8   9   0   1   2   3   4   5
+ * +---+---+---+---+---+---+---+---+---+---+---+---+---+---+---+---+
+ * | 0 | 1 | 1 |  TF   |NH | HLIM  |CID|SAC|  SAM  | M |DAC|  DAM  |
+ * +---+---+---+---+---+---+---+---+---+---+---+---+---+---+---+---+
+ */
+static inline int compress_IPHC_header(struct net_pkt *pkt)
+{
+	uint8_t compressed = 0;
+	uint16_t iphc = (NET_6LO_DISPATCH_IPHC << 8);
+	struct net_ipv6_hdr *ipv6 = NET_IPV6_HDR(pkt);
+	struct net_udp_hdr *udp;
+	struct in6_addr src, dst;
+	uint8_t *inline_pos;
+	uint8_t cid;
+
+	if (pkt->frags->len < NET_IPV6H_LEN) {
+		NET_ERR("Invalid length %d, min %d",
+			pkt->frags->len, NET_IPV6H_LEN);
+		return -EINVAL;
+	}
+
+	if (ipv6->nexthdr == IPPROTO_UDP &&
+	    pkt->frags->len < NET_IPV6UDPH_LEN) {
+		NET_ERR("Invalid length %d, min %d",
+			pkt->frags->len, NET_IPV6UDPH_LEN);
+		return -EINVAL;
+	}
+
+	inline_pos = pkt->buffer->data + NET_IPV6H_LEN;
+
+	if (ipv6->nexthdr == IPPROTO_UDP) {
+		udp = (struct net_udp_hdr *)inline_pos;
+		inline_pos += NET_UDPH_LEN;
+
+		inline_pos = compress_nh_udp(udp, inline_pos, false);
+	}
+
+	if (iphc_cache_get(pkt, ipv6, &iphc, &cid)) {
+		/* Same addresses as a previous packet, only copy the bytes
+		 * carried in-line.
+		 */
+		inline_pos = set_addr_inline(ipv6->dst, inline_pos,
+			&da_inline_table[(iphc & NET_6LO_IPHC_DA_MASK) >>
+					 NET_6LO_IPHC_DAM_POS]);
+		inline_pos = set_addr_inline(ipv6->src, inline_pos,
+			&sa_inline_table[(iphc & NET_6LO_IPHC_SA_MASK) >>
+					 NET_6LO_IPHC_SAM_POS]);
+	} else {
+		uint32_t gen = iphc_cache_gen_get();
+
+		/* The addresses are overwritten while being compressed */
+		net_ipv6_addr_copy_raw((uint8_t *)&src, ipv6->src);
+		net_ipv6_addr_copy_raw((uint8_t *)&dst, ipv6->dst);
+
+		inline_pos = compress_addr(pkt, ipv6, inline_pos, &iphc, &cid);
+		iphc_cache_set(pkt, src.s6_addr, dst.s6_addr, iphc, cid, gen);
+	}
+
 	inline_pos = compress_hoplimit(ipv6, inline_pos, &iphc);
 	inline_pos = compress_nh(ipv6, inline_pos, &iphc);
 	inline_pos = compress_tfl(ipv6, inline_pos, &iphc);
 
-#if defined(CONFIG_NET_6LO_CONTEXT)
 	if (iphc & NET_6LO_IPHC_CID_1) {
 		inline_pos -= sizeof(uint8_t);
-		*inline_pos = 0;
-
-		if (src_ctx) {
-			*inline_pos = src_ctx->cid << 4;
-		}
-
-		if (dst_ctx) {
-			*inline_pos |= dst_ctx->cid & 0x0F;
-		}
+		*inline_pos = cid;
 	}
-#endif
 
 	inline_pos -= sizeof(iphc);
 	iphc = htons(iphc);
@@ -923,127 +1176,33 @@ static inline uint8_t *uncompress_hoplimit(uint16_t iphc, uint8_t *cursor,
 	return cursor;
 }
 
-/* Helper to uncompress Source Address */
-static inline uint8_t *uncompress_sa(uint16_t iphc, uint8_t *cursor,
-				 struct net_ipv6_hdr *ipv6,
-				 struct net_pkt *pkt)
+/* Helper to uncompress an unicast Source or Destination Address. The prefix
+ * is either the link-local prefix or the one of a context, the interface
+ * identifier is either carried in-line, derived from 16 bits carried in-line
+ * or derived from the link layer address.
+ */
+static inline uint8_t *uncompress_addr(uint8_t am, const uint8_t *prefix,
+				       uint8_t *cursor, uint8_t *addr,
+				       struct net_linkaddr *lladdr)
 {
-	struct in6_addr src_ip;
-
-	NET_DBG("SAC_0");
-
-	net_ipv6_addr_copy_raw((uint8_t *)&src_ip, ipv6->src);
-
-	switch (iphc & NET_6LO_IPHC_SAM_MASK) {
-	case NET_6LO_IPHC_SAM_00:
-		NET_DBG("SAM_00 full src addr inlined");
-
-		memmove(src_ip.s6_addr, cursor, sizeof(src_ip.s6_addr));
-		cursor += sizeof(src_ip.s6_addr);
-
-		break;
-	case NET_6LO_IPHC_SAM_01:
-		NET_DBG("SAM_01 last 64 bits are inlined");
+	uint8_t len = sa_inline_size_table[am];
+	struct in6_addr ip;
 
-		memmove(&src_ip.s6_addr[8], cursor, 8);
-		cursor += 8U;
+	NET_DBG("AM_%u%u %u bytes inlined", am >> 1, am & 0x01, len);
 
-		src_ip.s6_addr32[0] = 0x00;
-		src_ip.s6_addr32[1] = 0x00;
-		src_ip.s6_addr[0] = 0xFE;
-		src_ip.s6_addr[1] = 0x80;
-
-		break;
-	case NET_6LO_IPHC_SAM_10:
-		NET_DBG("SAM_10 src addr 16 bit compressed");
-
-		memmove(&src_ip.s6_addr[14], cursor, 2);
-		cursor += 2U;
-		src_ip.s6_addr16[6] = 0x00;
-
-		src_ip.s6_addr32[0] = 0x00;
-		src_ip.s6_addr32[1] = 0x00;
-		src_ip.s6_addr32[2] = 0x00;
-		src_ip.s6_addr[0] = 0xFE;
-		src_ip.s6_addr[1] = 0x80;
-		src_ip.s6_addr[11] = 0xFF;
-		src_ip.s6_addr[12] = 0xFE;
-
-		break;
-	case NET_6LO_IPHC_SAM_11:
-		NET_DBG("SAM_11 generate src addr from ll");
-
-		net_ipv6_addr_create_iid(&src_ip, net_pkt_lladdr_src(pkt));
-
-		break;
+	if (len == 0U) {
+		net_ipv6_addr_create_iid(&ip, lladdr);
+	} else {
+		memcpy(&ip.s6_addr[8], iid_16_bit, sizeof(iid_16_bit));
 	}
 
-	net_ipv6_addr_copy_raw(ipv6->src, (uint8_t *)&src_ip);
+	memcpy(&ip.s6_addr[0], prefix, 8);
+	memcpy(&ip.s6_addr[sizeof(ip) - len], cursor, len);
 
-	return cursor;
-}
-
-#if defined(CONFIG_NET_6LO_CONTEXT)
-static inline uint8_t *uncompress_sa_ctx(uint16_t iphc, uint8_t *cursor,
-				     struct net_ipv6_hdr *ipv6,
-				     struct net_6lo_context *ctx,
-				     struct net_pkt *pkt)
-{
-	struct in6_addr src_ip;
+	net_ipv6_addr_copy_raw(addr, (uint8_t *)&ip);
 
-	net_ipv6_addr_copy_raw((uint8_t *)&src_ip, ipv6->src);
-
-	switch (iphc & NET_6LO_IPHC_SAM_MASK) {
-	case NET_6LO_IPHC_SAM_01:
-		NET_DBG("SAM_01 last 64 bits are inlined");
-
-		/* First 8 bytes are from context */
-		memmove(&src_ip.s6_addr[0], &ctx->prefix.s6_addr[0], 8);
-
-		/* And the rest are carried in-line*/
-		memmove(&src_ip.s6_addr[8], cursor, 8);
-		cursor += 8U;
-
-		break;
-	case NET_6LO_IPHC_SAM_10:
-		NET_DBG("SAM_10 src addr 16 bit compressed");
-
-		/* 16 bit carried in-line */
-		memmove(&src_ip.s6_addr[14], cursor, 2);
-		cursor += 2U;
-
-		/* First 8 bytes are from context */
-		memmove(&src_ip.s6_addr[0], &ctx->prefix.s6_addr[0], 8);
-
-		src_ip.s6_addr32[2] = 0x00;
-		src_ip.s6_addr16[6] = 0x00;
-		src_ip.s6_addr[11] = 0xFF;
-		src_ip.s6_addr[12] = 0xFE;
-
-		break;
-	case NET_6LO_IPHC_SAM_11:
-		NET_DBG("SAM_11 generate src addr from ll");
-
-		/* RFC 6282, 3.1.1. If SAC = 1 and SAM = 11
-		 * Derive addr using context information and
-		 * the encapsulating header.
-		 * (e.g., 802.15.4 or IPv6 source address).
-		 */
-		net_ipv6_addr_create_iid(&src_ip, net_pkt_lladdr_src(pkt));
-
-		/* net_ipv6_addr_create_iid will copy first 8 bytes
-		 * as link local prefix.
-		 * Overwrite first 8 bytes from context prefix here.
-		 */
-		memmove(&src_ip.s6_addr[0], &ctx->prefix.s6_addr[0], 8);
-		break;
-	}
-
-	net_ipv6_addr_copy_raw(ipv6->src, (uint8_t *)&src_ip);
-
-	return cursor;
+	return cursor + len;
 }
-#endif
 
 /* Helpers to uncompress Destination Address */
 static inline uint8_t *uncompress_da_mcast(uint16_t iphc, uint8_t *cursor,
@@ -1129,132 +1288,6 @@ static inline uint8_t *uncompress_da_mcast(uint16_t iphc, uint8_t *cursor,
 	return cursor;
 }
 
-/* Helper to uncompress Destination Address */
-static inline uint8_t *uncompress_da(uint16_t iphc, uint8_t *cursor,
-				 struct net_ipv6_hdr *ipv6,
-				 struct net_pkt *pkt)
-{
-	struct in6_addr dst_ip;
-
-	NET_DBG("DAC_0");
-
-	net_ipv6_addr_copy_raw((uint8_t *)&dst_ip, ipv6->dst);
-
-	switch (iphc & NET_6LO_IPHC_DAM_MASK) {
-	case NET_6LO_IPHC_DAM_00:
-		NET_DBG("DAM_00 full dst addr inlined");
-
-		memmove(&dst_ip.s6_addr[0], cursor,
-			sizeof(dst_ip.s6_addr));
-		cursor += sizeof(dst_ip.s6_addr);
-
-		break;
-	case NET_6LO_IPHC_DAM_01:
-		NET_DBG("DAM_01 last 64 bits are inlined");
-
-		memmove(&dst_ip.s6_addr[8], cursor, 8);
-		cursor += 8U;
-
-		dst_ip.s6_addr32[0] = 0x00;
-		dst_ip.s6_addr32[1] = 0x00;
-		dst_ip.s6_addr[0] = 0xFE;
-		dst_ip.s6_addr[1] = 0x80;
-
-		break;
-	case NET_6LO_IPHC_DAM_10:
-		NET_DBG("DAM_10 dst addr 16 bit compressed");
-
-		memmove(&dst_ip.s6_addr[14], cursor, 2);
-		cursor += 2U;
-
-		dst_ip.s6_addr32[0] = 0x00;
-		dst_ip.s6_addr32[1] = 0x00;
-		dst_ip.s6_addr32[2] = 0x00;
-		dst_ip.s6_addr16[6] = 0x00;
-		dst_ip.s6_addr[0] = 0xFE;
-		dst_ip.s6_addr[1] = 0x80;
-		dst_ip.s6_addr[11] = 0xFF;
-		dst_ip.s6_addr[12] = 0xFE;
-
-		break;
-	case NET_6LO_IPHC_DAM_11:
-		NET_DBG("DAM_11 generate dst addr from ll");
-
-		net_ipv6_addr_create_iid(&dst_ip, net_pkt_lladdr_dst(pkt));
-
-		break;
-	}
-
-	net_ipv6_addr_copy_raw(ipv6->dst, (uint8_t *)&dst_ip);
-
-	return cursor;
-}
-
-#if defined(CONFIG_NET_6LO_CONTEXT)
-static inline uint8_t *uncompress_da_ctx(uint16_t iphc, uint8_t *cursor,
-				     struct net_ipv6_hdr *ipv6,
-				     struct net_6lo_context *ctx,
-				     struct net_pkt *pkt)
-{
-	struct in6_addr dst_ip;
-
-	NET_DBG("DAC_1");
-
-	net_ipv6_addr_copy_raw((uint8_t *)&dst_ip, ipv6->dst);
-
-	switch (iphc & NET_6LO_IPHC_DAM_MASK) {
-	case NET_6LO_IPHC_DAM_01:
-		NET_DBG("DAM_01 last 64 bits are inlined");
-
-		/* Last 8 bytes carried in-line */
-		memmove(&dst_ip.s6_addr[8], cursor, 8);
-		cursor += 8U;
-
-		/* First 8 bytes are from context */
-		memmove(&dst_ip.s6_addr[0], &ctx->prefix.s6_addr[0], 8);
-
-		break;
-	case NET_6LO_IPHC_DAM_10:
-		NET_DBG("DAM_10 src addr 16 bit compressed");
-
-		/* 16 bit carried in-line */
-		memmove(&dst_ip.s6_addr[14], cursor, 2);
-		cursor += 2U;
-
-		/* First 8 bytes are from context */
-		memmove(&dst_ip.s6_addr[0], &ctx->prefix.s6_addr[0], 8);
-
-		dst_ip.s6_addr32[2] = 0x00;
-		dst_ip.s6_addr16[6] = 0x00;
-		dst_ip.s6_addr[11] = 0xFF;
-		dst_ip.s6_addr[12] = 0xFE;
-
-		break;
-	case NET_6LO_IPHC_DAM_11:
-		NET_DBG("DAM_11 generate src addr from ll");
-
-		/* RFC 6282, 3.1.1. If SAC = 1 and SAM = 11
-		 * Derive addr using context information and
-		 * the encapsulating header.
-		 * (e.g., 802.15.4 or IPv6 source address).
-		 */
-		net_ipv6_addr_create_iid(&dst_ip, net_pkt_lladdr_dst(pkt));
-
-		/* net_ipv6_addr_create_iid will copy first 8 bytes
-		 * as link local prefix.
-		 * Overwrite first 8 bytes from context prefix here.
-		 */
-		memmove(&dst_ip.s6_addr[0], &ctx->prefix.s6_addr[0], 8);
-
-		break;
-	}
-
-	net_ipv6_addr_copy_raw(ipv6->dst, (uint8_t *)&dst_ip);
-
-	return cursor;
-}
-#endif
-
 /* Helper to uncompress NH UDP */
 static uint8_t *uncompress_nh_udp(uint8_t nhc, uint8_t *cursor,
 				      struct net_udp_hdr *udp)
@@ -1356,6 +1389,7 @@ static bool uncompress_IPHC_header(struct net_pkt *pkt)
 	int inline_size, compressed_hdr_size;
 	size_t diff;
 	uint8_t *cursor;
+	uint8_t sam, dam;
 #if defined(CONFIG_NET_6LO_CONTEXT)
 	struct net_6lo_context *src = NULL;
 	struct net_6lo_context *dst = NULL;
@@ -1438,6 +1472,9 @@ static bool uncompress_IPHC_header(struct net_pkt *pkt)
 	/* Uncompress Hoplimit */
 	cursor = uncompress_hoplimit(iphc, cursor, ipv6);
 
+	sam = (iphc & NET_6LO_IPHC_SAM_MASK) >> NET_6LO_IPHC_SAM_POS;
+	dam = (iphc & NET_6LO_IPHC_DAM_MASK) >> NET_6LO_IPHC_DAM_POS;
+
 	/* Uncompress Source Address */
 	if (iphc & NET_6LO_IPHC_SAC_1) {
 		NET_DBG("SAC_1");
@@ -1453,14 +1490,16 @@ static bool uncompress_IPHC_header(struct net_pkt *pkt)
 				goto fail;
 			}
 
-			cursor = uncompress_sa_ctx(iphc, cursor, ipv6, src, pkt);
+			cursor = uncompress_addr(sam, src->prefix.s6_addr, cursor,
+						 ipv6->src, net_pkt_lladdr_src(pkt));
 #endif
 		} else {
 			NET_ERR("Context based uncompression not enabled");
 			goto fail;
 		}
 	} else {
-		cursor = uncompress_sa(iphc, cursor, ipv6, pkt);
+		cursor = uncompress_addr(sam, ll_prefix, cursor, ipv6->src,
+					 net_pkt_lladdr_src(pkt));
 	}
 
 	/* Uncompress Destination Address */
@@ -1482,13 +1521,20 @@ static bool uncompress_IPHC_header(struct net_pkt *pkt)
 				goto fail;
 			}
 
-			cursor = uncompress_da_ctx(iphc, cursor, ipv6, dst, pkt);
+			if (dam == 0U) {
+				NET_ERR("DAC_1 and DAM_00 is reserved");
+				goto fail;
+			}
+
+			cursor = uncompress_addr(dam, dst->prefix.s6_addr, cursor,
+						 ipv6->dst, net_pkt_lladdr_dst(pkt));
 #else
 			NET_ERR("Context based uncompression not enabled");
 			goto fail;
 #endif
 		} else {
-			cursor = uncompress_da(iphc, cursor, ipv6, pkt);
+			cursor = uncompress_addr(dam, ll_prefix, cursor, ipv6->dst,
+						 net_pkt_lladdr_dst(pkt));
 		}
 	}
 
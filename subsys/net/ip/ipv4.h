@@ -266,8 +266,23 @@ static inline void net_ipv4_set_ecn(uint8_t *tos, uint8_t ecn)
 }
 
 #if defined(CONFIG_NET_IPV4_FRAGMENT)
+/** Range of the datagram payload that has not been received yet. */
+struct net_ipv4_reassembly_hole {
+	/** Offset of the first missing byte */
+	uint32_t start;
+
+	/** Offset following the last missing byte */
+	uint32_t end;
+};
+
 /** Store pending IPv4 fragment information that is needed for reassembly. */
 struct net_ipv4_reassembly {
+	/** Node in the reassembly hash table or in the free list */
+	sys_snode_t node;
+
+	/** Node in the list of pending reassemblies, oldest first */
+	sys_dnode_t age_node;
+
 	/** IPv4 source address of the fragment */
 	struct in_addr src;
 
@@ -283,9 +298,22 @@ struct net_ipv4_reassembly {
 	/** Pointers to pending fragments */
 	struct net_pkt *pkt[CONFIG_NET_IPV4_FRAGMENT_MAX_PKT];
 
+	/**
+	 * Holes not yet filled by received fragments (RFC 815). Each
+	 * fragment can split one hole in two, so one more than the
+	 * number of fragments is enough.
+	 */
+	struct net_ipv4_reassembly_hole holes[CONFIG_NET_IPV4_FRAGMENT_MAX_PKT + 1];
+
+	/** Amount of fragment data held by this reassembly */
+	uint32_t mem;
+
 	/** IPv4 fragment identification */
 	uint16_t id;
 	uint8_t protocol;
+
+	/** Number of valid entries in holes */
+	uint8_t hole_count;
 };
 #else
 struct net_ipv4_reassembly;
@@ -27,87 +27,131 @@ LOG_MODULE_DECLARE(net_ipv4, CONFIG_NET_IPV4_LOG_LEVEL);
 /* Timeout for various buffer allocations in this file. */
 #define NET_BUF_TIMEOUT K_MSEC(100)
 
+/* Reassemblies waiting for more fragments are kept in a hash table keyed by
+ * the fragment id and addresses, and in a list ordered by age. The unused
+ * ones are in a free list.
+ */
+#define REASSEMBLY_HASH_SIZE CONFIG_NET_IPV4_FRAGMENT_HASH_SIZE
+
+BUILD_ASSERT(IS_POWER_OF_TWO(REASSEMBLY_HASH_SIZE),
+	     "Reassembly hash size must be a power of two");
+
+/* End offset of the hole that is open until the last fragment arrives */
+#define HOLE_OPEN_END UINT32_MAX
+
 static void reassembly_timeout(struct k_work *work);
 
 static struct net_ipv4_reassembly reassembly[CONFIG_NET_IPV4_FRAGMENT_MAX_COUNT];
+static sys_slist_t reassembly_hash[REASSEMBLY_HASH_SIZE];
+static sys_slist_t reassembly_free;
+static sys_dlist_t reassembly_age = SYS_DLIST_STATIC_INIT(&reassembly_age);
 
-static struct net_ipv4_reassembly *reassembly_get(uint16_t id, struct in_addr *src,
-						  struct in_addr *dst, uint8_t protocol)
+/* Amount of fragment data held by all pending reassemblies */
+static uint32_t reassembly_mem;
+
+static K_MUTEX_DEFINE(reassembly_lock);
+
+static sys_slist_t *reassembly_bucket(uint16_t id, const struct in_addr *src,
+				      const struct in_addr *dst, uint8_t protocol)
 {
-	int i, avail = -1;
-
-	for (i = 0; i < CONFIG_NET_IPV4_FRAGMENT_MAX_COUNT; i++) {
-		if (k_work_delayable_remaining_get(&reassembly[i].timer) &&
-		    reassembly[i].id == id &&
-		    net_ipv4_addr_cmp(src, &reassembly[i].src) &&
-		    net_ipv4_addr_cmp(dst, &reassembly[i].dst) &&
-		    reassembly[i].protocol == protocol) {
-			return &reassembly[i];
-		}
+	uint32_t key;
 
-		if (k_work_delayable_remaining_get(&reassembly[i].timer)) {
-			continue;
-		}
+	key = UNALIGNED_GET(&src->s_addr) ^ UNALIGNED_GET(&dst->s_addr) ^
+	      ((uint32_t)protocol << 16 | id);
+	key *= 0x9e3779b1U;
 
-		if (avail < 0) {
-			avail = i;
+	return &reassembly_hash[(key >> 16) & (REASSEMBLY_HASH_SIZE - 1)];
+}
+
+static struct net_ipv4_reassembly *reassembly_get(uint16_t id, struct in_addr *src,
+						  struct in_addr *dst, uint8_t protocol)
+{
+	sys_slist_t *bucket = reassembly_bucket(id, src, dst, protocol);
+	struct net_ipv4_reassembly *reass;
+	sys_snode_t *free_node;
+
+	SYS_SLIST_FOR_EACH_CONTAINER(bucket, reass, node) {
+		if (reass->id == id &&
+		    net_ipv4_addr_cmp(src, &reass->src) &&
+		    net_ipv4_addr_cmp(dst, &reass->dst) &&
+		    reass->protocol == protocol) {
+			return reass;
 		}
 	}
 
-	if (avail < 0) {
+	free_node = sys_slist_get(&reassembly_free);
+	if (!free_node) {
 		return NULL;
 	}
 
-	k_work_reschedule(&reassembly[avail].timer, K_SECONDS(CONFIG_NET_IPV4_FRAGMENT_TIMEOUT));
+	reass = CONTAINER_OF(free_node, struct net_ipv4_reassembly, node);
+
+	k_work_reschedule(&reass->timer, K_SECONDS(CONFIG_NET_IPV4_FRAGMENT_TIMEOUT));
+
+	net_ipaddr_copy(&reass->src, src);
+	net_ipaddr_copy(&reass->dst, dst);
 
-	net_ipaddr_copy(&reassembly[avail].src, src);
-	net_ipaddr_copy(&reassembly[avail].dst, dst);
+	reass->protocol = protocol;
+	reass->id = id;
+	reass->mem = 0U;
 
-	reassembly[avail].protocol = protocol;
-	reassembly[avail].id = id;
+	/* Nothing received yet, the whole datagram is one open ended hole */
+	reass->holes[0].start = 0U;
+	reass->holes[0].end = HOLE_OPEN_END;
+	reass->hole_count = 1U;
 
-	return &reassembly[avail];
+	sys_slist_prepend(bucket, &reass->node);
+	sys_dlist_append(&reassembly_age, &reass->age_node);
+
+	return reass;
 }
 
-static bool reassembly_cancel(uint32_t id, struct in_addr *src, struct in_addr *dst)
+/* Return the reassembly slot to the free list. The fragments must have been
+ * released or moved away before calling this.
+ */
+static void reassembly_release(struct net_ipv4_reassembly *reass)
 {
-	int i, j;
+	k_work_cancel_delayable(&reass->timer);
 
-	LOG_DBG("Cancel 0x%x", id);
+	if (!sys_slist_find_and_remove(reassembly_bucket(reass->id, &reass->src,
+							 &reass->dst, reass->protocol),
+				       &reass->node)) {
+		return;
+	}
 
-	for (i = 0; i < CONFIG_NET_IPV4_FRAGMENT_MAX_COUNT; i++) {
-		int32_t remaining;
+	sys_dlist_remove(&reass->age_node);
 
-		if (reassembly[i].id != id ||
-		    !net_ipv4_addr_cmp(src, &reassembly[i].src) ||
-		    !net_ipv4_addr_cmp(dst, &reassembly[i].dst)) {
-			continue;
-		}
+	reassembly_mem -= reass->mem;
+	reass->mem = 0U;
+	reass->id = 0U;
 
-		remaining = k_ticks_to_ms_ceil32(
-			k_work_delayable_remaining_get(&reassembly[i].timer));
-		k_work_cancel_delayable(&reassembly[i].timer);
+	sys_slist_append(&reassembly_free, &reass->node);
+}
 
-		LOG_DBG("IPv4 reassembly id 0x%x remaining %d ms", reassembly[i].id, remaining);
+static void reassembly_cancel(struct net_ipv4_reassembly *reass)
+{
+	int32_t remaining;
+	int j;
 
-		reassembly[i].id = 0U;
+	LOG_DBG("Cancel 0x%x", reass->id);
 
-		for (j = 0; j < CONFIG_NET_IPV4_FRAGMENT_MAX_PKT; j++) {
-			if (!reassembly[i].pkt[j]) {
-				continue;
-			}
+	remaining = k_ticks_to_ms_ceil32(k_work_delayable_remaining_get(&reass->timer));
 
-			LOG_DBG("[%d] IPv4 reassembly pkt %p %zd bytes data", j,
-				reassembly[i].pkt[j], net_pkt_get_len(reassembly[i].pkt[j]));
+	LOG_DBG("IPv4 reassembly id 0x%x remaining %d ms", reass->id, remaining);
 
-			net_pkt_unref(reassembly[i].pkt[j]);
-			reassembly[i].pkt[j] = NULL;
+	for (j = 0; j < CONFIG_NET_IPV4_FRAGMENT_MAX_PKT; j++) {
+		if (!reass->pkt[j]) {
+			continue;
 		}
 
-		return true;
+		LOG_DBG("[%d] IPv4 reassembly pkt %p %zd bytes data", j,
+			reass->pkt[j], net_pkt_get_len(reass->pkt[j]));
+
+		net_pkt_unref(reass->pkt[j]);
+		reass->pkt[j] = NULL;
 	}
 
-	return false;
+	reassembly_release(reass);
 }
 
 static void reassembly_info(char *str, struct net_ipv4_reassembly *reass)
@@ -124,6 +168,15 @@ static void reassembly_timeout(struct k_work *work)
 	struct net_ipv4_reassembly *reass =
 		CONTAINER_OF(work, struct net_ipv4_reassembly, timer);
 
+	k_mutex_lock(&reassembly_lock, K_FOREVER);
+
+	/* The slot might have been completed and reused while we were
+	 * waiting for the lock.
+	 */
+	if (k_work_delayable_remaining_get(&reass->timer)) {
+		goto out;
+	}
+
 	reassembly_info("Reassembly cancelled", reass);
 
 	/* Send a ICMPv4 Time Exceeded only if we received the first fragment */
@@ -132,7 +185,10 @@ static void reassembly_timeout(struct k_work *work)
 				      NET_ICMPV4_TIME_EXCEEDED_FRAGMENT_REASSEMBLY_TIME);
 	}
 
-	reassembly_cancel(reass->id, &reass->src, &reass->dst);
+	reassembly_cancel(reass);
+
+out:
+	k_mutex_unlock(&reassembly_lock);
 }
 
 static void reassemble_packet(struct net_ipv4_reassembly *reass)
@@ -143,8 +199,6 @@ static void reassemble_packet(struct net_ipv4_reassembly *reass)
 	struct net_buf *last;
 	int i;
 
-	k_work_cancel_delayable(&reass->timer);
-
 	NET_ASSERT(reass->pkt[0]);
 
 	last = net_buf_frag_last(reass->pkt[0]->buffer);
@@ -161,7 +215,8 @@ static void reassemble_packet(struct net_ipv4_reassembly *reass)
 		/* Get rid of IPv4 header which is at the beginning of the fragment. */
 		ipv4_hdr = (struct net_ipv4_hdr *)net_pkt_get_data(pkt, &ipv4_access);
 		if (!ipv4_hdr) {
-			goto error;
+			reassembly_cancel(reass);
+			return;
 		}
 
 		LOG_DBG("Removing %d bytes from start of pkt %p", net_pkt_ip_hdr_len(pkt),
@@ -169,7 +224,7 @@ static void reassemble_packet(struct net_ipv4_reassembly *reass)
 
 		if (net_pkt_pull(pkt, net_pkt_ip_hdr_len(pkt))) {
 			LOG_ERR("Failed to pull headers");
-			reassembly_cancel(reass->id, &reass->src, &reass->dst);
+			reassembly_cancel(reass);
 			return;
 		}
 
@@ -186,6 +241,8 @@ static void reassemble_packet(struct net_ipv4_reassembly *reass)
 	pkt = reass->pkt[0];
 	reass->pkt[0] = NULL;
 
+	reassembly_release(reass);
+
 	/* Update the header details for the packet */
 	net_pkt_cursor_init(pkt);
 
@@ -221,73 +278,105 @@ error:
 
 void net_ipv4_frag_foreach(net_ipv4_frag_cb_t cb, void *user_data)
 {
+	struct net_ipv4_reassembly *reass, *next;
 	int i;
 
-	for (i = 0; i < CONFIG_NET_IPV4_FRAGMENT_MAX_COUNT; i++) {
-		if (!k_work_delayable_remaining_get(&reassembly[i].timer)) {
-			continue;
-		}
+	k_mutex_lock(&reassembly_lock, K_FOREVER);
 
-		cb(&reassembly[i], user_data);
+	for (i = 0; i < REASSEMBLY_HASH_SIZE; i++) {
+		SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&reassembly_hash[i], reass, next, node) {
+			cb(reass, user_data);
+		}
 	}
+
+	k_mutex_unlock(&reassembly_lock);
 }
 
-/* Verify that we have all the fragments received and in correct order.
+/* Mark the payload range [start, end) of a fragment as received. The
+ * fragment must fit inside one hole, anything else means that it overlaps
+ * or duplicates data we already have. The last fragment (more == false)
+ * must go to the open ended hole, which is then closed.
  * Return:
- * - a negative value if the fragments are erroneous and must be dropped
- * - zero if we are expecting more fragments
- * - a positive value if we can proceed with the reassembly
+ * - a negative value if the fragment is erroneous and must be dropped
+ * - zero if the holes were updated
  */
-static int fragments_are_ready(struct net_ipv4_reassembly *reass)
+static int reassembly_fill_hole(struct net_ipv4_reassembly *reass, uint32_t start,
+				uint32_t end, bool more)
 {
-	unsigned int expected_offset = 0;
-	bool more = true;
 	int i;
 
-	/* Fragments can arrive in any order, for example in reverse order:
-	 *   1 -> Fragment3(M=0, offset=x2)
-	 *   2 -> Fragment2(M=1, offset=x1)
-	 *   3 -> Fragment1(M=1, offset=0)
-	 * We have to test several requirements before proceeding with the reassembly:
-	 * - We received the first fragment (Fragment Offset is 0)
-	 * - All intermediate fragments are contiguous
-	 * - The More bit of the last fragment is 0
-	 */
-	for (i = 0; i < CONFIG_NET_IPV4_FRAGMENT_MAX_PKT; i++) {
-		struct net_pkt *pkt = reass->pkt[i];
-		unsigned int offset;
-		int payload_len;
+	if (start == end && more) {
+		return -EBADMSG;
+	}
 
-		if (!pkt) {
-			break;
-		}
+	for (i = 0; i < reass->hole_count; i++) {
+		struct net_ipv4_reassembly_hole hole = reass->holes[i];
 
-		offset = net_pkt_ipv4_fragment_offset(pkt);
+		if (start < hole.start || end > hole.end) {
+			continue;
+		}
 
-		if (offset < expected_offset) {
-			/* Overlapping or duplicated, drop it */
+		if (!more && hole.end != HOLE_OPEN_END) {
+			/* Data beyond the end of the datagram was received */
 			return -EBADMSG;
-		} else if (offset != expected_offset) {
-			/* Not contiguous, let's wait for fragments */
-			return 0;
 		}
 
-		payload_len = net_pkt_get_len(pkt) - net_pkt_ip_hdr_len(pkt);
+		if (start > hole.start && more && end < hole.end &&
+		    reass->hole_count == ARRAY_SIZE(reass->holes)) {
+			return -ENOMEM;
+		}
 
-		if (payload_len < 0) {
-			return -EBADMSG;
+		reass->holes[i] = reass->holes[--reass->hole_count];
+
+		if (start > hole.start) {
+			reass->holes[reass->hole_count].start = hole.start;
+			reass->holes[reass->hole_count].end = start;
+			reass->hole_count++;
 		}
 
-		expected_offset += payload_len;
-		more = net_pkt_ipv4_fragment_more(pkt);
-	}
+		if (more && end < hole.end) {
+			reass->holes[reass->hole_count].start = end;
+			reass->holes[reass->hole_count].end = hole.end;
+			reass->hole_count++;
+		}
 
-	if (more) {
 		return 0;
 	}
 
-	return 1;
+	/* Overlapping or duplicated, drop it */
+	return -EBADMSG;
+}
+
+#if CONFIG_NET_IPV4_FRAGMENT_MAX_MEM > 0
+/* Make room for len bytes of fragment data. If the budget is exceeded, the
+ * oldest other pending reassemblies are dropped early, as they are the
+ * least likely ones to still complete.
+ */
+static bool reassembly_mem_reserve(struct net_ipv4_reassembly *reass, uint32_t len)
+{
+	while (reassembly_mem + len > CONFIG_NET_IPV4_FRAGMENT_MAX_MEM) {
+		struct net_ipv4_reassembly *oldest;
+
+		oldest = SYS_DLIST_PEEK_HEAD_CONTAINER(&reassembly_age, oldest,
+						       age_node);
+		if (oldest == reass) {
+			oldest = SYS_DLIST_PEEK_NEXT_CONTAINER(&reassembly_age,
+							       oldest, age_node);
+		}
+
+		if (!oldest) {
+			return false;
+		}
+
+		reassembly_info("Reassembly dropped early", oldest);
+		reassembly_cancel(oldest);
+	}
+
+	return true;
 }
+#else
+#define reassembly_mem_reserve(reass, len) true
+#endif /* CONFIG_NET_IPV4_FRAGMENT_MAX_MEM > 0 */
 
 static int shift_packets(struct net_ipv4_reassembly *reass, int pos)
 {
@@ -318,16 +407,19 @@ static int shift_packets(struct net_ipv4_reassembly *reass, int pos)
 enum net_verdict net_ipv4_handle_fragment_hdr(struct net_pkt *pkt, struct net_ipv4_hdr *hdr)
 {
 	struct net_ipv4_reassembly *reass = NULL;
+	enum net_verdict verdict = NET_OK;
+	uint32_t offset;
+	int payload_len;
 	uint16_t flag;
-	bool found;
 	uint8_t more;
 	uint16_t id;
-	int ret;
 	int i;
 
 	flag = ntohs(*((uint16_t *)&hdr->offset));
 	id = ntohs(*((uint16_t *)&hdr->id));
 
+	k_mutex_lock(&reassembly_lock, K_FOREVER);
+
 	reass = reassembly_get(id, (struct in_addr *)hdr->src,
 			       (struct in_addr *)hdr->dst, hdr->proto);
 	if (!reass) {
@@ -338,7 +430,9 @@ enum net_verdict net_ipv4_handle_fragment_hdr(struct net_pkt *pkt, struct net_ip
 	more = (flag & NET_IPV4_MORE_FRAG_MASK) ? true : false;
 	net_pkt_set_ipv4_fragment_flags(pkt, flag);
 
-	if (more && (net_pkt_get_len(pkt) - net_pkt_ip_hdr_len(pkt)) % 8) {
+	payload_len = net_pkt_get_len(pkt) - net_pkt_ip_hdr_len(pkt);
+
+	if (more && payload_len % 8) {
 		/* Fragment length is not multiple of 8, discard the packet and send bad IP
 		 * header error.
 		 */
@@ -347,57 +441,58 @@ enum net_verdict net_ipv4_handle_fragment_hdr(struct net_pkt *pkt, struct net_ip
 		goto drop;
 	}
 
+	if (payload_len < 0 || reass->pkt[CONFIG_NET_IPV4_FRAGMENT_MAX_PKT - 1]) {
+		/* We could not add this fragment into our saved fragment list. The whole packet
+		 * must be discarded at this point.
+		 */
+		LOG_ERR("No slots available for 0x%x", reass->id);
+		net_pkt_unref(pkt);
+		goto drop;
+	}
+
+	offset = net_pkt_ipv4_fragment_offset(pkt);
+
+	if (reassembly_fill_hole(reass, offset, offset + payload_len, more) < 0) {
+		LOG_ERR("Reassembled IPv4 verify failed, dropping id %u", reass->id);
+		net_pkt_unref(pkt);
+		goto drop;
+	}
+
+	/* Only accepted fragments may push other reassemblies out, the whole
+	 * datagram is dropped if this one does not fit.
+	 */
+	if (!reassembly_mem_reserve(reass, net_pkt_get_len(pkt))) {
+		LOG_ERR("Fragment memory limit reached, dropping id %u", reass->id);
+		net_pkt_unref(pkt);
+		goto drop;
+	}
+
 	/* The fragments might come in wrong order so place them in the reassembly chain in the
-	 * correct order.
+	 * correct order. There is room for at least one more fragment, so shifting cannot fail.
 	 */
-	for (i = 0, found = false; i < CONFIG_NET_IPV4_FRAGMENT_MAX_PKT; i++) {
+	for (i = 0; i < CONFIG_NET_IPV4_FRAGMENT_MAX_PKT; i++) {
 		if (reass->pkt[i]) {
-			if (net_pkt_ipv4_fragment_offset(reass->pkt[i]) <
-			    net_pkt_ipv4_fragment_offset(pkt)) {
+			if (net_pkt_ipv4_fragment_offset(reass->pkt[i]) < offset) {
 				continue;
 			}
 
-			/* Make room for this fragment. If there is no room then it will discard
-			 * the whole reassembly.
-			 */
-			if (shift_packets(reass, i)) {
-				break;
-			}
+			shift_packets(reass, i);
 		}
 
-		LOG_DBG("Storing pkt %p to slot %d offset %d", pkt, i,
-			net_pkt_ipv4_fragment_offset(pkt));
+		LOG_DBG("Storing pkt %p to slot %d offset %d", pkt, i, offset);
 		reass->pkt[i] = pkt;
-		found = true;
 
 		break;
 	}
 
-	if (!found) {
-		/* We could not add this fragment into our saved fragment list. The whole packet
-		 * must be discarded at this point.
-		 */
-		LOG_ERR("No slots available for 0x%x", reass->id);
-		net_pkt_unref(pkt);
-		goto drop;
-	}
+	reass->mem += net_pkt_get_len(pkt);
+	reassembly_mem += net_pkt_get_len(pkt);
 
-	ret = fragments_are_ready(reass);
-	if (ret < 0) {
-		LOG_ERR("Reassembled IPv4 verify failed, dropping id %u", reass->id);
-
-		/* Let the caller release the already inserted pkt */
-		if (i < CONFIG_NET_IPV4_FRAGMENT_MAX_PKT) {
-			reass->pkt[i] = NULL;
-		}
-
-		net_pkt_unref(pkt);
-		goto drop;
-	} else if (ret == 0) {
+	if (reass->hole_count > 0) {
 		reassembly_info("Reassembly nth pkt", reass);
 
 		LOG_DBG("More fragments to be received");
-		goto accept;
+		goto out;
 	}
 
 	reassembly_info("Reassembly last pkt", reass);
@@ -405,17 +500,19 @@ enum net_verdict net_ipv4_handle_fragment_hdr(struct net_pkt *pkt, struct net_ip
 	/* The last fragment received, reassemble the packet */
 	reassemble_packet(reass);
 
-accept:
-	return NET_OK;
+	goto out;
 
 drop:
 	if (reass) {
-		if (reassembly_cancel(reass->id, &reass->src, &reass->dst)) {
-			return NET_OK;
-		}
+		reassembly_cancel(reass);
+	} else {
+		verdict = NET_DROP;
 	}
 
-	return NET_DROP;
+out:
+	k_mutex_unlock(&reassembly_lock);
+
+	return verdict;
 }
 
 static int send_ipv4_fragment(struct net_pkt *pkt, uint16_t rand_id, uint16_t fit_len,
@@ -643,5 +740,6 @@ void net_ipv4_setup_fragment_buffers(void)
 	 */
 	for (int i = 0; i < CONFIG_NET_IPV4_FRAGMENT_MAX_COUNT; i++) {
 		k_work_init_delayable(&reassembly[i].timer, reassembly_timeout);
+		sys_slist_append(&reassembly_free, &reassembly[i].node);
 	}
 }
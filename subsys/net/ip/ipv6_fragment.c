@@ -40,11 +40,31 @@ LOG_MODULE_DECLARE(net_ipv6, CONFIG_NET_IPV6_LOG_LEVEL);
 
 #define FRAG_BUF_WAIT K_MSEC(10) /* how long to max wait for a buffer */
 
+/* Reassemblies waiting for more fragments are kept in a hash table keyed by
+ * the fragment id and addresses, and in a list ordered by age. The unused
+ * ones are in a free list.
+ */
+#define REASSEMBLY_HASH_SIZE CONFIG_NET_IPV6_FRAGMENT_HASH_SIZE
+
+BUILD_ASSERT(IS_POWER_OF_TWO(REASSEMBLY_HASH_SIZE),
+	     "Reassembly hash size must be a power of two");
+
+/* End offset of the hole that is open until the last fragment arrives */
+#define HOLE_OPEN_END UINT32_MAX
+
 static void reassembly_timeout(struct k_work *work);
 static bool reassembly_init_done;
 
 static struct net_ipv6_reassembly
 reassembly[CONFIG_NET_IPV6_FRAGMENT_MAX_COUNT];
+static sys_slist_t reassembly_hash[REASSEMBLY_HASH_SIZE];
+static sys_slist_t reassembly_free;
+static sys_dlist_t reassembly_age = SYS_DLIST_STATIC_INIT(&reassembly_age);
+
+/* Amount of fragment data held by all pending reassemblies */
+static uint32_t reassembly_mem;
+
+static K_MUTEX_DEFINE(reassembly_lock);
 
 int net_ipv6_find_last_ext_hdr(struct net_pkt *pkt, uint16_t *next_hdr_off,
 			       uint16_t *last_hdr_off)
@@ -120,86 +140,112 @@ fail:
 	return -EINVAL;
 }
 
+static sys_slist_t *reassembly_bucket(uint32_t id,
+				      const struct in6_addr *src,
+				      const struct in6_addr *dst)
+{
+	uint32_t key = id;
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(src->s6_addr32); i++) {
+		key ^= UNALIGNED_GET(&src->s6_addr32[i]) ^
+		       UNALIGNED_GET(&dst->s6_addr32[i]);
+		key *= 0x9e3779b1U;
+	}
+
+	return &reassembly_hash[(key >> 16) & (REASSEMBLY_HASH_SIZE - 1)];
+}
+
 static struct net_ipv6_reassembly *reassembly_get(uint32_t id,
 						  struct in6_addr *src,
 						  struct in6_addr *dst)
 {
-	int i, avail = -1;
-
-	for (i = 0; i < CONFIG_NET_IPV6_FRAGMENT_MAX_COUNT; i++) {
-		if (k_work_delayable_remaining_get(&reassembly[i].timer) &&
-		    reassembly[i].id == id &&
-		    net_ipv6_addr_cmp(src, &reassembly[i].src) &&
-		    net_ipv6_addr_cmp(dst, &reassembly[i].dst)) {
-			return &reassembly[i];
-		}
-
-		if (k_work_delayable_remaining_get(&reassembly[i].timer)) {
-			continue;
-		}
-
-		if (avail < 0) {
-			avail = i;
+	sys_slist_t *bucket = reassembly_bucket(id, src, dst);
+	struct net_ipv6_reassembly *reass;
+	sys_snode_t *free_node;
+
+	SYS_SLIST_FOR_EACH_CONTAINER(bucket, reass, node) {
+		if (reass->id == id &&
+		    net_ipv6_addr_cmp(src, &reass->src) &&
+		    net_ipv6_addr_cmp(dst, &reass->dst)) {
+			return reass;
 		}
 	}
 
-	if (avail < 0) {
+	free_node = sys_slist_get(&reassembly_free);
+	if (!free_node) {
 		return NULL;
 	}
 
-	k_work_reschedule(&reassembly[avail].timer, IPV6_REASSEMBLY_TIMEOUT);
+	reass = CONTAINER_OF(free_node, struct net_ipv6_reassembly, node);
+
+	k_work_reschedule(&reass->timer, IPV6_REASSEMBLY_TIMEOUT);
 
-	net_ipaddr_copy(&reassembly[avail].src, src);
-	net_ipaddr_copy(&reassembly[avail].dst, dst);
+	net_ipaddr_copy(&reass->src, src);
+	net_ipaddr_copy(&reass->dst, dst);
 
-	reassembly[avail].id = id;
+	reass->id = id;
+	reass->mem = 0U;
 
-	return &reassembly[avail];
+	/* Nothing received yet, the whole datagram is one open ended hole */
+	reass->holes[0].start = 0U;
+	reass->holes[0].end = HOLE_OPEN_END;
+	reass->hole_count = 1U;
+
+	sys_slist_prepend(bucket, &reass->node);
+	sys_dlist_append(&reassembly_age, &reass->age_node);
+
+	return reass;
 }
 
-static bool reassembly_cancel(uint32_t id,
-			      struct in6_addr *src,
-			      struct in6_addr *dst)
+/* Return the reassembly slot to the free list. The fragments must have been
+ * released or moved away before calling this.
+ */
+static void reassembly_release(struct net_ipv6_reassembly *reass)
 {
-	int i, j;
+	k_work_cancel_delayable(&reass->timer);
 
-	NET_DBG("Cancel 0x%x", id);
+	if (!sys_slist_find_and_remove(reassembly_bucket(reass->id, &reass->src,
+							 &reass->dst),
+				       &reass->node)) {
+		return;
+	}
 
-	for (i = 0; i < CONFIG_NET_IPV6_FRAGMENT_MAX_COUNT; i++) {
-		int32_t remaining;
+	sys_dlist_remove(&reass->age_node);
 
-		if (reassembly[i].id != id ||
-		    !net_ipv6_addr_cmp(src, &reassembly[i].src) ||
-		    !net_ipv6_addr_cmp(dst, &reassembly[i].dst)) {
-			continue;
-		}
+	reassembly_mem -= reass->mem;
+	reass->mem = 0U;
+	reass->id = 0U;
 
-		remaining = k_ticks_to_ms_ceil32(
-			k_work_delayable_remaining_get(&reassembly[i].timer));
-		k_work_cancel_delayable(&reassembly[i].timer);
+	sys_slist_append(&reassembly_free, &reass->node);
+}
 
-		NET_DBG("IPv6 reassembly id 0x%x remaining %d ms",
-			reassembly[i].id, remaining);
+static void reassembly_cancel(struct net_ipv6_reassembly *reass)
+{
+	int32_t remaining;
+	int j;
 
-		reassembly[i].id = 0U;
+	NET_DBG("Cancel 0x%x", reass->id);
 
-		for (j = 0; j < CONFIG_NET_IPV6_FRAGMENT_MAX_PKT; j++) {
-			if (!reassembly[i].pkt[j]) {
-				continue;
-			}
+	remaining = k_ticks_to_ms_ceil32(
+		k_work_delayable_remaining_get(&reass->timer));
 
-			NET_DBG("[%d] IPv6 reassembly pkt %p %zd bytes data",
-				j, reassembly[i].pkt[j],
-				net_pkt_get_len(reassembly[i].pkt[j]));
+	NET_DBG("IPv6 reassembly id 0x%x remaining %d ms",
+		reass->id, remaining);
 
-			net_pkt_unref(reassembly[i].pkt[j]);
-			reassembly[i].pkt[j] = NULL;
+	for (j = 0; j < CONFIG_NET_IPV6_FRAGMENT_MAX_PKT; j++) {
+		if (!reass->pkt[j]) {
+			continue;
 		}
 
-		return true;
+		NET_DBG("[%d] IPv6 reassembly pkt %p %zd bytes data",
+			j, reass->pkt[j], net_pkt_get_len(reass->pkt[j]));
+
+		net_pkt_unref(reass->pkt[j]);
+		reass->pkt[j] = NULL;
 	}
 
-	return false;
+	reassembly_release(reass);
 }
 
 static void reassembly_info(char *str, struct net_ipv6_reassembly *reass)
@@ -216,6 +262,15 @@ static void reassembly_timeout(struct k_work *work)
 	struct net_ipv6_reassembly *reass =
 		CONTAINER_OF(work, struct net_ipv6_reassembly, timer);
 
+	k_mutex_lock(&reassembly_lock, K_FOREVER);
+
+	/* The slot might have been completed and reused while we were
+	 * waiting for the lock.
+	 */
+	if (k_work_delayable_remaining_get(&reass->timer)) {
+		goto out;
+	}
+
 	reassembly_info("Reassembly cancelled", reass);
 
 	/* Send a ICMPv6 Time Exceeded only if we received the first fragment (RFC 2460 Sec. 5) */
@@ -223,7 +278,10 @@ static void reassembly_timeout(struct k_work *work)
 		net_icmpv6_send_error(reass->pkt[0], NET_ICMPV6_TIME_EXCEEDED, 1, 0);
 	}
 
-	reassembly_cancel(reass->id, &reass->src, &reass->dst);
+	reassembly_cancel(reass);
+
+out:
+	k_mutex_unlock(&reassembly_lock);
 }
 
 static void reassemble_packet(struct net_ipv6_reassembly *reass)
@@ -240,8 +298,6 @@ static void reassemble_packet(struct net_ipv6_reassembly *reass)
 	uint8_t next_hdr;
 	int i, len;
 
-	k_work_cancel_delayable(&reass->timer);
-
 	NET_ASSERT(reass->pkt[0]);
 
 	last = net_buf_frag_last(reass->pkt[0]->buffer);
@@ -270,7 +326,7 @@ static void reassemble_packet(struct net_ipv6_reassembly *reass)
 
 		if (net_pkt_pull(pkt, removed_len)) {
 			NET_ERR("Failed to pull headers");
-			reassembly_cancel(reass->id, &reass->src, &reass->dst);
+			reassembly_cancel(reass);
 			return;
 		}
 
@@ -287,6 +343,8 @@ static void reassemble_packet(struct net_ipv6_reassembly *reass)
 	pkt = reass->pkt[0];
 	reass->pkt[0] = NULL;
 
+	reassembly_release(reass);
+
 	/* Next we need to strip away the fragment header from the first packet
 	 * and set the various pointers and values in packet.
 	 */
@@ -356,77 +414,108 @@ error:
 
 void net_ipv6_frag_foreach(net_ipv6_frag_cb_t cb, void *user_data)
 {
+	struct net_ipv6_reassembly *reass, *next;
 	int i;
 
-	for (i = 0; reassembly_init_done &&
-		     i < CONFIG_NET_IPV6_FRAGMENT_MAX_COUNT; i++) {
-		if (!k_work_delayable_remaining_get(&reassembly[i].timer)) {
-			continue;
-		}
+	k_mutex_lock(&reassembly_lock, K_FOREVER);
 
-		cb(&reassembly[i], user_data);
+	for (i = 0; reassembly_init_done && i < REASSEMBLY_HASH_SIZE; i++) {
+		SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&reassembly_hash[i], reass,
+						  next, node) {
+			cb(reass, user_data);
+		}
 	}
+
+	k_mutex_unlock(&reassembly_lock);
 }
 
-/* Verify that we have all the fragments received and in correct order.
+/* Mark the payload range [start, end) of a fragment as received. The
+ * fragment must fit inside one hole, anything else means that it overlaps
+ * or duplicates data we already have (RFC 8200 allows dropping it). The
+ * last fragment (more == false) must go to the open ended hole, which is
+ * then closed.
  * Return:
- * - a negative value if the fragments are erroneous and must be dropped
- * - zero if we are expecting more fragments
- * - a positive value if we can proceed with the reassembly
+ * - a negative value if the fragment is erroneous and must be dropped
+ * - zero if the holes were updated
  */
-static int fragments_are_ready(struct net_ipv6_reassembly *reass)
+static int reassembly_fill_hole(struct net_ipv6_reassembly *reass,
+				uint32_t start, uint32_t end, bool more)
 {
-	unsigned int expected_offset = 0;
-	bool more = true;
 	int i;
 
-	/* Fragments can arrive in any order, for example in reverse order:
-	 *   1 -> Fragment3(M=0, offset=x2)
-	 *   2 -> Fragment2(M=1, offset=x1)
-	 *   3 -> Fragment1(M=1, offset=0)
-	 * We have to test several requirements before proceeding with the reassembly:
-	 * - We received the first fragment (Fragment Offset is 0)
-	 * - All intermediate fragments are contiguous
-	 * - The More bit of the last fragment is 0
-	 */
-	for (i = 0; i < CONFIG_NET_IPV6_FRAGMENT_MAX_PKT; i++) {
-		struct net_pkt *pkt = reass->pkt[i];
-		unsigned int offset;
-		int payload_len;
+	if (start == end && more) {
+		return -EBADMSG;
+	}
 
-		if (!pkt) {
-			break;
-		}
+	for (i = 0; i < reass->hole_count; i++) {
+		struct net_ipv6_reassembly_hole hole = reass->holes[i];
 
-		offset = net_pkt_ipv6_fragment_offset(pkt);
+		if (start < hole.start || end > hole.end) {
+			continue;
+		}
 
-		if (offset < expected_offset) {
-			/* Overlapping or duplicated
-			 * According to RFC8200 we can drop it
-			 */
+		if (!more && hole.end != HOLE_OPEN_END) {
+			/* Data beyond the end of the datagram was received */
 			return -EBADMSG;
-		} else if (offset != expected_offset) {
-			/* Not contiguous, let's wait for fragments */
-			return 0;
 		}
 
-		payload_len = net_pkt_get_len(pkt) - net_pkt_ipv6_fragment_start(pkt);
-		payload_len -= sizeof(struct net_ipv6_frag_hdr);
-		if (payload_len < 0) {
-			return -EBADMSG;
+		if (start > hole.start && more && end < hole.end &&
+		    reass->hole_count == ARRAY_SIZE(reass->holes)) {
+			return -ENOMEM;
 		}
 
-		expected_offset += payload_len;
-		more = net_pkt_ipv6_fragment_more(pkt);
-	}
+		reass->holes[i] = reass->holes[--reass->hole_count];
+
+		if (start > hole.start) {
+			reass->holes[reass->hole_count].start = hole.start;
+			reass->holes[reass->hole_count].end = start;
+			reass->hole_count++;
+		}
+
+		if (more && end < hole.end) {
+			reass->holes[reass->hole_count].start = end;
+			reass->holes[reass->hole_count].end = hole.end;
+			reass->hole_count++;
+		}
 
-	if (more) {
 		return 0;
 	}
 
-	return 1;
+	return -EBADMSG;
 }
 
+#if CONFIG_NET_IPV6_FRAGMENT_MAX_MEM > 0
+/* Make room for len bytes of fragment data. If the budget is exceeded, the
+ * oldest other pending reassemblies are dropped early, as they are the
+ * least likely ones to still complete.
+ */
+static bool reassembly_mem_reserve(struct net_ipv6_reassembly *reass,
+				   uint32_t len)
+{
+	while (reassembly_mem + len > CONFIG_NET_IPV6_FRAGMENT_MAX_MEM) {
+		struct net_ipv6_reassembly *oldest;
+
+		oldest = SYS_DLIST_PEEK_HEAD_CONTAINER(&reassembly_age, oldest,
+						       age_node);
+		if (oldest == reass) {
+			oldest = SYS_DLIST_PEEK_NEXT_CONTAINER(&reassembly_age,
+							       oldest, age_node);
+		}
+
+		if (!oldest) {
+			return false;
+		}
+
+		reassembly_info("Reassembly dropped early", oldest);
+		reassembly_cancel(oldest);
+	}
+
+	return true;
+}
+#else
+#define reassembly_mem_reserve(reass, len) true
+#endif /* CONFIG_NET_IPV6_FRAGMENT_MAX_MEM > 0 */
+
 static int shift_packets(struct net_ipv6_reassembly *reass, int pos)
 {
 	int i;
@@ -460,13 +549,16 @@ enum net_verdict net_ipv6_handle_fragment_hdr(struct net_pkt *pkt,
 					      uint8_t nexthdr)
 {
 	struct net_ipv6_reassembly *reass = NULL;
+	enum net_verdict verdict = NET_OK;
+	uint32_t offset;
+	int payload_len;
 	uint16_t flag;
-	bool found;
 	uint8_t more;
 	uint32_t id;
-	int ret;
 	int i;
 
+	k_mutex_lock(&reassembly_lock, K_FOREVER);
+
 	if (!reassembly_init_done) {
 		/* Static initializing does not work here because of the array
 		 * so we must do it at runtime.
@@ -474,6 +566,7 @@ enum net_verdict net_ipv6_handle_fragment_hdr(struct net_pkt *pkt,
 		for (i = 0; i < CONFIG_NET_IPV6_FRAGMENT_MAX_COUNT; i++) {
 			k_work_init_delayable(&reassembly[i].timer,
 					      reassembly_timeout);
+			sys_slist_append(&reassembly_free, &reassembly[i].node);
 		}
 
 		reassembly_init_done = true;
@@ -510,58 +603,68 @@ enum net_verdict net_ipv6_handle_fragment_hdr(struct net_pkt *pkt,
 		goto drop;
 	}
 
+	payload_len = net_pkt_get_len(pkt) - net_pkt_ipv6_fragment_start(pkt) -
+		      sizeof(struct net_ipv6_frag_hdr);
+
+	if (payload_len < 0 ||
+	    reass->pkt[CONFIG_NET_IPV6_FRAGMENT_MAX_PKT - 1]) {
+		/* We could not add this fragment into our saved fragment
+		 * list. We must discard the whole packet at this point.
+		 */
+		NET_DBG("No slots available for 0x%x", reass->id);
+		net_pkt_unref(pkt);
+		goto drop;
+	}
+
+	offset = net_pkt_ipv6_fragment_offset(pkt);
+
+	if (reassembly_fill_hole(reass, offset, offset + payload_len,
+				 more) < 0) {
+		NET_DBG("Reassembled IPv6 verify failed, dropping id %u",
+			reass->id);
+		net_pkt_unref(pkt);
+		goto drop;
+	}
+
+	/* Only accepted fragments may push other reassemblies out, the
+	 * whole datagram is dropped if this one does not fit.
+	 */
+	if (!reassembly_mem_reserve(reass, net_pkt_get_len(pkt))) {
+		NET_DBG("Fragment memory limit reached, dropping id %u",
+			reass->id);
+		net_pkt_unref(pkt);
+		goto drop;
+	}
+
 	/* The fragments might come in wrong order so place them
-	 * in reassembly chain in correct order.
+	 * in reassembly chain in correct order. There is room for at
+	 * least one more fragment, so shifting cannot fail.
 	 */
-	for (i = 0, found = false; i < CONFIG_NET_IPV6_FRAGMENT_MAX_PKT; i++) {
+	for (i = 0; i < CONFIG_NET_IPV6_FRAGMENT_MAX_PKT; i++) {
 		if (reass->pkt[i]) {
 			if (net_pkt_ipv6_fragment_offset(reass->pkt[i]) <
-			    net_pkt_ipv6_fragment_offset(pkt)) {
+			    offset) {
 				continue;
 			}
 
-			/* Make room for this fragment. If there is no room,
-			 * then it will discard the whole reassembly.
-			 */
-			if (shift_packets(reass, i)) {
-				break;
-			}
+			shift_packets(reass, i);
 		}
 
 		NET_DBG("Storing pkt %p to slot %d offset %d",
-			pkt, i, net_pkt_ipv6_fragment_offset(pkt));
+			pkt, i, offset);
 		reass->pkt[i] = pkt;
-		found = true;
 
 		break;
 	}
 
-	if (!found) {
-		/* We could not add this fragment into our saved fragment
-		 * list. We must discard the whole packet at this point.
-		 */
-		NET_DBG("No slots available for 0x%x", reass->id);
-		net_pkt_unref(pkt);
-		goto drop;
-	}
-
-	ret = fragments_are_ready(reass);
-	if (ret < 0) {
-		NET_DBG("Reassembled IPv6 verify failed, dropping id %u",
-			reass->id);
+	reass->mem += net_pkt_get_len(pkt);
+	reassembly_mem += net_pkt_get_len(pkt);
 
-		/* Let the caller release the already inserted pkt */
-		if (i < CONFIG_NET_IPV6_FRAGMENT_MAX_PKT) {
-			reass->pkt[i] = NULL;
-		}
-
-		net_pkt_unref(pkt);
-		goto drop;
-	} else if (ret == 0) {
+	if (reass->hole_count > 0) {
 		reassembly_info("Reassembly nth pkt", reass);
 
 		NET_DBG("More fragments to be received");
-		goto accept;
+		goto out;
 	}
 
 	reassembly_info("Reassembly last pkt", reass);
@@ -569,17 +672,19 @@ enum net_verdict net_ipv6_handle_fragment_hdr(struct net_pkt *pkt,
 	/* The last fragment received, reassemble the packet */
 	reassemble_packet(reass);
 
-accept:
-	return NET_OK;
+	goto out;
 
 drop:
 	if (reass) {
-		if (reassembly_cancel(reass->id, &reass->src, &reass->dst)) {
-			return NET_OK;
-		}
+		reassembly_cancel(reass);
+	} else {
+		verdict = NET_DROP;
 	}
 
-	return NET_DROP;
+out:
+	k_mutex_unlock(&reassembly_lock);
+
+	return verdict;
 }
 
 #define BUF_ALLOC_TIMEOUT K_MSEC(100)
@@ -1309,33 +1309,71 @@ static int get_context_dscp_ecn(struct net_context *context,
 #endif
 }
 
+/* Write one chunk of user data to net_pkt. If chksum is given, the data is
+ * summed while it is copied and added to the running checksum, offset being
+ * the amount of data already summed.
+ */
+static int context_write_chunk(struct net_pkt *pkt, const void *data,
+			       size_t len, uint16_t *chksum, size_t offset)
+{
+	uint16_t sum;
+	int ret;
+
+	if (!chksum) {
+		return net_pkt_write(pkt, data, len);
+	}
+
+	ret = net_pkt_write_chksum(pkt, data, len, &sum);
+	if (ret < 0) {
+		return ret;
+	}
+
+	/* Chunk starting at an odd offset is byte swapped */
+	if (offset & 1) {
+		sum = __bswap_16(sum);
+	}
+
+	*chksum = calc_chksum_add(*chksum, sum);
+
+	return ret;
+}
+
 /* If buf is not NULL, then use it. Otherwise read the data to be written
- * to net_pkt from msghdr.
+ * to net_pkt from msghdr. If chksum is not NULL, the checksum of the
+ * written data is returned in it.
  */
 static int context_write_data(struct net_pkt *pkt, const void *buf,
-			      int buf_len, const struct msghdr *msghdr)
+			      int buf_len, const struct msghdr *msghdr,
+			      uint16_t *chksum)
 {
+	size_t offset = 0;
 	int ret = 0;
 
+	if (chksum) {
+		*chksum = 0U;
+	}
+
 	if (msghdr) {
 		int i;
 
 		for (i = 0; i < msghdr->msg_iovlen; i++) {
 			int len = MIN(msghdr->msg_iov[i].iov_len, buf_len);
 
-			ret = net_pkt_write(pkt, msghdr->msg_iov[i].iov_base,
-					    len);
+			ret = context_write_chunk(pkt,
+						  msghdr->msg_iov[i].iov_base,
+						  len, chksum, offset);
 			if (ret < 0) {
 				break;
 			}
 
+			offset += len;
 			buf_len -= len;
 			if (buf_len == 0) {
 				break;
 			}
 		}
 	} else {
-		ret = net_pkt_write(pkt, buf, buf_len);
+		ret = context_write_chunk(pkt, buf, buf_len, chksum, offset);
 	}
 
 	return ret;
@@ -1387,9 +1425,21 @@ static int context_setup_udp_packet(struct net_context *context,
 		return ret;
 	}
 
-	ret = context_write_data(pkt, buf, len, msg);
-	if (ret) {
-		return ret;
+	if (IS_ENABLED(CONFIG_NET_UDP_CHECKSUM_COPY) &&
+	    net_if_need_calc_tx_checksum(net_pkt_iface(pkt))) {
+		uint16_t chksum;
+
+		ret = context_write_data(pkt, buf, len, msg, &chksum);
+		if (ret) {
+			return ret;
+		}
+
+		net_pkt_set_udp_payload_chksum(pkt, chksum);
+	} else {
+		ret = context_write_data(pkt, buf, len, msg, NULL);
+		if (ret) {
+			return ret;
+		}
 	}
 
 	return 0;
@@ -1732,7 +1782,7 @@ static int context_sendto(struct net_context *context,
 
 	if (IS_ENABLED(CONFIG_NET_OFFLOAD) &&
 	    net_if_is_ip_offloaded(net_context_get_iface(context))) {
-		ret = context_write_data(pkt, buf, len, msghdr);
+		ret = context_write_data(pkt, buf, len, msghdr, NULL);
 		if (ret < 0) {
 			goto fail;
 		}
@@ -1761,7 +1811,7 @@ static int context_sendto(struct net_context *context,
 	} else if (IS_ENABLED(CONFIG_NET_TCP) &&
 		   net_context_get_proto(context) == IPPROTO_TCP) {
 
-		ret = context_write_data(pkt, buf, len, msghdr);
+		ret = context_write_data(pkt, buf, len, msghdr, NULL);
 		if (ret < 0) {
 			goto fail;
 		}
@@ -1775,7 +1825,7 @@ static int context_sendto(struct net_context *context,
 		ret = net_tcp_send_data(context, cb, user_data);
 	} else if (IS_ENABLED(CONFIG_NET_SOCKETS_PACKET) &&
 		   net_context_get_family(context) == AF_PACKET) {
-		ret = context_write_data(pkt, buf, len, msghdr);
+		ret = context_write_data(pkt, buf, len, msghdr, NULL);
 		if (ret < 0) {
 			goto fail;
 		}
@@ -1806,7 +1856,7 @@ static int context_sendto(struct net_context *context,
 	} else if (IS_ENABLED(CONFIG_NET_SOCKETS_CAN) &&
 		   net_context_get_family(context) == AF_CAN &&
 		   net_context_get_proto(context) == CAN_RAW) {
-		ret = context_write_data(pkt, buf, len, msghdr);
+		ret = context_write_data(pkt, buf, len, msghdr, NULL);
 		if (ret < 0) {
 			goto fail;
 		}
@@ -1914,6 +1964,168 @@ int net_context_sendto(struct net_context *context,
 	return ret;
 }
 
+#if defined(CONFIG_NET_CONTEXT_ZEROCOPY_TX)
+/* Give the application buffer back to the caller if sending failed */
+static void context_detach_buf(struct net_pkt *pkt, struct net_buf *buf)
+{
+	struct net_buf *frag;
+
+	if (pkt->buffer == buf) {
+		pkt->buffer = NULL;
+		return;
+	}
+
+	for (frag = pkt->buffer; frag; frag = frag->frags) {
+		if (frag->frags == buf) {
+			frag->frags = NULL;
+			return;
+		}
+	}
+}
+
+static int context_send_buf(struct net_context *context,
+			    struct net_buf *buf,
+			    net_context_send_cb_t cb,
+			    k_timeout_t timeout,
+			    void *user_data)
+{
+	struct net_if *iface;
+	struct net_pkt *pkt;
+	size_t len;
+	int ret;
+
+	NET_ASSERT(PART_OF_ARRAY(contexts, context));
+
+	if (!net_context_is_used(context)) {
+		return -EBADF;
+	}
+
+	if (!(context->flags & NET_CONTEXT_REMOTE_ADDR_SET) ||
+	    !net_sin(&context->remote)->sin_port) {
+		return -EDESTADDRREQ;
+	}
+
+	iface = net_context_get_iface(context);
+	if (iface && !net_if_is_up(iface)) {
+		return -ENETDOWN;
+	}
+
+	if (IS_ENABLED(CONFIG_NET_OFFLOAD) && net_if_is_ip_offloaded(iface)) {
+		return -ENOTSUP;
+	}
+
+	len = net_buf_frags_len(buf);
+
+	if (IS_ENABLED(CONFIG_NET_UDP) &&
+	    net_context_get_proto(context) == IPPROTO_UDP) {
+		/* Allocate room for the headers only, the data is appended
+		 * as it is.
+		 */
+		pkt = context_alloc_pkt(context, 0, timeout);
+		if (!pkt) {
+			return -ENOBUFS;
+		}
+
+		context->send_cb = cb;
+		context->user_data = user_data;
+
+		if (IS_ENABLED(CONFIG_NET_CONTEXT_PRIORITY)) {
+			uint8_t priority;
+
+			get_context_priority(context, &priority, NULL);
+			net_pkt_set_priority(pkt, priority);
+		}
+
+		ret = context_setup_udp_packet(context, pkt, NULL, 0, NULL,
+					       &context->remote,
+					       sizeof(context->remote));
+		if (ret < 0) {
+			goto fail;
+		}
+
+		/* The appended data was not part of the copy time checksum */
+		net_pkt_clear_udp_payload_chksum(pkt);
+		net_pkt_append_buffer(pkt, buf);
+		context_finalize_packet(context, pkt);
+
+		ret = net_send_data(pkt);
+	} else if (IS_ENABLED(CONFIG_NET_TCP) &&
+		   net_context_get_proto(context) == IPPROTO_TCP) {
+		pkt = net_pkt_alloc(timeout);
+		if (!pkt) {
+			return -ENOBUFS;
+		}
+
+		net_pkt_set_context(pkt, context);
+		net_pkt_append_buffer(pkt, buf);
+
+		ret = net_tcp_queue_data(context, pkt);
+		if (ret < 0 && pkt->buffer == NULL) {
+			/* The data was queued but the connection was closed
+			 * because of an error. The data is released with the
+			 * connection, so report it as sent, the error is
+			 * reported by the next call.
+			 */
+			net_pkt_unref(pkt);
+			return len;
+		}
+
+		if (ret < 0) {
+			goto fail;
+		}
+
+		ret = net_tcp_send_data(context, cb, user_data);
+		if (ret < 0) {
+			/* The packet has already been consumed */
+			return ret;
+		}
+
+		return len;
+	} else {
+		return -EPROTONOSUPPORT;
+	}
+
+	if (ret < 0) {
+		goto fail;
+	}
+
+	return len;
+
+fail:
+	context_detach_buf(pkt, buf);
+	net_pkt_unref(pkt);
+
+	return ret;
+}
+#endif /* CONFIG_NET_CONTEXT_ZEROCOPY_TX */
+
+int net_context_send_buf(struct net_context *context,
+			 struct net_buf *buf,
+			 net_context_send_cb_t cb,
+			 k_timeout_t timeout,
+			 void *user_data)
+{
+#if defined(CONFIG_NET_CONTEXT_ZEROCOPY_TX)
+	int ret;
+
+	k_mutex_lock(&context->lock, K_FOREVER);
+
+	ret = context_send_buf(context, buf, cb, timeout, user_data);
+
+	k_mutex_unlock(&context->lock);
+
+	return ret;
+#else
+	ARG_UNUSED(context);
+	ARG_UNUSED(buf);
+	ARG_UNUSED(cb);
+	ARG_UNUSED(timeout);
+	ARG_UNUSED(user_data);
+
+	return -ENOTSUP;
+#endif
+}
+
 enum net_verdict net_context_packet_received(struct net_conn *conn,
 					     struct net_pkt *pkt,
 					     union net_ip_header *ip_hdr,
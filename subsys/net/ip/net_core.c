@@ -387,13 +387,19 @@ void net_process_rx_packet(struct net_pkt *pkt)
 static void net_queue_rx(struct net_if *iface, struct net_pkt *pkt)
 {
 	uint8_t prio = net_pkt_priority(pkt);
+#if defined(CONFIG_NET_TC_RX_FLOW_HASH)
+	uint8_t tc = net_rx_flow2tc(pkt);
+#else
 	uint8_t tc = net_rx_priority2tc(prio);
+#endif
 
 #if defined(CONFIG_NET_STATISTICS)
 	net_stats_update_tc_recv_pkt(iface, tc);
 	net_stats_update_tc_recv_bytes(iface, tc, net_pkt_get_len(pkt));
+#if !defined(CONFIG_NET_TC_RX_FLOW_HASH)
 	net_stats_update_tc_recv_priority(iface, tc, prio);
 #endif
+#endif
 
 #if NET_TC_RX_COUNT > 1
 	NET_DBG("TC %d with prio %d pkt %p", tc, prio, pkt);
@@ -39,6 +39,7 @@ LOG_MODULE_REGISTER(net_pkt, CONFIG_NET_PKT_LOG_LEVEL);
 #include <zephyr/net/udp.h>
 
 #include "net_private.h"
+#include "net_stats.h"
 #include "tcp_internal.h"
 
 /* Find max header size of IP protocol (IPv4 or IPv6) */
@@ -1419,10 +1420,17 @@ pkt_alloc_with_buffer(struct k_mem_slab *slab,
 {
 	uint64_t end = sys_clock_timeout_end_calc(timeout);
 	struct net_pkt *pkt;
+	uint32_t start_time;
 	int ret;
 
 	NET_DBG("On iface %p size %zu", iface, size);
 
+	if (IS_ENABLED(CONFIG_NET_STATISTICS_PKT_ALLOC)) {
+		start_time = k_cycle_get_32();
+	} else {
+		ARG_UNUSED(start_time);
+	}
+
 #if NET_LOG_LEVEL >= LOG_LEVEL_DBG
 	pkt = pkt_alloc_on_iface(slab, iface, timeout, caller, line);
 #else
@@ -1430,6 +1438,9 @@ pkt_alloc_with_buffer(struct k_mem_slab *slab,
 #endif
 
 	if (!pkt) {
+		net_stats_update_pkt_alloc(iface, slab == &tx_pkts, 1, 0,
+					   start_time,
+					   k_mem_slab_num_used_get(slab));
 		return NULL;
 	}
 
@@ -1455,9 +1466,12 @@ pkt_alloc_with_buffer(struct k_mem_slab *slab,
 
 	if (ret) {
 		net_pkt_unref(pkt);
-		return NULL;
+		pkt = NULL;
 	}
 
+	net_stats_update_pkt_alloc(iface, slab == &tx_pkts, 1, pkt ? 1 : 0,
+				   start_time, k_mem_slab_num_used_get(slab));
+
 	return pkt;
 }
 
@@ -1511,6 +1525,199 @@ struct net_pkt *net_pkt_rx_alloc_with_buffer(struct net_if *iface,
 #endif
 }
 
+#if NET_LOG_LEVEL >= LOG_LEVEL_DBG
+static int pkt_alloc_bulk_with_buffer(struct k_mem_slab *slab,
+				      struct net_if *iface,
+				      struct net_pkt **pkts,
+				      const size_t *sizes,
+				      int count,
+				      sa_family_t family,
+				      enum net_ip_protocol proto,
+				      k_timeout_t timeout,
+				      const char *caller,
+				      int line)
+#else
+static int pkt_alloc_bulk_with_buffer(struct k_mem_slab *slab,
+				      struct net_if *iface,
+				      struct net_pkt **pkts,
+				      const size_t *sizes,
+				      int count,
+				      sa_family_t family,
+				      enum net_ip_protocol proto,
+				      k_timeout_t timeout)
+#endif
+{
+	struct net_buf_pool *pool = slab == &tx_pkts ? &tx_bufs : &rx_bufs;
+	uint64_t end = sys_clock_timeout_end_calc(timeout);
+	uint32_t start_time;
+	size_t hdr_len;
+	int allocated;
+	int i;
+
+	if (count <= 0) {
+		return 0;
+	}
+
+	if (IS_ENABLED(CONFIG_NET_STATISTICS_PKT_ALLOC)) {
+		start_time = k_cycle_get_32();
+	} else {
+		ARG_UNUSED(start_time);
+	}
+
+	NET_DBG("On iface %p count %d", iface, count);
+
+	/* Take all the packet structures first, only the first one is
+	 * allowed to wait.
+	 */
+	for (allocated = 0; allocated < count; allocated++) {
+#if NET_LOG_LEVEL >= LOG_LEVEL_DBG
+		pkts[allocated] = pkt_alloc_on_iface(slab, iface,
+						     allocated ? K_NO_WAIT : timeout,
+						     caller, line);
+#else
+		pkts[allocated] = pkt_alloc_on_iface(slab, iface,
+						     allocated ? K_NO_WAIT : timeout);
+#endif
+		if (!pkts[allocated]) {
+			break;
+		}
+
+		net_pkt_set_family(pkts[allocated], family);
+	}
+
+	if (!allocated) {
+		goto out;
+	}
+
+	/* All the packets share the same family and protocol, and none of
+	 * them has a buffer yet.
+	 */
+	hdr_len = pkt_estimate_headers_length(pkts[0], family, proto);
+
+	if (k_is_in_isr()) {
+		timeout = K_NO_WAIT;
+	} else if (!K_TIMEOUT_EQ(timeout, K_NO_WAIT) &&
+		   !K_TIMEOUT_EQ(timeout, K_FOREVER)) {
+		int64_t remaining = end - sys_clock_tick_get();
+
+		if (remaining <= 0) {
+			timeout = K_NO_WAIT;
+		} else {
+			timeout = Z_TIMEOUT_TICKS(remaining);
+		}
+	}
+
+	for (i = 0; i < allocated; i++) {
+		struct net_buf *buf;
+		size_t alloc_len;
+
+		if (!sizes[i] && proto == 0 && family == AF_UNSPEC) {
+			continue;
+		}
+
+		alloc_len = pkt_buffer_length(pkts[i], sizes[i] + hdr_len,
+					      proto, 0);
+
+#if NET_LOG_LEVEL >= LOG_LEVEL_DBG
+		buf = pkt_alloc_buffer(pool, alloc_len, timeout, caller, line);
+#else
+		buf = pkt_alloc_buffer(pool, alloc_len, timeout);
+#endif
+		if (!buf) {
+			NET_DBG("Data buffer (%zd) allocation failed for %d/%d",
+				alloc_len, i, allocated);
+			break;
+		}
+
+		net_pkt_append_buffer(pkts[i], buf);
+		timeout = K_NO_WAIT;
+	}
+
+	/* Give back the packets that did not get their buffer */
+	net_pkt_unref_bulk(&pkts[i], allocated - i);
+	allocated = i;
+
+out:
+	net_stats_update_pkt_alloc(iface, slab == &tx_pkts, count, allocated,
+				   start_time, k_mem_slab_num_used_get(slab));
+
+	for (i = allocated; i < count; i++) {
+		pkts[i] = NULL;
+	}
+
+	return allocated;
+}
+
+#if NET_LOG_LEVEL >= LOG_LEVEL_DBG
+int net_pkt_alloc_bulk_with_buffer_debug(struct net_if *iface,
+					 struct net_pkt **pkts,
+					 const size_t *sizes,
+					 int count,
+					 sa_family_t family,
+					 enum net_ip_protocol proto,
+					 k_timeout_t timeout,
+					 const char *caller,
+					 int line)
+#else
+int net_pkt_alloc_bulk_with_buffer(struct net_if *iface,
+				   struct net_pkt **pkts,
+				   const size_t *sizes,
+				   int count,
+				   sa_family_t family,
+				   enum net_ip_protocol proto,
+				   k_timeout_t timeout)
+#endif
+{
+#if NET_LOG_LEVEL >= LOG_LEVEL_DBG
+	return pkt_alloc_bulk_with_buffer(&tx_pkts, iface, pkts, sizes, count,
+					  family, proto, timeout, caller, line);
+#else
+	return pkt_alloc_bulk_with_buffer(&tx_pkts, iface, pkts, sizes, count,
+					  family, proto, timeout);
+#endif
+}
+
+#if NET_LOG_LEVEL >= LOG_LEVEL_DBG
+int net_pkt_rx_alloc_bulk_with_buffer_debug(struct net_if *iface,
+					    struct net_pkt **pkts,
+					    const size_t *sizes,
+					    int count,
+					    sa_family_t family,
+					    enum net_ip_protocol proto,
+					    k_timeout_t timeout,
+					    const char *caller,
+					    int line)
+#else
+int net_pkt_rx_alloc_bulk_with_buffer(struct net_if *iface,
+				      struct net_pkt **pkts,
+				      const size_t *sizes,
+				      int count,
+				      sa_family_t family,
+				      enum net_ip_protocol proto,
+				      k_timeout_t timeout)
+#endif
+{
+#if NET_LOG_LEVEL >= LOG_LEVEL_DBG
+	return pkt_alloc_bulk_with_buffer(&rx_pkts, iface, pkts, sizes, count,
+					  family, proto, timeout, caller, line);
+#else
+	return pkt_alloc_bulk_with_buffer(&rx_pkts, iface, pkts, sizes, count,
+					  family, proto, timeout);
+#endif
+}
+
+void net_pkt_unref_bulk(struct net_pkt **pkts, int count)
+{
+	int i;
+
+	for (i = 0; i < count; i++) {
+		if (pkts[i]) {
+			net_pkt_unref(pkts[i]);
+			pkts[i] = NULL;
+		}
+	}
+}
+
 void net_pkt_append_buffer(struct net_pkt *pkt, struct net_buf *buffer)
 {
 	if (!pkt->buffer) {
@@ -1589,13 +1796,16 @@ static void pkt_cursor_update(struct net_pkt *pkt,
 	}
 }
 
-/* Internal function that does all operation (skip/read/write/memset) */
+/* Internal function that does all operation (skip/read/write/memset).
+ * If chksum is given, the copied data is summed on the fly.
+ */
 static int net_pkt_cursor_operate(struct net_pkt *pkt,
 				  void *data, size_t length,
-				  bool copy, bool write)
+				  bool copy, bool write, uint16_t *chksum)
 {
 	/* We use such variable to avoid lengthy lines */
 	struct net_pkt_cursor *c_op = &pkt->cursor;
+	size_t done = 0;
 
 	while (c_op->buf && length) {
 		size_t d_len, len;
@@ -1623,7 +1833,21 @@ static int net_pkt_cursor_operate(struct net_pkt *pkt,
 			len = d_len;
 		}
 
-		if (copy && data) {
+		if (copy && data && chksum) {
+			uint16_t sum;
+
+			sum = calc_chksum_copy(0U,
+					       write ? c_op->pos : data,
+					       write ? data : c_op->pos,
+					       len);
+
+			/* Chunk starting at an odd offset is byte swapped */
+			if (done & 1) {
+				sum = __bswap_16(sum);
+			}
+
+			*chksum = calc_chksum_add(*chksum, sum);
+		} else if (copy && data) {
 			memcpy(write ? c_op->pos : data,
 			       write ? data : c_op->pos,
 			       len);
@@ -1642,6 +1866,7 @@ static int net_pkt_cursor_operate(struct net_pkt *pkt,
 		}
 
 		length -= len;
+		done += len;
 	}
 
 	if (length) {
@@ -1656,21 +1881,22 @@ int net_pkt_skip(struct net_pkt *pkt, size_t skip)
 {
 	NET_DBG("pkt %p skip %zu", pkt, skip);
 
-	return net_pkt_cursor_operate(pkt, NULL, skip, false, true);
+	return net_pkt_cursor_operate(pkt, NULL, skip, false, true, NULL);
 }
 
 int net_pkt_memset(struct net_pkt *pkt, int byte, size_t amount)
 {
 	NET_DBG("pkt %p byte %d amount %zu", pkt, byte, amount);
 
-	return net_pkt_cursor_operate(pkt, &byte, amount, false, true);
+	return net_pkt_cursor_operate(pkt, &byte, amount, false, true,
+				      NULL);
 }
 
 int net_pkt_read(struct net_pkt *pkt, void *data, size_t length)
 {
 	NET_DBG("pkt %p data %p length %zu", pkt, data, length);
 
-	return net_pkt_cursor_operate(pkt, data, length, true, false);
+	return net_pkt_cursor_operate(pkt, data, length, true, false, NULL);
 }
 
 int net_pkt_read_be16(struct net_pkt *pkt, uint16_t *data)
@@ -1717,7 +1943,19 @@ int net_pkt_write(struct net_pkt *pkt, const void *data, size_t length)
 		return net_pkt_skip(pkt, length);
 	}
 
-	return net_pkt_cursor_operate(pkt, (void *)data, length, true, true);
+	return net_pkt_cursor_operate(pkt, (void *)data, length, true, true,
+				      NULL);
+}
+
+int net_pkt_write_chksum(struct net_pkt *pkt, const void *data, size_t length,
+			 uint16_t *chksum)
+{
+	NET_DBG("pkt %p data %p length %zu", pkt, data, length);
+
+	*chksum = 0U;
+
+	return net_pkt_cursor_operate(pkt, (void *)data, length, true, true,
+				      chksum);
 }
 
 int net_pkt_copy(struct net_pkt *pkt_dst,
@@ -1843,6 +2081,7 @@ static void clone_pkt_attributes(struct net_pkt *pkt, struct net_pkt *clone_pkt)
 
 	net_pkt_set_l2_bridged(clone_pkt, net_pkt_is_l2_bridged(pkt));
 	net_pkt_set_l2_processed(clone_pkt, net_pkt_is_l2_processed(pkt));
+	net_pkt_set_chksum_valid(clone_pkt, net_pkt_is_chksum_valid(pkt));
 	net_pkt_set_ll_proto_type(clone_pkt, net_pkt_ll_proto_type(pkt));
 
 	if (pkt->buffer && clone_pkt->buffer) {
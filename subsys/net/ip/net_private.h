@@ -93,6 +93,9 @@ static inline enum net_verdict net_ipv6_input(struct net_pkt *pkt,
 #endif
 extern bool net_tc_submit_to_tx_queue(uint8_t tc, struct net_pkt *pkt);
 extern void net_tc_submit_to_rx_queue(uint8_t tc, struct net_pkt *pkt);
+#if defined(CONFIG_NET_TC_RX_FLOW_HASH)
+extern int net_rx_flow2tc(struct net_pkt *pkt);
+#endif
 extern enum net_verdict net_promisc_mode_input(struct net_pkt *pkt);
 
 char *net_sprint_addr(sa_family_t af, const void *addr);
@@ -151,8 +154,24 @@ extern char *net_byte_to_hex(char *ptr, uint8_t byte, char base, bool pad);
 extern char *net_sprint_ll_addr_buf(const uint8_t *ll, uint8_t ll_len,
 				    char *buf, int buflen);
 extern uint16_t calc_chksum(uint16_t sum_in, const uint8_t *data, size_t len);
+extern uint16_t calc_chksum_copy(uint16_t sum_in, uint8_t *dst,
+				 const uint8_t *src, size_t len);
 extern uint16_t net_calc_chksum(struct net_pkt *pkt, uint8_t proto);
 
+/* Write data to the packet like net_pkt_write() does and return the
+ * checksum of the written data in chksum, as calc_chksum() would.
+ */
+int net_pkt_write_chksum(struct net_pkt *pkt, const void *data, size_t length,
+			 uint16_t *chksum);
+
+/* Add two partial checksums computed by calc_chksum() */
+static inline uint16_t calc_chksum_add(uint16_t sum_a, uint16_t sum_b)
+{
+	uint32_t sum = (uint32_t)sum_a + sum_b;
+
+	return (uint16_t)((sum & 0xffff) + (sum >> 16));
+}
+
 /**
  * @brief Deliver the incoming packet through the recv_cb of the net_context
  *        to the upper layers
@@ -1132,6 +1132,16 @@ static void print_tc_rx_stats(const struct shell *sh, struct net_if *iface)
 #if NET_TC_RX_COUNT > 1
 	int i;
 
+#if defined(CONFIG_NET_TC_RX_FLOW_HASH)
+	PR("RX flow queue statistics:\n");
+	PR("Queue\tRecv pkts\tbytes\n");
+
+	for (i = 0; i < NET_TC_RX_COUNT; i++) {
+		PR("[%d]\t%d\t\t%d\n", i,
+		   GET_STAT(iface, tc.recv[i].pkts),
+		   GET_STAT(iface, tc.recv[i].bytes));
+	}
+#else
 	PR("RX traffic class statistics:\n");
 
 #if defined(CONFIG_NET_PKT_RXTIME_STATS)
@@ -1169,6 +1179,7 @@ static void print_tc_rx_stats(const struct shell *sh, struct net_if *iface)
 		   GET_STAT(iface, tc.recv[i].bytes));
 	}
 #endif /* CONFIG_NET_PKT_RXTIME_STATS */
+#endif /* CONFIG_NET_TC_RX_FLOW_HASH */
 #else
 	ARG_UNUSED(sh);
 
@@ -1187,6 +1198,49 @@ static void print_tc_rx_stats(const struct shell *sh, struct net_if *iface)
 #endif /* NET_TC_RX_COUNT > 1 */
 }
 
+#if defined(CONFIG_NET_STATISTICS_PKT_ALLOC)
+static void print_pkt_alloc_stats(const struct shell *sh, const char *name,
+				  const struct net_stats_pkt_alloc *stats)
+{
+	PR("%s packet allocation stats:\n", name);
+	PR("\tAllocated     : %u\n", stats->allocs);
+	PR("\tFailures      : %u\n", stats->failures);
+	PR("\tBulk requests : %u\n", stats->bulk_allocs);
+	PR("\tAverage time  : %u us\n", stats->time_count ?
+	   (uint32_t)(stats->time_sum / (uint64_t)stats->time_count) : 0U);
+	PR("\tMaximum time  : %u us\n", stats->time_max);
+	PR("\tMaximum used  : %u\n", stats->max_used);
+}
+#endif
+
+static void print_pkt_allocs_stats(const struct shell *sh,
+				   struct net_if *iface)
+{
+#if defined(CONFIG_NET_STATISTICS_PKT_ALLOC)
+	print_pkt_alloc_stats(sh, "RX", GET_STAT_ADDR(iface, rx_alloc));
+	print_pkt_alloc_stats(sh, "TX", GET_STAT_ADDR(iface, tx_alloc));
+#else
+	ARG_UNUSED(sh);
+	ARG_UNUSED(iface);
+#endif
+}
+
+static void print_fq_codel_stats(const struct shell *sh, struct net_if *iface)
+{
+#if defined(CONFIG_NET_TC_TX_FQ_CODEL)
+	PR("FQ-CoDel TX queue stats:\n");
+	PR("\tCoDel drops   : %u\n",
+	   GET_STAT(iface, fq_codel.codel_drops));
+	PR("\tOverlimit     : %u\n",
+	   GET_STAT(iface, fq_codel.overlimit_drops));
+	PR("\tNew flows     : %u\n",
+	   GET_STAT(iface, fq_codel.new_flows));
+#else
+	ARG_UNUSED(sh);
+	ARG_UNUSED(iface);
+#endif
+}
+
 static void print_net_pm_stats(const struct shell *sh, struct net_if *iface)
 {
 #if defined(CONFIG_NET_STATISTICS_POWER_MANAGEMENT)
@@ -1311,6 +1365,8 @@ static void net_shell_print_statistics(struct net_if *iface, void *user_data)
 
 	print_tc_tx_stats(sh, iface);
 	print_tc_rx_stats(sh, iface);
+	print_fq_codel_stats(sh, iface);
+	print_pkt_allocs_stats(sh, iface);
 
 #if defined(CONFIG_NET_STATISTICS_ETHERNET) && \
 					defined(CONFIG_NET_STATISTICS_USER_API)
@@ -2298,6 +2354,80 @@ static int cmd_net_dns_query(const struct shell *sh, size_t argc,
 	return 0;
 }
 
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+static void dns_cache_cb(const struct dns_cache_info *info, void *user_data)
+{
+	const struct shell *sh = user_data;
+	char addr[NET_IPV6_ADDR_LEN];
+	int i;
+
+	PR("\t%s %s ttl %u%s\n", info->name,
+	   info->query_type == DNS_QUERY_TYPE_A ? "A" : "AAAA", info->ttl,
+	   info->status == DNS_EAI_NONAME ? " (no such name)" :
+	   info->status == DNS_EAI_NODATA ? " (no address)" : "");
+
+	for (i = 0; i < info->addr_count; i++) {
+		const struct sockaddr *sa = &info->addrs[i];
+
+		if (sa->sa_family == AF_INET) {
+			net_addr_ntop(AF_INET, &net_sin(sa)->sin_addr,
+				      addr, sizeof(addr));
+		} else if (sa->sa_family == AF_INET6) {
+			net_addr_ntop(AF_INET6, &net_sin6(sa)->sin6_addr,
+				      addr, sizeof(addr));
+		} else {
+			continue;
+		}
+
+		PR("\t\t%s\n", addr);
+	}
+}
+#endif
+
+static int cmd_net_dns_cache(const struct shell *sh, size_t argc,
+			     char *argv[])
+{
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+	struct dns_cache_stats stats;
+#endif
+
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+	dns_cache_stats_get(&stats);
+
+	PR("DNS cache entries %u, hits %u (negative %u), misses %u, "
+	   "evictions %u\n", stats.entries, stats.hits, stats.negative_hits,
+	   stats.misses, stats.evictions);
+
+	dns_cache_foreach(dns_cache_cb, (void *)sh);
+#else
+	PR_INFO("Set %s to enable %s support.\n", "CONFIG_DNS_RESOLVER_CACHE",
+		"DNS cache");
+#endif
+
+	return 0;
+}
+
+static int cmd_net_dns_cache_flush(const struct shell *sh, size_t argc,
+				   char *argv[])
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+	dns_cache_flush();
+
+	PR("DNS cache flushed.\n");
+#else
+	PR_INFO("Set %s to enable %s support.\n", "CONFIG_DNS_RESOLVER_CACHE",
+		"DNS cache");
+#endif
+
+	return 0;
+}
+
 static int cmd_net_dns(const struct shell *sh, size_t argc, char *argv[])
 {
 #if defined(CONFIG_DNS_RESOLVER)
@@ -6252,7 +6382,16 @@ SHELL_STATIC_SUBCMD_SET_CREATE(net_cmd_capture,
 	SHELL_SUBCMD_SET_END
 );
 
+SHELL_STATIC_SUBCMD_SET_CREATE(net_cmd_dns_cache,
+	SHELL_CMD(flush, NULL, "Remove all the cached answers.",
+		  cmd_net_dns_cache_flush),
+	SHELL_SUBCMD_SET_END
+);
+
 SHELL_STATIC_SUBCMD_SET_CREATE(net_cmd_dns,
+	SHELL_CMD(cache, &net_cmd_dns_cache,
+		  "Show the cached answers and cache statistics.",
+		  cmd_net_dns_cache),
 	SHELL_CMD(cancel, NULL, "Cancel all pending requests.",
 		  cmd_net_dns_cancel),
 	SHELL_CMD(query, NULL,
@@ -595,6 +595,84 @@ static inline void net_stats_update_tc_rx_time_detail(struct net_if *iface,
 #endif /* CONFIG_NET_PKT_RXTIME_STATS_DETAIL */
 #endif /* NET_TC_COUNT > 1 */
 
+#if defined(CONFIG_NET_TC_TX_FQ_CODEL) && defined(CONFIG_NET_STATISTICS) \
+	&& defined(CONFIG_NET_NATIVE)
+static inline void net_stats_update_fq_codel_drop(struct net_if *iface)
+{
+	UPDATE_STAT(iface, stats.fq_codel.codel_drops++);
+}
+
+static inline void net_stats_update_fq_codel_overlimit(struct net_if *iface)
+{
+	UPDATE_STAT(iface, stats.fq_codel.overlimit_drops++);
+}
+
+static inline void net_stats_update_fq_codel_new_flow(struct net_if *iface)
+{
+	UPDATE_STAT(iface, stats.fq_codel.new_flows++);
+}
+#else
+#define net_stats_update_fq_codel_drop(iface)
+#define net_stats_update_fq_codel_overlimit(iface)
+#define net_stats_update_fq_codel_new_flow(iface)
+#endif /* CONFIG_NET_TC_TX_FQ_CODEL && CONFIG_NET_STATISTICS */
+
+#if defined(CONFIG_NET_STATISTICS_PKT_ALLOC) && defined(CONFIG_NET_STATISTICS) \
+	&& defined(CONFIG_NET_NATIVE)
+static inline void pkt_alloc_stats_update(struct net_stats_pkt_alloc *stats,
+					  int requested, int allocated,
+					  uint32_t time, uint32_t used)
+{
+	stats->allocs += allocated;
+
+	if (allocated < requested) {
+		stats->failures++;
+	}
+
+	if (requested > 1) {
+		stats->bulk_allocs++;
+	}
+
+	stats->time_sum += time;
+	stats->time_count++;
+
+	if (time > stats->time_max) {
+		stats->time_max = time;
+	}
+
+	if (used > stats->max_used) {
+		stats->max_used = used;
+	}
+}
+
+/* The interface is optional here as packets can be allocated before
+ * being bound to one.
+ */
+static inline void net_stats_update_pkt_alloc(struct net_if *iface, bool tx,
+					      int requested, int allocated,
+					      uint32_t start_time,
+					      uint32_t used)
+{
+	uint32_t time = k_cyc_to_us_floor32(k_cycle_get_32() - start_time);
+
+	pkt_alloc_stats_update(tx ? &net_stats.tx_alloc : &net_stats.rx_alloc,
+			       requested, allocated, time, used);
+
+#if defined(CONFIG_NET_STATISTICS_PER_INTERFACE)
+	if (iface) {
+		pkt_alloc_stats_update(tx ? &iface->stats.tx_alloc :
+					    &iface->stats.rx_alloc,
+				       requested, allocated, time, used);
+	}
+#else
+	ARG_UNUSED(iface);
+#endif
+}
+#else
+#define net_stats_update_pkt_alloc(iface, tx, requested, allocated,	\
+				   start_time, used)
+#endif /* CONFIG_NET_STATISTICS_PKT_ALLOC && CONFIG_NET_STATISTICS */
+
 #if defined(CONFIG_NET_STATISTICS_POWER_MANAGEMENT)	\
 	&& defined(CONFIG_NET_STATISTICS) && defined(CONFIG_NET_NATIVE)
 static inline void net_stats_add_suspend_start_time(struct net_if *iface,
@@ -8,15 +8,18 @@
 LOG_MODULE_REGISTER(net_tc, CONFIG_NET_TC_LOG_LEVEL);
 
 #include <zephyr/kernel.h>
+#include <zephyr/sys/byteorder.h>
 #include <string.h>
 
 #include <zephyr/net/net_core.h>
 #include <zephyr/net/net_pkt.h>
 #include <zephyr/net/net_stats.h>
+#include <zephyr/net/ethernet.h>
 
 #include "net_private.h"
 #include "net_stats.h"
 #include "net_tc_mapping.h"
+#include "ipv4.h"
 
 /* Template for thread name. The "xx" is either "TX" denoting transmit thread,
  * or "RX" denoting receive thread. The "q[y]" denotes the traffic class queue
@@ -40,7 +43,12 @@ static struct net_traffic_class tx_classes[NET_TC_TX_COUNT];
 static struct net_traffic_class rx_classes[NET_TC_RX_COUNT];
 #endif
 
-#if NET_TC_RX_COUNT > 0 || NET_TC_TX_COUNT > 0
+#if defined(CONFIG_NET_TC_TX_FQ_CODEL)
+static void fq_codel_enqueue(uint8_t tc, struct net_pkt *pkt);
+#endif
+
+#if NET_TC_RX_COUNT > 0 || \
+	(NET_TC_TX_COUNT > 0 && !defined(CONFIG_NET_TC_TX_FQ_CODEL))
 static void submit_to_queue(struct k_fifo *queue, struct net_pkt *pkt)
 {
 	k_fifo_put(queue, pkt);
@@ -52,7 +60,11 @@ bool net_tc_submit_to_tx_queue(uint8_t tc, struct net_pkt *pkt)
 #if NET_TC_TX_COUNT > 0
 	net_pkt_set_tx_stats_tick(pkt, k_cycle_get_32());
 
+#if defined(CONFIG_NET_TC_TX_FQ_CODEL)
+	fq_codel_enqueue(tc, pkt);
+#else
 	submit_to_queue(&tx_classes[tc].fifo, pkt);
+#endif
 #else
 	ARG_UNUSED(tc);
 	ARG_UNUSED(pkt);
@@ -104,6 +116,519 @@ int net_rx_priority2tc(enum net_priority prio)
 #endif
 }
 
+#if defined(CONFIG_NET_TC_RX_FLOW_HASH) || defined(CONFIG_NET_TC_TX_FQ_CODEL)
+static inline uint32_t flow_hash_mix(uint32_t hash, uint32_t val)
+{
+	val *= 0xcc9e2d51U;
+	val = (val << 15) | (val >> 17);
+	val *= 0x1b873593U;
+
+	hash ^= val;
+	hash = (hash << 13) | (hash >> 19);
+
+	return hash * 5U + 0xe6546b64U;
+}
+
+static inline uint32_t flow_hash_final(uint32_t hash)
+{
+	hash ^= hash >> 16;
+	hash *= 0x85ebca6bU;
+	hash ^= hash >> 13;
+	hash *= 0xc2b2ae35U;
+	hash ^= hash >> 16;
+
+	return hash;
+}
+
+static uint32_t flow_hash_addr(uint32_t hash, const uint8_t *addr, size_t len)
+{
+	size_t i;
+
+	for (i = 0; i < len; i += sizeof(uint32_t)) {
+		hash = flow_hash_mix(hash, sys_get_le32(&addr[i]));
+	}
+
+	return hash;
+}
+
+/* Calculate a hash over the addresses, protocol and ports of the packet.
+ * The cursor must point to the start of the IP header, and it is left at
+ * an unspecified position. Packets that cannot be parsed get hash value 0.
+ */
+static uint32_t flow_hash(struct net_pkt *pkt)
+{
+	union {
+		struct net_ipv4_hdr ipv4;
+		struct net_ipv6_hdr ipv6;
+	} hdr;
+	uint32_t hash = 0U;
+	uint32_t ports = 0U;
+	size_t opts_len = 0;
+	uint8_t proto;
+
+	if (net_pkt_read(pkt, &hdr, sizeof(struct net_ipv4_hdr))) {
+		return 0U;
+	}
+
+	switch (hdr.ipv4.vhl >> 4) {
+	case 4:
+		hash = flow_hash_addr(hash, hdr.ipv4.src,
+				      2 * NET_IPV4_ADDR_SIZE);
+		proto = hdr.ipv4.proto;
+
+		/* Only the first fragment has the ports, so use the
+		 * addresses alone to keep all the fragments in one queue.
+		 */
+		if (sys_get_be16(hdr.ipv4.offset) &
+		    (NET_IPV4_FRAGH_OFFSET_MASK | NET_IPV4_MORE_FRAG_MASK)) {
+			proto = 0U;
+		}
+
+		opts_len = ((hdr.ipv4.vhl & NET_IPV4_IHL_MASK) * 4U) -
+			   sizeof(struct net_ipv4_hdr);
+		break;
+	case 6:
+		if (net_pkt_read(pkt, (uint8_t *)&hdr + sizeof(struct net_ipv4_hdr),
+				 sizeof(struct net_ipv6_hdr) -
+				 sizeof(struct net_ipv4_hdr))) {
+			return 0U;
+		}
+
+		hash = flow_hash_addr(hash, hdr.ipv6.src,
+				      2 * NET_IPV6_ADDR_SIZE);
+		proto = hdr.ipv6.nexthdr;
+		break;
+	default:
+		return 0U;
+	}
+
+	if ((proto == IPPROTO_TCP || proto == IPPROTO_UDP) &&
+	    !net_pkt_skip(pkt, opts_len) &&
+	    !net_pkt_read(pkt, &ports, sizeof(ports))) {
+		hash = flow_hash_mix(hash, ports);
+	}
+
+	return flow_hash_final(flow_hash_mix(hash, proto));
+}
+#endif /* CONFIG_NET_TC_RX_FLOW_HASH || CONFIG_NET_TC_TX_FQ_CODEL */
+
+#if defined(CONFIG_NET_TC_RX_FLOW_HASH)
+/* Move the cursor to the start of the IP header. Only the link layers that
+ * carry plain IP packets are supported.
+ */
+static int rx_flow_skip_l2(struct net_pkt *pkt)
+{
+	const struct net_l2 *l2 = net_if_l2(net_pkt_iface(pkt));
+
+#if defined(CONFIG_NET_L2_ETHERNET)
+	if (l2 == &NET_L2_GET_NAME(ETHERNET)) {
+		uint16_t type;
+
+		if (net_pkt_skip(pkt, 2 * sizeof(struct net_eth_addr)) ||
+		    net_pkt_read_be16(pkt, &type)) {
+			return -ENOBUFS;
+		}
+
+		if (type == NET_ETH_PTYPE_VLAN &&
+		    (net_pkt_skip(pkt, sizeof(uint16_t)) ||
+		     net_pkt_read_be16(pkt, &type))) {
+			return -ENOBUFS;
+		}
+
+		if (type != NET_ETH_PTYPE_IP && type != NET_ETH_PTYPE_IPV6) {
+			return -ENOTSUP;
+		}
+
+		return 0;
+	}
+#endif
+
+#if defined(CONFIG_NET_L2_DUMMY)
+	if (l2 == &NET_L2_GET_NAME(DUMMY)) {
+		return 0;
+	}
+#endif
+
+	ARG_UNUSED(l2);
+
+	return -ENOTSUP;
+}
+
+/* The received packet still contains the link layer header, so it is
+ * skipped before hashing.
+ */
+static uint32_t rx_flow_hash(struct net_pkt *pkt)
+{
+	struct net_pkt_cursor backup;
+	uint32_t hash = 0U;
+
+	net_pkt_cursor_backup(pkt, &backup);
+
+	if (rx_flow_skip_l2(pkt) == 0) {
+		hash = flow_hash(pkt);
+	}
+
+	net_pkt_cursor_restore(pkt, &backup);
+
+	return hash;
+}
+
+int net_rx_flow2tc(struct net_pkt *pkt)
+{
+	return rx_flow_hash(pkt) % NET_TC_RX_COUNT;
+}
+#endif /* CONFIG_NET_TC_RX_FLOW_HASH */
+
+#if defined(CONFIG_NET_TC_TX_FQ_CODEL)
+/* FQ-CoDel (RFC 8290) for the TX traffic classes. The packets of a class
+ * are spread to flow queues by their flow hash, the flows are served by
+ * deficit round robin, and each flow queue is managed by CoDel (RFC 8289).
+ * Packets are never ECN marked, they are always dropped.
+ */
+#define FQ_CODEL_FLOWS CONFIG_NET_TC_TX_FQ_CODEL_FLOWS
+#define FQ_CODEL_QUANTUM CONFIG_NET_TC_TX_FQ_CODEL_QUANTUM
+#define FQ_CODEL_TARGET_US CONFIG_NET_TC_TX_FQ_CODEL_TARGET
+#define FQ_CODEL_INTERVAL_US \
+	((uint64_t)CONFIG_NET_TC_TX_FQ_CODEL_INTERVAL * USEC_PER_MSEC)
+#define FQ_CODEL_LIMIT CONFIG_NET_TC_TX_FQ_CODEL_LIMIT
+
+/* The packets are linked through the first word of net_pkt, the same way
+ * as k_fifo does it.
+ */
+#define FQ_CODEL_PKT_NODE(pkt) ((sys_snode_t *)&(pkt)->fifo)
+#define FQ_CODEL_NODE_PKT(node) CONTAINER_OF(node, struct net_pkt, fifo)
+
+struct fq_codel_flow {
+	/** Queued packets of this flow */
+	sys_slist_t pkts;
+	/** Node in the new or old flows list */
+	sys_snode_t node;
+	/** Bytes queued in this flow */
+	uint32_t backlog;
+	/** Bytes this flow can still send in the current round */
+	int32_t deficit;
+	/** CoDel state, the times are in microseconds of uptime */
+	uint64_t first_above_time;
+	uint64_t drop_next;
+	uint32_t count;
+	uint32_t last_count;
+	bool dropping;
+	/** Is the flow in the new or old flows list */
+	bool active;
+};
+
+struct fq_codel {
+	struct fq_codel_flow flows[FQ_CODEL_FLOWS];
+	sys_slist_t new_flows;
+	sys_slist_t old_flows;
+	struct k_spinlock lock;
+	/** Given once for every queued packet */
+	struct k_sem pending;
+	int queued;
+};
+
+static struct fq_codel tx_fq_codel[NET_TC_TX_COUNT];
+
+static uint32_t fq_codel_isqrt(uint32_t val)
+{
+	uint32_t res = 0U;
+	uint32_t bit = 1U << 30;
+
+	while (bit > val) {
+		bit >>= 2;
+	}
+
+	while (bit != 0U) {
+		if (val >= res + bit) {
+			val -= res + bit;
+			res = (res >> 1) + bit;
+		} else {
+			res >>= 1;
+		}
+
+		bit >>= 2;
+	}
+
+	return res;
+}
+
+static inline uint64_t codel_control_law(uint64_t t, uint32_t count)
+{
+	return t + FQ_CODEL_INTERVAL_US / fq_codel_isqrt(count);
+}
+
+static struct net_pkt *fq_codel_pop(struct fq_codel *fq,
+				    struct fq_codel_flow *flow)
+{
+	sys_snode_t *node;
+	struct net_pkt *pkt;
+
+	node = sys_slist_get(&flow->pkts);
+	if (node == NULL) {
+		return NULL;
+	}
+
+	pkt = FQ_CODEL_NODE_PKT(node);
+
+	flow->backlog -= net_pkt_get_len(pkt);
+	fq->queued--;
+
+	return pkt;
+}
+
+/* Take the head packet of the flow and check if the queueing delay has
+ * stayed above the target for at least one interval.
+ */
+static struct net_pkt *codel_dodequeue(struct fq_codel *fq,
+				       struct fq_codel_flow *flow,
+				       uint64_t now, bool *ok_to_drop)
+{
+	struct net_pkt *pkt;
+	uint32_t sojourn;
+
+	*ok_to_drop = false;
+
+	pkt = fq_codel_pop(fq, flow);
+	if (pkt == NULL) {
+		flow->first_above_time = 0U;
+		return NULL;
+	}
+
+	sojourn = k_cyc_to_us_floor32(k_cycle_get_32() -
+				      net_pkt_tx_queue_time(pkt));
+
+	if (sojourn < FQ_CODEL_TARGET_US ||
+	    flow->backlog <= FQ_CODEL_QUANTUM) {
+		flow->first_above_time = 0U;
+	} else if (flow->first_above_time == 0U) {
+		flow->first_above_time = now + FQ_CODEL_INTERVAL_US;
+	} else if (now >= flow->first_above_time) {
+		*ok_to_drop = true;
+	}
+
+	return pkt;
+}
+
+/* The packets that CoDel decides to drop are collected to the dropped
+ * list, so that they can be freed after the lock is released.
+ */
+static struct net_pkt *codel_dequeue(struct fq_codel *fq,
+				     struct fq_codel_flow *flow,
+				     sys_slist_t *dropped)
+{
+	uint64_t now = k_ticks_to_us_floor64(k_uptime_ticks());
+	struct net_pkt *pkt;
+	bool ok_to_drop;
+
+	pkt = codel_dodequeue(fq, flow, now, &ok_to_drop);
+	if (pkt == NULL) {
+		flow->dropping = false;
+		return NULL;
+	}
+
+	if (flow->dropping) {
+		if (!ok_to_drop) {
+			flow->dropping = false;
+		}
+
+		while (flow->dropping && now >= flow->drop_next) {
+			sys_slist_append(dropped, FQ_CODEL_PKT_NODE(pkt));
+			flow->count++;
+
+			pkt = codel_dodequeue(fq, flow, now, &ok_to_drop);
+			if (pkt == NULL || !ok_to_drop) {
+				flow->dropping = false;
+			} else {
+				flow->drop_next =
+					codel_control_law(flow->drop_next,
+							  flow->count);
+			}
+		}
+	} else if (ok_to_drop) {
+		uint32_t delta;
+
+		sys_slist_append(dropped, FQ_CODEL_PKT_NODE(pkt));
+
+		pkt = codel_dodequeue(fq, flow, now, &ok_to_drop);
+		flow->dropping = true;
+
+		/* If we were dropping recently, continue from the drop
+		 * rate that controlled the queue the last time.
+		 */
+		delta = flow->count - flow->last_count;
+		if (delta > 1 && (int64_t)(now - flow->drop_next) <
+				 (int64_t)(16 * FQ_CODEL_INTERVAL_US)) {
+			flow->count = delta;
+		} else {
+			flow->count = 1U;
+		}
+
+		flow->drop_next = codel_control_law(now, flow->count);
+		flow->last_count = flow->count;
+	}
+
+	return pkt;
+}
+
+static struct net_pkt *fq_codel_dequeue(struct fq_codel *fq,
+					sys_slist_t *dropped)
+{
+	k_spinlock_key_t key = k_spin_lock(&fq->lock);
+	struct net_pkt *pkt = NULL;
+	struct fq_codel_flow *flow;
+	sys_slist_t *list;
+	sys_snode_t *node;
+
+	while (true) {
+		list = &fq->new_flows;
+		node = sys_slist_peek_head(list);
+		if (node == NULL) {
+			list = &fq->old_flows;
+			node = sys_slist_peek_head(list);
+			if (node == NULL) {
+				break;
+			}
+		}
+
+		flow = CONTAINER_OF(node, struct fq_codel_flow, node);
+
+		if (flow->deficit <= 0) {
+			flow->deficit += FQ_CODEL_QUANTUM;
+			sys_slist_get(list);
+			sys_slist_append(&fq->old_flows, node);
+			continue;
+		}
+
+		pkt = codel_dequeue(fq, flow, dropped);
+		if (pkt == NULL) {
+			sys_slist_get(list);
+
+			/* An emptied new flow goes through the old flows
+			 * list once, so that a flow sending one packet at a
+			 * time cannot starve the others.
+			 */
+			if (list == &fq->new_flows &&
+			    !sys_slist_is_empty(&fq->old_flows)) {
+				sys_slist_append(&fq->old_flows, node);
+			} else {
+				flow->active = false;
+			}
+
+			continue;
+		}
+
+		flow->deficit -= net_pkt_get_len(pkt);
+		break;
+	}
+
+	k_spin_unlock(&fq->lock, key);
+
+	return pkt;
+}
+
+static struct net_pkt *fq_codel_drop_fattest(struct fq_codel *fq)
+{
+	struct fq_codel_flow *fattest = &fq->flows[0];
+	int i;
+
+	for (i = 1; i < FQ_CODEL_FLOWS; i++) {
+		if (fq->flows[i].backlog > fattest->backlog) {
+			fattest = &fq->flows[i];
+		}
+	}
+
+	return fq_codel_pop(fq, fattest);
+}
+
+static void fq_codel_enqueue(uint8_t tc, struct net_pkt *pkt)
+{
+	struct fq_codel *fq = &tx_fq_codel[tc];
+	struct net_if *iface = net_pkt_iface(pkt);
+	struct net_pkt *dropped = NULL;
+	struct net_pkt_cursor backup;
+	struct fq_codel_flow *flow;
+	bool new_flow = false;
+	k_spinlock_key_t key;
+	uint32_t hash;
+
+	/* The link layer header is added later, so the packet starts with
+	 * the IP header here.
+	 */
+	net_pkt_cursor_backup(pkt, &backup);
+	net_pkt_cursor_init(pkt);
+	hash = flow_hash(pkt);
+	net_pkt_cursor_restore(pkt, &backup);
+
+	flow = &fq->flows[hash % FQ_CODEL_FLOWS];
+
+	net_pkt_set_tx_queue_time(pkt, k_cycle_get_32());
+
+	key = k_spin_lock(&fq->lock);
+
+	sys_slist_append(&flow->pkts, FQ_CODEL_PKT_NODE(pkt));
+	flow->backlog += net_pkt_get_len(pkt);
+	fq->queued++;
+
+	if (!flow->active) {
+		flow->active = true;
+		flow->deficit = FQ_CODEL_QUANTUM;
+		sys_slist_append(&fq->new_flows, &flow->node);
+		new_flow = true;
+	}
+
+	if (fq->queued > FQ_CODEL_LIMIT) {
+		dropped = fq_codel_drop_fattest(fq);
+	}
+
+	k_spin_unlock(&fq->lock, key);
+
+	if (new_flow) {
+		net_stats_update_fq_codel_new_flow(iface);
+	}
+
+	if (dropped != NULL) {
+		NET_DBG("TC %d queue full, dropping pkt %p", tc, dropped);
+
+		net_stats_update_fq_codel_overlimit(net_pkt_iface(dropped));
+		net_pkt_unref(dropped);
+	}
+
+	k_sem_give(&fq->pending);
+}
+
+static void fq_codel_tx_handler(struct fq_codel *fq)
+{
+	sys_slist_t dropped;
+	struct net_pkt *pkt;
+	sys_snode_t *node;
+
+	while (1) {
+		k_sem_take(&fq->pending, K_FOREVER);
+
+		sys_slist_init(&dropped);
+
+		pkt = fq_codel_dequeue(fq, &dropped);
+
+		while ((node = sys_slist_get(&dropped)) != NULL) {
+			struct net_pkt *drop = FQ_CODEL_NODE_PKT(node);
+
+			NET_DBG("CoDel dropping pkt %p", drop);
+
+			net_stats_update_fq_codel_drop(net_pkt_iface(drop));
+			net_pkt_unref(drop);
+		}
+
+		/* Packets dropped by CoDel leave extra counts in the
+		 * semaphore, so the queue can be empty here.
+		 */
+		if (pkt == NULL) {
+			continue;
+		}
+
+		net_process_tx_packet(pkt);
+	}
+}
+#endif /* CONFIG_NET_TC_TX_FQ_CODEL */
 
 #if defined(CONFIG_NET_TC_THREAD_COOPERATIVE)
 #define BASE_PRIO_TX (CONFIG_NET_TC_NUM_PRIORITIES - 1)
@@ -119,7 +644,12 @@ int net_rx_priority2tc(enum net_priority prio)
 #define BASE_PRIO_RX (CONFIG_NET_TC_RX_COUNT - 1)
 #endif
 
+#if defined(CONFIG_NET_TC_RX_FLOW_HASH)
+/* All the flow queues are equal so they share the same thread priority */
+#define PRIO_RX(i, _) (BASE_PRIO_RX)
+#else
 #define PRIO_RX(i, _) (BASE_PRIO_RX - i)
+#endif
 
 #if NET_TC_TX_COUNT > 0
 /* Convert traffic class to thread priority */
@@ -203,7 +733,7 @@ static void tc_tx_stats_priority_setup(struct net_if *iface)
 }
 #endif
 
-#if NET_TC_RX_COUNT > 0
+#if NET_TC_RX_COUNT > 0 && !defined(CONFIG_NET_TC_RX_FLOW_HASH)
 static void tc_rx_stats_priority_setup(struct net_if *iface)
 {
 	int i;
@@ -225,7 +755,7 @@ static void net_tc_tx_stats_priority_setup(struct net_if *iface,
 }
 #endif
 
-#if NET_TC_RX_COUNT > 0
+#if NET_TC_RX_COUNT > 0 && !defined(CONFIG_NET_TC_RX_FLOW_HASH)
 static void net_tc_rx_stats_priority_setup(struct net_if *iface,
 					   void *user_data)
 {
@@ -252,7 +782,7 @@ static void tc_rx_handler(struct k_fifo *fifo)
 }
 #endif
 
-#if NET_TC_TX_COUNT > 0
+#if NET_TC_TX_COUNT > 0 && !defined(CONFIG_NET_TC_TX_FQ_CODEL)
 static void tc_tx_handler(struct k_fifo *fifo)
 {
 	struct net_pkt *pkt;
@@ -286,8 +816,10 @@ void net_tc_tx_init(void)
 #endif
 
 	for (i = 0; i < NET_TC_TX_COUNT; i++) {
+		k_thread_entry_t entry;
 		uint8_t thread_priority;
 		int priority;
+		void *arg;
 		k_tid_t tid;
 
 		thread_priority = tx_tc2thread(i);
@@ -307,10 +839,21 @@ void net_tc_tx_init(void)
 
 		k_fifo_init(&tx_classes[i].fifo);
 
+#if defined(CONFIG_NET_TC_TX_FQ_CODEL)
+		sys_slist_init(&tx_fq_codel[i].new_flows);
+		sys_slist_init(&tx_fq_codel[i].old_flows);
+		k_sem_init(&tx_fq_codel[i].pending, 0, K_SEM_MAX_LIMIT);
+
+		entry = (k_thread_entry_t)fq_codel_tx_handler;
+		arg = &tx_fq_codel[i];
+#else
+		entry = (k_thread_entry_t)tc_tx_handler;
+		arg = &tx_classes[i].fifo;
+#endif
+
 		tid = k_thread_create(&tx_classes[i].handler, tx_stack[i],
 				      K_KERNEL_STACK_SIZEOF(tx_stack[i]),
-				      (k_thread_entry_t)tc_tx_handler,
-				      &tx_classes[i].fifo, NULL, NULL,
+				      entry, arg, NULL, NULL,
 				      priority, 0, K_FOREVER);
 		if (!tid) {
 			NET_ERR("Cannot create TC handler thread %d", i);
@@ -339,7 +882,7 @@ void net_tc_rx_init(void)
 
 	BUILD_ASSERT(NET_TC_RX_COUNT >= 0);
 
-#if defined(CONFIG_NET_STATISTICS)
+#if defined(CONFIG_NET_STATISTICS) && !defined(CONFIG_NET_TC_RX_FLOW_HASH)
 	net_if_foreach(net_tc_rx_stats_priority_setup, NULL);
 #endif
 
@@ -382,6 +925,13 @@ void net_tc_rx_init(void)
 			k_thread_name_set(tid, name);
 		}
 
+#if defined(CONFIG_NET_TC_RX_FLOW_HASH) && defined(CONFIG_SCHED_CPU_MASK)
+		/* Spread the flow queues over the CPUs so that the flows
+		 * are processed in parallel.
+		 */
+		(void)k_thread_cpu_pin(tid, i % arch_num_cpus());
+#endif
+
 		k_thread_start(tid);
 	}
 #endif
@@ -16,6 +16,7 @@ LOG_MODULE_REGISTER(net_route, CONFIG_NET_ROUTE_LOG_LEVEL);
 #include <limits.h>
 #include <zephyr/types.h>
 #include <zephyr/sys/slist.h>
+#include <zephyr/sys/dlist.h>
 
 #include <zephyr/net/net_pkt.h>
 #include <zephyr/net/net_core.h>
@@ -36,7 +37,7 @@ LOG_MODULE_REGISTER(net_route, CONFIG_NET_ROUTE_LOG_LEVEL);
 /* We keep track of the routes in a separate list so that we can remove
  * the oldest routes (at tail) if needed.
  */
-static sys_slist_t routes;
+static sys_dlist_t routes = SYS_DLIST_STATIC_INIT(&routes);
 
 /* Track currently active route lifetime timers */
 static sys_slist_t active_route_lifetime_timers;
@@ -256,6 +257,237 @@ static int nbr_nexthop_put(struct net_nbr *nbr)
 }
 
 
+#if defined(CONFIG_NET_ROUTE_LPM)
+/* Path compressed binary trie of the route prefixes. A node either holds
+ * the routes having exactly its prefix, or it is a branching node (no
+ * routes) that always has two children. A tree like this can have at
+ * most 2 * CONFIG_NET_MAX_ROUTES - 1 nodes.
+ */
+struct route_lpm_node {
+	struct route_lpm_node *child[2];
+	struct net_route_entry *routes;
+	struct in6_addr prefix;
+	uint8_t prefix_len;
+};
+
+static struct route_lpm_node route_lpm_nodes[2 * CONFIG_NET_MAX_ROUTES];
+static struct route_lpm_node *route_lpm_free;
+static struct route_lpm_node *route_lpm_root;
+
+static inline int route_lpm_bit(const struct in6_addr *addr, uint8_t pos)
+{
+	return (addr->s6_addr[pos / 8] >> (7 - (pos % 8))) & 0x01;
+}
+
+/* Return the number of leading bits (at most max_len) that are equal */
+static uint8_t route_lpm_match_len(const struct in6_addr *a,
+				   const struct in6_addr *b,
+				   uint8_t max_len)
+{
+	uint8_t len;
+	int i;
+
+	for (i = 0, len = 0U; len < max_len; i++, len += 8U) {
+		uint8_t diff = a->s6_addr[i] ^ b->s6_addr[i];
+
+		if (diff) {
+			len += __builtin_clz(diff) - 24;
+			break;
+		}
+	}
+
+	return MIN(len, max_len);
+}
+
+static struct route_lpm_node *route_lpm_node_alloc(const struct in6_addr *prefix,
+						   uint8_t prefix_len)
+{
+	struct route_lpm_node *node = route_lpm_free;
+
+	if (!node) {
+		return NULL;
+	}
+
+	route_lpm_free = node->child[0];
+
+	(void)memset(node, 0, sizeof(*node));
+	net_ipaddr_copy(&node->prefix, prefix);
+	node->prefix_len = prefix_len;
+
+	return node;
+}
+
+static void route_lpm_node_free(struct route_lpm_node *node)
+{
+	node->child[0] = route_lpm_free;
+	route_lpm_free = node;
+}
+
+static void route_lpm_init(void)
+{
+	int i;
+
+	route_lpm_root = NULL;
+	route_lpm_free = NULL;
+
+	for (i = 0; i < ARRAY_SIZE(route_lpm_nodes); i++) {
+		route_lpm_node_free(&route_lpm_nodes[i]);
+	}
+}
+
+static int route_lpm_insert(struct net_route_entry *route)
+{
+	struct route_lpm_node **link = &route_lpm_root;
+	uint8_t len = route->prefix_len;
+	struct route_lpm_node *node, *leaf, *branch;
+	uint8_t match = 0U;
+
+	while ((node = *link) != NULL) {
+		match = route_lpm_match_len(&route->addr, &node->prefix,
+					    MIN(len, node->prefix_len));
+		if (match < node->prefix_len) {
+			break;
+		}
+
+		if (len == node->prefix_len) {
+			route->lpm_next = node->routes;
+			node->routes = route;
+			return 0;
+		}
+
+		link = &node->child[route_lpm_bit(&route->addr,
+						  node->prefix_len)];
+	}
+
+	/* The node pool is sized for the worst case, so running out of
+	 * nodes means that the trie is corrupted.
+	 */
+	leaf = route_lpm_node_alloc(&route->addr, len);
+	if (!leaf) {
+		NET_ERR("Out of route trie nodes");
+		return -ENOMEM;
+	}
+
+	route->lpm_next = NULL;
+	leaf->routes = route;
+
+	if (node == NULL) {
+		*link = leaf;
+		return 0;
+	}
+
+	/* The new prefix covers the existing node, place it above */
+	if (match == len) {
+		leaf->child[route_lpm_bit(&node->prefix, len)] = node;
+		*link = leaf;
+		return 0;
+	}
+
+	/* The prefixes diverge, join them with a branching node */
+	branch = route_lpm_node_alloc(&route->addr, match);
+	if (!branch) {
+		NET_ERR("Out of route trie nodes");
+		route_lpm_node_free(leaf);
+		return -ENOMEM;
+	}
+
+	branch->child[route_lpm_bit(&route->addr, match)] = leaf;
+	branch->child[route_lpm_bit(&node->prefix, match)] = node;
+	*link = branch;
+
+	return 0;
+}
+
+static void route_lpm_remove(struct net_route_entry *route)
+{
+	struct route_lpm_node **link = &route_lpm_root;
+	struct route_lpm_node **parent_link = NULL;
+	struct route_lpm_node *node, *parent;
+	struct net_route_entry **prev;
+	uint8_t len = route->prefix_len;
+
+	while ((node = *link) != NULL) {
+		if (node->prefix_len > len ||
+		    route_lpm_match_len(&route->addr, &node->prefix,
+					node->prefix_len) < node->prefix_len) {
+			return;
+		}
+
+		if (node->prefix_len == len) {
+			break;
+		}
+
+		parent_link = link;
+		link = &node->child[route_lpm_bit(&route->addr,
+						  node->prefix_len)];
+	}
+
+	if (node == NULL) {
+		return;
+	}
+
+	for (prev = &node->routes; *prev; prev = &(*prev)->lpm_next) {
+		if (*prev == route) {
+			*prev = route->lpm_next;
+			break;
+		}
+	}
+
+	if (node->routes || (node->child[0] && node->child[1])) {
+		return;
+	}
+
+	*link = node->child[0] ? node->child[0] : node->child[1];
+	route_lpm_node_free(node);
+
+	/* A branching node must not be left with a single child */
+	if (parent_link) {
+		parent = *parent_link;
+
+		if (!parent->routes && !(parent->child[0] && parent->child[1])) {
+			*parent_link = parent->child[0] ? parent->child[0] :
+							  parent->child[1];
+			route_lpm_node_free(parent);
+		}
+	}
+}
+
+static struct net_route_entry *route_lpm_lookup(struct net_if *iface,
+						struct in6_addr *dst)
+{
+	struct route_lpm_node *node = route_lpm_root;
+	struct net_route_entry *found = NULL;
+	struct net_route_entry *route;
+
+	while (node) {
+		if (route_lpm_match_len(dst, &node->prefix,
+					node->prefix_len) < node->prefix_len) {
+			break;
+		}
+
+		for (route = node->routes; route; route = route->lpm_next) {
+			if (!iface || route->iface == iface) {
+				found = route;
+				break;
+			}
+		}
+
+		if (node->prefix_len == 128U) {
+			break;
+		}
+
+		node = node->child[route_lpm_bit(dst, node->prefix_len)];
+	}
+
+	return found;
+}
+#else
+#define route_lpm_init()
+#define route_lpm_insert(route) 0
+#define route_lpm_remove(route)
+#define route_lpm_lookup(iface, dst) NULL
+#endif /* CONFIG_NET_ROUTE_LPM */
+
 #define net_route_info(str, route, dst)					\
 	do {								\
 	if (CONFIG_NET_ROUTE_LOG_LEVEL >= LOG_LEVEL_DBG) {		\
@@ -272,8 +504,8 @@ static int nbr_nexthop_put(struct net_nbr *nbr)
 /* Route was accessed, so place it in front of the routes list */
 static inline void update_route_access(struct net_route_entry *route)
 {
-	sys_slist_find_and_remove(&routes, &route->node);
-	sys_slist_prepend(&routes, &route->node);
+	sys_dlist_remove(&route->node);
+	sys_dlist_prepend(&routes, &route->node);
 }
 
 struct net_route_entry *net_route_lookup(struct net_if *iface,
@@ -285,6 +517,11 @@ struct net_route_entry *net_route_lookup(struct net_if *iface,
 
 	k_mutex_lock(&lock, K_FOREVER);
 
+	if (IS_ENABLED(CONFIG_NET_ROUTE_LPM)) {
+		found = route_lpm_lookup(iface, dst);
+		goto out;
+	}
+
 	for (i = 0; i < CONFIG_NET_MAX_ROUTES && longest_match < 128; i++) {
 		struct net_nbr *nbr = get_nbr(i);
 
@@ -307,6 +544,7 @@ struct net_route_entry *net_route_lookup(struct net_if *iface,
 		}
 	}
 
+out:
 	if (found) {
 		net_route_info("Found", found, dst);
 
@@ -402,9 +640,9 @@ struct net_route_entry *net_route_add(struct net_if *iface,
 	nbr = nbr_new(iface, addr, prefix_len);
 	if (!nbr) {
 		/* Remove the oldest route and try again */
-		sys_snode_t *last = sys_slist_peek_tail(&routes);
+		sys_dnode_t *last = sys_dlist_peek_tail(&routes);
 
-		sys_slist_find_and_remove(&routes, last);
+		sys_dlist_remove(last);
 
 		route = CONTAINER_OF(last,
 				     struct net_route_entry,
@@ -451,9 +689,16 @@ struct net_route_entry *net_route_add(struct net_if *iface,
 	route->iface = iface;
 	route->preference = preference;
 
+	if (route_lpm_insert(route) < 0) {
+		release_nexthop_route(nexthop_route);
+		nbr_free(nbr);
+		route = NULL;
+		goto exit;
+	}
+
 	net_route_update_lifetime(route, lifetime);
 
-	sys_slist_prepend(&routes, &route->node);
+	sys_dlist_prepend(&routes, &route->node);
 
 	tmp = nbr_nexthop_get(iface, nexthop);
 
@@ -595,7 +840,14 @@ int net_route_del(struct net_route_entry *route)
 		}
 	}
 
-	sys_slist_find_and_remove(&routes, &route->node);
+	if (sys_dnode_is_linked(&route->node)) {
+		sys_dlist_remove(&route->node);
+	}
+
+	/* Remove the route from the trie even if its neighbor is already
+	 * gone, so that the lookup never returns a stale entry.
+	 */
+	route_lpm_remove(route);
 
 	nbr = net_route_get_nbr(route);
 	if (!nbr) {
@@ -1101,4 +1353,6 @@ void net_route_init(void)
 		CONFIG_NET_MAX_NEXTHOPS, sizeof(net_route_nexthop_pool));
 
 	k_work_init_delayable(&route_lifetime_timer, route_lifetime_timeout);
+
+	route_lpm_init();
 }
@@ -75,6 +75,7 @@ static K_KERNEL_STACK_DEFINE(work_q_stack, CONFIG_NET_TCP_WORKQ_STACK_SIZE);
 static enum net_verdict tcp_in(struct tcp *conn, struct net_pkt *pkt);
 static bool is_destination_local(struct net_pkt *pkt);
 static void tcp_out(struct tcp *conn, uint8_t flags);
+static int tcp_pkt_pull(struct net_pkt *pkt, size_t len);
 static const char *tcp_state_to_str(enum tcp_state state, bool prefix);
 
 int (*tcp_send_cb)(struct net_pkt *pkt) = NULL;
@@ -455,6 +456,15 @@ static int tcp_conn_unref(struct tcp *conn)
 	tcp_send_queue_flush(conn);
 
 	k_work_cancel_delayable(&conn->send_data_timer);
+
+	if (IS_ENABLED(CONFIG_NET_CONTEXT_ZEROCOPY_TX)) {
+		/* Segments in flight may still refer to the queued data,
+		 * release all of it under the lock before freeing the packet.
+		 */
+		(void)tcp_pkt_pull(conn->send_data,
+				   net_pkt_get_len(conn->send_data));
+	}
+
 	tcp_pkt_unref(conn->send_data);
 
 	if (CONFIG_NET_TCP_RECV_QUEUE_TIMEOUT) {
@@ -1105,6 +1115,110 @@ static void tcp_out(struct tcp *conn, uint8_t flags)
 	(void)tcp_out_ext(conn, flags, NULL /* no data */, conn->seq);
 }
 
+#if defined(CONFIG_NET_CONTEXT_ZEROCOPY_TX)
+/* Segments refer to the zero-copy data in send_data with reference
+ * buffers, each of them holding a reference to a send_data fragment.
+ * As the fragments are released both from the TCP and the TX threads,
+ * their reference count is protected by a spinlock.
+ */
+static struct k_spinlock tcp_tx_ref_lock;
+
+static void tcp_tx_buf_ref(struct net_buf *buf)
+{
+	k_spinlock_key_t key = k_spin_lock(&tcp_tx_ref_lock);
+
+	net_buf_ref(buf);
+
+	k_spin_unlock(&tcp_tx_ref_lock, key);
+}
+
+static void tcp_tx_buf_unref(struct net_buf *buf)
+{
+	k_spinlock_key_t key = k_spin_lock(&tcp_tx_ref_lock);
+
+	if (buf->ref > 1) {
+		buf->ref--;
+		k_spin_unlock(&tcp_tx_ref_lock, key);
+		return;
+	}
+
+	k_spin_unlock(&tcp_tx_ref_lock, key);
+
+	/* This was the last reference, nobody else can access the buffer */
+	net_buf_unref(buf);
+}
+
+static void tcp_tx_ref_destroy(struct net_buf *buf)
+{
+	struct net_buf *frag = *(struct net_buf **)net_buf_user_data(buf);
+
+	net_buf_destroy(buf);
+	tcp_tx_buf_unref(frag);
+}
+
+NET_BUF_POOL_DEFINE(tcp_tx_ref_pool, CONFIG_NET_CONTEXT_ZEROCOPY_TX_REF_COUNT,
+		    0, sizeof(struct net_buf *), tcp_tx_ref_destroy);
+
+/* Same as net_pkt_trim_buffer() for the fragments of send_data, which may
+ * be referenced by segments being transmitted.
+ */
+static void tcp_pkt_trim_buffer(struct net_pkt *pkt)
+{
+	struct net_buf *prev = NULL;
+	struct net_buf *buf = pkt->buffer;
+
+	while (buf) {
+		struct net_buf *next = buf->frags;
+
+		if (!buf->len) {
+			if (prev) {
+				prev->frags = next;
+			} else {
+				pkt->buffer = next;
+			}
+
+			buf->frags = NULL;
+			tcp_tx_buf_unref(buf);
+		} else {
+			prev = buf;
+		}
+
+		buf = next;
+	}
+}
+
+static int tcp_pkt_pull(struct net_pkt *pkt, size_t len)
+{
+	int total = net_pkt_get_len(pkt);
+
+	if (len > total) {
+		return -EINVAL;
+	}
+
+	/* The data may be referenced by segments that are not transmitted
+	 * yet, so it cannot be moved. Drop the acknowledged fragments and
+	 * skip the acknowledged part of the first remaining one instead.
+	 */
+	while (len > 0) {
+		struct net_buf *buf = pkt->buffer;
+
+		if (len < buf->len) {
+			net_buf_pull(buf, len);
+			break;
+		}
+
+		len -= buf->len;
+		pkt->buffer = buf->frags;
+		buf->frags = NULL;
+		tcp_tx_buf_unref(buf);
+	}
+
+	tcp_pkt_trim_buffer(pkt);
+	net_pkt_cursor_init(pkt);
+
+	return 0;
+}
+#else
 static int tcp_pkt_pull(struct net_pkt *pkt, size_t len)
 {
 	int total = net_pkt_get_len(pkt);
@@ -1122,6 +1236,7 @@ static int tcp_pkt_pull(struct net_pkt *pkt, size_t len)
  out:
 	return ret;
 }
+#endif /* CONFIG_NET_CONTEXT_ZEROCOPY_TX */
 
 static int tcp_pkt_peek(struct net_pkt *to, struct net_pkt *from, size_t pos,
 			size_t len)
@@ -1137,6 +1252,106 @@ static int tcp_pkt_peek(struct net_pkt *to, struct net_pkt *from, size_t pos,
 	return net_pkt_copy(to, from, len);
 }
 
+#if defined(CONFIG_NET_CONTEXT_ZEROCOPY_TX)
+/* Find the fragment holding the data at pos, pos is updated to the offset
+ * of the data in that fragment.
+ */
+static struct net_buf *tcp_pkt_frag_at(struct net_pkt *pkt, size_t *pos)
+{
+	struct net_buf *buf = pkt->buffer;
+
+	while (buf && *pos >= buf->len) {
+		*pos -= buf->len;
+		buf = buf->frags;
+	}
+
+	return buf;
+}
+
+/* Data can be sent by reference only if all of it is in zero-copy
+ * fragments, other data is always copied.
+ */
+static bool tcp_pkt_is_zerocopy(struct net_pkt *pkt, size_t pos, size_t len)
+{
+	struct net_buf *frag = tcp_pkt_frag_at(pkt, &pos);
+
+	for (; frag && len > 0; frag = frag->frags) {
+		if (frag->len > 0 && !(frag->flags & NET_BUF_EXTERNAL_DATA)) {
+			return false;
+		}
+
+		len -= MIN(frag->len - pos, len);
+		pos = 0;
+	}
+
+	return len == 0;
+}
+
+/* Attach the data at pos to the segment by reference, the data must be
+ * zero-copy, see tcp_pkt_is_zerocopy().
+ */
+static int tcp_pkt_peek_ref(struct net_pkt *to, struct net_pkt *from,
+			    size_t pos, size_t len)
+{
+	struct net_buf *buf = tcp_pkt_frag_at(from, &pos);
+
+	while (len > 0) {
+		size_t frag_len = MIN(buf->len - pos, len);
+		struct net_buf *ref;
+
+		if (frag_len > 0) {
+			ref = net_buf_alloc_with_data(&tcp_tx_ref_pool,
+						      buf->data + pos,
+						      frag_len, K_NO_WAIT);
+			if (!ref) {
+				return -ENOBUFS;
+			}
+
+			tcp_tx_buf_ref(buf);
+			*(struct net_buf **)net_buf_user_data(ref) = buf;
+
+			net_pkt_append_buffer(to, ref);
+		}
+
+		len -= frag_len;
+		pos = 0;
+		buf = buf->frags;
+	}
+
+	return 0;
+}
+
+static struct net_pkt *tcp_pkt_ref_data(struct tcp *conn, size_t len)
+{
+	struct net_pkt *pkt;
+
+	if (!tcp_pkt_is_zerocopy(conn->send_data, conn->unacked_len, len)) {
+		return NULL;
+	}
+
+	pkt = tcp_pkt_alloc(conn, 0);
+	if (!pkt) {
+		return NULL;
+	}
+
+	if (tcp_pkt_peek_ref(pkt, conn->send_data, conn->unacked_len,
+			     len) < 0) {
+		tcp_pkt_unref(pkt);
+		return NULL;
+	}
+
+	return pkt;
+}
+#else
+static inline struct net_pkt *tcp_pkt_ref_data(struct tcp *conn, size_t len)
+{
+	ARG_UNUSED(conn);
+	ARG_UNUSED(len);
+
+	return NULL;
+}
+#endif /* CONFIG_NET_CONTEXT_ZEROCOPY_TX */
+
 static bool tcp_window_full(struct tcp *conn)
 {
 	bool window_full = (conn->send_data_total >= conn->send_win);
@@ -1169,33 +1384,53 @@ static int tcp_unsent_len(struct tcp *conn)
 	return unsent_len;
 }
 
-static int tcp_send_data(struct tcp *conn)
+/* The optional pkt is a data packet allocated beforehand with room for a
+ * full segment, it is always consumed.
+ */
+static int tcp_send_data(struct tcp *conn, struct net_pkt *pkt)
 {
+	bool copy = true;
 	int ret = 0;
 	int len;
-	struct net_pkt *pkt;
 
 	len = MIN3(conn->send_data_total - conn->unacked_len,
 		   conn->send_win - conn->unacked_len,
 		   conn_mss(conn));
 	if (len == 0) {
 		NET_DBG("conn: %p no data to send", conn);
+		if (pkt) {
+			tcp_pkt_unref(pkt);
+		}
+
 		ret = -ENODATA;
 		goto out;
 	}
 
-	pkt = tcp_pkt_alloc(conn, len);
+	/* Zero-copy data is referenced by the segment, other data is copied */
 	if (!pkt) {
-		NET_ERR("conn: %p packet allocation failed, len=%d", conn, len);
-		ret = -ENOBUFS;
-		goto out;
+		pkt = tcp_pkt_ref_data(conn, len);
+		copy = (pkt == NULL);
 	}
 
-	ret = tcp_pkt_peek(pkt, conn->send_data, conn->unacked_len, len);
-	if (ret < 0) {
-		tcp_pkt_unref(pkt);
-		ret = -ENOBUFS;
-		goto out;
+	if (copy) {
+		if (!pkt) {
+			pkt = tcp_pkt_alloc(conn, len);
+		}
+
+		if (!pkt) {
+			NET_ERR("conn: %p packet allocation failed, len=%d",
+				conn, len);
+			ret = -ENOBUFS;
+			goto out;
+		}
+
+		ret = tcp_pkt_peek(pkt, conn->send_data, conn->unacked_len,
+				   len);
+		if (ret < 0) {
+			tcp_pkt_unref(pkt);
+			ret = -ENOBUFS;
+			goto out;
+		}
 	}
 
 	ret = tcp_out_ext(conn, PSH | ACK, pkt, conn->seq + conn->unacked_len);
@@ -1223,10 +1458,45 @@ static int tcp_send_data(struct tcp *conn)
 	return ret;
 }
 
+#if defined(CONFIG_NET_TCP_TX_BULK_COUNT)
+#define TCP_TX_BULK_COUNT CONFIG_NET_TCP_TX_BULK_COUNT
+#else
+#define TCP_TX_BULK_COUNT 1
+#endif
+
+/* Allocate the packets of the full sized segments that can be sent right
+ * away in one go.
+ */
+static int tcp_alloc_segments(struct tcp *conn, struct net_pkt **pkts)
+{
+	size_t sizes[TCP_TX_BULK_COUNT];
+	int mss = conn_mss(conn);
+	int count;
+	int i;
+
+	if (TCP_TX_BULK_COUNT < 2) {
+		return 0;
+	}
+
+	count = MIN(tcp_unsent_len(conn) / mss, TCP_TX_BULK_COUNT);
+	if (count < 2) {
+		return 0;
+	}
+
+	for (i = 0; i < count; i++) {
+		sizes[i] = mss;
+	}
+
+	return tcp_pkt_alloc_bulk(conn, pkts, sizes, count);
+}
+
 /* Send all queued but unsent data from the send_data packet by packet
  * until the receiver's window is full. */
 static int tcp_send_queued_data(struct tcp *conn)
 {
+	struct net_pkt *pkts[TCP_TX_BULK_COUNT];
+	int allocated = 0;
+	int next = 0;
 	int ret = 0;
 	bool subscribe = false;
 
@@ -1248,12 +1518,22 @@ static int tcp_send_queued_data(struct tcp *conn)
 			}
 		}
 
-		ret = tcp_send_data(conn);
+		if (next == allocated) {
+			allocated = tcp_alloc_segments(conn, pkts);
+			next = 0;
+		}
+
+		ret = tcp_send_data(conn, next < allocated ? pkts[next++] : NULL);
 		if (ret < 0) {
 			break;
 		}
 	}
 
+	/* The window or the data did not allow using all the segments */
+	while (next < allocated) {
+		tcp_pkt_unref(pkts[next++]);
+	}
+
 	if (conn->send_data_total) {
 		subscribe = true;
 	}
@@ -1309,7 +1589,7 @@ static void tcp_resend_data(struct k_work *work)
 	conn->data_mode = TCP_DATA_MODE_RESEND;
 	conn->unacked_len = 0;
 
-	ret = tcp_send_data(conn);
+	ret = tcp_send_data(conn, NULL);
 	conn->send_data_retries++;
 	if (ret == 0) {
 		if (conn->in_close && conn->send_data_total == 0) {
@@ -2336,7 +2616,7 @@ next_state:
 
 				conn->unacked_len = 0;
 
-				(void)tcp_send_data(conn);
+				(void)tcp_send_data(conn, NULL);
 
 				/* Restore the current transmission */
 				conn->unacked_len = temp_unacked_len;
@@ -3144,6 +3424,7 @@ struct net_tcp_hdr *net_tcp_input(struct net_pkt *pkt,
 
 	if (IS_ENABLED(CONFIG_NET_TCP_CHECKSUM) &&
 	    net_if_need_calc_rx_checksum(net_pkt_iface(pkt)) &&
+	    !net_pkt_is_chksum_valid(pkt) &&
 	    net_calc_chksum_tcp(pkt) != 0U) {
 		NET_DBG("DROP: checksum mismatch");
 		goto drop;
@@ -78,6 +78,25 @@
 	_pkt;								\
 })
 
+#define tcp_pkt_alloc_bulk(_conn, _pkts, _sizes, _count)		\
+({									\
+	int _n = net_pkt_alloc_bulk_with_buffer(			\
+			(_conn)->iface,					\
+			(_pkts),					\
+			(_sizes),					\
+			(_count),					\
+			net_context_get_family((_conn)->context),	\
+			IPPROTO_TCP,					\
+			TCP_PKT_ALLOC_TIMEOUT);				\
+									\
+	for (int _i = 0; _i < _n; _i++) {				\
+		tp_pkt_alloc((_pkts)[_i], tp_basename(__FILE__),	\
+			     __LINE__);					\
+	}								\
+									\
+	_n;								\
+})
+
 #define tcp_rx_pkt_alloc(_conn, _len)					\
 ({									\
 	struct net_pkt *_pkt;						\
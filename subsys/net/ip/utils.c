@@ -26,6 +26,8 @@ LOG_MODULE_REGISTER(net_utils, CONFIG_NET_UTILS_LOG_LEVEL);
 #include <zephyr/net/net_core.h>
 #include <zephyr/net/socketcan.h>
 
+#include "net_private.h"
+
 char *net_sprint_addr(sa_family_t af, const void *addr)
 {
 #define NBUFS 3
@@ -540,6 +542,51 @@ uint16_t calc_chksum(uint16_t sum_in, const uint8_t *data, size_t len)
 		sum = sum + *((uint16_t *)data);
 		data += sizeof(uint16_t);
 	}
+
+#if defined(CONFIG_64BIT)
+	/* On 64-bit targets sum native words, the carry out of the 64-bit
+	 * accumulator is added back right away (end around carry).
+	 */
+	if ((((uintptr_t)data & 0x04) != 0) && (pending >= sizeof(uint32_t))) {
+		pending -= sizeof(uint32_t);
+		sum = sum + *((uint32_t *)data);
+		data += sizeof(uint32_t);
+	}
+
+	while (pending >= sizeof(uint64_t) * 4) {
+		const uint64_t *p64 = (const uint64_t *)data;
+		uint64_t sum_a = p64[0];
+		uint64_t sum_b = p64[2];
+
+		sum_a += p64[1];
+		sum_a += (sum_a < p64[1]);
+		sum_b += p64[3];
+		sum_b += (sum_b < p64[3]);
+		sum_a += sum_b;
+		sum_a += (sum_a < sum_b);
+		sum += sum_a;
+		sum += (sum < sum_a);
+
+		pending -= sizeof(uint64_t) * 4;
+		data += sizeof(uint64_t) * 4;
+	}
+	while (pending >= sizeof(uint64_t)) {
+		uint64_t word = *((const uint64_t *)data);
+
+		sum += word;
+		sum += (sum < word);
+
+		pending -= sizeof(uint64_t);
+		data += sizeof(uint64_t);
+	}
+#endif /* CONFIG_64BIT */
+
+	/* The sum may be close to 2^64 here, fold it so that the 32-bit
+	 * loops below cannot overflow it.
+	 */
+	sum = (sum & 0xffffffff) + (sum >> 32);
+	sum = (sum & 0xffffffff) + (sum >> 32);
+
 	p = (uint32_t *)data;
 
 	/* Do loop unrolling for the very large data sets */
@@ -582,6 +629,55 @@ uint16_t calc_chksum(uint16_t sum_in, const uint8_t *data, size_t len)
 	}
 }
 
+/* Copy len bytes from src to dst and return the checksum of the copied
+ * data in the same format as calc_chksum(). The data is summed as native
+ * endian words while it is being moved and the byte order is fixed only
+ * once, after the sum has been folded.
+ */
+uint16_t calc_chksum_copy(uint16_t sum_in, uint8_t *dst, const uint8_t *src,
+			  size_t len)
+{
+	uint64_t sum = 0U;
+
+	while (len >= sizeof(uint64_t) * 2) {
+		uint64_t word_a = UNALIGNED_GET((const uint64_t *)src);
+		uint64_t word_b = UNALIGNED_GET((const uint64_t *)(src + 8));
+
+		UNALIGNED_PUT(word_a, (uint64_t *)dst);
+		UNALIGNED_PUT(word_b, (uint64_t *)(dst + 8));
+
+		sum += (word_a & 0xffffffff) + (word_a >> 32);
+		sum += (word_b & 0xffffffff) + (word_b >> 32);
+
+		src += sizeof(uint64_t) * 2;
+		dst += sizeof(uint64_t) * 2;
+		len -= sizeof(uint64_t) * 2;
+	}
+	while (len >= sizeof(uint16_t)) {
+		uint16_t word = UNALIGNED_GET((const uint16_t *)src);
+
+		UNALIGNED_PUT(word, (uint16_t *)dst);
+		sum += word;
+
+		src += sizeof(uint16_t);
+		dst += sizeof(uint16_t);
+		len -= sizeof(uint16_t);
+	}
+	if (len == 1) {
+		uint8_t last[2] = { *src, 0U };
+
+		*dst = *src;
+		sum += UNALIGNED_GET((const uint16_t *)last);
+	}
+
+	/* Fold sum into 16-bit word. */
+	while (sum >> 16) {
+		sum = (sum & 0xffff) + (sum >> 16);
+	}
+
+	return calc_chksum_add(sum_in, ntohs((uint16_t)sum));
+}
+
 static inline uint16_t pkt_calc_chksum(struct net_pkt *pkt, uint16_t sum)
 {
 	struct net_pkt_cursor *cur = &pkt->cursor;
@@ -657,7 +753,22 @@ uint16_t net_calc_chksum(struct net_pkt *pkt, uint8_t proto)
 	sum = calc_chksum(sum, pkt->cursor.pos, len);
 	net_pkt_skip(pkt, len + net_pkt_ip_opts_len(pkt));
 
-	sum = pkt_calc_chksum(pkt, sum);
+	if (proto == IPPROTO_UDP && net_pkt_is_udp_payload_chksum_valid(pkt)) {
+		struct net_udp_hdr hdr;
+
+		/* The payload was summed while it was copied into the
+		 * packet, only the UDP header is left to be added.
+		 */
+		if (net_pkt_read(pkt, &hdr, sizeof(hdr)) == 0) {
+			sum = calc_chksum(sum, (uint8_t *)&hdr, sizeof(hdr));
+			sum = calc_chksum_add(sum,
+					      net_pkt_udp_payload_chksum(pkt));
+		} else {
+			sum = pkt_calc_chksum(pkt, sum);
+		}
+	} else {
+		sum = pkt_calc_chksum(pkt, sum);
+	}
 
 	sum = (sum == 0U) ? 0xffff : htons(sum);
 
@@ -0,0 +1,448 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(net_capture, CONFIG_NET_CAPTURE_LOG_LEVEL);
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/sys/mpsc_pbuf.h>
+#include <zephyr/net/net_core.h>
+#include <zephyr/net/net_if.h>
+#include <zephyr/net/net_l2.h>
+#include <zephyr/net/net_pkt.h>
+#include <zephyr/net/net_pkt_filter.h>
+#include <zephyr/net/capture.h>
+
+#if defined(CONFIG_NET_CAPTURE_RING_FILE)
+#include <zephyr/fs/fs.h>
+#endif
+
+/* pcapng block types, see draft-ietf-opsawg-pcapng */
+#define PCAPNG_SHB_TYPE 0x0A0D0D0A
+#define PCAPNG_IDB_TYPE 0x00000001
+#define PCAPNG_EPB_TYPE 0x00000006
+#define PCAPNG_BYTE_ORDER_MAGIC 0x1A2B3C4D
+
+#define LINKTYPE_ETHERNET 1
+#define LINKTYPE_RAW 101
+#define LINKTYPE_IEEE802_15_4_NOFCS 230
+
+#define RING_WLEN (CONFIG_NET_CAPTURE_RING_SIZE / sizeof(uint32_t))
+
+struct pcapng_shb {
+	uint32_t block_type;
+	uint32_t block_total_length;
+	uint32_t byte_order_magic;
+	uint16_t major_version;
+	uint16_t minor_version;
+	int64_t section_length;
+	uint32_t block_total_length2;
+} __packed;
+
+struct pcapng_idb {
+	uint32_t block_type;
+	uint32_t block_total_length;
+	uint16_t link_type;
+	uint16_t reserved;
+	uint32_t snap_len;
+	uint32_t block_total_length2;
+} __packed;
+
+struct pcapng_epb {
+	uint32_t block_type;
+	uint32_t block_total_length;
+	uint32_t interface_id;
+	uint32_t timestamp_high;
+	uint32_t timestamp_low;
+	uint32_t captured_len;
+	uint32_t original_len;
+};
+
+/* Ring entry, the packet data and the block trailer follow the EPB header
+ * so that the whole block can be handed out as is when draining the ring.
+ */
+struct capture_record {
+	MPSC_PBUF_HDR;
+	uint32_t wlen : 32 - MPSC_PBUF_HDR_BITS;
+	struct pcapng_epb epb;
+};
+
+#define RECORD_WLEN(caplen) \
+	(sizeof(struct capture_record) / sizeof(uint32_t) + \
+	 DIV_ROUND_UP(caplen, sizeof(uint32_t)) + 1)
+
+BUILD_ASSERT(RECORD_WLEN(CONFIG_NET_CAPTURE_RING_SNAPLEN) < RING_WLEN,
+	     "Capture ring cannot hold a single packet");
+
+static struct net_capture_ring {
+	struct mpsc_pbuf_buffer buf;
+
+	/** Interface being captured, NULL if the capture is disabled */
+	atomic_ptr_t iface;
+
+	/** Rule list selecting the packets to capture */
+	struct npf_rule_list *filter;
+
+	atomic_t captured;
+	atomic_t filtered;
+	atomic_t dropped;
+	atomic_t truncated;
+
+	/** The section and interface blocks must be drained first */
+	atomic_t header_pending;
+
+	uint16_t link_type;
+	bool init_done;
+
+#if defined(CONFIG_NET_CAPTURE_RING_FILE)
+	struct fs_file_t file;
+	struct k_work_delayable file_work;
+	int file_error;
+	bool file_open;
+#endif
+} ring;
+
+/* Serializes the readers of the ring */
+static K_MUTEX_DEFINE(lock);
+
+static uint32_t ring_data[RING_WLEN];
+
+static uint32_t record_get_wlen(const union mpsc_pbuf_generic *packet)
+{
+	const struct capture_record *rec = (const struct capture_record *)packet;
+
+	return rec->wlen;
+}
+
+static const struct mpsc_pbuf_buffer_config ring_config = {
+	.buf = ring_data,
+	.size = RING_WLEN,
+	.get_wlen = record_get_wlen,
+	.flags = IS_POWER_OF_TWO(RING_WLEN) ? MPSC_PBUF_SIZE_POW2 : 0,
+};
+
+static uint16_t get_link_type(struct net_if *iface)
+{
+#if defined(CONFIG_NET_L2_ETHERNET)
+	if (net_if_l2(iface) == &NET_L2_GET_NAME(ETHERNET)) {
+		return LINKTYPE_ETHERNET;
+	}
+#endif
+#if defined(CONFIG_NET_L2_IEEE802154)
+	if (net_if_l2(iface) == &NET_L2_GET_NAME(IEEE802154)) {
+		return LINKTYPE_IEEE802_15_4_NOFCS;
+	}
+#endif
+
+	ARG_UNUSED(iface);
+
+	return LINKTYPE_RAW;
+}
+
+void net_capture_ring_pkt(struct net_if *iface, struct net_pkt *pkt)
+{
+	struct capture_record *rec;
+	struct npf_rule_list *filter;
+	uint64_t timestamp;
+	size_t caplen, padded;
+	size_t len;
+	uint8_t *data;
+
+	if (atomic_ptr_get(&ring.iface) != iface) {
+		return;
+	}
+
+	filter = ring.filter;
+	if (IS_ENABLED(CONFIG_NET_PKT_FILTER) && filter != NULL &&
+	    !npf_rules_ok(filter, pkt)) {
+		atomic_inc(&ring.filtered);
+		return;
+	}
+
+	len = net_pkt_get_len(pkt);
+	caplen = MIN(len, CONFIG_NET_CAPTURE_RING_SNAPLEN);
+
+	rec = (struct capture_record *)mpsc_pbuf_alloc(&ring.buf, RECORD_WLEN(caplen),
+						       K_NO_WAIT);
+	if (rec == NULL) {
+		NET_DBG("Captured pkt %s", "dropped");
+		atomic_inc(&ring.dropped);
+		return;
+	}
+
+	padded = ROUND_UP(caplen, sizeof(uint32_t));
+	timestamp = k_ticks_to_us_floor64(k_uptime_ticks());
+
+	rec->wlen = RECORD_WLEN(caplen);
+	rec->epb.block_type = PCAPNG_EPB_TYPE;
+	rec->epb.block_total_length = sizeof(struct pcapng_epb) + padded +
+				      sizeof(uint32_t);
+	rec->epb.interface_id = 0U;
+	rec->epb.timestamp_high = (uint32_t)(timestamp >> 32);
+	rec->epb.timestamp_low = (uint32_t)timestamp;
+	rec->epb.captured_len = caplen;
+	rec->epb.original_len = len;
+
+	/* Copy straight from the fragments, the packet cursor is left
+	 * untouched.
+	 */
+	data = (uint8_t *)(&rec->epb + 1);
+	(void)net_buf_linearize(data, caplen, pkt->buffer, 0, caplen);
+	memset(data + caplen, 0, padded - caplen);
+	*(uint32_t *)(data + padded) = rec->epb.block_total_length;
+
+	mpsc_pbuf_commit(&ring.buf, (union mpsc_pbuf_generic *)rec);
+
+	atomic_inc(&ring.captured);
+
+	if (caplen < len) {
+		atomic_inc(&ring.truncated);
+	}
+}
+
+static void discard_records(void)
+{
+	const union mpsc_pbuf_generic *item;
+
+	while ((item = mpsc_pbuf_claim(&ring.buf)) != NULL) {
+		mpsc_pbuf_free(&ring.buf, item);
+	}
+}
+
+int net_capture_ring_enable(struct net_if *iface, struct npf_rule_list *filter)
+{
+	if (iface == NULL) {
+		return -EINVAL;
+	}
+
+	if (!IS_ENABLED(CONFIG_NET_PKT_FILTER) && filter != NULL) {
+		return -ENOTSUP;
+	}
+
+	k_mutex_lock(&lock, K_FOREVER);
+
+	if (atomic_ptr_get(&ring.iface) != NULL) {
+		k_mutex_unlock(&lock);
+		return -EALREADY;
+	}
+
+	if (!ring.init_done) {
+		mpsc_pbuf_init(&ring.buf, &ring_config);
+		ring.init_done = true;
+	} else {
+		discard_records();
+	}
+
+	ring.filter = filter;
+	ring.link_type = get_link_type(iface);
+
+	atomic_clear(&ring.captured);
+	atomic_clear(&ring.filtered);
+	atomic_clear(&ring.dropped);
+	atomic_clear(&ring.truncated);
+	atomic_set(&ring.header_pending, 1);
+
+	atomic_ptr_set(&ring.iface, iface);
+
+	k_mutex_unlock(&lock);
+
+	return 0;
+}
+
+int net_capture_ring_disable(void)
+{
+	if (atomic_ptr_clear(&ring.iface) == NULL) {
+		return -EALREADY;
+	}
+
+	return 0;
+}
+
+static int drain_header(net_capture_ring_write_cb_t cb, void *user_data)
+{
+	struct {
+		struct pcapng_shb shb;
+		struct pcapng_idb idb;
+	} __packed header = {
+		.shb = {
+			.block_type = PCAPNG_SHB_TYPE,
+			.block_total_length = sizeof(struct pcapng_shb),
+			.byte_order_magic = PCAPNG_BYTE_ORDER_MAGIC,
+			.major_version = 1U,
+			.minor_version = 0U,
+			/* Section length not specified */
+			.section_length = -1,
+			.block_total_length2 = sizeof(struct pcapng_shb),
+		},
+		.idb = {
+			.block_type = PCAPNG_IDB_TYPE,
+			.block_total_length = sizeof(struct pcapng_idb),
+			.link_type = ring.link_type,
+			.snap_len = CONFIG_NET_CAPTURE_RING_SNAPLEN,
+			.block_total_length2 = sizeof(struct pcapng_idb),
+		},
+	};
+	int ret;
+
+	ret = cb(&header, sizeof(header), user_data);
+	if (ret < 0) {
+		return ret;
+	}
+
+	return sizeof(header);
+}
+
+int net_capture_ring_drain(net_capture_ring_write_cb_t cb, void *user_data)
+{
+	const union mpsc_pbuf_generic *item;
+	const struct capture_record *rec;
+	int total = 0;
+	int ret = 0;
+
+	if (cb == NULL) {
+		return -EINVAL;
+	}
+
+	k_mutex_lock(&lock, K_FOREVER);
+
+	if (!ring.init_done) {
+		goto out;
+	}
+
+	if (atomic_cas(&ring.header_pending, 1, 0)) {
+		ret = drain_header(cb, user_data);
+		if (ret < 0) {
+			goto out;
+		}
+
+		total += ret;
+	}
+
+	while ((item = mpsc_pbuf_claim(&ring.buf)) != NULL) {
+		rec = (const struct capture_record *)item;
+
+		ret = cb(&rec->epb, rec->epb.block_total_length, user_data);
+		if (ret == 0) {
+			total += rec->epb.block_total_length;
+		}
+
+		mpsc_pbuf_free(&ring.buf, item);
+
+		if (ret < 0) {
+			break;
+		}
+	}
+
+out:
+	k_mutex_unlock(&lock);
+
+	return ret < 0 ? ret : total;
+}
+
+int net_capture_ring_get_stats(struct net_capture_ring_stats *stats)
+{
+	if (stats == NULL) {
+		return -EINVAL;
+	}
+
+	stats->captured = atomic_get(&ring.captured);
+	stats->filtered = atomic_get(&ring.filtered);
+	stats->dropped = atomic_get(&ring.dropped);
+	stats->truncated = atomic_get(&ring.truncated);
+
+	return 0;
+}
+
+#if defined(CONFIG_NET_CAPTURE_RING_FILE)
+static int file_write(const void *data, size_t len, void *user_data)
+{
+	struct fs_file_t *file = user_data;
+	ssize_t ret;
+
+	ret = fs_write(file, data, len);
+	if (ret < 0) {
+		return ret;
+	}
+
+	return (size_t)ret == len ? 0 : -ENOSPC;
+}
+
+static void file_work_handler(struct k_work *work)
+{
+	int ret;
+
+	ARG_UNUSED(work);
+
+	ret = net_capture_ring_drain(file_write, &ring.file);
+	if (ret < 0) {
+		NET_ERR("Cannot write capture file (%d)", ret);
+		ring.file_error = ret;
+		return;
+	}
+
+	k_work_reschedule(&ring.file_work,
+			  K_MSEC(CONFIG_NET_CAPTURE_RING_FILE_INTERVAL));
+}
+
+int net_capture_ring_file_open(const char *path)
+{
+	int ret;
+
+	if (path == NULL) {
+		return -EINVAL;
+	}
+
+	if (ring.file_open) {
+		return -EALREADY;
+	}
+
+	fs_file_t_init(&ring.file);
+
+	ret = fs_open(&ring.file, path, FS_O_CREATE | FS_O_WRITE);
+	if (ret < 0) {
+		NET_ERR("Cannot open capture file %s (%d)", path, ret);
+		return ret;
+	}
+
+	ret = fs_truncate(&ring.file, 0);
+	if (ret < 0) {
+		(void)fs_close(&ring.file);
+		return ret;
+	}
+
+	ring.file_open = true;
+	ring.file_error = 0;
+
+	k_work_init_delayable(&ring.file_work, file_work_handler);
+	k_work_reschedule(&ring.file_work, K_NO_WAIT);
+
+	return 0;
+}
+
+int net_capture_ring_file_close(void)
+{
+	struct k_work_sync sync;
+	int ret;
+
+	if (!ring.file_open) {
+		return -EALREADY;
+	}
+
+	(void)k_work_cancel_delayable_sync(&ring.file_work, &sync);
+
+	ret = ring.file_error;
+	if (ret == 0) {
+		ret = net_capture_ring_drain(file_write, &ring.file);
+	}
+
+	if (fs_close(&ring.file) < 0 && ret >= 0) {
+		ret = -EIO;
+	}
+
+	ring.file_open = false;
+
+	return ret < 0 ? ret : 0;
+}
+#endif /* CONFIG_NET_CAPTURE_RING_FILE */
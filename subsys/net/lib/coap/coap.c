@@ -926,6 +926,25 @@ static bool is_request(const struct coap_packet *cpkt)
 	return !(code & ~COAP_REQUEST_MASK);
 }
 
+static int call_method(struct coap_resource *resource,
+		       struct coap_packet *cpkt,
+		       struct sockaddr *addr, socklen_t addr_len)
+{
+	coap_method_t method;
+	uint8_t code;
+
+	code = coap_header_get_code(cpkt);
+	if (method_from_code(resource, code, &method) < 0) {
+		return -ENOTSUP;
+	}
+
+	if (!method) {
+		return -EPERM;
+	}
+
+	return method(resource, cpkt, addr, addr_len);
+}
+
 int coap_handle_request(struct coap_packet *cpkt,
 			struct coap_resource *resources,
 			struct coap_option *options,
@@ -940,27 +959,228 @@ int coap_handle_request(struct coap_packet *cpkt,
 
 	/* FIXME: deal with hierarchical resources */
 	for (resource = resources; resource && resource->path; resource++) {
-		coap_method_t method;
-		uint8_t code;
-
 		if (!uri_path_eq(cpkt, resource->path, options, opt_num)) {
 			continue;
 		}
 
-		code = coap_header_get_code(cpkt);
-		if (method_from_code(resource, code, &method) < 0) {
-			return -ENOTSUP;
+		return call_method(resource, cpkt, addr, addr_len);
+	}
+
+	NET_DBG("%d", __LINE__);
+	return -ENOENT;
+}
+
+static uint32_t trie_hash(uint16_t parent, const uint8_t *segment, uint16_t len)
+{
+	uint32_t hash = 2166136261U;
+
+	hash = (hash ^ (parent & 0xff)) * 16777619U;
+	hash = (hash ^ (parent >> 8)) * 16777619U;
+
+	while (len-- > 0U) {
+		hash = (hash ^ *segment++) * 16777619U;
+	}
+
+	return hash;
+}
+
+static bool trie_is_wildcard(const char *segment, size_t len, char wildcard)
+{
+	return IS_ENABLED(CONFIG_COAP_URI_WILDCARD) && len == 1U &&
+	       *segment == wildcard;
+}
+
+/* Return the slot of the child node of the parent with the given segment,
+ * or the free slot where such a node would be inserted.
+ */
+static uint16_t trie_find(const struct coap_resource_trie *trie, uint16_t parent,
+			  const uint8_t *segment, uint16_t len)
+{
+	const struct coap_resource_trie_node *node;
+	uint16_t slot;
+
+	slot = trie_hash(parent, segment, len) % trie->max_nodes;
+
+	for (node = &trie->nodes[slot]; node->segment != NULL;
+	     node = &trie->nodes[slot]) {
+		if (node->parent == parent && node->len == len &&
+		    memcmp(node->segment, segment, len) == 0) {
+			break;
 		}
 
-		if (!method) {
-			return -EPERM;
+		if (++slot == trie->max_nodes) {
+			slot = 0U;
 		}
+	}
 
-		return method(resource, cpkt, addr, addr_len);
+	return slot;
+}
+
+/* Resources are stored as their index plus one, the first one wins */
+static inline uint16_t trie_first(uint16_t a, uint16_t b)
+{
+	if (a == 0U || b == 0U) {
+		return a | b;
 	}
 
-	NET_DBG("%d", __LINE__);
-	return -ENOENT;
+	return MIN(a, b);
+}
+
+static uint16_t trie_match(const struct coap_resource_trie *trie,
+			   uint16_t parent, uint16_t resource,
+			   const struct coap_option *options,
+			   uint8_t opt_num, uint8_t i)
+{
+	const struct coap_resource_trie_node *node;
+	uint16_t first = 0U;
+	uint16_t slot;
+
+	for (;; i++) {
+		while (i < opt_num && options[i].delta != COAP_OPTION_URI_PATH) {
+			i++;
+		}
+
+		if (i == opt_num) {
+			return trie_first(first, resource);
+		}
+
+		if (trie->wildcards) {
+			/* Multi-level wildcard matches all remaining segments */
+			slot = trie_find(trie, parent, (const uint8_t *)"#", 1U);
+			node = &trie->nodes[slot];
+			if (node->segment != NULL) {
+				first = trie_first(first, node->resource);
+			}
+
+			/* Single-level wildcard matches this segment */
+			slot = trie_find(trie, parent, (const uint8_t *)"+", 1U);
+			node = &trie->nodes[slot];
+			if (node->segment != NULL) {
+				first = trie_first(first,
+						   trie_match(trie, slot, node->resource,
+							      options, opt_num, i + 1));
+			}
+		}
+
+		slot = trie_find(trie, parent, options[i].value, options[i].len);
+		node = &trie->nodes[slot];
+		if (node->segment == NULL) {
+			return first;
+		}
+
+		parent = slot;
+		resource = node->resource;
+	}
+}
+
+int coap_resource_trie_init(struct coap_resource_trie *trie,
+			    struct coap_resource *resources,
+			    struct coap_resource_trie_node *nodes,
+			    size_t max_nodes)
+{
+	struct coap_resource *resource;
+	uint16_t index;
+
+	if (!trie || !resources || !nodes || max_nodes < 2 ||
+	    max_nodes >= COAP_RESOURCE_TRIE_ROOT) {
+		return -EINVAL;
+	}
+
+	memset(nodes, 0, max_nodes * sizeof(*nodes));
+
+	trie->resources = resources;
+	trie->nodes = nodes;
+	trie->max_nodes = max_nodes;
+	trie->num_nodes = 0U;
+	trie->root_resource = 0U;
+	trie->wildcards = false;
+
+	for (resource = resources, index = 0U; resource->path;
+	     resource++, index++) {
+		uint16_t *node_resource = &trie->root_resource;
+		uint16_t parent = COAP_RESOURCE_TRIE_ROOT;
+		const char * const *path;
+
+		if (index == UINT16_MAX) {
+			return -EINVAL;
+		}
+
+		for (path = resource->path; *path; path++) {
+			size_t len = strlen(*path);
+			uint16_t slot;
+
+			if (len > UINT16_MAX) {
+				return -EINVAL;
+			}
+
+			slot = trie_find(trie, parent, (const uint8_t *)*path, len);
+			if (nodes[slot].segment == NULL) {
+				/* Keep a free slot to terminate the probing */
+				if (trie->num_nodes + 1 >= trie->max_nodes) {
+					return -ENOMEM;
+				}
+
+				nodes[slot].segment = *path;
+				nodes[slot].len = len;
+				nodes[slot].parent = parent;
+				trie->num_nodes++;
+			}
+
+			parent = slot;
+			node_resource = &nodes[slot].resource;
+
+			if (trie_is_wildcard(*path, len, '+')) {
+				trie->wildcards = true;
+			} else if (trie_is_wildcard(*path, len, '#')) {
+				/* Segments after it are never compared */
+				trie->wildcards = true;
+				break;
+			}
+		}
+
+		if (*node_resource == 0U) {
+			*node_resource = index + 1;
+		}
+	}
+
+	NET_DBG("%u resources indexed in %u nodes", index, trie->num_nodes);
+
+	return 0;
+}
+
+struct coap_resource *coap_resource_trie_lookup(const struct coap_resource_trie *trie,
+						const struct coap_option *options,
+						uint8_t opt_num)
+{
+	uint16_t resource;
+
+	resource = trie_match(trie, COAP_RESOURCE_TRIE_ROOT, trie->root_resource,
+			      options, opt_num, 0U);
+	if (resource == 0U) {
+		return NULL;
+	}
+
+	return &trie->resources[resource - 1];
+}
+
+int coap_handle_request_trie(struct coap_packet *cpkt,
+			     const struct coap_resource_trie *trie,
+			     struct coap_option *options,
+			     uint8_t opt_num,
+			     struct sockaddr *addr, socklen_t addr_len)
+{
+	struct coap_resource *resource;
+
+	if (!is_request(cpkt)) {
+		return 0;
+	}
+
+	resource = coap_resource_trie_lookup(trie, options, opt_num);
+	if (!resource) {
+		return -ENOENT;
+	}
+
+	return call_method(resource, cpkt, addr, addr_len);
 }
 
 int coap_block_transfer_init(struct coap_block_context *ctx,
@@ -9,6 +9,7 @@
 LOG_MODULE_DECLARE(net_coap, CONFIG_COAP_LOG_LEVEL);
 
 #include <zephyr/net/socket.h>
+#include <zephyr/random/rand32.h>
 
 #include <zephyr/net/coap.h>
 #include <zephyr/net/coap_client.h>
@@ -22,6 +23,8 @@ LOG_MODULE_DECLARE(net_coap, CONFIG_COAP_LOG_LEVEL);
 #define DEFAULT_RETRY_AMOUNT 5
 #define BLOCK1_OPTION_SIZE 4
 #define PAYLOAD_MARKER_SIZE 1
+#define COAP_CLIENT_RTO_MIN 100
+#define COAP_CLIENT_RTO_MAX 60000
 
 static struct coap_client *clients[CONFIG_COAP_CLIENT_MAX_INSTANCES];
 static int num_clients;
@@ -64,9 +67,117 @@ static void reset_internal_request(struct coap_client_internal_request *request)
 	request->offset = 0;
 	request->last_id = 0;
 	request->retry_count = 0;
+	request->outstanding = false;
 	reset_block_contexts(request);
 }
 
+#if defined(CONFIG_COAP_CLIENT_COCOA)
+/* Move an estimate that has not been updated for a while back towards the
+ * default timeout, as it may no longer describe the path.
+ */
+static uint32_t cocoa_rto(struct coap_client *client)
+{
+	uint32_t now = k_uptime_get_32();
+	uint32_t idle = now - client->rto_updated;
+
+	if (client->rto < 1000 && idle > 16 * client->rto) {
+		client->rto = 2 * client->rto;
+		client->rto_updated = now;
+	} else if (client->rto > 3000 && idle > 4 * client->rto) {
+		client->rto = (2000 + client->rto) / 2;
+		client->rto_updated = now;
+	}
+
+	return client->rto;
+}
+
+static void cocoa_update(struct coap_client *client, uint32_t rtt, uint8_t retransmissions)
+{
+	struct coap_client_rtt_estimator *est;
+	uint32_t estimate;
+
+	/* It is unknown which transmission was answered after more retransmissions */
+	if (retransmissions > 2) {
+		return;
+	}
+
+	/* Exchanges without retransmissions feed the strong estimator, the others
+	 * measured from the first transmission feed the weak one.
+	 */
+	est = retransmissions == 0 ? &client->strong : &client->weak;
+	rtt = MAX(rtt, 1);
+
+	if (est->srtt == 0) {
+		est->srtt = rtt;
+		est->rttvar = rtt / 2;
+	} else {
+		uint32_t delta = est->srtt > rtt ? est->srtt - rtt : rtt - est->srtt;
+
+		est->rttvar = (3 * est->rttvar + delta) / 4;
+		est->srtt = (7 * est->srtt + rtt) / 8;
+	}
+
+	if (retransmissions == 0) {
+		estimate = est->srtt + 4 * est->rttvar;
+		client->rto = (client->rto + estimate) / 2;
+	} else {
+		estimate = est->srtt + est->rttvar;
+		client->rto = (3 * client->rto + estimate) / 4;
+	}
+
+	client->rto = CLAMP(client->rto, COAP_CLIENT_RTO_MIN, COAP_CLIENT_RTO_MAX);
+	client->rto_updated = k_uptime_get_32();
+
+	LOG_DBG("RTT %u ms, RTO %u ms", rtt, client->rto);
+}
+#endif /* CONFIG_COAP_CLIENT_COCOA */
+
+static bool pending_cycle(struct coap_client *client,
+			  struct coap_client_internal_request *internal_req)
+{
+#if defined(CONFIG_COAP_CLIENT_COCOA)
+	struct coap_pending *pending = &internal_req->pending;
+	uint32_t rto;
+
+	if (pending->timeout == 0) {
+		/* Initial transmission */
+		rto = cocoa_rto(client);
+
+		/* Variable backoff factor, in halves */
+		if (rto < 1000) {
+			internal_req->backoff = 6;
+		} else if (rto > 3000) {
+			internal_req->backoff = 3;
+		} else {
+			internal_req->backoff = 4;
+		}
+
+#if defined(CONFIG_COAP_RANDOMIZE_ACK_TIMEOUT)
+		rto += sys_rand32_get() %
+		       (rto * (CONFIG_COAP_ACK_RANDOM_PERCENT - 100) / 100 + 1);
+#endif
+		pending->timeout = rto;
+
+		return true;
+	}
+
+	if (pending->retries == 0) {
+		return false;
+	}
+
+	pending->t0 += pending->timeout;
+	pending->timeout = MIN(pending->timeout * internal_req->backoff / 2,
+			       COAP_CLIENT_RTO_MAX);
+	pending->retries--;
+
+	return true;
+#else
+	ARG_UNUSED(client);
+
+	return coap_pending_cycle(&internal_req->pending);
+#endif
+}
+
 static int coap_client_schedule_poll(struct coap_client *client, int sock,
 				     struct coap_client_request *req,
 				     struct coap_client_internal_request *internal_req)
@@ -368,6 +479,134 @@ out:
 	return ret;
 }
 
+static void report_callback_error(struct coap_client_internal_request *internal_req, int error_code)
+{
+	if (internal_req->coap_request.cb) {
+		internal_req->coap_request.cb(error_code, 0, NULL, 0, true,
+					      internal_req->coap_request.user_data);
+	}
+}
+
+static int num_outstanding(struct coap_client *client)
+{
+	int count = 0;
+
+	for (int i = 0; i < CONFIG_COAP_CLIENT_MAX_REQUESTS; i++) {
+		if (client->requests[i].outstanding) {
+			count++;
+		}
+	}
+
+	return count;
+}
+
+/* Must be called with the send mutex held */
+static int send_new_request(struct coap_client *client,
+			    struct coap_client_internal_request *internal_req)
+{
+	int ret;
+
+	ret = coap_pending_init(&internal_req->pending, &internal_req->request, &client->address,
+				internal_req->retry_count);
+	if (ret < 0) {
+		LOG_ERR("Failed to initialize pending struct");
+		return ret;
+	}
+
+	pending_cycle(client, internal_req);
+	internal_req->outstanding = true;
+	internal_req->send_time = internal_req->pending.t0;
+
+	ret = send_request(client->fd, internal_req->request.data, internal_req->request.offset, 0,
+			   &client->address, client->socklen);
+	if (ret < 0) {
+		LOG_ERR("Transmission failed: %d", errno);
+		return ret;
+	}
+
+	return 0;
+}
+
+/* Must be called with the send mutex held */
+static int send_or_queue_request(struct coap_client *client,
+				 struct coap_client_internal_request *internal_req)
+{
+	if (num_outstanding(client) >= CONFIG_COAP_CLIENT_NSTART) {
+		LOG_DBG("%d requests outstanding, queueing", CONFIG_COAP_CLIENT_NSTART);
+
+		/* Not transmitted yet, so nothing to retransmit or match */
+		coap_pending_clear(&internal_req->pending);
+		sys_slist_append(&client->send_queue, &internal_req->queue_node);
+
+		return 0;
+	}
+
+	return send_new_request(client, internal_req);
+}
+
+/* Must be called with the send mutex held */
+static void send_queued_requests(struct coap_client *client)
+{
+	struct coap_client_internal_request *internal_req;
+	sys_snode_t *node;
+	int ret;
+
+	while (num_outstanding(client) < CONFIG_COAP_CLIENT_NSTART) {
+		node = sys_slist_get(&client->send_queue);
+		if (node == NULL) {
+			break;
+		}
+
+		internal_req = CONTAINER_OF(node, struct coap_client_internal_request,
+					    queue_node);
+
+		/* The send buffer has been reused since the request was created */
+		if (internal_req->send_blk_ctx.total_size > 0) {
+			internal_req->send_blk_ctx.current = internal_req->offset;
+		}
+
+		ret = coap_client_init_request(client, &internal_req->coap_request,
+					       internal_req, true);
+		if (ret == 0) {
+			ret = send_new_request(client, internal_req);
+		}
+
+		if (ret < 0) {
+			LOG_ERR("Failed to send queued request: %d", ret);
+			internal_req->outstanding = false;
+			internal_req->request_ongoing = false;
+			report_callback_error(internal_req, ret);
+		}
+	}
+}
+
+/* The request got an answer or timed out, let the queued requests go */
+static void release_request(struct coap_client *client,
+			    struct coap_client_internal_request *internal_req)
+{
+	k_mutex_lock(&client->send_mutex, K_FOREVER);
+	internal_req->outstanding = false;
+	send_queued_requests(client);
+	k_mutex_unlock(&client->send_mutex);
+}
+
+static void request_answered(struct coap_client *client,
+			     struct coap_client_internal_request *internal_req)
+{
+	if (!internal_req->outstanding) {
+		return;
+	}
+
+#if defined(CONFIG_COAP_CLIENT_COCOA)
+	if (internal_req->coap_request.confirmable) {
+		cocoa_update(client, k_uptime_get_32() - internal_req->send_time,
+			     internal_req->retry_count - internal_req->pending.retries);
+	}
+#endif
+
+	release_request(client, internal_req);
+}
+
 int coap_client_req(struct coap_client *client, int sock, const struct sockaddr *addr,
 		    struct coap_client_request *req, int retries)
 {
@@ -419,9 +658,7 @@ int coap_client_req(struct coap_client *client, int sock, const struct sockaddr
 		internal_req->retry_count = retries;
 	}
 
-	if (k_mutex_lock(&client->send_mutex, K_NO_WAIT)) {
-		return -EAGAIN;
-	}
+	k_mutex_lock(&client->send_mutex, K_FOREVER);
 
 	ret = coap_client_init_request(client, req, internal_req, false);
 	if (ret < 0) {
@@ -437,44 +674,17 @@ int coap_client_req(struct coap_client *client, int sock, const struct sockaddr
 		goto out;
 	}
 
-	ret = coap_pending_init(&internal_req->pending, &internal_req->request, &client->address,
-				internal_req->retry_count);
-
-	if (ret < 0) {
-		LOG_ERR("Failed to initialize pending struct");
-		k_mutex_unlock(&client->send_mutex);
-		goto out;
-	}
-
-	coap_pending_cycle(&internal_req->pending);
-
-	ret = send_request(sock, internal_req->request.data, internal_req->request.offset, 0,
-			  &client->address, client->socklen);
+	ret = send_or_queue_request(client, internal_req);
 
 	k_mutex_unlock(&client->send_mutex);
-
-	if (ret < 0) {
-		LOG_ERR("Transmission failed: %d", errno);
-	} else {
-		/* Do not return the number of bytes sent */
-		ret = 0;
-	}
 out:
 	return ret;
 }
 
-static void report_callback_error(struct coap_client_internal_request *internal_req, int error_code)
-{
-	if (internal_req->coap_request.cb) {
-		internal_req->coap_request.cb(error_code, 0, NULL, 0, true,
-					      internal_req->coap_request.user_data);
-	}
-}
-
 static bool timeout_expired(struct coap_client_internal_request *internal_req)
 {
-	return (internal_req->request_ongoing &&
-		internal_req->pending.timeout <= k_uptime_get_32());
+	return (internal_req->request_ongoing && internal_req->pending.timeout != 0 &&
+		k_uptime_get_32() - internal_req->pending.t0 >= internal_req->pending.timeout);
 }
 
 static int resend_request(struct coap_client *client,
@@ -482,7 +692,7 @@ static int resend_request(struct coap_client *client,
 {
 	int ret = 0;
 
-	if (internal_req->pending.timeout != 0 && coap_pending_cycle(&internal_req->pending)) {
+	if (pending_cycle(client, internal_req)) {
 		LOG_ERR("Timeout in poll, retrying send");
 
 		/* Reset send block context as it was updated in previous init from packet */
@@ -510,6 +720,7 @@ static int resend_request(struct coap_client *client,
 		ret = -ETIMEDOUT;
 		report_callback_error(internal_req, ret);
 		internal_req->request_ongoing = false;
+		release_request(client, internal_req);
 	}
 
 	return ret;
@@ -530,6 +741,30 @@ static int coap_client_resend_handler(void)
 	return ret;
 }
 
+/* Time until the next retransmission is due, at most the polling period */
+static int next_timeout(void)
+{
+	int32_t timeout = COAP_PERIODIC_TIMEOUT;
+	uint32_t now = k_uptime_get_32();
+
+	for (int i = 0; i < num_clients; i++) {
+		for (int j = 0; j < CONFIG_COAP_CLIENT_MAX_REQUESTS; j++) {
+			struct coap_client_internal_request *internal_req =
+				&clients[i]->requests[j];
+			int32_t remaining;
+
+			if (!internal_req->request_ongoing || internal_req->pending.timeout == 0) {
+				continue;
+			}
+
+			remaining = internal_req->pending.t0 + internal_req->pending.timeout - now;
+			timeout = CLAMP(remaining, 0, timeout);
+		}
+	}
+
+	return timeout;
+}
+
 static int handle_poll(void)
 {
 	int ret = 0;
@@ -546,7 +781,7 @@ static int handle_poll(void)
 			nfds++;
 		}
 
-		ret = zsock_poll(fds, nfds, COAP_PERIODIC_TIMEOUT);
+		ret = zsock_poll(fds, nfds, next_timeout());
 
 		if (ret < 0) {
 			LOG_ERR("Error in poll:%d", errno);
@@ -686,6 +921,7 @@ struct coap_client_internal_request *get_request_with_id(struct coap_client *cli
 {
 	for (int i = 0; i < CONFIG_COAP_CLIENT_MAX_REQUESTS; i++) {
 		if (client->requests[i].request_ongoing == true &&
+		    client->requests[i].pending.data != NULL &&
 		    client->requests[i].pending.id == message_id) {
 			return &client->requests[i];
 		}
@@ -704,7 +940,8 @@ struct coap_client_internal_request *get_request_with_token(struct coap_client *
 	response_tkl = coap_header_get_token(resp, response_token);
 
 	for (int i = 0; i < CONFIG_COAP_CLIENT_MAX_REQUESTS; i++) {
-		if (client->requests[i].request_ongoing) {
+		if (client->requests[i].request_ongoing &&
+		    client->requests[i].pending.data != NULL) {
 			if (client->requests[i].request_tkl != response_tkl) {
 				continue;
 			}
@@ -743,6 +980,7 @@ static int handle_response(struct coap_client *client, const struct coap_packet
 		LOG_ERR("Unexpected ACK or Reset");
 		return -EFAULT;
 	} else if (response_type == COAP_TYPE_RESET) {
+		request_answered(client, internal_req);
 		coap_pending_clear(&internal_req->pending);
 	}
 
@@ -754,8 +992,9 @@ static int handle_response(struct coap_client *client, const struct coap_packet
 	/* Separate response coming */
 	if (payload_len == 0 && response_type == COAP_TYPE_ACK &&
 	    response_code == COAP_CODE_EMPTY) {
+		request_answered(client, internal_req);
 		internal_req->pending.t0 = k_uptime_get_32();
-		internal_req->pending.timeout = internal_req->pending.t0 + COAP_SEPARATE_TIMEOUT;
+		internal_req->pending.timeout = COAP_SEPARATE_TIMEOUT;
 		internal_req->pending.retries = 0;
 		return 1;
 	}
@@ -774,6 +1013,8 @@ static int handle_response(struct coap_client *client, const struct coap_packet
 		return 1;
 	}
 
+	request_answered(client, internal_req);
+
 	/* Send ack for CON */
 	if (response_type == COAP_TYPE_CON) {
 		/* CON response is always a separate response, respond with empty ACK. */
@@ -846,18 +1087,7 @@ static int handle_response(struct coap_client *client, const struct coap_packet
 			goto fail;
 		}
 
-		ret = coap_pending_init(&internal_req->pending, &internal_req->request,
-					&client->address, internal_req->retry_count);
-		if (ret < 0) {
-			LOG_ERR("Error creating pending");
-			k_mutex_unlock(&client->send_mutex);
-			goto fail;
-		}
-		coap_pending_cycle(&internal_req->pending);
-
-		ret = send_request(client->fd, internal_req->request.data,
-				   internal_req->request.offset, 0, &client->address,
-				   client->socklen);
+		ret = send_or_queue_request(client, internal_req);
 		k_mutex_unlock(&client->send_mutex);
 
 		if (ret < 0) {
@@ -870,6 +1100,9 @@ static int handle_response(struct coap_client *client, const struct coap_packet
 fail:
 	client->response_ready = false;
 	internal_req->request_ongoing = false;
+	if (internal_req->outstanding) {
+		release_request(client, internal_req);
+	}
 	return ret;
 }
 
@@ -907,6 +1140,12 @@ void coap_client_recv(void *coap_cl, void *a, void *b)
 			}
 		}
 
+		/* Retransmissions may be due even if responses keep coming */
+		ret = coap_client_resend_handler();
+		if (ret < 0) {
+			LOG_ERR("Error resending request: %d", ret);
+		}
+
 		/* There are more messages coming */
 		if (has_ongoing_requests()) {
 			continue;
@@ -929,6 +1168,14 @@ int coap_client_init(struct coap_client *client, const char *info)
 	}
 
 	k_mutex_init(&client->send_mutex);
+	sys_slist_init(&client->send_queue);
+
+#if defined(CONFIG_COAP_CLIENT_COCOA)
+	memset(&client->strong, 0, sizeof(client->strong));
+	memset(&client->weak, 0, sizeof(client->weak));
+	client->rto = CONFIG_COAP_INIT_ACK_TIMEOUT_MS;
+	client->rto_updated = k_uptime_get_32();
+#endif
 
 	clients[num_clients] = client;
 	num_clients++;
@@ -0,0 +1,283 @@
+/** @file
+ * @brief DNS answer cache
+ *
+ * Keeps the answers of the DNS resolver until their TTL expires.
+ */
+
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(net_dns_resolve, CONFIG_DNS_RESOLVER_LOG_LEVEL);
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/slist.h>
+#include <zephyr/sys/dlist.h>
+#include <string.h>
+#include <strings.h>
+#include <errno.h>
+
+#include <zephyr/net/net_core.h>
+#include <zephyr/net/net_ip.h>
+#include <zephyr/net/dns_resolve.h>
+#include "dns_internal.h"
+
+#define DNS_CACHE_ENTRIES CONFIG_DNS_RESOLVER_CACHE_MAX_ENTRIES
+#define DNS_CACHE_BUCKETS CONFIG_DNS_RESOLVER_CACHE_MAX_ENTRIES
+#define DNS_CACHE_NAME_LEN CONFIG_DNS_RESOLVER_CACHE_NAME_LEN
+#define DNS_CACHE_ADDRS CONFIG_DNS_RESOLVER_AI_MAX_ENTRIES
+
+struct dns_cache_entry {
+	/** Node in the hash bucket or in the free list */
+	sys_snode_t node;
+	/** Node in the LRU list, the least recently used entry is first */
+	sys_dnode_t lru;
+	/** Uptime in milliseconds when the answer expires */
+	int64_t expires;
+	struct sockaddr addrs[DNS_CACHE_ADDRS];
+	uint32_t hash;
+	enum dns_query_type query_type;
+	/** Number of addresses, 0 for a negative answer */
+	uint8_t addr_count;
+	/** Status of a negative answer, DNS_EAI_NONAME or DNS_EAI_NODATA */
+	int8_t status;
+	char name[DNS_CACHE_NAME_LEN + 1];
+};
+
+static struct dns_cache_entry dns_cache_entries[DNS_CACHE_ENTRIES];
+static sys_slist_t dns_cache_buckets[DNS_CACHE_BUCKETS];
+static sys_slist_t dns_cache_free;
+static sys_dlist_t dns_cache_lru = SYS_DLIST_STATIC_INIT(&dns_cache_lru);
+static struct dns_cache_stats dns_cache_stats;
+static bool dns_cache_initialized;
+
+static K_MUTEX_DEFINE(dns_cache_lock);
+
+/* DNS names are case insensitive, so are the hash and the comparison */
+static uint32_t dns_cache_hash(const char *name, enum dns_query_type type)
+{
+	uint32_t hash = 2166136261U;
+
+	while (*name != '\0') {
+		char c = *name++;
+
+		if (c >= 'A' && c <= 'Z') {
+			c += 'a' - 'A';
+		}
+
+		hash = (hash ^ (uint8_t)c) * 16777619U;
+	}
+
+	return (hash ^ (uint32_t)type) * 16777619U;
+}
+
+static inline sys_slist_t *dns_cache_bucket(uint32_t hash)
+{
+	return &dns_cache_buckets[hash % DNS_CACHE_BUCKETS];
+}
+
+/* Must be invoked with the cache lock held */
+static void dns_cache_init(void)
+{
+	int i;
+
+	if (dns_cache_initialized) {
+		return;
+	}
+
+	for (i = 0; i < DNS_CACHE_ENTRIES; i++) {
+		sys_slist_append(&dns_cache_free, &dns_cache_entries[i].node);
+	}
+
+	dns_cache_initialized = true;
+}
+
+/* Must be invoked with the cache lock held */
+static void dns_cache_remove(struct dns_cache_entry *entry)
+{
+	sys_slist_find_and_remove(dns_cache_bucket(entry->hash), &entry->node);
+	sys_dlist_remove(&entry->lru);
+	sys_slist_append(&dns_cache_free, &entry->node);
+
+	dns_cache_stats.entries--;
+}
+
+/* Must be invoked with the cache lock held */
+static struct dns_cache_entry *dns_cache_get(const char *name,
+					     enum dns_query_type type,
+					     uint32_t hash)
+{
+	struct dns_cache_entry *entry;
+
+	SYS_SLIST_FOR_EACH_CONTAINER(dns_cache_bucket(hash), entry, node) {
+		if (entry->hash == hash && entry->query_type == type &&
+		    strcasecmp(entry->name, name) == 0) {
+			return entry;
+		}
+	}
+
+	return NULL;
+}
+
+int dns_cache_find(const char *name, enum dns_query_type type,
+		   struct sockaddr *addrs, int *count)
+{
+	uint32_t hash = dns_cache_hash(name, type);
+	struct dns_cache_entry *entry;
+	int ret = -ENOENT;
+
+	k_mutex_lock(&dns_cache_lock, K_FOREVER);
+
+	dns_cache_init();
+
+	entry = dns_cache_get(name, type, hash);
+	if (entry != NULL && entry->expires - k_uptime_get() <= 0) {
+		NET_DBG("Cached answer for %s expired", name);
+
+		dns_cache_remove(entry);
+		entry = NULL;
+	}
+
+	if (entry == NULL) {
+		dns_cache_stats.misses++;
+		goto out;
+	}
+
+	/* Most recently used entries are kept at the end of the list */
+	sys_dlist_remove(&entry->lru);
+	sys_dlist_append(&dns_cache_lru, &entry->lru);
+
+	dns_cache_stats.hits++;
+
+	if (entry->addr_count == 0U) {
+		dns_cache_stats.negative_hits++;
+		ret = entry->status;
+		goto out;
+	}
+
+	memcpy(addrs, entry->addrs, entry->addr_count * sizeof(addrs[0]));
+	*count = entry->addr_count;
+	ret = 0;
+
+out:
+	k_mutex_unlock(&dns_cache_lock);
+
+	return ret;
+}
+
+void dns_cache_add(const char *name, enum dns_query_type type,
+		   const struct sockaddr *addrs, int count, uint32_t ttl,
+		   int status)
+{
+	struct dns_cache_entry *entry;
+	size_t name_len;
+	uint32_t hash;
+
+	if (count == 0) {
+		ttl = CONFIG_DNS_RESOLVER_CACHE_NEGATIVE_TTL;
+	}
+
+	ttl = MIN(ttl, CONFIG_DNS_RESOLVER_CACHE_MAX_TTL);
+	if (ttl == 0U) {
+		return;
+	}
+
+	name_len = strlen(name);
+	if (name_len > DNS_CACHE_NAME_LEN) {
+		return;
+	}
+
+	count = MIN(count, DNS_CACHE_ADDRS);
+	hash = dns_cache_hash(name, type);
+
+	k_mutex_lock(&dns_cache_lock, K_FOREVER);
+
+	dns_cache_init();
+
+	/* A newer answer replaces the cached one */
+	entry = dns_cache_get(name, type, hash);
+	if (entry != NULL) {
+		dns_cache_remove(entry);
+	}
+
+	if (sys_slist_is_empty(&dns_cache_free)) {
+		entry = CONTAINER_OF(sys_dlist_peek_head(&dns_cache_lru),
+				     struct dns_cache_entry, lru);
+
+		NET_DBG("Evicting cached answer for %s", entry->name);
+
+		dns_cache_remove(entry);
+		dns_cache_stats.evictions++;
+	}
+
+	entry = CONTAINER_OF(sys_slist_get(&dns_cache_free),
+			     struct dns_cache_entry, node);
+
+	memcpy(entry->name, name, name_len + 1);
+	memcpy(entry->addrs, addrs, count * sizeof(addrs[0]));
+	entry->addr_count = count;
+	entry->status = count ? 0 : status;
+	entry->query_type = type;
+	entry->hash = hash;
+	entry->expires = k_uptime_get() + (int64_t)ttl * MSEC_PER_SEC;
+
+	sys_slist_prepend(dns_cache_bucket(hash), &entry->node);
+	sys_dlist_append(&dns_cache_lru, &entry->lru);
+
+	dns_cache_stats.entries++;
+
+	NET_DBG("Cached %d address(es) for %s type %d ttl %u", count, name,
+		type, ttl);
+
+	k_mutex_unlock(&dns_cache_lock);
+}
+
+void dns_cache_flush(void)
+{
+	struct dns_cache_entry *entry, *next;
+
+	k_mutex_lock(&dns_cache_lock, K_FOREVER);
+
+	SYS_DLIST_FOR_EACH_CONTAINER_SAFE(&dns_cache_lru, entry, next, lru) {
+		dns_cache_remove(entry);
+	}
+
+	k_mutex_unlock(&dns_cache_lock);
+}
+
+void dns_cache_foreach(dns_cache_cb_t cb, void *user_data)
+{
+	struct dns_cache_entry *entry, *next;
+	struct dns_cache_info info;
+	int64_t now;
+
+	k_mutex_lock(&dns_cache_lock, K_FOREVER);
+
+	now = k_uptime_get();
+
+	SYS_DLIST_FOR_EACH_CONTAINER_SAFE(&dns_cache_lru, entry, next, lru) {
+		if (entry->expires - now <= 0) {
+			dns_cache_remove(entry);
+			continue;
+		}
+
+		info.name = entry->name;
+		info.query_type = entry->query_type;
+		info.status = entry->status;
+		info.ttl = DIV_ROUND_UP(entry->expires - now, MSEC_PER_SEC);
+		info.addrs = entry->addrs;
+		info.addr_count = entry->addr_count;
+
+		cb(&info, user_data);
+	}
+
+	k_mutex_unlock(&dns_cache_lock);
+}
+
+void dns_cache_stats_get(struct dns_cache_stats *stats)
+{
+	k_mutex_lock(&dns_cache_lock, K_FOREVER);
+	*stats = dns_cache_stats;
+	k_mutex_unlock(&dns_cache_lock);
+}
@@ -18,3 +18,19 @@ int dns_validate_msg(struct dns_resolve_context *ctx,
 		     struct net_buf *dns_cname,
 		     uint16_t *query_hash);
 #endif
+
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+/* Find a cached answer. Returns 0 and fills in the addresses for a
+ * positive answer, the status of a negative answer (DNS_EAI_NONAME or
+ * DNS_EAI_NODATA) and -ENOENT if nothing valid is cached for the name.
+ */
+int dns_cache_find(const char *name, enum dns_query_type type,
+		   struct sockaddr *addrs, int *count);
+
+/* Store an answer. An empty address list means a negative answer with
+ * the given status, in which case the ttl is ignored.
+ */
+void dns_cache_add(const char *name, enum dns_query_type type,
+		   const struct sockaddr *addrs, int count, uint32_t ttl,
+		   int status);
+#endif
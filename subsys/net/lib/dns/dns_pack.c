@@ -221,9 +221,11 @@ int dns_unpack_response_header(struct dns_msg_t *msg, int src_id)
 	ancount = dns_unpack_header_ancount(dns_header);
 
 	/* For mDNS (when src_id == 0) the query count is 0 so accept
-	 * the packet in that case.
+	 * the packet in that case. A unicast NOERROR response without
+	 * answers is valid, the name exists but has no records of the
+	 * queried type (NODATA, RFC 2308 ch 2.2).
 	 */
-	if ((qdcount < 1 && src_id > 0) || ancount < 1) {
+	if ((qdcount < 1 && src_id > 0) || (ancount < 1 && src_id == 0)) {
 		return -EINVAL;
 	}
 
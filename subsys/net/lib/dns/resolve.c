@@ -473,6 +473,10 @@ int dns_validate_msg(struct dns_resolve_context *ctx,
 {
 	struct dns_addrinfo info = { 0 };
 	uint32_t ttl; /* RR ttl, so far it is not passed to caller */
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+	struct sockaddr cache_addrs[CONFIG_DNS_RESOLVER_AI_MAX_ENTRIES];
+	uint32_t cache_ttl = UINT32_MAX;
+#endif
 	uint8_t *src, *addr;
 	const char *query_name;
 	int address_size;
@@ -480,6 +484,7 @@ int dns_validate_msg(struct dns_resolve_context *ctx,
 	int answer_ptr;
 	int items;
 	int server_idx;
+	int rcode;
 	int ret = 0;
 
 	/* Make sure that we can read DNS id, flags and rcode */
@@ -515,6 +520,9 @@ int dns_validate_msg(struct dns_resolve_context *ctx,
 		goto quit;
 	}
 
+	/* The response code of an answer that is not an error */
+	rcode = ret;
+
 	if (dns_header_qdcount(dns_msg->msg) != 1) {
 		/* For mDNS (when dns_id == 0) the query count is 0 */
 		if (*dns_id > 0) {
@@ -633,6 +641,14 @@ query_known:
 			src = dns_msg->msg + dns_msg->response_position;
 			memcpy(addr, src, address_size);
 
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+			if (items < (int)ARRAY_SIZE(cache_addrs)) {
+				cache_addrs[items] = info.ai_addr;
+			}
+
+			cache_ttl = MIN(cache_ttl, ttl);
+#endif
+
 			invoke_query_callback(DNS_EAI_INPROGRESS, &info,
 					      &ctx->queries[*query_idx]);
 			items++;
@@ -700,12 +716,29 @@ query_known:
 		}
 	}
 
-	if (items == 0) {
-		ret = DNS_EAI_NODATA;
-	} else {
+	if (items > 0) {
 		ret = DNS_EAI_ALLDONE;
+	} else if (rcode == DNS_HEADER_NAMEERROR) {
+		ret = DNS_EAI_NONAME;
+	} else {
+		ret = DNS_EAI_NODATA;
 	}
 
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+	/* The TTL of the answer is the smallest TTL of its records. Only
+	 * answers and the negative answers defined in RFC 2308 are cached,
+	 * server failures are not.
+	 */
+	if (ctx->queries[*query_idx].query != NULL &&
+	    (rcode == DNS_HEADER_NOERROR || rcode == DNS_HEADER_NAMEERROR)) {
+		dns_cache_add(ctx->queries[*query_idx].query,
+			      ctx->queries[*query_idx].query_type,
+			      cache_addrs,
+			      MIN(items, (int)ARRAY_SIZE(cache_addrs)),
+			      cache_ttl, ret);
+	}
+#endif
+
 quit:
 	return ret;
 }
@@ -736,6 +769,7 @@ static int dns_read(struct dns_resolve_context *ctx,
 
 	dns_msg.msg = dns_data->data;
 	dns_msg.msg_size = data_len;
+	dns_msg.response_type = DNS_RESPONSE_INVALID;
 
 	ret = dns_validate_msg(ctx, &dns_msg, dns_id, &query_idx,
 			       dns_cname, query_hash);
@@ -1105,6 +1139,45 @@ static void query_timeout(struct k_work *work)
 	k_mutex_unlock(&pending_query->ctx->lock);
 }
 
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+/* Returns true if the query was answered from the cache */
+static bool dns_resolve_from_cache(const char *query,
+				   enum dns_query_type type,
+				   dns_resolve_cb_t cb,
+				   void *user_data)
+{
+	struct sockaddr addrs[CONFIG_DNS_RESOLVER_AI_MAX_ENTRIES];
+	struct dns_addrinfo info;
+	int count, ret, i;
+
+	ret = dns_cache_find(query, type, addrs, &count);
+	if (ret == -ENOENT) {
+		return false;
+	}
+
+	if (ret < 0) {
+		cb(ret, NULL, user_data);
+		return true;
+	}
+
+	for (i = 0; i < count; i++) {
+		memset(&info, 0, sizeof(info));
+
+		info.ai_addr = addrs[i];
+		info.ai_family = addrs[i].sa_family;
+		info.ai_addrlen = addrs[i].sa_family == AF_INET6 ?
+				  sizeof(struct sockaddr_in6) :
+				  sizeof(struct sockaddr_in);
+
+		cb(DNS_EAI_INPROGRESS, &info, user_data);
+	}
+
+	cb(DNS_EAI_ALLDONE, NULL, user_data);
+
+	return true;
+}
+#endif /* CONFIG_DNS_RESOLVER_CACHE */
+
 int dns_resolve_name(struct dns_resolve_context *ctx,
 		     const char *query,
 		     enum dns_query_type type,
@@ -1181,6 +1254,12 @@ int dns_resolve_name(struct dns_resolve_context *ctx,
 		return 0;
 	}
 
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+	if (dns_resolve_from_cache(query, type, cb, user_data)) {
+		return 0;
+	}
+#endif
+
 try_resolve:
 	k_mutex_lock(&ctx->lock, K_FOREVER);
 
@@ -1462,6 +1541,9 @@ int dns_resolve_reconfigure(struct dns_resolve_context *ctx,
 		goto unlock;
 	}
 
+	/* The cached answers came from the old servers */
+	dns_cache_flush();
+
 	if (ctx->state == DNS_RESOLVE_CONTEXT_ACTIVE) {
 		dns_resolve_cancel_all(ctx);
 
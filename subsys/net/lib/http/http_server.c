@@ -0,0 +1,1101 @@
+/** @file
+ * @brief HTTP server
+ *
+ * Serves the resources of the HTTP services over HTTP/1.1
+ */
+
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(net_http_server, CONFIG_NET_HTTP_LOG_LEVEL);
+
+#include <zephyr/kernel.h>
+#include <string.h>
+#include <errno.h>
+#include <stdbool.h>
+
+#include <zephyr/net/net_core.h>
+#include <zephyr/net/net_ip.h>
+#include <zephyr/net/socket.h>
+#include <zephyr/net/http/parser.h>
+#include <zephyr/net/http/server.h>
+#include <zephyr/net/http/service.h>
+#include <zephyr/net/http/status.h>
+
+#if defined(CONFIG_FILE_SYSTEM)
+#include <zephyr/fs/fs.h>
+#endif
+
+#if defined(CONFIG_EVENTFD)
+#include <zephyr/posix/sys/eventfd.h>
+#endif
+
+#define MAX_SERVICES CONFIG_HTTP_SERVER_MAX_SERVICES
+#define MAX_CLIENTS CONFIG_HTTP_SERVER_MAX_CLIENTS
+#define CHUNK_SIZE CONFIG_HTTP_SERVER_CHUNK_SIZE
+#define INACTIVITY_TIMEOUT \
+	((int64_t)CONFIG_HTTP_SERVER_CLIENT_INACTIVITY_TIMEOUT * MSEC_PER_SEC)
+
+/* Without an event descriptor to wake the server thread up, it checks for
+ * a stop request at this interval (in milliseconds).
+ */
+#define STOP_CHECK_INTERVAL 100
+
+#define HEADER_BUF_SIZE 192
+
+/* A chunk is framed by four hex digits and CRLF before the data, and CRLF
+ * after it. The chunk size is zero padded so that the data can be written
+ * to its final place before its length is known.
+ */
+#define CHUNK_HDR_LEN 6
+#define CHUNK_TRAILER_LEN 2
+#define LAST_CHUNK "0\r\n\r\n"
+
+BUILD_ASSERT(CHUNK_SIZE <= 0xffff, "Chunk size must fit in four hex digits");
+
+#define MAX_POLL_FDS (1 + MAX_SERVICES + MAX_CLIENTS)
+
+struct http_client_ctx {
+	/** Socket of the connection, or -1 if the context is free */
+	int fd;
+
+	/** Index of the service the client connected to */
+	int service;
+
+	struct http_parser parser;
+
+	/** Request being answered */
+	struct http_server_request request;
+
+	/** Uptime in milliseconds of the last data received or sent */
+	int64_t last_activity;
+
+	/** Resource being sent, NULL for an error response */
+	const struct http_resource_detail *resource;
+
+	/** Number of content bytes produced so far */
+	size_t offset;
+
+	/** Header bytes not sent yet */
+	const uint8_t *hdr;
+	size_t hdr_len;
+
+	/** Body bytes not sent yet */
+	const uint8_t *body;
+	size_t body_len;
+
+	/** Number of received bytes not parsed yet */
+	size_t data_len;
+
+	/** Length of the URL received so far */
+	size_t url_len;
+
+#if defined(CONFIG_FILE_SYSTEM)
+	struct fs_file_t file;
+	bool file_open;
+#endif
+
+	/** A complete request has been parsed */
+	bool request_ready : 1;
+
+	/** The URL did not fit into the URL buffer */
+	bool url_too_long : 1;
+
+	/** The connection is kept open after the response */
+	bool keep_alive : 1;
+
+	/** A response is being sent */
+	bool responding : 1;
+
+	/** Only the header of the response is sent */
+	bool head_only : 1;
+
+	/** The body is sent with chunked transfer coding */
+	bool chunked : 1;
+
+	/** The last chunk has been produced */
+	bool last_chunk : 1;
+
+	char url[CONFIG_HTTP_SERVER_MAX_URL_LENGTH + 1];
+	char header[HEADER_BUF_SIZE];
+	uint8_t chunk[CHUNK_HDR_LEN + CHUNK_SIZE + CHUNK_TRAILER_LEN];
+	uint8_t buffer[CONFIG_HTTP_SERVER_CLIENT_BUFFER_SIZE];
+};
+
+static struct http_client_ctx clients[MAX_CLIENTS];
+
+static const struct http_service_desc *services[MAX_SERVICES];
+static int service_fds[MAX_SERVICES];
+static size_t service_clients[MAX_SERVICES];
+static int num_services;
+
+static struct zsock_pollfd fds[MAX_POLL_FDS];
+static struct http_client_ctx *fd_clients[MAX_POLL_FDS];
+
+static int event_fd = -1;
+static atomic_t stop_requested;
+
+static K_MUTEX_DEFINE(server_lock);
+static K_THREAD_STACK_DEFINE(server_stack, CONFIG_HTTP_SERVER_STACK_SIZE);
+static struct k_thread server_thread;
+static k_tid_t server_tid;
+
+static const char *status_str(enum http_status status)
+{
+	switch (status) {
+	case HTTP_200_OK:
+		return "OK";
+	case HTTP_400_BAD_REQUEST:
+		return "Bad Request";
+	case HTTP_404_NOT_FOUND:
+		return "Not Found";
+	case HTTP_405_METHOD_NOT_ALLOWED:
+		return "Method Not Allowed";
+	case HTTP_414_URI_TOO_LONG:
+		return "URI Too Long";
+	default:
+		return "Internal Server Error";
+	}
+}
+
+static int on_message_begin(struct http_parser *parser)
+{
+	struct http_client_ctx *ctx =
+		CONTAINER_OF(parser, struct http_client_ctx, parser);
+
+	ctx->url_len = 0;
+	ctx->url_too_long = false;
+
+	return 0;
+}
+
+static int on_url(struct http_parser *parser, const char *at, size_t length)
+{
+	struct http_client_ctx *ctx =
+		CONTAINER_OF(parser, struct http_client_ctx, parser);
+
+	/* The URL may be split over several receive calls */
+	if (ctx->url_len + length > CONFIG_HTTP_SERVER_MAX_URL_LENGTH) {
+		ctx->url_too_long = true;
+		return 0;
+	}
+
+	memcpy(&ctx->url[ctx->url_len], at, length);
+	ctx->url_len += length;
+
+	return 0;
+}
+
+static int on_message_complete(struct http_parser *parser)
+{
+	struct http_client_ctx *ctx =
+		CONTAINER_OF(parser, struct http_client_ctx, parser);
+
+	ctx->request_ready = true;
+	ctx->keep_alive = http_should_keep_alive(parser) && !parser->upgrade;
+
+	/* Stop at the end of the request, any pipelined request following
+	 * it is kept in the buffer until the response has been sent.
+	 */
+	http_parser_pause(parser, 1);
+
+	return 0;
+}
+
+static const struct http_parser_settings parser_settings = {
+	.on_message_begin = on_message_begin,
+	.on_url = on_url,
+	.on_message_complete = on_message_complete,
+};
+
+static void response_header(struct http_client_ctx *ctx,
+			    enum http_status status,
+			    const struct http_resource_detail *detail,
+			    size_t content_len)
+{
+	char length[sizeof("Content-Length: 18446744073709551615\r\n")] = "";
+	const char *content_type = NULL;
+	const char *content_encoding = NULL;
+	int len;
+
+	if (detail != NULL) {
+		content_type = detail->content_type;
+		content_encoding = detail->content_encoding;
+	}
+
+	if (ctx->chunked) {
+		strcpy(length, "Transfer-Encoding: chunked\r\n");
+	} else if (content_len != SIZE_MAX) {
+		snprintk(length, sizeof(length), "Content-Length: %zu\r\n",
+			 content_len);
+	}
+
+	len = snprintk(ctx->header, sizeof(ctx->header),
+		       "HTTP/1.1 %d %s\r\n"
+		       "%s%s%s"
+		       "%s%s%s"
+		       "%s"
+		       "%s"
+		       "\r\n",
+		       status, status_str(status),
+		       content_type ? "Content-Type: " : "",
+		       content_type ? content_type : "",
+		       content_type ? "\r\n" : "",
+		       content_encoding ? "Content-Encoding: " : "",
+		       content_encoding ? content_encoding : "",
+		       content_encoding ? "\r\n" : "",
+		       length,
+		       !ctx->keep_alive ? "Connection: close\r\n" :
+		       ctx->parser.http_minor == 0 ? "Connection: keep-alive\r\n" :
+		       "");
+	if (len >= (int)sizeof(ctx->header)) {
+		NET_ERR("Response header does not fit (%d bytes)", len);
+
+		ctx->resource = NULL;
+		ctx->chunked = false;
+		ctx->keep_alive = false;
+
+		len = snprintk(ctx->header, sizeof(ctx->header),
+			       "HTTP/1.1 %d %s\r\n"
+			       "Content-Length: 0\r\n"
+			       "Connection: close\r\n"
+			       "\r\n",
+			       HTTP_500_INTERNAL_SERVER_ERROR,
+			       status_str(HTTP_500_INTERNAL_SERVER_ERROR));
+	}
+
+	ctx->hdr = (const uint8_t *)ctx->header;
+	ctx->hdr_len = len;
+}
+
+static void response_error(struct http_client_ctx *ctx,
+			   enum http_status status)
+{
+	NET_DBG("[%d] %s: %d", ctx->fd, ctx->url, status);
+
+	ctx->resource = NULL;
+	ctx->chunked = false;
+
+	response_header(ctx, status, NULL, 0);
+}
+
+static const struct http_resource_detail *
+find_resource(const struct http_service_desc *service, const char *url)
+{
+	HTTP_SERVICE_FOREACH_RESOURCE(service, res) {
+		if (strcmp(res->resource, url) == 0) {
+			return res->detail;
+		}
+	}
+
+	return NULL;
+}
+
+static void response_static(struct http_client_ctx *ctx)
+{
+	const struct http_resource_detail_static *detail =
+		CONTAINER_OF(ctx->resource,
+			     const struct http_resource_detail_static, common);
+
+	response_header(ctx, HTTP_200_OK, ctx->resource,
+			detail->static_data_len);
+
+	/* Sent straight from the resource, without copying */
+	if (!ctx->head_only && ctx->resource != NULL) {
+		ctx->body = detail->static_data;
+		ctx->body_len = detail->static_data_len;
+	}
+}
+
+static void response_fs(struct http_client_ctx *ctx)
+{
+#if defined(CONFIG_FILE_SYSTEM)
+	const struct http_resource_detail_fs *detail =
+		CONTAINER_OF(ctx->resource,
+			     const struct http_resource_detail_fs, common);
+	struct fs_dirent entry;
+	int ret;
+
+	ret = fs_stat(detail->fs_path, &entry);
+	if (ret < 0 || entry.type != FS_DIR_ENTRY_FILE) {
+		response_error(ctx, HTTP_404_NOT_FOUND);
+		return;
+	}
+
+	if (!ctx->head_only) {
+		fs_file_t_init(&ctx->file);
+
+		ret = fs_open(&ctx->file, detail->fs_path, FS_O_READ);
+		if (ret < 0) {
+			NET_ERR("Cannot open %s (%d)", detail->fs_path, ret);
+			response_error(ctx, HTTP_500_INTERNAL_SERVER_ERROR);
+			return;
+		}
+
+		ctx->file_open = true;
+	}
+
+	response_header(ctx, HTTP_200_OK, ctx->resource, entry.size);
+#else
+	NET_ERR("File system support is disabled");
+	response_error(ctx, HTTP_500_INTERNAL_SERVER_ERROR);
+#endif
+}
+
+static void response_dynamic(struct http_client_ctx *ctx)
+{
+	/* The length of the content is not known in advance. An HTTP/1.0
+	 * client does not know chunked transfer coding, so the end of the
+	 * content is signalled by closing the connection instead.
+	 */
+	if (ctx->parser.http_major == 1 && ctx->parser.http_minor == 0) {
+		ctx->keep_alive = false;
+	} else {
+		ctx->chunked = true;
+	}
+
+	response_header(ctx, HTTP_200_OK, ctx->resource, SIZE_MAX);
+}
+
+static void handle_request(struct http_client_ctx *ctx)
+{
+	const struct http_resource_detail *detail;
+	enum http_method method = ctx->parser.method;
+	char *query;
+
+	ctx->request_ready = false;
+	ctx->responding = true;
+	ctx->chunked = false;
+	ctx->last_chunk = false;
+	ctx->offset = 0;
+	ctx->hdr_len = 0;
+	ctx->body_len = 0;
+	ctx->resource = NULL;
+	ctx->head_only = (method == HTTP_HEAD);
+
+	ctx->url[ctx->url_len] = '\0';
+
+	if (ctx->url_too_long) {
+		ctx->url[0] = '\0';
+		response_error(ctx, HTTP_414_URI_TOO_LONG);
+		return;
+	}
+
+	query = strchr(ctx->url, '?');
+	if (query != NULL) {
+		*query++ = '\0';
+	} else {
+		query = &ctx->url[ctx->url_len];
+	}
+
+	ctx->request.method = method;
+	ctx->request.url = ctx->url;
+	ctx->request.query = query;
+
+	NET_DBG("[%d] %s %s", ctx->fd, http_method_str(method), ctx->url);
+
+	detail = find_resource(services[ctx->service], ctx->url);
+	if (detail == NULL) {
+		response_error(ctx, HTTP_404_NOT_FOUND);
+		return;
+	}
+
+	if (method >= 32 ||
+	    !(detail->bitmask_of_supported_http_methods & BIT(method))) {
+		response_error(ctx, HTTP_405_METHOD_NOT_ALLOWED);
+		return;
+	}
+
+	ctx->resource = detail;
+
+	switch (detail->type) {
+	case HTTP_RESOURCE_TYPE_STATIC:
+		response_static(ctx);
+		break;
+	case HTTP_RESOURCE_TYPE_FS:
+		response_fs(ctx);
+		break;
+	case HTTP_RESOURCE_TYPE_DYNAMIC:
+		response_dynamic(ctx);
+		break;
+	default:
+		response_error(ctx, HTTP_500_INTERNAL_SERVER_ERROR);
+		break;
+	}
+}
+
+static void put_chunk_len(uint8_t *buf, size_t len)
+{
+	static const char hex[] = "0123456789abcdef";
+	int i;
+
+	for (i = 0; i < 4; i++) {
+		buf[i] = hex[(len >> (12 - 4 * i)) & 0xf];
+	}
+
+	buf[4] = '\r';
+	buf[5] = '\n';
+	buf[CHUNK_HDR_LEN + len] = '\r';
+	buf[CHUNK_HDR_LEN + len + 1] = '\n';
+}
+
+static int next_dynamic(struct http_client_ctx *ctx)
+{
+	const struct http_resource_detail_dynamic *detail =
+		CONTAINER_OF(ctx->resource,
+			     const struct http_resource_detail_dynamic, common);
+	int ret;
+
+	if (ctx->last_chunk) {
+		return 0;
+	}
+
+	ret = detail->cb(&ctx->request, ctx->offset, &ctx->chunk[CHUNK_HDR_LEN],
+			 CHUNK_SIZE, detail->user_data);
+	if (ret < 0) {
+		NET_DBG("[%d] Dynamic resource %s failed (%d)", ctx->fd,
+			ctx->url, ret);
+		return ret;
+	}
+
+	ret = MIN(ret, CHUNK_SIZE);
+	ctx->offset += ret;
+
+	if (!ctx->chunked) {
+		ctx->last_chunk = (ret == 0);
+		ctx->body = &ctx->chunk[CHUNK_HDR_LEN];
+		ctx->body_len = ret;
+
+		return ret;
+	}
+
+	if (ret == 0) {
+		ctx->last_chunk = true;
+		ctx->body = (const uint8_t *)LAST_CHUNK;
+		ctx->body_len = sizeof(LAST_CHUNK) - 1;
+
+		return 1;
+	}
+
+	put_chunk_len(ctx->chunk, ret);
+
+	ctx->body = ctx->chunk;
+	ctx->body_len = CHUNK_HDR_LEN + ret + CHUNK_TRAILER_LEN;
+
+	return 1;
+}
+
+static int next_fs(struct http_client_ctx *ctx)
+{
+#if defined(CONFIG_FILE_SYSTEM)
+	ssize_t len;
+
+	if (!ctx->file_open) {
+		return 0;
+	}
+
+	len = fs_read(&ctx->file, ctx->chunk, CHUNK_SIZE);
+	if (len <= 0) {
+		(void)fs_close(&ctx->file);
+		ctx->file_open = false;
+
+		return len;
+	}
+
+	ctx->offset += len;
+	ctx->body = ctx->chunk;
+	ctx->body_len = len;
+
+	return 1;
+#else
+	return 0;
+#endif
+}
+
+/* Produce the next part of the body once the previous one has been sent.
+ * Return a positive value if there is more to send, 0 at the end of the
+ * body, or a negative error code.
+ */
+static int next_body(struct http_client_ctx *ctx)
+{
+	if (ctx->resource == NULL || ctx->head_only) {
+		return 0;
+	}
+
+	switch (ctx->resource->type) {
+	case HTTP_RESOURCE_TYPE_FS:
+		return next_fs(ctx);
+	case HTTP_RESOURCE_TYPE_DYNAMIC:
+		return next_dynamic(ctx);
+	default:
+		/* Static content is given in one piece */
+		return 0;
+	}
+}
+
+/* Send as much of the response as the socket accepts. Return 0 when the
+ * response has been sent, -EAGAIN if the socket is full, or a negative
+ * error code.
+ */
+static int client_send(struct http_client_ctx *ctx)
+{
+	struct iovec iov[2];
+	struct msghdr msg = {
+		.msg_iov = iov,
+	};
+	ssize_t sent;
+	size_t len;
+	int ret;
+
+	while (true) {
+		/* The next part of the body is produced before the header
+		 * is sent, so that both go out in the same segment.
+		 */
+		if (ctx->body_len == 0) {
+			ret = next_body(ctx);
+			if (ret < 0) {
+				return ret;
+			}
+
+			if (ret == 0 && ctx->hdr_len == 0) {
+				return 0;
+			}
+		}
+
+		msg.msg_iovlen = 0;
+
+		if (ctx->hdr_len > 0) {
+			iov[msg.msg_iovlen].iov_base = (void *)ctx->hdr;
+			iov[msg.msg_iovlen].iov_len = ctx->hdr_len;
+			msg.msg_iovlen++;
+		}
+
+		if (ctx->body_len > 0) {
+			iov[msg.msg_iovlen].iov_base = (void *)ctx->body;
+			iov[msg.msg_iovlen].iov_len = ctx->body_len;
+			msg.msg_iovlen++;
+		}
+
+		sent = zsock_sendmsg(ctx->fd, &msg, ZSOCK_MSG_DONTWAIT);
+		if (sent < 0) {
+			return -errno;
+		}
+
+		ctx->last_activity = k_uptime_get();
+
+		len = MIN(sent, ctx->hdr_len);
+		ctx->hdr += len;
+		ctx->hdr_len -= len;
+		sent -= len;
+
+		ctx->body += sent;
+		ctx->body_len -= sent;
+	}
+}
+
+static void client_close(struct http_client_ctx *ctx)
+{
+	NET_DBG("[%d] Closing connection", ctx->fd);
+
+#if defined(CONFIG_FILE_SYSTEM)
+	if (ctx->file_open) {
+		(void)fs_close(&ctx->file);
+		ctx->file_open = false;
+	}
+#endif
+
+	(void)zsock_close(ctx->fd);
+	ctx->fd = -1;
+
+	service_clients[ctx->service]--;
+}
+
+/* Parse the received data until a request is complete. Return true if a
+ * request is ready to be answered.
+ */
+static bool client_parse(struct http_client_ctx *ctx)
+{
+	enum http_errno err;
+	size_t parsed;
+
+	parsed = http_parser_execute(&ctx->parser, &parser_settings,
+				     (const char *)ctx->buffer, ctx->data_len);
+
+	err = HTTP_PARSER_ERRNO(&ctx->parser);
+	if (err == HPE_PAUSED) {
+		http_parser_pause(&ctx->parser, 0);
+	} else if (err != HPE_OK) {
+		NET_DBG("[%d] Invalid request: %s", ctx->fd,
+			http_errno_description(err));
+
+		/* The rest of the stream cannot be parsed anymore */
+		ctx->data_len = 0;
+		ctx->url_len = 0;
+		ctx->url[0] = '\0';
+		ctx->keep_alive = false;
+		ctx->responding = true;
+		ctx->head_only = false;
+		ctx->body_len = 0;
+
+		response_error(ctx, HTTP_400_BAD_REQUEST);
+
+		return false;
+	}
+
+	ctx->data_len -= parsed;
+	memmove(ctx->buffer, &ctx->buffer[parsed], ctx->data_len);
+
+	return ctx->request_ready;
+}
+
+/* Answer the requests received so far. Return a negative error code if the
+ * connection must be closed.
+ */
+static int client_serve(struct http_client_ctx *ctx)
+{
+	int ret;
+
+	while (true) {
+		if (ctx->responding) {
+			ret = client_send(ctx);
+			if (ret == -EAGAIN) {
+				return 0;
+			}
+
+			if (ret < 0) {
+				return ret;
+			}
+
+			ctx->responding = false;
+
+			if (!ctx->keep_alive) {
+				return -ECONNRESET;
+			}
+		}
+
+		if (ctx->data_len == 0) {
+			return 0;
+		}
+
+		if (client_parse(ctx)) {
+			handle_request(ctx);
+		} else if (!ctx->responding) {
+			return 0;
+		}
+	}
+}
+
+static int client_recv(struct http_client_ctx *ctx)
+{
+	ssize_t len;
+
+	len = zsock_recv(ctx->fd, &ctx->buffer[ctx->data_len],
+			 sizeof(ctx->buffer) - ctx->data_len, ZSOCK_MSG_DONTWAIT);
+	if (len < 0) {
+		return errno == EAGAIN ? 0 : -errno;
+	}
+
+	if (len == 0) {
+		/* Connection closed by the client */
+		return -ENOTCONN;
+	}
+
+	ctx->data_len += len;
+	ctx->last_activity = k_uptime_get();
+
+	return client_serve(ctx);
+}
+
+static void client_accept(int service)
+{
+	struct http_client_ctx *ctx = NULL;
+	struct sockaddr addr;
+	socklen_t addrlen = sizeof(addr);
+	int fd;
+	int i;
+
+	fd = zsock_accept(service_fds[service], &addr, &addrlen);
+	if (fd < 0) {
+		NET_ERR("Cannot accept connection (%d)", errno);
+		return;
+	}
+
+	for (i = 0; i < MAX_CLIENTS; i++) {
+		if (clients[i].fd < 0) {
+			ctx = &clients[i];
+			break;
+		}
+	}
+
+	if (ctx == NULL) {
+		NET_DBG("No free client context");
+		(void)zsock_close(fd);
+		return;
+	}
+
+	NET_DBG("[%d] Connection accepted", fd);
+
+	memset(ctx, 0, offsetof(struct http_client_ctx, url));
+	ctx->fd = fd;
+	ctx->service = service;
+	ctx->last_activity = k_uptime_get();
+
+	http_parser_init(&ctx->parser, HTTP_REQUEST);
+
+	service_clients[service]++;
+}
+
+static bool service_full(int service)
+{
+	size_t concurrent = services[service]->concurrent;
+	int i;
+
+	if (concurrent > 0 && service_clients[service] >= concurrent) {
+		return true;
+	}
+
+	for (i = 0; i < MAX_CLIENTS; i++) {
+		if (clients[i].fd < 0) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/* Close the connections that have been inactive for too long, and return
+ * the time until the next one expires.
+ */
+static int client_expire(void)
+{
+	int64_t now = k_uptime_get();
+	int64_t timeout = INT32_MAX;
+	int64_t remaining;
+	int i;
+
+	for (i = 0; i < MAX_CLIENTS; i++) {
+		if (clients[i].fd < 0) {
+			continue;
+		}
+
+		remaining = clients[i].last_activity + INACTIVITY_TIMEOUT - now;
+		if (remaining <= 0) {
+			NET_DBG("[%d] Connection inactive", clients[i].fd);
+			client_close(&clients[i]);
+			continue;
+		}
+
+		timeout = MIN(timeout, remaining);
+	}
+
+	if (event_fd < 0) {
+		timeout = MIN(timeout, STOP_CHECK_INTERVAL);
+	}
+
+	return timeout == INT32_MAX ? -1 : (int)timeout;
+}
+
+static int build_poll_fds(void)
+{
+	int nfds = 0;
+	int i;
+
+	if (event_fd >= 0) {
+		fds[nfds].fd = event_fd;
+		fds[nfds].events = ZSOCK_POLLIN;
+		fd_clients[nfds] = NULL;
+		nfds++;
+	}
+
+	/* A service that has no room for another client is not polled,
+	 * its connections wait in the listen backlog.
+	 */
+	for (i = 0; i < num_services; i++) {
+		fds[nfds].fd = service_full(i) ? -1 : service_fds[i];
+		fds[nfds].events = ZSOCK_POLLIN;
+		fd_clients[nfds] = NULL;
+		nfds++;
+	}
+
+	for (i = 0; i < MAX_CLIENTS; i++) {
+		if (clients[i].fd < 0) {
+			continue;
+		}
+
+		/* Pipelined requests are not read while a response is being
+		 * sent, which bounds the memory used by each client.
+		 */
+		fds[nfds].fd = clients[i].fd;
+		fds[nfds].events = clients[i].responding ? ZSOCK_POLLOUT :
+							  ZSOCK_POLLIN;
+		fd_clients[nfds] = &clients[i];
+		nfds++;
+	}
+
+	return nfds;
+}
+
+static void client_event(struct http_client_ctx *ctx, short revents)
+{
+	int ret;
+
+	if (revents & ZSOCK_POLLIN) {
+		ret = client_recv(ctx);
+	} else if (revents & ZSOCK_POLLOUT) {
+		ret = client_serve(ctx);
+	} else if (revents & (ZSOCK_POLLERR | ZSOCK_POLLHUP | ZSOCK_POLLNVAL)) {
+		ret = -ENOTCONN;
+	} else {
+		return;
+	}
+
+	if (ret < 0) {
+		client_close(ctx);
+	}
+}
+
+static void server_cleanup(void)
+{
+	int i;
+
+	for (i = 0; i < MAX_CLIENTS; i++) {
+		if (clients[i].fd >= 0) {
+			client_close(&clients[i]);
+		}
+	}
+
+	for (i = 0; i < num_services; i++) {
+		(void)zsock_close(service_fds[i]);
+		service_fds[i] = -1;
+	}
+
+	num_services = 0;
+
+	if (event_fd >= 0) {
+		(void)zsock_close(event_fd);
+		event_fd = -1;
+	}
+}
+
+static void http_server_run(void *p1, void *p2, void *p3)
+{
+	int timeout;
+	int nfds;
+	int ret;
+	int i;
+
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (!atomic_get(&stop_requested)) {
+		timeout = client_expire();
+		nfds = build_poll_fds();
+
+		ret = zsock_poll(fds, nfds, timeout);
+		if (ret < 0) {
+			NET_ERR("Poll failed (%d)", errno);
+			break;
+		}
+
+		if (atomic_get(&stop_requested)) {
+			break;
+		}
+
+		for (i = 0; i < nfds; i++) {
+			if (fds[i].revents == 0 || fds[i].fd == event_fd) {
+				continue;
+			}
+
+			if (fd_clients[i] != NULL) {
+				client_event(fd_clients[i], fds[i].revents);
+			} else if (fds[i].revents & ZSOCK_POLLIN) {
+				client_accept(i - (event_fd >= 0 ? 1 : 0));
+			}
+		}
+	}
+
+	server_cleanup();
+
+	NET_DBG("HTTP server stopped");
+}
+
+static int service_listen(const struct http_service_desc *service)
+{
+	struct sockaddr addr;
+	socklen_t addrlen;
+	int optval = 1;
+	int ret;
+	int fd;
+
+	memset(&addr, 0, sizeof(addr));
+
+	/* A host that is not an address is a name or a virtual host, the
+	 * service then listens to all the addresses.
+	 */
+	if (IS_ENABLED(CONFIG_NET_IPV4) &&
+	    zsock_inet_pton(AF_INET, service->host,
+			    &net_sin(&addr)->sin_addr) == 1) {
+		addr.sa_family = AF_INET;
+	} else if (IS_ENABLED(CONFIG_NET_IPV6) &&
+		   zsock_inet_pton(AF_INET6, service->host,
+				   &net_sin6(&addr)->sin6_addr) == 1) {
+		addr.sa_family = AF_INET6;
+	} else {
+		memset(&addr, 0, sizeof(addr));
+		addr.sa_family = IS_ENABLED(CONFIG_NET_IPV4) ? AF_INET : AF_INET6;
+	}
+
+	if (addr.sa_family == AF_INET) {
+		net_sin(&addr)->sin_port = htons(*service->port);
+		addrlen = sizeof(struct sockaddr_in);
+	} else {
+		net_sin6(&addr)->sin6_port = htons(*service->port);
+		addrlen = sizeof(struct sockaddr_in6);
+	}
+
+	fd = zsock_socket(addr.sa_family, SOCK_STREAM, IPPROTO_TCP);
+	if (fd < 0) {
+		return -errno;
+	}
+
+	(void)zsock_setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &optval,
+			       sizeof(optval));
+
+	ret = zsock_bind(fd, &addr, addrlen);
+	if (ret < 0) {
+		ret = -errno;
+		goto fail;
+	}
+
+	ret = zsock_listen(fd, MAX(service->backlog, 1));
+	if (ret < 0) {
+		ret = -errno;
+		goto fail;
+	}
+
+	/* An ephemeral port is written back to the service */
+	if (*service->port == 0U) {
+		ret = zsock_getsockname(fd, &addr, &addrlen);
+		if (ret < 0) {
+			ret = -errno;
+			goto fail;
+		}
+
+		*service->port = ntohs(addr.sa_family == AF_INET ?
+				       net_sin(&addr)->sin_port :
+				       net_sin6(&addr)->sin6_port);
+	}
+
+	NET_DBG("Service %s listening on port %d", service->host,
+		*service->port);
+
+	return fd;
+
+fail:
+	(void)zsock_close(fd);
+
+	return ret;
+}
+
+int http_server_start(void)
+{
+	int ret = 0;
+	int fd;
+	int i;
+
+	k_mutex_lock(&server_lock, K_FOREVER);
+
+	if (server_tid != NULL) {
+		ret = -EALREADY;
+		goto out;
+	}
+
+	for (i = 0; i < MAX_CLIENTS; i++) {
+		clients[i].fd = -1;
+	}
+
+	HTTP_SERVICE_FOREACH(service) {
+		if (num_services == MAX_SERVICES) {
+			NET_ERR("Too many services, see %s",
+				"CONFIG_HTTP_SERVER_MAX_SERVICES");
+			ret = -ENOMEM;
+			goto fail;
+		}
+
+		fd = service_listen(service);
+		if (fd < 0) {
+			NET_ERR("Cannot listen to service %s (%d)",
+				service->host, fd);
+			ret = fd;
+			goto fail;
+		}
+
+		services[num_services] = service;
+		service_fds[num_services] = fd;
+		service_clients[num_services] = 0;
+		num_services++;
+	}
+
+	if (1 + num_services + MAX_CLIENTS > CONFIG_NET_SOCKETS_POLL_MAX) {
+		NET_ERR("Too few poll entries, see %s",
+			"CONFIG_NET_SOCKETS_POLL_MAX");
+		ret = -ENOMEM;
+		goto fail;
+	}
+
+#if defined(CONFIG_EVENTFD)
+	event_fd = eventfd(0, EFD_NONBLOCK);
+	if (event_fd < 0) {
+		NET_DBG("No event descriptor, stop is polled (%d)", errno);
+	}
+#endif
+
+	atomic_clear(&stop_requested);
+
+	server_tid = k_thread_create(&server_thread, server_stack,
+				     K_THREAD_STACK_SIZEOF(server_stack),
+				     http_server_run, NULL, NULL, NULL,
+				     CONFIG_HTTP_SERVER_THREAD_PRIORITY, 0,
+				     K_NO_WAIT);
+	k_thread_name_set(server_tid, "http_server");
+
+	goto out;
+
+fail:
+	server_cleanup();
+out:
+	k_mutex_unlock(&server_lock);
+
+	return ret;
+}
+
+int http_server_stop(void)
+{
+	int ret = 0;
+
+	k_mutex_lock(&server_lock, K_FOREVER);
+
+	if (server_tid == NULL) {
+		ret = -EALREADY;
+		goto out;
+	}
+
+	atomic_set(&stop_requested, 1);
+
+#if defined(CONFIG_EVENTFD)
+	if (event_fd >= 0) {
+		(void)eventfd_write(event_fd, 1);
+	}
+#endif
+
+	ret = k_thread_join(server_tid, K_FOREVER);
+	server_tid = NULL;
+
+out:
+	k_mutex_unlock(&server_lock);
+
+	return ret;
+}
@@ -97,6 +97,18 @@ struct service_node {
 static struct service_node service_node_data[MAX_PERIODIC_SERVICE];
 static sys_slist_t engine_service_list;
 
+/* Observations with a notification scheduled, in a binary min-heap ordered
+ * by event timestamp, so that the engine only looks at the observations
+ * which are due instead of walking all of them on every iteration.
+ */
+static struct observe_node *observe_heap[CONFIG_LWM2M_ENGINE_MAX_OBSERVER];
+static int observe_heap_len;
+static struct k_spinlock observe_heap_lock;
+
+#if defined(CONFIG_LWM2M_ENGINE_NOTIFICATION_STATS)
+static struct lwm2m_notification_stats notification_stats;
+#endif
+
 static K_KERNEL_STACK_DEFINE(engine_thread_stack, CONFIG_LWM2M_ENGINE_STACK_SIZE);
 static struct k_thread engine_thread_data;
 
@@ -393,30 +405,185 @@ static int32_t retransmit_request(struct lwm2m_ctx *client_ctx, const uint32_t t
 
 	return next_retransmission;
 }
-static int32_t engine_next_service_timeout_ms(uint32_t max_timeout, const int64_t timestamp)
+
+/* Observation scheduling */
+
+static inline bool observe_heap_less(int a, int b)
 {
-	struct service_node *srv;
-	uint64_t time_left_ms;
-	uint32_t timeout = max_timeout;
+	return observe_heap[a]->event_timestamp < observe_heap[b]->event_timestamp;
+}
 
-	SYS_SLIST_FOR_EACH_CONTAINER(&engine_service_list, srv, node) {
-		time_left_ms = srv->last_timestamp + srv->min_call_period;
+static void observe_heap_swap(int a, int b)
+{
+	struct observe_node *tmp = observe_heap[a];
 
-		/* service is due */
-		if (time_left_ms < timestamp) {
-			return 0;
+	observe_heap[a] = observe_heap[b];
+	observe_heap[b] = tmp;
+
+	/* Heap positions are stored 1-based, 0 meaning not scheduled */
+	observe_heap[a]->sched_index = a + 1;
+	observe_heap[b]->sched_index = b + 1;
+}
+
+static void observe_heap_up(int i)
+{
+	int parent;
+
+	while (i > 0) {
+		parent = (i - 1) / 2;
+		if (!observe_heap_less(i, parent)) {
+			break;
 		}
 
-		/* service timeout is less than the current timeout */
-		time_left_ms -= timestamp;
-		if (time_left_ms < timeout) {
-			timeout = time_left_ms;
+		observe_heap_swap(i, parent);
+		i = parent;
+	}
+}
+
+static void observe_heap_down(int i)
+{
+	int child;
+
+	while (true) {
+		child = 2 * i + 1;
+		if (child >= observe_heap_len) {
+			break;
+		}
+
+		if (child + 1 < observe_heap_len && observe_heap_less(child + 1, child)) {
+			child++;
 		}
+
+		if (!observe_heap_less(child, i)) {
+			break;
+		}
+
+		observe_heap_swap(i, child);
+		i = child;
 	}
+}
 
-	return timeout;
+static void observe_heap_remove(struct observe_node *obs)
+{
+	int i = obs->sched_index - 1;
+
+	obs->sched_index = 0;
+	observe_heap_len--;
+
+	if (i == observe_heap_len) {
+		return;
+	}
+
+	observe_heap[i] = observe_heap[observe_heap_len];
+	observe_heap[i]->sched_index = i + 1;
+	observe_heap_up(i);
+	observe_heap_down(i);
+}
+
+void lwm2m_engine_observe_schedule(struct observe_node *obs, int64_t timestamp)
+{
+	k_spinlock_key_t key = k_spin_lock(&observe_heap_lock);
+	int i;
+
+	obs->event_timestamp = timestamp;
+
+	if (obs->sched_index) {
+		observe_heap_remove(obs);
+	}
+
+	if (timestamp && observe_heap_len < ARRAY_SIZE(observe_heap)) {
+		i = observe_heap_len++;
+		observe_heap[i] = obs;
+		obs->sched_index = i + 1;
+		observe_heap_up(i);
+	}
+
+	k_spin_unlock(&observe_heap_lock, key);
+}
+
+/* Remove and return the first observation due at @p timestamp, if any. */
+static struct observe_node *observe_heap_pop_due(const int64_t timestamp)
+{
+	k_spinlock_key_t key = k_spin_lock(&observe_heap_lock);
+	struct observe_node *obs = NULL;
+
+	if (observe_heap_len > 0 && observe_heap[0]->event_timestamp <= timestamp) {
+		obs = observe_heap[0];
+		observe_heap_remove(obs);
+	}
+
+	k_spin_unlock(&observe_heap_lock, key);
+
+	return obs;
+}
+
+/* Put back an observation popped by observe_heap_pop_due(). */
+static void observe_heap_push_back(struct observe_node *obs)
+{
+	lwm2m_engine_observe_schedule(obs, obs->event_timestamp);
+}
+
+static int64_t observe_heap_next_timestamp(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&observe_heap_lock);
+	int64_t timestamp = 0;
+
+	if (observe_heap_len > 0) {
+		timestamp = observe_heap[0]->event_timestamp;
+	}
+
+	k_spin_unlock(&observe_heap_lock, key);
+
+	return timestamp;
+}
+
+#if defined(CONFIG_LWM2M_ENGINE_NOTIFICATION_STATS)
+int lwm2m_engine_get_notification_stats(struct lwm2m_notification_stats *stats)
+{
+	k_spinlock_key_t key;
+
+	if (!stats) {
+		return -EINVAL;
+	}
+
+	key = k_spin_lock(&observe_heap_lock);
+	*stats = notification_stats;
+	stats->scheduled = observe_heap_len;
+	k_spin_unlock(&observe_heap_lock, key);
+
+	return 0;
+}
+
+void lwm2m_engine_reset_notification_stats(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&observe_heap_lock);
+
+	(void)memset(&notification_stats, 0, sizeof(notification_stats));
+	k_spin_unlock(&observe_heap_lock, key);
+}
+
+static void notification_stats_update(uint32_t latency_ms)
+{
+	k_spinlock_key_t key = k_spin_lock(&observe_heap_lock);
+
+	notification_stats.notifications++;
+	notification_stats.total_latency_ms += latency_ms;
+	if (latency_ms > notification_stats.max_latency_ms) {
+		notification_stats.max_latency_ms = latency_ms;
+	}
+
+	k_spin_unlock(&observe_heap_lock, key);
 }
 
+static void notification_stats_defer(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&observe_heap_lock);
+
+	notification_stats.deferred++;
+	k_spin_unlock(&observe_heap_lock, key);
+}
+#endif /* CONFIG_LWM2M_ENGINE_NOTIFICATION_STATS */
+
 int lwm2m_engine_add_service(k_work_handler_t service, uint32_t period_ms)
 {
 	int i;
@@ -468,18 +635,24 @@ static int32_t lwm2m_engine_service(const int64_t timestamp)
 {
 	struct service_node *srv;
 	int64_t service_due_timestamp;
+	int64_t timeout = ENGINE_UPDATE_INTERVAL_MS;
 
+	/* Run the services which are due and compute how long to sleep till
+	 * the next service in the same pass.
+	 */
 	SYS_SLIST_FOR_EACH_CONTAINER(&engine_service_list, srv, node) {
 		service_due_timestamp = srv->last_timestamp + srv->min_call_period;
 		/* service is due */
 		if (timestamp >= service_due_timestamp) {
 			srv->last_timestamp = k_uptime_get();
 			srv->service_work(NULL);
+			service_due_timestamp = srv->last_timestamp + srv->min_call_period;
 		}
+
+		timeout = MIN(timeout, MAX(service_due_timestamp - timestamp, 0));
 	}
 
-	/* calculate how long to sleep till the next service */
-	return engine_next_service_timeout_ms(ENGINE_UPDATE_INTERVAL_MS, timestamp);
+	return timeout;
 }
 
 /* LwM2M Socket Integration */
@@ -533,36 +706,116 @@ void lwm2m_socket_del(struct lwm2m_ctx *ctx)
 	}
 }
 
-static void check_notifications(struct lwm2m_ctx *ctx, const int64_t timestamp)
+static bool notification_allowed(struct lwm2m_ctx *ctx)
+{
+	int i;
+
+	if (!ctx || !sys_slist_is_empty(&ctx->pending_sends) ||
+	    !lwm2m_rd_client_is_registred(ctx)) {
+		return false;
+	}
+
+	for (i = 0; i < sock_nfds; i++) {
+		if (sock_ctx[i] == ctx) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/* Number of contexts which can send a notification right now. */
+static int notification_allowed_count(void)
+{
+	int count = 0;
+	int i;
+
+	for (i = 0; i < sock_nfds; i++) {
+		if (notification_allowed(sock_ctx[i])) {
+			count++;
+		}
+	}
+
+	return count;
+}
+
+/* Generate the notifications which are due, and return how long to sleep
+ * till the next one.
+ */
+static int32_t check_notifications(const int64_t timestamp, int32_t timeout)
 {
+	sys_slist_t deferred;
 	struct observe_node *obs;
+	int64_t next;
+	bool pending;
+	int allowed;
 	int rc;
 
+	sys_slist_init(&deferred);
+
 	lwm2m_registry_lock();
-	SYS_SLIST_FOR_EACH_CONTAINER(&ctx->observer, obs, node) {
-		if (!obs->event_timestamp || timestamp < obs->event_timestamp) {
-			continue;
-		}
-		/* Check That There is not pending process*/
-		if (obs->active_tx_operation) {
+
+	/* The due observations of a blocked context stay in the heap, they
+	 * are only popped while some context can still send.
+	 */
+	allowed = notification_allowed_count();
+
+	while (allowed > 0 && (obs = observe_heap_pop_due(timestamp)) != NULL) {
+		/* Check That There is not pending process, the pending send
+		 * check also limits each context to one notification at a time.
+		 */
+		if (obs->active_tx_operation || !notification_allowed(obs->ctx)) {
+#if defined(CONFIG_LWM2M_ENGINE_NOTIFICATION_STATS)
+			notification_stats_defer();
+#endif
+			sys_slist_append(&deferred, &obs->sched_node);
 			continue;
 		}
 
-		rc = generate_notify_message(ctx, obs, NULL);
+		rc = generate_notify_message(obs->ctx, obs, NULL);
 		if (rc == -ENOMEM) {
 			/* no memory/messages available, retry later */
-			goto cleanup;
+			sys_slist_append(&deferred, &obs->sched_node);
+			break;
 		}
-		obs->event_timestamp =
-			engine_observe_shedule_next_event(obs, ctx->srv_obj_inst, timestamp);
-		obs->last_timestamp = timestamp;
+
+#if defined(CONFIG_LWM2M_ENGINE_NOTIFICATION_STATS)
 		if (!rc) {
-			/* create at most one notification */
-			goto cleanup;
+			notification_stats_update(timestamp - obs->event_timestamp);
+		}
+#endif
+
+		lwm2m_engine_observe_schedule(
+			obs, engine_observe_shedule_next_event(obs, obs->ctx->srv_obj_inst,
+							       timestamp));
+		obs->last_timestamp = timestamp;
+
+		if (!notification_allowed(obs->ctx)) {
+			allowed--;
 		}
 	}
-cleanup:
+
+	next = observe_heap_next_timestamp();
+	pending = !sys_slist_is_empty(&deferred);
+
+	/* Deferred observations are still due, they are checked again on the
+	 * next iteration of the socket loop.
+	 */
+	while ((obs = SYS_SLIST_PEEK_HEAD_CONTAINER(&deferred, obs, sched_node)) != NULL) {
+		(void)sys_slist_get_not_empty(&deferred);
+		observe_heap_push_back(obs);
+	}
 	lwm2m_registry_unlock();
+
+	if (pending || (next && next <= timestamp)) {
+		return timeout;
+	}
+
+	if (next && next - timestamp < timeout) {
+		timeout = next - timestamp;
+	}
+
+	return timeout;
 }
 
 static int socket_recv_message(struct lwm2m_ctx *client_ctx)
@@ -692,13 +945,10 @@ static void socket_loop(void)
 					timeout = next_retransmit;
 				}
 			}
-			if (sock_ctx[i] != NULL &&
-			    sys_slist_is_empty(&sock_ctx[i]->pending_sends) &&
-			    lwm2m_rd_client_is_registred(sock_ctx[i])) {
-				check_notifications(sock_ctx[i], timestamp);
-			}
 		}
 
+		timeout = check_notifications(timestamp, timeout);
+
 		socket_reset_pollfd_events();
 
 		/*
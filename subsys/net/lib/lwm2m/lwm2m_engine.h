@@ -94,6 +94,17 @@ int bootstrap_delete(struct lwm2m_message *msg);
  */
 int lwm2m_engine_add_service(k_work_handler_t service, uint32_t period_ms);
 
+/**
+ * @brief Schedules the next notification of the observation @p obs at @p timestamp.
+ *
+ * The engine only checks the observations which are due, so the event timestamp of an
+ * observation must always be updated through this function.
+ *
+ * @param[in] obs Observation to schedule
+ * @param[in] timestamp Uptime of the next notification in ms, 0 to disable it
+ */
+void lwm2m_engine_observe_schedule(struct observe_node *obs, int64_t timestamp);
+
 /**
  * @brief Returns the index in the security objects list corresponding to the object instance
  * id given by @p obj_inst_id
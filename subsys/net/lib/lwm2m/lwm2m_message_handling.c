@@ -430,7 +430,25 @@ void lwm2m_engine_context_close(struct lwm2m_ctx *client_ctx)
 #if defined(CONFIG_LWM2M_QUEUE_MODE_ENABLED)
 	client_ctx->buffer_client_messages = true;
 #endif
+#if defined(CONFIG_LWM2M_SEND_BATCH)
+	(void)k_work_cancel_delayable(&client_ctx->send_batch_work);
+	client_ctx->send_batch_len = 0;
+#endif
+}
+
+#if defined(CONFIG_LWM2M_SEND_BATCH)
+static void send_batch_work_handler(struct k_work *work)
+{
+	struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+	struct lwm2m_ctx *ctx = CONTAINER_OF(dwork, struct lwm2m_ctx, send_batch_work);
+	int ret;
+
+	ret = lwm2m_send_batch_flush(ctx, NULL);
+	if (ret < 0 && ret != -ENODATA) {
+		LOG_ERR("Batched send failed (err:%d)", ret);
+	}
 }
+#endif
 
 void lwm2m_engine_context_init(struct lwm2m_ctx *client_ctx)
 {
@@ -441,6 +459,10 @@ void lwm2m_engine_context_init(struct lwm2m_ctx *client_ctx)
 	client_ctx->buffer_client_messages = true;
 	sys_slist_init(&client_ctx->queued_messages);
 #endif
+#if defined(CONFIG_LWM2M_SEND_BATCH)
+	k_work_init_delayable(&client_ctx->send_batch_work, send_batch_work_handler);
+	client_ctx->send_batch_len = 0;
+#endif
 }
 /* utility functions */
 
@@ -3410,6 +3432,78 @@ cleanup:
 #endif
 }
 
+#if defined(CONFIG_LWM2M_SEND_BATCH)
+int lwm2m_send_batch_flush(struct lwm2m_ctx *ctx, lwm2m_send_cb_t reply_cb)
+{
+	int ret;
+
+	if (!ctx) {
+		return -EINVAL;
+	}
+
+	lwm2m_registry_lock();
+	(void)k_work_cancel_delayable(&ctx->send_batch_work);
+
+	if (ctx->send_batch_len == 0) {
+		ret = -ENODATA;
+	} else {
+		ret = lwm2m_send_cb(ctx, ctx->send_batch, ctx->send_batch_len, reply_cb);
+		/* Keep the paths for the next batch if the Send failed */
+		if (ret == 0) {
+			ctx->send_batch_len = 0;
+		}
+	}
+
+	lwm2m_registry_unlock();
+
+	return ret;
+}
+
+int lwm2m_send_batch(struct lwm2m_ctx *ctx, const struct lwm2m_obj_path path_list[],
+		     uint8_t path_list_size)
+{
+	int ret = 0;
+	int i, j;
+
+	if (!ctx || (!path_list && path_list_size)) {
+		return -EINVAL;
+	}
+
+	lwm2m_registry_lock();
+
+	for (i = 0; i < path_list_size; i++) {
+		for (j = 0; j < ctx->send_batch_len; j++) {
+			if (lwm2m_obj_path_equal(&ctx->send_batch[j], &path_list[i])) {
+				break;
+			}
+		}
+
+		if (j < ctx->send_batch_len) {
+			continue;
+		}
+
+		/* Queue full, send what is queued and start a new batch */
+		if (ctx->send_batch_len == ARRAY_SIZE(ctx->send_batch)) {
+			ret = lwm2m_send_batch_flush(ctx, NULL);
+			if (ret < 0) {
+				break;
+			}
+		}
+
+		ctx->send_batch[ctx->send_batch_len++] = path_list[i];
+	}
+
+	if (ctx->send_batch_len > 0 && !k_work_delayable_is_pending(&ctx->send_batch_work)) {
+		(void)k_work_schedule(&ctx->send_batch_work,
+				      K_MSEC(CONFIG_LWM2M_SEND_BATCH_DELAY_MS));
+	}
+
+	lwm2m_registry_unlock();
+
+	return ret;
+}
+#endif /* CONFIG_LWM2M_SEND_BATCH */
+
 int lwm2m_send(struct lwm2m_ctx *ctx, const struct lwm2m_obj_path path_list[],
 			 uint8_t path_list_size, bool confirmation_request)
 {
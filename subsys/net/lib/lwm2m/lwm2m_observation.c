@@ -367,7 +367,7 @@ int lwm2m_notify_observer_path(const struct lwm2m_obj_path *path)
 
 				if (!obs->event_timestamp || obs->event_timestamp > timestamp) {
 					obs->resource_update = true;
-					obs->event_timestamp = timestamp;
+					lwm2m_engine_observe_schedule(obs, timestamp);
 				}
 
 				LOG_DBG("NOTIFY EVENT %u/%u/%u", path->obj_id, path->obj_inst_id,
@@ -430,11 +430,12 @@ static void engine_observe_node_init(struct observe_node *obs, const uint8_t *to
 	memcpy(obs->token, token, tkl);
 	obs->tkl = tkl;
 
+	obs->ctx = ctx;
 	obs->last_timestamp = k_uptime_get();
 	if (att_pmax) {
-		obs->event_timestamp = obs->last_timestamp + MSEC_PER_SEC * att_pmax;
+		lwm2m_engine_observe_schedule(obs, obs->last_timestamp + MSEC_PER_SEC * att_pmax);
 	} else {
-		obs->event_timestamp = 0;
+		lwm2m_engine_observe_schedule(obs, 0);
 	}
 	obs->resource_update = false;
 	obs->active_tx_operation = false;
@@ -706,6 +707,7 @@ void remove_observer_from_list(struct lwm2m_ctx *ctx, sys_snode_t *prev_node,
 		remove_observer_path_from_list(ctx, obs, o_p, NULL);
 	}
 	sys_slist_remove(&ctx->observer, prev_node, &obs->node);
+	lwm2m_engine_observe_schedule(obs, 0);
 	(void)memset(obs, 0, sizeof(*obs));
 }
 
@@ -936,7 +938,7 @@ static int lwm2m_engine_observer_timestamp_update(sys_slist_t *observer,
 			/* Disable Automatic Notify */
 			timestamp = 0;
 		}
-		obs->event_timestamp = timestamp;
+		lwm2m_engine_observe_schedule(obs, timestamp);
 
 		(void)memset(&nattrs, 0, sizeof(nattrs));
 	}
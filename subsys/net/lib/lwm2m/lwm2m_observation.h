@@ -24,6 +24,9 @@ struct observe_node {
 	bool resource_update : 1;     /* Resource is updated */
 	bool composite : 1;	      /* Composite Observation */
 	bool active_tx_operation : 1; /* Active Notification  process ongoing */
+	struct lwm2m_ctx *ctx;	      /* Context the Observation belongs to */
+	sys_snode_t sched_node;	      /* Deferred by the engine scheduler */
+	uint16_t sched_index;	      /* Position in the engine scheduler + 1 */
 };
 /* Attribute handling. */
 
@@ -18,6 +18,7 @@ LOG_MODULE_REGISTER(LOG_MODULE_NAME);
 #include <inttypes.h>
 #include <ctype.h>
 #include <time.h>
+#include <zephyr/sys/byteorder.h>
 #include <zephyr/sys/util.h>
 #include <zephyr/kernel.h>
 
@@ -29,32 +30,35 @@ LOG_MODULE_REGISTER(LOG_MODULE_NAME);
 #include "lwm2m_object.h"
 #include "lwm2m_rw_senml_cbor.h"
 #include "lwm2m_senml_cbor_decode.h"
-#include "lwm2m_senml_cbor_encode.h"
 #include "lwm2m_senml_cbor_types.h"
 #include "lwm2m_util.h"
 
 #define SENML_MAX_NAME_SIZE sizeof("/65535/65535/")
 
+#define CPKT_CBOR_W_SZ(pos, cpkt) ((size_t)(pos) - (size_t)(cpkt)->data - (size_t)(cpkt)->offset)
+
 struct cbor_out_fmt_data {
-	/* Data */
-	struct lwm2m_senml input;
+	/* Record being formed, encoded as soon as its value is known */
+	struct record record;
+
+	/* Offset of the record array in the output packet */
+	uint16_t array_offset;
+	bool array_started;
+	uint16_t record_count;
 
-	/* Storage for basenames and names ~ sizeof("/65535/65535/") */
-	struct {
-		char names[CONFIG_LWM2M_RW_SENML_CBOR_RECORDS][SENML_MAX_NAME_SIZE];
-		size_t name_sz; /* Name buff size */
-		uint8_t name_cnt;
-	};
+	/* Storage for the basename and name of the record ~ sizeof("/65535/65535/") */
+	char basename[SENML_MAX_NAME_SIZE];
+	char name[SENML_MAX_NAME_SIZE];
+
+	/* Last encoded basename, a record repeating it does not carry it */
+	char last_basename[SENML_MAX_NAME_SIZE];
+	size_t last_basename_len;
 
 	/* Basetime for Cached data timestamp */
 	time_t basetime;
 
-	/* Storage for object links */
-	struct {
-		char objlnk[CONFIG_LWM2M_RW_SENML_CBOR_RECORDS][sizeof("65535:65535")];
-		size_t objlnk_sz; /* Object link buff size */
-		uint8_t objlnk_cnt;
-	};
+	/* Storage for the object link of the record */
+	char objlnk[sizeof("65535:65535")];
 };
 
 struct cbor_in_fmt_data {
@@ -78,15 +82,10 @@ static int path_to_string(char *buf, size_t buf_size, const struct lwm2m_obj_pat
  */
 K_MUTEX_DEFINE(fd_mtx);
 
-#define GET_CBOR_FD_NAME(fd) ((fd)->names[(fd)->name_cnt])
 /* Get the current record */
-#define GET_CBOR_FD_REC(fd) \
-	&((fd)->input._lwm2m_senml__record[(fd)->input._lwm2m_senml__record_count])
+#define GET_CBOR_FD_REC(fd) (&(fd)->record)
 /* Get a record */
 #define GET_IN_FD_REC_I(fd, i) &((fd)->dcd._lwm2m_senml__record[i])
-/* Consume the current record */
-#define CONSUME_CBOR_FD_REC(fd) \
-	&((fd)->input._lwm2m_senml__record[(fd)->input._lwm2m_senml__record_count++])
 /* Get CBOR output formatter data */
 #define LWM2M_OFD_CBOR(octx) ((struct cbor_out_fmt_data *)engine_get_out_user_data(octx))
 
@@ -98,9 +97,6 @@ static void setup_out_fmt_data(struct lwm2m_message *msg)
 
 	(void)memset(fd, 0, sizeof(*fd));
 	engine_set_out_user_data(&msg->out, fd);
-	fd->name_sz = SENML_MAX_NAME_SIZE;
-	fd->basetime = 0;
-	fd->objlnk_sz = sizeof("65535:65535");
 }
 
 static void clear_out_fmt_data(struct lwm2m_message *msg)
@@ -127,32 +123,161 @@ static void clear_in_fmt_data(struct lwm2m_message *msg)
 	k_mutex_unlock(&fd_mtx);
 }
 
-static int fmt_range_check(struct cbor_out_fmt_data *fd)
+/* The record array header is written before the first record with room for up to 23
+ * records, and widened by put_end() if more records were written.
+ */
+static int put_array_start(struct cbor_out_fmt_data *fd, struct coap_packet *cpkt)
 {
-	if (fd->name_cnt >= CONFIG_LWM2M_RW_SENML_CBOR_RECORDS ||
-	    fd->objlnk_cnt >= CONFIG_LWM2M_RW_SENML_CBOR_RECORDS ||
-	    fd->input._lwm2m_senml__record_count >= CONFIG_LWM2M_RW_SENML_CBOR_RECORDS) {
-		LOG_ERR("CONFIG_LWM2M_RW_SENML_CBOR_RECORDS too small");
+	if (fd->array_started) {
+		return 0;
+	}
+
+	if (CPKT_BUF_W_SIZE(cpkt) < 1) {
 		return -ENOMEM;
 	}
 
+	fd->array_offset = cpkt->offset;
+	fd->array_started = true;
+
+	*CPKT_BUF_W_PTR(cpkt) = 0x80; /* 80 # array(0) */
+	cpkt->offset++;
+
 	return 0;
 }
 
-static int put_basename(struct lwm2m_output_context *out, struct lwm2m_obj_path *path)
+static bool encode_record(zcbor_state_t *state, struct cbor_out_fmt_data *fd)
+{
+	struct record *record = GET_CBOR_FD_REC(fd);
+	struct record_union_ *value = &record->_record_union;
+	size_t entries = 1;
+
+	/* Basename applies to the succeeding records until a new one is given */
+	if (record->_record_bn_present) {
+		if (record->_record_bn._record_bn.len == fd->last_basename_len &&
+		    memcmp(record->_record_bn._record_bn.value, fd->last_basename,
+			   fd->last_basename_len) == 0) {
+			record->_record_bn_present = false;
+		} else {
+			memcpy(fd->last_basename, record->_record_bn._record_bn.value,
+			       record->_record_bn._record_bn.len);
+			fd->last_basename_len = record->_record_bn._record_bn.len;
+		}
+	}
+
+	entries += record->_record_bn_present + record->_record_bt_present +
+		   record->_record_n_present + record->_record_t_present;
+
+	/* Keys in the same order as the generated encoder */
+	if (!zcbor_map_start_encode(state, entries)) {
+		return false;
+	}
+
+	if (record->_record_bn_present &&
+	    !(zcbor_int32_put(state, lwm2m_senml_cbor_key_bn) &&
+	      zcbor_tstr_encode(state, &record->_record_bn._record_bn))) {
+		return false;
+	}
+
+	if (record->_record_bt_present &&
+	    !(zcbor_int32_put(state, lwm2m_senml_cbor_key_bt) &&
+	      zcbor_int64_put(state, record->_record_bt._record_bt))) {
+		return false;
+	}
+
+	if (record->_record_n_present &&
+	    !(zcbor_int32_put(state, lwm2m_senml_cbor_key_n) &&
+	      zcbor_tstr_encode(state, &record->_record_n._record_n))) {
+		return false;
+	}
+
+	if (record->_record_t_present &&
+	    !(zcbor_int32_put(state, lwm2m_senml_cbor_key_t) &&
+	      zcbor_int64_put(state, record->_record_t._record_t))) {
+		return false;
+	}
+
+	switch (value->_record_union_choice) {
+	case _union_vi:
+		if (!(zcbor_int32_put(state, lwm2m_senml_cbor_key_vi) &&
+		      zcbor_int64_put(state, value->_union_vi))) {
+			return false;
+		}
+		break;
+	case _union_vf:
+		if (!(zcbor_int32_put(state, lwm2m_senml_cbor_key_vf) &&
+		      zcbor_float64_put(state, value->_union_vf))) {
+			return false;
+		}
+		break;
+	case _union_vs:
+		if (!(zcbor_int32_put(state, lwm2m_senml_cbor_key_vs) &&
+		      zcbor_tstr_encode(state, &value->_union_vs))) {
+			return false;
+		}
+		break;
+	case _union_vb:
+		if (!(zcbor_int32_put(state, lwm2m_senml_cbor_key_vb) &&
+		      zcbor_bool_put(state, value->_union_vb))) {
+			return false;
+		}
+		break;
+	case _union_vd:
+		if (!(zcbor_int32_put(state, lwm2m_senml_cbor_key_vd) &&
+		      zcbor_bstr_encode(state, &value->_union_vd))) {
+			return false;
+		}
+		break;
+	case _union_vlo:
+		if (!(zcbor_tstr_put_lit(state, "vlo") &&
+		      zcbor_tstr_encode(state, &value->_union_vlo))) {
+			return false;
+		}
+		break;
+	default:
+		return false;
+	}
+
+	return zcbor_map_end_encode(state, entries);
+}
+
+/* Encode the current record straight into the output packet */
+static int put_record(struct lwm2m_output_context *out)
 {
 	struct cbor_out_fmt_data *fd = LWM2M_OFD_CBOR(out);
 	int len;
 	int ret;
 
-	ret = fmt_range_check(fd);
+	ret = put_array_start(fd, out->out_cpkt);
 	if (ret < 0) {
 		return ret;
 	}
 
-	char *basename = GET_CBOR_FD_NAME(fd);
+	ZCBOR_STATE_E(states, 1, CPKT_BUF_W_PTR(out->out_cpkt), CPKT_BUF_W_SIZE(out->out_cpkt), 1);
+
+	if (!encode_record(states, fd)) {
+		LOG_ERR("unable to encode senml cbor record");
+		return -ENOMEM;
+	}
+
+	len = CPKT_CBOR_W_SZ(states[0].payload, out->out_cpkt);
+	out->out_cpkt->offset += len;
+	fd->record_count++;
+
+	/* Next record */
+	(void)memset(GET_CBOR_FD_REC(fd), 0, sizeof(struct record));
+
+	return len;
+}
+
+static int put_basename(struct lwm2m_output_context *out, struct lwm2m_obj_path *path)
+{
+	struct cbor_out_fmt_data *fd = LWM2M_OFD_CBOR(out);
+	int len;
+
+	char *basename = fd->basename;
 
-	len = path_to_string(basename, fd->name_sz, path, LWM2M_PATH_LEVEL_OBJECT_INST);
+	len = path_to_string(basename, sizeof(fd->basename), path,
+			     LWM2M_PATH_LEVEL_OBJECT_INST);
 
 	if (len < 0) {
 		return len;
@@ -170,8 +295,6 @@ static int put_basename(struct lwm2m_output_context *out, struct lwm2m_obj_path
 		return -EINVAL;
 	}
 
-	fd->name_cnt++;
-
 	return 0;
 }
 
@@ -179,35 +302,58 @@ static int put_empty_array(struct lwm2m_output_context *out)
 {
 	int len = 1;
 
+	if (CPKT_BUF_W_SIZE(out->out_cpkt) < len) {
+		return -ENOMEM;
+	}
+
 	memset(CPKT_BUF_W_PTR(out->out_cpkt), 0x80, len); /* 80 # array(0) */
 	out->out_cpkt->offset += len;
 
 	return len;
 }
 
-static int put_end(struct lwm2m_output_context *out, struct lwm2m_obj_path *path)
+static int put_begin(struct lwm2m_output_context *out, struct lwm2m_obj_path *path)
 {
-	size_t len;
-	struct lwm2m_senml *input = &(LWM2M_OFD_CBOR(out)->input);
+	return put_array_start(LWM2M_OFD_CBOR(out), out->out_cpkt);
+}
 
-	if (!input->_lwm2m_senml__record_count) {
-		len = put_empty_array(out);
+static int put_end(struct lwm2m_output_context *out, struct lwm2m_obj_path *path)
+{
+	struct cbor_out_fmt_data *fd = LWM2M_OFD_CBOR(out);
+	struct coap_packet *cpkt = out->out_cpkt;
+	uint8_t *array = cpkt->data + fd->array_offset;
+	size_t hdr_len;
 
-		return len;
+	if (!fd->array_started) {
+		return put_empty_array(out);
 	}
 
-	uint_fast8_t ret =
-		cbor_encode_lwm2m_senml(CPKT_BUF_W_REGION(out->out_cpkt), input, &len);
+	if (fd->record_count < 24) {
+		*array = 0x80 | fd->record_count;
+
+		return cpkt->offset - fd->array_offset;
+	}
 
-	if (ret != ZCBOR_SUCCESS) {
+	/* Widen the array header, the records were written after one byte */
+	hdr_len = fd->record_count <= UINT8_MAX ? 2 : 3;
+	if (CPKT_BUF_W_SIZE(cpkt) < hdr_len - 1) {
 		LOG_ERR("unable to encode senml cbor msg");
+		return -ENOMEM;
+	}
+
+	memmove(array + hdr_len, array + 1, cpkt->offset - fd->array_offset - 1);
 
-		return -E2BIG;
+	if (hdr_len == 2) {
+		array[0] = 0x98;
+		array[1] = fd->record_count;
+	} else {
+		array[0] = 0x99;
+		sys_put_be16(fd->record_count, &array[1]);
 	}
 
-	out->out_cpkt->offset += len;
+	cpkt->offset += hdr_len - 1;
 
-	return len;
+	return cpkt->offset - fd->array_offset;
 }
 
 static int put_begin_oi(struct lwm2m_output_context *out, struct lwm2m_obj_path *path)
@@ -228,14 +374,8 @@ static int put_begin_r(struct lwm2m_output_context *out, struct lwm2m_obj_path *
 {
 	struct cbor_out_fmt_data *fd = LWM2M_OFD_CBOR(out);
 	int len;
-	int ret;
 
-	ret = fmt_range_check(fd);
-	if (ret < 0) {
-		return ret;
-	}
-
-	char *name = GET_CBOR_FD_NAME(fd);
+	char *name = fd->name;
 
 	/* Write resource name */
 	len = snprintk(name, sizeof("65535"), "%" PRIu16 "", path->res_id);
@@ -245,16 +385,6 @@ static int put_begin_r(struct lwm2m_output_context *out, struct lwm2m_obj_path *
 		return -EINVAL;
 	}
 
-	/* Check if we could use an already existing name
-	 * -> latest name slot is used as a scratchpad
-	 */
-	for (int idx = 0; idx < fd->name_cnt; idx++) {
-		if (strncmp(name, fd->names[idx], len) == 0) {
-			name = fd->names[idx];
-			break;
-		}
-	}
-
 	/* Tell CBOR encoder where to find the name */
 	struct record *record = GET_CBOR_FD_REC(fd);
 
@@ -262,13 +392,6 @@ static int put_begin_r(struct lwm2m_output_context *out, struct lwm2m_obj_path *
 	record->_record_n._record_n.len = len;
 	record->_record_n_present = 1;
 
-	/* Makes possible to use same slot for storing r/ri name combination.
-	 * No need to increase the name count if an existing name has been used
-	 */
-	if (path->level < LWM2M_PATH_LEVEL_RESOURCE_INST && name == GET_CBOR_FD_NAME(fd)) {
-		fd->name_cnt++;
-	}
-
 	return 0;
 }
 
@@ -276,12 +399,6 @@ static int put_data_timestamp(struct lwm2m_output_context *out, time_t value)
 {
 	struct record *out_record;
 	struct cbor_out_fmt_data *fd = LWM2M_OFD_CBOR(out);
-	int ret;
-
-	ret = fmt_range_check(fd);
-	if (ret < 0) {
-		return ret;
-	}
 
 	/* Tell CBOR encoder where to find the name */
 	out_record = GET_CBOR_FD_REC(fd);
@@ -302,14 +419,8 @@ static int put_data_timestamp(struct lwm2m_output_context *out, time_t value)
 static int put_begin_ri(struct lwm2m_output_context *out, struct lwm2m_obj_path *path)
 {
 	struct cbor_out_fmt_data *fd = LWM2M_OFD_CBOR(out);
-	char *name = GET_CBOR_FD_NAME(fd);
+	char *name = fd->name;
 	struct record *record = GET_CBOR_FD_REC(fd);
-	int ret;
-
-	ret = fmt_range_check(fd);
-	if (ret < 0) {
-		return ret;
-	}
 
 	/* Forms name from resource id and resource instance id */
 	int len = snprintk(name, SENML_MAX_NAME_SIZE,
@@ -321,26 +432,11 @@ static int put_begin_ri(struct lwm2m_output_context *out, struct lwm2m_obj_path
 		return -EINVAL;
 	}
 
-	/* Check if we could use an already existing name
-	 * -> latest name slot is used as a scratchpad
-	 */
-	for (int idx = 0; idx < fd->name_cnt; idx++) {
-		if (strncmp(name, fd->names[idx], len) == 0) {
-			name = fd->names[idx];
-			break;
-		}
-	}
-
 	/* Tell CBOR encoder where to find the name */
 	record->_record_n._record_n.value = name;
 	record->_record_n._record_n.len = len;
 	record->_record_n_present = 1;
 
-	/* No need to increase the name count if an existing name has been used */
-	if (name == GET_CBOR_FD_NAME(fd)) {
-		fd->name_cnt++;
-	}
-
 	return 0;
 }
 
@@ -369,14 +465,14 @@ static int put_value(struct lwm2m_output_context *out, struct lwm2m_obj_path *pa
 		return ret;
 	}
 
-	struct record *record = CONSUME_CBOR_FD_REC(LWM2M_OFD_CBOR(out));
+	struct record *record = GET_CBOR_FD_REC(LWM2M_OFD_CBOR(out));
 
 	/* Write the value */
 	record->_record_union._record_union_choice = _union_vi;
 	record->_record_union._union_vi = value;
 	record->_record_union_present = 1;
 
-	return 0;
+	return put_record(out);
 }
 
 static int put_s8(struct lwm2m_output_context *out, struct lwm2m_obj_path *path, int8_t value)
@@ -401,20 +497,7 @@ static int put_s64(struct lwm2m_output_context *out, struct lwm2m_obj_path *path
 
 static int put_time(struct lwm2m_output_context *out, struct lwm2m_obj_path *path, time_t value)
 {
-	int ret = put_name_nth_ri(out, path);
-
-	if (ret < 0) {
-		return ret;
-	}
-
-	struct record *record = CONSUME_CBOR_FD_REC(LWM2M_OFD_CBOR(out));
-
-	/* Write the value */
-	record->_record_union._record_union_choice = _union_vi;
-	record->_record_union._union_vi = (int64_t)value;
-	record->_record_union_present = 1;
-
-	return 0;
+	return put_value(out, path, (int64_t)value);
 }
 
 static int put_float(struct lwm2m_output_context *out, struct lwm2m_obj_path *path, double *value)
@@ -425,14 +508,14 @@ static int put_float(struct lwm2m_output_context *out, struct lwm2m_obj_path *pa
 		return ret;
 	}
 
-	struct record *record = CONSUME_CBOR_FD_REC(LWM2M_OFD_CBOR(out));
+	struct record *record = GET_CBOR_FD_REC(LWM2M_OFD_CBOR(out));
 
 	/* Write the value */
 	record->_record_union._record_union_choice = _union_vf;
 	record->_record_union._union_vf = *value;
 	record->_record_union_present = 1;
 
-	return 0;
+	return put_record(out);
 }
 
 static int put_string(struct lwm2m_output_context *out, struct lwm2m_obj_path *path, char *buf,
@@ -444,7 +527,7 @@ static int put_string(struct lwm2m_output_context *out, struct lwm2m_obj_path *p
 		return ret;
 	}
 
-	struct record *record = CONSUME_CBOR_FD_REC(LWM2M_OFD_CBOR(out));
+	struct record *record = GET_CBOR_FD_REC(LWM2M_OFD_CBOR(out));
 
 	/* Write the value */
 	record->_record_union._record_union_choice = _union_vs;
@@ -452,7 +535,7 @@ static int put_string(struct lwm2m_output_context *out, struct lwm2m_obj_path *p
 	record->_record_union._union_vs.len = buflen;
 	record->_record_union_present = 1;
 
-	return 0;
+	return put_record(out);
 }
 
 static int put_bool(struct lwm2m_output_context *out, struct lwm2m_obj_path *path, bool value)
@@ -463,14 +546,14 @@ static int put_bool(struct lwm2m_output_context *out, struct lwm2m_obj_path *pat
 		return ret;
 	}
 
-	struct record *record = CONSUME_CBOR_FD_REC(LWM2M_OFD_CBOR(out));
+	struct record *record = GET_CBOR_FD_REC(LWM2M_OFD_CBOR(out));
 
 	/* Write the value */
 	record->_record_union._record_union_choice = _union_vb;
 	record->_record_union._union_vb = value;
 	record->_record_union_present = 1;
 
-	return 0;
+	return put_record(out);
 }
 
 static int put_opaque(struct lwm2m_output_context *out, struct lwm2m_obj_path *path, char *buf,
@@ -482,7 +565,7 @@ static int put_opaque(struct lwm2m_output_context *out, struct lwm2m_obj_path *p
 		return ret;
 	}
 
-	struct record *record = CONSUME_CBOR_FD_REC(LWM2M_OFD_CBOR(out));
+	struct record *record = GET_CBOR_FD_REC(LWM2M_OFD_CBOR(out));
 
 	/* Write the value */
 	record->_record_union._record_union_choice = _union_vd;
@@ -490,7 +573,7 @@ static int put_opaque(struct lwm2m_output_context *out, struct lwm2m_obj_path *p
 	record->_record_union._union_vd.len = buflen;
 	record->_record_union_present = 1;
 
-	return 0;
+	return put_record(out);
 }
 
 static int put_objlnk(struct lwm2m_output_context *out, struct lwm2m_obj_path *path,
@@ -499,16 +582,10 @@ static int put_objlnk(struct lwm2m_output_context *out, struct lwm2m_obj_path *p
 	int ret = 0;
 	struct cbor_out_fmt_data *fd = LWM2M_OFD_CBOR(out);
 
-	ret = fmt_range_check(fd);
-	if (ret < 0) {
-		return ret;
-	}
-
 	/* Format object link */
-	int objlnk_idx = fd->objlnk_cnt;
-	char *objlink_buf = fd->objlnk[objlnk_idx];
+	char *objlink_buf = fd->objlnk;
 	int objlnk_len =
-		snprintk(objlink_buf, fd->objlnk_sz, "%u:%u", value->obj_id, value->obj_inst);
+		snprintk(objlink_buf, sizeof(fd->objlnk), "%u:%u", value->obj_id, value->obj_inst);
 	if (objlnk_len < 0) {
 		return -EINVAL;
 	}
@@ -519,7 +596,7 @@ static int put_objlnk(struct lwm2m_output_context *out, struct lwm2m_obj_path *p
 		return ret;
 	}
 
-	struct record *record = CONSUME_CBOR_FD_REC(LWM2M_OFD_CBOR(out));
+	struct record *record = GET_CBOR_FD_REC(fd);
 
 	/* Write the value */
 	record->_record_union._record_union_choice = _union_vlo;
@@ -527,9 +604,7 @@ static int put_objlnk(struct lwm2m_output_context *out, struct lwm2m_obj_path *p
 	record->_record_union._union_vlo.len = objlnk_len;
 	record->_record_union_present = 1;
 
-	fd->objlnk_cnt++;
-
-	return 0;
+	return put_record(out);
 }
 
 static int get_opaque(struct lwm2m_input_context *in,
@@ -778,6 +853,7 @@ static int do_write_op_item(struct lwm2m_message *msg, struct record *rec)
 }
 
 const struct lwm2m_writer senml_cbor_writer = {
+	.put_begin = put_begin,
 	.put_end = put_end,
 	.put_begin_oi = put_begin_oi,
 	.put_begin_r = put_begin_r,
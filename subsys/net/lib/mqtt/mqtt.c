@@ -236,16 +236,267 @@ static int verify_tx_state(const struct mqtt_client *client)
 	return 0;
 }
 
-int mqtt_publish(struct mqtt_client *client,
-		 const struct mqtt_publish_param *param)
+/** Payload of the messages published without payload buffers. */
+static const struct iovec no_payload;
+
+/** @brief Encode a PUBLISH message to be sent with a single sendmsg(). */
+static int publish_msg_encode(struct mqtt_client *client,
+			      const struct mqtt_publish_param *param,
+			      const struct iovec *payload, size_t payload_count,
+			      struct iovec *io_vector, struct msghdr *msg)
 {
+	struct buf_ctx packet;
+	uint32_t payload_len = 0U;
+	size_t header_len;
+	size_t count = 0;
+	size_t i;
 	int err_code;
+
+	if (payload_count > CONFIG_MQTT_PUBLISH_MAX_PAYLOAD_IOV) {
+		return -EINVAL;
+	}
+
+	for (i = 0; i < payload_count; i++) {
+		/* Remaining length of the packet is limited to 28 bits. */
+		if (payload[i].iov_len > MQTT_MAX_PAYLOAD_SIZE - payload_len) {
+			return -EMSGSIZE;
+		}
+
+		payload_len += payload[i].iov_len;
+	}
+
+	tx_buf_init(client, &packet);
+
+	err_code = publish_header_encode(param, payload_len, &packet);
+	if (err_code < 0) {
+		return err_code;
+	}
+
+	/* Fixed header and topic length. */
+	header_len = packet.end - packet.cur;
+	if (param->message.topic.qos) {
+		header_len -= sizeof(uint16_t);
+	}
+
+	io_vector[count].iov_base = packet.cur;
+	io_vector[count].iov_len = header_len;
+	count++;
+
+	io_vector[count].iov_base = (void *)param->message.topic.topic.utf8;
+	io_vector[count].iov_len = param->message.topic.topic.size;
+	count++;
+
+	if (param->message.topic.qos) {
+		io_vector[count].iov_base = packet.cur + header_len;
+		io_vector[count].iov_len = sizeof(uint16_t);
+		count++;
+	}
+
+	for (i = 0; i < payload_count; i++) {
+		io_vector[count++] = payload[i];
+	}
+
+	memset(msg, 0, sizeof(*msg));
+
+	msg->msg_iov = io_vector;
+	msg->msg_iovlen = count;
+
+	return 0;
+}
+
+static struct mqtt_inflight *inflight_find(struct mqtt_client *client,
+					   uint16_t message_id)
+{
+	uint8_t i;
+
+	for (i = 0U; i < client->internal.inflight_count; i++) {
+		if (client->inflight[i].message_id == message_id) {
+			return &client->inflight[i];
+		}
+	}
+
+	return NULL;
+}
+
+static int inflight_add(struct mqtt_client *client,
+			const struct mqtt_publish_param *param,
+			const struct iovec *payload, size_t payload_count)
+{
+	struct mqtt_inflight *entry;
+
+	if (client->inflight == NULL ||
+	    param->message.topic.qos == MQTT_QOS_0_AT_MOST_ONCE) {
+		return 0;
+	}
+
+	if (inflight_find(client, param->message_id) != NULL) {
+		return -EBUSY;
+	}
+
+	if (client->internal.inflight_count >= client->inflight_size) {
+		return -EAGAIN;
+	}
+
+	/* Entries are kept in publication order, for retransmission. */
+	entry = &client->inflight[client->internal.inflight_count++];
+
+	entry->topic = param->message.topic;
+	entry->message_id = param->message_id;
+	entry->retain_flag = param->retain_flag;
+	entry->released = 0U;
+
+	if (payload == NULL) {
+		entry->payload.iov_base = param->message.payload.data;
+		entry->payload.iov_len = param->message.payload.len;
+		entry->payload_iov = NULL;
+		entry->payload_count = 1;
+	} else {
+		entry->payload_iov = payload;
+		entry->payload_count = payload_count;
+	}
+
+	return 0;
+}
+
+static void inflight_remove(struct mqtt_client *client,
+			    struct mqtt_inflight *entry)
+{
+	struct mqtt_inflight *end =
+		&client->inflight[client->internal.inflight_count];
+
+	memmove(entry, entry + 1, (end - entry - 1) * sizeof(*entry));
+	client->internal.inflight_count--;
+}
+
+void mqtt_inflight_ack(struct mqtt_client *client, uint8_t type,
+		       uint16_t message_id)
+{
+	struct mqtt_inflight *entry;
+
+	if (client->inflight == NULL) {
+		return;
+	}
+
+	entry = inflight_find(client, message_id);
+	if (entry == NULL) {
+		NET_DBG("[CID %p]: Unknown message id 0x%04x acknowledged",
+			client, message_id);
+		return;
+	}
+
+	switch (type) {
+	case MQTT_PKT_TYPE_PUBACK:
+		if (entry->topic.qos == MQTT_QOS_1_AT_LEAST_ONCE) {
+			inflight_remove(client, entry);
+		}
+		break;
+
+	case MQTT_PKT_TYPE_PUBREC:
+		if (entry->topic.qos == MQTT_QOS_2_EXACTLY_ONCE) {
+			entry->released = 1U;
+		}
+		break;
+
+	case MQTT_PKT_TYPE_PUBCOMP:
+		if (entry->released) {
+			inflight_remove(client, entry);
+		}
+		break;
+
+	default:
+		break;
+	}
+}
+
+void mqtt_inflight_drop(struct mqtt_client *client)
+{
+	struct mqtt_evt evt = {
+		.type = MQTT_EVT_INFLIGHT_DROPPED,
+	};
+	uint8_t count = client->internal.inflight_count;
+
+	/* Messages published again from the event handler are added after
+	 * the dropped ones.
+	 */
+	while (count-- > 0U) {
+		evt.param.inflight_dropped.message_id =
+			client->inflight[0].message_id;
+
+		NET_DBG("[CID %p]: Dropping message id 0x%04x", client,
+			evt.param.inflight_dropped.message_id);
+
+		inflight_remove(client, &client->inflight[0]);
+		event_notify(client, &evt);
+	}
+}
+
+int mqtt_inflight_resend(struct mqtt_client *client)
+{
+	struct iovec io_vector[3 + CONFIG_MQTT_PUBLISH_MAX_PAYLOAD_IOV];
+	struct mqtt_inflight *entry;
 	struct buf_ctx packet;
-	struct iovec io_vector[2];
 	struct msghdr msg;
+	uint8_t i;
+	int err_code;
 
-	NULL_PARAM_CHECK(client);
-	NULL_PARAM_CHECK(param);
+	for (i = 0U; i < client->internal.inflight_count; i++) {
+		entry = &client->inflight[i];
+
+		NET_DBG("[CID %p]: Retransmitting message id 0x%04x", client,
+			entry->message_id);
+
+		if (entry->released) {
+			struct mqtt_pubrel_param param = {
+				.message_id = entry->message_id,
+			};
+
+			tx_buf_init(client, &packet);
+
+			err_code = publish_release_encode(&param, &packet);
+			if (err_code < 0) {
+				return err_code;
+			}
+
+			err_code = mqtt_transport_write(client, packet.cur,
+							packet.end - packet.cur);
+		} else {
+			struct mqtt_publish_param param = {
+				.message.topic = entry->topic,
+				.message_id = entry->message_id,
+				.dup_flag = 1U,
+				.retain_flag = entry->retain_flag,
+			};
+
+			err_code = publish_msg_encode(
+				client, &param,
+				entry->payload_iov ? entry->payload_iov :
+						     &entry->payload,
+				entry->payload_count, io_vector, &msg);
+			if (err_code < 0) {
+				return err_code;
+			}
+
+			err_code = mqtt_transport_write_msg(client, &msg);
+		}
+
+		if (err_code < 0) {
+			return err_code;
+		}
+	}
+
+	client->internal.last_activity = mqtt_sys_tick_in_ms_get();
+
+	return 0;
+}
+
+static int client_publish(struct mqtt_client *client,
+			  const struct mqtt_publish_param *param,
+			  const struct iovec *payload, size_t payload_count)
+{
+	int err_code;
+	struct iovec io_vector[3 + CONFIG_MQTT_PUBLISH_MAX_PAYLOAD_IOV];
+	struct iovec message_payload;
+	struct msghdr msg;
 
 	NET_DBG("[CID %p]:[State 0x%02x]: >> Topic size 0x%08x, "
 		 "Data size 0x%08x", client, client->internal.state,
@@ -254,27 +505,28 @@ int mqtt_publish(struct mqtt_client *client,
 
 	mqtt_mutex_lock(client);
 
-	tx_buf_init(client, &packet);
-
 	err_code = verify_tx_state(client);
 	if (err_code < 0) {
 		goto error;
 	}
 
-	err_code = publish_encode(param, &packet);
+	if (payload == NULL) {
+		message_payload.iov_base = param->message.payload.data;
+		message_payload.iov_len = param->message.payload.len;
+	}
+
+	err_code = publish_msg_encode(client, param,
+				      payload ? payload : &message_payload,
+				      payload ? payload_count : 1,
+				      io_vector, &msg);
 	if (err_code < 0) {
 		goto error;
 	}
 
-	io_vector[0].iov_base = packet.cur;
-	io_vector[0].iov_len = packet.end - packet.cur;
-	io_vector[1].iov_base = param->message.payload.data;
-	io_vector[1].iov_len = param->message.payload.len;
-
-	memset(&msg, 0, sizeof(msg));
-
-	msg.msg_iov = io_vector;
-	msg.msg_iovlen = ARRAY_SIZE(io_vector);
+	err_code = inflight_add(client, param, payload, payload_count);
+	if (err_code < 0) {
+		goto error;
+	}
 
 	err_code = client_write_msg(client, &msg);
 
@@ -287,6 +539,33 @@ error:
 	return err_code;
 }
 
+int mqtt_publish(struct mqtt_client *client,
+		 const struct mqtt_publish_param *param)
+{
+	NULL_PARAM_CHECK(client);
+	NULL_PARAM_CHECK(param);
+
+	return client_publish(client, param, NULL, 0);
+}
+
+int mqtt_publish_iov(struct mqtt_client *client,
+		     const struct mqtt_publish_param *param,
+		     const struct iovec *payload, size_t payload_count)
+{
+	NULL_PARAM_CHECK(client);
+	NULL_PARAM_CHECK(param);
+
+	if (payload == NULL) {
+		if (payload_count > 0) {
+			return -EINVAL;
+		}
+
+		payload = &no_payload;
+	}
+
+	return client_publish(client, param, payload, payload_count);
+}
+
 int mqtt_publish_qos1_ack(struct mqtt_client *client,
 			  const struct mqtt_puback_param *param)
 {
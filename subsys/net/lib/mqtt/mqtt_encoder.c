@@ -432,6 +432,54 @@ int publish_encode(const struct mqtt_publish_param *param, struct buf_ctx *buf)
 	return 0;
 }
 
+int publish_header_encode(const struct mqtt_publish_param *param,
+			  uint32_t payload_len, struct buf_ctx *buf)
+{
+	const uint8_t message_type = MQTT_MESSAGES_OPTIONS(
+			MQTT_PKT_TYPE_PUBLISH, param->dup_flag,
+			param->message.topic.qos, param->retain_flag);
+	int err_code;
+	uint8_t *start;
+
+	/* Message id zero is not permitted by spec. */
+	if ((param->message.topic.qos) && (param->message_id == 0U)) {
+		return -EINVAL;
+	}
+
+	/* Reserve space for fixed header. */
+	buf->cur += MQTT_FIXED_HEADER_MAX_SIZE;
+	start = buf->cur;
+
+	/* Only the topic length is packed, the topic itself is sent from
+	 * the application buffer.
+	 */
+	err_code = pack_uint16(param->message.topic.topic.size, buf);
+	if (err_code != 0) {
+		return err_code;
+	}
+
+	if (param->message.topic.qos) {
+		err_code = pack_uint16(param->message_id, buf);
+		if (err_code != 0) {
+			return err_code;
+		}
+	}
+
+	/* Move the buffer pointer over the topic and the payload to ensure
+	 * that message length in fixed header is encoded correctly.
+	 */
+	buf->cur += param->message.topic.topic.size + payload_len;
+
+	err_code = mqtt_encode_fixed_header(message_type, start, buf);
+	if (err_code != 0) {
+		return err_code;
+	}
+
+	buf->end -= param->message.topic.topic.size + payload_len;
+
+	return 0;
+}
+
 int publish_ack_encode(const struct mqtt_puback_param *param,
 		       struct buf_ctx *buf)
 {
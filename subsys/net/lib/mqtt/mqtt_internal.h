@@ -162,6 +162,33 @@ void event_notify(struct mqtt_client *client, const struct mqtt_evt *evt);
  */
 int mqtt_handle_rx(struct mqtt_client *client);
 
+/**@brief Updates the in-flight window with an acknowledgment of the peer.
+ *
+ * @param[in] client Identifies the client for which the ack was received.
+ * @param[in] type Packet type of the ack, MQTT_PKT_TYPE_PUBACK,
+ *                 MQTT_PKT_TYPE_PUBREC or MQTT_PKT_TYPE_PUBCOMP.
+ * @param[in] message_id Message id of the acknowledged message.
+ */
+void mqtt_inflight_ack(struct mqtt_client *client, uint8_t type,
+		       uint16_t message_id);
+
+/**@brief Retransmits the messages of the in-flight window, after the
+ *        connection to the broker was established again.
+ *
+ * @param[in] client Identifies the client which reconnected.
+ *
+ * @return 0 if the procedure is successful, an error code otherwise.
+ */
+int mqtt_inflight_resend(struct mqtt_client *client);
+
+/**@brief Empties the in-flight window, after the connection to the broker
+ *        was established again without the previous session. The
+ *        application is notified of each dropped message.
+ *
+ * @param[in] client Identifies the client which reconnected.
+ */
+void mqtt_inflight_drop(struct mqtt_client *client);
+
 /**@brief Constructs/encodes Connect packet.
  *
  * @param[in] client Identifies the client for which the procedure is requested.
@@ -191,6 +218,24 @@ int connect_request_encode(const struct mqtt_client *client,
  */
 int publish_encode(const struct mqtt_publish_param *param, struct buf_ctx *buf);
 
+/**@brief Constructs/encodes the header of a Publish packet.
+ *
+ * Unlike @ref publish_encode, the topic is not copied to the buffer. The
+ * encoded frame is made of the fixed header and the topic length, followed
+ * by the topic, the message id (if any) and the payload.
+ *
+ * @param[in] param Publish message parameters.
+ * @param[in] payload_len Total length of the payload.
+ * @param[inout] buf_ctx Pointer to the buffer context structure,
+ *                       containing buffer for the encoded message.
+ *                       As output points to the beginning of the frame and
+ *                       to the end of the message id (if any).
+ *
+ * @return 0 if the procedure is successful, an error code otherwise.
+ */
+int publish_header_encode(const struct mqtt_publish_param *param,
+			  uint32_t payload_len, struct buf_ctx *buf);
+
 /**@brief Constructs/encodes Publish Ack packet.
  *
  * @param[in] param Publish Ack message parameters.
@@ -867,6 +867,138 @@ ssize_t z_vrfy_zsock_sendto(int sock, const void *buf, size_t len, int flags,
 #include <syscalls/zsock_sendto_mrsh.c>
 #endif /* CONFIG_USERSPACE */
 
+#if defined(CONFIG_NET_SOCKETS_SEND_ZEROCOPY)
+struct zsock_zerocopy_info {
+	zsock_send_zerocopy_cb_t cb;
+	void *user_data;
+	const void *data;
+	size_t len;
+};
+
+static void zsock_zerocopy_destroy(struct net_buf *buf)
+{
+	struct zsock_zerocopy_info info =
+		*(struct zsock_zerocopy_info *)net_buf_user_data(buf);
+
+	net_buf_destroy(buf);
+
+	if (info.cb) {
+		info.cb(info.data, info.len, info.user_data);
+	}
+}
+
+NET_BUF_POOL_DEFINE(zsock_zerocopy_pool, CONFIG_NET_SOCKETS_SEND_ZEROCOPY_COUNT,
+		    0, sizeof(struct zsock_zerocopy_info),
+		    zsock_zerocopy_destroy);
+
+static ssize_t zsock_send_zerocopy_ctx(struct net_context *ctx,
+				       struct net_buf *buf, int flags)
+{
+	k_timeout_t timeout = K_FOREVER;
+	uint32_t retry_timeout = WAIT_BUFS_INITIAL_MS;
+	uint64_t buf_timeout = 0;
+	uint64_t end;
+	int status;
+
+	if ((flags & ZSOCK_MSG_DONTWAIT) || sock_is_nonblock(ctx)) {
+		timeout = K_NO_WAIT;
+	} else {
+		net_context_get_option(ctx, NET_OPT_SNDTIMEO, &timeout, NULL);
+		buf_timeout = sys_clock_timeout_end_calc(MAX_WAIT_BUFS);
+	}
+
+	end = sys_clock_timeout_end_calc(timeout);
+
+	/* Register the callback before sending in order to receive the response
+	 * from the peer.
+	 */
+	status = net_context_recv(ctx, zsock_received_cb,
+				  K_NO_WAIT, ctx->user_data);
+	if (status < 0) {
+		errno = -status;
+		return -1;
+	}
+
+	while (1) {
+		status = net_context_send_buf(ctx, buf, NULL, timeout,
+					      ctx->user_data);
+		if (status < 0) {
+			status = send_check_and_wait(ctx, status, buf_timeout,
+						     timeout, &retry_timeout);
+			if (status < 0) {
+				return status;
+			}
+
+			/* Update the timeout value in case loop is repeated. */
+			timeout_recalc(end, &timeout);
+
+			continue;
+		}
+
+		break;
+	}
+
+	return status;
+}
+
+ssize_t zsock_send_zerocopy(int sock, const void *data, size_t len, int flags,
+			    zsock_send_zerocopy_cb_t cb, void *user_data)
+{
+	const struct socket_op_vtable *vtable;
+	struct zsock_zerocopy_info *info;
+	struct net_context *ctx;
+	struct k_mutex *lock;
+	struct net_buf *buf;
+	ssize_t ret;
+
+	if (k_is_user_context()) {
+		errno = EPERM;
+		return -1;
+	}
+
+	ctx = get_sock_vtable(sock, &vtable, &lock);
+	if (ctx == NULL) {
+		errno = EBADF;
+		return -1;
+	}
+
+	/* Only native sockets send net_pkt's that can carry the data */
+	if (vtable != &sock_fd_op_vtable) {
+		errno = EOPNOTSUPP;
+		return -1;
+	}
+
+	buf = net_buf_alloc_with_data(&zsock_zerocopy_pool, (void *)data, len,
+				      K_NO_WAIT);
+	if (buf == NULL) {
+		errno = ENOBUFS;
+		return -1;
+	}
+
+	info = net_buf_user_data(buf);
+	info->cb = cb;
+	info->user_data = user_data;
+	info->data = data;
+	info->len = len;
+
+	(void)k_mutex_lock(lock, K_FOREVER);
+
+	ret = zsock_send_zerocopy_ctx(ctx, buf, flags);
+
+	k_mutex_unlock(lock);
+
+	if (ret < 0) {
+		/* The buffer is still owned by us as the data was not sent,
+		 * no completion is reported for it.
+		 */
+		info->cb = NULL;
+		net_buf_unref(buf);
+	}
+
+	return ret;
+}
+#endif /* CONFIG_NET_SOCKETS_SEND_ZEROCOPY */
+
 size_t msghdr_non_empty_iov_count(const struct msghdr *msg)
 {
 	size_t non_empty_iov_count = 0;
@@ -928,92 +1060,248 @@ ssize_t z_impl_zsock_sendmsg(int sock, const struct msghdr *msg, int flags)
 }
 
 #ifdef CONFIG_USERSPACE
-static inline ssize_t z_vrfy_zsock_sendmsg(int sock,
-					   const struct msghdr *msg,
-					   int flags)
+/* Replace the user pointers of a message header already copied to kernel
+ * memory with kernel copies of the data they point to. On failure the
+ * pointers not yet copied are cleared so sendmsg_free_copy() can be used.
+ */
+static int sendmsg_copy(struct msghdr *msg)
 {
-	struct msghdr msg_copy;
+	struct iovec *iov = msg->msg_iov;
+	void *name = msg->msg_name;
+	void *control = msg->msg_control;
+	size_t size;
 	size_t i;
-	int ret;
 
-	Z_OOPS(z_user_from_copy(&msg_copy, (void *)msg, sizeof(msg_copy)));
-
-	msg_copy.msg_name = NULL;
-	msg_copy.msg_control = NULL;
+	msg->msg_name = NULL;
+	msg->msg_control = NULL;
+	msg->msg_iov = NULL;
 
-	msg_copy.msg_iov = z_user_alloc_from_copy(msg->msg_iov,
-				       msg->msg_iovlen * sizeof(struct iovec));
-	if (!msg_copy.msg_iov) {
-		errno = ENOMEM;
-		goto fail;
-	}
+	if (msg->msg_iovlen > 0) {
+		if (size_mul_overflow(msg->msg_iovlen, sizeof(struct iovec),
+				      &size)) {
+			errno = EINVAL;
+			return -1;
+		}
 
-	for (i = 0; i < msg->msg_iovlen; i++) {
-		msg_copy.msg_iov[i].iov_base =
-			z_user_alloc_from_copy(msg->msg_iov[i].iov_base,
-					       msg->msg_iov[i].iov_len);
-		if (!msg_copy.msg_iov[i].iov_base) {
+		msg->msg_iov = z_user_alloc_from_copy(iov, size);
+		if (msg->msg_iov == NULL) {
 			errno = ENOMEM;
-			goto fail;
+			return -1;
 		}
 
-		msg_copy.msg_iov[i].iov_len = msg->msg_iov[i].iov_len;
+		for (i = 0; i < msg->msg_iovlen; i++) {
+			iov = &msg->msg_iov[i];
+
+			if (iov->iov_len == 0) {
+				iov->iov_base = NULL;
+				continue;
+			}
+
+			iov->iov_base = z_user_alloc_from_copy(iov->iov_base,
+							       iov->iov_len);
+			if (iov->iov_base == NULL) {
+				/* Make sure that the user buffers are not freed */
+				while (++i < msg->msg_iovlen) {
+					msg->msg_iov[i].iov_base = NULL;
+				}
+
+				errno = ENOMEM;
+				return -1;
+			}
+		}
 	}
 
 	if (msg->msg_namelen > 0) {
-		msg_copy.msg_name = z_user_alloc_from_copy(msg->msg_name,
-							   msg->msg_namelen);
-		if (!msg_copy.msg_name) {
+		msg->msg_name = z_user_alloc_from_copy(name, msg->msg_namelen);
+		if (msg->msg_name == NULL) {
 			errno = ENOMEM;
-			goto fail;
+			return -1;
 		}
 	}
 
 	if (msg->msg_controllen > 0) {
-		msg_copy.msg_control = z_user_alloc_from_copy(msg->msg_control,
+		msg->msg_control = z_user_alloc_from_copy(control,
 							  msg->msg_controllen);
-		if (!msg_copy.msg_control) {
+		if (msg->msg_control == NULL) {
 			errno = ENOMEM;
-			goto fail;
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+static void sendmsg_free_copy(struct msghdr *msg)
+{
+	k_free(msg->msg_name);
+	k_free(msg->msg_control);
+
+	if (msg->msg_iov != NULL) {
+		for (size_t i = 0; i < msg->msg_iovlen; i++) {
+			k_free(msg->msg_iov[i].iov_base);
+		}
+
+		k_free(msg->msg_iov);
+	}
+}
+
+static inline ssize_t z_vrfy_zsock_sendmsg(int sock,
+					   const struct msghdr *msg,
+					   int flags)
+{
+	struct msghdr msg_copy;
+	ssize_t ret = -1;
+
+	Z_OOPS(z_user_from_copy(&msg_copy, (void *)msg, sizeof(msg_copy)));
+
+	if (sendmsg_copy(&msg_copy) == 0) {
+		ret = z_impl_zsock_sendmsg(sock,
+					   (const struct msghdr *)&msg_copy,
+					   flags);
+	}
+
+	sendmsg_free_copy(&msg_copy);
+
+	return ret;
+}
+#include <syscalls/zsock_sendmsg_mrsh.c>
+#endif /* CONFIG_USERSPACE */
+
+int zsock_sendmmsg_ctx(struct net_context *ctx, struct mmsghdr *msgvec,
+		       unsigned int vlen, int flags)
+{
+	unsigned int i;
+	ssize_t ret;
+
+	for (i = 0; i < vlen; i++) {
+		ret = zsock_sendmsg_ctx(ctx, &msgvec[i].msg_hdr, flags);
+		if (ret < 0) {
+			/* Report the error only if nothing was sent */
+			return i > 0 ? i : -1;
+		}
+
+		msgvec[i].msg_len = ret;
+	}
+
+	return i;
+}
+
+/* Used for the socket types that do not provide sendmmsg() */
+static int sendmmsg_fallback(void *obj, const struct socket_op_vtable *vtable,
+			     struct mmsghdr *msgvec, unsigned int vlen,
+			     int flags)
+{
+	unsigned int i;
+	ssize_t ret;
+
+	for (i = 0; i < vlen; i++) {
+		ret = vtable->sendmsg(obj, &msgvec[i].msg_hdr, flags);
+		if (ret < 0) {
+			return i > 0 ? i : -1;
 		}
+
+		msgvec[i].msg_len = ret;
+	}
+
+	return i;
+}
+
+int z_impl_zsock_sendmmsg(int sock, struct mmsghdr *msgvec,
+			  unsigned int vlen, int flags)
+{
+	const struct socket_op_vtable *vtable;
+	struct k_mutex *lock;
+	void *obj;
+	int ret;
+
+	obj = get_sock_vtable(sock, &vtable, &lock);
+	if (obj == NULL) {
+		errno = EBADF;
+		return -1;
 	}
 
-	ret = z_impl_zsock_sendmsg(sock, (const struct msghdr *)&msg_copy,
-				   flags);
+	if (vtable->sendmmsg == NULL && vtable->sendmsg == NULL) {
+		errno = EOPNOTSUPP;
+		return -1;
+	}
 
-	k_free(msg_copy.msg_name);
-	k_free(msg_copy.msg_control);
+	(void)k_mutex_lock(lock, K_FOREVER);
 
-	for (i = 0; i < msg_copy.msg_iovlen; i++) {
-		k_free(msg_copy.msg_iov[i].iov_base);
+	if (vtable->sendmmsg != NULL) {
+		ret = vtable->sendmmsg(obj, msgvec, vlen, flags);
+	} else {
+		ret = sendmmsg_fallback(obj, vtable, msgvec, vlen, flags);
 	}
 
-	k_free(msg_copy.msg_iov);
+	k_mutex_unlock(lock);
 
 	return ret;
+}
 
-fail:
-	if (msg_copy.msg_name) {
-		k_free(msg_copy.msg_name);
+#ifdef CONFIG_USERSPACE
+static inline int z_vrfy_zsock_sendmmsg(int sock, struct mmsghdr *msgvec,
+					unsigned int vlen, int flags)
+{
+	struct mmsghdr *msgvec_copy;
+	bool fault = false;
+	unsigned int i;
+	size_t size;
+	int ret = -1;
+
+	if (vlen == 0) {
+		return z_impl_zsock_sendmmsg(sock, NULL, 0, flags);
 	}
 
-	if (msg_copy.msg_control) {
-		k_free(msg_copy.msg_control);
+	if (size_mul_overflow(vlen, sizeof(struct mmsghdr), &size)) {
+		errno = EINVAL;
+		return -1;
 	}
 
-	if (msg_copy.msg_iov) {
-		for (i = 0; i < msg_copy.msg_iovlen; i++) {
-			if (msg_copy.msg_iov[i].iov_base) {
-				k_free(msg_copy.msg_iov[i].iov_base);
-			}
+	msgvec_copy = z_user_alloc_from_copy(msgvec, size);
+	if (msgvec_copy == NULL) {
+		errno = ENOMEM;
+		return -1;
+	}
+
+	/* The whole batch is copied to kernel memory first so that it is
+	 * sent with a single call, holding the socket lock only once.
+	 */
+	for (i = 0; i < vlen; i++) {
+		if (sendmsg_copy(&msgvec_copy[i].msg_hdr) < 0) {
+			break;
 		}
+	}
 
-		k_free(msg_copy.msg_iov);
+	if (i == vlen) {
+		ret = z_impl_zsock_sendmmsg(sock, msgvec_copy, vlen, flags);
+	} else {
+		/* Make sure that the not yet processed entries are not freed */
+		while (++i < vlen) {
+			msgvec_copy[i].msg_hdr.msg_name = NULL;
+			msgvec_copy[i].msg_hdr.msg_control = NULL;
+			msgvec_copy[i].msg_hdr.msg_iov = NULL;
+		}
 	}
 
-	return -1;
+	for (i = 0; ret > 0 && i < (unsigned int)ret; i++) {
+		if (z_user_to_copy(&msgvec[i].msg_len, &msgvec_copy[i].msg_len,
+				   sizeof(msgvec[i].msg_len)) != 0) {
+			fault = true;
+			break;
+		}
+	}
+
+	for (i = 0; i < vlen; i++) {
+		sendmsg_free_copy(&msgvec_copy[i].msg_hdr);
+	}
+
+	k_free(msgvec_copy);
+
+	Z_OOPS(fault);
+
+	return ret;
 }
-#include <syscalls/zsock_sendmsg_mrsh.c>
+#include <syscalls/zsock_sendmmsg_mrsh.c>
 #endif /* CONFIG_USERSPACE */
 
 static int sock_get_pkt_src_addr(struct net_pkt *pkt,
@@ -1179,17 +1467,12 @@ int zsock_wait_data(struct net_context *ctx, k_timeout_t *timeout)
 	return 0;
 }
 
-static inline ssize_t zsock_recv_dgram(struct net_context *ctx,
-				       void *buf,
-				       size_t max_len,
-				       int flags,
-				       struct sockaddr *src_addr,
-				       socklen_t *addrlen)
+/* Get the next datagram from the socket receive queue, waiting for it
+ * if needed. With ZSOCK_MSG_PEEK the datagram is left in the queue.
+ */
+static struct net_pkt *zsock_dgram_get_pkt(struct net_context *ctx, int flags)
 {
 	k_timeout_t timeout = K_FOREVER;
-	size_t recv_len = 0;
-	size_t read_len;
-	struct net_pkt_cursor backup;
 	struct net_pkt *pkt;
 
 	if ((flags & ZSOCK_MSG_DONTWAIT) || sock_is_nonblock(ctx)) {
@@ -1202,7 +1485,7 @@ static inline ssize_t zsock_recv_dgram(struct net_context *ctx,
 		ret = zsock_wait_data(ctx, &timeout);
 		if (ret < 0) {
 			errno = -ret;
-			return -1;
+			return NULL;
 		}
 	}
 
@@ -1213,269 +1496,778 @@ static inline ssize_t zsock_recv_dgram(struct net_context *ctx,
 		/* EAGAIN when timeout expired, EINTR when cancelled */
 		if (res && res != -EAGAIN && res != -EINTR) {
 			errno = -res;
-			return -1;
+			return NULL;
+		}
+
+		pkt = k_fifo_peek_head(&ctx->recv_q);
+	} else {
+		pkt = k_fifo_get(&ctx->recv_q, timeout);
+	}
+
+	if (!pkt) {
+		errno = EAGAIN;
+		return NULL;
+	}
+
+	return pkt;
+}
+
+static int zsock_dgram_src_addr(struct net_context *ctx, struct net_pkt *pkt,
+				struct sockaddr *src_addr, socklen_t *addrlen)
+{
+	if (IS_ENABLED(CONFIG_NET_OFFLOAD) &&
+	    net_if_is_ip_offloaded(net_context_get_iface(ctx))) {
+		/*
+		 * Packets from offloaded IP stack do not have IP
+		 * headers, so src address cannot be figured out at this
+		 * point. The best we can do is returning remote address
+		 * if that was set using connect() call.
+		 */
+		if (ctx->flags & NET_CONTEXT_REMOTE_ADDR_SET) {
+			memcpy(src_addr, &ctx->remote,
+			       MIN(*addrlen, sizeof(ctx->remote)));
+		} else {
+			return -ENOTSUP;
 		}
+	} else {
+		int rv;
+
+		rv = sock_get_pkt_src_addr(pkt, net_context_get_proto(ctx),
+					   src_addr, *addrlen);
+		if (rv < 0) {
+			LOG_ERR("sock_get_pkt_src_addr %d", rv);
+			return rv;
+		}
+	}
+
+	/* addrlen is a value-result argument, set to actual
+	 * size of source address
+	 */
+	if (src_addr->sa_family == AF_INET) {
+		*addrlen = sizeof(struct sockaddr_in);
+	} else if (src_addr->sa_family == AF_INET6) {
+		*addrlen = sizeof(struct sockaddr_in6);
+	} else {
+		return -ENOTSUP;
+	}
+
+	return 0;
+}
+
+static ssize_t zsock_recv_dgram_iov(struct net_context *ctx,
+				    const struct iovec *iov,
+				    size_t iovlen,
+				    int flags,
+				    struct sockaddr *src_addr,
+				    socklen_t *addrlen)
+{
+	size_t recv_len = 0;
+	size_t read_len = 0;
+	struct net_pkt_cursor backup;
+	struct net_pkt *pkt;
+
+	pkt = zsock_dgram_get_pkt(ctx, flags);
+	if (!pkt) {
+		return -1;
+	}
+
+	net_pkt_cursor_backup(pkt, &backup);
+
+	if (src_addr && addrlen) {
+		int rv;
+
+		rv = zsock_dgram_src_addr(ctx, pkt, src_addr, addrlen);
+		if (rv < 0) {
+			errno = -rv;
+			goto fail;
+		}
+	}
+
+	recv_len = net_pkt_remaining_data(pkt);
+
+	for (size_t i = 0; i < iovlen && read_len < recv_len; i++) {
+		size_t len = MIN(iov[i].iov_len, recv_len - read_len);
+
+		if (net_pkt_read(pkt, iov[i].iov_base, len)) {
+			errno = ENOBUFS;
+			goto fail;
+		}
+
+		read_len += len;
+	}
+
+	if (IS_ENABLED(CONFIG_NET_PKT_RXTIME_STATS) &&
+	    !(flags & ZSOCK_MSG_PEEK)) {
+		net_socket_update_tc_rx_time(pkt, k_cycle_get_32());
+	}
+
+	if (!(flags & ZSOCK_MSG_PEEK)) {
+		net_pkt_unref(pkt);
+	} else {
+		net_pkt_cursor_restore(pkt, &backup);
+	}
+
+	return (flags & ZSOCK_MSG_TRUNC) ? recv_len : read_len;
+
+fail:
+	if (!(flags & ZSOCK_MSG_PEEK)) {
+		net_pkt_unref(pkt);
+	}
+
+	return -1;
+}
+
+static inline ssize_t zsock_recv_dgram(struct net_context *ctx,
+				       void *buf,
+				       size_t max_len,
+				       int flags,
+				       struct sockaddr *src_addr,
+				       socklen_t *addrlen)
+{
+	struct iovec iov = {
+		.iov_base = buf,
+		.iov_len = max_len,
+	};
+
+	return zsock_recv_dgram_iov(ctx, &iov, 1, flags, src_addr, addrlen);
+}
+
+static inline ssize_t zsock_recv_stream(struct net_context *ctx,
+					void *buf,
+					size_t max_len,
+					int flags)
+{
+	k_timeout_t timeout = K_FOREVER;
+	size_t recv_len = 0;
+	struct net_pkt_cursor backup;
+	int res;
+	uint64_t end;
+	const bool waitall = flags & ZSOCK_MSG_WAITALL;
+
+	if (!net_context_is_used(ctx)) {
+		errno = EBADF;
+		return -1;
+	}
+
+	if (net_context_get_state(ctx) != NET_CONTEXT_CONNECTED) {
+		errno = ENOTCONN;
+		return -1;
+	}
+
+	if ((flags & ZSOCK_MSG_DONTWAIT) || sock_is_nonblock(ctx)) {
+		timeout = K_NO_WAIT;
+	} else if (!sock_is_eof(ctx) && !sock_is_error(ctx)) {
+		net_context_get_option(ctx, NET_OPT_RCVTIMEO, &timeout, NULL);
+	}
+
+	end = sys_clock_timeout_end_calc(timeout);
+
+	do {
+		struct net_pkt *pkt;
+		size_t data_len, read_len;
+		bool release_pkt = true;
+
+		if (sock_is_error(ctx)) {
+			errno = POINTER_TO_INT(ctx->user_data);
+			return -1;
+		}
+
+		if (sock_is_eof(ctx)) {
+			return 0;
+		}
+
+		if (!K_TIMEOUT_EQ(timeout, K_NO_WAIT)) {
+			res = zsock_wait_data(ctx, &timeout);
+			if (res < 0) {
+				errno = -res;
+				return -1;
+			}
+		}
+
+		pkt = k_fifo_peek_head(&ctx->recv_q);
+		if (!pkt) {
+			/* Either timeout expired, or wait was cancelled
+			 * due to connection closure by peer.
+			 */
+			NET_DBG("NULL return from fifo");
+
+			if (waitall && (recv_len > 0)) {
+				return recv_len;
+			} else if (sock_is_error(ctx)) {
+				errno = POINTER_TO_INT(ctx->user_data);
+				return -1;
+			} else if (sock_is_eof(ctx)) {
+				return 0;
+			} else {
+				errno = EAGAIN;
+				return -1;
+			}
+		}
+
+		net_pkt_cursor_backup(pkt, &backup);
+
+		data_len = net_pkt_remaining_data(pkt);
+		read_len = data_len;
+		if (recv_len + read_len > max_len) {
+			read_len = max_len - recv_len;
+			release_pkt = false;
+		}
+
+		/* Actually copy data to application buffer */
+		if (net_pkt_read(pkt, (uint8_t *)buf + recv_len, read_len)) {
+			errno = ENOBUFS;
+			return -1;
+		}
+
+		recv_len += read_len;
+
+		if (!(flags & ZSOCK_MSG_PEEK)) {
+			if (release_pkt) {
+				/* Finished processing head pkt in
+				 * the fifo. Drop it from there.
+				 */
+				k_fifo_get(&ctx->recv_q, K_NO_WAIT);
+				if (net_pkt_eof(pkt)) {
+					sock_set_eof(ctx);
+				}
+
+				if (IS_ENABLED(CONFIG_NET_PKT_RXTIME_STATS)) {
+					net_socket_update_tc_rx_time(
+						pkt, k_cycle_get_32());
+				}
+
+				net_pkt_unref(pkt);
+			}
+		} else {
+			net_pkt_cursor_restore(pkt, &backup);
+		}
+
+		/* Update the timeout value in case loop is repeated. */
+		timeout_recalc(end, &timeout);
+	} while ((recv_len == 0) || (waitall && (recv_len < max_len)));
+
+	if (!(flags & ZSOCK_MSG_PEEK)) {
+		net_context_update_recv_wnd(ctx, recv_len);
+	}
+
+	return recv_len;
+}
+
+ssize_t zsock_recvfrom_ctx(struct net_context *ctx, void *buf, size_t max_len,
+			   int flags,
+			   struct sockaddr *src_addr, socklen_t *addrlen)
+{
+	enum net_sock_type sock_type = net_context_get_type(ctx);
+
+	if (max_len == 0) {
+		return 0;
+	}
+
+	if (sock_type == SOCK_DGRAM) {
+		return zsock_recv_dgram(ctx, buf, max_len, flags, src_addr, addrlen);
+	} else if (sock_type == SOCK_STREAM) {
+		return zsock_recv_stream(ctx, buf, max_len, flags);
+	} else {
+		__ASSERT(0, "Unknown socket type");
+	}
+
+	return 0;
+}
+
+ssize_t z_impl_zsock_recvfrom(int sock, void *buf, size_t max_len, int flags,
+			     struct sockaddr *src_addr, socklen_t *addrlen)
+{
+	VTABLE_CALL(recvfrom, sock, buf, max_len, flags, src_addr, addrlen);
+}
+
+#ifdef CONFIG_USERSPACE
+ssize_t z_vrfy_zsock_recvfrom(int sock, void *buf, size_t max_len, int flags,
+			      struct sockaddr *src_addr, socklen_t *addrlen)
+{
+	socklen_t addrlen_copy;
+	ssize_t ret;
+
+	if (Z_SYSCALL_MEMORY_WRITE(buf, max_len)) {
+		errno = EFAULT;
+		return -1;
+	}
+
+	if (addrlen) {
+		Z_OOPS(z_user_from_copy(&addrlen_copy, addrlen,
+					sizeof(socklen_t)));
+	}
+	Z_OOPS(src_addr && Z_SYSCALL_MEMORY_WRITE(src_addr, addrlen_copy));
+
+	ret = z_impl_zsock_recvfrom(sock, (void *)buf, max_len, flags,
+				   (struct sockaddr *)src_addr,
+				   addrlen ? &addrlen_copy : NULL);
+
+	if (addrlen) {
+		Z_OOPS(z_user_to_copy(addrlen, &addrlen_copy,
+				      sizeof(socklen_t)));
+	}
+
+	return ret;
+}
+#include <syscalls/zsock_recvfrom_mrsh.c>
+#endif /* CONFIG_USERSPACE */
+
+#if defined(CONFIG_NET_SOCKETS_RECV_ZEROCOPY)
+/* Hand the payload of a received packet over to the caller. The packet
+ * fragments holding only protocol headers are left in front of the
+ * loaned chain, they are released together with the packet.
+ */
+static void zsock_rx_loan_init(struct zsock_rx_loan *loan, struct net_pkt *pkt)
+{
+	struct net_buf *buf = pkt->cursor.buf;
+
+	loan->pkt = pkt;
+	loan->len = net_pkt_remaining_data(pkt);
+
+	if (buf == NULL || loan->len == 0) {
+		loan->buf = NULL;
+		return;
+	}
+
+	net_buf_pull(buf, (uint8_t *)pkt->cursor.pos - buf->data);
+	pkt->cursor.pos = buf->data;
+
+	loan->buf = buf;
+}
+
+static ssize_t zsock_recv_dgram_zerocopy(struct net_context *ctx,
+					 struct zsock_rx_loan *loan,
+					 int flags,
+					 struct sockaddr *src_addr,
+					 socklen_t *addrlen)
+{
+	struct net_pkt *pkt;
+
+	pkt = zsock_dgram_get_pkt(ctx, flags);
+	if (!pkt) {
+		return -1;
+	}
+
+	if (src_addr && addrlen) {
+		int rv;
+
+		rv = zsock_dgram_src_addr(ctx, pkt, src_addr, addrlen);
+		if (rv < 0) {
+			net_pkt_unref(pkt);
+			errno = -rv;
+			return -1;
+		}
+	}
+
+	if (IS_ENABLED(CONFIG_NET_PKT_RXTIME_STATS)) {
+		net_socket_update_tc_rx_time(pkt, k_cycle_get_32());
+	}
+
+	zsock_rx_loan_init(loan, pkt);
+
+	return loan->len;
+}
+
+static ssize_t zsock_recv_stream_zerocopy(struct net_context *ctx,
+					  struct zsock_rx_loan *loan,
+					  int flags)
+{
+	k_timeout_t timeout = K_FOREVER;
+	struct net_pkt *pkt;
+	int res;
+
+	if (!net_context_is_used(ctx)) {
+		errno = EBADF;
+		return -1;
+	}
+
+	if (net_context_get_state(ctx) != NET_CONTEXT_CONNECTED) {
+		errno = ENOTCONN;
+		return -1;
+	}
+
+	if ((flags & ZSOCK_MSG_DONTWAIT) || sock_is_nonblock(ctx)) {
+		timeout = K_NO_WAIT;
+	} else if (!sock_is_eof(ctx) && !sock_is_error(ctx)) {
+		net_context_get_option(ctx, NET_OPT_RCVTIMEO, &timeout, NULL);
+	}
+
+	if (sock_is_error(ctx)) {
+		errno = POINTER_TO_INT(ctx->user_data);
+		return -1;
+	}
+
+	if (sock_is_eof(ctx)) {
+		return 0;
+	}
+
+	if (!K_TIMEOUT_EQ(timeout, K_NO_WAIT)) {
+		res = zsock_wait_data(ctx, &timeout);
+		if (res < 0) {
+			errno = -res;
+			return -1;
+		}
+	}
+
+	pkt = k_fifo_get(&ctx->recv_q, K_NO_WAIT);
+	if (!pkt) {
+		if (sock_is_error(ctx)) {
+			errno = POINTER_TO_INT(ctx->user_data);
+			return -1;
+		} else if (sock_is_eof(ctx)) {
+			return 0;
+		}
+
+		errno = EAGAIN;
+		return -1;
+	}
+
+	if (net_pkt_eof(pkt)) {
+		sock_set_eof(ctx);
+	}
+
+	/* Nothing is loaned for the end of stream marker, so the caller
+	 * does not need to release anything when 0 is returned.
+	 */
+	if (net_pkt_remaining_data(pkt) == 0) {
+		net_pkt_unref(pkt);
+		return 0;
+	}
+
+	if (IS_ENABLED(CONFIG_NET_PKT_RXTIME_STATS)) {
+		net_socket_update_tc_rx_time(pkt, k_cycle_get_32());
+	}
+
+	zsock_rx_loan_init(loan, pkt);
+
+	/* The receive window is opened when the data is dequeued, not when
+	 * the loan is returned. Applications holding on to loaned buffers
+	 * for a long time are limited by the net_buf pool instead.
+	 */
+	net_context_update_recv_wnd(ctx, loan->len);
+
+	return loan->len;
+}
+
+ssize_t zsock_recv_zerocopy(int sock, struct zsock_rx_loan *loan, int flags,
+			    struct sockaddr *src_addr, socklen_t *addrlen)
+{
+	const struct socket_op_vtable *vtable;
+	enum net_sock_type sock_type;
+	struct net_context *ctx;
+	struct k_mutex *lock;
+	ssize_t ret;
+
+	if (k_is_user_context()) {
+		errno = EPERM;
+		return -1;
+	}
+
+	if (loan == NULL) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	/* A loaned packet is owned by the caller, so it cannot stay
+	 * in the receive queue.
+	 */
+	if (flags & ZSOCK_MSG_PEEK) {
+		errno = EINVAL;
+		return -1;
+	}
 
-		pkt = k_fifo_peek_head(&ctx->recv_q);
-	} else {
-		pkt = k_fifo_get(&ctx->recv_q, timeout);
+	ctx = get_sock_vtable(sock, &vtable, &lock);
+	if (ctx == NULL) {
+		errno = EBADF;
+		return -1;
 	}
 
-	if (!pkt) {
-		errno = EAGAIN;
+	/* Only native sockets queue net_pkt's that can be loaned */
+	if (vtable != &sock_fd_op_vtable) {
+		errno = EOPNOTSUPP;
 		return -1;
 	}
 
-	net_pkt_cursor_backup(pkt, &backup);
+	loan->pkt = NULL;
+	loan->buf = NULL;
+	loan->len = 0;
 
-	if (src_addr && addrlen) {
-		if (IS_ENABLED(CONFIG_NET_OFFLOAD) &&
-		    net_if_is_ip_offloaded(net_context_get_iface(ctx))) {
-			/*
-			 * Packets from offloaded IP stack do not have IP
-			 * headers, so src address cannot be figured out at this
-			 * point. The best we can do is returning remote address
-			 * if that was set using connect() call.
-			 */
-			if (ctx->flags & NET_CONTEXT_REMOTE_ADDR_SET) {
-				memcpy(src_addr, &ctx->remote,
-				       MIN(*addrlen, sizeof(ctx->remote)));
-			} else {
-				errno = ENOTSUP;
-				goto fail;
-			}
-		} else {
-			int rv;
+	(void)k_mutex_lock(lock, K_FOREVER);
 
-			rv = sock_get_pkt_src_addr(pkt, net_context_get_proto(ctx),
-						   src_addr, *addrlen);
-			if (rv < 0) {
-				errno = -rv;
-				LOG_ERR("sock_get_pkt_src_addr %d", rv);
-				goto fail;
-			}
-		}
+	sock_type = net_context_get_type(ctx);
 
-		/* addrlen is a value-result argument, set to actual
-		 * size of source address
-		 */
-		if (src_addr->sa_family == AF_INET) {
-			*addrlen = sizeof(struct sockaddr_in);
-		} else if (src_addr->sa_family == AF_INET6) {
-			*addrlen = sizeof(struct sockaddr_in6);
-		} else {
-			errno = ENOTSUP;
-			goto fail;
-		}
+	if (sock_type == SOCK_DGRAM) {
+		ret = zsock_recv_dgram_zerocopy(ctx, loan, flags, src_addr,
+						addrlen);
+	} else if (sock_type == SOCK_STREAM) {
+		ret = zsock_recv_stream_zerocopy(ctx, loan, flags);
+	} else {
+		errno = EOPNOTSUPP;
+		ret = -1;
 	}
 
-	recv_len = net_pkt_remaining_data(pkt);
-	read_len = MIN(recv_len, max_len);
+	k_mutex_unlock(lock);
 
-	if (net_pkt_read(pkt, buf, read_len)) {
-		errno = ENOBUFS;
-		goto fail;
-	}
+	return ret;
+}
 
-	if (IS_ENABLED(CONFIG_NET_PKT_RXTIME_STATS) &&
-	    !(flags & ZSOCK_MSG_PEEK)) {
-		net_socket_update_tc_rx_time(pkt, k_cycle_get_32());
+void zsock_recv_zerocopy_release(struct zsock_rx_loan *loan)
+{
+	if (loan == NULL || loan->pkt == NULL) {
+		return;
 	}
 
-	if (!(flags & ZSOCK_MSG_PEEK)) {
-		net_pkt_unref(pkt);
-	} else {
-		net_pkt_cursor_restore(pkt, &backup);
-	}
+	net_pkt_unref(loan->pkt);
 
-	return (flags & ZSOCK_MSG_TRUNC) ? recv_len : read_len;
+	loan->pkt = NULL;
+	loan->buf = NULL;
+	loan->len = 0;
+}
+#endif /* CONFIG_NET_SOCKETS_RECV_ZEROCOPY */
 
-fail:
-	if (!(flags & ZSOCK_MSG_PEEK)) {
-		net_pkt_unref(pkt);
+static size_t msghdr_iov_len(const struct msghdr *msg)
+{
+	size_t len = 0;
+
+	for (size_t i = 0; i < msg->msg_iovlen; i++) {
+		len += msg->msg_iov[i].iov_len;
 	}
 
-	return -1;
+	return len;
 }
 
-static inline ssize_t zsock_recv_stream(struct net_context *ctx,
-					void *buf,
-					size_t max_len,
-					int flags)
+int zsock_recvmmsg_ctx(struct net_context *ctx, struct mmsghdr *msgvec,
+		       unsigned int vlen, int flags)
 {
-	k_timeout_t timeout = K_FOREVER;
-	size_t recv_len = 0;
-	struct net_pkt_cursor backup;
-	int res;
-	uint64_t end;
-	const bool waitall = flags & ZSOCK_MSG_WAITALL;
+	unsigned int i;
 
-	if (!net_context_is_used(ctx)) {
-		errno = EBADF;
+	if (net_context_get_type(ctx) != SOCK_DGRAM) {
+		errno = EOPNOTSUPP;
 		return -1;
 	}
 
-	if (net_context_get_state(ctx) != NET_CONTEXT_CONNECTED) {
-		errno = ENOTCONN;
-		return -1;
-	}
+	for (i = 0; i < vlen; i++) {
+		struct msghdr *msg = &msgvec[i].msg_hdr;
+		size_t max_len = msghdr_iov_len(msg);
+		ssize_t ret;
 
-	if ((flags & ZSOCK_MSG_DONTWAIT) || sock_is_nonblock(ctx)) {
-		timeout = K_NO_WAIT;
-	} else if (!sock_is_eof(ctx) && !sock_is_error(ctx)) {
-		net_context_get_option(ctx, NET_OPT_RCVTIMEO, &timeout, NULL);
-	}
+		ret = zsock_recv_dgram_iov(ctx, msg->msg_iov, msg->msg_iovlen,
+					   flags | ZSOCK_MSG_TRUNC,
+					   msg->msg_name,
+					   msg->msg_name ? &msg->msg_namelen :
+							   NULL);
+		if (ret < 0) {
+			/* Report the error only if nothing was received */
+			return i > 0 ? i : -1;
+		}
 
-	end = sys_clock_timeout_end_calc(timeout);
+		msg->msg_controllen = 0;
+		msg->msg_flags = 0;
 
-	do {
-		struct net_pkt *pkt;
-		size_t data_len, read_len;
-		bool release_pkt = true;
+		if ((size_t)ret > max_len) {
+			msg->msg_flags |= ZSOCK_MSG_TRUNC;
 
-		if (sock_is_error(ctx)) {
-			errno = POINTER_TO_INT(ctx->user_data);
-			return -1;
+			if (!(flags & ZSOCK_MSG_TRUNC)) {
+				ret = max_len;
+			}
 		}
 
-		if (sock_is_eof(ctx)) {
-			return 0;
-		}
+		msgvec[i].msg_len = ret;
 
-		if (!K_TIMEOUT_EQ(timeout, K_NO_WAIT)) {
-			res = zsock_wait_data(ctx, &timeout);
-			if (res < 0) {
-				errno = -res;
-				return -1;
-			}
+		if (flags & ZSOCK_MSG_PEEK) {
+			/* Peeking would return the same datagram again */
+			i++;
+			break;
 		}
 
-		pkt = k_fifo_peek_head(&ctx->recv_q);
-		if (!pkt) {
-			/* Either timeout expired, or wait was cancelled
-			 * due to connection closure by peer.
-			 */
-			NET_DBG("NULL return from fifo");
+		/* Wait only for the first datagram, the rest are picked
+		 * only if they are already queued.
+		 */
+		flags |= ZSOCK_MSG_DONTWAIT;
+	}
 
-			if (waitall && (recv_len > 0)) {
-				return recv_len;
-			} else if (sock_is_error(ctx)) {
-				errno = POINTER_TO_INT(ctx->user_data);
-				return -1;
-			} else if (sock_is_eof(ctx)) {
-				return 0;
-			} else {
-				errno = EAGAIN;
-				return -1;
-			}
-		}
+	return i;
+}
 
-		net_pkt_cursor_backup(pkt, &backup);
+/* Used for the socket types that do not provide recvmmsg(). Only one
+ * buffer per message is supported.
+ */
+static int recvmmsg_fallback(void *obj, const struct socket_op_vtable *vtable,
+			     struct mmsghdr *msgvec, unsigned int vlen,
+			     int flags)
+{
+	unsigned int i;
 
-		data_len = net_pkt_remaining_data(pkt);
-		read_len = data_len;
-		if (recv_len + read_len > max_len) {
-			read_len = max_len - recv_len;
-			release_pkt = false;
-		}
+	for (i = 0; i < vlen; i++) {
+		struct msghdr *msg = &msgvec[i].msg_hdr;
+		ssize_t ret;
 
-		/* Actually copy data to application buffer */
-		if (net_pkt_read(pkt, (uint8_t *)buf + recv_len, read_len)) {
-			errno = ENOBUFS;
-			return -1;
+		if (msg->msg_iovlen > 1) {
+			errno = EOPNOTSUPP;
+			return i > 0 ? i : -1;
 		}
 
-		recv_len += read_len;
-
-		if (!(flags & ZSOCK_MSG_PEEK)) {
-			if (release_pkt) {
-				/* Finished processing head pkt in
-				 * the fifo. Drop it from there.
-				 */
-				k_fifo_get(&ctx->recv_q, K_NO_WAIT);
-				if (net_pkt_eof(pkt)) {
-					sock_set_eof(ctx);
-				}
+		ret = vtable->recvfrom(obj,
+				       msg->msg_iovlen ? msg->msg_iov[0].iov_base :
+							 NULL,
+				       msg->msg_iovlen ? msg->msg_iov[0].iov_len : 0,
+				       flags, msg->msg_name,
+				       msg->msg_name ? &msg->msg_namelen : NULL);
+		if (ret < 0) {
+			return i > 0 ? i : -1;
+		}
 
-				if (IS_ENABLED(CONFIG_NET_PKT_RXTIME_STATS)) {
-					net_socket_update_tc_rx_time(
-						pkt, k_cycle_get_32());
-				}
+		msg->msg_controllen = 0;
+		msg->msg_flags = 0;
+		msgvec[i].msg_len = ret;
 
-				net_pkt_unref(pkt);
-			}
-		} else {
-			net_pkt_cursor_restore(pkt, &backup);
+		if (flags & ZSOCK_MSG_PEEK) {
+			i++;
+			break;
 		}
 
-		/* Update the timeout value in case loop is repeated. */
-		timeout_recalc(end, &timeout);
-	} while ((recv_len == 0) || (waitall && (recv_len < max_len)));
-
-	if (!(flags & ZSOCK_MSG_PEEK)) {
-		net_context_update_recv_wnd(ctx, recv_len);
+		flags |= ZSOCK_MSG_DONTWAIT;
 	}
 
-	return recv_len;
+	return i;
 }
 
-ssize_t zsock_recvfrom_ctx(struct net_context *ctx, void *buf, size_t max_len,
-			   int flags,
-			   struct sockaddr *src_addr, socklen_t *addrlen)
+int z_impl_zsock_recvmmsg(int sock, struct mmsghdr *msgvec,
+			  unsigned int vlen, int flags)
 {
-	enum net_sock_type sock_type = net_context_get_type(ctx);
+	const struct socket_op_vtable *vtable;
+	struct k_mutex *lock;
+	void *obj;
+	int ret;
 
-	if (max_len == 0) {
-		return 0;
+	obj = get_sock_vtable(sock, &vtable, &lock);
+	if (obj == NULL) {
+		errno = EBADF;
+		return -1;
 	}
 
-	if (sock_type == SOCK_DGRAM) {
-		return zsock_recv_dgram(ctx, buf, max_len, flags, src_addr, addrlen);
-	} else if (sock_type == SOCK_STREAM) {
-		return zsock_recv_stream(ctx, buf, max_len, flags);
+	if (vtable->recvmmsg == NULL && vtable->recvfrom == NULL) {
+		errno = EOPNOTSUPP;
+		return -1;
+	}
+
+	(void)k_mutex_lock(lock, K_FOREVER);
+
+	if (vtable->recvmmsg != NULL) {
+		ret = vtable->recvmmsg(obj, msgvec, vlen, flags);
 	} else {
-		__ASSERT(0, "Unknown socket type");
+		ret = recvmmsg_fallback(obj, vtable, msgvec, vlen, flags);
 	}
 
-	return 0;
+	k_mutex_unlock(lock);
+
+	return ret;
 }
 
-ssize_t z_impl_zsock_recvfrom(int sock, void *buf, size_t max_len, int flags,
-			     struct sockaddr *src_addr, socklen_t *addrlen)
+#ifdef CONFIG_USERSPACE
+static void recvmmsg_free_copy(struct mmsghdr *msgvec, unsigned int vlen)
 {
-	VTABLE_CALL(recvfrom, sock, buf, max_len, flags, src_addr, addrlen);
+	for (unsigned int i = 0; i < vlen; i++) {
+		k_free(msgvec[i].msg_hdr.msg_iov);
+	}
+
+	k_free(msgvec);
 }
 
-#ifdef CONFIG_USERSPACE
-ssize_t z_vrfy_zsock_recvfrom(int sock, void *buf, size_t max_len, int flags,
-			      struct sockaddr *src_addr, socklen_t *addrlen)
+static inline int z_vrfy_zsock_recvmmsg(int sock, struct mmsghdr *msgvec,
+					unsigned int vlen, int flags)
 {
-	socklen_t addrlen_copy;
-	ssize_t ret;
+	struct mmsghdr *msgvec_copy;
+	unsigned int i;
+	size_t size;
+	int ret;
 
-	if (Z_SYSCALL_MEMORY_WRITE(buf, max_len)) {
-		errno = EFAULT;
+	if (vlen == 0) {
+		return z_impl_zsock_recvmmsg(sock, NULL, 0, flags);
+	}
+
+	if (size_mul_overflow(vlen, sizeof(struct mmsghdr), &size)) {
+		errno = EINVAL;
 		return -1;
 	}
 
-	if (addrlen) {
-		Z_OOPS(z_user_from_copy(&addrlen_copy, addrlen,
-					sizeof(socklen_t)));
+	msgvec_copy = z_user_alloc_from_copy(msgvec, size);
+	if (msgvec_copy == NULL) {
+		errno = ENOMEM;
+		return -1;
 	}
-	Z_OOPS(src_addr && Z_SYSCALL_MEMORY_WRITE(src_addr, addrlen_copy));
 
-	ret = z_impl_zsock_recvfrom(sock, (void *)buf, max_len, flags,
-				   (struct sockaddr *)src_addr,
-				   addrlen ? &addrlen_copy : NULL);
+	/* The received data is written directly to the user buffers, so
+	 * only the message headers and the iovec arrays are copied.
+	 */
+	for (i = 0; i < vlen; i++) {
+		struct msghdr *msg = &msgvec_copy[i].msg_hdr;
+		struct iovec *iov = msg->msg_iov;
 
-	if (addrlen) {
-		Z_OOPS(z_user_to_copy(addrlen, &addrlen_copy,
+		msg->msg_control = NULL;
+		msg->msg_iov = NULL;
+
+		if (msg->msg_iovlen > 0) {
+			if (size_mul_overflow(msg->msg_iovlen,
+					      sizeof(struct iovec), &size)) {
+				errno = EINVAL;
+				goto fail;
+			}
+
+			msg->msg_iov = z_user_alloc_from_copy(iov, size);
+			if (msg->msg_iov == NULL) {
+				errno = ENOMEM;
+				goto fail;
+			}
+		}
+
+		for (size_t j = 0; j < msg->msg_iovlen; j++) {
+			if (Z_SYSCALL_MEMORY_WRITE(msg->msg_iov[j].iov_base,
+						   msg->msg_iov[j].iov_len)) {
+				errno = EFAULT;
+				goto fail;
+			}
+		}
+
+		if (msg->msg_name != NULL &&
+		    Z_SYSCALL_MEMORY_WRITE(msg->msg_name, msg->msg_namelen)) {
+			errno = EFAULT;
+			goto fail;
+		}
+	}
+
+	ret = z_impl_zsock_recvmmsg(sock, msgvec_copy, vlen, flags);
+
+	for (i = 0; ret > 0 && i < (unsigned int)ret; i++) {
+		Z_OOPS(z_user_to_copy(&msgvec[i].msg_len,
+				      &msgvec_copy[i].msg_len,
+				      sizeof(msgvec[i].msg_len)));
+		Z_OOPS(z_user_to_copy(&msgvec[i].msg_hdr.msg_namelen,
+				      &msgvec_copy[i].msg_hdr.msg_namelen,
 				      sizeof(socklen_t)));
+		Z_OOPS(z_user_to_copy(&msgvec[i].msg_hdr.msg_flags,
+				      &msgvec_copy[i].msg_hdr.msg_flags,
+				      sizeof(int)));
+		Z_OOPS(z_user_to_copy(&msgvec[i].msg_hdr.msg_controllen,
+				      &msgvec_copy[i].msg_hdr.msg_controllen,
+				      sizeof(size_t)));
 	}
 
+	recvmmsg_free_copy(msgvec_copy, vlen);
+
 	return ret;
+
+fail:
+	/* Make sure that the not yet processed entries are not freed */
+	for (unsigned int j = i + 1; j < vlen; j++) {
+		msgvec_copy[j].msg_hdr.msg_iov = NULL;
+	}
+
+	recvmmsg_free_copy(msgvec_copy, vlen);
+
+	return -1;
 }
-#include <syscalls/zsock_recvfrom_mrsh.c>
+#include <syscalls/zsock_recvmmsg_mrsh.c>
 #endif /* CONFIG_USERSPACE */
 
 /* As this is limited function, we don't follow POSIX signature, with
@@ -2603,6 +3395,18 @@ static ssize_t sock_recvfrom_vmeth(void *obj, void *buf, size_t max_len,
 				  src_addr, addrlen);
 }
 
+static int sock_sendmmsg_vmeth(void *obj, struct mmsghdr *msgvec,
+			       unsigned int vlen, int flags)
+{
+	return zsock_sendmmsg_ctx(obj, msgvec, vlen, flags);
+}
+
+static int sock_recvmmsg_vmeth(void *obj, struct mmsghdr *msgvec,
+			       unsigned int vlen, int flags)
+{
+	return zsock_recvmmsg_ctx(obj, msgvec, vlen, flags);
+}
+
 static int sock_getsockopt_vmeth(void *obj, int level, int optname,
 				 void *optval, socklen_t *optlen)
 {
@@ -2650,6 +3454,8 @@ const struct socket_op_vtable sock_fd_op_vtable = {
 	.setsockopt = sock_setsockopt_vmeth,
 	.getpeername = sock_getpeername_vmeth,
 	.getsockname = sock_getsockname_vmeth,
+	.sendmmsg = sock_sendmmsg_vmeth,
+	.recvmmsg = sock_recvmmsg_vmeth,
 };
 
 #if defined(CONFIG_NET_NATIVE)
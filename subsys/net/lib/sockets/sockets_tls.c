@@ -51,6 +51,7 @@ LOG_MODULE_REGISTER(net_sock_tls, CONFIG_NET_SOCKETS_LOG_LEVEL);
 #include <mbedtls/error.h>
 #include <mbedtls/platform.h>
 #include <mbedtls/ssl_cache.h>
+#include <mbedtls/ssl_ticket.h>
 #endif /* CONFIG_MBEDTLS */
 
 #include "sockets_internal.h"
@@ -66,6 +67,11 @@ LOG_MODULE_REGISTER(net_sock_tls, CONFIG_NET_SOCKETS_LOG_LEVEL);
 #define ALPN_MAX_PROTOCOLS 0
 #endif /* CONFIG_NET_SOCKETS_TLS_MAX_APP_PROTOCOLS */
 
+#if defined(CONFIG_NET_SOCKETS_ENABLE_DTLS) && \
+	defined(MBEDTLS_SSL_DTLS_CONNECTION_ID)
+#define DTLS_CID_SUPPORTED
+#endif
+
 static const struct socket_op_vtable tls_sock_fd_op_vtable;
 
 #ifndef MBEDTLS_ERR_SSL_PEER_VERIFY_FAILED
@@ -138,6 +144,9 @@ __net_socket struct tls_context {
 	/** Information whether TLS handshake is currently in progress. */
 	bool handshake_in_progress;
 
+	/** Information whether the server resumed the session of the peer. */
+	bool session_resumed;
+
 	/** Information whether TLS handshake is complete or not. */
 	struct k_sem tls_established;
 
@@ -185,6 +194,17 @@ __net_socket struct tls_context {
 		/* DTLS handshake timeout */
 		uint32_t dtls_handshake_timeout_min;
 		uint32_t dtls_handshake_timeout_max;
+
+#if defined(DTLS_CID_SUPPORTED)
+		/** DTLS Connection ID mode. */
+		int8_t dtls_cid;
+
+		/** Length of our DTLS Connection ID, 0 if not set yet. */
+		uint8_t dtls_cid_len;
+
+		/** Our DTLS Connection ID. */
+		uint8_t dtls_cid_value[MBEDTLS_SSL_CID_IN_LEN_MAX];
+#endif /* DTLS_CID_SUPPORTED */
 #endif /* CONFIG_NET_SOCKETS_ENABLE_DTLS */
 	} options;
 
@@ -200,6 +220,17 @@ __net_socket struct tls_context {
 
 	/** DTLS peer address length. */
 	socklen_t dtls_peer_addrlen;
+
+#if defined(DTLS_CID_SUPPORTED)
+	/** Address of the last datagram carrying our Connection ID received
+	 *  from another address than the peer one. It becomes the peer
+	 *  address once a record of the datagram is authenticated.
+	 */
+	struct sockaddr dtls_pending_addr;
+
+	/** Pending peer address length, 0 if none. */
+	socklen_t dtls_pending_addrlen;
+#endif /* DTLS_CID_SUPPORTED */
 #endif /* CONFIG_NET_SOCKETS_ENABLE_DTLS */
 
 #if defined(CONFIG_MBEDTLS)
@@ -233,6 +264,28 @@ static struct tls_session_cache client_cache[CONFIG_NET_SOCKETS_TLS_MAX_CLIENT_S
 static mbedtls_ssl_cache_context server_cache;
 #endif
 
+#if defined(MBEDTLS_SSL_TICKET_C)
+static mbedtls_ssl_ticket_context server_ticket;
+static bool server_ticket_ready;
+
+/* Cipher protecting the session tickets, mbedTLS requires an AEAD one. */
+#if defined(MBEDTLS_AES_C) && defined(MBEDTLS_GCM_C)
+#define TLS_TICKET_CIPHER MBEDTLS_CIPHER_AES_256_GCM
+#elif defined(MBEDTLS_AES_C) && defined(MBEDTLS_CCM_C)
+#define TLS_TICKET_CIPHER MBEDTLS_CIPHER_AES_256_CCM
+#else
+#define TLS_TICKET_CIPHER MBEDTLS_CIPHER_CHACHA20_POLY1305
+#endif
+#endif /* MBEDTLS_SSL_TICKET_C */
+
+/* A mutex for protecting the server session cache, the session ticket keys
+ * and the handshake counters, shared by all server sockets. mbedTLS does
+ * not protect them itself unless built with MBEDTLS_THREADING_C.
+ */
+static struct k_mutex server_session_lock;
+
+static struct tls_handshake_stats handshake_stats;
+
 /* A mutex for protecting TLS context allocation. */
 static struct k_mutex context_lock;
 
@@ -334,6 +387,132 @@ static int dtls_get_remaining_timeout(struct tls_context *ctx)
 }
 #endif /* CONFIG_NET_SOCKETS_ENABLE_DTLS */
 
+#if defined(MBEDTLS_SSL_CACHE_C)
+static void tls_server_cache_init(void)
+{
+	mbedtls_ssl_cache_init(&server_cache);
+	mbedtls_ssl_cache_set_max_entries(
+		&server_cache, CONFIG_NET_SOCKETS_TLS_MAX_SERVER_SESSION_COUNT);
+#if defined(MBEDTLS_HAVE_TIME)
+	mbedtls_ssl_cache_set_timeout(&server_cache,
+				      CONFIG_NET_SOCKETS_TLS_SESSION_LIFETIME);
+#endif
+}
+
+/* mbedTLS-defined function for looking up a session in the server cache. */
+static int tls_server_cache_get(void *data, unsigned char const *session_id,
+				size_t session_id_len,
+				mbedtls_ssl_session *session)
+{
+	struct tls_context *context = data;
+	int ret;
+
+	k_mutex_lock(&server_session_lock, K_FOREVER);
+	ret = mbedtls_ssl_cache_get(&server_cache, session_id, session_id_len,
+				    session);
+	k_mutex_unlock(&server_session_lock);
+
+	if (ret == 0) {
+		context->session_resumed = true;
+	}
+
+	return ret;
+}
+
+/* mbedTLS-defined function for storing a session in the server cache. */
+static int tls_server_cache_set(void *data, unsigned char const *session_id,
+				size_t session_id_len,
+				const mbedtls_ssl_session *session)
+{
+	int ret;
+
+	ARG_UNUSED(data);
+
+	k_mutex_lock(&server_session_lock, K_FOREVER);
+	ret = mbedtls_ssl_cache_set(&server_cache, session_id, session_id_len,
+				    session);
+	k_mutex_unlock(&server_session_lock);
+
+	return ret;
+}
+#endif /* MBEDTLS_SSL_CACHE_C */
+
+#if defined(MBEDTLS_SSL_TICKET_C)
+/* Generate the ticket keys on first use rather than at boot, as the entropy
+ * source may not be ready yet. Must be called with server_session_lock held.
+ */
+static int tls_server_ticket_setup(void)
+{
+	int ret;
+
+	if (server_ticket_ready) {
+		return 0;
+	}
+
+	ret = mbedtls_ssl_ticket_setup(&server_ticket, tls_ctr_drbg_random,
+				       NULL, TLS_TICKET_CIPHER,
+				       CONFIG_NET_SOCKETS_TLS_SESSION_LIFETIME);
+	if (ret != 0) {
+		NET_ERR("Failed to setup session tickets, err: -%x", -ret);
+		mbedtls_ssl_ticket_free(&server_ticket);
+		mbedtls_ssl_ticket_init(&server_ticket);
+		return ret;
+	}
+
+	server_ticket_ready = true;
+
+	return 0;
+}
+
+/* mbedTLS-defined function for issuing a session ticket. */
+static int tls_server_ticket_write(void *data,
+				   const mbedtls_ssl_session *session,
+				   unsigned char *start,
+				   const unsigned char *end,
+				   size_t *tlen, uint32_t *lifetime)
+{
+	int ret;
+
+	ARG_UNUSED(data);
+
+	k_mutex_lock(&server_session_lock, K_FOREVER);
+
+	ret = tls_server_ticket_setup();
+	if (ret == 0) {
+		ret = mbedtls_ssl_ticket_write(&server_ticket, session, start,
+					       end, tlen, lifetime);
+	}
+
+	k_mutex_unlock(&server_session_lock);
+
+	return ret;
+}
+
+/* mbedTLS-defined function for restoring a session from a ticket. */
+static int tls_server_ticket_parse(void *data, mbedtls_ssl_session *session,
+				   unsigned char *buf, size_t len)
+{
+	struct tls_context *context = data;
+	int ret;
+
+	k_mutex_lock(&server_session_lock, K_FOREVER);
+
+	ret = tls_server_ticket_setup();
+	if (ret == 0) {
+		ret = mbedtls_ssl_ticket_parse(&server_ticket, session, buf,
+					       len);
+	}
+
+	k_mutex_unlock(&server_session_lock);
+
+	if (ret == 0) {
+		context->session_resumed = true;
+	}
+
+	return ret;
+}
+#endif /* MBEDTLS_SSL_TICKET_C */
+
 /* Initialize TLS internals. */
 static int tls_init(void)
 {
@@ -347,9 +526,14 @@ static int tls_init(void)
 	(void)memset(client_cache, 0, sizeof(client_cache));
 
 	k_mutex_init(&context_lock);
+	k_mutex_init(&server_session_lock);
 
 #if defined(MBEDTLS_SSL_CACHE_C)
-	mbedtls_ssl_cache_init(&server_cache);
+	tls_server_cache_init();
+#endif
+
+#if defined(MBEDTLS_SSL_TICKET_C)
+	mbedtls_ssl_ticket_init(&server_ticket);
 #endif
 
 	return 0;
@@ -696,10 +880,42 @@ static void tls_session_purge(void)
 {
 	tls_session_cache_reset();
 
+	k_mutex_lock(&server_session_lock, K_FOREVER);
+
 #if defined(MBEDTLS_SSL_CACHE_C)
 	mbedtls_ssl_cache_free(&server_cache);
-	mbedtls_ssl_cache_init(&server_cache);
+	tls_server_cache_init();
 #endif
+
+#if defined(MBEDTLS_SSL_TICKET_C)
+	/* New keys are generated on next use, so that the tickets issued so
+	 * far are rejected.
+	 */
+	mbedtls_ssl_ticket_free(&server_ticket);
+	mbedtls_ssl_ticket_init(&server_ticket);
+	server_ticket_ready = false;
+#endif
+
+	k_mutex_unlock(&server_session_lock);
+}
+
+static void tls_handshake_stats_update(struct tls_context *context, int ret)
+{
+	if (context->config.endpoint != MBEDTLS_SSL_IS_SERVER || ret == -EAGAIN) {
+		return;
+	}
+
+	k_mutex_lock(&server_session_lock, K_FOREVER);
+
+	if (ret != 0) {
+		handshake_stats.failed++;
+	} else if (context->session_resumed) {
+		handshake_stats.resumed++;
+	} else {
+		handshake_stats.full++;
+	}
+
+	k_mutex_unlock(&server_session_lock);
 }
 
 static inline int time_left(uint32_t start, uint32_t timeout)
@@ -843,43 +1059,93 @@ static int dtls_tx(void *ctx, const unsigned char *buf, size_t len)
 	return sent;
 }
 
+#if defined(DTLS_CID_SUPPORTED)
+/* Check whether a datagram received from another address than the peer one
+ * may come from the peer, whose address changed. Such datagrams carry our
+ * Connection ID, mbedTLS drops them if the Connection ID does not match or
+ * if the record cannot be authenticated.
+ */
+static bool dtls_is_cid_record(struct tls_context *tls_ctx,
+			       const unsigned char *buf, size_t len)
+{
+	return tls_ctx->options.dtls_cid == TLS_DTLS_CID_ENABLED &&
+	       is_handshake_complete(tls_ctx) && len > 0 &&
+	       buf[0] == MBEDTLS_SSL_MSG_CID;
+}
+
+static void dtls_peer_address_update(struct tls_context *context)
+{
+	if (context->dtls_pending_addrlen == 0) {
+		return;
+	}
+
+	NET_DBG("DTLS peer address changed for %p", context);
+
+	dtls_peer_address_set(context, &context->dtls_pending_addr,
+			      context->dtls_pending_addrlen);
+	context->dtls_pending_addrlen = 0;
+}
+#endif /* DTLS_CID_SUPPORTED */
+
 static int dtls_rx(void *ctx, unsigned char *buf, size_t len)
 {
 	struct tls_context *tls_ctx = ctx;
-	socklen_t addrlen = sizeof(struct sockaddr);
+	socklen_t addrlen;
 	struct sockaddr addr;
 	int err;
 	ssize_t received;
 
-	received = zsock_recvfrom(tls_ctx->sock, buf, len,
-				  ZSOCK_MSG_DONTWAIT, &addr, &addrlen);
-	if (received < 0) {
-		if (errno == EAGAIN) {
-			return MBEDTLS_ERR_SSL_WANT_READ;
+#if defined(DTLS_CID_SUPPORTED)
+	tls_ctx->dtls_pending_addrlen = 0;
+#endif
+
+	/* Datagrams from other peers are dropped, the next queued datagram is
+	 * read right away instead of waiting for another wakeup.
+	 */
+	while (true) {
+		addrlen = sizeof(struct sockaddr);
+		received = zsock_recvfrom(tls_ctx->sock, buf, len,
+					  ZSOCK_MSG_DONTWAIT, &addr, &addrlen);
+		if (received < 0) {
+			if (errno == EAGAIN) {
+				return MBEDTLS_ERR_SSL_WANT_READ;
+			}
+
+			return MBEDTLS_ERR_NET_RECV_FAILED;
 		}
 
-		return MBEDTLS_ERR_NET_RECV_FAILED;
+		if (tls_ctx->dtls_peer_addrlen == 0) {
+			break;
+		}
+
+		if (dtls_is_peer_addr_valid(tls_ctx, &addr, addrlen)) {
+			return received;
+		}
+
+#if defined(DTLS_CID_SUPPORTED)
+		if (dtls_is_cid_record(tls_ctx, buf, received)) {
+			memcpy(&tls_ctx->dtls_pending_addr, &addr, addrlen);
+			tls_ctx->dtls_pending_addrlen = addrlen;
+			return received;
+		}
+#endif
 	}
 
-	if (tls_ctx->dtls_peer_addrlen == 0) {
-		/* Only allow to store peer address for DTLS servers. */
-		if (tls_ctx->options.role == MBEDTLS_SSL_IS_SERVER) {
-			dtls_peer_address_set(tls_ctx, &addr, addrlen);
+	/* Only allow to store peer address for DTLS servers. */
+	if (tls_ctx->options.role == MBEDTLS_SSL_IS_SERVER) {
+		dtls_peer_address_set(tls_ctx, &addr, addrlen);
 
-			err = mbedtls_ssl_set_client_transport_id(
-				&tls_ctx->ssl,
-				(const unsigned char *)&addr, addrlen);
-			if (err < 0) {
-				return err;
-			}
-		} else {
-			/* For clients it's incorrect to receive when
-			 * no peer has been set up.
-			 */
-			return MBEDTLS_ERR_SSL_PEER_VERIFY_FAILED;
+		err = mbedtls_ssl_set_client_transport_id(
+			&tls_ctx->ssl,
+			(const unsigned char *)&addr, addrlen);
+		if (err < 0) {
+			return err;
 		}
-	} else if (!dtls_is_peer_addr_valid(tls_ctx, &addr, addrlen)) {
-		return MBEDTLS_ERR_SSL_WANT_READ;
+	} else {
+		/* For clients it's incorrect to receive when
+		 * no peer has been set up.
+		 */
+		return MBEDTLS_ERR_SSL_PEER_VERIFY_FAILED;
 	}
 
 	return received;
@@ -1132,6 +1398,58 @@ exit:
 	return err;
 }
 
+#if defined(DTLS_CID_SUPPORTED)
+static size_t dtls_cid_own_len(struct tls_context *context)
+{
+	if (context->options.dtls_cid != TLS_DTLS_CID_ENABLED) {
+		return 0;
+	}
+
+	return context->options.dtls_cid_len;
+}
+
+static int dtls_cid_conf(struct tls_context *context)
+{
+	int ret;
+
+	if (context->options.dtls_cid == TLS_DTLS_CID_DISABLED) {
+		return 0;
+	}
+
+	if (context->options.dtls_cid == TLS_DTLS_CID_ENABLED &&
+	    context->options.dtls_cid_len == 0) {
+		ret = tls_ctr_drbg_random(NULL, context->options.dtls_cid_value,
+					  sizeof(context->options.dtls_cid_value));
+		if (ret != 0) {
+			return -EIO;
+		}
+
+		context->options.dtls_cid_len =
+			sizeof(context->options.dtls_cid_value);
+	}
+
+	ret = mbedtls_ssl_conf_cid(&context->config, dtls_cid_own_len(context),
+				   MBEDTLS_SSL_UNEXPECTED_CID_IGNORE);
+	if (ret != 0) {
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+/* The Connection IDs must be set up again for every handshake. */
+static int dtls_cid_set(struct tls_context *context)
+{
+	if (context->options.dtls_cid == TLS_DTLS_CID_DISABLED) {
+		return 0;
+	}
+
+	return mbedtls_ssl_set_cid(&context->ssl, MBEDTLS_SSL_CID_ENABLED,
+				   context->options.dtls_cid_value,
+				   dtls_cid_own_len(context));
+}
+#endif /* DTLS_CID_SUPPORTED */
+
 static int tls_mbedtls_reset(struct tls_context *context)
 {
 	int ret;
@@ -1142,6 +1460,18 @@ static int tls_mbedtls_reset(struct tls_context *context)
 	}
 
 	k_sem_reset(&context->tls_established);
+	context->session_resumed = false;
+
+#if defined(DTLS_CID_SUPPORTED)
+	if (context->type == SOCK_DGRAM) {
+		context->dtls_pending_addrlen = 0;
+
+		ret = dtls_cid_set(context);
+		if (ret != 0) {
+			return ret;
+		}
+	}
+#endif
 
 #if defined(CONFIG_NET_SOCKETS_ENABLE_DTLS)
 	/* Server role: reset the address so that a new
@@ -1250,6 +1580,8 @@ static int tls_mbedtls_handshake(struct tls_context *context,
 		k_sem_give(&context->tls_established);
 	}
 
+	tls_handshake_stats_update(context, ret);
+
 	context->handshake_in_progress = false;
 
 	return ret;
@@ -1323,6 +1655,13 @@ static int tls_mbedtls_init(struct tls_context *context, bool is_server)
 					&context->config,
 					CONFIG_NET_SOCKETS_DTLS_TIMEOUT);
 		}
+
+#if defined(DTLS_CID_SUPPORTED)
+		ret = dtls_cid_conf(context);
+		if (ret != 0) {
+			return ret;
+		}
+#endif /* DTLS_CID_SUPPORTED */
 	}
 #endif /* CONFIG_NET_SOCKETS_ENABLE_DTLS */
 
@@ -1370,11 +1709,27 @@ static int tls_mbedtls_init(struct tls_context *context, bool is_server)
 	}
 #endif /* CONFIG_MBEDTLS_SSL_ALPN */
 
-#if defined(MBEDTLS_SSL_CACHE_C)
 	if (is_server && context->options.cache_enabled) {
-		mbedtls_ssl_conf_session_cache(&context->config, &server_cache,
-					       mbedtls_ssl_cache_get,
-					       mbedtls_ssl_cache_set);
+#if defined(MBEDTLS_SSL_CACHE_C)
+		mbedtls_ssl_conf_session_cache(&context->config, context,
+					       tls_server_cache_get,
+					       tls_server_cache_set);
+#endif
+#if defined(MBEDTLS_SSL_TICKET_C)
+		mbedtls_ssl_conf_session_tickets_cb(&context->config,
+						    tls_server_ticket_write,
+						    tls_server_ticket_parse,
+						    context);
+#endif
+	}
+
+#if defined(MBEDTLS_SSL_SESSION_TICKETS) && defined(MBEDTLS_SSL_CLI_C)
+	/* Tickets are of no use to clients which do not cache sessions. */
+	if (!is_server) {
+		mbedtls_ssl_conf_session_tickets(&context->config,
+				context->options.cache_enabled ?
+				MBEDTLS_SSL_SESSION_TICKETS_ENABLED :
+				MBEDTLS_SSL_SESSION_TICKETS_DISABLED);
 	}
 #endif
 
@@ -1387,6 +1742,15 @@ static int tls_mbedtls_init(struct tls_context *context, bool is_server)
 		return -ENOMEM;
 	}
 
+#if defined(DTLS_CID_SUPPORTED)
+	if (type == MBEDTLS_SSL_TRANSPORT_DATAGRAM) {
+		ret = dtls_cid_set(context);
+		if (ret != 0) {
+			return -EINVAL;
+		}
+	}
+#endif /* DTLS_CID_SUPPORTED */
+
 	context->is_initialized = true;
 
 	return 0;
@@ -1704,6 +2068,22 @@ static int tls_opt_session_cache_purge_set(struct tls_context *context,
 	return 0;
 }
 
+static int tls_opt_handshake_stats_get(struct tls_context *context,
+				       void *optval, socklen_t *optlen)
+{
+	ARG_UNUSED(context);
+
+	if (*optlen != sizeof(struct tls_handshake_stats)) {
+		return -EINVAL;
+	}
+
+	k_mutex_lock(&server_session_lock, K_FOREVER);
+	memcpy(optval, &handshake_stats, sizeof(handshake_stats));
+	k_mutex_unlock(&server_session_lock);
+
+	return 0;
+}
+
 static int tls_opt_peer_verify_set(struct tls_context *context,
 				   const void *optval, socklen_t optlen)
 {
@@ -1779,6 +2159,171 @@ static int tls_opt_dtls_role_set(struct tls_context *context,
 	return 0;
 }
 
+#if defined(DTLS_CID_SUPPORTED)
+static int tls_opt_dtls_cid_set(struct tls_context *context,
+				const void *optval, socklen_t optlen)
+{
+	int *cid;
+
+	if (!optval) {
+		return -EINVAL;
+	}
+
+	if (optlen != sizeof(int)) {
+		return -EINVAL;
+	}
+
+	/* Connection IDs exist only in DTLS */
+	if (context->type != SOCK_DGRAM) {
+		return -EINVAL;
+	}
+
+	/* The Connection ID is negotiated with the configuration of the
+	 * first handshake.
+	 */
+	if (context->is_initialized) {
+		return -EPERM;
+	}
+
+	cid = (int *)optval;
+	if (*cid != TLS_DTLS_CID_DISABLED &&
+	    *cid != TLS_DTLS_CID_SUPPORTED &&
+	    *cid != TLS_DTLS_CID_ENABLED) {
+		return -EINVAL;
+	}
+
+	context->options.dtls_cid = *cid;
+
+	return 0;
+}
+
+static int tls_opt_dtls_cid_get(struct tls_context *context,
+				void *optval, socklen_t *optlen)
+{
+	if (*optlen != sizeof(int)) {
+		return -EINVAL;
+	}
+
+	*(int *)optval = context->options.dtls_cid;
+
+	return 0;
+}
+
+static int tls_opt_dtls_cid_value_set(struct tls_context *context,
+				      const void *optval, socklen_t optlen)
+{
+	if (!optval) {
+		return -EINVAL;
+	}
+
+	if (optlen == 0 ||
+	    optlen > sizeof(context->options.dtls_cid_value)) {
+		return -EINVAL;
+	}
+
+	if (context->type != SOCK_DGRAM) {
+		return -EINVAL;
+	}
+
+	if (context->is_initialized) {
+		return -EPERM;
+	}
+
+	memcpy(context->options.dtls_cid_value, optval, optlen);
+	context->options.dtls_cid_len = optlen;
+
+	return 0;
+}
+
+static int tls_opt_dtls_cid_value_get(struct tls_context *context,
+				      void *optval, socklen_t *optlen)
+{
+	if (*optlen < context->options.dtls_cid_len) {
+		return -EINVAL;
+	}
+
+	memcpy(optval, context->options.dtls_cid_value,
+	       context->options.dtls_cid_len);
+	*optlen = context->options.dtls_cid_len;
+
+	return 0;
+}
+
+static int dtls_peer_cid_get(struct tls_context *context, uint8_t *peer_cid,
+			     size_t *peer_cid_len)
+{
+	int enabled;
+	int ret;
+
+	*peer_cid_len = 0;
+
+	if (!is_handshake_complete(context)) {
+		return -ENOTCONN;
+	}
+
+	ret = mbedtls_ssl_get_peer_cid(&context->ssl, &enabled, peer_cid,
+				       peer_cid_len);
+	if (ret != 0) {
+		return -EIO;
+	}
+
+	if (enabled != MBEDTLS_SSL_CID_ENABLED) {
+		*peer_cid_len = 0;
+		return -ENOENT;
+	}
+
+	return 0;
+}
+
+static int tls_opt_dtls_peer_cid_value_get(struct tls_context *context,
+					   void *optval, socklen_t *optlen)
+{
+	uint8_t peer_cid[MBEDTLS_SSL_CID_OUT_LEN_MAX];
+	size_t peer_cid_len;
+	int ret;
+
+	ret = dtls_peer_cid_get(context, peer_cid, &peer_cid_len);
+	if (ret == -ENOTCONN || ret == -EIO) {
+		return ret;
+	}
+
+	if (*optlen < peer_cid_len) {
+		return -EINVAL;
+	}
+
+	memcpy(optval, peer_cid, peer_cid_len);
+	*optlen = peer_cid_len;
+
+	return 0;
+}
+
+static int tls_opt_dtls_cid_status_get(struct tls_context *context,
+				       void *optval, socklen_t *optlen)
+{
+	uint8_t peer_cid[MBEDTLS_SSL_CID_OUT_LEN_MAX];
+	size_t peer_cid_len;
+	int status = TLS_DTLS_CID_STATUS_DISABLED;
+
+	if (*optlen != sizeof(int)) {
+		return -EINVAL;
+	}
+
+	if (dtls_peer_cid_get(context, peer_cid, &peer_cid_len) == 0) {
+		if (dtls_cid_own_len(context) > 0) {
+			status |= TLS_DTLS_CID_STATUS_DOWNLINK;
+		}
+
+		if (peer_cid_len > 0) {
+			status |= TLS_DTLS_CID_STATUS_UPLINK;
+		}
+	}
+
+	*(int *)optval = status;
+
+	return 0;
+}
+#endif /* DTLS_CID_SUPPORTED */
+
 static int protocol_check(int family, int type, int *proto)
 {
 	if (family != AF_INET && family != AF_INET6) {
@@ -2370,6 +2915,10 @@ static ssize_t recvfrom_dtls_common(struct tls_context *ctx, void *buf,
 			}
 		}
 
+#if defined(DTLS_CID_SUPPORTED)
+		dtls_peer_address_update(ctx);
+#endif
+
 		if (src_addr && addrlen) {
 			dtls_peer_address_get(ctx, src_addr, addrlen);
 		}
@@ -2388,17 +2937,20 @@ static ssize_t recvfrom_dtls_common(struct tls_context *ctx, void *buf,
 			ret += remaining;
 		}
 
-		for (int i = 0; i < remaining; i++) {
-			uint8_t byte;
+		while (remaining > 0) {
+			uint8_t discard[64];
 			int err;
 
-			err = mbedtls_ssl_read(&ctx->ssl, &byte, sizeof(byte));
+			err = mbedtls_ssl_read(&ctx->ssl, discard,
+					       MIN(remaining, sizeof(discard)));
 			if (err <= 0) {
 				NET_ERR("Error while flushing the rest of the"
 					" datagram, err %d", err);
 				ret = MBEDTLS_ERR_SSL_INTERNAL_ERROR;
 				break;
 			}
+
+			remaining -= err;
 		}
 
 		break;
@@ -3008,6 +3560,10 @@ int ztls_getsockopt_ctx(struct tls_context *ctx, int level, int optname,
 		err = tls_opt_session_cache_get(ctx, optval, optlen);
 		break;
 
+	case TLS_HANDSHAKE_STATS:
+		err = tls_opt_handshake_stats_get(ctx, optval, optlen);
+		break;
+
 #if defined(CONFIG_NET_SOCKETS_ENABLE_DTLS)
 	case TLS_DTLS_HANDSHAKE_TIMEOUT_MIN:
 		err = tls_opt_dtls_handshake_timeout_get(ctx, optval,
@@ -3020,6 +3576,24 @@ int ztls_getsockopt_ctx(struct tls_context *ctx, int level, int optname,
 		break;
 #endif /* CONFIG_NET_SOCKETS_ENABLE_DTLS */
 
+#if defined(DTLS_CID_SUPPORTED)
+	case TLS_DTLS_CID:
+		err = tls_opt_dtls_cid_get(ctx, optval, optlen);
+		break;
+
+	case TLS_DTLS_CID_VALUE:
+		err = tls_opt_dtls_cid_value_get(ctx, optval, optlen);
+		break;
+
+	case TLS_DTLS_PEER_CID_VALUE:
+		err = tls_opt_dtls_peer_cid_value_get(ctx, optval, optlen);
+		break;
+
+	case TLS_DTLS_CID_STATUS:
+		err = tls_opt_dtls_cid_status_get(ctx, optval, optlen);
+		break;
+#endif /* DTLS_CID_SUPPORTED */
+
 	default:
 		/* Unknown or write-only option. */
 		err = -ENOPROTOOPT;
@@ -3124,6 +3698,16 @@ int ztls_setsockopt_ctx(struct tls_context *ctx, int level, int optname,
 		break;
 #endif /* CONFIG_NET_SOCKETS_ENABLE_DTLS */
 
+#if defined(DTLS_CID_SUPPORTED)
+	case TLS_DTLS_CID:
+		err = tls_opt_dtls_cid_set(ctx, optval, optlen);
+		break;
+
+	case TLS_DTLS_CID_VALUE:
+		err = tls_opt_dtls_cid_value_set(ctx, optval, optlen);
+		break;
+#endif /* DTLS_CID_SUPPORTED */
+
 	case TLS_NATIVE:
 		/* Option handled at the socket dispatcher level. */
 		err = 0;
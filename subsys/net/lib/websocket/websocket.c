@@ -49,6 +49,10 @@ LOG_MODULE_REGISTER(net_websocket, CONFIG_NET_WEBSOCKET_LOG_LEVEL);
 
 static struct websocket_context contexts[CONFIG_WEBSOCKET_MAX_CONTEXTS];
 
+#if defined(CONFIG_WEBSOCKET_DEFLATE)
+static struct websocket_deflate deflate_states[CONFIG_WEBSOCKET_MAX_CONTEXTS];
+#endif
+
 static struct k_sem contexts_lock;
 
 static const struct socket_op_vtable websocket_fd_op_vtable;
@@ -176,6 +180,7 @@ static int on_header_field(struct http_parser *parser, const char *at,
 						internal.parser);
 	struct websocket_context *ctx = req->internal.user_data;
 	const char *ws_accept_str = "Sec-WebSocket-Accept";
+	const char *ws_extensions_str = "Sec-WebSocket-Extensions";
 	uint16_t len;
 
 	len = strlen(ws_accept_str);
@@ -183,6 +188,11 @@ static int on_header_field(struct http_parser *parser, const char *at,
 		ctx->sec_accept_present = true;
 	}
 
+	len = strlen(ws_extensions_str);
+	if (length >= len && strncasecmp(at, ws_extensions_str, len) == 0) {
+		ctx->extensions_present = true;
+	}
+
 	if (ctx->http_cb && ctx->http_cb->on_header_field) {
 		ctx->http_cb->on_header_field(parser, at, length);
 	}
@@ -221,6 +231,24 @@ static int on_header_value(struct http_parser *parser, const char *at,
 		}
 	}
 
+	if (ctx->extensions_present) {
+		ctx->extensions_present = false;
+
+		/* The server must not use an extension we did not offer */
+#if defined(CONFIG_WEBSOCKET_DEFLATE)
+		if (ctx->deflate_offered &&
+		    websocket_deflate_parse_response(ctx->deflate, at,
+						     length) == 0) {
+			ctx->deflate_enabled = true;
+		} else
+#endif
+		{
+			NET_DBG("[%p] Unsupported extensions %.*s", ctx,
+				(int)length, at);
+			ctx->extensions_rejected = true;
+		}
+	}
+
 	if (ctx->http_cb && ctx->http_cb->on_header_value) {
 		ctx->http_cb->on_header_value(parser, at, length);
 	}
@@ -251,6 +279,7 @@ int websocket_connect(int sock, struct websocket_request *wreq,
 		"Upgrade: websocket\r\n",
 		"Connection: Upgrade\r\n",
 		"Sec-WebSocket-Version: 13\r\n",
+		NULL,
 		NULL
 	};
 
@@ -278,6 +307,30 @@ int websocket_connect(int sock, struct websocket_request *wreq,
 	ctx->recv_buf.size = wreq->tmp_buf_len;
 	ctx->sec_accept_key = sec_accept_key;
 	ctx->http_cb = wreq->http_cb;
+	ctx->extensions_present = false;
+	ctx->extensions_rejected = false;
+	ctx->deflate_offered = false;
+	ctx->deflate_enabled = false;
+	ctx->rx_compressed = false;
+	ctx->rx_inflate = false;
+	ctx->rx_discard = false;
+
+#if defined(CONFIG_WEBSOCKET_DEFLATE)
+	ctx->deflate = &deflate_states[ctx - contexts];
+	ctx->deflate->rx_out_len = 0;
+	ctx->deflate->rx_out_pos = 0;
+
+	/* Each message is compressed on its own, which keeps the state
+	 * needed per connection small.
+	 */
+	if (wreq->permessage_deflate) {
+		headers[ARRAY_SIZE(headers) - 2] =
+			"Sec-WebSocket-Extensions: permessage-deflate; "
+			"client_no_context_takeover; "
+			"server_no_context_takeover\r\n";
+		ctx->deflate_offered = true;
+	}
+#endif
 
 	mbedtls_sha1((const unsigned char *)&rnd_value, sizeof(rnd_value),
 			 sec_accept_key);
@@ -353,13 +406,18 @@ int websocket_connect(int sock, struct websocket_request *wreq,
 		goto out;
 	}
 
-	if (!(ctx->all_received && ctx->sec_accept_ok)) {
-		NET_DBG("[%p] WS handshake failed (%d/%d)", ctx,
-			ctx->all_received, ctx->sec_accept_ok);
+	if (!(ctx->all_received && ctx->sec_accept_ok) ||
+	    ctx->extensions_rejected) {
+		NET_DBG("[%p] WS handshake failed (%d/%d/%d)", ctx,
+			ctx->all_received, ctx->sec_accept_ok,
+			ctx->extensions_rejected);
 		ret = -ECONNABORTED;
 		goto out;
 	}
 
+	NET_DBG("[%p] permessage-deflate %s", ctx,
+		ctx->deflate_enabled ? "enabled" : "disabled");
+
 	ctx->user_data = user_data;
 
 	fd = z_reserve_fd();
@@ -534,6 +592,39 @@ static int websocket_ioctl_vmeth(void *obj, unsigned int request, va_list args)
 	return 0;
 }
 
+/* Mask or unmask len bytes, offset is the position of the first byte in the
+ * frame payload. The data is processed a word at a time, src and dst can be
+ * the same buffer.
+ */
+static void websocket_mask(uint8_t *dst, const uint8_t *src, size_t len,
+			   uint32_t masking_value, uint64_t offset)
+{
+	unsigned int shift = (offset % 4) * 8;
+	uint8_t key[4];
+	uint32_t key_word;
+	uint32_t word;
+	size_t i;
+
+	/* Rotate the key so that it starts with the byte for this offset */
+	if (shift > 0) {
+		masking_value = (masking_value << shift) |
+				(masking_value >> (32 - shift));
+	}
+
+	sys_put_be32(masking_value, key);
+	memcpy(&key_word, key, sizeof(key_word));
+
+	for (i = 0; i + sizeof(word) <= len; i += sizeof(word)) {
+		memcpy(&word, &src[i], sizeof(word));
+		word ^= key_word;
+		memcpy(&dst[i], &word, sizeof(word));
+	}
+
+	for (; i < len; i++) {
+		dst[i] = src[i] ^ key[i % 4];
+	}
+}
+
 #if !defined(CONFIG_NET_TEST)
 static int sendmsg_all(int sock, const struct msghdr *message, int flags)
 {
@@ -576,16 +667,17 @@ static int sendmsg_all(int sock, const struct msghdr *message, int flags)
 
 static int websocket_prepare_and_send(struct websocket_context *ctx,
 				      uint8_t *header, size_t header_len,
-				      uint8_t *payload, size_t payload_len,
-				      int32_t timeout)
+				      const uint8_t *payload, size_t payload_len,
+				      bool mask, int32_t timeout)
 {
 	struct iovec io_vector[2];
 	struct msghdr msg;
+	size_t offset = 0;
+	int total = 0;
+	int ret;
 
 	io_vector[0].iov_base = header;
 	io_vector[0].iov_len = header_len;
-	io_vector[1].iov_base = payload;
-	io_vector[1].iov_len = payload_len;
 
 	memset(&msg, 0, sizeof(msg));
 
@@ -601,21 +693,56 @@ static int websocket_prepare_and_send(struct websocket_context *ctx,
 		}
 	}
 
-#if defined(CONFIG_NET_TEST)
-	/* Simulate a case where the payload is split to two. The unit test
-	 * does not set mask bit in this case.
-	 */
-	return verify_sent_and_received_msg(&msg, !(header[1] & BIT(7)));
-#else
+#if !defined(CONFIG_NET_TEST)
 	k_timeout_t tout = K_FOREVER;
 
 	if (timeout != SYS_FOREVER_MS) {
 		tout = K_MSEC(timeout);
 	}
+#endif
+
+	/* The payload is masked into the tx buffer a chunk at a time and
+	 * sent together with the header, so the user data is never copied
+	 * as a whole.
+	 */
+	do {
+		size_t len = payload_len - offset;
+
+		if (len == 0) {
+			io_vector[1].iov_base = NULL;
+		} else if (mask) {
+			len = MIN(len, sizeof(ctx->tx_buf));
+			websocket_mask(ctx->tx_buf, &payload[offset], len,
+				       ctx->masking_value, offset);
+			io_vector[1].iov_base = ctx->tx_buf;
+		} else {
+			io_vector[1].iov_base = (void *)&payload[offset];
+		}
+
+		io_vector[1].iov_len = len;
 
-	return sendmsg_all(ctx->real_sock, &msg,
-			   K_TIMEOUT_EQ(tout, K_NO_WAIT) ? MSG_DONTWAIT : 0);
+#if defined(CONFIG_NET_TEST)
+		/* Simulate a case where the payload is split to two. The unit
+		 * test does not set mask bit in this case.
+		 */
+		ret = verify_sent_and_received_msg(&msg, !(header[1] & BIT(7)));
+#else
+		ret = sendmsg_all(ctx->real_sock, &msg,
+				  K_TIMEOUT_EQ(tout, K_NO_WAIT) ? MSG_DONTWAIT : 0);
 #endif /* CONFIG_NET_TEST */
+		if (ret < 0) {
+			return ret;
+		}
+
+		total += ret;
+		offset += len;
+
+		/* The rest of the chunks are sent without the header */
+		msg.msg_iov = &io_vector[1];
+		msg.msg_iovlen = 1;
+	} while (offset < payload_len);
+
+	return total;
 }
 
 int websocket_send_msg(int ws_sock, const uint8_t *payload, size_t payload_len,
@@ -624,7 +751,10 @@ int websocket_send_msg(int ws_sock, const uint8_t *payload, size_t payload_len,
 {
 	struct websocket_context *ctx;
 	uint8_t header[MAX_HEADER_LEN], hdr_len = 2;
-	uint8_t *data_to_send = (uint8_t *)payload;
+	const uint8_t *data_to_send = payload;
+	size_t data_len = payload_len;
+	bool mask_data = mask;
+	bool compressed = false;
 	int ret;
 
 	if (opcode != WEBSOCKET_OPCODE_DATA_TEXT &&
@@ -662,15 +792,36 @@ int websocket_send_msg(int ws_sock, const uint8_t *payload, size_t payload_len,
 	/* Text, binary, ping, pong or close ? */
 	header[0] |= opcode;
 
+#if defined(CONFIG_WEBSOCKET_DEFLATE)
+	/* Only unfragmented data messages are compressed, and only if it
+	 * makes them smaller.
+	 */
+	if (ctx->deflate_enabled && final &&
+	    (opcode == WEBSOCKET_OPCODE_DATA_TEXT ||
+	     opcode == WEBSOCKET_OPCODE_DATA_BINARY) &&
+	    payload_len >= CONFIG_WEBSOCKET_DEFLATE_MIN_SIZE) {
+		ret = websocket_deflate_compress(ctx->deflate, payload,
+						 payload_len, ctx->deflate->tx,
+						 sizeof(ctx->deflate->tx));
+		if (ret > 0 && ret < payload_len) {
+			/* RSV1 marks a compressed message */
+			header[0] |= BIT(6);
+			data_to_send = ctx->deflate->tx;
+			data_len = ret;
+			compressed = true;
+		}
+	}
+#endif
+
 	/* Masking */
 	header[1] = mask ? BIT(7) : 0;
 
-	if (payload_len < 126) {
-		header[1] |= payload_len;
-	} else if (payload_len < 65536) {
+	if (data_len < 126) {
+		header[1] |= data_len;
+	} else if (data_len < 65536) {
 		header[1] |= 126;
-		header[2] = payload_len >> 8;
-		header[3] = payload_len;
+		header[2] = data_len >> 8;
+		header[3] = data_len;
 		hdr_len += 2;
 	} else {
 		header[1] |= 127;
@@ -678,17 +829,15 @@ int websocket_send_msg(int ws_sock, const uint8_t *payload, size_t payload_len,
 		header[3] = 0;
 		header[4] = 0;
 		header[5] = 0;
-		header[6] = payload_len >> 24;
-		header[7] = payload_len >> 16;
-		header[8] = payload_len >> 8;
-		header[9] = payload_len;
+		header[6] = data_len >> 24;
+		header[7] = data_len >> 16;
+		header[8] = data_len >> 8;
+		header[9] = data_len;
 		hdr_len += 8;
 	}
 
 	/* Add masking value if needed */
 	if (mask) {
-		int i;
-
 		ctx->masking_value = sys_rand32_get();
 
 		header[hdr_len++] |= ctx->masking_value >> 24;
@@ -696,30 +845,20 @@ int websocket_send_msg(int ws_sock, const uint8_t *payload, size_t payload_len,
 		header[hdr_len++] |= ctx->masking_value >> 8;
 		header[hdr_len++] |= ctx->masking_value;
 
-		if ((payload != NULL) && (payload_len > 0)) {
-			data_to_send = k_malloc(payload_len);
-			if (!data_to_send) {
-				return -ENOMEM;
-			}
-
-			memcpy(data_to_send, payload, payload_len);
-
-			for (i = 0; i < payload_len; i++) {
-				data_to_send[i] ^= ctx->masking_value >> (8 * (3 - i % 4));
-			}
+#if defined(CONFIG_WEBSOCKET_DEFLATE)
+		/* The compressed data is ours so it can be masked in place */
+		if (compressed) {
+			websocket_mask(ctx->deflate->tx, ctx->deflate->tx,
+				       data_len, ctx->masking_value, 0);
+			mask_data = false;
 		}
+#endif
 	}
 
-	ret = websocket_prepare_and_send(ctx, header, hdr_len,
-					 data_to_send, payload_len, timeout);
+	ret = websocket_prepare_and_send(ctx, header, hdr_len, data_to_send,
+					 data_len, mask_data, timeout);
 	if (ret < 0) {
-		NET_DBG("Cannot send ws msg (%d)", -errno);
-		goto quit;
-	}
-
-quit:
-	if (data_to_send != payload) {
-		k_free(data_to_send);
+		NET_DBG("Cannot send ws msg (%d)", ret);
 	}
 
 	/* Do no math with 0 and error codes */
@@ -727,6 +866,11 @@ quit:
 		return ret;
 	}
 
+	/* The caller is interested in how much of its data was sent */
+	if (compressed) {
+		return payload_len;
+	}
+
 	return ret - hdr_len;
 }
 
@@ -749,6 +893,78 @@ static uint32_t websocket_opcode2flag(uint8_t data)
 	return 0;
 }
 
+#if defined(CONFIG_WEBSOCKET_DEFLATE)
+static void websocket_deflate_frame_start(struct websocket_context *ctx,
+					  uint8_t data)
+{
+	uint8_t opcode = data & 0x0f;
+
+	/* RSV1 is only set in the first frame of a compressed message */
+	if (opcode == WEBSOCKET_OPCODE_DATA_TEXT ||
+	    opcode == WEBSOCKET_OPCODE_DATA_BINARY) {
+		ctx->rx_compressed = (data & BIT(6)) != 0;
+		ctx->rx_discard = false;
+		ctx->deflate->rx_in_len = 0;
+		ctx->deflate->rx_msg_type = websocket_opcode2flag(data);
+	}
+
+	/* Control frames can be sent between the fragments of a message */
+	ctx->rx_inflate = ctx->rx_compressed && !(opcode & 0x08);
+}
+
+static int websocket_inflate(struct websocket_context *ctx)
+{
+	static const uint8_t trailer[WS_DEFLATE_TRAILER_LEN] = {
+		0x00, 0x00, 0xff, 0xff
+	};
+	struct websocket_deflate *deflate = ctx->deflate;
+	int ret;
+
+	ctx->rx_compressed = false;
+
+	memcpy(&deflate->rx_in[deflate->rx_in_len], trailer, sizeof(trailer));
+
+	ret = websocket_deflate_decompress(deflate, deflate->rx_in,
+					   deflate->rx_in_len + sizeof(trailer),
+					   deflate->rx_out,
+					   sizeof(deflate->rx_out));
+	if (ret < 0) {
+		NET_DBG("[%p] Cannot decompress msg (%d)", ctx, ret);
+		return ret;
+	}
+
+	NET_DBG("[%p] Decompressed %zd bytes to %d", ctx, deflate->rx_in_len,
+		ret);
+
+	deflate->rx_out_len = ret;
+	deflate->rx_out_pos = 0;
+	deflate->rx_msg_type |= WEBSOCKET_FLAG_FINAL;
+
+	return 0;
+}
+
+static int websocket_inflated_copy(struct websocket_context *ctx,
+				   uint8_t *buf, size_t buf_len,
+				   uint32_t *message_type, uint64_t *remaining)
+{
+	struct websocket_deflate *deflate = ctx->deflate;
+	size_t len = MIN(buf_len, deflate->rx_out_len - deflate->rx_out_pos);
+
+	memcpy(buf, &deflate->rx_out[deflate->rx_out_pos], len);
+	deflate->rx_out_pos += len;
+
+	if (remaining != NULL) {
+		*remaining = deflate->rx_out_len - deflate->rx_out_pos;
+	}
+
+	if (message_type != NULL) {
+		*message_type = deflate->rx_msg_type;
+	}
+
+	return len;
+}
+#endif /* CONFIG_WEBSOCKET_DEFLATE */
+
 static int websocket_parse(struct websocket_context *ctx, struct websocket_buffer *payload)
 {
 	int len;
@@ -768,6 +984,11 @@ static int websocket_parse(struct websocket_context *ctx, struct websocket_buffe
 				if ((data & 0x80) != 0) {
 					ctx->message_type |= WEBSOCKET_FLAG_FINAL;
 				}
+#if defined(CONFIG_WEBSOCKET_DEFLATE)
+				if (ctx->deflate_enabled) {
+					websocket_deflate_frame_start(ctx, data);
+				}
+#endif
 				ctx->parser_state = WEBSOCKET_PARSER_STATE_LENGTH;
 				break;
 			case WEBSOCKET_PARSER_STATE_LENGTH:
@@ -834,21 +1055,71 @@ static int websocket_parse(struct websocket_context *ctx, struct websocket_buffe
 			}
 #endif
 		} else {
+			struct websocket_buffer *dst = payload;
 			size_t remaining_in_recv_buf = ctx->recv_buf.count - parsed_count;
 			size_t payload_in_recv_buf =
 				MIN(remaining_in_recv_buf, ctx->parser_remaining);
-			size_t free_in_payload_buf = payload->size - payload->count;
-			size_t ready_to_copy = MIN(payload_in_recv_buf, free_in_payload_buf);
+			size_t free_in_payload_buf;
+			size_t ready_to_copy;
+
+#if defined(CONFIG_WEBSOCKET_DEFLATE)
+			struct websocket_buffer compressed;
+
+			/* Compressed data is collected until the message is
+			 * complete and can be decompressed. The rest of a
+			 * message that does not fit is skipped up to its last
+			 * frame, so that the next message can be received.
+			 */
+			if (ctx->rx_inflate) {
+				compressed.buf = ctx->deflate->rx_in;
+				compressed.size = CONFIG_WEBSOCKET_DEFLATE_BUF_SIZE;
+				compressed.count = ctx->deflate->rx_in_len;
+				dst = &compressed;
+
+				if (!ctx->rx_discard &&
+				    ctx->parser_remaining > compressed.size - compressed.count) {
+					NET_DBG("[%p] Compressed msg too long", ctx);
+					ctx->rx_discard = true;
+				}
+
+				if (ctx->rx_discard) {
+					parsed_count += payload_in_recv_buf;
+					ctx->parser_remaining -= payload_in_recv_buf;
+					if (ctx->parser_remaining == 0) {
+						ctx->parser_state = WEBSOCKET_PARSER_STATE_OPCODE;
+					}
+
+					continue;
+				}
+			}
+#endif
+
+			free_in_payload_buf = dst->size - dst->count;
+			ready_to_copy = MIN(payload_in_recv_buf, free_in_payload_buf);
 
 			if (free_in_payload_buf == 0) {
 				break;
 			}
 
-			memcpy(&payload->buf[payload->count], &ctx->recv_buf.buf[parsed_count],
-			       ready_to_copy);
+			if (ctx->masked) {
+				websocket_mask(&dst->buf[dst->count],
+					       &ctx->recv_buf.buf[parsed_count],
+					       ready_to_copy, ctx->masking_value,
+					       ctx->message_len - ctx->parser_remaining);
+			} else {
+				memcpy(&dst->buf[dst->count],
+				       &ctx->recv_buf.buf[parsed_count], ready_to_copy);
+			}
+
 			parsed_count += ready_to_copy;
-			payload->count += ready_to_copy;
+			dst->count += ready_to_copy;
 			ctx->parser_remaining -= ready_to_copy;
+
+#if defined(CONFIG_WEBSOCKET_DEFLATE)
+			if (dst != payload) {
+				ctx->deflate->rx_in_len = compressed.count;
+			}
+#endif
 			if (ctx->parser_remaining == 0) {
 				ctx->parser_remaining = 0;
 				ctx->parser_state = WEBSOCKET_PARSER_STATE_OPCODE;
@@ -955,6 +1226,15 @@ int websocket_recv_msg(int ws_sock, uint8_t *buf, size_t buf_len,
 	}
 #endif /* CONFIG_NET_TEST */
 
+#if defined(CONFIG_WEBSOCKET_DEFLATE)
+	/* Return the rest of a decompressed message first */
+	if (ctx->deflate_enabled &&
+	    ctx->deflate->rx_out_pos < ctx->deflate->rx_out_len) {
+		return websocket_inflated_copy(ctx, buf, buf_len, message_type,
+					       remaining);
+	}
+#endif
+
 	do {
 		size_t parsed_count;
 
@@ -987,7 +1267,7 @@ int websocket_recv_msg(int ws_sock, uint8_t *buf, size_t buf_len,
 
 			if (ret < 0) {
 				if ((ret == -EAGAIN) && (payload.count > 0)) {
-					/* go to unmasking */
+					/* return what we have so far */
 					break;
 				}
 				return ret;
@@ -1009,6 +1289,38 @@ int websocket_recv_msg(int ws_sock, uint8_t *buf, size_t buf_len,
 		}
 		parsed_count = ret;
 
+#if defined(CONFIG_WEBSOCKET_DEFLATE)
+		if (ctx->rx_inflate &&
+		    ctx->parser_state == WEBSOCKET_PARSER_STATE_OPCODE) {
+			size_t left = ctx->recv_buf.count - parsed_count;
+
+			if (left > 0) {
+				memmove(ctx->recv_buf.buf, &ctx->recv_buf.buf[parsed_count], left);
+			}
+			ctx->recv_buf.count = left;
+			ctx->rx_inflate = false;
+
+			/* Wait for the rest of the message */
+			if (!(ctx->message_type & WEBSOCKET_FLAG_FINAL)) {
+				continue;
+			}
+
+			if (ctx->rx_discard) {
+				ctx->rx_discard = false;
+				ctx->rx_compressed = false;
+				return -EMSGSIZE;
+			}
+
+			ret = websocket_inflate(ctx);
+			if (ret < 0) {
+				return ret;
+			}
+
+			return websocket_inflated_copy(ctx, buf, buf_len,
+						       message_type, remaining);
+		}
+#endif
+
 		if ((ctx->parser_state == WEBSOCKET_PARSER_STATE_OPCODE) ||
 		    (payload.count >= payload.size)) {
 			if (remaining != NULL) {
@@ -1031,19 +1343,6 @@ int websocket_recv_msg(int ws_sock, uint8_t *buf, size_t buf_len,
 
 	} while (true);
 
-	/* Unmask the data */
-	if (ctx->masked) {
-		uint8_t *mask_as_bytes = (uint8_t *)&ctx->masking_value;
-		size_t data_buf_offset = ctx->message_len - ctx->parser_remaining - payload.count;
-
-		for (size_t i = 0; i < payload.count; i++) {
-			size_t m = data_buf_offset % 4;
-
-			payload.buf[i] ^= mask_as_bytes[3 - m];
-			data_buf_offset++;
-		}
-	}
-
 	return payload.count;
 }
 
@@ -0,0 +1,690 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* DEFLATE (RFC 1951) support for the permessage-deflate Websocket extension
+ * (RFC 7692). Outgoing messages are compressed with fixed Huffman codes and
+ * a single entry hash to find repeated strings, which is cheap and works
+ * well for the small text messages the extension is meant for. Incoming
+ * messages can use any block type.
+ */
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(net_websocket, CONFIG_NET_WEBSOCKET_LOG_LEVEL);
+
+#include <zephyr/kernel.h>
+#include <errno.h>
+#include <string.h>
+#include <strings.h>
+#include <stdlib.h>
+
+#include "websocket_internal.h"
+
+#define MAX_BITS 15
+#define MIN_MATCH 3
+#define MAX_MATCH 258
+#define NUM_LEN_CODES 29
+#define NUM_DIST_CODES 30
+#define END_OF_BLOCK 256
+
+#define BTYPE_STORED 0
+#define BTYPE_FIXED 1
+#define BTYPE_DYNAMIC 2
+
+static const uint16_t len_base[NUM_LEN_CODES] = {
+	3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+	35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+};
+
+static const uint8_t len_extra[NUM_LEN_CODES] = {
+	0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+	3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+};
+
+static const uint16_t dist_base[NUM_DIST_CODES] = {
+	1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+	257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145,
+	8193, 12289, 16385, 24577
+};
+
+static const uint8_t dist_extra[NUM_DIST_CODES] = {
+	0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+	7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+};
+
+/* Order of the code length code lengths in a dynamic block header */
+static const uint8_t clen_order[19] = {
+	16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15
+};
+
+struct bit_writer {
+	uint8_t *out;
+	size_t size;
+	size_t pos;
+	uint32_t bits;
+	uint8_t count;
+	bool overflow;
+};
+
+struct bit_reader {
+	const uint8_t *in;
+	size_t len;
+	size_t pos;
+	uint32_t bits;
+	uint8_t count;
+	bool error;
+};
+
+static void put_bits(struct bit_writer *bw, uint32_t value, uint8_t count)
+{
+	bw->bits |= value << bw->count;
+	bw->count += count;
+
+	while (bw->count >= 8) {
+		if (bw->pos < bw->size) {
+			bw->out[bw->pos++] = bw->bits;
+		} else {
+			bw->overflow = true;
+		}
+
+		bw->bits >>= 8;
+		bw->count -= 8;
+	}
+}
+
+/* Huffman codes are stored starting from their most significant bit */
+static void put_code(struct bit_writer *bw, uint32_t code, uint8_t len)
+{
+	uint32_t reversed = 0;
+	uint8_t i;
+
+	for (i = 0; i < len; i++) {
+		reversed = (reversed << 1) | ((code >> i) & 1);
+	}
+
+	put_bits(bw, reversed, len);
+}
+
+static void put_fixed_symbol(struct bit_writer *bw, uint16_t symbol)
+{
+	if (symbol < 144) {
+		put_code(bw, 0x30 + symbol, 8);
+	} else if (symbol < 256) {
+		put_code(bw, 0x190 + symbol - 144, 9);
+	} else if (symbol < 280) {
+		put_code(bw, symbol - 256, 7);
+	} else {
+		put_code(bw, 0xc0 + symbol - 280, 8);
+	}
+}
+
+static void put_match(struct bit_writer *bw, uint16_t len, uint16_t dist)
+{
+	int code;
+
+	for (code = NUM_LEN_CODES - 1; len_base[code] > len; code--) {
+	}
+
+	put_fixed_symbol(bw, END_OF_BLOCK + 1 + code);
+	put_bits(bw, len - len_base[code], len_extra[code]);
+
+	for (code = NUM_DIST_CODES - 1; dist_base[code] > dist; code--) {
+	}
+
+	put_code(bw, code, 5);
+	put_bits(bw, dist - dist_base[code], dist_extra[code]);
+}
+
+static inline uint32_t hash3(const uint8_t *data)
+{
+	uint32_t value = (data[0] << 16) | (data[1] << 8) | data[2];
+
+	return (value * 2654435761U) >> (32 - WS_DEFLATE_HASH_BITS);
+}
+
+int websocket_deflate_compress(struct websocket_deflate *deflate,
+			       const uint8_t *in, size_t in_len,
+			       uint8_t *out, size_t out_size)
+{
+	struct bit_writer bw = {
+		.out = out,
+		.size = out_size,
+	};
+	size_t max_dist = MIN(1U << deflate->client_window_bits,
+			      dist_base[NUM_DIST_CODES - 1] +
+			      BIT(dist_extra[NUM_DIST_CODES - 1]) - 1);
+	size_t pos = 0;
+
+	/* Positions are stored in 16 bits */
+	if (in_len >= UINT16_MAX) {
+		return -ENOSPC;
+	}
+
+	memset(deflate->hash_head, 0, sizeof(deflate->hash_head));
+
+	/* Single non final block with fixed codes */
+	put_bits(&bw, 0, 1);
+	put_bits(&bw, BTYPE_FIXED, 2);
+
+	while (pos < in_len && !bw.overflow) {
+		size_t len = 0;
+		size_t dist = 0;
+
+		if (pos + MIN_MATCH <= in_len) {
+			uint32_t hash = hash3(&in[pos]);
+			size_t candidate = deflate->hash_head[hash];
+
+			deflate->hash_head[hash] = pos + 1;
+
+			if (candidate > 0 && pos - (candidate - 1) <= max_dist) {
+				size_t max_len = MIN(in_len - pos, MAX_MATCH);
+
+				candidate--;
+
+				while (len < max_len &&
+				       in[candidate + len] == in[pos + len]) {
+					len++;
+				}
+
+				dist = pos - candidate;
+			}
+		}
+
+		if (len < MIN_MATCH) {
+			put_fixed_symbol(&bw, in[pos++]);
+			continue;
+		}
+
+		put_match(&bw, len, dist);
+
+		/* Remember the strings inside the match for the next ones */
+		for (len += pos, pos++; pos < len; pos++) {
+			if (pos + MIN_MATCH <= in_len) {
+				deflate->hash_head[hash3(&in[pos])] = pos + 1;
+			}
+		}
+	}
+
+	put_fixed_symbol(&bw, END_OF_BLOCK);
+
+	/* Empty stored block, the receiver appends its LEN and NLEN fields */
+	put_bits(&bw, 0, 1);
+	put_bits(&bw, BTYPE_STORED, 2);
+
+	if (bw.count > 0) {
+		put_bits(&bw, 0, 8 - bw.count);
+	}
+
+	if (bw.overflow) {
+		return -ENOSPC;
+	}
+
+	return bw.pos;
+}
+
+static uint32_t get_bits(struct bit_reader *br, uint8_t count)
+{
+	uint32_t value;
+
+	while (br->count < count) {
+		if (br->pos >= br->len) {
+			br->error = true;
+			return 0;
+		}
+
+		br->bits |= (uint32_t)br->in[br->pos++] << br->count;
+		br->count += 8;
+	}
+
+	value = br->bits & (BIT(count) - 1);
+	br->bits >>= count;
+	br->count -= count;
+
+	return value;
+}
+
+/* Build the decoding table, returns 0 for a complete code, >0 for an
+ * incomplete one and <0 for an over-subscribed one.
+ */
+static int huffman_build(struct websocket_huffman *h, const uint16_t *lengths,
+			 int num)
+{
+	uint16_t offs[MAX_BITS + 1];
+	int symbol;
+	int left;
+	int len;
+
+	memset(h->count, 0, sizeof(h->count));
+
+	for (symbol = 0; symbol < num; symbol++) {
+		h->count[lengths[symbol]]++;
+	}
+
+	if (h->count[0] == num) {
+		return 0;
+	}
+
+	left = 1;
+	for (len = 1; len <= MAX_BITS; len++) {
+		left <<= 1;
+		left -= h->count[len];
+		if (left < 0) {
+			return left;
+		}
+	}
+
+	offs[1] = 0;
+	for (len = 1; len < MAX_BITS; len++) {
+		offs[len + 1] = offs[len] + h->count[len];
+	}
+
+	for (symbol = 0; symbol < num; symbol++) {
+		if (lengths[symbol] != 0) {
+			h->symbol[offs[lengths[symbol]]++] = symbol;
+		}
+	}
+
+	return left;
+}
+
+static int huffman_decode(struct bit_reader *br,
+			  const struct websocket_huffman *h)
+{
+	int first = 0;
+	int index = 0;
+	int code = 0;
+	int count;
+	int len;
+
+	for (len = 1; len <= MAX_BITS; len++) {
+		code |= get_bits(br, 1);
+		count = h->count[len];
+
+		if (code - count < first) {
+			return h->symbol[index + (code - first)];
+		}
+
+		index += count;
+		first += count;
+		first <<= 1;
+		code <<= 1;
+	}
+
+	return -EINVAL;
+}
+
+struct inflate_out {
+	uint8_t *buf;
+	size_t size;
+	size_t len;
+};
+
+static int inflate_stored(struct bit_reader *br, struct inflate_out *out)
+{
+	uint16_t len;
+	uint16_t nlen;
+
+	/* Stored data starts on a byte boundary */
+	br->bits = 0;
+	br->count = 0;
+
+	if (br->len - br->pos < 4) {
+		return -EINVAL;
+	}
+
+	len = br->in[br->pos] | (br->in[br->pos + 1] << 8);
+	nlen = br->in[br->pos + 2] | (br->in[br->pos + 3] << 8);
+	br->pos += 4;
+
+	if (len != (uint16_t)~nlen || br->len - br->pos < len) {
+		return -EINVAL;
+	}
+
+	if (out->size - out->len < len) {
+		return -EMSGSIZE;
+	}
+
+	memcpy(&out->buf[out->len], &br->in[br->pos], len);
+	out->len += len;
+	br->pos += len;
+
+	return 0;
+}
+
+static int inflate_codes(struct bit_reader *br, struct inflate_out *out,
+			 const struct websocket_huffman *lencode,
+			 const struct websocket_huffman *distcode)
+{
+	int symbol;
+
+	do {
+		size_t dist;
+		size_t len;
+
+		symbol = huffman_decode(br, lencode);
+		if (symbol < 0 || br->error) {
+			return -EINVAL;
+		}
+
+		if (symbol < END_OF_BLOCK) {
+			if (out->len >= out->size) {
+				return -EMSGSIZE;
+			}
+
+			out->buf[out->len++] = symbol;
+			continue;
+		}
+
+		if (symbol == END_OF_BLOCK) {
+			break;
+		}
+
+		symbol -= END_OF_BLOCK + 1;
+		if (symbol >= NUM_LEN_CODES) {
+			return -EINVAL;
+		}
+
+		len = len_base[symbol] + get_bits(br, len_extra[symbol]);
+
+		symbol = huffman_decode(br, distcode);
+		if (symbol < 0 || symbol >= NUM_DIST_CODES) {
+			return -EINVAL;
+		}
+
+		dist = dist_base[symbol] + get_bits(br, dist_extra[symbol]);
+		if (br->error || dist > out->len) {
+			return -EINVAL;
+		}
+
+		if (out->size - out->len < len) {
+			return -EMSGSIZE;
+		}
+
+		/* The copy can overlap the data it produces */
+		while (len--) {
+			out->buf[out->len] = out->buf[out->len - dist];
+			out->len++;
+		}
+	} while (true);
+
+	return 0;
+}
+
+static int inflate_fixed(struct websocket_deflate *deflate,
+			 struct bit_reader *br, struct inflate_out *out)
+{
+	uint16_t *lengths = deflate->lengths;
+	int symbol;
+
+	for (symbol = 0; symbol < 144; symbol++) {
+		lengths[symbol] = 8;
+	}
+
+	for (; symbol < 256; symbol++) {
+		lengths[symbol] = 9;
+	}
+
+	for (; symbol < 280; symbol++) {
+		lengths[symbol] = 7;
+	}
+
+	for (; symbol < 288; symbol++) {
+		lengths[symbol] = 8;
+	}
+
+	(void)huffman_build(&deflate->lencode, lengths, 288);
+
+	for (symbol = 0; symbol < NUM_DIST_CODES; symbol++) {
+		lengths[symbol] = 5;
+	}
+
+	(void)huffman_build(&deflate->distcode, lengths, NUM_DIST_CODES);
+
+	return inflate_codes(br, out, &deflate->lencode, &deflate->distcode);
+}
+
+static int inflate_dynamic(struct websocket_deflate *deflate,
+			   struct bit_reader *br, struct inflate_out *out)
+{
+	uint16_t *lengths = deflate->lengths;
+	int nlen, ndist, ncode;
+	int index;
+	int err;
+
+	nlen = get_bits(br, 5) + 257;
+	ndist = get_bits(br, 5) + 1;
+	ncode = get_bits(br, 4) + 4;
+
+	if (nlen > 286 || ndist > NUM_DIST_CODES) {
+		return -EINVAL;
+	}
+
+	for (index = 0; index < ARRAY_SIZE(clen_order); index++) {
+		lengths[clen_order[index]] =
+			index < ncode ? get_bits(br, 3) : 0;
+	}
+
+	/* Code length codes must be complete */
+	if (huffman_build(&deflate->lencode, lengths, 19) != 0) {
+		return -EINVAL;
+	}
+
+	index = 0;
+	while (index < nlen + ndist) {
+		uint16_t len = 0;
+		int symbol;
+		int repeat;
+
+		symbol = huffman_decode(br, &deflate->lencode);
+		if (symbol < 0 || br->error) {
+			return -EINVAL;
+		}
+
+		if (symbol < 16) {
+			lengths[index++] = symbol;
+			continue;
+		}
+
+		if (symbol == 16) {
+			if (index == 0) {
+				return -EINVAL;
+			}
+
+			len = lengths[index - 1];
+			repeat = 3 + get_bits(br, 2);
+		} else if (symbol == 17) {
+			repeat = 3 + get_bits(br, 3);
+		} else {
+			repeat = 11 + get_bits(br, 7);
+		}
+
+		if (index + repeat > nlen + ndist) {
+			return -EINVAL;
+		}
+
+		while (repeat--) {
+			lengths[index++] = len;
+		}
+	}
+
+	if (br->error || lengths[END_OF_BLOCK] == 0) {
+		return -EINVAL;
+	}
+
+	/* Only a single code of length one may be left incomplete */
+	err = huffman_build(&deflate->lencode, lengths, nlen);
+	if (err < 0 || (err > 0 && nlen - deflate->lencode.count[0] != 1)) {
+		return -EINVAL;
+	}
+
+	err = huffman_build(&deflate->distcode, lengths + nlen, ndist);
+	if (err < 0 || (err > 0 && ndist - deflate->distcode.count[0] != 1)) {
+		return -EINVAL;
+	}
+
+	return inflate_codes(br, out, &deflate->lencode, &deflate->distcode);
+}
+
+int websocket_deflate_decompress(struct websocket_deflate *deflate,
+				 const uint8_t *in, size_t in_len,
+				 uint8_t *out, size_t out_size)
+{
+	struct bit_reader br = {
+		.in = in,
+		.len = in_len,
+	};
+	struct inflate_out output = {
+		.buf = out,
+		.size = out_size,
+	};
+	uint32_t last;
+	int ret;
+
+	do {
+		last = get_bits(&br, 1);
+
+		switch (get_bits(&br, 2)) {
+		case BTYPE_STORED:
+			ret = inflate_stored(&br, &output);
+			break;
+		case BTYPE_FIXED:
+			ret = inflate_fixed(deflate, &br, &output);
+			break;
+		case BTYPE_DYNAMIC:
+			ret = inflate_dynamic(deflate, &br, &output);
+			break;
+		default:
+			ret = -EINVAL;
+			break;
+		}
+
+		if (ret < 0) {
+			return ret;
+		}
+
+		if (br.error) {
+			return -EINVAL;
+		}
+	} while (!last && br.pos < br.len);
+
+	return output.len;
+}
+
+static bool param_is(const char *param, size_t len, const char *name)
+{
+	return len == strlen(name) && strncasecmp(param, name, len) == 0;
+}
+
+static int parse_window_bits(const char *value, size_t len, uint8_t *bits)
+{
+	char str[3];
+	int val;
+
+	/* The value can be a quoted string */
+	if (len >= 2 && value[0] == '"' && value[len - 1] == '"') {
+		value++;
+		len -= 2;
+	}
+
+	if (len == 0 || len >= sizeof(str)) {
+		return -EINVAL;
+	}
+
+	memcpy(str, value, len);
+	str[len] = '\0';
+
+	val = atoi(str);
+	if (val < 8 || val > 15) {
+		return -EINVAL;
+	}
+
+	*bits = val;
+
+	return 0;
+}
+
+int websocket_deflate_parse_response(struct websocket_deflate *deflate,
+				     const char *value, size_t len)
+{
+	bool server_no_context_takeover = false;
+	bool extension_found = false;
+	size_t pos = 0;
+
+	deflate->client_window_bits = MAX_BITS;
+
+	while (pos < len) {
+		const char *param;
+		const char *eq;
+		size_t param_len;
+		uint8_t bits;
+
+		while (pos < len && (value[pos] == ' ' || value[pos] == '\t' ||
+				     value[pos] == ';')) {
+			pos++;
+		}
+
+		param = &value[pos];
+
+		while (pos < len && value[pos] != ';') {
+			/* Only the extension that was offered can be accepted */
+			if (value[pos] == ',') {
+				return -EINVAL;
+			}
+
+			pos++;
+		}
+
+		param_len = &value[pos] - param;
+		while (param_len > 0 && (param[param_len - 1] == ' ' ||
+					 param[param_len - 1] == '\t')) {
+			param_len--;
+		}
+
+		if (param_len == 0) {
+			continue;
+		}
+
+		if (!extension_found) {
+			if (!param_is(param, param_len, "permessage-deflate")) {
+				return -EINVAL;
+			}
+
+			extension_found = true;
+			continue;
+		}
+
+		eq = memchr(param, '=', param_len);
+		if (eq == NULL) {
+			if (param_is(param, param_len,
+				     "server_no_context_takeover")) {
+				server_no_context_takeover = true;
+			} else if (!param_is(param, param_len,
+					     "client_no_context_takeover")) {
+				return -EINVAL;
+			}
+
+			continue;
+		}
+
+		if (parse_window_bits(eq + 1, param_len - (eq + 1 - param),
+				      &bits) < 0) {
+			return -EINVAL;
+		}
+
+		if (param_is(param, eq - param, "client_max_window_bits")) {
+			deflate->client_window_bits = bits;
+		} else if (!param_is(param, eq - param,
+				     "server_max_window_bits")) {
+			return -EINVAL;
+		}
+	}
+
+	/* Each incoming message is decompressed on its own, so the server
+	 * must not refer to the previous ones.
+	 */
+	if (!extension_found || !server_no_context_takeover) {
+		return -EINVAL;
+	}
+
+	return 0;
+}
@@ -46,6 +46,78 @@ struct websocket_buffer {
 	size_t count;
 };
 
+#if defined(CONFIG_WEBSOCKET_DEFLATE)
+/* Number of bits of the hash used to find repeated strings */
+#define WS_DEFLATE_HASH_BITS 10
+
+/* The receiver appends these to a compressed message, RFC 7692 ch 7.2.2 */
+#define WS_DEFLATE_TRAILER_LEN 4
+
+/**
+ * Canonical Huffman decoding table
+ */
+struct websocket_huffman {
+	/* number of codes of each length */
+	uint16_t count[16];
+	/* symbols ordered by their code */
+	uint16_t symbol[288];
+};
+
+/**
+ * permessage-deflate extension state, RFC 7692
+ */
+struct websocket_deflate {
+	/* last position + 1 of each hashed 3 byte sequence, 0 if none */
+	uint16_t hash_head[1 << WS_DEFLATE_HASH_BITS];
+	/* literal/length and distance decoding tables */
+	struct websocket_huffman lencode;
+	struct websocket_huffman distcode;
+	/* code lengths of a dynamic block */
+	uint16_t lengths[320];
+	/* compressed outgoing message */
+	uint8_t tx[CONFIG_WEBSOCKET_DEFLATE_BUF_SIZE];
+	/* compressed incoming message, with room for the trailer */
+	uint8_t rx_in[CONFIG_WEBSOCKET_DEFLATE_BUF_SIZE + WS_DEFLATE_TRAILER_LEN];
+	size_t rx_in_len;
+	/* decompressed incoming message not yet passed to the user */
+	uint8_t rx_out[CONFIG_WEBSOCKET_DEFLATE_BUF_SIZE];
+	size_t rx_out_len;
+	size_t rx_out_pos;
+	/* message type of the incoming compressed message */
+	uint32_t rx_msg_type;
+	/* max LZ77 window size of the peer decompressor, as log2 */
+	uint8_t client_window_bits;
+};
+
+/**
+ * @brief Compress a message, the result ends with an empty stored block
+ * without its LEN and NLEN fields as required by RFC 7692.
+ *
+ * @return Length of the compressed data, -ENOSPC if it does not fit
+ */
+int websocket_deflate_compress(struct websocket_deflate *deflate,
+			       const uint8_t *in, size_t in_len,
+			       uint8_t *out, size_t out_size);
+
+/**
+ * @brief Decompress a message, the trailer must already be appended.
+ *
+ * @return Length of the decompressed data, -EMSGSIZE if it does not fit,
+ *         -EINVAL if the data is not valid
+ */
+int websocket_deflate_decompress(struct websocket_deflate *deflate,
+				 const uint8_t *in, size_t in_len,
+				 uint8_t *out, size_t out_size);
+
+/**
+ * @brief Check the Sec-WebSocket-Extensions value sent by the server.
+ *
+ * @return 0 if the negotiated parameters are supported, <0 otherwise
+ */
+int websocket_deflate_parse_response(struct websocket_deflate *deflate,
+				     const char *value, size_t len);
+#endif /* CONFIG_WEBSOCKET_DEFLATE */
+
 /**
  * Websocket connection information
  */
@@ -119,6 +191,35 @@ __net_socket struct websocket_context {
 
 	/** Did we receive all from peer during HTTP handshake */
 	uint8_t all_received : 1;
+
+	/** Did we receive Sec-WebSocket-Extensions: field */
+	uint8_t extensions_present : 1;
+
+	/** Did the server reply with extensions we cannot use */
+	uint8_t extensions_rejected : 1;
+
+	/** Did we offer permessage-deflate to the server */
+	uint8_t deflate_offered : 1;
+
+	/** Is permessage-deflate in use */
+	uint8_t deflate_enabled : 1;
+
+	/** Is the message being received compressed */
+	uint8_t rx_compressed : 1;
+
+	/** Is the frame being received part of a compressed message */
+	uint8_t rx_inflate : 1;
+
+	/** Is the compressed message being received too long and dropped */
+	uint8_t rx_discard : 1;
+
+	/** Buffer where outgoing data is masked before being sent */
+	uint8_t tx_buf[CONFIG_WEBSOCKET_TX_BUF_SIZE];
+
+#if defined(CONFIG_WEBSOCKET_DEFLATE)
+	/** permessage-deflate state, used if deflate_enabled is set */
+	struct websocket_deflate *deflate;
+#endif
 };
 
 #if defined(CONFIG_NET_TEST)
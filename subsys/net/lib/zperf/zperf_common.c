@@ -208,6 +208,191 @@ uint32_t zperf_packet_duration(uint32_t packet_size, uint32_t rate_in_kbps)
 			  (rate_in_kbps * 1024U));
 }
 
+#if defined(CONFIG_NET_ZPERF_CPU_USAGE)
+static void cpu_usage_start(k_thread_runtime_stats_t *stats)
+{
+	(void)k_thread_runtime_stats_all_get(stats);
+}
+
+/* The CPU statistics count the idle and non-idle cycles in execution_cycles,
+ * and the non-idle ones only in total_cycles.
+ */
+static uint32_t cpu_usage_get(const k_thread_runtime_stats_t *start)
+{
+	k_thread_runtime_stats_t now;
+	uint64_t cycles, busy;
+
+	(void)k_thread_runtime_stats_all_get(&now);
+
+	cycles = now.execution_cycles - start->execution_cycles;
+	busy = now.total_cycles - start->total_cycles;
+
+	if (cycles == 0U) {
+		return 0U;
+	}
+
+	return (uint32_t)((busy * 1000U) / cycles);
+}
+#endif /* CONFIG_NET_ZPERF_CPU_USAGE */
+
+#if CONFIG_NET_ZPERF_MAX_STREAMS > 1
+struct zperf_stream {
+	struct k_thread thread;
+	const struct zperf_upload_params *param;
+	zperf_upload_stream_fn upload;
+	struct zperf_results result;
+	int ret;
+};
+
+static struct zperf_stream zperf_streams[CONFIG_NET_ZPERF_MAX_STREAMS];
+
+/* The first stream runs in the calling thread */
+static K_THREAD_STACK_ARRAY_DEFINE(zperf_stream_stacks,
+				   CONFIG_NET_ZPERF_MAX_STREAMS - 1,
+				   CONFIG_NET_ZPERF_STREAM_STACK_SIZE);
+
+static K_MUTEX_DEFINE(zperf_streams_lock);
+
+static void zperf_stream_thread(void *p1, void *p2, void *p3)
+{
+	struct zperf_stream *stream = p1;
+	uint8_t stream_id = POINTER_TO_UINT(p2);
+
+	ARG_UNUSED(p3);
+
+	stream->ret = stream->upload(stream->param, stream_id, &stream->result);
+}
+
+static void zperf_results_add(struct zperf_results *sum,
+			      const struct zperf_results *result)
+{
+	sum->nb_packets_sent += result->nb_packets_sent;
+	sum->nb_packets_rcvd += result->nb_packets_rcvd;
+	sum->nb_packets_lost += result->nb_packets_lost;
+	sum->nb_packets_outorder += result->nb_packets_outorder;
+	sum->nb_packets_errors += result->nb_packets_errors;
+	sum->total_len += result->total_len;
+	sum->time_in_us = MAX(sum->time_in_us, result->time_in_us);
+	sum->client_time_in_us = MAX(sum->client_time_in_us,
+				     result->client_time_in_us);
+	sum->jitter_in_us = MAX(sum->jitter_in_us, result->jitter_in_us);
+	sum->packet_size = result->packet_size;
+}
+
+static int zperf_run_streams(const struct zperf_upload_params *param,
+			     zperf_upload_stream_fn upload,
+			     zperf_callback callback, void *user_data,
+			     struct zperf_results *result)
+{
+	uint8_t nb_streams = param->num_streams;
+	int prio = k_thread_priority_get(k_current_get());
+	struct zperf_stream *stream;
+	int ret = 0;
+
+	if (k_mutex_lock(&zperf_streams_lock, K_NO_WAIT) != 0) {
+		return -EBUSY;
+	}
+
+	for (uint8_t i = 0; i < nb_streams; i++) {
+		stream = &zperf_streams[i];
+
+		memset(&stream->result, 0, sizeof(stream->result));
+		stream->param = param;
+		stream->upload = upload;
+		stream->ret = 0;
+
+		if (i == 0) {
+			continue;
+		}
+
+		k_thread_create(&stream->thread, zperf_stream_stacks[i - 1],
+				K_THREAD_STACK_SIZEOF(zperf_stream_stacks[i - 1]),
+				zperf_stream_thread, stream, UINT_TO_POINTER(i),
+				NULL, prio, 0, K_NO_WAIT);
+		k_thread_name_set(&stream->thread, "zperf_stream");
+	}
+
+	stream = &zperf_streams[0];
+	stream->ret = upload(param, 0, &stream->result);
+
+	for (uint8_t i = 0; i < nb_streams; i++) {
+		stream = &zperf_streams[i];
+
+		if (i > 0) {
+			(void)k_thread_join(&stream->thread, K_FOREVER);
+		}
+
+		if (stream->ret < 0) {
+			NET_ERR("Stream %u failed (%d)", i, stream->ret);
+			if (ret == 0) {
+				ret = stream->ret;
+			}
+
+			continue;
+		}
+
+		stream->result.stream_id = i;
+		stream->result.nb_streams = 1U;
+		zperf_results_add(result, &stream->result);
+
+		if (callback != NULL) {
+			callback(ZPERF_SESSION_STREAM_FINISHED, &stream->result,
+				 user_data);
+		}
+	}
+
+	k_mutex_unlock(&zperf_streams_lock);
+
+	return ret;
+}
+#endif /* CONFIG_NET_ZPERF_MAX_STREAMS > 1 */
+
+int zperf_upload_streams(const struct zperf_upload_params *param,
+			 zperf_upload_stream_fn upload,
+			 zperf_callback callback, void *user_data,
+			 struct zperf_results *result)
+{
+#if defined(CONFIG_NET_ZPERF_CPU_USAGE)
+	k_thread_runtime_stats_t cpu_stats;
+#endif
+	int ret;
+
+	if (param->num_streams > CONFIG_NET_ZPERF_MAX_STREAMS) {
+		NET_ERR("Too many streams (%u), max %u", param->num_streams,
+			CONFIG_NET_ZPERF_MAX_STREAMS);
+		return -EINVAL;
+	}
+
+	memset(result, 0, sizeof(*result));
+
+#if defined(CONFIG_NET_ZPERF_CPU_USAGE)
+	cpu_usage_start(&cpu_stats);
+#endif
+
+	if (param->num_streams <= 1) {
+		ret = upload(param, 0, result);
+	} else {
+#if CONFIG_NET_ZPERF_MAX_STREAMS > 1
+		ret = zperf_run_streams(param, upload, callback, user_data,
+					result);
+#else
+		ret = -EINVAL;
+#endif
+	}
+
+	if (ret < 0) {
+		return ret;
+	}
+
+	result->nb_streams = MAX(param->num_streams, 1);
+
+#if defined(CONFIG_NET_ZPERF_CPU_USAGE)
+	result->cpu_usage_permille = cpu_usage_get(&cpu_stats);
+#endif
+
+	return 0;
+}
+
 void zperf_async_work_submit(struct k_work *work)
 {
 	k_work_submit_to_queue(&zperf_work_q, work);
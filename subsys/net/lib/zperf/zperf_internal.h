@@ -82,6 +82,11 @@ struct zperf_async_upload_context {
 	void *user_data;
 };
 
+/* Runs stream @p stream_id of the upload described by @p param */
+typedef int (*zperf_upload_stream_fn)(const struct zperf_upload_params *param,
+				      uint8_t stream_id,
+				      struct zperf_results *result);
+
 static inline uint32_t time_delta(uint32_t ts, uint32_t t)
 {
 	return (t >= ts) ? (t - ts) : (ULONG_MAX - ts + t);
@@ -103,6 +108,11 @@ int zperf_prepare_upload_sock(const struct sockaddr *peer_addr, int tos,
 
 uint32_t zperf_packet_duration(uint32_t packet_size, uint32_t rate_in_kbps);
 
+int zperf_upload_streams(const struct zperf_upload_params *param,
+			 zperf_upload_stream_fn upload,
+			 zperf_callback callback, void *user_data,
+			 struct zperf_results *result);
+
 void zperf_async_work_submit(struct k_work *work);
 void zperf_udp_uploader_init(void);
 void zperf_tcp_uploader_init(void);
@@ -256,6 +256,15 @@ static int cmd_setip(const struct shell *sh, size_t argc, char *argv[])
 	return 0;
 }
 
+static uint32_t packet_rate(uint32_t nb_packets, uint32_t time_in_us)
+{
+	if (time_in_us == 0U) {
+		return 0U;
+	}
+
+	return (uint32_t)(((uint64_t)nb_packets * USEC_PER_SEC) / time_in_us);
+}
+
 static void udp_session_cb(enum zperf_status status,
 			   struct zperf_results *result,
 			   void *user_data)
@@ -301,6 +310,10 @@ static void udp_session_cb(enum zperf_status status,
 		print_number(sh, rate_in_kbps, KBPS, KBPS_UNIT);
 		shell_fprintf(sh, SHELL_NORMAL, "\n");
 
+		shell_fprintf(sh, SHELL_NORMAL, " packets/s:\t\t%u\n",
+			      packet_rate(result->nb_packets_rcvd,
+					  result->time_in_us));
+
 		break;
 	}
 
@@ -367,8 +380,6 @@ static void shell_udp_upload_print_stats(const struct shell *sh,
 	if (IS_ENABLED(CONFIG_NET_UDP)) {
 		unsigned int rate_in_kbps, client_rate_in_kbps;
 
-		shell_fprintf(sh, SHELL_NORMAL, "-\nUpload completed!\n");
-
 		if (results->time_in_us != 0U) {
 			rate_in_kbps = (uint32_t)
 				(((uint64_t)results->total_len *
@@ -423,6 +434,12 @@ static void shell_udp_upload_print_stats(const struct shell *sh,
 		shell_fprintf(sh, SHELL_NORMAL, "\t(");
 		print_number(sh, client_rate_in_kbps, KBPS, KBPS_UNIT);
 		shell_fprintf(sh, SHELL_NORMAL, ")\n");
+
+		shell_fprintf(sh, SHELL_NORMAL, "Packets/s:\t\t%u\t(%u)\n",
+			      packet_rate(results->nb_packets_rcvd,
+					  results->time_in_us),
+			      packet_rate(results->nb_packets_sent,
+					  results->client_time_in_us));
 	}
 }
 
@@ -432,8 +449,6 @@ static void shell_tcp_upload_print_stats(const struct shell *sh,
 	if (IS_ENABLED(CONFIG_NET_TCP)) {
 		unsigned int client_rate_in_kbps;
 
-		shell_fprintf(sh, SHELL_NORMAL, "-\nUpload completed!\n");
-
 		if (results->client_time_in_us != 0U) {
 			client_rate_in_kbps = (uint32_t)
 				(((uint64_t)results->nb_packets_sent *
@@ -459,6 +474,21 @@ static void shell_tcp_upload_print_stats(const struct shell *sh,
 	}
 }
 
+static void shell_upload_print_summary(const struct shell *sh,
+				      struct zperf_results *results)
+{
+	if (results->nb_streams > 1) {
+		shell_fprintf(sh, SHELL_NORMAL, "Streams:\t\t%u\n",
+			      results->nb_streams);
+	}
+
+	if (IS_ENABLED(CONFIG_NET_ZPERF_CPU_USAGE)) {
+		shell_fprintf(sh, SHELL_NORMAL, "CPU usage:\t\t%u.%u %%\n",
+			      results->cpu_usage_permille / 10U,
+			      results->cpu_usage_permille % 10U);
+	}
+}
+
 static void udp_upload_cb(enum zperf_status status,
 			  struct zperf_results *result,
 			  void *user_data)
@@ -469,8 +499,16 @@ static void udp_upload_cb(enum zperf_status status,
 	case ZPERF_SESSION_STARTED:
 		break;
 
+	case ZPERF_SESSION_STREAM_FINISHED:
+		shell_fprintf(sh, SHELL_NORMAL, "-\nStream %u completed!\n",
+			      result->stream_id);
+		shell_udp_upload_print_stats(sh, result);
+		break;
+
 	case ZPERF_SESSION_FINISHED: {
+		shell_fprintf(sh, SHELL_NORMAL, "-\nUpload completed!\n");
 		shell_udp_upload_print_stats(sh, result);
+		shell_upload_print_summary(sh, result);
 		break;
 	}
 
@@ -490,8 +528,16 @@ static void tcp_upload_cb(enum zperf_status status,
 	case ZPERF_SESSION_STARTED:
 		break;
 
+	case ZPERF_SESSION_STREAM_FINISHED:
+		shell_fprintf(sh, SHELL_NORMAL, "-\nStream %u completed!\n",
+			      result->stream_id);
+		shell_tcp_upload_print_stats(sh, result);
+		break;
+
 	case ZPERF_SESSION_FINISHED: {
+		shell_fprintf(sh, SHELL_NORMAL, "-\nUpload completed!\n");
 		shell_tcp_upload_print_stats(sh, result);
+		shell_upload_print_summary(sh, result);
 		break;
 	}
 
@@ -516,6 +562,10 @@ static int execute_upload(const struct shell *sh,
 		      param->packet_size);
 	shell_fprintf(sh, SHELL_NORMAL, "Rate:\t\t%u kbps\n",
 		      param->rate_kbps);
+	if (param->num_streams > 1) {
+		shell_fprintf(sh, SHELL_NORMAL, "Streams:\t%u\n",
+			      param->num_streams);
+	}
 	shell_fprintf(sh, SHELL_NORMAL, "Starting...\n");
 
 	if (IS_ENABLED(CONFIG_NET_IPV6) && param->peer_addr.sa_family == AF_INET6) {
@@ -563,7 +613,9 @@ static int execute_upload(const struct shell *sh,
 				return ret;
 			}
 
+			shell_fprintf(sh, SHELL_NORMAL, "-\nUpload completed!\n");
 			shell_udp_upload_print_stats(sh, &results);
+			shell_upload_print_summary(sh, &results);
 		}
 	} else {
 		if (!IS_ENABLED(CONFIG_NET_UDP)) {
@@ -589,7 +641,9 @@ static int execute_upload(const struct shell *sh,
 				return ret;
 			}
 
+			shell_fprintf(sh, SHELL_NORMAL, "-\nUpload completed!\n");
 			shell_tcp_upload_print_stats(sh, &results);
+			shell_upload_print_summary(sh, &results);
 		}
 	} else {
 		if (!IS_ENABLED(CONFIG_NET_TCP)) {
@@ -670,6 +724,23 @@ static int shell_cmd_upload(const struct shell *sh, size_t argc,
 			opt_cnt += 1;
 			break;
 
+		case 'P': {
+			int num_streams = parse_arg(&i, argc, argv);
+
+			if (num_streams < 1 ||
+			    num_streams > CONFIG_NET_ZPERF_MAX_STREAMS) {
+				shell_fprintf(sh, SHELL_WARNING,
+					      "Number of streams must be between "
+					      "1 and %d\n",
+					      CONFIG_NET_ZPERF_MAX_STREAMS);
+				return -ENOEXEC;
+			}
+
+			param.num_streams = num_streams;
+			opt_cnt += 2;
+			break;
+		}
+
 		case 'n':
 			if (is_udp) {
 				shell_fprintf(sh, SHELL_WARNING,
@@ -843,6 +914,23 @@ static int shell_cmd_upload2(const struct shell *sh, size_t argc,
 			opt_cnt += 1;
 			break;
 
+		case 'P': {
+			int num_streams = parse_arg(&i, argc, argv);
+
+			if (num_streams < 1 ||
+			    num_streams > CONFIG_NET_ZPERF_MAX_STREAMS) {
+				shell_fprintf(sh, SHELL_WARNING,
+					      "Number of streams must be between "
+					      "1 and %d\n",
+					      CONFIG_NET_ZPERF_MAX_STREAMS);
+				return -ENOEXEC;
+			}
+
+			param.num_streams = num_streams;
+			opt_cnt += 2;
+			break;
+		}
+
 		case 'n':
 			if (is_udp) {
 				shell_fprintf(sh, SHELL_WARNING,
@@ -1145,6 +1233,8 @@ SHELL_STATIC_SUBCMD_SET_CREATE(zperf_cmd_tcp,
 		  "Available options:\n"
 		  "-S tos: Specify IPv4/6 type of service\n"
 		  "-a: Asynchronous call (shell will not block for the upload)\n"
+		  "-P num: Number of parallel streams, the results of each\n"
+		  "        stream are printed for asynchronous calls\n"
 		  "-n: Disable Nagle's algorithm\n"
 		  "Example: tcp upload 192.0.2.2 1111 1 1K\n"
 		  "Example: tcp upload 2001:db8::2\n",
@@ -1159,6 +1249,8 @@ SHELL_STATIC_SUBCMD_SET_CREATE(zperf_cmd_tcp,
 		  "Available options:\n"
 		  "-S tos: Specify IPv4/6 type of service\n"
 		  "-a: Asynchronous call (shell will not block for the upload)\n"
+		  "-P num: Number of parallel streams, the results of each\n"
+		  "        stream are printed for asynchronous calls\n"
 		  "Example: tcp upload2 v6 1 1K\n"
 		  "Example: tcp upload2 v4\n"
 		  "-n: Disable Nagle's algorithm\n"
@@ -1198,6 +1290,8 @@ SHELL_STATIC_SUBCMD_SET_CREATE(zperf_cmd_udp,
 		  "Available options:\n"
 		  "-S tos: Specify IPv4/6 type of service\n"
 		  "-a: Asynchronous call (shell will not block for the upload)\n"
+		  "-P num: Number of parallel streams, the results of each\n"
+		  "        stream are printed for asynchronous calls\n"
 		  "Example: udp upload 192.0.2.2 1111 1 1K 1M\n"
 		  "Example: udp upload 2001:db8::2\n",
 		  cmd_udp_upload),
@@ -1212,6 +1306,8 @@ SHELL_STATIC_SUBCMD_SET_CREATE(zperf_cmd_udp,
 		  "Available options:\n"
 		  "-S tos: Specify IPv4/6 type of service\n"
 		  "-a: Asynchronous call (shell will not block for the upload)\n"
+		  "-P num: Number of parallel streams, the results of each\n"
+		  "        stream are printed for asynchronous calls\n"
 		  "Example: udp upload2 v4 1 1K 1M\n"
 		  "Example: udp upload2 v6\n"
 #if defined(CONFIG_NET_IPV6) && defined(MY_IP6ADDR_SET)
@@ -20,6 +20,44 @@ static char sample_packet[PACKET_SIZE_MAX];
 
 static struct zperf_async_upload_context tcp_async_upload_ctx;
 
+#if defined(CONFIG_NET_ZPERF_TCP_SEND_ZEROCOPY)
+static K_SEM_DEFINE(tcp_zerocopy_sem, CONFIG_NET_SOCKETS_SEND_ZEROCOPY_COUNT,
+		    CONFIG_NET_SOCKETS_SEND_ZEROCOPY_COUNT);
+
+static void tcp_zerocopy_done(const void *data, size_t len, void *user_data)
+{
+	ARG_UNUSED(data);
+	ARG_UNUSED(len);
+	ARG_UNUSED(user_data);
+
+	k_sem_give(&tcp_zerocopy_sem);
+}
+
+/* The sample packet is not modified during the upload, so it can be
+ * handed over to the network stack as it is. The semaphore limits the
+ * number of sends in progress to what the socket layer can track.
+ */
+static int tcp_send_zerocopy(int sock, unsigned int packet_size,
+			     int64_t end_time)
+{
+	int64_t remaining = end_time - k_uptime_ticks();
+	int ret;
+
+	if (k_sem_take(&tcp_zerocopy_sem, K_TICKS(MAX(remaining, 0))) != 0) {
+		/* Test duration elapsed while waiting for completions */
+		return 0;
+	}
+
+	ret = zsock_send_zerocopy(sock, sample_packet, packet_size, 0,
+				  tcp_zerocopy_done, NULL);
+	if (ret < 0) {
+		k_sem_give(&tcp_zerocopy_sem);
+	}
+
+	return ret;
+}
+#endif /* CONFIG_NET_ZPERF_TCP_SEND_ZEROCOPY */
+
 static int tcp_upload(int sock,
 		      unsigned int duration_in_ms,
 		      unsigned int packet_size,
@@ -41,17 +79,13 @@ static int tcp_upload(int sock,
 	start_time = k_uptime_ticks();
 	last_print_time = start_time;
 
-	(void)memset(sample_packet, 'z', sizeof(sample_packet));
-
-	/* Set the "flags" field in start of the packet to be 0.
-	 * As the protocol is not properly described anywhere, it is
-	 * not certain if this is a proper thing to do.
-	 */
-	(void)memset(sample_packet, 0, sizeof(uint32_t));
-
 	do {
 		/* Send the packet */
+#if defined(CONFIG_NET_ZPERF_TCP_SEND_ZEROCOPY)
+		ret = tcp_send_zerocopy(sock, packet_size, duration);
+#else
 		ret = zsock_send(sock, sample_packet, packet_size, 0);
+#endif
 		if (ret < 0) {
 			if (nb_errors == 0 && ret != -ENOMEM) {
 				NET_ERR("Failed to send the packet (%d)", errno);
@@ -70,15 +104,15 @@ static int tcp_upload(int sock,
 				ret = -errno;
 				break;
 			}
-		} else {
+		} else if (ret > 0) {
 			nb_packets++;
 		}
 
 #if defined(CONFIG_ARCH_POSIX)
 		k_busy_wait(100 * USEC_PER_MSEC);
-#else
-		k_yield();
 #endif
+		/* Let the other streams of a parallel upload run */
+		k_yield();
 
 		remaining = duration - k_uptime_ticks();
 	} while (remaining > 0);
@@ -108,15 +142,14 @@ static int tcp_upload(int sock,
 	return 0;
 }
 
-int zperf_tcp_upload(const struct zperf_upload_params *param,
-		     struct zperf_results *result)
+static int tcp_upload_stream(const struct zperf_upload_params *param,
+			     uint8_t stream_id,
+			     struct zperf_results *result)
 {
 	int sock;
 	int ret;
 
-	if (param == NULL || result == NULL) {
-		return -EINVAL;
-	}
+	ARG_UNUSED(stream_id);
 
 	sock = zperf_prepare_upload_sock(&param->peer_addr, param->options.tos,
 					 IPPROTO_TCP);
@@ -129,6 +162,7 @@ int zperf_tcp_upload(const struct zperf_upload_params *param,
 			     &param->options.tcp_nodelay,
 			     sizeof(param->options.tcp_nodelay)) != 0) {
 		NET_WARN("Failed to set IPPROTO_TCP - TCP_NODELAY socket option.");
+		zsock_close(sock);
 		return -EINVAL;
 	}
 
@@ -139,6 +173,17 @@ int zperf_tcp_upload(const struct zperf_upload_params *param,
 	return ret;
 }
 
+int zperf_tcp_upload(const struct zperf_upload_params *param,
+		     struct zperf_results *result)
+{
+	if (param == NULL || result == NULL) {
+		return -EINVAL;
+	}
+
+	return zperf_upload_streams(param, tcp_upload_stream, NULL, NULL,
+				    result);
+}
+
 static void tcp_upload_async_work(struct k_work *work)
 {
 	struct zperf_async_upload_context *upload_ctx =
@@ -149,7 +194,9 @@ static void tcp_upload_async_work(struct k_work *work)
 	upload_ctx->callback(ZPERF_SESSION_STARTED, NULL,
 			     upload_ctx->user_data);
 
-	ret = zperf_tcp_upload(&upload_ctx->param, &result);
+	ret = zperf_upload_streams(&upload_ctx->param, tcp_upload_stream,
+				   upload_ctx->callback, upload_ctx->user_data,
+				   &result);
 	if (ret < 0) {
 		upload_ctx->callback(ZPERF_SESSION_ERROR, NULL,
 				     upload_ctx->user_data);
@@ -181,5 +228,14 @@ int zperf_tcp_upload_async(const struct zperf_upload_params *param,
 
 void zperf_tcp_uploader_init(void)
 {
+	/* The packet is sent as it is by all the streams of an upload */
+	(void)memset(sample_packet, 'z', sizeof(sample_packet));
+
+	/* Set the "flags" field in start of the packet to be 0.
+	 * As the protocol is not properly described anywhere, it is
+	 * not certain if this is a proper thing to do.
+	 */
+	(void)memset(sample_packet, 0, sizeof(uint32_t));
+
 	k_work_init(&tcp_async_upload_ctx.work, tcp_upload_async_work);
 }
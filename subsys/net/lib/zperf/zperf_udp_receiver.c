@@ -12,6 +12,7 @@ LOG_MODULE_DECLARE(net_zperf, CONFIG_NET_ZPERF_LOG_LEVEL);
 
 #include <zephyr/kernel.h>
 
+#include <zephyr/net/buf.h>
 #include <zephyr/net/socket.h>
 #include <zephyr/net/zperf.h>
 
@@ -38,6 +39,7 @@ static struct sockaddr_in *in4_addr_my;
 #define SOCK_ID_MAX 2
 
 #define UDP_RECEIVER_BUF_SIZE 1500
+#define UDP_RECEIVER_BATCH CONFIG_NET_ZPERF_UDP_BATCH
 #define POLL_TIMEOUT_MS 100
 
 static K_THREAD_STACK_DEFINE(udp_receiver_stack_area, UDP_RECEIVER_STACK_SIZE);
@@ -98,21 +100,16 @@ static int zperf_receiver_send_stat(int sock, const struct sockaddr *addr,
 	return ret;
 }
 
-static void udp_received(int sock, const struct sockaddr *addr, uint8_t *data,
-			 size_t datalen)
+/* Process a datagram of datalen bytes, only its zperf header is needed */
+static void udp_datagram_received(int sock, const struct sockaddr *addr,
+				  struct zperf_udp_datagram *hdr,
+				  size_t datalen)
 {
-	struct zperf_udp_datagram *hdr;
 	struct session *session;
 	int32_t transit_time;
 	int64_t time;
 	int32_t id;
 
-	if (datalen < sizeof(struct zperf_udp_datagram)) {
-		NET_WARN("Short iperf packet!");
-		return;
-	}
-
-	hdr = (struct zperf_udp_datagram *)data;
 	time = k_uptime_ticks();
 
 	session = get_session(addr, SESSION_UDP);
@@ -229,6 +226,79 @@ static void udp_received(int sock, const struct sockaddr *addr, uint8_t *data,
 	}
 }
 
+static void udp_received(int sock, const struct sockaddr *addr, uint8_t *data,
+			 size_t datalen)
+{
+	if (datalen < sizeof(struct zperf_udp_datagram)) {
+		NET_WARN("Short iperf packet!");
+		return;
+	}
+
+	udp_datagram_received(sock, addr, (struct zperf_udp_datagram *)data,
+			      datalen);
+}
+
+/* Receive all the queued datagrams, up to UDP_RECEIVER_BATCH, with one
+ * call.
+ */
+static int udp_receive_batch(int sock)
+{
+	static uint8_t bufs[UDP_RECEIVER_BATCH][UDP_RECEIVER_BUF_SIZE];
+	struct mmsghdr msgs[UDP_RECEIVER_BATCH] = { 0 };
+	struct sockaddr addrs[UDP_RECEIVER_BATCH];
+	struct iovec iov[UDP_RECEIVER_BATCH];
+	int ret;
+
+	for (int i = 0; i < UDP_RECEIVER_BATCH; i++) {
+		iov[i].iov_base = bufs[i];
+		iov[i].iov_len = sizeof(bufs[i]);
+
+		msgs[i].msg_hdr.msg_name = &addrs[i];
+		msgs[i].msg_hdr.msg_namelen = sizeof(addrs[i]);
+		msgs[i].msg_hdr.msg_iov = &iov[i];
+		msgs[i].msg_hdr.msg_iovlen = 1;
+	}
+
+	ret = zsock_recvmmsg(sock, msgs, UDP_RECEIVER_BATCH, 0);
+	if (ret < 0) {
+		return ret;
+	}
+
+	for (int i = 0; i < ret; i++) {
+		udp_received(sock, &addrs[i], bufs[i], msgs[i].msg_len);
+	}
+
+	return ret;
+}
+
+/* Receive one datagram without copying the payload, only the zperf
+ * header is copied out of the network buffers.
+ */
+static int udp_receive_zerocopy(int sock)
+{
+	struct zperf_udp_datagram hdr;
+	struct zsock_rx_loan loan;
+	struct sockaddr addr;
+	socklen_t addrlen = sizeof(addr);
+	ssize_t ret;
+
+	ret = zsock_recv_zerocopy(sock, &loan, 0, &addr, &addrlen);
+	if (ret < 0) {
+		return ret;
+	}
+
+	if (loan.len < sizeof(hdr)) {
+		NET_WARN("Short iperf packet!");
+	} else {
+		net_buf_linearize(&hdr, sizeof(hdr), loan.buf, 0, sizeof(hdr));
+		udp_datagram_received(sock, &addr, &hdr, loan.len);
+	}
+
+	zsock_recv_zerocopy_release(&loan);
+
+	return ret;
+}
+
 static void udp_server_session(void)
 {
 	static uint8_t buf[UDP_RECEIVER_BUF_SIZE];
@@ -372,6 +442,23 @@ static void udp_server_session(void)
 				continue;
 			}
 
+			if (IS_ENABLED(CONFIG_NET_ZPERF_UDP_RECV_ZEROCOPY) ||
+			    UDP_RECEIVER_BATCH > 1) {
+				if (IS_ENABLED(CONFIG_NET_ZPERF_UDP_RECV_ZEROCOPY)) {
+					ret = udp_receive_zerocopy(fds[i].fd);
+				} else {
+					ret = udp_receive_batch(fds[i].fd);
+				}
+
+				if (ret < 0) {
+					NET_ERR("recv failed on IPv%d socket (%d)",
+						(i == SOCK_ID_IPV4) ? 4 : 6, errno);
+					goto error;
+				}
+
+				continue;
+			}
+
 			ret = zsock_recvfrom(fds[i].fd, buf, sizeof(buf), 0,
 					     &addr, &addrlen);
 			if (ret < 0) {
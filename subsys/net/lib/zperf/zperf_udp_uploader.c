@@ -14,12 +14,24 @@ LOG_MODULE_DECLARE(net_zperf, CONFIG_NET_ZPERF_LOG_LEVEL);
 
 #include "zperf_internal.h"
 
-static uint8_t sample_packet[sizeof(struct zperf_udp_datagram) +
-			     sizeof(struct zperf_client_hdr_v1) +
-			     PACKET_SIZE_MAX];
+#define SAMPLE_PACKET_SIZE (sizeof(struct zperf_udp_datagram) +		\
+			    sizeof(struct zperf_client_hdr_v1) +	\
+			    PACKET_SIZE_MAX)
+
+/* The headers are rewritten for every datagram, so each stream of a
+ * parallel upload needs a packet of its own.
+ */
+static uint8_t sample_packet[CONFIG_NET_ZPERF_MAX_STREAMS][SAMPLE_PACKET_SIZE];
 
 static struct zperf_async_upload_context udp_async_upload_ctx;
 
+#define UDP_BATCH CONFIG_NET_ZPERF_UDP_BATCH
+
+struct udp_batch_hdr {
+	struct zperf_udp_datagram datagram;
+	struct zperf_client_hdr_v1 hdr;
+} __packed;
+
 static inline void zperf_upload_decode_stat(const uint8_t *data,
 					    size_t datalen,
 					    struct zperf_results *results)
@@ -45,7 +57,7 @@ static inline void zperf_upload_decode_stat(const uint8_t *data,
 		ntohl(UNALIGNED_GET(&stat->jitter1)) * USEC_PER_SEC;
 }
 
-static inline int zperf_upload_fin(int sock,
+static inline int zperf_upload_fin(int sock, uint8_t *packet,
 				   uint32_t nb_packets,
 				   uint64_t end_time,
 				   uint32_t packet_size,
@@ -65,14 +77,14 @@ static inline int zperf_upload_fin(int sock,
 	};
 
 	while (ret <= 0 && loop-- > 0) {
-		datagram = (struct zperf_udp_datagram *)sample_packet;
+		datagram = (struct zperf_udp_datagram *)packet;
 
 		/* Fill the packet header */
 		datagram->id = htonl(-nb_packets);
 		datagram->tv_sec = htonl(secs);
 		datagram->tv_usec = htonl(usecs);
 
-		hdr = (struct zperf_client_hdr_v1 *)(sample_packet +
+		hdr = (struct zperf_client_hdr_v1 *)(packet +
 						     sizeof(*datagram));
 
 		/* According to iperf documentation (in include/Settings.hpp),
@@ -83,13 +95,13 @@ static inline int zperf_upload_fin(int sock,
 		hdr->flags = 0;
 		hdr->num_of_threads = htonl(1);
 		hdr->port = 0;
-		hdr->buffer_len = sizeof(sample_packet) -
+		hdr->buffer_len = SAMPLE_PACKET_SIZE -
 			sizeof(*datagram) - sizeof(*hdr);
 		hdr->bandwidth = 0;
 		hdr->num_of_bytes = htonl(packet_size);
 
 		/* Send the packet */
-		ret = zsock_send(sock, sample_packet, packet_size, 0);
+		ret = zsock_send(sock, packet, packet_size, 0);
 		if (ret < 0) {
 			NET_ERR("Failed to send the packet (%d)", errno);
 			continue;
@@ -131,15 +143,76 @@ static inline int zperf_upload_fin(int sock,
 	return 0;
 }
 
-static int udp_upload(int sock, int port,
+static void udp_fill_header(struct zperf_udp_datagram *datagram,
+			    struct zperf_client_hdr_v1 *hdr,
+			    uint32_t id, int64_t loop_time, int port,
+			    unsigned int packet_size,
+			    unsigned int rate_in_kbps)
+{
+	uint32_t secs, usecs;
+
+	secs = k_ticks_to_ms_ceil32(loop_time) / 1000U;
+	usecs = k_ticks_to_us_ceil32(loop_time) - secs * USEC_PER_SEC;
+
+	datagram->id = htonl(id);
+	datagram->tv_sec = htonl(secs);
+	datagram->tv_usec = htonl(usecs);
+
+	hdr->flags = 0;
+	hdr->num_of_threads = htonl(1);
+	hdr->port = htonl(port);
+	hdr->buffer_len = SAMPLE_PACKET_SIZE -
+		sizeof(*datagram) - sizeof(*hdr);
+	hdr->bandwidth = htonl(rate_in_kbps);
+	hdr->num_of_bytes = htonl(packet_size);
+}
+
+/* Send UDP_BATCH datagrams with one call. Each datagram has its own header
+ * buffer, while the payload after the header is shared by all of them.
+ */
+static int udp_send_batch(int sock, uint8_t stream_id, uint32_t first_id,
+			  int64_t loop_time, int port,
+			  unsigned int packet_size, unsigned int rate_in_kbps)
+{
+	static struct udp_batch_hdr stream_hdrs[CONFIG_NET_ZPERF_MAX_STREAMS][UDP_BATCH];
+	struct udp_batch_hdr *hdrs = stream_hdrs[stream_id];
+	struct mmsghdr msgs[UDP_BATCH] = { 0 };
+	struct iovec iov[UDP_BATCH][2];
+	size_t hdr_len = MIN(packet_size, sizeof(struct udp_batch_hdr));
+	int ret;
+
+	for (int i = 0; i < UDP_BATCH; i++) {
+		udp_fill_header(&hdrs[i].datagram, &hdrs[i].hdr, first_id + i,
+				loop_time, port, packet_size, rate_in_kbps);
+
+		iov[i][0].iov_base = &hdrs[i];
+		iov[i][0].iov_len = hdr_len;
+		iov[i][1].iov_base = sample_packet[stream_id] + hdr_len;
+		iov[i][1].iov_len = packet_size - hdr_len;
+
+		msgs[i].msg_hdr.msg_iov = iov[i];
+		msgs[i].msg_hdr.msg_iovlen = ARRAY_SIZE(iov[i]);
+	}
+
+	ret = zsock_sendmmsg(sock, msgs, UDP_BATCH, 0);
+	if (ret < 0) {
+		return -errno;
+	}
+
+	return ret;
+}
+
+static int udp_upload(int sock, uint8_t stream_id, int port,
 		      unsigned int duration_in_ms,
 		      unsigned int packet_size,
 		      unsigned int rate_in_kbps,
 		      struct zperf_results *results)
 {
-	uint32_t packet_duration = zperf_packet_duration(packet_size, rate_in_kbps);
+	uint32_t packet_duration =
+		zperf_packet_duration(packet_size, rate_in_kbps) * UDP_BATCH;
 	uint64_t duration = sys_clock_timeout_end_calc(K_MSEC(duration_in_ms));
 	uint64_t delay = packet_duration;
+	uint8_t *packet = sample_packet[stream_id];
 	uint32_t nb_packets = 0U;
 	int64_t start_time, end_time;
 	int64_t last_print_time, last_loop_time;
@@ -161,12 +234,11 @@ static int udp_upload(int sock, int port,
 	last_print_time = start_time;
 	last_loop_time = start_time;
 
-	(void)memset(sample_packet, 'z', sizeof(sample_packet));
+	(void)memset(packet, 'z', SAMPLE_PACKET_SIZE);
 
 	do {
 		struct zperf_udp_datagram *datagram;
 		struct zperf_client_hdr_v1 *hdr;
-		uint32_t secs, usecs;
 		int64_t loop_time;
 		int32_t adjust;
 
@@ -194,32 +266,32 @@ static int udp_upload(int sock, int port,
 
 		last_loop_time = loop_time;
 
-		secs = k_ticks_to_ms_ceil32(loop_time) / 1000U;
-		usecs = k_ticks_to_us_ceil32(loop_time) - secs * USEC_PER_SEC;
-
-		/* Fill the packet header */
-		datagram = (struct zperf_udp_datagram *)sample_packet;
-
-		datagram->id = htonl(nb_packets);
-		datagram->tv_sec = htonl(secs);
-		datagram->tv_usec = htonl(usecs);
-
-		hdr = (struct zperf_client_hdr_v1 *)(sample_packet +
-						     sizeof(*datagram));
-		hdr->flags = 0;
-		hdr->num_of_threads = htonl(1);
-		hdr->port = htonl(port);
-		hdr->buffer_len = sizeof(sample_packet) -
-			sizeof(*datagram) - sizeof(*hdr);
-		hdr->bandwidth = htonl(rate_in_kbps);
-		hdr->num_of_bytes = htonl(packet_size);
+		if (UDP_BATCH > 1) {
+			ret = udp_send_batch(sock, stream_id, nb_packets,
+					     loop_time, port, packet_size,
+					     rate_in_kbps);
+			if (ret < 0) {
+				NET_ERR("Failed to send the packets (%d)", ret);
+				return ret;
+			}
 
-		/* Send the packet */
-		ret = zsock_send(sock, sample_packet, packet_size, 0);
-		if (ret < 0) {
-			NET_ERR("Failed to send the packet (%d)", errno);
-			return -errno;
+			nb_packets += ret;
 		} else {
+			/* Fill the packet header */
+			datagram = (struct zperf_udp_datagram *)packet;
+			hdr = (struct zperf_client_hdr_v1 *)(packet +
+							     sizeof(*datagram));
+
+			udp_fill_header(datagram, hdr, nb_packets, loop_time,
+					port, packet_size, rate_in_kbps);
+
+			/* Send the packet */
+			ret = zsock_send(sock, packet, packet_size, 0);
+			if (ret < 0) {
+				NET_ERR("Failed to send the packet (%d)", errno);
+				return -errno;
+			}
+
 			nb_packets++;
 		}
 
@@ -241,6 +313,8 @@ static int udp_upload(int sock, int port,
 		/* Wait */
 #if defined(CONFIG_ARCH_POSIX)
 		k_busy_wait(USEC_PER_MSEC);
+		/* Let the other streams of a parallel upload run */
+		k_yield();
 #else
 		if (delay != 0) {
 			if (k_us_to_ticks_floor64(delay) > remaining) {
@@ -254,7 +328,7 @@ static int udp_upload(int sock, int port,
 
 	end_time = k_uptime_ticks();
 
-	ret = zperf_upload_fin(sock, nb_packets, end_time, packet_size,
+	ret = zperf_upload_fin(sock, packet, nb_packets, end_time, packet_size,
 			       results);
 	if (ret < 0) {
 		return ret;
@@ -269,17 +343,14 @@ static int udp_upload(int sock, int port,
 	return 0;
 }
 
-int zperf_udp_upload(const struct zperf_upload_params *param,
-		     struct zperf_results *result)
+static int udp_upload_stream(const struct zperf_upload_params *param,
+			     uint8_t stream_id,
+			     struct zperf_results *result)
 {
 	int port = 0;
 	int sock;
 	int ret;
 
-	if (param == NULL || result == NULL) {
-		return -EINVAL;
-	}
-
 	if (param->peer_addr.sa_family == AF_INET) {
 		port = ntohs(net_sin(&param->peer_addr)->sin_port);
 	} else if (param->peer_addr.sa_family == AF_INET6) {
@@ -296,14 +367,25 @@ int zperf_udp_upload(const struct zperf_upload_params *param,
 		return sock;
 	}
 
-	ret = udp_upload(sock, port, param->duration_ms, param->packet_size,
-			 param->rate_kbps, result);
+	ret = udp_upload(sock, stream_id, port, param->duration_ms,
+			 param->packet_size, param->rate_kbps, result);
 
 	zsock_close(sock);
 
 	return ret;
 }
 
+int zperf_udp_upload(const struct zperf_upload_params *param,
+		     struct zperf_results *result)
+{
+	if (param == NULL || result == NULL) {
+		return -EINVAL;
+	}
+
+	return zperf_upload_streams(param, udp_upload_stream, NULL, NULL,
+				    result);
+}
+
 static void udp_upload_async_work(struct k_work *work)
 {
 	struct zperf_async_upload_context *upload_ctx =
@@ -314,7 +396,9 @@ static void udp_upload_async_work(struct k_work *work)
 	upload_ctx->callback(ZPERF_SESSION_STARTED, NULL,
 			     upload_ctx->user_data);
 
-	ret = zperf_udp_upload(&upload_ctx->param, &result);
+	ret = zperf_upload_streams(&upload_ctx->param, udp_upload_stream,
+				   upload_ctx->callback, upload_ctx->user_data,
+				   &result);
 	if (ret < 0) {
 		upload_ctx->callback(ZPERF_SESSION_ERROR, NULL,
 				     upload_ctx->user_data);
@@ -11,6 +11,8 @@ LOG_MODULE_REGISTER(npf_base, CONFIG_NET_PKT_FILTER_LOG_LEVEL);
 #include <zephyr/net/net_pkt_filter.h>
 #include <zephyr/spinlock.h>
 
+#include "npf_internal.h"
+
 /*
  * Our actual rule lists for supported test points
  */
@@ -78,24 +80,33 @@ static enum net_verdict evaluate(sys_slist_t *rule_head, struct net_pkt *pkt)
 static enum net_verdict lock_evaluate(struct npf_rule_list *rules, struct net_pkt *pkt)
 {
 	k_spinlock_key_t key = k_spin_lock(&rules->lock);
-	enum net_verdict result = evaluate(&rules->rule_head, pkt);
+	enum net_verdict result;
+
+	if (rules->program != NULL) {
+		result = npf_program_run(rules->program, pkt);
+	} else {
+		result = evaluate(&rules->rule_head, pkt);
+	}
 
 	k_spin_unlock(&rules->lock, key);
 	return result;
 }
 
-bool net_pkt_filter_send_ok(struct net_pkt *pkt)
+bool npf_rules_ok(struct npf_rule_list *rules, struct net_pkt *pkt)
 {
-	enum net_verdict result = lock_evaluate(&npf_send_rules, pkt);
+	enum net_verdict result = lock_evaluate(rules, pkt);
 
 	return result == NET_OK;
 }
 
-bool net_pkt_filter_recv_ok(struct net_pkt *pkt)
+bool net_pkt_filter_send_ok(struct net_pkt *pkt)
 {
-	enum net_verdict result = lock_evaluate(&npf_recv_rules, pkt);
+	return npf_rules_ok(&npf_send_rules, pkt);
+}
 
-	return result == NET_OK;
+bool net_pkt_filter_recv_ok(struct net_pkt *pkt)
+{
+	return npf_rules_ok(&npf_recv_rules, pkt);
 }
 
 /*
@@ -107,6 +118,7 @@ void npf_insert_rule(struct npf_rule_list *rules, struct npf_rule *rule)
 	k_spinlock_key_t key = k_spin_lock(&rules->lock);
 
 	NET_DBG("inserting rule %p into %p", rule, rules);
+	rules->program = NULL;
 	sys_slist_prepend(&rules->rule_head, &rule->node);
 
 	k_spin_unlock(&rules->lock, key);
@@ -120,6 +132,7 @@ void npf_append_rule(struct npf_rule_list *rules, struct npf_rule *rule)
 	k_spinlock_key_t key = k_spin_lock(&rules->lock);
 
 	NET_DBG("appending rule %p into %p", rule, rules);
+	rules->program = NULL;
 	sys_slist_append(&rules->rule_head, &rule->node);
 
 	k_spin_unlock(&rules->lock, key);
@@ -130,6 +143,10 @@ bool npf_remove_rule(struct npf_rule_list *rules, struct npf_rule *rule)
 	k_spinlock_key_t key = k_spin_lock(&rules->lock);
 	bool result = sys_slist_find_and_remove(&rules->rule_head, &rule->node);
 
+	if (result) {
+		rules->program = NULL;
+	}
+
 	k_spin_unlock(&rules->lock, key);
 	NET_DBG("removing rule %p from %p: %d", rule, rules, result);
 	return result;
@@ -142,6 +159,7 @@ bool npf_remove_all_rules(struct npf_rule_list *rules)
 
 	if (result) {
 		sys_slist_init(&rules->rule_head);
+		rules->program = NULL;
 		NET_DBG("removing all rules from %p", rules);
 	}
 
@@ -0,0 +1,461 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(npf_compile, CONFIG_NET_PKT_FILTER_LOG_LEVEL);
+
+#include <string.h>
+#include <zephyr/net/net_core.h>
+#include <zephyr/net/net_ip.h>
+#include <zephyr/net/ethernet.h>
+#include <zephyr/net/net_pkt_filter.h>
+#include <zephyr/spinlock.h>
+
+#include "npf_internal.h"
+
+enum npf_op {
+	NPF_OP_RETURN,
+	NPF_OP_CALL,		/* condition unknown to the compiler */
+	NPF_OP_IFACE,
+	NPF_OP_ORIG_IFACE,
+	NPF_OP_SIZE,
+	NPF_OP_ETH_TYPE,
+	NPF_OP_IP_PROTO,
+	NPF_OP_SRC_ADDR,
+	NPF_OP_DST_ADDR,
+	NPF_OP_SRC_PORT,
+	NPF_OP_DST_PORT,
+};
+
+#define NPF_INSN_NEGATE BIT(0)
+
+#define NO_RULE UINT16_MAX
+
+/* Hash table filled up to 3/4 */
+#define TABLE_MAX_ENTRIES(size) ((size) - (size) / 4U)
+
+static const struct {
+	npf_test_fn_t *fn;
+	uint8_t op;
+	uint8_t flags;
+} known_tests[] = {
+	{ npf_iface_match, NPF_OP_IFACE, 0 },
+	{ npf_iface_unmatch, NPF_OP_IFACE, NPF_INSN_NEGATE },
+	{ npf_orig_iface_match, NPF_OP_ORIG_IFACE, 0 },
+	{ npf_orig_iface_unmatch, NPF_OP_ORIG_IFACE, NPF_INSN_NEGATE },
+	{ npf_size_inbounds, NPF_OP_SIZE, 0 },
+#if defined(CONFIG_NET_L2_ETHERNET)
+	{ npf_eth_type_match, NPF_OP_ETH_TYPE, 0 },
+	{ npf_eth_type_unmatch, NPF_OP_ETH_TYPE, NPF_INSN_NEGATE },
+#endif
+#if defined(CONFIG_NET_IP)
+	{ npf_ip_proto_match, NPF_OP_IP_PROTO, 0 },
+	{ npf_ip_proto_unmatch, NPF_OP_IP_PROTO, NPF_INSN_NEGATE },
+	{ npf_ip_src_addr_match, NPF_OP_SRC_ADDR, 0 },
+	{ npf_ip_src_addr_unmatch, NPF_OP_SRC_ADDR, NPF_INSN_NEGATE },
+	{ npf_ip_dst_addr_match, NPF_OP_DST_ADDR, 0 },
+	{ npf_ip_dst_addr_unmatch, NPF_OP_DST_ADDR, NPF_INSN_NEGATE },
+	{ npf_src_port_inrange, NPF_OP_SRC_PORT, 0 },
+	{ npf_dst_port_inrange, NPF_OP_DST_PORT, 0 },
+#endif
+};
+
+static uint32_t hash_5tuple(uint8_t family, uint8_t proto,
+			    const uint8_t *src_addr, const uint8_t *dst_addr,
+			    uint16_t src_port, uint16_t dst_port)
+{
+	size_t addr_len = family == AF_INET6 ? NET_IPV6_ADDR_SIZE :
+					       NET_IPV4_ADDR_SIZE;
+	uint32_t hash = 2166136261U;
+	size_t i;
+
+	/* FNV-1a */
+	for (i = 0; i < addr_len; i++) {
+		hash = (hash ^ src_addr[i]) * 16777619U;
+		hash = (hash ^ dst_addr[i]) * 16777619U;
+	}
+
+	hash = (hash ^ proto) * 16777619U;
+	hash = (hash ^ src_port) * 16777619U;
+	hash = (hash ^ dst_port) * 16777619U;
+
+	return hash;
+}
+
+static struct npf_exact_entry *lookup(struct npf_program *program,
+				      const struct npf_ip_info *info)
+{
+	size_t addr_len = info->family == AF_INET6 ? NET_IPV6_ADDR_SIZE :
+						     NET_IPV4_ADDR_SIZE;
+	uint32_t mask = program->table_size - 1U;
+	struct npf_exact_entry *entry;
+	uint32_t idx;
+
+	idx = hash_5tuple(info->family, info->proto, info->src_addr,
+			  info->dst_addr, info->src_port, info->dst_port) & mask;
+
+	/* Linear probing, the table is never full */
+	for (entry = &program->table[idx]; entry->in_use;
+	     idx = (idx + 1U) & mask, entry = &program->table[idx]) {
+		if (entry->family == info->family &&
+		    entry->proto == info->proto &&
+		    entry->src_port == info->src_port &&
+		    entry->dst_port == info->dst_port &&
+		    memcmp(entry->src_addr, info->src_addr, addr_len) == 0 &&
+		    memcmp(entry->dst_addr, info->dst_addr, addr_len) == 0) {
+			return entry;
+		}
+	}
+
+	return NULL;
+}
+
+enum net_verdict npf_program_run(struct npf_program *program, struct net_pkt *pkt)
+{
+	struct npf_exact_entry *entry;
+	const struct npf_insn *insn;
+	struct npf_ip_info info;
+	uint16_t exact_rule = NO_RULE;
+	uint8_t exact_result = NET_DROP;
+	bool info_valid = false;
+	bool match;
+	uint16_t pc = 0;
+
+	if (program->nb_entries > 0) {
+		npf_get_ip_info(pkt, &info);
+		info_valid = true;
+
+		if (info.has_ports) {
+			entry = lookup(program, &info);
+			if (entry != NULL) {
+				exact_rule = entry->rule;
+				exact_result = entry->result;
+			}
+		}
+	}
+
+	while (pc < program->nb_insns) {
+		insn = &program->insns[pc];
+
+		/* A hashed rule located before this one matched */
+		if (insn->rule > exact_rule) {
+			return exact_result;
+		}
+
+		switch (insn->op) {
+		case NPF_OP_RETURN:
+			return insn->result;
+
+		case NPF_OP_IFACE:
+			match = CONTAINER_OF(insn->test, struct npf_test_iface,
+					     test)->iface == net_pkt_iface(pkt);
+			break;
+
+		case NPF_OP_ORIG_IFACE:
+			match = CONTAINER_OF(insn->test, struct npf_test_iface,
+					     test)->iface == net_pkt_orig_iface(pkt);
+			break;
+
+		case NPF_OP_SIZE: {
+			struct npf_test_size_bounds *bounds =
+				CONTAINER_OF(insn->test, struct npf_test_size_bounds, test);
+			size_t pkt_size = net_pkt_get_len(pkt);
+
+			match = pkt_size >= bounds->min && pkt_size <= bounds->max;
+			break;
+		}
+
+#if defined(CONFIG_NET_L2_ETHERNET)
+		case NPF_OP_ETH_TYPE:
+			match = NET_ETH_HDR(pkt)->type ==
+				CONTAINER_OF(insn->test, struct npf_test_eth_type, test)->type;
+			break;
+#endif
+
+		case NPF_OP_IP_PROTO:
+		case NPF_OP_SRC_ADDR:
+		case NPF_OP_DST_ADDR:
+		case NPF_OP_SRC_PORT:
+		case NPF_OP_DST_PORT: {
+			struct npf_test_port_range *range;
+			struct npf_test_ip_addr *addr;
+
+			if (!info_valid) {
+				npf_get_ip_info(pkt, &info);
+				info_valid = true;
+			}
+
+			if (insn->op == NPF_OP_IP_PROTO) {
+				match = info.family != AF_UNSPEC &&
+					info.proto == CONTAINER_OF(insn->test,
+								   struct npf_test_ip_proto,
+								   test)->proto;
+			} else if (insn->op == NPF_OP_SRC_ADDR || insn->op == NPF_OP_DST_ADDR) {
+				addr = CONTAINER_OF(insn->test, struct npf_test_ip_addr, test);
+				match = info.family == addr->family &&
+					npf_ip_addr_test(addr, insn->op == NPF_OP_SRC_ADDR ?
+							       info.src_addr : info.dst_addr);
+			} else {
+				range = CONTAINER_OF(insn->test, struct npf_test_port_range,
+						     test);
+				match = info.has_ports &&
+					IN_RANGE(insn->op == NPF_OP_SRC_PORT ?
+						 info.src_port : info.dst_port,
+						 range->min, range->max);
+			}
+
+			break;
+		}
+
+		default:
+			match = insn->test->fn(insn->test, pkt);
+			break;
+		}
+
+		if (match != !!(insn->flags & NPF_INSN_NEGATE)) {
+			pc++;
+		} else {
+			pc = insn->next_rule;
+		}
+	}
+
+	if (exact_rule != NO_RULE) {
+		return exact_result;
+	}
+
+	return program->no_match;
+}
+
+/* Return the condition of a rule if it is of the expected type. */
+static struct npf_test *find_test(struct npf_rule *rule, npf_test_fn_t *fn)
+{
+	struct npf_test *found = NULL;
+	uint32_t i;
+
+	for (i = 0; i < rule->nb_tests; i++) {
+		if (rule->tests[i]->fn == fn) {
+			if (found != NULL) {
+				return NULL;
+			}
+
+			found = rule->tests[i];
+		}
+	}
+
+	return found;
+}
+
+/* Add the rule to the hash table if it matches an exact 5-tuple. */
+static bool compile_exact(struct npf_program *program, struct npf_rule *rule,
+			  uint16_t rule_idx)
+{
+#if defined(CONFIG_NET_IP)
+	struct npf_test_ip_addr *src, *dst;
+	struct npf_test_port_range *sport, *dport;
+	struct npf_test_ip_proto *proto;
+	struct npf_exact_entry *entry;
+	struct npf_test *test;
+	size_t addr_len;
+	uint32_t mask;
+	uint32_t idx;
+
+	if (program->table_size == 0U || rule->nb_tests != 5U ||
+	    program->nb_entries >= TABLE_MAX_ENTRIES(program->table_size)) {
+		return false;
+	}
+
+	test = find_test(rule, npf_ip_proto_match);
+	if (test == NULL) {
+		return false;
+	}
+
+	proto = CONTAINER_OF(test, struct npf_test_ip_proto, test);
+	if (proto->proto != IPPROTO_UDP && proto->proto != IPPROTO_TCP) {
+		return false;
+	}
+
+	test = find_test(rule, npf_ip_src_addr_match);
+	if (test == NULL) {
+		return false;
+	}
+
+	src = CONTAINER_OF(test, struct npf_test_ip_addr, test);
+
+	test = find_test(rule, npf_ip_dst_addr_match);
+	if (test == NULL) {
+		return false;
+	}
+
+	dst = CONTAINER_OF(test, struct npf_test_ip_addr, test);
+
+	test = find_test(rule, npf_src_port_inrange);
+	if (test == NULL) {
+		return false;
+	}
+
+	sport = CONTAINER_OF(test, struct npf_test_port_range, test);
+
+	test = find_test(rule, npf_dst_port_inrange);
+	if (test == NULL) {
+		return false;
+	}
+
+	dport = CONTAINER_OF(test, struct npf_test_port_range, test);
+
+	addr_len = src->family == AF_INET6 ? NET_IPV6_ADDR_SIZE : NET_IPV4_ADDR_SIZE;
+
+	if (src->family != dst->family ||
+	    src->nb_addresses != 1U || dst->nb_addresses != 1U ||
+	    src->prefix_len != addr_len * 8U || dst->prefix_len != addr_len * 8U ||
+	    sport->min != sport->max || dport->min != dport->max) {
+		return false;
+	}
+
+	mask = program->table_size - 1U;
+	idx = hash_5tuple(src->family, proto->proto, src->addresses,
+			  dst->addresses, sport->min, dport->min) & mask;
+
+	while (program->table[idx].in_use) {
+		entry = &program->table[idx];
+
+		/* An earlier rule already matches the same 5-tuple */
+		if (entry->family == src->family && entry->proto == proto->proto &&
+		    entry->src_port == sport->min && entry->dst_port == dport->min &&
+		    memcmp(entry->src_addr, src->addresses, addr_len) == 0 &&
+		    memcmp(entry->dst_addr, dst->addresses, addr_len) == 0) {
+			return true;
+		}
+
+		idx = (idx + 1U) & mask;
+	}
+
+	entry = &program->table[idx];
+
+	memcpy(entry->src_addr, src->addresses, addr_len);
+	memcpy(entry->dst_addr, dst->addresses, addr_len);
+	entry->src_port = sport->min;
+	entry->dst_port = dport->min;
+	entry->family = src->family;
+	entry->proto = proto->proto;
+	entry->rule = rule_idx;
+	entry->result = rule->result;
+	entry->in_use = true;
+
+	program->nb_entries++;
+
+	return true;
+#else
+	ARG_UNUSED(program);
+	ARG_UNUSED(rule);
+	ARG_UNUSED(rule_idx);
+
+	return false;
+#endif
+}
+
+static void compile_test(struct npf_insn *insn, struct npf_test *test)
+{
+	size_t i;
+
+	insn->op = NPF_OP_CALL;
+	insn->flags = 0U;
+	insn->test = test;
+
+	for (i = 0; i < ARRAY_SIZE(known_tests); i++) {
+		if (known_tests[i].fn == test->fn) {
+			insn->op = known_tests[i].op;
+			insn->flags = known_tests[i].flags;
+			break;
+		}
+	}
+}
+
+static int compile(sys_slist_t *rule_head, struct npf_program *program)
+{
+	struct npf_insn *insn;
+	struct npf_rule *rule;
+	uint16_t rule_idx = 0U;
+	uint16_t first;
+	uint32_t i;
+
+	program->nb_insns = 0U;
+	program->nb_entries = 0U;
+	program->no_match = sys_slist_is_empty(rule_head) ? NET_OK : NET_DROP;
+
+	if (program->table_size > 0U) {
+		memset(program->table, 0, program->table_size * sizeof(program->table[0]));
+	}
+
+	SYS_SLIST_FOR_EACH_CONTAINER(rule_head, rule, node) {
+		if (rule_idx == NO_RULE) {
+			return -ENOMEM;
+		}
+
+		if (compile_exact(program, rule, rule_idx)) {
+			rule_idx++;
+			continue;
+		}
+
+		if (program->nb_insns + rule->nb_tests + 1U > program->max_insns) {
+			return -ENOMEM;
+		}
+
+		first = program->nb_insns;
+
+		for (i = 0; i < rule->nb_tests; i++) {
+			insn = &program->insns[program->nb_insns++];
+			compile_test(insn, rule->tests[i]);
+			insn->rule = rule_idx;
+		}
+
+		insn = &program->insns[program->nb_insns++];
+		insn->op = NPF_OP_RETURN;
+		insn->flags = 0U;
+		insn->rule = rule_idx;
+		insn->result = rule->result;
+		insn->test = NULL;
+
+		/* A failed test jumps to the next rule */
+		for (i = first; i < program->nb_insns; i++) {
+			program->insns[i].next_rule = program->nb_insns;
+		}
+
+		rule_idx++;
+	}
+
+	NET_DBG("%u rules: %u instructions, %u hashed", rule_idx,
+		program->nb_insns, program->nb_entries);
+
+	return 0;
+}
+
+int npf_compile_rules(struct npf_rule_list *rules, struct npf_program *program)
+{
+	k_spinlock_key_t key = k_spin_lock(&rules->lock);
+	int ret;
+
+	rules->program = NULL;
+
+	ret = compile(&rules->rule_head, program);
+	if (ret == 0) {
+		rules->program = program;
+	}
+
+	k_spin_unlock(&rules->lock, key);
+
+	if (ret < 0) {
+		NET_ERR("Cannot compile rules %p (%d)", rules, ret);
+	}
+
+	return ret;
+}
+
+void npf_uncompile_rules(struct npf_rule_list *rules)
+{
+	k_spinlock_key_t key = k_spin_lock(&rules->lock);
+
+	rules->program = NULL;
+
+	k_spin_unlock(&rules->lock, key);
+}
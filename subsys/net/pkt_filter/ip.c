@@ -0,0 +1,353 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(npf_ip, CONFIG_NET_PKT_FILTER_LOG_LEVEL);
+
+#include <string.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/net/net_ip.h>
+#include <zephyr/net/ethernet.h>
+#include <zephyr/net/net_pkt_filter.h>
+
+#include "npf_internal.h"
+
+#define VLAN_HDR_LEN 4
+#define IPV4_IHL_MASK 0x0f
+#define IPV6_FRAG_OFFSET_MASK 0xfff8
+
+/* Whether the frames of the L2 are made of the IP packet only. */
+static bool l2_is_raw_ip(const struct net_l2 *l2)
+{
+#if defined(CONFIG_NET_L2_DUMMY)
+	if (l2 == &NET_L2_GET_NAME(DUMMY)) {
+		return true;
+	}
+#endif
+#if defined(CONFIG_NET_L2_VIRTUAL)
+	if (l2 == &NET_L2_GET_NAME(VIRTUAL)) {
+		return true;
+	}
+#endif
+#if defined(CONFIG_NET_L2_OPENTHREAD)
+	if (l2 == &NET_L2_GET_NAME(OPENTHREAD)) {
+		return true;
+	}
+#endif
+
+	ARG_UNUSED(l2);
+
+	return false;
+}
+
+/* Offset of the IP header, or a negative value if the link layer protocol
+ * is not IP.
+ */
+static int get_ip_offset(struct net_pkt *pkt, const struct net_buf *buf)
+{
+	const struct net_l2 *l2;
+#if defined(CONFIG_NET_L2_ETHERNET)
+	const struct net_eth_hdr *eth_hdr;
+	uint16_t type;
+	int offset;
+#endif
+
+	/* Outgoing packets get their link layer header from the L2 after
+	 * being filtered, incoming ones are filtered before the L2 removes
+	 * it.
+	 */
+	if (net_pkt_family(pkt) != AF_UNSPEC) {
+		return 0;
+	}
+
+	l2 = net_if_l2(net_pkt_iface(pkt));
+
+#if defined(CONFIG_NET_L2_ETHERNET)
+	if (l2 == &NET_L2_GET_NAME(ETHERNET)) {
+		if (buf->len < sizeof(struct net_eth_hdr)) {
+			return -EINVAL;
+		}
+
+		eth_hdr = (const struct net_eth_hdr *)buf->data;
+		type = ntohs(eth_hdr->type);
+		offset = sizeof(struct net_eth_hdr);
+
+		if (type == NET_ETH_PTYPE_VLAN) {
+			if (buf->len < offset + VLAN_HDR_LEN) {
+				return -EINVAL;
+			}
+
+			type = sys_get_be16(&buf->data[offset + 2]);
+			offset += VLAN_HDR_LEN;
+		}
+
+		if (type != NET_ETH_PTYPE_IP && type != NET_ETH_PTYPE_IPV6) {
+			return -EINVAL;
+		}
+
+		return offset;
+	}
+#endif
+
+	ARG_UNUSED(buf);
+
+	/* The frames of the other L2s, like IEEE 802.15.4, Bluetooth or PPP,
+	 * do not start with a plain IP header.
+	 */
+	if (!l2_is_raw_ip(l2)) {
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+static int get_ipv4_info(const uint8_t *data, size_t len, struct npf_ip_info *info)
+{
+	const struct net_ipv4_hdr *hdr = (const struct net_ipv4_hdr *)data;
+	size_t hdr_len;
+
+	if (len < sizeof(struct net_ipv4_hdr)) {
+		return -EINVAL;
+	}
+
+	hdr_len = (hdr->vhl & IPV4_IHL_MASK) * 4U;
+	if (hdr_len < sizeof(struct net_ipv4_hdr) || hdr_len > len) {
+		return -EINVAL;
+	}
+
+	info->family = AF_INET;
+	info->proto = hdr->proto;
+	info->src_addr = hdr->src;
+	info->dst_addr = hdr->dst;
+
+	/* Only the first fragment carries the ports */
+	if ((sys_get_be16(hdr->offset) & NET_IPV4_FRAGH_OFFSET_MASK) != 0U) {
+		return -ENODATA;
+	}
+
+	return hdr_len;
+}
+
+static int get_ipv6_info(const uint8_t *data, size_t len, struct npf_ip_info *info)
+{
+	const struct net_ipv6_hdr *hdr = (const struct net_ipv6_hdr *)data;
+	size_t offset = sizeof(struct net_ipv6_hdr);
+	uint8_t nexthdr;
+
+	if (len < sizeof(struct net_ipv6_hdr)) {
+		return -EINVAL;
+	}
+
+	info->family = AF_INET6;
+	info->src_addr = hdr->src;
+	info->dst_addr = hdr->dst;
+
+	nexthdr = hdr->nexthdr;
+
+	/* Skip the extension headers to find the upper layer protocol */
+	while (true) {
+		info->proto = nexthdr;
+
+		switch (nexthdr) {
+		case NET_IPV6_NEXTHDR_HBHO:
+		case NET_IPV6_NEXTHDR_DESTO:
+		case NET_IPV6_NEXTHDR_ROUTING:
+			if (len < offset + 2) {
+				return -ENODATA;
+			}
+
+			nexthdr = data[offset];
+			offset += (data[offset + 1] + 1U) * 8U;
+			break;
+
+		case NET_IPV6_NEXTHDR_FRAG:
+			if (len < offset + sizeof(struct net_ipv6_frag_hdr)) {
+				return -ENODATA;
+			}
+
+			nexthdr = data[offset];
+
+			/* Only the first fragment carries the ports */
+			if ((sys_get_be16(&data[offset + 2]) & IPV6_FRAG_OFFSET_MASK) != 0U) {
+				info->proto = nexthdr;
+				return -ENODATA;
+			}
+
+			offset += sizeof(struct net_ipv6_frag_hdr);
+			break;
+
+		default:
+			return offset;
+		}
+	}
+}
+
+void npf_get_ip_info(struct net_pkt *pkt, struct npf_ip_info *info)
+{
+	const struct net_buf *buf = pkt->buffer;
+	const uint8_t *data;
+	size_t len;
+	int offset;
+
+	info->family = AF_UNSPEC;
+	info->has_ports = false;
+
+	if (buf == NULL) {
+		return;
+	}
+
+	offset = get_ip_offset(pkt, buf);
+	if (offset < 0 || buf->len <= offset) {
+		return;
+	}
+
+	data = &buf->data[offset];
+	len = buf->len - offset;
+
+	switch (data[0] & 0xf0) {
+	case 0x40:
+		if (!IS_ENABLED(CONFIG_NET_IPV4)) {
+			return;
+		}
+
+		offset = get_ipv4_info(data, len, info);
+		break;
+
+	case 0x60:
+		if (!IS_ENABLED(CONFIG_NET_IPV6)) {
+			return;
+		}
+
+		offset = get_ipv6_info(data, len, info);
+		break;
+
+	default:
+		return;
+	}
+
+	if (offset < 0) {
+		if (offset == -EINVAL) {
+			info->family = AF_UNSPEC;
+		}
+
+		return;
+	}
+
+	if ((info->proto == IPPROTO_UDP || info->proto == IPPROTO_TCP) &&
+	    len >= offset + 2 * sizeof(uint16_t)) {
+		info->src_port = sys_get_be16(&data[offset]);
+		info->dst_port = sys_get_be16(&data[offset + 2]);
+		info->has_ports = true;
+	}
+}
+
+static bool prefix_compare(const uint8_t *addr1, const uint8_t *addr2,
+			   uint8_t prefix_len)
+{
+	uint8_t bytes = prefix_len / 8U;
+	uint8_t bits = prefix_len % 8U;
+	uint8_t mask;
+
+	if (memcmp(addr1, addr2, bytes) != 0) {
+		return false;
+	}
+
+	if (bits == 0U) {
+		return true;
+	}
+
+	mask = (uint8_t)(0xff << (8U - bits));
+
+	return ((addr1[bytes] ^ addr2[bytes]) & mask) == 0U;
+}
+
+bool npf_ip_addr_test(const struct npf_test_ip_addr *test, const uint8_t *addr)
+{
+	size_t addr_len = test->family == AF_INET6 ? NET_IPV6_ADDR_SIZE :
+						      NET_IPV4_ADDR_SIZE;
+	const uint8_t *addresses = test->addresses;
+	unsigned int i;
+
+	for (i = 0; i < test->nb_addresses; i++) {
+		if (prefix_compare(&addresses[i * addr_len], addr, test->prefix_len)) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool npf_ip_proto_match(struct npf_test *test, struct net_pkt *pkt)
+{
+	struct npf_test_ip_proto *test_proto =
+			CONTAINER_OF(test, struct npf_test_ip_proto, test);
+	struct npf_ip_info info;
+
+	npf_get_ip_info(pkt, &info);
+
+	return info.family != AF_UNSPEC && info.proto == test_proto->proto;
+}
+
+bool npf_ip_proto_unmatch(struct npf_test *test, struct net_pkt *pkt)
+{
+	return !npf_ip_proto_match(test, pkt);
+}
+
+bool npf_ip_src_addr_match(struct npf_test *test, struct net_pkt *pkt)
+{
+	struct npf_test_ip_addr *test_addr =
+			CONTAINER_OF(test, struct npf_test_ip_addr, test);
+	struct npf_ip_info info;
+
+	npf_get_ip_info(pkt, &info);
+
+	return info.family == test_addr->family &&
+	       npf_ip_addr_test(test_addr, info.src_addr);
+}
+
+bool npf_ip_src_addr_unmatch(struct npf_test *test, struct net_pkt *pkt)
+{
+	return !npf_ip_src_addr_match(test, pkt);
+}
+
+bool npf_ip_dst_addr_match(struct npf_test *test, struct net_pkt *pkt)
+{
+	struct npf_test_ip_addr *test_addr =
+			CONTAINER_OF(test, struct npf_test_ip_addr, test);
+	struct npf_ip_info info;
+
+	npf_get_ip_info(pkt, &info);
+
+	return info.family == test_addr->family &&
+	       npf_ip_addr_test(test_addr, info.dst_addr);
+}
+
+bool npf_ip_dst_addr_unmatch(struct npf_test *test, struct net_pkt *pkt)
+{
+	return !npf_ip_dst_addr_match(test, pkt);
+}
+
+bool npf_src_port_inrange(struct npf_test *test, struct net_pkt *pkt)
+{
+	struct npf_test_port_range *range =
+			CONTAINER_OF(test, struct npf_test_port_range, test);
+	struct npf_ip_info info;
+
+	npf_get_ip_info(pkt, &info);
+
+	return info.has_ports && info.src_port >= range->min &&
+	       info.src_port <= range->max;
+}
+
+bool npf_dst_port_inrange(struct npf_test *test, struct net_pkt *pkt)
+{
+	struct npf_test_port_range *range =
+			CONTAINER_OF(test, struct npf_test_port_range, test);
+	struct npf_ip_info info;
+
+	npf_get_ip_info(pkt, &info);
+
+	return info.has_ports && info.dst_port >= range->min &&
+	       info.dst_port <= range->max;
+}
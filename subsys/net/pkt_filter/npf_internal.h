@@ -0,0 +1,51 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef __NPF_INTERNAL_H
+#define __NPF_INTERNAL_H
+
+#include <zephyr/net/net_pkt.h>
+#include <zephyr/net/net_pkt_filter.h>
+
+/* IP addresses, protocol and ports of a packet */
+struct npf_ip_info {
+	const uint8_t *src_addr;
+	const uint8_t *dst_addr;
+	uint16_t src_port;		/* host order */
+	uint16_t dst_port;		/* host order */
+	sa_family_t family;		/* AF_UNSPEC if not an IP packet */
+	uint8_t proto;
+	bool has_ports;
+};
+
+#if defined(CONFIG_NET_IP)
+/* Locate the IP header of the packet, which is preceded by the link layer
+ * header in packets that have not been processed by the L2 yet. Only the
+ * first fragment of the packet is inspected.
+ */
+void npf_get_ip_info(struct net_pkt *pkt, struct npf_ip_info *info);
+
+bool npf_ip_addr_test(const struct npf_test_ip_addr *test, const uint8_t *addr);
+#else
+static inline void npf_get_ip_info(struct net_pkt *pkt, struct npf_ip_info *info)
+{
+	ARG_UNUSED(pkt);
+
+	info->family = AF_UNSPEC;
+	info->has_ports = false;
+}
+
+static inline bool npf_ip_addr_test(const struct npf_test_ip_addr *test,
+				    const uint8_t *addr)
+{
+	ARG_UNUSED(test);
+	ARG_UNUSED(addr);
+
+	return false;
+}
+#endif
+
+enum net_verdict npf_program_run(struct npf_program *program, struct net_pkt *pkt);
+
+#endif /* __NPF_INTERNAL_H */
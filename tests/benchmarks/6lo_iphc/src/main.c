@@ -0,0 +1,187 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Measures the time needed to compress and uncompress the IPv6 and UDP
+ * headers of a packet with 6LoWPAN IPHC, for link-local, context based and
+ * multicast addresses, on an interface using IEEE 802.15.4 link addresses.
+ * Every iteration sends a new packet to the same neighbor, as a Thread device
+ * typically does.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <zephyr/net/net_if.h>
+#include <zephyr/net/net_pkt.h>
+#include <zephyr/net/net_ip.h>
+#include <zephyr/net/dummy.h>
+
+#include "6lo.h"
+#include "icmpv6.h"
+
+#define ITERATIONS 1000
+#define PAYLOAD_LEN 32
+
+#define UDP_SRC_PORT 0xf0b1
+#define UDP_DST_PORT 5683
+
+static uint8_t src_mac[8] = { 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0xaa, 0xbb };
+static uint8_t dst_mac[8] = { 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0xbb, 0xaa };
+
+static struct net_icmpv6_nd_opt_6co ctx = {
+	.context_len = 0x40,
+	.flag = 0x11,
+	.lifetime = 0x1234,
+	.prefix = { 0x20, 0x01, 0x0d, 0xb8 },
+};
+
+static struct net_if *iface;
+
+static void iphc_iface_init(struct net_if *iface)
+{
+	net_if_set_link_addr(iface, src_mac, sizeof(src_mac), NET_LINK_IEEE802154);
+}
+
+static int iphc_send(const struct device *dev, struct net_pkt *pkt)
+{
+	return 0;
+}
+
+static struct dummy_api iphc_if_api = {
+	.iface_api.init = iphc_iface_init,
+	.send = iphc_send,
+};
+
+NET_DEVICE_INIT(iphc_bench, "iphc_bench", NULL, NULL, NULL, NULL,
+		CONFIG_KERNEL_INIT_PRIORITY_DEFAULT, &iphc_if_api, DUMMY_L2,
+		NET_L2_GET_CTX_TYPE(DUMMY_L2), 127);
+
+static void ll_addr(struct in6_addr *addr, uint8_t *mac)
+{
+	struct net_linkaddr lladdr = {
+		.addr = mac,
+		.len = 8,
+		.type = NET_LINK_IEEE802154,
+	};
+
+	net_ipv6_addr_create_iid(addr, &lladdr);
+}
+
+static struct net_pkt *create_pkt(const struct in6_addr *src,
+				  const struct in6_addr *dst)
+{
+	struct net_ipv6_hdr ipv6 = {
+		.vtc = 0x60,
+		.nexthdr = IPPROTO_UDP,
+		.hop_limit = 64,
+		.len = htons(NET_UDPH_LEN + PAYLOAD_LEN),
+	};
+	struct net_udp_hdr udp = {
+		.src_port = htons(UDP_SRC_PORT),
+		.dst_port = htons(UDP_DST_PORT),
+		.len = htons(NET_UDPH_LEN + PAYLOAD_LEN),
+	};
+	static const uint8_t payload[PAYLOAD_LEN];
+	struct net_pkt *pkt;
+
+	net_ipv6_addr_copy_raw(ipv6.src, (const uint8_t *)src);
+	net_ipv6_addr_copy_raw(ipv6.dst, (const uint8_t *)dst);
+
+	pkt = net_pkt_alloc_with_buffer(iface, NET_IPV6UDPH_LEN + PAYLOAD_LEN,
+					AF_INET6, IPPROTO_UDP, K_NO_WAIT);
+	zassert_not_null(pkt, "Cannot allocate pkt");
+
+	net_pkt_lladdr_src(pkt)->addr = src_mac;
+	net_pkt_lladdr_src(pkt)->len = sizeof(src_mac);
+	net_pkt_lladdr_dst(pkt)->addr = dst_mac;
+	net_pkt_lladdr_dst(pkt)->len = sizeof(dst_mac);
+
+	zassert_equal(net_pkt_write(pkt, &ipv6, sizeof(ipv6)), 0, "");
+	zassert_equal(net_pkt_write(pkt, &udp, sizeof(udp)), 0, "");
+	zassert_equal(net_pkt_write(pkt, payload, sizeof(payload)), 0, "");
+
+	net_pkt_set_ip_hdr_len(pkt, NET_IPV6H_LEN);
+	net_pkt_cursor_init(pkt);
+
+	return pkt;
+}
+
+static void measure(const char *name, const struct in6_addr *src,
+		    const struct in6_addr *dst)
+{
+	uint64_t compress_ns = 0, uncompress_ns = 0;
+	struct net_pkt *pkt;
+	int64_t start;
+	int saved = 0;
+	int ret;
+	int i;
+
+	for (i = 0; i < ITERATIONS; i++) {
+		pkt = create_pkt(src, dst);
+
+		start = k_uptime_ticks();
+		ret = net_6lo_compress(pkt, true);
+		compress_ns += k_ticks_to_ns_floor64(k_uptime_ticks() - start);
+
+		zassert_true(ret >= 0, "Cannot compress (%d)", ret);
+		saved = NET_IPV6UDPH_LEN + PAYLOAD_LEN - net_pkt_get_len(pkt);
+
+		start = k_uptime_ticks();
+		zassert_true(net_6lo_uncompress(pkt), "Cannot uncompress");
+		uncompress_ns += k_ticks_to_ns_floor64(k_uptime_ticks() - start);
+
+		zassert_equal(net_pkt_get_len(pkt), NET_IPV6UDPH_LEN + PAYLOAD_LEN,
+			      "Wrong uncompressed length");
+
+		net_pkt_unref(pkt);
+	}
+
+	printk("%-12s %2d bytes saved, compress %5u ns, uncompress %5u ns\n", name,
+	       saved, (uint32_t)(compress_ns / ITERATIONS),
+	       (uint32_t)(uncompress_ns / ITERATIONS));
+}
+
+ZTEST(iphc, test_link_local)
+{
+	struct in6_addr src, dst;
+
+	ll_addr(&src, src_mac);
+	ll_addr(&dst, dst_mac);
+
+	measure("link-local", &src, &dst);
+}
+
+ZTEST(iphc, test_context)
+{
+	struct in6_addr src, dst;
+
+	ll_addr(&src, src_mac);
+	ll_addr(&dst, dst_mac);
+
+	memcpy(&src, ctx.prefix, 8);
+	memcpy(&dst, ctx.prefix, 8);
+
+	measure("context", &src, &dst);
+}
+
+ZTEST(iphc, test_multicast)
+{
+	struct in6_addr src, dst;
+
+	ll_addr(&src, src_mac);
+	net_ipv6_addr_create_ll_allnodes_mcast(&dst);
+
+	measure("multicast", &src, &dst);
+}
+
+static void *iphc_setup(void)
+{
+	iface = net_if_get_first_by_type(&NET_L2_GET_NAME(DUMMY));
+	zassert_not_null(iface, "No interface");
+
+	net_6lo_set_context(iface, &ctx);
+
+	return NULL;
+}
+
+ZTEST_SUITE(iphc, NULL, iphc_setup, NULL, NULL, NULL);
@@ -0,0 +1,166 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Compares the linear resource dispatch of coap_handle_request() with
+ * the resource trie, on a tree of NUM_RESOURCES resources with paths
+ * of the form "dev/<group>/<item>".
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <zephyr/net/coap.h>
+
+#define NUM_GROUPS 100
+#define NUM_ITEMS 100
+#define NUM_RESOURCES (NUM_GROUPS * NUM_ITEMS)
+#define NUM_REQUESTS 64
+
+#define COAP_BUF_SIZE 64
+#define MAX_OPTIONS 4
+
+/* "dev", the groups and the items */
+#define NUM_SEGMENTS (1 + NUM_GROUPS + NUM_RESOURCES)
+
+static char names[MAX(NUM_GROUPS, NUM_ITEMS)][4];
+static const char *paths[NUM_RESOURCES][4];
+static struct coap_resource resources[NUM_RESOURCES + 1];
+static struct coap_resource_trie_node nodes[COAP_RESOURCE_TRIE_NODES(NUM_SEGMENTS)];
+static struct coap_resource_trie trie;
+
+static struct coap_resource *dispatched;
+
+static struct sockaddr_in6 dummy_addr = {
+	.sin6_family = AF_INET6,
+};
+
+struct request {
+	uint8_t data[COAP_BUF_SIZE];
+	struct coap_packet cpkt;
+	struct coap_option options[MAX_OPTIONS];
+};
+
+static struct request requests[NUM_REQUESTS];
+
+static int resource_get(struct coap_resource *resource,
+			struct coap_packet *request,
+			struct sockaddr *addr, socklen_t addr_len)
+{
+	dispatched = resource;
+
+	return 0;
+}
+
+static void build_request(struct request *req, int index)
+{
+	const char * const *path;
+	int r;
+
+	r = coap_packet_init(&req->cpkt, req->data, sizeof(req->data),
+			     COAP_VERSION_1, COAP_TYPE_CON, 0, NULL,
+			     COAP_METHOD_GET, coap_next_id());
+	zassert_equal(r, 0, "Unable to init request");
+
+	for (path = paths[index]; *path; path++) {
+		r = coap_packet_append_option(&req->cpkt, COAP_OPTION_URI_PATH,
+					      *path, strlen(*path));
+		zassert_equal(r, 0, "Unable to append option");
+	}
+
+	r = coap_packet_parse(&req->cpkt, req->data, req->cpkt.offset,
+			      req->options, MAX_OPTIONS);
+	zassert_equal(r, 0, "Unable to parse request");
+}
+
+static uint32_t dispatch(struct request *req, bool use_trie)
+{
+	uint32_t start, cycles;
+	int r;
+
+	start = k_cycle_get_32();
+
+	if (use_trie) {
+		r = coap_handle_request_trie(&req->cpkt, &trie, req->options,
+					     MAX_OPTIONS,
+					     (struct sockaddr *)&dummy_addr,
+					     sizeof(dummy_addr));
+	} else {
+		r = coap_handle_request(&req->cpkt, resources, req->options,
+					MAX_OPTIONS,
+					(struct sockaddr *)&dummy_addr,
+					sizeof(dummy_addr));
+	}
+
+	cycles = k_cycle_get_32() - start;
+
+	zassert_equal(r, 0, "Request not dispatched (%d)", r);
+
+	return cycles;
+}
+
+ZTEST(coap_dispatch, test_dispatch)
+{
+	uint64_t linear = 0, trie_cycles = 0;
+	uint32_t start, build;
+	int i, r;
+
+	start = k_cycle_get_32();
+	r = coap_resource_trie_init(&trie, resources, nodes, ARRAY_SIZE(nodes));
+	build = k_cycle_get_32() - start;
+
+	zassert_equal(r, 0, "Could not build the trie (%d)", r);
+	zassert_equal(trie.num_nodes, NUM_SEGMENTS, "Wrong number of nodes");
+
+	/* Spread the requests over the whole tree, the last resource is
+	 * the worst case of the linear search.
+	 */
+	for (i = 0; i < NUM_REQUESTS; i++) {
+		int index = NUM_RESOURCES - 1 - i * (NUM_RESOURCES / NUM_REQUESTS);
+		struct coap_resource *expected = &resources[index];
+
+		build_request(&requests[i], index);
+
+		dispatched = NULL;
+		linear += dispatch(&requests[i], false);
+		zassert_equal_ptr(dispatched, expected, "Wrong linear dispatch");
+
+		dispatched = NULL;
+		trie_cycles += dispatch(&requests[i], true);
+		zassert_equal_ptr(dispatched, expected, "Wrong trie dispatch");
+	}
+
+	printk("%d resources, trie built in %u cycles\n", NUM_RESOURCES, build);
+	printk("linear dispatch: %llu cycles per request\n",
+	       (unsigned long long)(linear / NUM_REQUESTS));
+	printk("trie dispatch: %llu cycles per request\n",
+	       (unsigned long long)(trie_cycles / NUM_REQUESTS));
+
+	zassert_true(trie_cycles < linear, "Trie dispatch is not faster");
+}
+
+static void *coap_dispatch_setup(void)
+{
+	int group, item, i;
+
+	for (i = 0; i < MAX(NUM_GROUPS, NUM_ITEMS); i++) {
+		snprintk(names[i], sizeof(names[i]), "%d", i);
+	}
+
+	for (group = 0; group < NUM_GROUPS; group++) {
+		for (item = 0; item < NUM_ITEMS; item++) {
+			int index = group * NUM_ITEMS + item;
+
+			paths[index][0] = "dev";
+			paths[index][1] = names[group];
+			paths[index][2] = names[item];
+			paths[index][3] = NULL;
+
+			resources[index].path = paths[index];
+			resources[index].get = resource_get;
+		}
+	}
+
+	return NULL;
+}
+
+ZTEST_SUITE(coap_dispatch, NULL, coap_dispatch_setup, NULL, NULL, NULL);
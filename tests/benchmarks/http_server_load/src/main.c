@@ -0,0 +1,297 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Measures the number of requests per second the HTTP server answers to
+ * NUM_CLIENTS concurrent clients over the loopback interface, with
+ * persistent connections, with pipelined requests, and with a new
+ * connection for every request.
+ */
+
+#include <string.h>
+#include <errno.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <zephyr/net/socket.h>
+#include <zephyr/net/http/server.h>
+#include <zephyr/net/http/service.h>
+
+#define NUM_CLIENTS CONFIG_HTTP_SERVER_MAX_CLIENTS
+#define REQUESTS_PER_CLIENT 200
+#define PIPELINE_DEPTH 4
+
+#define CLIENT_STACK_SIZE 1024
+#define CLIENT_PRIORITY K_PRIO_PREEMPT(8)
+
+static uint16_t load_port;
+HTTP_SERVICE_DEFINE(load_service, "127.0.0.1", &load_port, NUM_CLIENTS,
+		    NUM_CLIENTS, NULL);
+
+static const char index_html[] = "<html><body>Zephyr</body></html>";
+
+static struct http_resource_detail_static index_detail = {
+	.common = {
+		.bitmask_of_supported_http_methods = BIT(HTTP_GET),
+		.type = HTTP_RESOURCE_TYPE_STATIC,
+		.content_type = "text/html",
+	},
+	.static_data = index_html,
+	.static_data_len = sizeof(index_html) - 1,
+};
+
+HTTP_RESOURCE_DEFINE(index_resource, load_service, "/", &index_detail);
+
+#define REQUEST "GET / HTTP/1.1\r\n\r\n"
+#define CLOSE_REQUEST "GET / HTTP/1.1\r\nConnection: close\r\n\r\n"
+
+#define RESPONSE_HEADER_LEN                                                    \
+	(sizeof("HTTP/1.1 200 OK\r\n"                                          \
+		"Content-Type: text/html\r\n"                                  \
+		"Content-Length: 32\r\n"                                       \
+		"\r\n") - 1)
+#define RESPONSE_LEN (RESPONSE_HEADER_LEN + sizeof(index_html) - 1)
+#define CLOSE_RESPONSE_LEN (RESPONSE_LEN + sizeof("Connection: close\r\n") - 1)
+
+BUILD_ASSERT(sizeof(index_html) - 1 == 32);
+
+enum load_mode {
+	LOAD_KEEP_ALIVE,
+	LOAD_PIPELINED,
+	LOAD_NEW_CONNECTION,
+};
+
+struct load_client {
+	struct k_thread thread;
+	enum load_mode mode;
+	int answered;
+	int error;
+	char buf[CLOSE_RESPONSE_LEN * PIPELINE_DEPTH];
+};
+
+static struct load_client load_clients[NUM_CLIENTS];
+static K_THREAD_STACK_ARRAY_DEFINE(client_stacks, NUM_CLIENTS,
+				   CLIENT_STACK_SIZE);
+
+static int client_connect(void)
+{
+	struct sockaddr addr;
+	struct sockaddr_in *addr4 = (struct sockaddr_in *)&addr;
+	int fd;
+
+	memset(&addr, 0, sizeof(addr));
+	addr4->sin_family = AF_INET;
+	addr4->sin_port = htons(load_port);
+	zsock_inet_pton(AF_INET, "127.0.0.1", &addr4->sin_addr);
+
+	fd = zsock_socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	if (fd < 0) {
+		return -errno;
+	}
+
+	if (zsock_connect(fd, &addr, sizeof(struct sockaddr_in)) < 0) {
+		zsock_close(fd);
+		return -errno;
+	}
+
+	return fd;
+}
+
+static int send_all(int fd, const char *buf, size_t len)
+{
+	ssize_t ret;
+
+	while (len > 0) {
+		ret = zsock_send(fd, buf, len, 0);
+		if (ret < 0) {
+			return -errno;
+		}
+
+		buf += ret;
+		len -= ret;
+	}
+
+	return 0;
+}
+
+static int recv_all(int fd, char *buf, size_t len)
+{
+	ssize_t ret;
+
+	while (len > 0) {
+		ret = zsock_recv(fd, buf, len, 0);
+		if (ret <= 0) {
+			return ret < 0 ? -errno : -ECONNRESET;
+		}
+
+		buf += ret;
+		len -= ret;
+	}
+
+	return 0;
+}
+
+/* Send @p count requests at once on a persistent connection and receive
+ * their responses.
+ */
+static int exchange(struct load_client *client, int fd, int count)
+{
+	static const char requests[] = REQUEST REQUEST REQUEST REQUEST;
+	int ret;
+
+	BUILD_ASSERT(sizeof(requests) - 1 ==
+		     (sizeof(REQUEST) - 1) * PIPELINE_DEPTH);
+
+	ret = send_all(fd, requests, (sizeof(REQUEST) - 1) * count);
+	if (ret < 0) {
+		return ret;
+	}
+
+	ret = recv_all(fd, client->buf, RESPONSE_LEN * count);
+	if (ret < 0) {
+		return ret;
+	}
+
+	client->answered += count;
+
+	return 0;
+}
+
+static int run_persistent(struct load_client *client, int depth)
+{
+	int fd;
+	int ret = 0;
+	int i;
+
+	fd = client_connect();
+	if (fd < 0) {
+		return fd;
+	}
+
+	for (i = 0; i < REQUESTS_PER_CLIENT && ret == 0; i += depth) {
+		ret = exchange(client, fd, MIN(depth, REQUESTS_PER_CLIENT - i));
+	}
+
+	zsock_close(fd);
+
+	return ret;
+}
+
+static int run_new_connection(struct load_client *client)
+{
+	int ret;
+	int fd;
+	int i;
+
+	for (i = 0; i < REQUESTS_PER_CLIENT; i++) {
+		fd = client_connect();
+		if (fd < 0) {
+			return fd;
+		}
+
+		ret = send_all(fd, CLOSE_REQUEST, sizeof(CLOSE_REQUEST) - 1);
+		if (ret == 0) {
+			ret = recv_all(fd, client->buf, CLOSE_RESPONSE_LEN);
+		}
+
+		zsock_close(fd);
+
+		if (ret < 0) {
+			return ret;
+		}
+
+		client->answered++;
+	}
+
+	return 0;
+}
+
+static void load_client_run(void *p1, void *p2, void *p3)
+{
+	struct load_client *client = p1;
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	switch (client->mode) {
+	case LOAD_KEEP_ALIVE:
+		client->error = run_persistent(client, 1);
+		break;
+	case LOAD_PIPELINED:
+		client->error = run_persistent(client, PIPELINE_DEPTH);
+		break;
+	case LOAD_NEW_CONNECTION:
+		client->error = run_new_connection(client);
+		break;
+	}
+}
+
+static void run_load(enum load_mode mode, const char *name)
+{
+	int64_t start, elapsed;
+	int answered = 0;
+	int i;
+
+	start = k_uptime_get();
+
+	for (i = 0; i < NUM_CLIENTS; i++) {
+		load_clients[i].mode = mode;
+		load_clients[i].answered = 0;
+		load_clients[i].error = 0;
+
+		k_thread_create(&load_clients[i].thread, client_stacks[i],
+				K_THREAD_STACK_SIZEOF(client_stacks[i]),
+				load_client_run, &load_clients[i], NULL, NULL,
+				CLIENT_PRIORITY, 0, K_NO_WAIT);
+	}
+
+	for (i = 0; i < NUM_CLIENTS; i++) {
+		k_thread_join(&load_clients[i].thread, K_FOREVER);
+
+		zassert_equal(load_clients[i].error, 0, "Client %d failed (%d)",
+			      i, load_clients[i].error);
+
+		answered += load_clients[i].answered;
+	}
+
+	elapsed = MAX(k_uptime_get() - start, 1);
+
+	zassert_equal(answered, NUM_CLIENTS * REQUESTS_PER_CLIENT,
+		      "Requests lost");
+
+	printk("%s: %d clients, %d requests in %u ms, %u requests/s\n", name,
+	       NUM_CLIENTS, answered, (uint32_t)elapsed,
+	       (uint32_t)(answered * MSEC_PER_SEC / elapsed));
+}
+
+ZTEST(http_server_load, test_keep_alive)
+{
+	run_load(LOAD_KEEP_ALIVE, "keep-alive");
+}
+
+ZTEST(http_server_load, test_pipelined)
+{
+	run_load(LOAD_PIPELINED, "pipelined");
+}
+
+ZTEST(http_server_load, test_new_connection)
+{
+	run_load(LOAD_NEW_CONNECTION, "connection per request");
+}
+
+static void *http_server_load_setup(void)
+{
+	zassert_equal(http_server_start(), 0, "Cannot start the server");
+
+	return NULL;
+}
+
+static void http_server_load_teardown(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	zassert_equal(http_server_stop(), 0, "Cannot stop the server");
+}
+
+ZTEST_SUITE(http_server_load, NULL, http_server_load_setup, NULL, NULL,
+	    http_server_load_teardown);
@@ -0,0 +1,163 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Measures how late the LwM2M engine generates the notifications of 1000
+ * observations, each with a one second period and with the due times spread
+ * over the period. The socket layer and the message generation are stubbed,
+ * so only the scheduling of the engine is measured. Also measures how many
+ * due notifications the engine postpones while each notification keeps the
+ * context busy till it is sent.
+ */
+
+#include <string.h>
+
+#include <zephyr/fff.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/ztest.h>
+
+#include "lwm2m_engine.h"
+#include "lwm2m_rd_client.h"
+
+#include "stubs.h"
+
+LOG_MODULE_REGISTER(lwm2m_engine_test);
+
+DEFINE_FFF_GLOBALS;
+
+#define OBSERVATIONS CONFIG_LWM2M_ENGINE_MAX_OBSERVER
+#define PERIOD_MS 1000
+#define PERIODS 3
+
+/* Generous bound, the engine should only be late by its own processing time */
+#define MAX_LATENCY_MS 100
+
+static struct lwm2m_ctx ctx;
+static struct observe_node observations[OBSERVATIONS];
+static struct lwm2m_message notify_msg;
+
+static int64_t next_event_custom_fake(struct observe_node *obs, uint16_t srv_obj_inst,
+				      const int64_t timestamp)
+{
+	return obs->event_timestamp + PERIOD_MS;
+}
+
+/* Queue the notification like the engine does, the context stays busy till
+ * the socket loop sends it.
+ */
+static int generate_notify_message_busy_fake(struct lwm2m_ctx *client_ctx,
+					     struct observe_node *obs, void *user_data)
+{
+	notify_msg.ctx = client_ctx;
+	notify_msg.type = COAP_TYPE_NON_CON;
+	sys_slist_append(&client_ctx->pending_sends, &notify_msg.node);
+	set_socket_events(ZSOCK_POLLOUT);
+
+	return 0;
+}
+
+/* Schedule the first notification of each observation at @p start, plus
+ * a share of @p spread_ms.
+ */
+static void observations_start(int64_t start, int64_t spread_ms)
+{
+	int ret;
+	int i;
+
+	(void)memset(&ctx, 0x0, sizeof(ctx));
+	ctx.sock_fd = -1;
+	ctx.remote_addr.sa_family = AF_INET;
+	sys_slist_init(&ctx.observer);
+	sys_slist_init(&ctx.pending_sends);
+
+	for (i = 0; i < OBSERVATIONS; i++) {
+		struct observe_node *obs = &observations[i];
+
+		(void)memset(obs, 0x0, sizeof(*obs));
+		obs->ctx = &ctx;
+		obs->last_timestamp = k_uptime_get();
+
+		sys_slist_append(&ctx.observer, &obs->node);
+		lwm2m_engine_observe_schedule(obs, start + i * spread_ms / OBSERVATIONS);
+	}
+
+	lwm2m_engine_reset_notification_stats();
+
+	ret = lwm2m_engine_start(&ctx);
+	zassert_equal(ret, 0);
+}
+
+static void observations_stop(struct lwm2m_notification_stats *stats)
+{
+	int ret;
+	int i;
+
+	ret = lwm2m_engine_stop(&ctx);
+	zassert_equal(ret, 0);
+
+	zassert_equal(lwm2m_engine_get_notification_stats(stats), 0);
+
+	for (i = 0; i < OBSERVATIONS; i++) {
+		lwm2m_engine_observe_schedule(&observations[i], 0);
+	}
+}
+
+ZTEST(lwm2m_observe, test_notifications)
+{
+	struct lwm2m_notification_stats stats;
+
+	observations_start(k_uptime_get() + PERIOD_MS, PERIOD_MS);
+
+	k_sleep(K_MSEC(PERIOD_MS * (PERIODS + 1)));
+
+	observations_stop(&stats);
+
+	zassert_true(stats.notifications >= OBSERVATIONS * PERIODS, "Notifications lost (%u)",
+		     stats.notifications);
+	zassert_equal(stats.scheduled, OBSERVATIONS, "Observations not rescheduled");
+
+	printk("%u observations: %u notifications, latency avg %u ms, max %u ms\n",
+	       OBSERVATIONS, stats.notifications,
+	       (uint32_t)(stats.total_latency_ms / stats.notifications), stats.max_latency_ms);
+
+	zassert_true(stats.max_latency_ms <= MAX_LATENCY_MS, "Notifications late (%u ms)",
+		     stats.max_latency_ms);
+}
+
+ZTEST(lwm2m_observe, test_notifications_busy)
+{
+	struct lwm2m_notification_stats stats;
+
+	generate_notify_message_fake.custom_fake = generate_notify_message_busy_fake;
+
+	/* All the notifications are due at once, the context only sends
+	 * one of them at a time.
+	 */
+	observations_start(k_uptime_get(), 0);
+
+	k_sleep(K_MSEC(PERIOD_MS));
+
+	observations_stop(&stats);
+
+	zassert_true(stats.notifications > 0, "No notification");
+	zassert_equal(stats.scheduled, OBSERVATIONS, "Observations not rescheduled");
+
+	printk("%u observations, busy context: %u notifications, %u postponed\n",
+	       OBSERVATIONS, stats.notifications, stats.deferred);
+
+	/* The observations of a busy context are left in the heap */
+	zassert_equal(stats.deferred, 0, "Observations of a busy context popped (%u)",
+		      stats.deferred);
+}
+
+static void setup(void *data)
+{
+	DO_FOREACH_FAKE(RESET_FAKE);
+	FFF_RESET_HISTORY();
+
+	clear_socket_events();
+	lwm2m_rd_client_is_registred_fake.return_val = true;
+	engine_observe_shedule_next_event_fake.custom_fake = next_event_custom_fake;
+}
+
+ZTEST_SUITE(lwm2m_observe, NULL, NULL, setup, NULL, NULL);
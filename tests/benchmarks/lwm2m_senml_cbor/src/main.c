@@ -0,0 +1,161 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Measures the time the SenML CBOR writer needs to encode an object instance
+ * with RESOURCES resources, read as a whole and as a composite read of every
+ * resource, and the size of the resulting payload.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+
+#include "lwm2m_util.h"
+#include "lwm2m_rw_senml_cbor.h"
+#include "lwm2m_engine.h"
+
+#define TEST_OBJ_ID 0xFFFF
+#define TEST_OBJ_INST_ID 0
+
+#define RESOURCES 16
+#define ENCODES 1000
+
+BUILD_ASSERT(RESOURCES <= CONFIG_LWM2M_COMPOSITE_PATH_LIST_SIZE);
+
+static struct lwm2m_engine_obj test_obj;
+static struct lwm2m_engine_obj_field test_fields[RESOURCES];
+static struct lwm2m_engine_obj_inst test_inst;
+static struct lwm2m_engine_res test_res[RESOURCES];
+static struct lwm2m_engine_res_inst test_res_inst[RESOURCES];
+
+/* Half of the resources are integers, the other half floats */
+static int32_t test_s32[RESOURCES / 2];
+static double test_float[RESOURCES / 2];
+
+static struct lwm2m_message test_msg;
+
+static struct lwm2m_engine_obj_inst *test_obj_create(uint16_t obj_inst_id)
+{
+	int i = 0, j = 0;
+	int res;
+
+	init_res_instance(test_res_inst, ARRAY_SIZE(test_res_inst));
+
+	for (res = 0; res < RESOURCES / 2; res++) {
+		INIT_OBJ_RES_DATA(res, test_res, i, test_res_inst, j,
+				  &test_s32[res], sizeof(test_s32[res]));
+	}
+
+	for (res = 0; res < RESOURCES / 2; res++) {
+		INIT_OBJ_RES_DATA(RESOURCES / 2 + res, test_res, i, test_res_inst, j,
+				  &test_float[res], sizeof(test_float[res]));
+	}
+
+	test_inst.resources = test_res;
+	test_inst.resource_count = i;
+
+	return &test_inst;
+}
+
+static void context_reset(struct lwm2m_obj_path *path)
+{
+	memset(&test_msg, 0, sizeof(test_msg));
+
+	test_msg.out.writer = &senml_cbor_writer;
+	test_msg.out.out_cpkt = &test_msg.cpkt;
+	test_msg.path = *path;
+
+	test_msg.cpkt.data = test_msg.msg_data;
+	test_msg.cpkt.max_len = sizeof(test_msg.msg_data);
+}
+
+static void report(const char *name, uint64_t elapsed_us, size_t len)
+{
+	printk("%s: %d records, %u bytes, %u us per encode\n", name, RESOURCES, (uint32_t)len,
+	       (uint32_t)(elapsed_us / ENCODES));
+}
+
+ZTEST(lwm2m_senml_cbor, test_read_object_instance)
+{
+	struct lwm2m_obj_path path = LWM2M_OBJ(TEST_OBJ_ID, TEST_OBJ_INST_ID);
+	uint64_t elapsed_us = 0;
+	int64_t start;
+	int ret;
+	int i;
+
+	for (i = 0; i < ENCODES; i++) {
+		context_reset(&path);
+
+		start = k_uptime_ticks();
+		ret = do_read_op_senml_cbor(&test_msg);
+		elapsed_us += k_ticks_to_us_floor64(k_uptime_ticks() - start);
+
+		zassert_true(ret >= 0, "Cannot encode (%d)", ret);
+	}
+
+	report("object instance read", elapsed_us, test_msg.cpkt.offset);
+}
+
+ZTEST(lwm2m_senml_cbor, test_composite_read)
+{
+	struct lwm2m_obj_path_list path_list_buf[RESOURCES];
+	struct lwm2m_obj_path path;
+	sys_slist_t path_list;
+	sys_slist_t path_free_list;
+	uint64_t elapsed_us = 0;
+	int64_t start;
+	int ret;
+	int i;
+
+	lwm2m_engine_path_list_init(&path_list, &path_free_list, path_list_buf,
+				    ARRAY_SIZE(path_list_buf));
+
+	for (i = 0; i < RESOURCES; i++) {
+		path = LWM2M_OBJ(TEST_OBJ_ID, TEST_OBJ_INST_ID, i);
+		zassert_equal(lwm2m_engine_add_path_to_list(&path_list, &path_free_list, &path),
+			      0, "Cannot add path");
+	}
+
+	for (i = 0; i < ENCODES; i++) {
+		context_reset(&path);
+
+		start = k_uptime_ticks();
+		ret = do_composite_read_op_for_parsed_path_senml_cbor(&test_msg, &path_list);
+		elapsed_us += k_ticks_to_us_floor64(k_uptime_ticks() - start);
+
+		zassert_true(ret >= 0, "Cannot encode (%d)", ret);
+	}
+
+	report("composite read", elapsed_us, test_msg.cpkt.offset);
+}
+
+static void *lwm2m_senml_cbor_setup(void)
+{
+	struct lwm2m_engine_obj_inst *obj_inst = NULL;
+	int i;
+
+	for (i = 0; i < RESOURCES / 2; i++) {
+		test_fields[i] = (struct lwm2m_engine_obj_field)OBJ_FIELD_DATA(i, R, S32);
+		test_fields[RESOURCES / 2 + i] = (struct lwm2m_engine_obj_field)
+			OBJ_FIELD_DATA(RESOURCES / 2 + i, R, FLOAT);
+
+		test_s32[i] = i * 1000;
+		test_float[i] = i + 0.5;
+	}
+
+	test_obj.obj_id = TEST_OBJ_ID;
+	test_obj.version_major = 1;
+	test_obj.version_minor = 0;
+	test_obj.is_core = false;
+	test_obj.fields = test_fields;
+	test_obj.field_count = ARRAY_SIZE(test_fields);
+	test_obj.max_instance_count = 1U;
+	test_obj.create_cb = test_obj_create;
+
+	(void)lwm2m_register_obj(&test_obj);
+	(void)lwm2m_create_obj_inst(TEST_OBJ_ID, TEST_OBJ_INST_ID, &obj_inst);
+
+	return NULL;
+}
+
+ZTEST_SUITE(lwm2m_senml_cbor, NULL, lwm2m_senml_cbor_setup, NULL, NULL, NULL);
@@ -0,0 +1,66 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Measures the number of cycles needed to calculate the Internet checksum
+ * of 64 to 9000 bytes with calc_chksum(), to copy the data with memcpy()
+ * and then calculate its checksum, and to do both in one pass with
+ * calc_chksum_copy().
+ */
+
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+
+#include "net_private.h"
+
+#define MAX_LENGTH 9000
+#define ROUNDS 100
+
+static uint8_t src[MAX_LENGTH];
+static uint8_t dst[MAX_LENGTH];
+
+ZTEST(net_checksum, test_checksum)
+{
+	static const size_t lengths[] = { 64, 256, 1500, 9000 };
+	volatile uint16_t sum = 0U;
+	uint32_t start, chksum, copy_chksum, fused;
+
+	for (int i = 0; i < MAX_LENGTH; i++) {
+		src[i] = (uint8_t)i * 13;
+	}
+
+	for (int i = 0; i < ARRAY_SIZE(lengths); i++) {
+		size_t len = lengths[i];
+
+		start = k_cycle_get_32();
+		for (int j = 0; j < ROUNDS; j++) {
+			sum = calc_chksum(sum, src, len);
+		}
+		chksum = k_cycle_get_32() - start;
+
+		start = k_cycle_get_32();
+		for (int j = 0; j < ROUNDS; j++) {
+			memcpy(dst, src, len);
+			sum = calc_chksum(sum, dst, len);
+		}
+		copy_chksum = k_cycle_get_32() - start;
+
+		start = k_cycle_get_32();
+		for (int j = 0; j < ROUNDS; j++) {
+			sum = calc_chksum_copy(sum, dst, src, len);
+		}
+		fused = k_cycle_get_32() - start;
+
+		zassert_equal(calc_chksum(0U, src, len),
+			      calc_chksum_copy(0U, dst, src, len),
+			      "Checksum mismatch for length %zu", len);
+
+		printk("%5zu bytes: chksum %u, memcpy + chksum %u, "
+		       "copy_chksum %u cycles\n", len, chksum / ROUNDS,
+		       copy_chksum / ROUNDS, fused / ROUNDS);
+	}
+}
+
+ZTEST_SUITE(net_checksum, NULL, NULL, NULL, NULL, NULL);
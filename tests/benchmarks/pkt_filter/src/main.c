@@ -0,0 +1,168 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Measures the per-packet cost of the send filter with EXACT_RULES UDP
+ * 5-tuple rules followed by PREFIX_RULES source prefix and destination port
+ * range rules, when the rule list is walked, compiled to instructions only,
+ * and compiled with the 5-tuple rules in a hash table.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <zephyr/net/net_ip.h>
+#include <zephyr/net/net_pkt.h>
+#include <zephyr/net/net_pkt_filter.h>
+
+#define EXACT_RULES 128
+#define PREFIX_RULES 32
+#define EVALUATIONS 10000
+
+#define SRC_PORT 40000
+#define EXACT_PORT 1000
+#define RANGE_PORT 5000
+#define RANGE_LEN 10
+
+static struct in_addr src_addr[] = { { { { 192, 0, 2, 1 } } } };
+static struct in_addr dst_addr[] = { { { { 192, 0, 2, 2 } } } };
+
+static NPF_IP_PROTO_MATCH(match_udp, IPPROTO_UDP);
+static NPF_IPV4_SRC_ADDR_MATCH(match_src_addr, src_addr);
+static NPF_IPV4_DST_ADDR_MATCH(match_dst_addr, dst_addr);
+static NPF_SRC_PORT_MATCH(match_src_port, SRC_PORT);
+
+#define EXACT_RULE(i, _)							\
+	static NPF_DST_PORT_MATCH(match_dst_port_##i, EXACT_PORT + i);		\
+	static NPF_RULE(exact_rule_##i, NET_OK, match_udp, match_src_addr,	\
+			match_dst_addr, match_src_port, match_dst_port_##i)
+
+#define PREFIX_RULE(i, _)							\
+	static struct in_addr prefix_##i[] = { { { { 10, i, 0, 0 } } } };	\
+	static NPF_IPV4_SRC_PREFIX_MATCH(match_prefix_##i, prefix_##i, 16);	\
+	static NPF_DST_PORT_RANGE(match_range_##i, RANGE_PORT + i * RANGE_LEN,	\
+				  RANGE_PORT + i * RANGE_LEN + RANGE_LEN - 1);	\
+	static NPF_RULE(prefix_rule_##i, NET_OK, match_prefix_##i, match_range_##i)
+
+LISTIFY(EXACT_RULES, EXACT_RULE, (;));
+LISTIFY(PREFIX_RULES, PREFIX_RULE, (;));
+
+#define RULE_PTR(i, name) &name##_##i
+
+static struct npf_rule *rules[] = {
+	LISTIFY(EXACT_RULES, RULE_PTR, (,), exact_rule),
+	LISTIFY(PREFIX_RULES, RULE_PTR, (,), prefix_rule),
+	&npf_default_drop,
+};
+
+/* Every rule compiled to instructions, or only the non 5-tuple ones */
+NPF_PROGRAM_DEFINE(insn_program, EXACT_RULES * 6 + PREFIX_RULES * 3 + 1, 0);
+NPF_PROGRAM_DEFINE(hash_program, PREFIX_RULES * 3 + 1, 256);
+
+static struct net_pkt *build_udp_pkt(const uint8_t *src, uint16_t dst_port)
+{
+	struct net_ipv4_hdr hdr = {
+		.vhl = 0x45,
+		.ttl = 64,
+		.proto = IPPROTO_UDP,
+	};
+	uint16_t ports[2] = { htons(SRC_PORT), htons(dst_port) };
+	struct net_pkt *pkt;
+
+	memcpy(hdr.src, src, sizeof(hdr.src));
+	memcpy(hdr.dst, dst_addr, sizeof(hdr.dst));
+
+	pkt = net_pkt_alloc_with_buffer(NULL, sizeof(hdr) + sizeof(ports), AF_INET,
+					IPPROTO_UDP, K_NO_WAIT);
+	zassert_not_null(pkt, "Cannot allocate pkt");
+
+	zassert_equal(net_pkt_write(pkt, &hdr, sizeof(hdr)), 0, "");
+	zassert_equal(net_pkt_write(pkt, ports, sizeof(ports)), 0, "");
+
+	return pkt;
+}
+
+static void measure(const char *name, struct net_pkt *pkt, bool expected)
+{
+	uint64_t elapsed_ns;
+	int64_t start;
+	int errors = 0;
+	int i;
+
+	start = k_uptime_ticks();
+
+	for (i = 0; i < EVALUATIONS; i++) {
+		if (net_pkt_filter_send_ok(pkt) != expected) {
+			errors++;
+		}
+	}
+
+	elapsed_ns = k_ticks_to_ns_floor64(k_uptime_ticks() - start);
+
+	zassert_equal(errors, 0, "%s: wrong verdict", name);
+
+	printk("  %-20s %6u ns per packet\n", name, (uint32_t)(elapsed_ns / EVALUATIONS));
+}
+
+static void measure_all(const char *mode)
+{
+	static const uint8_t prefix_src[] = { 10, PREFIX_RULES - 1, 1, 1 };
+	struct net_pkt *first_exact, *last_exact, *last_prefix, *no_match;
+
+	first_exact = build_udp_pkt((const uint8_t *)src_addr, EXACT_PORT);
+	last_exact = build_udp_pkt((const uint8_t *)src_addr, EXACT_PORT + EXACT_RULES - 1);
+	last_prefix = build_udp_pkt(prefix_src, RANGE_PORT + PREFIX_RULES * RANGE_LEN - 1);
+	no_match = build_udp_pkt((const uint8_t *)src_addr, 1);
+
+	printk("%s, %zu rules:\n", mode, ARRAY_SIZE(rules));
+
+	measure("first 5-tuple rule", first_exact, true);
+	measure("last 5-tuple rule", last_exact, true);
+	measure("last prefix rule", last_prefix, true);
+	measure("no match", no_match, false);
+
+	net_pkt_unref(first_exact);
+	net_pkt_unref(last_exact);
+	net_pkt_unref(last_prefix);
+	net_pkt_unref(no_match);
+}
+
+ZTEST(pkt_filter, test_rule_list)
+{
+	measure_all("rule list");
+}
+
+ZTEST(pkt_filter, test_compiled_insns)
+{
+	zassert_equal(npf_compile_rules(&npf_send_rules, &insn_program), 0, "Cannot compile");
+	zassert_equal(insn_program.nb_entries, 0, "Rules hashed");
+
+	measure_all("compiled, instructions only");
+}
+
+ZTEST(pkt_filter, test_compiled_hash)
+{
+	zassert_equal(npf_compile_rules(&npf_send_rules, &hash_program), 0, "Cannot compile");
+	zassert_equal(hash_program.nb_entries, EXACT_RULES, "5-tuple rules not hashed");
+
+	measure_all("compiled, 5-tuple hash");
+}
+
+static void *pkt_filter_setup(void)
+{
+	size_t i;
+
+	for (i = 0; i < ARRAY_SIZE(rules); i++) {
+		npf_append_send_rule(rules[i]);
+	}
+
+	return NULL;
+}
+
+static void pkt_filter_after(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	npf_uncompile_rules(&npf_send_rules);
+}
+
+ZTEST_SUITE(pkt_filter, NULL, pkt_filter_setup, NULL, pkt_filter_after, NULL);
@@ -0,0 +1,207 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Measures the time a TLS client needs to connect to a TLS server over the
+ * loopback interface, with a full handshake and with a handshake resuming
+ * the previous session, either from the server session cache or with a
+ * session ticket depending on the configuration.
+ */
+
+#include <string.h>
+#include <errno.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <zephyr/net/socket.h>
+#include <zephyr/net/tls_credentials.h>
+
+#define HANDSHAKES 20
+
+#define PSK_TAG 1
+
+#define SERVER_STACK_SIZE 4096
+#define SERVER_PRIORITY K_PRIO_PREEMPT(8)
+
+/* ECDHE-PSK, so that full handshakes include the key exchange of the
+ * certificate based ciphersuites, without the certificate verification.
+ */
+#define TLS_ECDHE_PSK_WITH_AES_128_CBC_SHA256 0xC037
+
+static const int ciphersuites[] = { TLS_ECDHE_PSK_WITH_AES_128_CBC_SHA256 };
+
+static const unsigned char psk[] = {
+	0x01, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+	0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f
+};
+static const char psk_id[] = "benchmark_identity";
+
+static const sec_tag_t sec_tags[] = { PSK_TAG };
+
+static int server_fd = -1;
+static struct sockaddr_in server_addr;
+static int server_error;
+
+static struct k_thread server_thread;
+static K_THREAD_STACK_DEFINE(server_stack, SERVER_STACK_SIZE);
+
+/* Accept @p p1 connections, the handshake is done by accept(). */
+static void server_run(void *p1, void *p2, void *p3)
+{
+	int count = POINTER_TO_INT(p1);
+	int fd;
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (count-- > 0) {
+		fd = zsock_accept(server_fd, NULL, NULL);
+		if (fd < 0) {
+			server_error = -errno;
+			return;
+		}
+
+		zsock_close(fd);
+	}
+}
+
+static void tls_setsockopt(int fd, int optname, const void *optval,
+			   socklen_t optlen)
+{
+	zassert_equal(zsock_setsockopt(fd, SOL_TLS, optname, optval, optlen), 0,
+		      "Cannot set TLS option %d (%d)", optname, errno);
+}
+
+/* Connect to the server and return the duration of connect() in us. */
+static uint32_t client_connect(bool resume)
+{
+	int cache = resume ? TLS_SESSION_CACHE_ENABLED :
+			     TLS_SESSION_CACHE_DISABLED;
+	int64_t start;
+	uint32_t elapsed;
+	int fd;
+
+	fd = zsock_socket(AF_INET, SOCK_STREAM, IPPROTO_TLS_1_2);
+	zassert_true(fd >= 0, "Cannot create client socket (%d)", errno);
+
+	tls_setsockopt(fd, TLS_SEC_TAG_LIST, sec_tags, sizeof(sec_tags));
+	tls_setsockopt(fd, TLS_CIPHERSUITE_LIST, ciphersuites,
+		       sizeof(ciphersuites));
+	tls_setsockopt(fd, TLS_SESSION_CACHE, &cache, sizeof(cache));
+
+	start = k_uptime_ticks();
+
+	zassert_equal(zsock_connect(fd, (struct sockaddr *)&server_addr,
+				    sizeof(server_addr)),
+		      0, "Cannot connect (%d)", errno);
+
+	elapsed = k_ticks_to_us_floor32(k_uptime_ticks() - start);
+
+	zsock_close(fd);
+
+	return elapsed;
+}
+
+static void get_stats(struct tls_handshake_stats *stats)
+{
+	socklen_t optlen = sizeof(*stats);
+
+	zassert_equal(zsock_getsockopt(server_fd, SOL_TLS, TLS_HANDSHAKE_STATS,
+				       stats, &optlen),
+		      0, "Cannot read handshake counters (%d)", errno);
+}
+
+static void run_handshakes(bool resume, const char *name)
+{
+	struct tls_handshake_stats before, after;
+	uint64_t total_us = 0;
+	int purge = 0;
+	int i;
+
+	tls_setsockopt(server_fd, TLS_SESSION_CACHE_PURGE, &purge,
+		       sizeof(purge));
+	get_stats(&before);
+
+	server_error = 0;
+	k_thread_create(&server_thread, server_stack,
+			K_THREAD_STACK_SIZEOF(server_stack), server_run,
+			INT_TO_POINTER(HANDSHAKES + 1), NULL, NULL,
+			SERVER_PRIORITY, 0, K_NO_WAIT);
+
+	/* The first connection establishes the session to resume */
+	(void)client_connect(resume);
+
+	for (i = 0; i < HANDSHAKES; i++) {
+		total_us += client_connect(resume);
+	}
+
+	k_thread_join(&server_thread, K_FOREVER);
+	zassert_equal(server_error, 0, "Server failed (%d)", server_error);
+
+	get_stats(&after);
+
+	zassert_equal(after.failed, before.failed, "Handshakes failed");
+	zassert_equal(after.full - before.full, resume ? 1 : HANDSHAKES + 1,
+		      "Wrong number of full handshakes");
+	zassert_equal(after.resumed - before.resumed, resume ? HANDSHAKES : 0,
+		      "Wrong number of resumed handshakes");
+
+	printk("%s: %d handshakes, %u us per handshake\n", name, HANDSHAKES,
+	       (uint32_t)(total_us / HANDSHAKES));
+}
+
+ZTEST(tls_resumption, test_full_handshake)
+{
+	run_handshakes(false, "full handshake");
+}
+
+ZTEST(tls_resumption, test_resumed_handshake)
+{
+	run_handshakes(true, IS_ENABLED(CONFIG_MBEDTLS_SSL_TICKET_C) ?
+			     "resumed handshake (ticket)" :
+			     "resumed handshake (session cache)");
+}
+
+static void *tls_resumption_setup(void)
+{
+	int cache = TLS_SESSION_CACHE_ENABLED;
+	socklen_t addrlen = sizeof(server_addr);
+
+	zassert_equal(tls_credential_add(PSK_TAG, TLS_CREDENTIAL_PSK, psk,
+					 sizeof(psk)),
+		      0, "Cannot register PSK");
+	zassert_equal(tls_credential_add(PSK_TAG, TLS_CREDENTIAL_PSK_ID, psk_id,
+					 strlen(psk_id)),
+		      0, "Cannot register PSK ID");
+
+	server_addr.sin_family = AF_INET;
+	zsock_inet_pton(AF_INET, "127.0.0.1", &server_addr.sin_addr);
+
+	server_fd = zsock_socket(AF_INET, SOCK_STREAM, IPPROTO_TLS_1_2);
+	zassert_true(server_fd >= 0, "Cannot create server socket (%d)", errno);
+
+	tls_setsockopt(server_fd, TLS_SEC_TAG_LIST, sec_tags, sizeof(sec_tags));
+	tls_setsockopt(server_fd, TLS_SESSION_CACHE, &cache, sizeof(cache));
+
+	zassert_equal(zsock_bind(server_fd, (struct sockaddr *)&server_addr,
+				 sizeof(server_addr)),
+		      0, "Cannot bind (%d)", errno);
+	zassert_equal(zsock_getsockname(server_fd,
+					(struct sockaddr *)&server_addr,
+					&addrlen),
+		      0, "Cannot get the server port (%d)", errno);
+	zassert_equal(zsock_listen(server_fd, 1), 0, "Cannot listen (%d)",
+		      errno);
+
+	return NULL;
+}
+
+static void tls_resumption_teardown(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	zsock_close(server_fd);
+}
+
+ZTEST_SUITE(tls_resumption, NULL, tls_resumption_setup, NULL, NULL,
+	    tls_resumption_teardown);
@@ -0,0 +1,404 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Measures the number of JSON telemetry messages per second the Websocket
+ * client sends to a minimal echo server over the loopback interface and
+ * receives back, without compression and with the permessage-deflate
+ * extension, along with the number of bytes sent on the wire.
+ */
+
+#include <string.h>
+#include <errno.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <zephyr/net/socket.h>
+#include <zephyr/net/websocket.h>
+#include <zephyr/sys/base64.h>
+#include <mbedtls/sha1.h>
+
+#define MESSAGES 500
+
+#define TIMEOUT_MS 5000
+
+#define SERVER_STACK_SIZE 2048
+#define SERVER_PRIORITY K_PRIO_PREEMPT(8)
+
+#define WS_MAGIC "258EAFA5-E914-47DA-95CA-C5AB0DC85B11"
+#define WS_KEY_FIELD "Sec-WebSocket-Key: "
+#define WS_OPCODE_CLOSE 0x08
+#define WS_SHA1_LEN 20
+
+/* Echo server stand-in, serving a single connection. */
+static struct server {
+	int fd;
+	struct sockaddr_in addr;
+	/* Accept permessage-deflate if the client offers it */
+	bool deflate;
+	/* Bytes of the messages received from the client, headers included */
+	size_t rx_bytes;
+	/* Messages received with the RSV1 bit set */
+	int compressed;
+	int error;
+	uint8_t buf[1024];
+} server;
+
+static struct k_thread server_thread;
+static K_THREAD_STACK_DEFINE(server_stack, SERVER_STACK_SIZE);
+
+static uint8_t tmp_buf[512];
+static uint8_t msg_buf[512];
+static uint8_t echo_buf[512];
+
+static int send_all(int fd, const void *buf, size_t len)
+{
+	const uint8_t *data = buf;
+	ssize_t ret;
+
+	while (len > 0) {
+		ret = zsock_send(fd, data, len, 0);
+		if (ret < 0) {
+			return -errno;
+		}
+
+		data += ret;
+		len -= ret;
+	}
+
+	return 0;
+}
+
+static int recv_all(int fd, uint8_t *buf, size_t len)
+{
+	ssize_t ret;
+
+	while (len > 0) {
+		ret = zsock_recv(fd, buf, len, 0);
+		if (ret <= 0) {
+			return ret < 0 ? -errno : -ECONNRESET;
+		}
+
+		buf += ret;
+		len -= ret;
+	}
+
+	return 0;
+}
+
+static int server_handshake(int fd)
+{
+	static const char extension[] =
+		"Sec-WebSocket-Extensions: permessage-deflate; "
+		"client_no_context_takeover; server_no_context_takeover\r\n";
+	char *request = (char *)server.buf;
+	uint8_t sha1[WS_SHA1_LEN];
+	char key_magic[64];
+	char accept[32];
+	size_t len = 0;
+	size_t olen;
+	char *key;
+	char *end;
+	ssize_t ret;
+
+	/* The client waits for the response, nothing follows the request */
+	do {
+		ret = zsock_recv(fd, &request[len], sizeof(server.buf) - 1 - len,
+				 0);
+		if (ret <= 0) {
+			return ret < 0 ? -errno : -ECONNRESET;
+		}
+
+		len += ret;
+		request[len] = '\0';
+	} while (strstr(request, "\r\n\r\n") == NULL);
+
+	key = strstr(request, WS_KEY_FIELD);
+	if (key == NULL) {
+		return -EBADMSG;
+	}
+
+	key += sizeof(WS_KEY_FIELD) - 1;
+	end = strstr(key, "\r\n");
+	if (end == NULL || end - key > sizeof(key_magic) - sizeof(WS_MAGIC)) {
+		return -EBADMSG;
+	}
+
+	memcpy(key_magic, key, end - key);
+	memcpy(&key_magic[end - key], WS_MAGIC, sizeof(WS_MAGIC) - 1);
+	mbedtls_sha1((const unsigned char *)key_magic,
+		     end - key + sizeof(WS_MAGIC) - 1, sha1);
+
+	if (base64_encode(accept, sizeof(accept), &olen, sha1,
+			  sizeof(sha1)) != 0) {
+		return -EINVAL;
+	}
+
+	len = snprintk(request, sizeof(server.buf),
+		       "HTTP/1.1 101 Switching Protocols\r\n"
+		       "Upgrade: websocket\r\n"
+		       "Connection: Upgrade\r\n"
+		       "Sec-WebSocket-Accept: %s\r\n"
+		       "%s\r\n",
+		       accept,
+		       server.deflate && strstr(request, "permessage-deflate") ?
+		       extension : "");
+
+	return send_all(fd, request, len);
+}
+
+/* Send the frames back unmasked. The server does not keep a compression
+ * context, so compressed messages can be echoed as they are.
+ */
+static int server_echo(int fd)
+{
+	uint8_t hdr[4];
+	uint8_t mask[4];
+	size_t hdr_len;
+	size_t len;
+	size_t i;
+	int ret;
+
+	while (true) {
+		ret = recv_all(fd, hdr, 2);
+		if (ret < 0) {
+			return ret;
+		}
+
+		hdr_len = 2;
+		len = hdr[1] & 0x7f;
+
+		if (len == 127) {
+			return -EMSGSIZE;
+		}
+
+		if (len == 126) {
+			ret = recv_all(fd, &hdr[2], 2);
+			if (ret < 0) {
+				return ret;
+			}
+
+			len = (hdr[2] << 8) | hdr[3];
+			hdr_len += 2;
+		}
+
+		if (!(hdr[1] & 0x80) || len > sizeof(server.buf)) {
+			return -EBADMSG;
+		}
+
+		ret = recv_all(fd, mask, sizeof(mask));
+		if (ret == 0) {
+			ret = recv_all(fd, server.buf, len);
+		}
+
+		if (ret < 0) {
+			return ret;
+		}
+
+		server.rx_bytes += hdr_len + sizeof(mask) + len;
+
+		if (hdr[0] & 0x40) {
+			server.compressed++;
+		}
+
+		for (i = 0; i < len; i++) {
+			server.buf[i] ^= mask[i % 4];
+		}
+
+		hdr[1] &= ~0x80;
+
+		ret = send_all(fd, hdr, hdr_len);
+		if (ret == 0) {
+			ret = send_all(fd, server.buf, len);
+		}
+
+		if (ret < 0 || (hdr[0] & 0x0f) == WS_OPCODE_CLOSE) {
+			return ret;
+		}
+	}
+}
+
+static void server_run(void *p1, void *p2, void *p3)
+{
+	int fd;
+
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	fd = zsock_accept(server.fd, NULL, NULL);
+	if (fd < 0) {
+		server.error = -errno;
+		return;
+	}
+
+	server.error = server_handshake(fd);
+	if (server.error == 0) {
+		server.error = server_echo(fd);
+	}
+
+	zsock_close(fd);
+}
+
+static void server_start(bool deflate)
+{
+	server.deflate = deflate;
+	server.rx_bytes = 0;
+	server.compressed = 0;
+	server.error = 0;
+
+	k_thread_create(&server_thread, server_stack,
+			K_THREAD_STACK_SIZEOF(server_stack), server_run, NULL,
+			NULL, NULL, SERVER_PRIORITY, 0, K_NO_WAIT);
+}
+
+static void server_stop(void)
+{
+	k_thread_join(&server_thread, K_FOREVER);
+	zassert_equal(server.error, 0, "Server failed (%d)", server.error);
+}
+
+static int client_connect(int *sock, bool deflate)
+{
+	struct websocket_request req;
+
+	*sock = zsock_socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	zassert_true(*sock >= 0, "Cannot create socket (%d)", errno);
+
+	zassert_equal(zsock_connect(*sock, (struct sockaddr *)&server.addr,
+				    sizeof(server.addr)),
+		      0, "Cannot connect (%d)", errno);
+
+	memset(&req, 0, sizeof(req));
+
+	req.host = "127.0.0.1";
+	req.url = "/";
+	req.tmp_buf = tmp_buf;
+	req.tmp_buf_len = sizeof(tmp_buf);
+	req.permessage_deflate = deflate;
+
+	return websocket_connect(*sock, &req, TIMEOUT_MS, NULL);
+}
+
+/* Telemetry sample, the values change from one message to the other. */
+static size_t telemetry(int seq)
+{
+	return snprintk((char *)msg_buf, sizeof(msg_buf),
+			"{\"device\":\"sensor-0001\",\"seq\":%d,"
+			"\"timestamp\":%d,\"temperature\":%d.%02d,"
+			"\"humidity\":%d.%02d,\"pressure\":%d.%02d,"
+			"\"battery\":3.%02d,\"status\":\"ok\","
+			"\"location\":{\"latitude\":60.16952,"
+			"\"longitude\":24.93545},\"firmware\":\"1.2.3\"}",
+			seq, 1700000000 + seq, 20 + seq % 5, seq % 100,
+			40 + seq % 7, (seq * 3) % 100, 1013, (seq * 7) % 100,
+			70 + seq % 30);
+}
+
+static void echo(int ws, size_t len)
+{
+	uint64_t remaining;
+	uint32_t type;
+	size_t received = 0;
+	int ret;
+
+	ret = websocket_send_msg(ws, msg_buf, len, WEBSOCKET_OPCODE_DATA_TEXT,
+				 true, true, TIMEOUT_MS);
+	zassert_equal(ret, len, "Cannot send (%d)", ret);
+
+	do {
+		ret = websocket_recv_msg(ws, &echo_buf[received],
+					 sizeof(echo_buf) - received, &type,
+					 &remaining, TIMEOUT_MS);
+		zassert_true(ret >= 0, "Cannot receive (%d)", ret);
+
+		received += ret;
+	} while (remaining > 0 || !(type & WEBSOCKET_FLAG_FINAL));
+
+	zassert_equal(received, len, "Invalid echo length");
+	zassert_mem_equal(echo_buf, msg_buf, len, "Invalid echo");
+}
+
+static void run_echo(bool deflate, const char *name)
+{
+	int64_t start, elapsed;
+	size_t payload = 0;
+	int sock;
+	int ws;
+	int i;
+
+	server_start(deflate);
+
+	ws = client_connect(&sock, deflate);
+	zassert_true(ws >= 0, "Cannot open websocket (%d)", ws);
+
+	start = k_uptime_get();
+
+	for (i = 0; i < MESSAGES; i++) {
+		size_t len = telemetry(i);
+
+		echo(ws, len);
+		payload += len;
+	}
+
+	elapsed = MAX(k_uptime_get() - start, 1);
+
+	websocket_disconnect(ws);
+	server_stop();
+	zsock_close(sock);
+
+	zassert_equal(server.compressed, deflate ? MESSAGES : 0,
+		      "Invalid number of compressed messages");
+
+	/* The close message is not part of the measurement */
+	server.rx_bytes -= 6;
+
+	printk("%s: %d messages in %u ms, %u messages/s, "
+	       "%zu payload bytes, %zu bytes on the wire (%zu%%)\n",
+	       name, MESSAGES, (uint32_t)elapsed,
+	       (uint32_t)(MESSAGES * MSEC_PER_SEC / elapsed), payload,
+	       server.rx_bytes, server.rx_bytes * 100 / payload);
+}
+
+ZTEST(websocket_echo, test_plain)
+{
+	run_echo(false, "uncompressed");
+}
+
+ZTEST(websocket_echo, test_deflate)
+{
+	run_echo(true, "permessage-deflate");
+}
+
+static void *websocket_echo_setup(void)
+{
+	socklen_t addrlen = sizeof(server.addr);
+
+	server.addr.sin_family = AF_INET;
+	zsock_inet_pton(AF_INET, "127.0.0.1", &server.addr.sin_addr);
+
+	server.fd = zsock_socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	zassert_true(server.fd >= 0, "Cannot create server socket (%d)", errno);
+
+	zassert_equal(zsock_bind(server.fd, (struct sockaddr *)&server.addr,
+				 sizeof(server.addr)),
+		      0, "Cannot bind (%d)", errno);
+	zassert_equal(zsock_getsockname(server.fd,
+					(struct sockaddr *)&server.addr,
+					&addrlen),
+		      0, "Cannot get the server port (%d)", errno);
+	zassert_equal(zsock_listen(server.fd, 1), 0, "Cannot listen (%d)",
+		      errno);
+
+	return NULL;
+}
+
+static void websocket_echo_teardown(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	zsock_close(server.fd);
+}
+
+ZTEST_SUITE(websocket_echo, NULL, websocket_echo_setup, NULL, NULL,
+	    websocket_echo_teardown);
@@ -0,0 +1,92 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Measures the zperf TCP upload throughput over the loopback interface with
+ * 1, 2 and 4 parallel streams, and the CPU utilization during each upload.
+ * The zperf TCP receiver of the same image acts as the server.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <zephyr/net/net_ip.h>
+#include <zephyr/net/zperf.h>
+
+#define SERVER_PORT 5001
+#define DURATION_MS 2000
+#define PACKET_SIZE 512
+
+static void download_cb(enum zperf_status status, struct zperf_results *result,
+			void *user_data)
+{
+	ARG_UNUSED(status);
+	ARG_UNUSED(result);
+	ARG_UNUSED(user_data);
+}
+
+static void upload(uint8_t num_streams)
+{
+	struct zperf_upload_params param = { 0 };
+	struct sockaddr_in *addr = net_sin(&param.peer_addr);
+	struct in_addr loopback = INADDR_LOOPBACK_INIT;
+	struct zperf_results results;
+	uint64_t rate_kbps = 0;
+	int ret;
+
+	addr->sin_family = AF_INET;
+	addr->sin_port = htons(SERVER_PORT);
+	addr->sin_addr = loopback;
+
+	param.duration_ms = DURATION_MS;
+	param.packet_size = PACKET_SIZE;
+	param.num_streams = num_streams;
+
+	ret = zperf_tcp_upload(&param, &results);
+	zassert_equal(ret, 0, "Upload failed (%d)", ret);
+	zassert_equal(results.nb_streams, num_streams, "Wrong number of streams");
+	zassert_true(results.nb_packets_sent > 0, "Nothing sent");
+
+	if (results.client_time_in_us != 0U) {
+		rate_kbps = ((uint64_t)results.nb_packets_sent * results.packet_size *
+			     8U * USEC_PER_SEC) /
+			    ((uint64_t)results.client_time_in_us * 1024U);
+	}
+
+	printk("%u stream(s): %u packets, %u errors, %u kbps, CPU usage %u.%u %%\n",
+	       num_streams, results.nb_packets_sent, results.nb_packets_errors,
+	       (uint32_t)rate_kbps, results.cpu_usage_permille / 10U,
+	       results.cpu_usage_permille % 10U);
+}
+
+ZTEST(zperf_streams, test_tcp_upload)
+{
+	for (uint8_t num_streams = 1; num_streams <= CONFIG_NET_ZPERF_MAX_STREAMS;
+	     num_streams *= 2) {
+		upload(num_streams);
+	}
+}
+
+static void *zperf_streams_setup(void)
+{
+	struct zperf_download_params param = {
+		.port = SERVER_PORT,
+	};
+
+	zassert_equal(zperf_tcp_download(&param, download_cb, NULL), 0,
+		      "Cannot start the server");
+
+	/* Let the server thread bind the listening socket */
+	k_sleep(K_MSEC(100));
+
+	return NULL;
+}
+
+static void zperf_streams_teardown(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	(void)zperf_tcp_download_stop();
+}
+
+ZTEST_SUITE(zperf_streams, NULL, zperf_streams_setup, NULL, NULL,
+	    zperf_streams_teardown);
@@ -1148,10 +1148,8 @@ static const struct {
 #endif
 };
 
-ZTEST(t_6lo, test_loop)
+static void setup_tests(void)
 {
-	int count;
-
 	if (IS_ENABLED(CONFIG_NET_TC_THREAD_COOPERATIVE)) {
 		k_thread_priority_set(k_current_get(),
 				K_PRIO_COOP(CONFIG_NUM_COOP_PRIORITIES - 1));
@@ -1165,6 +1163,13 @@ ZTEST(t_6lo, test_loop)
 	net_6lo_set_context(net_if_get_first_by_type(&NET_L2_GET_NAME(DUMMY)),
 			    &ctx2);
 #endif
+}
+
+ZTEST(t_6lo, test_loop)
+{
+	int count;
+
+	setup_tests();
 
 	for (count = 0; count < ARRAY_SIZE(tests); count++) {
 		TC_PRINT("Starting %s\n", tests[count].name);
@@ -1174,5 +1179,22 @@ ZTEST(t_6lo, test_loop)
 	net_pkt_print();
 }
 
+/* Compress every packet twice in a row, the second time the address
+ * compression comes from the IPHC cache.
+ */
+ZTEST(t_6lo, test_loop_cached)
+{
+	int count;
+
+	setup_tests();
+
+	for (count = 0; count < ARRAY_SIZE(tests); count++) {
+		TC_PRINT("Starting %s twice\n", tests[count].name);
+
+		test_6lo(tests[count].data);
+		test_6lo(tests[count].data);
+	}
+}
+
 /*test case main entry*/
 ZTEST_SUITE(t_6lo, NULL, NULL, NULL, NULL, NULL);
@@ -0,0 +1,226 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <errno.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <zephyr/net/net_if.h>
+#include <zephyr/net/net_pkt.h>
+#include <zephyr/net/net_pkt_filter.h>
+#include <zephyr/net/capture.h>
+
+#define SHB_LEN 28
+#define IDB_LEN 20
+#define EPB_HDR_LEN 28
+
+#define PCAPNG_SHB_TYPE 0x0A0D0D0A
+#define PCAPNG_IDB_TYPE 0x00000001
+#define PCAPNG_EPB_TYPE 0x00000006
+#define LINKTYPE_RAW 101
+
+#define SNAPLEN CONFIG_NET_CAPTURE_RING_SNAPLEN
+
+static struct net_if *iface;
+
+static uint8_t out[2 * CONFIG_NET_CAPTURE_RING_SIZE];
+static size_t out_len;
+
+static struct npf_rule_list filter;
+static NPF_SIZE_MAX(maxsize_100, 100);
+static NPF_RULE(small_pkts, NET_OK, maxsize_100);
+
+static int write_cb(const void *data, size_t len, void *user_data)
+{
+	ARG_UNUSED(user_data);
+
+	if (out_len + len > sizeof(out)) {
+		return -ENOMEM;
+	}
+
+	memcpy(&out[out_len], data, len);
+	out_len += len;
+
+	return 0;
+}
+
+static uint32_t get_u32(size_t offset)
+{
+	uint32_t val;
+
+	memcpy(&val, &out[offset], sizeof(val));
+
+	return val;
+}
+
+static void capture(size_t len)
+{
+	struct net_pkt *pkt;
+	size_t i;
+
+	pkt = net_pkt_alloc_with_buffer(iface, len, AF_UNSPEC, 0, K_NO_WAIT);
+	zassert_not_null(pkt, "Cannot allocate pkt");
+
+	for (i = 0; i < len; i++) {
+		zassert_equal(net_pkt_write_u8(pkt, (uint8_t)i), 0, "Cannot write pkt");
+	}
+
+	net_capture_pkt(iface, pkt);
+
+	net_pkt_unref(pkt);
+}
+
+static void drain(void)
+{
+	int ret;
+
+	out_len = 0;
+
+	ret = net_capture_ring_drain(write_cb, NULL);
+	zassert_equal(ret, out_len, "Drained %d bytes, got %zu", ret, out_len);
+}
+
+/* Check the Enhanced Packet Block at @p offset and return the offset of the
+ * next block.
+ */
+static size_t check_epb(size_t offset, size_t len)
+{
+	size_t caplen = MIN(len, SNAPLEN);
+	size_t total = EPB_HDR_LEN + ROUND_UP(caplen, 4) + 4;
+	size_t i;
+
+	zassert_true(offset + total <= out_len, "Block truncated");
+	zassert_equal(get_u32(offset), PCAPNG_EPB_TYPE, "Wrong block type");
+	zassert_equal(get_u32(offset + 4), total, "Wrong block length");
+	zassert_equal(get_u32(offset + 8), 0, "Wrong interface id");
+	zassert_equal(get_u32(offset + 20), caplen, "Wrong captured length");
+	zassert_equal(get_u32(offset + 24), len, "Wrong original length");
+
+	for (i = 0; i < caplen; i++) {
+		zassert_equal(out[offset + EPB_HDR_LEN + i], (uint8_t)i,
+			      "Wrong data at %zu", i);
+	}
+
+	zassert_equal(get_u32(offset + total - 4), total, "Wrong block trailer");
+
+	return offset + total;
+}
+
+ZTEST(net_capture, test_pcapng_format)
+{
+	struct net_capture_ring_stats stats;
+	size_t offset;
+
+	zassert_equal(net_capture_ring_enable(iface, NULL), 0, "Cannot enable");
+
+	/* The second packet spans several buffers and is truncated */
+	capture(60);
+	capture(SNAPLEN + 10);
+
+	drain();
+
+	zassert_equal(get_u32(0), PCAPNG_SHB_TYPE, "No section header");
+	zassert_equal(get_u32(4), SHB_LEN, "Wrong section header length");
+	zassert_equal(get_u32(8), 0x1A2B3C4D, "Wrong byte order magic");
+
+	zassert_equal(get_u32(SHB_LEN), PCAPNG_IDB_TYPE, "No interface block");
+	zassert_equal(get_u32(SHB_LEN + 4), IDB_LEN, "Wrong interface block length");
+	zassert_equal(get_u32(SHB_LEN + 8) & 0xFFFF, LINKTYPE_RAW, "Wrong link type");
+	zassert_equal(get_u32(SHB_LEN + 12), SNAPLEN, "Wrong snapshot length");
+
+	offset = check_epb(SHB_LEN + IDB_LEN, 60);
+	offset = check_epb(offset, SNAPLEN + 10);
+	zassert_equal(offset, out_len, "Unexpected data");
+
+	zassert_equal(net_capture_ring_get_stats(&stats), 0, "Cannot get stats");
+	zassert_equal(stats.captured, 2, "Wrong captured count");
+	zassert_equal(stats.truncated, 1, "Wrong truncated count");
+	zassert_equal(stats.dropped, 0, "Wrong dropped count");
+
+	/* The headers are only written once per capture */
+	drain();
+	zassert_equal(out_len, 0, "Unexpected data");
+
+	zassert_equal(net_capture_ring_disable(), 0, "Cannot disable");
+
+	capture(60);
+	drain();
+	zassert_equal(out_len, 0, "Packet captured while disabled");
+}
+
+ZTEST(net_capture, test_filter)
+{
+	struct net_capture_ring_stats stats;
+	size_t offset;
+
+	npf_append_rule(&filter, &small_pkts);
+
+	zassert_equal(net_capture_ring_enable(iface, &filter), 0, "Cannot enable");
+
+	capture(200);
+	capture(50);
+
+	drain();
+
+	offset = check_epb(SHB_LEN + IDB_LEN, 50);
+	zassert_equal(offset, out_len, "Filtered packet captured");
+
+	zassert_equal(net_capture_ring_get_stats(&stats), 0, "Cannot get stats");
+	zassert_equal(stats.captured, 1, "Wrong captured count");
+	zassert_equal(stats.filtered, 1, "Wrong filtered count");
+
+	zassert_equal(net_capture_ring_disable(), 0, "Cannot disable");
+	npf_remove_all_rules(&filter);
+}
+
+ZTEST(net_capture, test_ring_full)
+{
+	struct net_capture_ring_stats stats;
+	size_t offset;
+	uint32_t i;
+
+	zassert_equal(net_capture_ring_enable(iface, NULL), 0, "Cannot enable");
+
+	for (i = 0; i < CONFIG_NET_CAPTURE_RING_SIZE / 64; i++) {
+		capture(64);
+	}
+
+	zassert_equal(net_capture_ring_get_stats(&stats), 0, "Cannot get stats");
+	zassert_true(stats.dropped > 0, "Ring never full");
+	zassert_equal(stats.captured + stats.dropped, i, "Packets lost");
+
+	drain();
+
+	offset = SHB_LEN + IDB_LEN;
+	for (i = 0; i < stats.captured; i++) {
+		offset = check_epb(offset, 64);
+	}
+
+	zassert_equal(offset, out_len, "Unexpected data");
+
+	/* Space is available again once drained */
+	capture(64);
+	drain();
+	zassert_equal(check_epb(0, 64), out_len, "Packet not captured");
+
+	zassert_equal(net_capture_ring_disable(), 0, "Cannot disable");
+}
+
+static void *net_capture_setup(void)
+{
+	iface = net_if_get_default();
+	zassert_not_null(iface, "No interface");
+
+	return NULL;
+}
+
+static void net_capture_after(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	(void)net_capture_ring_disable();
+}
+
+ZTEST_SUITE(net_capture, NULL, net_capture_setup, NULL, net_capture_after, NULL);
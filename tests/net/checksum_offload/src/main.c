@@ -79,6 +79,7 @@ static struct net_context *udp_v4_ctx_2;
 static bool test_failed;
 static bool test_started;
 static bool start_receiving;
+static bool corrupt_chksum;
 
 static K_SEM_DEFINE(wait_data, 0, UINT_MAX);
 
@@ -152,6 +153,7 @@ static int eth_tx_offloading_disabled(const struct device *dev,
 
 	if (start_receiving) {
 		struct net_udp_hdr hdr, *udp_hdr;
+		struct net_pkt *rx_pkt;
 		uint16_t port;
 		uint8_t lladdr[6];
 
@@ -183,6 +185,13 @@ static int eth_tx_offloading_disabled(const struct device *dev,
 		udp_hdr->src_port = udp_hdr->dst_port;
 		udp_hdr->dst_port = port;
 
+		/* Checksum is wrong but the packet is marked as already
+		 * validated, so the stack must not drop it.
+		 */
+		if (corrupt_chksum) {
+			udp_hdr->chksum ^= htons(0x1234);
+		}
+
 		memcpy(lladdr,
 		       ((struct net_eth_hdr *)net_pkt_data(pkt))->src.addr,
 		       sizeof(lladdr));
@@ -192,8 +201,12 @@ static int eth_tx_offloading_disabled(const struct device *dev,
 		memcpy(((struct net_eth_hdr *)net_pkt_data(pkt))->dst.addr,
 		       lladdr, sizeof(lladdr));
 
-		if (net_recv_data(net_pkt_iface(pkt),
-				  net_pkt_clone(pkt, K_NO_WAIT)) < 0) {
+		rx_pkt = net_pkt_clone(pkt, K_NO_WAIT);
+		zassert_not_null(rx_pkt, "Cannot clone packet %p", pkt);
+
+		net_pkt_set_chksum_valid(rx_pkt, corrupt_chksum);
+
+		if (net_recv_data(net_pkt_iface(pkt), rx_pkt) < 0) {
 			test_failed = true;
 			zassert_true(false, "Packet %p receive failed\n", pkt);
 		}
@@ -820,6 +833,62 @@ static void test_rx_chksum_offload_disabled_test_v4(void)
 	k_sleep(K_MSEC(10));
 }
 
+static void test_rx_chksum_valid_test_v4(void)
+{
+	struct net_context *udp_v4_ctx;
+	struct net_if *iface;
+	int ret, len;
+	struct sockaddr_in dst_addr4 = {
+		.sin_family = AF_INET,
+		.sin_port = htons(TEST_PORT),
+	};
+	struct sockaddr_in src_addr4 = {
+		.sin_family = AF_INET,
+		.sin_port = 0,
+	};
+
+	ret = net_context_get(AF_INET, SOCK_DGRAM, IPPROTO_UDP, &udp_v4_ctx);
+	zassert_equal(ret, 0, "Create IPv4 UDP context failed");
+
+	memcpy(&src_addr4.sin_addr, &in4addr_my, sizeof(struct in_addr));
+	memcpy(&dst_addr4.sin_addr, &in4addr_dst, sizeof(struct in_addr));
+
+	ret = net_context_bind(udp_v4_ctx, (struct sockaddr *)&src_addr4,
+			       sizeof(struct sockaddr_in));
+	zassert_equal(ret, 0, "Context bind failure test failed");
+
+	iface = eth_interfaces[0];
+	zassert_equal_ptr(&eth_context_offloading_disabled,
+			  net_if_get_device(iface)->data,
+			  "eth context mismatch");
+
+	len = strlen(test_data);
+
+	test_started = true;
+	start_receiving = true;
+	corrupt_chksum = true;
+
+	ret = net_context_recv(udp_v4_ctx, recv_cb_offload_disabled,
+			       K_NO_WAIT, NULL);
+	zassert_equal(ret, 0, "Recv UDP failed (%d)\n", ret);
+
+	ret = net_context_sendto(udp_v4_ctx, test_data, len,
+				 (struct sockaddr *)&dst_addr4,
+				 sizeof(struct sockaddr_in),
+				 NULL, K_FOREVER, NULL);
+	zassert_equal(ret, len, "Send UDP pkt failed (%d)\n", ret);
+
+	if (k_sem_take(&wait_data, WAIT_TIME)) {
+		DBG("Timeout while waiting interface data\n");
+		zassert_false(true, "Timeout");
+	}
+
+	start_receiving = false;
+	corrupt_chksum = false;
+
+	net_context_unref(udp_v4_ctx);
+}
+
 static void test_rx_chksum_offload_enabled_test_v6(void)
 {
 	struct eth_context *ctx; /* This is interface context */
@@ -947,6 +1016,11 @@ ZTEST(net_chksum_offload, test_chksum_offload_enabled_v4)
 	test_rx_chksum_offload_enabled_test_v4();
 }
 
+ZTEST(net_chksum_offload, test_chksum_valid_v4)
+{
+	test_rx_chksum_valid_test_v4();
+}
+
 ZTEST(net_chksum_offload, test_chksum_offload_disabled_v6)
 {
 	test_tx_chksum_offload_disabled_test_v6();
@@ -0,0 +1,284 @@
+/* main.c - FQ-CoDel TX queue tests */
+
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#define NET_LOG_LEVEL CONFIG_NET_TC_LOG_LEVEL
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(net_test, NET_LOG_LEVEL);
+
+#include <zephyr/types.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <errno.h>
+#include <zephyr/sys/printk.h>
+#include <zephyr/linker/sections.h>
+
+#include <zephyr/ztest.h>
+
+#include <zephyr/net/dummy.h>
+#include <zephyr/net/net_ip.h>
+#include <zephyr/net/net_l2.h>
+#include <zephyr/net/net_pkt.h>
+
+#include "ipv6.h"
+#include "udp_internal.h"
+
+#define NET_LOG_ENABLED 1
+#include "net_private.h"
+
+#define BULK_PORT 5001
+#define INTERACTIVE_PORT 5002
+
+/* With the default quantum of 1514 bytes, a bulk flow can send two of
+ * these packets in one round.
+ */
+#define BULK_LEN 1200
+#define INTERACTIVE_LEN 32
+
+#define BULK_COUNT 20
+#define SLOW_COUNT 40
+#define OVERLIMIT_EXTRA 10
+
+/* Emulated link speed, about 2.4 Mbit/s for the bulk packets */
+#define SLOW_SEND_MS 4
+
+#define MAX_SENT 64
+
+#define WAIT_TIME K_MSEC(500)
+
+static struct in6_addr my_addr = { { { 0x20, 0x01, 0x0d, 0xb8, 1, 0, 0, 0,
+				       0, 0, 0, 0, 0, 0, 0, 0x1 } } };
+static struct in6_addr peer_addr = { { { 0x20, 0x01, 0x0d, 0xb8, 1, 0, 0, 0,
+					 0, 0, 0, 0, 0, 0, 0, 0x2 } } };
+
+static struct net_if *test_iface;
+
+static uint16_t sent_ports[MAX_SENT];
+static int sent_count;
+static bool hold_tx;
+static bool slow_tx;
+static K_SEM_DEFINE(tx_gate, 0, 1);
+static K_SEM_DEFINE(tx_done, 0, MAX_SENT);
+
+static uint8_t payload[BULK_LEN];
+
+static void fake_iface_init(struct net_if *iface)
+{
+	static uint8_t mac[6] = { 0x00, 0x00, 0x5E, 0x00, 0x53, 0x01 };
+
+	net_if_set_link_addr(iface, mac, sizeof(mac), NET_LINK_DUMMY);
+}
+
+/* The TX thread calls this, so blocking here keeps the rest of the
+ * packets in the FQ-CoDel queues.
+ */
+static int fake_iface_send(const struct device *dev, struct net_pkt *pkt)
+{
+	uint16_t port;
+
+	ARG_UNUSED(dev);
+
+	if (hold_tx) {
+		k_sem_take(&tx_gate, K_FOREVER);
+	}
+
+	if (slow_tx) {
+		k_msleep(SLOW_SEND_MS);
+	}
+
+	net_pkt_cursor_init(pkt);
+
+	if (net_pkt_skip(pkt, sizeof(struct net_ipv6_hdr) +
+			 sizeof(uint16_t)) ||
+	    net_pkt_read_be16(pkt, &port)) {
+		port = 0U;
+	}
+
+	if (sent_count < MAX_SENT) {
+		sent_ports[sent_count++] = port;
+	}
+
+	k_sem_give(&tx_done);
+
+	return 0;
+}
+
+static struct dummy_api fake_iface_api = {
+	.iface_api.init = fake_iface_init,
+	.send = fake_iface_send,
+};
+
+NET_DEVICE_INIT(fq_codel_test, "fq_codel_test", NULL, NULL, NULL, NULL,
+		CONFIG_KERNEL_INIT_PRIORITY_DEFAULT, &fake_iface_api,
+		DUMMY_L2, NET_L2_GET_CTX_TYPE(DUMMY_L2), NET_IPV6_MTU);
+
+static void send_udp(uint16_t dst_port, size_t len)
+{
+	struct net_pkt *pkt;
+	int ret;
+
+	pkt = net_pkt_alloc_with_buffer(test_iface, len, AF_INET6,
+					IPPROTO_UDP, K_SECONDS(1));
+	zassert_not_null(pkt, "Cannot allocate pkt");
+
+	if (net_ipv6_create(pkt, &my_addr, &peer_addr) ||
+	    net_udp_create(pkt, htons(dst_port), htons(dst_port)) ||
+	    net_pkt_write(pkt, payload, len)) {
+		net_pkt_unref(pkt);
+		zassert_true(false, "Cannot create pkt");
+	}
+
+	net_pkt_cursor_init(pkt);
+	net_ipv6_finalize(pkt, IPPROTO_UDP);
+
+	ret = net_send_data(pkt);
+	zassert_equal(ret, 0, "Cannot send pkt (%d)", ret);
+}
+
+/* Wait until the queue has been idle for a while and return the number
+ * of packets the driver got.
+ */
+static int wait_tx_idle(void)
+{
+	int count = 0;
+
+	while (k_sem_take(&tx_done, WAIT_TIME) == 0) {
+		count++;
+	}
+
+	return count;
+}
+
+static void release_tx(void)
+{
+	hold_tx = false;
+	k_sem_give(&tx_gate);
+}
+
+static void *fq_codel_setup(void)
+{
+	struct net_if_addr *ifaddr;
+
+	test_iface = net_if_get_first_by_type(&NET_L2_GET_NAME(DUMMY));
+	zassert_not_null(test_iface, "No test interface");
+
+	ifaddr = net_if_ipv6_addr_add(test_iface, &my_addr,
+				      NET_ADDR_MANUAL, 0);
+	zassert_not_null(ifaddr, "Cannot add address");
+
+	ifaddr->addr_state = NET_ADDR_PREFERRED;
+
+	net_if_up(test_iface);
+
+	return NULL;
+}
+
+static void fq_codel_before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	hold_tx = false;
+	slow_tx = false;
+	sent_count = 0;
+
+	k_sem_reset(&tx_gate);
+	k_sem_reset(&tx_done);
+}
+
+ZTEST(net_fq_codel, test_interactive_flow_latency)
+{
+	int interactive_pos = -1;
+	int i;
+
+	hold_tx = true;
+
+	for (i = 0; i < BULK_COUNT; i++) {
+		send_udp(BULK_PORT, BULK_LEN);
+	}
+
+	send_udp(INTERACTIVE_PORT, INTERACTIVE_LEN);
+
+	release_tx();
+
+	zassert_equal(wait_tx_idle(), BULK_COUNT + 1,
+		      "Packets lost (%d sent)", sent_count);
+
+	for (i = 0; i < sent_count; i++) {
+		if (sent_ports[i] == INTERACTIVE_PORT) {
+			interactive_pos = i;
+			break;
+		}
+	}
+
+	/* With a single FIFO the interactive packet would be the last one
+	 * sent. Now it can only wait for the bulk flow to use its current
+	 * quantum.
+	 */
+	zassert_true(interactive_pos >= 0 && interactive_pos <= 2,
+		     "Interactive packet sent at position %d",
+		     interactive_pos);
+}
+
+ZTEST(net_fq_codel, test_codel_drop)
+{
+	net_stats_t drops = test_iface->stats.fq_codel.codel_drops;
+	int sent;
+	int i;
+
+	slow_tx = true;
+
+	for (i = 0; i < SLOW_COUNT; i++) {
+		send_udp(BULK_PORT, BULK_LEN);
+	}
+
+	sent = wait_tx_idle();
+	drops = test_iface->stats.fq_codel.codel_drops - drops;
+
+	/* Draining the whole queue takes longer than the CoDel interval
+	 * so the standing queue must have been cut down by dropping.
+	 */
+	zassert_true(drops > 0, "No CoDel drops");
+	zassert_equal(sent + drops, SLOW_COUNT,
+		      "Sent %d and dropped %d packets", sent, drops);
+}
+
+ZTEST(net_fq_codel, test_overlimit_drop)
+{
+	net_stats_t drops = test_iface->stats.fq_codel.overlimit_drops;
+	int sent;
+	int i;
+
+	hold_tx = true;
+
+	for (i = 0; i < CONFIG_NET_TC_TX_FQ_CODEL_LIMIT + OVERLIMIT_EXTRA;
+	     i++) {
+		send_udp(BULK_PORT, INTERACTIVE_LEN);
+	}
+
+	send_udp(INTERACTIVE_PORT, INTERACTIVE_LEN);
+
+	release_tx();
+
+	sent = wait_tx_idle();
+	drops = test_iface->stats.fq_codel.overlimit_drops - drops;
+
+	zassert_true(drops > 0, "No overlimit drops");
+	zassert_equal(sent + drops,
+		      CONFIG_NET_TC_TX_FQ_CODEL_LIMIT + OVERLIMIT_EXTRA + 1,
+		      "Sent %d and dropped %d packets", sent, drops);
+
+	/* The drops hit the fattest flow, so the sparse one survives */
+	for (i = 0; i < sent_count; i++) {
+		if (sent_ports[i] == INTERACTIVE_PORT) {
+			break;
+		}
+	}
+
+	zassert_not_equal(i, sent_count, "Interactive packet was dropped");
+}
+
+ZTEST_SUITE(net_fq_codel, NULL, fq_codel_setup, fq_codel_before, NULL, NULL);
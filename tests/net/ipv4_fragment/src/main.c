@@ -873,6 +873,143 @@ ZTEST(net_ipv4_fragment, test_do_not_fragment)
 	zassert_equal(pkt_recv_size, pkt_recv_expected_size, "Packet size mismatch");
 }
 
+/* Fragment storm datagrams are not sent to our own address, so the IPv4 input
+ * drops them silently once they have been reassembled.
+ */
+static struct in_addr storm_addr = { { { 0xc0, 0xa8, 0x08, 0x03 } } };
+
+#define STORM_FRAGMENTS 4
+#define STORM_FRAGMENT_LEN 64
+#define STORM_ROUNDS 16
+#define MEM_LIMIT_FRAGMENT_LEN 512
+
+/* Creates one fragment of a storm datagram as if it was received from iface1 */
+static struct net_pkt *create_storm_fragment(uint16_t id, uint16_t offset, uint16_t len,
+					     bool more)
+{
+	uint16_t flags = (offset / 8) | (more ? NET_IPV4_MORE_FRAG_MASK : 0);
+	struct net_ipv4_hdr *hdr;
+	struct net_pkt *pkt;
+	int ret;
+
+	pkt = net_pkt_rx_alloc_with_buffer(iface1, NET_IPV4H_LEN + len, AF_INET,
+					   IPPROTO_UDP, ALLOC_TIMEOUT);
+	zassert_not_null(pkt, "Packet creation failure");
+
+	net_pkt_set_family(pkt, AF_INET);
+	net_pkt_set_ip_hdr_len(pkt, NET_IPV4H_LEN);
+
+	ret = net_pkt_write(pkt, ipv4_udp, NET_IPV4H_LEN);
+	zassert_equal(ret, 0, "IPv4 header append failed");
+
+	ret = net_pkt_memset(pkt, 0xaa, len);
+	zassert_equal(ret, 0, "IPv4 data append failed");
+
+	hdr = NET_IPV4_HDR(pkt);
+	hdr->len = htons(NET_IPV4H_LEN + len);
+	UNALIGNED_PUT(htons(id), (uint16_t *)hdr->id);
+	UNALIGNED_PUT(htons(flags), (uint16_t *)hdr->offset);
+	net_ipv4_addr_copy_raw(hdr->src, (uint8_t *)&my_addr2);
+	net_ipv4_addr_copy_raw(hdr->dst, (uint8_t *)&storm_addr);
+
+	net_pkt_cursor_init(pkt);
+
+	return pkt;
+}
+
+static void recv_storm_fragment(uint16_t id, uint16_t offset, uint16_t len, bool more,
+				uint32_t *cycles)
+{
+	struct net_pkt *pkt = create_storm_fragment(id, offset, len, more);
+	enum net_verdict verdict;
+	uint32_t start;
+
+	start = k_cycle_get_32();
+	verdict = net_ipv4_handle_fragment_hdr(pkt, NET_IPV4_HDR(pkt));
+	*cycles += k_cycle_get_32() - start;
+
+	zassert_equal(verdict, NET_OK, "Fragment id %u offset %u not accepted", id, offset);
+}
+
+/* Interleave the fragments of as many datagrams as there are reassembly slots, last
+ * fragment first, and check that all of them get reassembled.
+ */
+ZTEST(net_ipv4_fragment, test_fragment_storm)
+{
+	uint32_t count = 0U;
+	uint32_t cycles = 0U;
+	uint8_t packets;
+
+	for (int round = 0; round < STORM_ROUNDS; round++) {
+		for (int frag = STORM_FRAGMENTS - 1; frag >= 0; frag--) {
+			for (int i = 0; i < CONFIG_NET_IPV4_FRAGMENT_MAX_COUNT; i++) {
+				uint16_t id = round * CONFIG_NET_IPV4_FRAGMENT_MAX_COUNT + i + 1;
+
+				recv_storm_fragment(id, frag * STORM_FRAGMENT_LEN,
+						    STORM_FRAGMENT_LEN,
+						    frag < STORM_FRAGMENTS - 1, &cycles);
+				count++;
+			}
+		}
+
+		packets = 0;
+		net_ipv4_frag_foreach(reassembly_foreach_cb, &packets);
+		zassert_equal(packets, 0, "Expected all datagrams to be reassembled");
+	}
+
+	TC_PRINT("%u fragments, %u cycles per fragment\n", count, cycles / count);
+
+	/* Let the reassembled datagrams be dropped before the next test */
+	k_sleep(K_MSEC(100));
+}
+
+/* Start more reassemblies than fit into the memory limit and check that the
+ * oldest ones are dropped to make room for the new ones.
+ */
+ZTEST(net_ipv4_fragment, test_fragment_mem_limit)
+{
+	const int fit = CONFIG_NET_IPV4_FRAGMENT_MAX_MEM /
+			(NET_IPV4H_LEN + MEM_LIMIT_FRAGMENT_LEN);
+	uint32_t cycles = 0U;
+	uint8_t packets;
+
+	BUILD_ASSERT(CONFIG_NET_IPV4_FRAGMENT_MAX_MEM /
+		     (NET_IPV4H_LEN + MEM_LIMIT_FRAGMENT_LEN) <
+		     CONFIG_NET_IPV4_FRAGMENT_MAX_COUNT,
+		     "Memory limit must be hit before the reassembly slots run out");
+
+	for (int i = 0; i < CONFIG_NET_IPV4_FRAGMENT_MAX_COUNT; i++) {
+		recv_storm_fragment(i + 1, 0, MEM_LIMIT_FRAGMENT_LEN, true, &cycles);
+
+		/* Make the age of each reassembly distinct */
+		k_sleep(K_MSEC(20));
+	}
+
+	packets = 0;
+	net_ipv4_frag_foreach(reassembly_foreach_cb, &packets);
+	zassert_equal(packets, fit, "Expected %d pending reassemblies", fit);
+
+	/* A duplicate drops its own datagram but must not push others out */
+	recv_storm_fragment(CONFIG_NET_IPV4_FRAGMENT_MAX_COUNT, 0, MEM_LIMIT_FRAGMENT_LEN,
+			    true, &cycles);
+
+	packets = 0;
+	net_ipv4_frag_foreach(reassembly_foreach_cb, &packets);
+	zassert_equal(packets, fit - 1, "Expected %d pending reassemblies", fit - 1);
+
+	/* Complete the others, the oldest ones must be gone already */
+	for (int i = CONFIG_NET_IPV4_FRAGMENT_MAX_COUNT - fit;
+	     i < CONFIG_NET_IPV4_FRAGMENT_MAX_COUNT - 1; i++) {
+		recv_storm_fragment(i + 1, MEM_LIMIT_FRAGMENT_LEN, 8, false, &cycles);
+	}
+
+	packets = 0;
+	net_ipv4_frag_foreach(reassembly_foreach_cb, &packets);
+	zassert_equal(packets, 0, "Expected all pending datagrams to be reassembled");
+
+	k_sleep(K_MSEC(100));
+}
+
 static void test_pre(void *ptr)
 {
 	k_sem_reset(&wait_data);
@@ -2390,4 +2390,166 @@ ZTEST(net_ipv6_fragment, test_recv_ipv6_fragment)
 	net_icmpv6_unregister_handler(&ping6_handler);
 }
 
+/* Fragment storm datagrams are not sent to our own address, so the IPv6 input
+ * drops them silently once they have been reassembled.
+ */
+static struct in6_addr storm_addr = { { { 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0,
+					  0, 0, 0, 0, 0, 0, 0, 0x3 } } };
+
+#define STORM_FRAGMENTS 4
+#define STORM_FRAGMENT_LEN 64
+#define STORM_ROUNDS 16
+#define MEM_LIMIT_FRAGMENT_LEN 512
+#define STORM_HDR_LEN (NET_IPV6H_LEN + NET_IPV6_FRAGH_LEN)
+
+static void reassembly_foreach_cb(struct net_ipv6_reassembly *reassembly, void *data)
+{
+	uint8_t *packets = (uint8_t *)data;
+	++*packets;
+}
+
+/* Creates one fragment of a storm datagram as if it was received from iface1 and
+ * leaves the cursor where net_ipv6_handle_fragment_hdr() expects it.
+ */
+static struct net_pkt *create_storm_fragment(uint32_t id, uint16_t offset, uint16_t len,
+					     bool more)
+{
+	struct net_ipv6_frag_hdr frag_hdr = {
+		.nexthdr = IPPROTO_UDP,
+		.offset = htons(offset | (more ? 0x01 : 0)),
+		.id = htonl(id),
+	};
+	struct net_ipv6_hdr hdr = {
+		.vtc = 0x60,
+		.len = htons(NET_IPV6_FRAGH_LEN + len),
+		.nexthdr = NET_IPV6_NEXTHDR_FRAG,
+		.hop_limit = 64,
+	};
+	struct net_pkt *pkt;
+	int ret;
+
+	net_ipv6_addr_copy_raw(hdr.src, (uint8_t *)&my_addr2);
+	net_ipv6_addr_copy_raw(hdr.dst, (uint8_t *)&storm_addr);
+
+	pkt = net_pkt_rx_alloc_with_buffer(iface1, STORM_HDR_LEN + len, AF_INET6,
+					   IPPROTO_UDP, ALLOC_TIMEOUT);
+	zassert_not_null(pkt, "Packet creation failure");
+
+	net_pkt_set_ip_hdr_len(pkt, NET_IPV6H_LEN);
+
+	ret = net_pkt_write(pkt, &hdr, sizeof(hdr));
+	zassert_equal(ret, 0, "IPv6 header append failed");
+
+	ret = net_pkt_write(pkt, &frag_hdr, sizeof(frag_hdr));
+	zassert_equal(ret, 0, "IPv6 fragment header append failed");
+
+	ret = net_pkt_memset(pkt, 0xaa, len);
+	zassert_equal(ret, 0, "IPv6 data append failed");
+
+	net_pkt_set_ipv6_hdr_prev(pkt, offsetof(struct net_ipv6_hdr, nexthdr));
+	net_pkt_set_ipv6_fragment_start(pkt, NET_IPV6H_LEN);
+	net_pkt_set_overwrite(pkt, true);
+
+	net_pkt_cursor_init(pkt);
+	net_pkt_skip(pkt, NET_IPV6H_LEN + 1);
+
+	return pkt;
+}
+
+static void recv_storm_fragment(uint32_t id, uint16_t offset, uint16_t len, bool more,
+				uint32_t *cycles)
+{
+	struct net_pkt *pkt = create_storm_fragment(id, offset, len, more);
+	struct net_ipv6_hdr hdr;
+	enum net_verdict verdict;
+	uint32_t start;
+
+	memcpy(&hdr, NET_IPV6_HDR(pkt), sizeof(hdr));
+
+	start = k_cycle_get_32();
+	verdict = net_ipv6_handle_fragment_hdr(pkt, &hdr, NET_IPV6_NEXTHDR_FRAG);
+	*cycles += k_cycle_get_32() - start;
+
+	zassert_equal(verdict, NET_OK, "Fragment id %u offset %u not accepted", id, offset);
+}
+
+/* Interleave the fragments of as many datagrams as there are reassembly slots, last
+ * fragment first, and check that all of them get reassembled.
+ */
+ZTEST(net_ipv6_fragment, test_fragment_storm)
+{
+	uint32_t count = 0U;
+	uint32_t cycles = 0U;
+	uint8_t packets;
+
+	for (int round = 0; round < STORM_ROUNDS; round++) {
+		for (int frag = STORM_FRAGMENTS - 1; frag >= 0; frag--) {
+			for (int i = 0; i < CONFIG_NET_IPV6_FRAGMENT_MAX_COUNT; i++) {
+				uint32_t id = round * CONFIG_NET_IPV6_FRAGMENT_MAX_COUNT + i + 1;
+
+				recv_storm_fragment(id, frag * STORM_FRAGMENT_LEN,
+						    STORM_FRAGMENT_LEN,
+						    frag < STORM_FRAGMENTS - 1, &cycles);
+				count++;
+			}
+		}
+
+		packets = 0;
+		net_ipv6_frag_foreach(reassembly_foreach_cb, &packets);
+		zassert_equal(packets, 0, "Expected all datagrams to be reassembled");
+	}
+
+	TC_PRINT("%u fragments, %u cycles per fragment\n", count, cycles / count);
+
+	/* Let the reassembled datagrams be dropped before the next test */
+	k_sleep(K_MSEC(100));
+}
+
+/* Start more reassemblies than fit into the memory limit and check that the
+ * oldest ones are dropped to make room for the new ones.
+ */
+ZTEST(net_ipv6_fragment, test_fragment_mem_limit)
+{
+	const int fit = CONFIG_NET_IPV6_FRAGMENT_MAX_MEM /
+			(STORM_HDR_LEN + MEM_LIMIT_FRAGMENT_LEN);
+	uint32_t cycles = 0U;
+	uint8_t packets;
+
+	BUILD_ASSERT(CONFIG_NET_IPV6_FRAGMENT_MAX_MEM /
+		     (STORM_HDR_LEN + MEM_LIMIT_FRAGMENT_LEN) <
+		     CONFIG_NET_IPV6_FRAGMENT_MAX_COUNT,
+		     "Memory limit must be hit before the reassembly slots run out");
+
+	for (int i = 0; i < CONFIG_NET_IPV6_FRAGMENT_MAX_COUNT; i++) {
+		recv_storm_fragment(i + 1, 0, MEM_LIMIT_FRAGMENT_LEN, true, &cycles);
+
+		/* Make the age of each reassembly distinct */
+		k_sleep(K_MSEC(20));
+	}
+
+	packets = 0;
+	net_ipv6_frag_foreach(reassembly_foreach_cb, &packets);
+	zassert_equal(packets, fit, "Expected %d pending reassemblies", fit);
+
+	/* A duplicate drops its own datagram but must not push others out */
+	recv_storm_fragment(CONFIG_NET_IPV6_FRAGMENT_MAX_COUNT, 0, MEM_LIMIT_FRAGMENT_LEN,
+			    true, &cycles);
+
+	packets = 0;
+	net_ipv6_frag_foreach(reassembly_foreach_cb, &packets);
+	zassert_equal(packets, fit - 1, "Expected %d pending reassemblies", fit - 1);
+
+	/* Complete the others, the oldest ones must be gone already */
+	for (int i = CONFIG_NET_IPV6_FRAGMENT_MAX_COUNT - fit;
+	     i < CONFIG_NET_IPV6_FRAGMENT_MAX_COUNT - 1; i++) {
+		recv_storm_fragment(i + 1, MEM_LIMIT_FRAGMENT_LEN, 8, false, &cycles);
+	}
+
+	packets = 0;
+	net_ipv6_frag_foreach(reassembly_foreach_cb, &packets);
+	zassert_equal(packets, 0, "Expected all pending datagrams to be reassembled");
+
+	k_sleep(K_MSEC(100));
+}
+
 ZTEST_SUITE(net_ipv6_fragment, NULL, test_setup, NULL, NULL, NULL);
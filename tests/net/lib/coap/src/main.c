@@ -1023,6 +1023,115 @@ ZTEST(coap, test_handle_invalid_coap_req)
 	zassert_equal(r, -ENOTSUP, "Request handling should fail with -ENOTSUP");
 }
 
+static struct coap_resource *trie_dispatched;
+
+static int trie_resource_get(struct coap_resource *resource,
+			     struct coap_packet *request,
+			     struct sockaddr *addr, socklen_t addr_len)
+{
+	trie_dispatched = resource;
+
+	return 0;
+}
+
+static const char * const trie_path_root[] = { NULL };
+static const char * const trie_path_a_b[] = { "a", "b", NULL };
+static const char * const trie_path_a_plus[] = { "a", "+", NULL };
+static const char * const trie_path_a_hash[] = { "a", "#", NULL };
+static const char * const trie_path_c[] = { "c", NULL };
+static const char * const trie_path_plus_d[] = { "+", "d", NULL };
+
+static struct coap_resource trie_resources[] = {
+	{ .path = trie_path_a_b, .get = trie_resource_get },
+	{ .path = trie_path_a_plus, .get = trie_resource_get },
+	{ .path = trie_path_a_hash, .get = trie_resource_get },
+	{ .path = trie_path_c, .get = trie_resource_get },
+	{ .path = trie_path_plus_d, .get = trie_resource_get },
+	/* Shadowed by the first resource */
+	{ .path = trie_path_a_b, .get = trie_resource_get },
+	{ .path = trie_path_root, .get = trie_resource_get },
+	{ },
+};
+
+static struct coap_resource_trie_node trie_nodes[COAP_RESOURCE_TRIE_NODES(8)];
+
+static struct coap_resource *trie_dispatch(const struct coap_resource_trie *trie,
+					   const char * const *path)
+{
+	struct coap_packet req;
+	struct coap_option options[4] = {};
+	struct coap_resource *linear;
+	uint8_t *data = data_buf[0];
+	uint8_t opt_num = ARRAY_SIZE(options);
+	int r1, r2;
+	int r;
+
+	r = coap_packet_init(&req, data, COAP_BUF_SIZE, COAP_VERSION_1,
+			     COAP_TYPE_CON, 0, NULL, COAP_METHOD_GET,
+			     coap_next_id());
+	zassert_equal(r, 0, "Unable to init req");
+
+	for (; *path; path++) {
+		r = coap_packet_append_option(&req, COAP_OPTION_URI_PATH,
+					      *path, strlen(*path));
+		zassert_equal(r, 0, "Unable to append option");
+	}
+
+	r = coap_packet_parse(&req, data, req.offset, options, opt_num);
+	zassert_equal(r, 0, "Could not parse req packet");
+
+	trie_dispatched = NULL;
+	r1 = coap_handle_request(&req, trie_resources, options, opt_num,
+				 (struct sockaddr *)&dummy_addr,
+				 sizeof(dummy_addr));
+	linear = trie_dispatched;
+
+	trie_dispatched = NULL;
+	r2 = coap_handle_request_trie(&req, trie, options, opt_num,
+				      (struct sockaddr *)&dummy_addr,
+				      sizeof(dummy_addr));
+
+	zassert_equal(r1, r2, "Different results (%d and %d)", r1, r2);
+	zassert_equal_ptr(linear, trie_dispatched, "Different resources");
+	zassert_equal_ptr(coap_resource_trie_lookup(trie, options, opt_num),
+			  trie_dispatched, "Lookup differs from dispatch");
+
+	return trie_dispatched;
+}
+
+ZTEST(coap, test_resource_trie)
+{
+	static const char * const a_z[] = { "a", "z", NULL };
+	static const char * const a_z_y[] = { "a", "z", "y", NULL };
+	static const char * const a[] = { "a", NULL };
+	static const char * const c_d[] = { "c", "d", NULL };
+	static const char * const d[] = { "d", NULL };
+	struct coap_resource_trie trie;
+	int r;
+
+	r = coap_resource_trie_init(&trie, trie_resources, trie_nodes,
+				    ARRAY_SIZE(trie_nodes));
+	zassert_equal(r, 0, "Could not build the trie");
+
+	zassert_equal_ptr(trie_dispatch(&trie, trie_path_a_b),
+			  &trie_resources[0], "Wrong resource for a/b");
+	zassert_equal_ptr(trie_dispatch(&trie, a_z),
+			  &trie_resources[1], "Wrong resource for a/z");
+	zassert_equal_ptr(trie_dispatch(&trie, a_z_y),
+			  &trie_resources[2], "Wrong resource for a/z/y");
+	zassert_equal_ptr(trie_dispatch(&trie, trie_path_c),
+			  &trie_resources[3], "Wrong resource for c");
+	zassert_equal_ptr(trie_dispatch(&trie, c_d),
+			  &trie_resources[4], "Wrong resource for c/d");
+	zassert_equal_ptr(trie_dispatch(&trie, trie_path_root),
+			  &trie_resources[6], "Wrong resource for the root");
+	zassert_is_null(trie_dispatch(&trie, a), "No resource for a");
+	zassert_is_null(trie_dispatch(&trie, d), "No resource for d");
+
+	r = coap_resource_trie_init(&trie, trie_resources, trie_nodes, 4);
+	zassert_equal(r, -ENOMEM, "Trie should not fit in 4 nodes");
+}
+
 ZTEST(coap, test_build_options_out_of_order_0)
 {
 	uint8_t result[] = {0x45, 0x02, 0x12, 0x34, 't', 'o', 'k',  'e', 'n', 0xC0, 0xB1, 0x19,
@@ -292,7 +292,8 @@ ZTEST(coap_client, test_no_response)
 	ret = coap_client_req(&client, 0, &address, &client_request, 0);
 
 	zassert_true(ret >= 0, "Sending request failed, %d", ret);
-	k_sleep(K_MSEC(1000));
+	k_sleep(K_MSEC(CONFIG_COAP_INIT_ACK_TIMEOUT_MS + 1000));
+	zassert_equal(last_response_code, (uint8_t)-ETIMEDOUT, "Unexpected response");
 }
 
 ZTEST(coap_client, test_separate_response)
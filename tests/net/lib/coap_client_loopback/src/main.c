@@ -0,0 +1,320 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(net_test, CONFIG_COAP_LOG_LEVEL);
+
+#include <errno.h>
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <zephyr/net/socket.h>
+#include <zephyr/net/coap.h>
+#include <zephyr/net/coap_client.h>
+
+#define SERVER_PORT 15683
+#define STACK_SIZE 2048
+#define THREAD_PRIORITY K_PRIO_COOP(8)
+
+#define MAX_BUF_SIZE 256
+#define MAX_OPTIONS 4
+
+/* Requests to "slow" are answered after this time, the others at once */
+#define HOLD_TIME_MS 50
+#define MAX_HELD CONFIG_COAP_CLIENT_MAX_REQUESTS
+#define NUM_SLOW_REQUESTS CONFIG_COAP_CLIENT_MAX_REQUESTS
+
+/* Served in blocks of this size to requests for "big" */
+#define BLOCK_SIZE 64
+#define BIG_SIZE 1000
+
+#define WAIT_TIME K_SECONDS(5)
+
+struct held_request {
+	struct sockaddr addr;
+	socklen_t addr_len;
+	uint8_t data[MAX_BUF_SIZE];
+	uint16_t len;
+	int64_t received;
+};
+
+static struct held_request held[MAX_HELD];
+static int num_held;
+static int max_held;
+
+static uint8_t server_buf[MAX_BUF_SIZE];
+static uint8_t response_buf[MAX_BUF_SIZE];
+static uint8_t big_payload[BIG_SIZE];
+static int server_sock;
+
+static struct coap_client client;
+static struct sockaddr server_addr;
+static int client_sock;
+
+static struct k_sem completed;
+static int16_t last_code;
+
+static size_t big_received;
+static int big_blocks;
+static bool big_error;
+
+static bool path_is(const struct coap_packet *req, const char *path)
+{
+	struct coap_option option;
+
+	if (coap_find_options(req, COAP_OPTION_URI_PATH, &option, 1) != 1) {
+		return false;
+	}
+
+	return option.len == strlen(path) && memcmp(option.value, path, option.len) == 0;
+}
+
+static void send_response(const struct sockaddr *addr, socklen_t addr_len,
+			  const struct coap_packet *req)
+{
+	struct coap_block_context ctx;
+	struct coap_packet rsp;
+	int block;
+	int ret;
+
+	ret = coap_ack_init(&rsp, req, response_buf, sizeof(response_buf),
+			    COAP_RESPONSE_CODE_CONTENT);
+	if (ret < 0) {
+		return;
+	}
+
+	if (path_is(req, "big")) {
+		block = coap_get_option_int(req, COAP_OPTION_BLOCK2);
+
+		coap_block_transfer_init(&ctx, COAP_BLOCK_64, BIG_SIZE);
+		if (block > 0) {
+			ctx.current = GET_BLOCK_NUM(block) * BLOCK_SIZE;
+		}
+
+		if (ctx.current >= BIG_SIZE ||
+		    coap_append_block2_option(&rsp, &ctx) < 0 ||
+		    coap_packet_append_payload_marker(&rsp) < 0 ||
+		    coap_packet_append_payload(&rsp, &big_payload[ctx.current],
+					       MIN(BLOCK_SIZE, BIG_SIZE - ctx.current)) < 0) {
+			return;
+		}
+	}
+
+	(void)zsock_sendto(server_sock, rsp.data, rsp.offset, 0, addr, addr_len);
+}
+
+static bool is_held(const struct coap_packet *req)
+{
+	struct coap_packet pkt;
+
+	for (int i = 0; i < num_held; i++) {
+		if (coap_packet_parse(&pkt, held[i].data, held[i].len, NULL, 0) == 0 &&
+		    coap_header_get_id(&pkt) == coap_header_get_id(req)) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static void release_held(void)
+{
+	struct coap_packet req;
+
+	while (num_held > 0 && k_uptime_get() - held[0].received >= HOLD_TIME_MS) {
+		if (coap_packet_parse(&req, held[0].data, held[0].len, NULL, 0) == 0) {
+			send_response(&held[0].addr, held[0].addr_len, &req);
+		}
+
+		num_held--;
+		memmove(&held[0], &held[1], num_held * sizeof(held[0]));
+	}
+}
+
+static void coap_server(void)
+{
+	struct zsock_pollfd fds = {
+		.fd = server_sock,
+		.events = ZSOCK_POLLIN,
+	};
+	struct sockaddr addr;
+	socklen_t addr_len;
+	struct coap_packet req;
+	int len;
+
+	while (true) {
+		release_held();
+
+		if (zsock_poll(&fds, 1, 10) <= 0) {
+			continue;
+		}
+
+		addr_len = sizeof(addr);
+		len = zsock_recvfrom(server_sock, server_buf, sizeof(server_buf), 0,
+				     &addr, &addr_len);
+		if (len <= 0 || coap_packet_parse(&req, server_buf, len, NULL, 0) < 0) {
+			continue;
+		}
+
+		if (!path_is(&req, "slow")) {
+			send_response(&addr, addr_len, &req);
+			continue;
+		}
+
+		/* Retransmissions of a held request are not new requests */
+		if (is_held(&req) || num_held == MAX_HELD) {
+			continue;
+		}
+
+		memcpy(&held[num_held].addr, &addr, addr_len);
+		held[num_held].addr_len = addr_len;
+		memcpy(held[num_held].data, server_buf, len);
+		held[num_held].len = len;
+		held[num_held].received = k_uptime_get();
+		num_held++;
+
+		max_held = MAX(max_held, num_held);
+	}
+}
+
+K_THREAD_DEFINE(coap_server_thread_id, STACK_SIZE,
+		coap_server, NULL, NULL, NULL,
+		THREAD_PRIORITY, 0, -1);
+
+static void response_cb(int16_t code, size_t offset, const uint8_t *payload, size_t len,
+			bool last_block, void *user_data)
+{
+	last_code = code;
+
+	if (last_block) {
+		k_sem_give(&completed);
+	}
+}
+
+static int send_get(const char *path, coap_client_response_cb_t cb)
+{
+	struct coap_client_request req = {
+		.method = COAP_METHOD_GET,
+		.confirmable = true,
+		.path = path,
+		.fmt = COAP_CONTENT_FORMAT_TEXT_PLAIN,
+		.cb = cb,
+	};
+
+	return coap_client_req(&client, client_sock, &server_addr, &req, -1);
+}
+
+ZTEST(coap_client_loopback, test_nstart_window)
+{
+	int ret;
+
+	max_held = 0;
+
+	/* The client has a request slot for each, so none is refused */
+	for (int i = 0; i < NUM_SLOW_REQUESTS; i++) {
+		ret = send_get("slow", response_cb);
+		zassert_equal(ret, 0, "Request %d failed (%d)", i, ret);
+	}
+
+	for (int i = 0; i < NUM_SLOW_REQUESTS; i++) {
+		zassert_equal(k_sem_take(&completed, WAIT_TIME), 0,
+			      "Request %d not completed", i);
+		zassert_equal(last_code, COAP_RESPONSE_CODE_CONTENT,
+			      "Unexpected response %d", last_code);
+	}
+
+	zassert_equal(max_held, CONFIG_COAP_CLIENT_NSTART,
+		      "%d requests were outstanding at once", max_held);
+}
+
+static void big_cb(int16_t code, size_t offset, const uint8_t *payload, size_t len,
+		   bool last_block, void *user_data)
+{
+	last_code = code;
+
+	/* Each block is delivered as it arrives, in order */
+	if (offset != big_received || len > BLOCK_SIZE ||
+	    memcmp(payload, &big_payload[offset], len) != 0) {
+		big_error = true;
+	}
+
+	big_received += len;
+	big_blocks++;
+
+	if (last_block) {
+		k_sem_give(&completed);
+	}
+}
+
+ZTEST(coap_client_loopback, test_block2_streaming)
+{
+	int ret;
+
+	big_received = 0;
+	big_blocks = 0;
+	big_error = false;
+
+	ret = send_get("big", big_cb);
+	zassert_equal(ret, 0, "Request failed (%d)", ret);
+
+	zassert_equal(k_sem_take(&completed, WAIT_TIME), 0, "Transfer not completed");
+	zassert_equal(last_code, COAP_RESPONSE_CODE_CONTENT, "Unexpected response %d",
+		      last_code);
+	zassert_false(big_error, "Blocks delivered out of order or corrupted");
+	zassert_equal(big_received, BIG_SIZE, "Received %zu bytes", big_received);
+	zassert_equal(big_blocks, DIV_ROUND_UP(BIG_SIZE, BLOCK_SIZE),
+		      "Received %d blocks", big_blocks);
+}
+
+ZTEST(coap_client_loopback, test_cocoa_rto)
+{
+	int ret;
+
+	/* Each exchange without retransmission moves the estimate halfway
+	 * towards the measured round-trip time.
+	 */
+	for (int i = 0; i < 8; i++) {
+		ret = send_get("fast", response_cb);
+		zassert_equal(ret, 0, "Request %d failed (%d)", i, ret);
+
+		zassert_equal(k_sem_take(&completed, WAIT_TIME), 0,
+			      "Request %d not completed", i);
+	}
+
+	zassert_true(client.rto < CONFIG_COAP_INIT_ACK_TIMEOUT_MS / 8,
+		     "RTO %u ms was not estimated from the round-trip time", client.rto);
+}
+
+static void *coap_client_loopback_setup(void)
+{
+	struct sockaddr_in *addr = (struct sockaddr_in *)&server_addr;
+	int ret;
+
+	for (int i = 0; i < BIG_SIZE; i++) {
+		big_payload[i] = i % 251;
+	}
+
+	k_sem_init(&completed, 0, NUM_SLOW_REQUESTS);
+
+	addr->sin_family = AF_INET;
+	addr->sin_port = htons(SERVER_PORT);
+	zsock_inet_pton(AF_INET, "127.0.0.1", &addr->sin_addr);
+
+	server_sock = zsock_socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+	zassert_true(server_sock >= 0, "Cannot create server socket");
+
+	ret = zsock_bind(server_sock, &server_addr, sizeof(struct sockaddr_in));
+	zassert_equal(ret, 0, "Cannot bind server socket (%d)", errno);
+
+	client_sock = zsock_socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+	zassert_true(client_sock >= 0, "Cannot create client socket");
+
+	ret = coap_client_init(&client, NULL);
+	zassert_equal(ret, 0, "Cannot initialize client (%d)", ret);
+
+	k_thread_start(coap_server_thread_id);
+
+	return NULL;
+}
+
+ZTEST_SUITE(coap_client_loopback, NULL, coap_client_loopback_setup, NULL, NULL, NULL);
@@ -0,0 +1,336 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(net_test, CONFIG_DNS_RESOLVER_LOG_LEVEL);
+
+#include <errno.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/ztest.h>
+#include <zephyr/net/socket.h>
+#include <zephyr/net/dns_resolve.h>
+
+#define SERVER_PORT 15353
+#define STACK_SIZE 1024
+#define THREAD_PRIORITY K_PRIO_COOP(2)
+
+#define DNS_TIMEOUT 500 /* ms */
+#define WAIT_TIME K_MSEC(DNS_TIMEOUT + 300)
+
+#define DNS_HDR_LEN 12
+#define MAX_BUF_SIZE 256
+
+/* The stand-in server answers every name with this address, except
+ * names starting with "nx." that do not exist, names starting with
+ * "nodata." that exist but have no address, and names starting with
+ * "short." that are given a TTL of one second.
+ */
+static const uint8_t server_answer[] = { 192, 0, 2, 10 };
+#define LONG_TTL 60
+#define SHORT_TTL 1
+
+static uint8_t server_buf[MAX_BUF_SIZE];
+static atomic_t queries_received;
+static int server_sock;
+
+static struct k_sem wait_result;
+static int result_status;
+static int result_count;
+static struct sockaddr_in result_addr;
+
+static bool label_is(const uint8_t *qname, const char *label)
+{
+	size_t len = strlen(label);
+
+	return qname[0] == len && memcmp(&qname[1], label, len) == 0;
+}
+
+/* Build the answer into the query buffer and return its length */
+static int create_answer(uint8_t *buf, int len)
+{
+	const uint8_t *qname = &buf[DNS_HDR_LEN];
+	uint32_t ttl = LONG_TTL;
+	int pos = DNS_HDR_LEN;
+
+	while (pos < len && buf[pos] != 0U) {
+		pos += buf[pos] + 1;
+	}
+
+	/* The terminating label, QTYPE and QCLASS */
+	pos += 1 + 2 + 2;
+	if (pos > len) {
+		return -EINVAL;
+	}
+
+	buf[2] = 0x81; /* QR and RD */
+	buf[3] = 0x80; /* RA */
+	sys_put_be16(0, &buf[6]); /* ANCOUNT */
+	sys_put_be16(0, &buf[8]); /* NSCOUNT */
+	sys_put_be16(0, &buf[10]); /* ARCOUNT */
+
+	if (label_is(qname, "nx")) {
+		buf[3] |= 3; /* NXDOMAIN */
+		return pos;
+	}
+
+	if (label_is(qname, "nodata")) {
+		return pos;
+	}
+
+	if (label_is(qname, "short")) {
+		ttl = SHORT_TTL;
+	}
+
+	if (pos + 16 > MAX_BUF_SIZE) {
+		return -ENOMEM;
+	}
+
+	sys_put_be16(1, &buf[6]);
+
+	/* Pointer to the name in the question */
+	sys_put_be16(0xc000 | DNS_HDR_LEN, &buf[pos]);
+	sys_put_be16(1, &buf[pos + 2]); /* A */
+	sys_put_be16(1, &buf[pos + 4]); /* IN */
+	sys_put_be32(ttl, &buf[pos + 6]);
+	sys_put_be16(sizeof(server_answer), &buf[pos + 10]);
+	memcpy(&buf[pos + 12], server_answer, sizeof(server_answer));
+
+	return pos + 12 + sizeof(server_answer);
+}
+
+static void dns_server(void)
+{
+	struct sockaddr_in client;
+	socklen_t client_len;
+	int len;
+
+	while (true) {
+		client_len = sizeof(client);
+
+		len = zsock_recvfrom(server_sock, server_buf, sizeof(server_buf),
+				     0, (struct sockaddr *)&client,
+				     &client_len);
+		if (len < DNS_HDR_LEN) {
+			continue;
+		}
+
+		atomic_inc(&queries_received);
+
+		len = create_answer(server_buf, len);
+		if (len < 0) {
+			continue;
+		}
+
+		(void)zsock_sendto(server_sock, server_buf, len, 0,
+				   (struct sockaddr *)&client, client_len);
+	}
+}
+
+K_THREAD_DEFINE(dns_server_thread_id, STACK_SIZE,
+		dns_server, NULL, NULL, NULL,
+		THREAD_PRIORITY, 0, -1);
+
+static void result_cb(enum dns_resolve_status status,
+		      struct dns_addrinfo *info,
+		      void *user_data)
+{
+	ARG_UNUSED(user_data);
+
+	if (status == DNS_EAI_INPROGRESS) {
+		memcpy(&result_addr, &info->ai_addr, sizeof(result_addr));
+		result_count++;
+		return;
+	}
+
+	result_status = status;
+	k_sem_give(&wait_result);
+}
+
+/* Resolve the name and return the number of queries the server got */
+static int resolve(const char *name, int expected_status)
+{
+	atomic_val_t before = atomic_get(&queries_received);
+	int ret;
+
+	result_status = 0;
+	result_count = 0;
+	memset(&result_addr, 0, sizeof(result_addr));
+
+	ret = dns_get_addr_info(name, DNS_QUERY_TYPE_A, NULL, result_cb,
+				NULL, DNS_TIMEOUT);
+	zassert_equal(ret, 0, "Cannot resolve %s (%d)", name, ret);
+
+	zassert_equal(k_sem_take(&wait_result, WAIT_TIME), 0,
+		      "No result for %s", name);
+	zassert_equal(result_status, expected_status,
+		      "Unexpected status %d for %s", result_status, name);
+
+	if (expected_status == DNS_EAI_ALLDONE) {
+		zassert_equal(result_count, 1, "Unexpected address count");
+		zassert_mem_equal(&result_addr.sin_addr, server_answer,
+				  sizeof(server_answer), "Wrong address");
+	}
+
+	return atomic_get(&queries_received) - before;
+}
+
+ZTEST(dns_cache, test_cache_hit)
+{
+	struct dns_cache_stats before, after;
+
+	dns_cache_stats_get(&before);
+
+	zassert_equal(resolve("host.zephyr.test", DNS_EAI_ALLDONE), 1,
+		      "First query was not sent to the server");
+	zassert_equal(resolve("host.zephyr.test", DNS_EAI_ALLDONE), 0,
+		      "Second query was sent to the server");
+	zassert_equal(resolve("HOST.Zephyr.Test", DNS_EAI_ALLDONE), 0,
+		      "Names must be compared case insensitively");
+
+	dns_cache_stats_get(&after);
+
+	zassert_equal(after.hits - before.hits, 2, "Wrong hit count");
+	zassert_equal(after.misses - before.misses, 1, "Wrong miss count");
+	zassert_equal(after.entries, 1, "Wrong entry count");
+}
+
+ZTEST(dns_cache, test_cache_ttl_expiry)
+{
+	zassert_equal(resolve("short.zephyr.test", DNS_EAI_ALLDONE), 1,
+		      "First query was not sent to the server");
+	zassert_equal(resolve("short.zephyr.test", DNS_EAI_ALLDONE), 0,
+		      "Query was sent before the TTL expired");
+
+	k_msleep(SHORT_TTL * MSEC_PER_SEC + 100);
+
+	zassert_equal(resolve("short.zephyr.test", DNS_EAI_ALLDONE), 1,
+		      "Expired answer was used");
+}
+
+ZTEST(dns_cache, test_cache_negative)
+{
+	struct dns_cache_stats before, after;
+
+	dns_cache_stats_get(&before);
+
+	zassert_equal(resolve("nx.zephyr.test", DNS_EAI_NONAME), 1,
+		      "First query was not sent to the server");
+	zassert_equal(resolve("nx.zephyr.test", DNS_EAI_NONAME), 0,
+		      "Negative answer was not cached");
+
+	dns_cache_stats_get(&after);
+
+	zassert_equal(after.negative_hits - before.negative_hits, 1,
+		      "Wrong negative hit count");
+}
+
+ZTEST(dns_cache, test_cache_nodata)
+{
+	struct dns_cache_stats before, after;
+
+	dns_cache_stats_get(&before);
+
+	zassert_equal(resolve("nodata.zephyr.test", DNS_EAI_NODATA), 1,
+		      "First query was not sent to the server");
+	zassert_equal(resolve("nodata.zephyr.test", DNS_EAI_NODATA), 0,
+		      "Empty answer was not cached");
+
+	dns_cache_stats_get(&after);
+
+	zassert_equal(after.negative_hits - before.negative_hits, 1,
+		      "Wrong negative hit count");
+}
+
+ZTEST(dns_cache, test_cache_lru)
+{
+	struct dns_cache_stats before, after;
+
+	BUILD_ASSERT(CONFIG_DNS_RESOLVER_CACHE_MAX_ENTRIES == 3);
+
+	dns_cache_stats_get(&before);
+
+	zassert_equal(resolve("a.zephyr.test", DNS_EAI_ALLDONE), 1, "a");
+	zassert_equal(resolve("b.zephyr.test", DNS_EAI_ALLDONE), 1, "b");
+	zassert_equal(resolve("c.zephyr.test", DNS_EAI_ALLDONE), 1, "c");
+
+	/* Make "a" the most recently used, so that "b" is evicted next */
+	zassert_equal(resolve("a.zephyr.test", DNS_EAI_ALLDONE), 0, "a hit");
+	zassert_equal(resolve("d.zephyr.test", DNS_EAI_ALLDONE), 1, "d");
+
+	zassert_equal(resolve("a.zephyr.test", DNS_EAI_ALLDONE), 0,
+		      "Recently used answer was evicted");
+	zassert_equal(resolve("c.zephyr.test", DNS_EAI_ALLDONE), 0,
+		      "Wrong answer was evicted");
+	zassert_equal(resolve("b.zephyr.test", DNS_EAI_ALLDONE), 1,
+		      "Least recently used answer was not evicted");
+
+	dns_cache_stats_get(&after);
+
+	zassert_equal(after.evictions - before.evictions, 2,
+		      "Wrong eviction count");
+	zassert_equal(after.entries, CONFIG_DNS_RESOLVER_CACHE_MAX_ENTRIES,
+		      "Wrong entry count");
+}
+
+static void count_entries(const struct dns_cache_info *info, void *user_data)
+{
+	int *count = user_data;
+
+	zassert_equal(info->query_type, DNS_QUERY_TYPE_A, "Wrong type");
+	zassert_true(info->ttl > 0 && info->ttl <= LONG_TTL, "Wrong TTL");
+
+	(*count)++;
+}
+
+ZTEST(dns_cache, test_cache_flush)
+{
+	int count = 0;
+
+	zassert_equal(resolve("host.zephyr.test", DNS_EAI_ALLDONE), 1,
+		      "First query was not sent to the server");
+
+	dns_cache_foreach(count_entries, &count);
+	zassert_equal(count, 1, "Wrong number of entries");
+
+	dns_cache_flush();
+
+	count = 0;
+	dns_cache_foreach(count_entries, &count);
+	zassert_equal(count, 0, "Cache was not flushed");
+
+	zassert_equal(resolve("host.zephyr.test", DNS_EAI_ALLDONE), 1,
+		      "Flushed answer was used");
+}
+
+static void *dns_cache_setup(void)
+{
+	struct sockaddr_in addr = {
+		.sin_family = AF_INET,
+		.sin_port = htons(SERVER_PORT),
+		.sin_addr = INADDR_LOOPBACK_INIT,
+	};
+	int ret;
+
+	k_sem_init(&wait_result, 0, 1);
+
+	server_sock = zsock_socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+	zassert_true(server_sock >= 0, "Cannot create server socket");
+
+	ret = zsock_bind(server_sock, (struct sockaddr *)&addr, sizeof(addr));
+	zassert_equal(ret, 0, "Cannot bind server socket (%d)", errno);
+
+	k_thread_start(dns_server_thread_id);
+
+	return NULL;
+}
+
+static void dns_cache_before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	dns_cache_flush();
+}
+
+ZTEST_SUITE(dns_cache, NULL, dns_cache_setup, dns_cache_before, NULL, NULL);
@@ -0,0 +1,328 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <errno.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <zephyr/net/socket.h>
+#include <zephyr/net/http/server.h>
+#include <zephyr/net/http/service.h>
+
+#define RECV_TIMEOUT_MS 2000
+#define RESPONSE_BUF_SIZE 4096
+
+/* Larger than the chunk size and the TCP window, so that the response
+ * cannot be sent at once.
+ */
+#define LARGE_LEN 2500
+
+static uint16_t test_port;
+HTTP_SERVICE_DEFINE(test_service, "127.0.0.1", &test_port, 2, 2, NULL);
+
+static const char index_html[] = "<html>Zephyr</html>";
+
+static struct http_resource_detail_static index_detail = {
+	.common = {
+		.bitmask_of_supported_http_methods = BIT(HTTP_GET) | BIT(HTTP_HEAD),
+		.type = HTTP_RESOURCE_TYPE_STATIC,
+		.content_type = "text/html",
+	},
+	.static_data = index_html,
+	.static_data_len = sizeof(index_html) - 1,
+};
+
+HTTP_RESOURCE_DEFINE(index_resource, test_service, "/", &index_detail);
+
+static uint8_t large_data[LARGE_LEN];
+
+static struct http_resource_detail_static large_detail = {
+	.common = {
+		.bitmask_of_supported_http_methods = BIT(HTTP_GET),
+		.type = HTTP_RESOURCE_TYPE_STATIC,
+	},
+	.static_data = large_data,
+	.static_data_len = sizeof(large_data),
+};
+
+HTTP_RESOURCE_DEFINE(large_resource, test_service, "/large", &large_detail);
+
+/* Counts from 0 to 9, in parts of at most four bytes */
+static int counter_cb(const struct http_server_request *req, size_t offset,
+		      uint8_t *buf, size_t len, void *user_data)
+{
+	static const char digits[] = "0123456789";
+	size_t remaining = sizeof(digits) - 1 - offset;
+
+	ARG_UNUSED(user_data);
+
+	/* Run by the server thread, a wrong request makes the test fail by
+	 * closing the connection.
+	 */
+	if (req->method != HTTP_GET || strcmp(req->url, "/counter") != 0) {
+		return -EINVAL;
+	}
+
+	len = MIN(MIN(len, remaining), 4);
+	memcpy(buf, &digits[offset], len);
+
+	return len;
+}
+
+static struct http_resource_detail_dynamic counter_detail = {
+	.common = {
+		.bitmask_of_supported_http_methods = BIT(HTTP_GET),
+		.type = HTTP_RESOURCE_TYPE_DYNAMIC,
+		.content_type = "text/plain",
+	},
+	.cb = counter_cb,
+};
+
+HTTP_RESOURCE_DEFINE(counter_resource, test_service, "/counter", &counter_detail);
+
+#define INDEX_RESPONSE                                                         \
+	"HTTP/1.1 200 OK\r\n"                                                  \
+	"Content-Type: text/html\r\n"                                          \
+	"Content-Length: 19\r\n"                                               \
+	"\r\n"                                                                 \
+	"<html>Zephyr</html>"
+
+#define INDEX_RESPONSE_CLOSE                                                   \
+	"HTTP/1.1 200 OK\r\n"                                                  \
+	"Content-Type: text/html\r\n"                                          \
+	"Content-Length: 19\r\n"                                               \
+	"Connection: close\r\n"                                                \
+	"\r\n"                                                                 \
+	"<html>Zephyr</html>"
+
+#define LARGE_HEADER "HTTP/1.1 200 OK\r\nContent-Length: 2500\r\n\r\n"
+
+#define CLOSE_REQUEST "GET / HTTP/1.1\r\nConnection: close\r\n\r\n"
+
+static char response[RESPONSE_BUF_SIZE];
+
+static int client_connect(void)
+{
+	struct sockaddr addr;
+	struct sockaddr_in *addr4 = (struct sockaddr_in *)&addr;
+	struct timeval timeout = {
+		.tv_sec = RECV_TIMEOUT_MS / MSEC_PER_SEC,
+	};
+	int ret;
+	int fd;
+
+	memset(&addr, 0, sizeof(addr));
+	addr4->sin_family = AF_INET;
+	addr4->sin_port = htons(test_port);
+	zsock_inet_pton(AF_INET, "127.0.0.1", &addr4->sin_addr);
+
+	fd = zsock_socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	zassert_true(fd >= 0, "Cannot create client socket (%d)", errno);
+
+	ret = zsock_setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout,
+			       sizeof(timeout));
+	zassert_equal(ret, 0, "Cannot set receive timeout (%d)", errno);
+
+	ret = zsock_connect(fd, &addr, sizeof(struct sockaddr_in));
+	zassert_equal(ret, 0, "Cannot connect (%d)", errno);
+
+	return fd;
+}
+
+static void client_send(int fd, const char *request)
+{
+	size_t len = strlen(request);
+	ssize_t sent;
+
+	while (len > 0) {
+		sent = zsock_send(fd, request, len, 0);
+		zassert_true(sent > 0, "Cannot send request (%d)", errno);
+
+		request += sent;
+		len -= sent;
+	}
+}
+
+/* Receive until @p len bytes arrived, or until the server closes the
+ * connection if @p len is 0.
+ */
+static size_t client_recv(int fd, size_t len)
+{
+	size_t received = 0;
+	ssize_t ret;
+
+	while (len == 0 || received < len) {
+		ret = zsock_recv(fd, &response[received],
+				 sizeof(response) - 1 - received, 0);
+		zassert_true(ret >= 0, "Cannot receive response (%d)", errno);
+
+		if (ret == 0) {
+			break;
+		}
+
+		received += ret;
+	}
+
+	response[received] = '\0';
+
+	return received;
+}
+
+static void expect_response(const char *request, const char *expected)
+{
+	int fd = client_connect();
+
+	client_send(fd, request);
+	client_recv(fd, 0);
+
+	zassert_equal(strcmp(response, expected), 0,
+		      "Unexpected response:\n%s", response);
+
+	zsock_close(fd);
+}
+
+ZTEST(http_server, test_static)
+{
+	expect_response(CLOSE_REQUEST, INDEX_RESPONSE_CLOSE);
+}
+
+ZTEST(http_server, test_keep_alive)
+{
+	int fd = client_connect();
+	int i;
+
+	for (i = 0; i < 3; i++) {
+		client_send(fd, "GET / HTTP/1.1\r\n\r\n");
+		client_recv(fd, sizeof(INDEX_RESPONSE) - 1);
+
+		zassert_equal(strcmp(response, INDEX_RESPONSE), 0,
+			      "Unexpected response:\n%s", response);
+	}
+
+	client_send(fd, CLOSE_REQUEST);
+	client_recv(fd, 0);
+
+	zassert_equal(strcmp(response, INDEX_RESPONSE_CLOSE), 0,
+		      "Unexpected response:\n%s", response);
+
+	zsock_close(fd);
+}
+
+ZTEST(http_server, test_pipelining)
+{
+	/* The POST body must be skipped to find the next request */
+	expect_response("GET / HTTP/1.1\r\n\r\n"
+			"HEAD / HTTP/1.1\r\n\r\n"
+			"GET /missing HTTP/1.1\r\n\r\n"
+			"POST / HTTP/1.1\r\nContent-Length: 4\r\n\r\nbody"
+			CLOSE_REQUEST,
+			INDEX_RESPONSE
+			"HTTP/1.1 200 OK\r\n"
+			"Content-Type: text/html\r\n"
+			"Content-Length: 19\r\n"
+			"\r\n"
+			"HTTP/1.1 404 Not Found\r\n"
+			"Content-Length: 0\r\n"
+			"\r\n"
+			"HTTP/1.1 405 Method Not Allowed\r\n"
+			"Content-Length: 0\r\n"
+			"\r\n"
+			INDEX_RESPONSE_CLOSE);
+}
+
+ZTEST(http_server, test_chunked)
+{
+	expect_response("GET /counter HTTP/1.1\r\n\r\n" CLOSE_REQUEST,
+			"HTTP/1.1 200 OK\r\n"
+			"Content-Type: text/plain\r\n"
+			"Transfer-Encoding: chunked\r\n"
+			"\r\n"
+			"0004\r\n0123\r\n"
+			"0004\r\n4567\r\n"
+			"0002\r\n89\r\n"
+			"0\r\n\r\n"
+			INDEX_RESPONSE_CLOSE);
+}
+
+ZTEST(http_server, test_http_1_0)
+{
+	/* Without chunked transfer coding, the end of the content is marked
+	 * by closing the connection.
+	 */
+	expect_response("GET /counter?x=1 HTTP/1.0\r\n\r\n",
+			"HTTP/1.1 200 OK\r\n"
+			"Content-Type: text/plain\r\n"
+			"Connection: close\r\n"
+			"\r\n"
+			"0123456789");
+}
+
+ZTEST(http_server, test_large)
+{
+	int fd = client_connect();
+	size_t header_len;
+	size_t len;
+	char *body;
+
+	client_send(fd, "GET /large HTTP/1.1\r\n\r\n" CLOSE_REQUEST);
+	len = client_recv(fd, 0);
+
+	body = strstr(response, "\r\n\r\n");
+	zassert_not_null(body, "No header");
+	body += 4;
+	header_len = body - response;
+
+	zassert_equal(header_len, strlen(LARGE_HEADER), "Unexpected header");
+	zassert_equal(strncmp(response, LARGE_HEADER, header_len), 0,
+		      "Unexpected header:\n%s", response);
+	zassert_true(len >= header_len + LARGE_LEN, "Response too short");
+	zassert_mem_equal(body, large_data, LARGE_LEN, "Wrong content");
+	zassert_equal(strcmp(&body[LARGE_LEN], INDEX_RESPONSE_CLOSE), 0,
+		      "Pipelined response lost");
+
+	zsock_close(fd);
+}
+
+ZTEST(http_server, test_errors)
+{
+	expect_response("GET /this/url/is/too/long/for/the/server HTTP/1.1\r\n\r\n"
+			CLOSE_REQUEST,
+			"HTTP/1.1 414 URI Too Long\r\n"
+			"Content-Length: 0\r\n"
+			"\r\n"
+			INDEX_RESPONSE_CLOSE);
+
+	expect_response("NOT HTTP\r\n\r\n",
+			"HTTP/1.1 400 Bad Request\r\n"
+			"Content-Length: 0\r\n"
+			"Connection: close\r\n"
+			"\r\n");
+}
+
+static void *http_server_setup(void)
+{
+	int i;
+
+	for (i = 0; i < LARGE_LEN; i++) {
+		large_data[i] = 'a' + i % 26;
+	}
+
+	zassert_equal(http_server_start(), 0, "Cannot start the server");
+	zassert_not_equal(test_port, 0, "No ephemeral port assigned");
+
+	zassert_equal(http_server_start(), -EALREADY, "Server started twice");
+
+	return NULL;
+}
+
+static void http_server_teardown(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	zassert_equal(http_server_stop(), 0, "Cannot stop the server");
+}
+
+ZTEST_SUITE(http_server, NULL, http_server_setup, NULL, NULL,
+	    http_server_teardown);
@@ -955,6 +955,60 @@ ZTEST(net_content_senml_cbor_nomem, test_put_time_nomem)
 	zassert_equal(ret, -ENOMEM, "Invalid error code returned");
 }
 
+ZTEST(net_content_senml_cbor, test_put_composite)
+{
+	int ret;
+	struct lwm2m_obj_path_list path_list_buf[2];
+	sys_slist_t path_list;
+	sys_slist_t path_free_list;
+	struct lwm2m_obj_path paths[] = {
+		LWM2M_OBJ(TEST_OBJ_ID, TEST_OBJ_INST_ID, TEST_RES_S8),
+		LWM2M_OBJ(TEST_OBJ_ID, TEST_OBJ_INST_ID, TEST_RES_BOOL),
+	};
+	/* The second record shares the basename of the first one */
+	struct test_payload_buffer expected_payload = {
+		.data = {
+			(0x04 << 5) | 2,
+			(0x05 << 5) | 3,
+			(0x01 << 5) | 1,
+			(0x03 << 5) | 9,
+			'/', '6', '5', '5', '3', '5', '/', '0', '/',
+			(0x00 << 5) | 0,
+			(0x03 << 5) | 1,
+			'0',
+			(0x00 << 5) | 2,
+			(0x00 << 5) | 1,
+			(0x05 << 5) | 2,
+			(0x00 << 5) | 0,
+			(0x03 << 5) | 1,
+			'6',
+			(0x00 << 5) | 4,
+			(0x07 << 5) | 21,
+		},
+		.len = 24
+	};
+
+	lwm2m_engine_path_list_init(&path_list, &path_free_list, path_list_buf,
+				    ARRAY_SIZE(path_list_buf));
+
+	for (int i = 0; i < ARRAY_SIZE(paths); i++) {
+		ret = lwm2m_engine_add_path_to_list(&path_list, &path_free_list, &paths[i]);
+		zassert_equal(ret, 0, "Cannot add path");
+	}
+
+	test_s8 = 1;
+	test_bool = true;
+
+	ret = do_composite_read_op_for_parsed_path_senml_cbor(&test_msg, &path_list);
+	zassert_true(ret >= 0, "Error reported");
+
+	zassert_mem_equal(test_msg.msg_data + TEST_PAYLOAD_OFFSET,
+			  expected_payload.data, expected_payload.len,
+			  "Invalid payload format");
+	zassert_equal(test_msg.cpkt.offset, expected_payload.len + TEST_PAYLOAD_OFFSET,
+		      "Invalid packet offset");
+}
+
 ZTEST(net_content_senml_cbor, test_get_s32)
 {
 	int ret;
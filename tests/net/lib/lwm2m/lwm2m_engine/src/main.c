@@ -213,12 +213,15 @@ ZTEST(lwm2m_engine, test_check_notifications)
 	ctx.remote_addr.sa_family = AF_INET;
 	sys_slist_init(&ctx.observer);
 
+	(void)memset(&obs, 0x0, sizeof(obs));
+
+	obs.ctx = &ctx;
 	obs.last_timestamp = k_uptime_get();
-	obs.event_timestamp = k_uptime_get() + 1000U;
 	obs.resource_update = false;
 	obs.active_tx_operation = false;
 
 	sys_slist_append(&ctx.observer, &obs.node);
+	lwm2m_engine_observe_schedule(&obs, k_uptime_get() + 1000U);
 
 	lwm2m_rd_client_is_registred_fake.return_val = true;
 	ret = lwm2m_engine_start(&ctx);
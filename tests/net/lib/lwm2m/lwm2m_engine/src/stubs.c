@@ -104,7 +104,10 @@ ssize_t z_impl_zsock_recvfrom(int sock, void *buf, size_t max_len, int flags,
 
 int z_impl_zsock_poll(struct zsock_pollfd *fds, int nfds, int poll_timeout)
 {
-	k_sleep(K_MSEC(poll_timeout));
+	/* Like a real socket, do not wait if the event is already there */
+	if (!(fds->events & my_events & (ZSOCK_POLLIN | ZSOCK_POLLOUT))) {
+		k_sleep(K_MSEC(poll_timeout));
+	}
 	fds->revents = my_events;
 	return 0;
 }
@@ -0,0 +1,146 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "lwm2m_engine.h"
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+
+#define BATCH_SIZE CONFIG_LWM2M_COMPOSITE_PATH_LIST_SIZE
+
+/* The context is never registered, so every Send operation fails with
+ * -EPERM. This checks which paths stay queued after a failed flush.
+ */
+static struct lwm2m_ctx ctx;
+
+static void assert_batch(const struct lwm2m_obj_path *paths, int count)
+{
+	int i;
+
+	zassert_equal(ctx.send_batch_len, count, "Invalid number of queued paths (%u)",
+		      ctx.send_batch_len);
+
+	for (i = 0; i < count; i++) {
+		zassert_mem_equal(&ctx.send_batch[i], &paths[i], sizeof(paths[i]),
+				  "Invalid queued path %d", i);
+	}
+}
+
+ZTEST(lwm2m_send_batch, test_dedupe)
+{
+	const struct lwm2m_obj_path paths[] = {
+		LWM2M_OBJ(3303, 0, 5700), LWM2M_OBJ(3304, 0, 5700), LWM2M_OBJ(3303, 0, 5700),
+	};
+	int ret;
+
+	ret = lwm2m_send_batch(&ctx, paths, ARRAY_SIZE(paths));
+	zassert_equal(ret, 0, "Cannot queue paths (%d)", ret);
+	assert_batch(paths, 2);
+
+	ret = lwm2m_send_batch(&ctx, &paths[1], 1);
+	zassert_equal(ret, 0, "Cannot queue path (%d)", ret);
+	assert_batch(paths, 2);
+}
+
+ZTEST(lwm2m_send_batch, test_flush_empty)
+{
+	int ret;
+
+	ret = lwm2m_send_batch_flush(&ctx, NULL);
+	zassert_equal(ret, -ENODATA, "Empty batch sent (%d)", ret);
+}
+
+ZTEST(lwm2m_send_batch, test_flush_failure_keeps_paths)
+{
+	const struct lwm2m_obj_path paths[] = {
+		LWM2M_OBJ(3303, 0, 5700), LWM2M_OBJ(3304, 0, 5700),
+	};
+	int ret;
+
+	ret = lwm2m_send_batch(&ctx, paths, ARRAY_SIZE(paths));
+	zassert_equal(ret, 0, "Cannot queue paths (%d)", ret);
+
+	ret = lwm2m_send_batch_flush(&ctx, NULL);
+	zassert_equal(ret, -EPERM, "Batch sent (%d)", ret);
+	assert_batch(paths, ARRAY_SIZE(paths));
+
+	/* The paths are sent with the next batch */
+	ret = lwm2m_send_batch_flush(&ctx, NULL);
+	zassert_equal(ret, -EPERM, "Batch sent (%d)", ret);
+	assert_batch(paths, ARRAY_SIZE(paths));
+}
+
+ZTEST(lwm2m_send_batch, test_flush_full)
+{
+	struct lwm2m_obj_path paths[BATCH_SIZE + 1];
+	int ret;
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(paths); i++) {
+		paths[i] = LWM2M_OBJ(3303, i, 5700);
+	}
+
+	ret = lwm2m_send_batch(&ctx, paths, BATCH_SIZE);
+	zassert_equal(ret, 0, "Cannot queue paths (%d)", ret);
+	assert_batch(paths, BATCH_SIZE);
+
+	/* A path already queued does not need room */
+	ret = lwm2m_send_batch(&ctx, paths, 1);
+	zassert_equal(ret, 0, "Cannot queue path (%d)", ret);
+	assert_batch(paths, BATCH_SIZE);
+
+	/* A new path makes the queue flush, which fails */
+	ret = lwm2m_send_batch(&ctx, &paths[BATCH_SIZE], 1);
+	zassert_equal(ret, -EPERM, "Full batch sent (%d)", ret);
+	assert_batch(paths, BATCH_SIZE);
+}
+
+ZTEST(lwm2m_send_batch, test_delayed_flush)
+{
+	const struct lwm2m_obj_path paths[] = {
+		LWM2M_OBJ(3303, 0, 5700), LWM2M_OBJ(3304, 0, 5700),
+	};
+	int ret;
+
+	ret = lwm2m_send_batch(&ctx, paths, 1);
+	zassert_equal(ret, 0, "Cannot queue path (%d)", ret);
+	zassert_true(k_work_delayable_is_pending(&ctx.send_batch_work), "Flush not scheduled");
+
+	k_sleep(K_MSEC(CONFIG_LWM2M_SEND_BATCH_DELAY_MS / 2));
+
+	/* The delay runs from the first queued path */
+	ret = lwm2m_send_batch(&ctx, &paths[1], 1);
+	zassert_equal(ret, 0, "Cannot queue path (%d)", ret);
+
+	k_sleep(K_MSEC(CONFIG_LWM2M_SEND_BATCH_DELAY_MS / 2 + 30));
+
+	zassert_false(k_work_delayable_is_pending(&ctx.send_batch_work), "Flush not done");
+	assert_batch(paths, ARRAY_SIZE(paths));
+
+	/* The paths left by the failed flush are sent with the next batch */
+	ret = lwm2m_send_batch(&ctx, paths, 1);
+	zassert_equal(ret, 0, "Cannot queue path (%d)", ret);
+	zassert_true(k_work_delayable_is_pending(&ctx.send_batch_work), "Flush not scheduled");
+	assert_batch(paths, ARRAY_SIZE(paths));
+}
+
+static void lwm2m_send_batch_before(void *f)
+{
+	ARG_UNUSED(f);
+
+	(void)memset(&ctx, 0, sizeof(ctx));
+	lwm2m_engine_context_init(&ctx);
+}
+
+static void lwm2m_send_batch_after(void *f)
+{
+	struct k_work_sync sync;
+
+	ARG_UNUSED(f);
+
+	(void)k_work_cancel_delayable_sync(&ctx.send_batch_work, &sync);
+}
+
+ZTEST_SUITE(lwm2m_send_batch, NULL, NULL, lwm2m_send_batch_before, lwm2m_send_batch_after,
+	    NULL);
@@ -0,0 +1,496 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Checks the in-flight window of the MQTT client against a minimal broker
+ * over the loopback interface: the window limits the number of messages
+ * left unacknowledged, and these messages are retransmitted after a
+ * reconnection resuming the session, or dropped if the session is lost.
+ */
+
+#include <string.h>
+#include <errno.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <zephyr/net/socket.h>
+#include <zephyr/net/mqtt.h>
+
+#define WINDOW 8
+#define DROPPED_MESSAGES 4
+
+#define TIMEOUT_MS 5000
+
+#define BROKER_STACK_SIZE 1024
+#define BROKER_PRIORITY K_PRIO_PREEMPT(8)
+
+#define PKT_TYPE_CONNECT 0x10
+#define PKT_TYPE_PUBLISH 0x30
+#define PKT_TYPE_DISCONNECT 0xE0
+#define PKT_FLAG_DUP 0x08
+
+static const char topic[] = "sensors/inflight";
+static uint8_t payload[64];
+
+/* Broker stand-in, serving one connection after the other. */
+static struct broker {
+	int fd;
+	struct sockaddr_in addr;
+	int connections;
+	/* Close the first connection after this number of messages, without
+	 * acknowledging them. 0 to acknowledge all the messages.
+	 */
+	int drop_after;
+	/* Resume the session of the client on reconnection */
+	bool session_present;
+	int published;
+	int duplicates;
+	int error;
+	uint8_t buf[256];
+} broker;
+
+static struct k_thread broker_thread;
+static K_THREAD_STACK_DEFINE(broker_stack, BROKER_STACK_SIZE);
+
+static struct mqtt_client client;
+static struct mqtt_inflight inflight[WINDOW];
+static uint8_t rx_buf[128];
+static uint8_t tx_buf[128];
+static bool connected;
+static int dropped;
+static uint16_t dropped_ids[WINDOW];
+
+static int recv_all(int fd, uint8_t *buf, size_t len)
+{
+	ssize_t ret;
+
+	while (len > 0) {
+		ret = zsock_recv(fd, buf, len, 0);
+		if (ret <= 0) {
+			return ret < 0 ? -errno : -ECONNRESET;
+		}
+
+		buf += ret;
+		len -= ret;
+	}
+
+	return 0;
+}
+
+/* Read one MQTT packet, the body is stored in the broker buffer. */
+static int read_packet(int fd, uint8_t *type, size_t *len)
+{
+	uint8_t byte;
+	int shift = 0;
+	int ret;
+
+	ret = recv_all(fd, type, 1);
+	if (ret < 0) {
+		return ret;
+	}
+
+	*len = 0;
+
+	do {
+		ret = recv_all(fd, &byte, 1);
+		if (ret < 0) {
+			return ret;
+		}
+
+		*len |= (byte & 0x7F) << shift;
+		shift += 7;
+	} while ((byte & 0x80) && shift < 28);
+
+	if (*len > sizeof(broker.buf)) {
+		return -EMSGSIZE;
+	}
+
+	return recv_all(fd, broker.buf, *len);
+}
+
+static int broker_serve(int fd, bool drop)
+{
+	uint8_t connack[] = { 0x20, 0x02, 0x00, 0x00 };
+	uint8_t puback[] = { 0x40, 0x02, 0x00, 0x00 };
+	uint16_t topic_len;
+	uint8_t type;
+	size_t len;
+	int ret;
+
+	while (true) {
+		ret = read_packet(fd, &type, &len);
+		if (ret < 0) {
+			return ret == -ECONNRESET ? 0 : ret;
+		}
+
+		switch (type & 0xF0) {
+		case PKT_TYPE_CONNECT:
+			/* Session Present flag */
+			connack[2] = broker.session_present ? 0x01 : 0x00;
+
+			if (zsock_send(fd, connack, sizeof(connack), 0) < 0) {
+				return -errno;
+			}
+
+			break;
+
+		case PKT_TYPE_PUBLISH:
+			broker.published++;
+			if (type & PKT_FLAG_DUP) {
+				broker.duplicates++;
+			}
+
+			if (drop) {
+				if (broker.published == broker.drop_after) {
+					return 0;
+				}
+
+				break;
+			}
+
+			/* Message id following the topic */
+			topic_len = (broker.buf[0] << 8) | broker.buf[1];
+			if (len < topic_len + 4) {
+				return -EBADMSG;
+			}
+
+			puback[2] = broker.buf[topic_len + 2];
+			puback[3] = broker.buf[topic_len + 3];
+
+			if (zsock_send(fd, puback, sizeof(puback), 0) < 0) {
+				return -errno;
+			}
+
+			break;
+
+		case PKT_TYPE_DISCONNECT:
+			return 0;
+
+		default:
+			return -EBADMSG;
+		}
+	}
+}
+
+static void broker_run(void *p1, void *p2, void *p3)
+{
+	int i;
+	int fd;
+
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	for (i = 0; i < broker.connections && broker.error == 0; i++) {
+		fd = zsock_accept(broker.fd, NULL, NULL);
+		if (fd < 0) {
+			broker.error = -errno;
+			return;
+		}
+
+		broker.error = broker_serve(fd, i == 0 && broker.drop_after > 0);
+
+		zsock_close(fd);
+	}
+}
+
+static void broker_start(int connections, int drop_after)
+{
+	broker.connections = connections;
+	broker.drop_after = drop_after;
+	broker.session_present = false;
+	broker.published = 0;
+	broker.duplicates = 0;
+	broker.error = 0;
+
+	k_thread_create(&broker_thread, broker_stack,
+			K_THREAD_STACK_SIZEOF(broker_stack), broker_run, NULL,
+			NULL, NULL, BROKER_PRIORITY, 0, K_NO_WAIT);
+}
+
+static void broker_stop(void)
+{
+	k_thread_join(&broker_thread, K_FOREVER);
+	zassert_equal(broker.error, 0, "Broker failed (%d)", broker.error);
+}
+
+static void mqtt_evt_handler(struct mqtt_client *c, const struct mqtt_evt *evt)
+{
+	ARG_UNUSED(c);
+
+	switch (evt->type) {
+	case MQTT_EVT_CONNACK:
+		connected = (evt->result == 0);
+		break;
+
+	case MQTT_EVT_DISCONNECT:
+		connected = false;
+		break;
+
+	case MQTT_EVT_INFLIGHT_DROPPED:
+		zassert_false(connected, "Message dropped after CONNACK");
+		zassert_true(dropped < WINDOW, "Too many messages dropped");
+		dropped_ids[dropped++] = evt->param.inflight_dropped.message_id;
+		break;
+
+	default:
+		break;
+	}
+}
+
+/* Process the packets received from the broker within @p timeout_ms. */
+static void client_input(int timeout_ms)
+{
+	struct zsock_pollfd fds = {
+		.fd = client.transport.tcp.sock,
+		.events = ZSOCK_POLLIN,
+	};
+
+	if (zsock_poll(&fds, 1, timeout_ms) > 0) {
+		(void)mqtt_input(&client);
+	}
+}
+
+static void client_wait(bool *done, bool expected)
+{
+	int64_t deadline = k_uptime_get() + TIMEOUT_MS;
+
+	while (*done != expected) {
+		zassert_true(k_uptime_get() < deadline, "Timeout");
+		client_input(100);
+	}
+}
+
+static void client_wait_acks(void)
+{
+	int64_t deadline = k_uptime_get() + TIMEOUT_MS;
+
+	while (client.internal.inflight_count > 0) {
+		zassert_true(k_uptime_get() < deadline, "Acks lost");
+		client_input(100);
+	}
+}
+
+static void client_connect(void)
+{
+	zassert_equal(mqtt_connect(&client), 0, "Cannot connect");
+	client_wait(&connected, true);
+}
+
+static void client_init(int window)
+{
+	mqtt_client_init(&client);
+
+	client.broker = &broker.addr;
+	client.evt_cb = mqtt_evt_handler;
+	client.client_id.utf8 = (const uint8_t *)"inflight";
+	client.client_id.size = strlen("inflight");
+	client.rx_buf = rx_buf;
+	client.rx_buf_size = sizeof(rx_buf);
+	client.tx_buf = tx_buf;
+	client.tx_buf_size = sizeof(tx_buf);
+	client.inflight = inflight;
+	client.inflight_size = window;
+	client.transport.type = MQTT_TRANSPORT_NON_SECURE;
+}
+
+static int publish(uint16_t message_id, bool scatter)
+{
+	struct mqtt_publish_param param = {
+		.message.topic = {
+			.topic = {
+				.utf8 = (const uint8_t *)topic,
+				.size = sizeof(topic) - 1,
+			},
+			.qos = MQTT_QOS_1_AT_LEAST_ONCE,
+		},
+		.message.payload = {
+			.data = payload,
+			.len = sizeof(payload),
+		},
+		.message_id = message_id,
+	};
+	/* Header and body of the payload, kept until acknowledged */
+	static const struct iovec iov[] = {
+		{ .iov_base = payload, .iov_len = 8 },
+		{ .iov_base = &payload[8], .iov_len = sizeof(payload) - 8 },
+	};
+
+	if (scatter) {
+		return mqtt_publish_iov(&client, &param, iov, ARRAY_SIZE(iov));
+	}
+
+	return mqtt_publish(&client, &param);
+}
+
+ZTEST(mqtt_inflight, test_window_full)
+{
+	int ret;
+	int i;
+
+	/* The broker never acknowledges, nor closes the connection */
+	broker_start(1, WINDOW + 1);
+	client_init(WINDOW);
+	client_connect();
+
+	for (i = 0; i < WINDOW; i++) {
+		zassert_equal(publish(i + 1, i % 2), 0, "Cannot publish");
+	}
+
+	ret = publish(WINDOW + 1, false);
+	zassert_equal(ret, -EAGAIN, "Window not full (%d)", ret);
+	zassert_equal(client.internal.inflight_count, WINDOW,
+		      "Invalid number of messages in flight");
+
+	zassert_equal(mqtt_disconnect(&client), 0, "Cannot disconnect");
+	broker_stop();
+
+	zassert_equal(broker.published, WINDOW, "Invalid number of messages");
+}
+
+ZTEST(mqtt_inflight, test_payload_too_long)
+{
+	struct mqtt_publish_param param = {
+		.message.topic = {
+			.topic = {
+				.utf8 = (const uint8_t *)topic,
+				.size = sizeof(topic) - 1,
+			},
+			.qos = MQTT_QOS_1_AT_LEAST_ONCE,
+		},
+		.message_id = 1,
+	};
+	/* The sum of the lengths wraps around 32 bits */
+	const struct iovec iov[] = {
+		{ .iov_base = payload, .iov_len = 0x0FFFFFFF },
+		{ .iov_base = payload, .iov_len = 0xF0000001 },
+	};
+	const struct iovec too_long = {
+		.iov_base = payload, .iov_len = 0x10000000,
+	};
+	int ret;
+
+	broker_start(1, 0);
+	client_init(WINDOW);
+	client_connect();
+
+	ret = mqtt_publish_iov(&client, &param, iov, ARRAY_SIZE(iov));
+	zassert_equal(ret, -EMSGSIZE, "Payload accepted (%d)", ret);
+
+	ret = mqtt_publish_iov(&client, &param, &too_long, 1);
+	zassert_equal(ret, -EMSGSIZE, "Payload accepted (%d)", ret);
+	zassert_equal(client.internal.inflight_count, 0,
+		      "Message added to the window");
+
+	zassert_equal(mqtt_disconnect(&client), 0, "Cannot disconnect");
+	broker_stop();
+
+	zassert_equal(broker.published, 0, "Message sent");
+}
+
+ZTEST(mqtt_inflight, test_retransmission)
+{
+	int i;
+
+	broker_start(2, DROPPED_MESSAGES);
+	client_init(WINDOW);
+	client.clean_session = 0U;
+	client_connect();
+
+	broker.session_present = true;
+
+	for (i = 0; i < DROPPED_MESSAGES; i++) {
+		zassert_equal(publish(i + 1, i % 2), 0, "Cannot publish");
+	}
+
+	/* The broker closes the connection without acknowledging */
+	client_wait(&connected, false);
+	zassert_equal(client.internal.inflight_count, DROPPED_MESSAGES,
+		      "Messages not kept in the window");
+
+	/* The messages are sent again once the session is resumed */
+	client_connect();
+	client_wait_acks();
+
+	zassert_equal(mqtt_disconnect(&client), 0, "Cannot disconnect");
+	broker_stop();
+
+	zassert_equal(broker.published, 2 * DROPPED_MESSAGES,
+		      "Messages not retransmitted");
+	zassert_equal(broker.duplicates, DROPPED_MESSAGES,
+		      "Retransmitted messages not marked as duplicates");
+}
+
+ZTEST(mqtt_inflight, test_session_lost)
+{
+	int i;
+
+	broker_start(2, DROPPED_MESSAGES);
+	client_init(WINDOW);
+	client.clean_session = 0U;
+	client_connect();
+
+	for (i = 0; i < DROPPED_MESSAGES; i++) {
+		zassert_equal(publish(i + 1, i % 2), 0, "Cannot publish");
+	}
+
+	client_wait(&connected, false);
+
+	/* The broker does not resume the session, the messages are given
+	 * back to the application instead of being sent again.
+	 */
+	dropped = 0;
+	client_connect();
+
+	zassert_equal(dropped, DROPPED_MESSAGES, "Messages not dropped");
+	for (i = 0; i < DROPPED_MESSAGES; i++) {
+		zassert_equal(dropped_ids[i], i + 1, "Invalid message dropped");
+	}
+
+	zassert_equal(client.internal.inflight_count, 0,
+		      "Messages left in the window");
+
+	zassert_equal(mqtt_disconnect(&client), 0, "Cannot disconnect");
+	broker_stop();
+
+	zassert_equal(broker.published, DROPPED_MESSAGES,
+		      "Messages retransmitted");
+}
+
+static void *mqtt_inflight_setup(void)
+{
+	socklen_t addrlen = sizeof(broker.addr);
+	int i;
+
+	for (i = 0; i < sizeof(payload); i++) {
+		payload[i] = i;
+	}
+
+	broker.addr.sin_family = AF_INET;
+	zsock_inet_pton(AF_INET, "127.0.0.1", &broker.addr.sin_addr);
+
+	broker.fd = zsock_socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	zassert_true(broker.fd >= 0, "Cannot create broker socket (%d)", errno);
+
+	zassert_equal(zsock_bind(broker.fd, (struct sockaddr *)&broker.addr,
+				 sizeof(broker.addr)),
+		      0, "Cannot bind (%d)", errno);
+	zassert_equal(zsock_getsockname(broker.fd,
+					(struct sockaddr *)&broker.addr,
+					&addrlen),
+		      0, "Cannot get the broker port (%d)", errno);
+	zassert_equal(zsock_listen(broker.fd, 1), 0, "Cannot listen (%d)",
+		      errno);
+
+	return NULL;
+}
+
+static void mqtt_inflight_teardown(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	zsock_close(broker.fd);
+}
+
+ZTEST_SUITE(mqtt_inflight, NULL, mqtt_inflight_setup, NULL, NULL,
+	    mqtt_inflight_teardown);
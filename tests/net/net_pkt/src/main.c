@@ -232,6 +232,72 @@ ZTEST(net_pkt_test_suite, test_net_pkt_allocate_with_buffer)
 		     "Pkt not properly unreferenced");
 }
 
+ZTEST(net_pkt_test_suite, test_net_pkt_allocate_bulk)
+{
+	const size_t sizes[] = { 60, 512, 1800, 0 };
+	struct net_pkt *pkts[CONFIG_NET_PKT_TX_COUNT + 2];
+	size_t exhaust_sizes[ARRAY_SIZE(pkts)];
+	int allocated;
+	int i;
+
+	/* Each packet gets its own size, on the same family and protocol */
+	allocated = net_pkt_alloc_bulk_with_buffer(eth_if, pkts, sizes,
+						   ARRAY_SIZE(sizes), AF_INET,
+						   IPPROTO_UDP, K_NO_WAIT);
+	zassert_equal(allocated, ARRAY_SIZE(sizes), "Pkts not allocated");
+
+	zassert_true(pkt_is_of_size(pkts[0], 60 + NET_IPV4UDPH_LEN),
+		     "Pkt 0 size is not right");
+	zassert_true(pkt_is_of_size(pkts[1], 512 + NET_IPV4UDPH_LEN),
+		     "Pkt 1 size is not right");
+	zassert_true(net_pkt_available_buffer(pkts[2]) ==
+		     net_if_get_mtu(eth_if), "Pkt 2 size is not right");
+	zassert_true(pkt_is_of_size(pkts[3], NET_IPV4UDPH_LEN),
+		     "Pkt 3 size is not right");
+
+	for (i = 0; i < allocated; i++) {
+		zassert_equal(net_pkt_iface(pkts[i]), eth_if, "Wrong iface");
+		zassert_equal(net_pkt_family(pkts[i]), AF_INET, "Wrong family");
+	}
+
+	net_pkt_unref_bulk(pkts, allocated);
+
+	for (i = 0; i < allocated; i++) {
+		zassert_is_null(pkts[i], "Pkt %d not released", i);
+	}
+
+	/* Asking for more packets than the slab holds gives a partial
+	 * result instead of failing.
+	 */
+	for (i = 0; i < ARRAY_SIZE(exhaust_sizes); i++) {
+		exhaust_sizes[i] = 1;
+	}
+
+	allocated = net_pkt_alloc_bulk_with_buffer(eth_if, pkts, exhaust_sizes,
+						   ARRAY_SIZE(pkts), AF_UNSPEC,
+						   0, K_NO_WAIT);
+	zassert_true(allocated > 0, "No pkt allocated");
+	zassert_true(allocated <= CONFIG_NET_PKT_TX_COUNT,
+		     "More pkts than available");
+
+	for (i = 0; i < ARRAY_SIZE(pkts); i++) {
+		if (i < allocated) {
+			zassert_not_null(pkts[i], "Pkt %d not allocated", i);
+		} else {
+			zassert_is_null(pkts[i], "Pkt %d should be NULL", i);
+		}
+	}
+
+	net_pkt_unref_bulk(pkts, ARRAY_SIZE(pkts));
+
+	/* Everything went back to the slab */
+	allocated = net_pkt_alloc_bulk_with_buffer(eth_if, pkts, sizes, 2,
+						   AF_UNSPEC, 0, K_NO_WAIT);
+	zassert_equal(allocated, 2, "Pkts not released");
+
+	net_pkt_unref_bulk(pkts, allocated);
+}
+
 /********************************\
  * HOW TO R/W A PACKET -  TESTS *
 \********************************/
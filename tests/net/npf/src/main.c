@@ -20,6 +20,7 @@ LOG_MODULE_REGISTER(npf_test, NET_LOG_LEVEL);
 
 #include <zephyr/net/net_if.h>
 #include <zephyr/net/ethernet.h>
+#include <zephyr/net/dummy.h>
 #include <zephyr/net/net_pkt_filter.h>
 
 #if NET_LOG_LEVEL >= LOG_LEVEL_DBG
@@ -85,6 +86,14 @@ ETH_NET_DEVICE_INIT(dummy_iface_b, "dummy_b", NULL, NULL,
 #define dummy_iface_a NET_IF_GET_NAME(dummy_iface_a, 0)[0]
 #define dummy_iface_b NET_IF_GET_NAME(dummy_iface_b, 0)[0]
 
+/* Interface whose frames are made of the IP packet only */
+static const struct dummy_api raw_ip_api;
+
+NET_DEVICE_INIT(raw_ip_iface, "raw_ip", NULL, NULL,
+		NULL, NULL, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT,
+		&raw_ip_api, DUMMY_L2, NET_L2_GET_CTX_TYPE(DUMMY_L2), NET_IPV6_MTU);
+#define raw_ip_iface NET_IF_GET_NAME(raw_ip_iface, 0)[0]
+
 static NPF_IFACE_MATCH(match_iface_a, &dummy_iface_a);
 static NPF_IFACE_UNMATCH(unmatch_iface_b, &dummy_iface_b);
 
@@ -307,4 +316,264 @@ ZTEST(net_pkt_filter_test_suite, test_npf_address_mask)
 	test_npf_eth_mac_addr_mask();
 }
 
+/*
+ * IP 5-tuple filtering
+ */
+
+#define IPV4_SRC_ADDR { { { 192, 0, 2, 1 } } }
+#define IPV4_DST_ADDR { { { 192, 0, 2, 2 } } }
+#define IPV6_SRC_ADDR { { { 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x1 } } }
+#define IPV6_DST_ADDR { { { 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x2 } } }
+
+#define SRC_PORT 1000
+#define DST_PORT 2000
+
+/* Incoming IP packet, with an Ethernet header if the interface needs one */
+static struct net_pkt *build_iface_ip_pkt(struct net_if *iface, sa_family_t family,
+					  uint8_t proto, uint16_t src_port,
+					  uint16_t dst_port)
+{
+	struct in_addr src4 = IPV4_SRC_ADDR, dst4 = IPV4_DST_ADDR;
+	struct in6_addr src6 = IPV6_SRC_ADDR, dst6 = IPV6_DST_ADDR;
+	struct net_eth_hdr eth_hdr;
+	struct net_pkt *pkt;
+	uint16_t ports[2] = { htons(src_port), htons(dst_port) };
+	int ret;
+
+	pkt = net_pkt_rx_alloc_with_buffer(iface, 100, AF_UNSPEC, 0, K_NO_WAIT);
+	zassert_not_null(pkt, "");
+
+	if (net_if_l2(iface) == &NET_L2_GET_NAME(ETHERNET)) {
+		eth_hdr.src = ETH_SRC_ADDR;
+		eth_hdr.dst = ETH_DST_ADDR;
+		eth_hdr.type = htons(family == AF_INET ? NET_ETH_PTYPE_IP :
+					 NET_ETH_PTYPE_IPV6);
+
+		ret = net_pkt_write(pkt, &eth_hdr, sizeof(eth_hdr));
+		zassert_equal(ret, 0, "");
+	}
+
+	if (family == AF_INET) {
+		struct net_ipv4_hdr hdr = {
+			.vhl = 0x45,
+			.ttl = 64,
+			.proto = proto,
+		};
+
+		memcpy(hdr.src, &src4, sizeof(hdr.src));
+		memcpy(hdr.dst, &dst4, sizeof(hdr.dst));
+		ret = net_pkt_write(pkt, &hdr, sizeof(hdr));
+	} else {
+		struct net_ipv6_hdr hdr = {
+			.vtc = 0x60,
+			.nexthdr = proto,
+			.hop_limit = 64,
+		};
+
+		memcpy(hdr.src, &src6, sizeof(hdr.src));
+		memcpy(hdr.dst, &dst6, sizeof(hdr.dst));
+		ret = net_pkt_write(pkt, &hdr, sizeof(hdr));
+	}
+
+	zassert_equal(ret, 0, "");
+
+	ret = net_pkt_write(pkt, ports, sizeof(ports));
+	zassert_equal(ret, 0, "");
+
+	return pkt;
+}
+
+static struct net_pkt *build_ip_pkt(sa_family_t family, uint8_t proto,
+				    uint16_t src_port, uint16_t dst_port)
+{
+	return build_iface_ip_pkt(&dummy_iface_a, family, proto, src_port, dst_port);
+}
+
+static struct in_addr ipv4_src_list[] = { IPV4_SRC_ADDR };
+static struct in_addr ipv4_dst_list[] = { IPV4_DST_ADDR };
+static struct in_addr ipv4_net_list[] = { { { { 192, 0, 2, 0 } } } };
+static struct in6_addr ipv6_src_list[] = { IPV6_SRC_ADDR };
+static struct in6_addr ipv6_dst_list[] = { IPV6_DST_ADDR };
+
+static NPF_IP_PROTO_MATCH(match_udp, IPPROTO_UDP);
+static NPF_IP_PROTO_MATCH(match_tcp, IPPROTO_TCP);
+static NPF_IP_PROTO_UNMATCH(unmatch_udp, IPPROTO_UDP);
+static NPF_IPV4_SRC_ADDR_MATCH(match_ipv4_src, ipv4_src_list);
+static NPF_IPV4_DST_ADDR_MATCH(match_ipv4_dst, ipv4_dst_list);
+static NPF_IPV4_DST_ADDR_UNMATCH(unmatch_ipv4_dst, ipv4_dst_list);
+static NPF_IPV4_SRC_PREFIX_MATCH(match_ipv4_net, ipv4_net_list, 24);
+static NPF_IPV6_SRC_ADDR_MATCH(match_ipv6_src, ipv6_src_list);
+static NPF_IPV6_DST_ADDR_MATCH(match_ipv6_dst, ipv6_dst_list);
+static NPF_SRC_PORT_MATCH(match_src_port, SRC_PORT);
+static NPF_DST_PORT_MATCH(match_dst_port, DST_PORT);
+static NPF_DST_PORT_MATCH(match_other_dst_port, DST_PORT + 1);
+static NPF_DST_PORT_RANGE(match_dst_port_range, DST_PORT - 10, DST_PORT + 10);
+
+static NPF_RULE(accept_udp, NET_OK, match_udp);
+static NPF_RULE(accept_not_udp, NET_OK, unmatch_udp);
+static NPF_RULE(accept_ipv4_net, NET_OK, match_ipv4_net);
+static NPF_RULE(accept_not_ipv4_dst, NET_OK, unmatch_ipv4_dst);
+static NPF_RULE(accept_dst_port_range, NET_OK, match_dst_port_range);
+static NPF_RULE(accept_ipv6_pair, NET_OK, match_ipv6_src, match_ipv6_dst);
+static NPF_RULE(accept_udp_5tuple, NET_OK, match_udp, match_ipv4_src, match_ipv4_dst,
+		match_src_port, match_dst_port);
+static NPF_RULE(accept_tcp_5tuple, NET_OK, match_tcp, match_ipv4_src, match_ipv4_dst,
+		match_src_port, match_dst_port);
+static NPF_RULE(accept_other_5tuple, NET_OK, match_udp, match_ipv4_src, match_ipv4_dst,
+		match_src_port, match_other_dst_port);
+static NPF_RULE(reject_udp, NET_DROP, match_udp);
+
+static void check_rule(struct npf_rule *rule, struct net_pkt *pkt, bool expected)
+{
+	npf_append_recv_rule(rule);
+	npf_append_recv_rule(&npf_default_drop);
+
+	zassert_equal(net_pkt_filter_recv_ok(pkt), expected, "");
+
+	zassert_true(npf_remove_all_recv_rules(), "");
+}
+
+ZTEST(net_pkt_filter_test_suite, test_npf_ip)
+{
+	struct net_pkt *udp4 = build_ip_pkt(AF_INET, IPPROTO_UDP, SRC_PORT, DST_PORT);
+	struct net_pkt *tcp6 = build_ip_pkt(AF_INET6, IPPROTO_TCP, SRC_PORT, DST_PORT);
+	struct net_pkt *arp = build_test_pkt(NET_ETH_PTYPE_ARP, 100, &dummy_iface_a);
+
+	check_rule(&accept_udp, udp4, true);
+	check_rule(&accept_udp, tcp6, false);
+	check_rule(&accept_udp, arp, false);
+	check_rule(&accept_not_udp, tcp6, true);
+
+	check_rule(&accept_ipv4_net, udp4, true);
+	check_rule(&accept_ipv4_net, tcp6, false);
+	check_rule(&accept_not_ipv4_dst, udp4, false);
+	check_rule(&accept_not_ipv4_dst, tcp6, true);
+
+	check_rule(&accept_dst_port_range, udp4, true);
+	check_rule(&accept_dst_port_range, tcp6, true);
+	check_rule(&accept_dst_port_range, arp, false);
+
+	check_rule(&accept_ipv6_pair, tcp6, true);
+	check_rule(&accept_ipv6_pair, udp4, false);
+
+	check_rule(&accept_udp_5tuple, udp4, true);
+	check_rule(&accept_tcp_5tuple, udp4, false);
+	check_rule(&accept_other_5tuple, udp4, false);
+
+	net_pkt_unref(udp4);
+	net_pkt_unref(tcp6);
+	net_pkt_unref(arp);
+}
+
+ZTEST(net_pkt_filter_test_suite, test_npf_ip_l2)
+{
+	struct net_pkt *raw_udp4 = build_iface_ip_pkt(&raw_ip_iface, AF_INET, IPPROTO_UDP,
+						      SRC_PORT, DST_PORT);
+	struct net_pkt *unknown_udp4 = build_iface_ip_pkt(NULL, AF_INET, IPPROTO_UDP,
+							  SRC_PORT, DST_PORT);
+
+	/* The IP header starts the frames of a raw IP interface */
+	check_rule(&accept_udp, raw_udp4, true);
+	check_rule(&accept_udp_5tuple, raw_udp4, true);
+
+	/* The frames of an unknown L2 are never taken as IP packets */
+	check_rule(&accept_udp, unknown_udp4, false);
+	check_rule(&accept_not_ipv4_dst, unknown_udp4, true);
+	check_rule(&accept_dst_port_range, unknown_udp4, false);
+
+	net_pkt_unref(raw_udp4);
+	net_pkt_unref(unknown_udp4);
+}
+
+/*
+ * Compiled rule lists
+ */
+
+NPF_PROGRAM_DEFINE(test_program, 32, 8);
+NPF_PROGRAM_DEFINE(small_program, 2, 0);
+
+static void check_compiled(struct net_pkt **pkts, size_t count)
+{
+	bool expected[4];
+	size_t i;
+
+	zassert_true(count <= ARRAY_SIZE(expected), "");
+
+	npf_uncompile_rules(&npf_recv_rules);
+
+	for (i = 0; i < count; i++) {
+		expected[i] = net_pkt_filter_recv_ok(pkts[i]);
+	}
+
+	zassert_equal(npf_compile_rules(&npf_recv_rules, &test_program), 0, "");
+	zassert_equal_ptr(npf_recv_rules.program, &test_program, "");
+
+	for (i = 0; i < count; i++) {
+		zassert_equal(net_pkt_filter_recv_ok(pkts[i]), expected[i],
+			      "pkt %zu: compiled verdict differs", i);
+	}
+}
+
+ZTEST(net_pkt_filter_test_suite, test_npf_compile)
+{
+	struct net_pkt *pkts[] = {
+		build_ip_pkt(AF_INET, IPPROTO_UDP, SRC_PORT, DST_PORT),
+		build_ip_pkt(AF_INET, IPPROTO_TCP, SRC_PORT, DST_PORT),
+		build_ip_pkt(AF_INET6, IPPROTO_UDP, SRC_PORT, DST_PORT),
+		build_test_pkt(NET_ETH_PTYPE_ARP, 300, &dummy_iface_a),
+	};
+	size_t i;
+
+	/* No rules */
+	check_compiled(pkts, ARRAY_SIZE(pkts));
+	zassert_true(net_pkt_filter_recv_ok(pkts[0]), "");
+
+	/* Hashed 5-tuple rules along with generic ones */
+	npf_append_recv_rule(&accept_other_5tuple);
+	npf_append_recv_rule(&accept_tcp_5tuple);
+	npf_append_recv_rule(&accept_iface_a);
+	npf_append_recv_rule(&npf_default_drop);
+	zassert_is_null(npf_recv_rules.program, "");
+
+	check_compiled(pkts, ARRAY_SIZE(pkts));
+	zassert_equal(test_program.nb_entries, 2, "5-tuple rules not hashed");
+	zassert_true(net_pkt_filter_recv_ok(pkts[0]), "");
+	zassert_true(net_pkt_filter_recv_ok(pkts[1]), "");
+
+	/* A rule located before a hashed rule takes precedence */
+	npf_insert_recv_rule(&accept_udp_5tuple);
+	npf_insert_recv_rule(&reject_udp);
+	zassert_is_null(npf_recv_rules.program, "Modified rules still compiled");
+
+	check_compiled(pkts, ARRAY_SIZE(pkts));
+	zassert_false(net_pkt_filter_recv_ok(pkts[0]), "");
+	zassert_true(net_pkt_filter_recv_ok(pkts[1]), "");
+
+	zassert_true(npf_remove_recv_rule(&reject_udp), "");
+	check_compiled(pkts, ARRAY_SIZE(pkts));
+	zassert_true(net_pkt_filter_recv_ok(pkts[0]), "");
+
+	/* Generic conditions, the size and ethernet conditions */
+	zassert_true(npf_remove_all_recv_rules(), "");
+	npf_append_recv_rule(&reject_big_pkts);
+	npf_append_recv_rule(&reject_non_ip);
+	npf_append_recv_rule(&accept_not_udp);
+	npf_append_recv_rule(&accept_ipv4_net);
+	npf_append_recv_rule(&accept_matched_src_addr);
+	npf_append_recv_rule(&npf_default_drop);
+
+	check_compiled(pkts, ARRAY_SIZE(pkts));
+	zassert_equal(test_program.nb_entries, 0, "");
+
+	/* Not enough room for the instructions */
+	zassert_equal(npf_compile_rules(&npf_recv_rules, &small_program), -ENOMEM, "");
+	zassert_is_null(npf_recv_rules.program, "");
+
+	zassert_true(npf_remove_all_recv_rules(), "");
+
+	for (i = 0; i < ARRAY_SIZE(pkts); i++) {
+		net_pkt_unref(pkts[i]);
+	}
+}
+
 ZTEST_SUITE(net_pkt_filter_test_suite, NULL, test_npf_iface, NULL, NULL, NULL);
@@ -91,6 +91,7 @@ static int msg_sending;
 K_SEM_DEFINE(wait_data, 0, UINT_MAX);
 
 #define WAIT_TIME K_MSEC(250)
+#define LOOKUP_ROUNDS 10
 
 struct net_route_test {
 	uint8_t mac_addr[sizeof(struct net_eth_addr)];
@@ -284,6 +285,7 @@ static void test_init(void)
 		memcpy(&dest_addresses[i], &generic_addr,
 		       sizeof(struct in6_addr));
 
+		dest_addresses[i].s6_addr[13] = (i + 1) >> 8;
 		dest_addresses[i].s6_addr[14] = i + 1;
 		dest_addresses[i].s6_addr[15] = sys_rand32_get();
 	}
@@ -544,6 +546,35 @@ static void test_route_preference(void)
 	net_route_del(entry);
 }
 
+static void test_route_lookup_perf(void)
+{
+	uint32_t start, cycles;
+	int i, round;
+
+	test_route_add_many();
+
+	start = k_cycle_get_32();
+
+	for (round = 0; round < LOOKUP_ROUNDS; round++) {
+		for (i = 0; i < max_routes; i++) {
+			zassert_equal_ptr(net_route_lookup(my_iface,
+							   &dest_addresses[i]),
+					  test_routes[i],
+					  "Wrong route found for %d", i);
+		}
+	}
+
+	cycles = k_cycle_get_32() - start;
+
+	TC_PRINT("%d routes, %d lookups took %u cycles (%u cycles per lookup)\n",
+		 max_routes, LOOKUP_ROUNDS * max_routes, cycles,
+		 cycles / (LOOKUP_ROUNDS * max_routes));
+
+	test_route_del_many();
+
+	zassert_is_null(net_route_lookup(my_iface, &dest_addresses[0]),
+			"Route found after delete");
+}
 
 /*test case main entry*/
 ZTEST(route_test_suite, test_route)
@@ -566,6 +597,7 @@ ZTEST(route_test_suite, test_route)
 	test_route_del_many();
 	test_route_lifetime();
 	test_route_preference();
+	test_route_lookup_perf();
 }
 
 ZTEST_SUITE(route_test_suite, NULL, NULL, NULL, NULL, NULL);
@@ -11,6 +11,7 @@ LOG_MODULE_REGISTER(net_test, CONFIG_NET_SOCKETS_LOG_LEVEL);
 #include <fcntl.h>
 #include <zephyr/net/socket.h>
 #include <zephyr/net/loopback.h>
+#include <zephyr/net/buf.h>
 
 #include "../../socket_helpers.h"
 
@@ -279,6 +280,63 @@ ZTEST_USER(net_socket_tcp, test_v6_send_recv)
 	k_sleep(TCP_TEARDOWN_TIMEOUT);
 }
 
+ZTEST(net_socket_tcp, test_v4_recv_zerocopy_eof)
+{
+	/* Test that zsock_recv_zerocopy() loans the received data and
+	 * does not leave anything to release on end of stream.
+	 */
+	int c_sock;
+	int s_sock;
+	int new_sock;
+	struct sockaddr_in c_saddr;
+	struct sockaddr_in s_saddr;
+	struct sockaddr addr;
+	socklen_t addrlen = sizeof(addr);
+	struct zsock_rx_loan loan;
+	char rx_buf[sizeof(TEST_STR_SMALL)];
+	ssize_t len;
+
+	prepare_sock_tcp_v4(MY_IPV4_ADDR, ANY_PORT, &c_sock, &c_saddr);
+	prepare_sock_tcp_v4(MY_IPV4_ADDR, SERVER_PORT, &s_sock, &s_saddr);
+
+	test_bind(s_sock, (struct sockaddr *)&s_saddr, sizeof(s_saddr));
+	test_listen(s_sock);
+
+	test_connect(c_sock, (struct sockaddr *)&s_saddr, sizeof(s_saddr));
+	test_send(c_sock, TEST_STR_SMALL, strlen(TEST_STR_SMALL), 0);
+
+	test_accept(s_sock, &new_sock, &addr, &addrlen);
+
+	len = zsock_recv_zerocopy(new_sock, &loan, 0, NULL, NULL);
+	zassert_equal(len, strlen(TEST_STR_SMALL), "zero-copy recv failed (%d)",
+		      errno);
+	zassert_not_null(loan.pkt, "nothing loaned");
+
+	len = net_buf_linearize(rx_buf, sizeof(rx_buf), loan.buf, 0, loan.len);
+	zassert_equal(len, strlen(TEST_STR_SMALL), "linearize failed");
+	zassert_mem_equal(rx_buf, TEST_STR_SMALL, strlen(TEST_STR_SMALL),
+			  "invalid rx data");
+
+	zsock_recv_zerocopy_release(&loan);
+
+	test_close(c_sock);
+
+	len = zsock_recv_zerocopy(new_sock, &loan, 0, NULL, NULL);
+	zassert_equal(len, 0, "EOF not detected (%d)", errno);
+	zassert_is_null(loan.pkt, "packet loaned on EOF");
+	zassert_is_null(loan.buf, "buffer loaned on EOF");
+
+	/* Calling again should be OK */
+	len = zsock_recv_zerocopy(new_sock, &loan, 0, NULL, NULL);
+	zassert_equal(len, 0, "EOF not detected (%d)", errno);
+	zassert_is_null(loan.pkt, "packet loaned on EOF");
+
+	test_close(new_sock);
+	test_close(s_sock);
+
+	k_sleep(TCP_TEARDOWN_TIMEOUT);
+}
+
 /* Test the stack behavior with a resonable sized block data, be sure to have multiple packets */
 #define TEST_LARGE_TRANSFER_SIZE 60000
 #define TEST_PRIME 811
@@ -336,7 +394,62 @@ void tcp_server_block_thread(void *vps_sock, void *unused2, void *unused3)
 	test_close(new_sock);
 }
 
-void test_send_recv_large_common(int tcp_nodelay, int family)
+#define TEST_ZEROCOPY_CHUNK_SIZE 4096
+
+static uint8_t zerocopy_data[TEST_LARGE_TRANSFER_SIZE];
+static atomic_t zerocopy_completed;
+static K_SEM_DEFINE(zerocopy_sem, CONFIG_NET_SOCKETS_SEND_ZEROCOPY_COUNT,
+		    CONFIG_NET_SOCKETS_SEND_ZEROCOPY_COUNT);
+
+static void zerocopy_done(const void *data, size_t len, void *user_data)
+{
+	ARG_UNUSED(data);
+	ARG_UNUSED(user_data);
+
+	atomic_add(&zerocopy_completed, len);
+	k_sem_give(&zerocopy_sem);
+}
+
+static void test_send_large_zerocopy(int sock)
+{
+	ssize_t total_send = 0;
+	int wait = 0;
+
+	for (int i = 0; i < sizeof(zerocopy_data); i++) {
+		zerocopy_data[i] = (i * TEST_PRIME) & 0xff;
+	}
+
+	atomic_clear(&zerocopy_completed);
+
+	while (total_send < TEST_LARGE_TRANSFER_SIZE) {
+		size_t chunk_size = MIN(TEST_ZEROCOPY_CHUNK_SIZE,
+					TEST_LARGE_TRANSFER_SIZE - total_send);
+		ssize_t send_bytes;
+
+		zassert_ok(k_sem_take(&zerocopy_sem, K_SECONDS(10)),
+			   "No zero-copy send completed");
+
+		send_bytes = zsock_send_zerocopy(sock, &zerocopy_data[total_send],
+						 chunk_size, 0, zerocopy_done,
+						 NULL);
+		zassert_equal(send_bytes, chunk_size,
+			      "Error sending %i bytes on top of %i, errno %i",
+			      chunk_size, total_send, errno);
+
+		total_send += send_bytes;
+	}
+
+	/* The data is released after the peer has acknowledged it */
+	while (atomic_get(&zerocopy_completed) < TEST_LARGE_TRANSFER_SIZE &&
+	       wait++ < 100) {
+		k_msleep(THREAD_SLEEP);
+	}
+
+	zassert_equal(atomic_get(&zerocopy_completed), TEST_LARGE_TRANSFER_SIZE,
+		      "Not all zero-copy sends completed");
+}
+
+void test_send_recv_large_common(int tcp_nodelay, int family, bool zerocopy)
 {
 	int rv;
 	int c_sock;
@@ -385,6 +498,11 @@ void test_send_recv_large_common(int tcp_nodelay, int family)
 	int iteration = 0;
 	uint8_t buffer[256];
 
+	if (zerocopy) {
+		test_send_large_zerocopy(c_sock);
+		total_send = TEST_LARGE_TRANSFER_SIZE;
+	}
+
 	while (total_send < TEST_LARGE_TRANSFER_SIZE) {
 		/* Fill the buffer with a known pattern */
 		for (int i = 0; i < sizeof(buffer); i++) {
@@ -436,39 +554,51 @@ static void restore_packet_loss_ratio(void)
 
 ZTEST(net_socket_tcp, test_v4_send_recv_large_normal)
 {
-	test_send_recv_large_common(0, AF_INET);
+	test_send_recv_large_common(0, AF_INET, false);
 }
 
 ZTEST(net_socket_tcp, test_v4_send_recv_large_packet_loss)
 {
 	set_packet_loss_ratio();
-	test_send_recv_large_common(0, AF_INET);
+	test_send_recv_large_common(0, AF_INET, false);
 	restore_packet_loss_ratio();
 }
 
 ZTEST(net_socket_tcp, test_v4_send_recv_large_no_delay)
 {
 	set_packet_loss_ratio();
-	test_send_recv_large_common(1, AF_INET);
+	test_send_recv_large_common(1, AF_INET, false);
 	restore_packet_loss_ratio();
 }
 
 ZTEST(net_socket_tcp, test_v6_send_recv_large_normal)
 {
-	test_send_recv_large_common(0, AF_INET6);
+	test_send_recv_large_common(0, AF_INET6, false);
 }
 
 ZTEST(net_socket_tcp, test_v6_send_recv_large_packet_loss)
 {
 	set_packet_loss_ratio();
-	test_send_recv_large_common(0, AF_INET6);
+	test_send_recv_large_common(0, AF_INET6, false);
 	restore_packet_loss_ratio();
 }
 
 ZTEST(net_socket_tcp, test_v6_send_recv_large_no_delay)
 {
 	set_packet_loss_ratio();
-	test_send_recv_large_common(1, AF_INET6);
+	test_send_recv_large_common(1, AF_INET6, false);
+	restore_packet_loss_ratio();
+}
+
+ZTEST(net_socket_tcp, test_v4_send_recv_large_zerocopy)
+{
+	test_send_recv_large_common(0, AF_INET, true);
+}
+
+ZTEST(net_socket_tcp, test_v6_send_recv_large_zerocopy_packet_loss)
+{
+	set_packet_loss_ratio();
+	test_send_recv_large_common(0, AF_INET6, true);
 	restore_packet_loss_ratio();
 }
 
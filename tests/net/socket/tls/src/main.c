@@ -603,6 +603,269 @@ ZTEST(net_socket_tls, test_v6_dtls_sendmsg)
 			  (struct sockaddr *)&server_addr, sizeof(server_addr));
 }
 
+#define NAT_SERVER_PORT 4243
+#define NAT_INNER_PORT 4244
+#define NAT_OUTER_PORT_1 4245
+#define NAT_OUTER_PORT_2 4246
+#define NAT_STACK_SIZE 1024
+
+/* Forwards the datagrams of a DTLS client to a DTLS server, from one of two
+ * source ports, to mimic a NAT whose binding changes.
+ */
+static struct nat_data {
+	int inner;
+	int outer[2];
+	int current;
+	struct sockaddr client_addr;
+	socklen_t client_addrlen;
+	struct sockaddr_in server_addr;
+	bool stop;
+	uint8_t buf[512];
+} nat;
+
+static struct k_thread nat_thread;
+static K_THREAD_STACK_DEFINE(nat_stack, NAT_STACK_SIZE);
+
+static void nat_entry(void *p1, void *p2, void *p3)
+{
+	struct zsock_pollfd fds[3];
+	ssize_t len;
+	int i;
+
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	fds[0].fd = nat.inner;
+	fds[1].fd = nat.outer[0];
+	fds[2].fd = nat.outer[1];
+
+	while (!nat.stop) {
+		for (i = 0; i < ARRAY_SIZE(fds); i++) {
+			fds[i].events = ZSOCK_POLLIN;
+			fds[i].revents = 0;
+		}
+
+		if (zsock_poll(fds, ARRAY_SIZE(fds), 10) <= 0) {
+			continue;
+		}
+
+		if (fds[0].revents & ZSOCK_POLLIN) {
+			nat.client_addrlen = sizeof(nat.client_addr);
+			len = recvfrom(nat.inner, nat.buf, sizeof(nat.buf), 0,
+				       &nat.client_addr, &nat.client_addrlen);
+			if (len > 0) {
+				(void)sendto(nat.outer[nat.current], nat.buf, len,
+					     0, (struct sockaddr *)&nat.server_addr,
+					     sizeof(nat.server_addr));
+			}
+		}
+
+		for (i = 0; i < ARRAY_SIZE(nat.outer); i++) {
+			if (!(fds[i + 1].revents & ZSOCK_POLLIN)) {
+				continue;
+			}
+
+			len = recv(nat.outer[i], nat.buf, sizeof(nat.buf), 0);
+			if (len > 0) {
+				(void)sendto(nat.inner, nat.buf, len, 0,
+					     &nat.client_addr, nat.client_addrlen);
+			}
+		}
+	}
+}
+
+static void test_dtls_nat_rebinding(bool use_cid)
+{
+	int client_cid = TLS_DTLS_CID_SUPPORTED;
+	int server_cid = TLS_DTLS_CID_ENABLED;
+	int role = TLS_DTLS_ROLE_SERVER;
+	struct timeval timeo_optval = {
+		.tv_sec = 2,
+	};
+	struct test_msg_trunc_data test_data = {
+		.data = TEST_STR_SMALL,
+		.datalen = sizeof(TEST_STR_SMALL) - 1
+	};
+	struct sockaddr_in inner_addr, outer_addr, client_addr;
+	struct sockaddr_in src_addr;
+	socklen_t addrlen;
+	uint8_t rx_buf[sizeof(TEST_STR_SMALL) - 1];
+	int client_sock, server_sock;
+	int i;
+	int rv;
+
+	prepare_sock_dtls_v4(MY_IPV4_ADDR, ANY_PORT, &client_sock, &client_addr,
+			     IPPROTO_DTLS_1_2);
+	prepare_sock_dtls_v4(MY_IPV4_ADDR, NAT_SERVER_PORT, &server_sock,
+			     &nat.server_addr, IPPROTO_DTLS_1_2);
+
+	test_config_psk(server_sock, client_sock);
+
+	rv = setsockopt(server_sock, SOL_TLS, TLS_DTLS_ROLE, &role, sizeof(role));
+	zassert_equal(rv, 0, "failed to set DTLS server role");
+
+	if (use_cid) {
+		rv = setsockopt(server_sock, SOL_TLS, TLS_DTLS_CID, &server_cid,
+				sizeof(server_cid));
+		zassert_equal(rv, 0, "failed to set server CID mode");
+		rv = setsockopt(client_sock, SOL_TLS, TLS_DTLS_CID, &client_cid,
+				sizeof(client_cid));
+		zassert_equal(rv, 0, "failed to set client CID mode");
+	}
+
+	rv = setsockopt(server_sock, SOL_SOCKET, SO_RCVTIMEO, &timeo_optval,
+			sizeof(timeo_optval));
+	zassert_equal(rv, 0, "setsockopt failed (%d)", errno);
+	rv = setsockopt(client_sock, SOL_SOCKET, SO_RCVTIMEO, &timeo_optval,
+			sizeof(timeo_optval));
+	zassert_equal(rv, 0, "setsockopt failed (%d)", errno);
+
+	test_bind(server_sock, (struct sockaddr *)&nat.server_addr,
+		  sizeof(nat.server_addr));
+
+	prepare_sock_udp_v4(MY_IPV4_ADDR, NAT_INNER_PORT, &nat.inner,
+			    &inner_addr);
+	test_bind(nat.inner, (struct sockaddr *)&inner_addr, sizeof(inner_addr));
+
+	for (i = 0; i < ARRAY_SIZE(nat.outer); i++) {
+		prepare_sock_udp_v4(MY_IPV4_ADDR,
+				    i == 0 ? NAT_OUTER_PORT_1 : NAT_OUTER_PORT_2,
+				    &nat.outer[i], &outer_addr);
+		test_bind(nat.outer[i], (struct sockaddr *)&outer_addr,
+			  sizeof(outer_addr));
+	}
+
+	nat.current = 0;
+	nat.stop = false;
+	k_thread_create(&nat_thread, nat_stack, K_THREAD_STACK_SIZEOF(nat_stack),
+			nat_entry, NULL, NULL, NULL,
+			K_LOWEST_APPLICATION_THREAD_PRIO, 0, K_NO_WAIT);
+
+	rv = connect(client_sock, (struct sockaddr *)&inner_addr,
+		     sizeof(inner_addr));
+	zassert_equal(rv, 0, "connect failed");
+
+	/* The handshake is done by the first send() */
+	test_data.sock = client_sock;
+	k_work_init_delayable(&test_data.tx_work,
+			      test_msg_trunc_tx_work_handler);
+	k_work_reschedule(&test_data.tx_work, K_MSEC(10));
+
+	memset(rx_buf, 0, sizeof(rx_buf));
+	rv = recv(server_sock, rx_buf, sizeof(rx_buf), 0);
+	zassert_equal(rv, sizeof(rx_buf), "recv failed (%d)", errno);
+	zassert_mem_equal(rx_buf, TEST_STR_SMALL, sizeof(rx_buf),
+			  "invalid rx data");
+
+	if (use_cid) {
+		uint8_t own_cid[32];
+		uint8_t peer_cid[32];
+		socklen_t own_cid_len = sizeof(own_cid);
+		socklen_t peer_cid_len = sizeof(peer_cid);
+		socklen_t optlen = sizeof(int);
+		int status;
+
+		rv = getsockopt(server_sock, SOL_TLS, TLS_DTLS_CID_STATUS,
+				&status, &optlen);
+		zassert_equal(rv, 0, "getsockopt failed (%d)", errno);
+		zassert_equal(status, TLS_DTLS_CID_STATUS_DOWNLINK,
+			      "wrong server CID status");
+
+		rv = getsockopt(client_sock, SOL_TLS, TLS_DTLS_CID_STATUS,
+				&status, &optlen);
+		zassert_equal(rv, 0, "getsockopt failed (%d)", errno);
+		zassert_equal(status, TLS_DTLS_CID_STATUS_UPLINK,
+			      "wrong client CID status");
+
+		rv = getsockopt(server_sock, SOL_TLS, TLS_DTLS_CID_VALUE,
+				own_cid, &own_cid_len);
+		zassert_equal(rv, 0, "getsockopt failed (%d)", errno);
+		rv = getsockopt(client_sock, SOL_TLS, TLS_DTLS_PEER_CID_VALUE,
+				peer_cid, &peer_cid_len);
+		zassert_equal(rv, 0, "getsockopt failed (%d)", errno);
+		zassert_equal(peer_cid_len, own_cid_len, "wrong CID length");
+		zassert_mem_equal(peer_cid, own_cid, own_cid_len, "wrong CID");
+	}
+
+	/* The client now reaches the server from another port */
+	nat.current = 1;
+
+	test_send(client_sock, TEST_STR_SMALL, sizeof(TEST_STR_SMALL) - 1, 0);
+
+	memset(rx_buf, 0, sizeof(rx_buf));
+	addrlen = sizeof(src_addr);
+	rv = recvfrom(server_sock, rx_buf, sizeof(rx_buf), 0,
+		      (struct sockaddr *)&src_addr, &addrlen);
+
+	if (!use_cid) {
+		/* Records from an unknown address are dropped */
+		zassert_equal(rv, -1, "recv should have failed");
+		zassert_equal(errno, EAGAIN, "incorrect errno value");
+	} else {
+		zassert_equal(rv, sizeof(rx_buf), "recv failed (%d)", errno);
+		zassert_mem_equal(rx_buf, TEST_STR_SMALL, sizeof(rx_buf),
+				  "invalid rx data");
+		zassert_equal(ntohs(src_addr.sin_port), NAT_OUTER_PORT_2,
+			      "peer address not updated");
+
+		/* The answer reaches the client through the new binding */
+		test_send(server_sock, TEST_STR_SMALL,
+			  sizeof(TEST_STR_SMALL) - 1, 0);
+
+		memset(rx_buf, 0, sizeof(rx_buf));
+		rv = recv(client_sock, rx_buf, sizeof(rx_buf), 0);
+		zassert_equal(rv, sizeof(rx_buf), "recv failed (%d)", errno);
+		zassert_mem_equal(rx_buf, TEST_STR_SMALL, sizeof(rx_buf),
+				  "invalid rx data");
+	}
+
+	nat.stop = true;
+	k_thread_join(&nat_thread, K_FOREVER);
+
+	test_close(client_sock);
+	test_close(server_sock);
+	test_close(nat.inner);
+	test_close(nat.outer[0]);
+	test_close(nat.outer[1]);
+}
+
+ZTEST(net_socket_tls, test_dtls_nat_rebinding_without_cid)
+{
+	test_dtls_nat_rebinding(false);
+}
+
+ZTEST(net_socket_tls, test_dtls_nat_rebinding_with_cid)
+{
+	Z_TEST_SKIP_IFNDEF(CONFIG_MBEDTLS_SSL_DTLS_CONNECTION_ID);
+
+	test_dtls_nat_rebinding(true);
+}
+
+ZTEST(net_socket_tls, test_dtls_cid_on_stream)
+{
+	struct sockaddr_in bind_addr;
+	uint8_t cid[] = { 1, 2, 3, 4 };
+	int cid_mode = TLS_DTLS_CID_ENABLED;
+	int sock, rv;
+
+	Z_TEST_SKIP_IFNDEF(CONFIG_MBEDTLS_SSL_DTLS_CONNECTION_ID);
+
+	prepare_sock_tls_v4(MY_IPV4_ADDR, ANY_PORT, &sock, &bind_addr,
+			    IPPROTO_TLS_1_2);
+
+	rv = setsockopt(sock, SOL_TLS, TLS_DTLS_CID, &cid_mode,
+			sizeof(cid_mode));
+	zassert_equal(rv, -1, "CID mode accepted on a stream socket");
+	zassert_equal(errno, EINVAL, "invalid errno (%d)", errno);
+
+	rv = setsockopt(sock, SOL_TLS, TLS_DTLS_CID_VALUE, cid, sizeof(cid));
+	zassert_equal(rv, -1, "CID value accepted on a stream socket");
+	zassert_equal(errno, EINVAL, "invalid errno (%d)", errno);
+
+	test_close(sock);
+}
+
 struct close_data {
 	struct k_work_delayable work;
 	int fd;
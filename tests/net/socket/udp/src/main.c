@@ -9,11 +9,13 @@
 LOG_MODULE_REGISTER(net_test, CONFIG_NET_SOCKETS_LOG_LEVEL);
 
 #include <stdio.h>
+#include <time.h>
 #include <zephyr/sys/mutex.h>
 #include <zephyr/ztest_assert.h>
 
 #include <zephyr/net/socket.h>
 #include <zephyr/net/ethernet.h>
+#include <zephyr/net/buf.h>
 
 #include "ipv6.h"
 #include "../../socket_helpers.h"
@@ -1286,4 +1288,207 @@ ZTEST(net_socket_udp, test_23_v6_dgram_overflow)
 			    BUF_AND_SIZE(test_str_all_tx_bufs));
 }
 
+#define MMSG_COUNT 3
+
+static ZTEST_BMEM char mmsg_rx_buf[MMSG_COUNT + 1][sizeof(TEST_STR2)];
+
+static void comm_sendmmsg_recvmmsg(int client_sock,
+				   struct sockaddr *client_addr,
+				   socklen_t client_addrlen,
+				   int server_sock,
+				   struct sockaddr *server_addr,
+				   socklen_t server_addrlen)
+{
+	static const char * const data[MMSG_COUNT] = {
+		TEST_STR_SMALL, TEST_STR2, TEST_STR_SMALL TEST_STR_SMALL,
+	};
+	struct mmsghdr tx_msgs[MMSG_COUNT] = { 0 };
+	struct mmsghdr rx_msgs[MMSG_COUNT + 1] = { 0 };
+	struct iovec tx_iov[MMSG_COUNT][2];
+	struct iovec rx_iov[MMSG_COUNT + 1];
+	struct sockaddr_storage addr[MMSG_COUNT + 1];
+	int rv;
+	int i;
+
+	zassert_not_null(client_addr, "null client addr");
+	zassert_not_null(server_addr, "null server addr");
+
+	for (i = 0; i < MMSG_COUNT; i++) {
+		size_t half = strlen(data[i]) / 2;
+
+		/* Split each datagram into two buffers */
+		tx_iov[i][0].iov_base = (void *)data[i];
+		tx_iov[i][0].iov_len = half;
+		tx_iov[i][1].iov_base = (void *)(data[i] + half);
+		tx_iov[i][1].iov_len = strlen(data[i]) - half;
+
+		tx_msgs[i].msg_hdr.msg_name = server_addr;
+		tx_msgs[i].msg_hdr.msg_namelen = server_addrlen;
+		tx_msgs[i].msg_hdr.msg_iov = tx_iov[i];
+		tx_msgs[i].msg_hdr.msg_iovlen = 2;
+	}
+
+	rv = sendmmsg(client_sock, tx_msgs, MMSG_COUNT, 0);
+	zassert_equal(rv, MMSG_COUNT, "sendmmsg failed (%d)", errno);
+
+	for (i = 0; i < MMSG_COUNT; i++) {
+		zassert_equal(tx_msgs[i].msg_len, strlen(data[i]),
+			      "invalid send length");
+	}
+
+	for (i = 0; i < MMSG_COUNT + 1; i++) {
+		rx_iov[i].iov_base = mmsg_rx_buf[i];
+		rx_iov[i].iov_len = sizeof(mmsg_rx_buf[i]);
+
+		rx_msgs[i].msg_hdr.msg_name = &addr[i];
+		rx_msgs[i].msg_hdr.msg_namelen = sizeof(addr[i]);
+		rx_msgs[i].msg_hdr.msg_iov = &rx_iov[i];
+		rx_msgs[i].msg_hdr.msg_iovlen = 1;
+	}
+
+	/* Give the loopback time to deliver all the datagrams */
+	k_msleep(10);
+
+	/* Ask for one more datagram than was sent. The call must not block
+	 * waiting for it as the first datagram is already there.
+	 */
+	rv = recvmmsg(server_sock, rx_msgs, MMSG_COUNT + 1, 0, NULL);
+	zassert_equal(rv, MMSG_COUNT, "recvmmsg failed (%d)", errno);
+
+	for (i = 0; i < MMSG_COUNT; i++) {
+		zassert_equal(rx_msgs[i].msg_len, strlen(data[i]),
+			      "invalid receive length");
+		zassert_mem_equal(mmsg_rx_buf[i], data[i], strlen(data[i]),
+				  "invalid rx data");
+		zassert_equal(rx_msgs[i].msg_hdr.msg_namelen, client_addrlen,
+			      "unexpected addrlen");
+		zassert_equal(rx_msgs[i].msg_hdr.msg_flags, 0,
+			      "unexpected flags");
+	}
+
+	rv = recvmmsg(server_sock, rx_msgs, MMSG_COUNT, MSG_DONTWAIT, NULL);
+	zassert_equal(rv, -1, "recvmmsg succeeded on empty socket");
+	zassert_equal(errno, EAGAIN, "invalid errno (%d)", errno);
+
+	rv = recvmmsg(server_sock, rx_msgs, MMSG_COUNT, MSG_DONTWAIT,
+		      &(struct timespec){ 0 });
+	zassert_equal(rv, -1, "recvmmsg accepted a timeout");
+	zassert_equal(errno, EINVAL, "invalid errno (%d)", errno);
+
+	rv = close(client_sock);
+	zassert_equal(rv, 0, "close failed");
+	rv = close(server_sock);
+	zassert_equal(rv, 0, "close failed");
+}
+
+ZTEST(net_socket_udp, test_24_v4_sendmmsg_recvmmsg)
+{
+	int rv;
+	int client_sock;
+	int server_sock;
+	struct sockaddr_in client_addr;
+	struct sockaddr_in server_addr;
+
+	prepare_sock_udp_v4(MY_IPV4_ADDR, ANY_PORT, &client_sock, &client_addr);
+	prepare_sock_udp_v4(MY_IPV4_ADDR, SERVER_PORT, &server_sock, &server_addr);
+
+	rv = bind(server_sock,
+		  (struct sockaddr *)&server_addr,
+		  sizeof(server_addr));
+	zassert_equal(rv, 0, "server bind failed");
+
+	comm_sendmmsg_recvmmsg(client_sock,
+			       (struct sockaddr *)&client_addr,
+			       sizeof(client_addr),
+			       server_sock,
+			       (struct sockaddr *)&server_addr,
+			       sizeof(server_addr));
+}
+
+ZTEST_USER(net_socket_udp, test_25_v6_sendmmsg_recvmmsg)
+{
+	int rv;
+	int client_sock;
+	int server_sock;
+	struct sockaddr_in6 client_addr;
+	struct sockaddr_in6 server_addr;
+
+	prepare_sock_udp_v6(MY_IPV6_ADDR, ANY_PORT, &client_sock, &client_addr);
+	prepare_sock_udp_v6(MY_IPV6_ADDR, SERVER_PORT, &server_sock, &server_addr);
+
+	rv = bind(server_sock,
+		  (struct sockaddr *)&server_addr,
+		  sizeof(server_addr));
+	zassert_equal(rv, 0, "server bind failed");
+
+	comm_sendmmsg_recvmmsg(client_sock,
+			       (struct sockaddr *)&client_addr,
+			       sizeof(client_addr),
+			       server_sock,
+			       (struct sockaddr *)&server_addr,
+			       sizeof(server_addr));
+}
+
+ZTEST(net_socket_udp, test_26_v6_recv_zerocopy)
+{
+	int rv;
+	ssize_t len;
+	int client_sock;
+	int server_sock;
+	struct sockaddr_in6 client_addr;
+	struct sockaddr_in6 server_addr;
+	struct sockaddr_in6 addr;
+	socklen_t addrlen = sizeof(addr);
+	struct zsock_rx_loan loan;
+	char rx_buf[sizeof(TEST_STR2)];
+
+	prepare_sock_udp_v6(MY_IPV6_ADDR, ANY_PORT, &client_sock, &client_addr);
+	prepare_sock_udp_v6(MY_IPV6_ADDR, SERVER_PORT, &server_sock, &server_addr);
+
+	rv = bind(server_sock,
+		  (struct sockaddr *)&server_addr,
+		  sizeof(server_addr));
+	zassert_equal(rv, 0, "server bind failed");
+
+	len = sendto(client_sock, BUF_AND_SIZE(TEST_STR2), 0,
+		     (struct sockaddr *)&server_addr, sizeof(server_addr));
+	zassert_equal(len, STRLEN(TEST_STR2), "sendto failed");
+
+	len = zsock_recv_zerocopy(server_sock, &loan, MSG_PEEK, NULL, NULL);
+	zassert_equal(len, -1, "peek should not be supported");
+	zassert_equal(errno, EINVAL, "invalid errno (%d)", errno);
+
+	len = zsock_recv_zerocopy(server_sock, &loan, 0,
+				  (struct sockaddr *)&addr, &addrlen);
+	zassert_equal(len, STRLEN(TEST_STR2), "zero-copy recv failed (%d)",
+		      errno);
+	zassert_equal(loan.len, STRLEN(TEST_STR2), "invalid loan length");
+	zassert_not_null(loan.buf, "no loaned buffer");
+	zassert_equal(net_buf_frags_len(loan.buf), STRLEN(TEST_STR2),
+		      "loaned buffers should hold the payload only");
+	zassert_equal(addrlen, sizeof(struct sockaddr_in6),
+		      "unexpected addrlen");
+	zassert_equal(addr.sin6_family, AF_INET6, "invalid source family");
+
+	len = net_buf_linearize(rx_buf, sizeof(rx_buf), loan.buf, 0, loan.len);
+	zassert_equal(len, STRLEN(TEST_STR2), "linearize failed");
+	zassert_mem_equal(rx_buf, TEST_STR2, STRLEN(TEST_STR2),
+			  "invalid rx data");
+
+	zsock_recv_zerocopy_release(&loan);
+	zassert_is_null(loan.pkt, "loan not cleared");
+
+	/* Releasing an empty loan is a no-op */
+	zsock_recv_zerocopy_release(&loan);
+
+	len = zsock_recv_zerocopy(server_sock, &loan, MSG_DONTWAIT, NULL, NULL);
+	zassert_equal(len, -1, "zero-copy recv succeeded on empty socket");
+	zassert_equal(errno, EAGAIN, "invalid errno (%d)", errno);
+
+	rv = close(client_sock);
+	zassert_equal(rv, 0, "close failed");
+	rv = close(server_sock);
+	zassert_equal(rv, 0, "close failed");
+}
+
 ZTEST_SUITE(net_socket_udp, NULL, NULL, NULL, NULL, NULL);
@@ -53,6 +53,19 @@ static uint8_t temp_recv_buf[MAX_RECV_BUF_LEN + EXTRA_BUF_SPACE];
 static uint8_t feed_buf[MAX_RECV_BUF_LEN + EXTRA_BUF_SPACE];
 static size_t test_msg_len;
 
+/* Number of chunks and bytes received of the last message sent */
+static int test_chunks;
+static size_t test_received_len;
+
+/* Is the message sent by the send tests compressed */
+static bool test_deflate;
+#if defined(CONFIG_WEBSOCKET_DEFLATE)
+static struct websocket_deflate tx_deflate;
+static struct websocket_deflate rx_deflate;
+#endif
+
+static struct test_data test_data;
+
 static int test_fd_alloc(void *obj)
 {
 	int fd;
@@ -69,7 +82,6 @@ static int test_recv_buf(uint8_t *feed_buf, size_t feed_len,
 			 uint32_t *msg_type, uint64_t *remaining,
 			 uint8_t *recv_buf, size_t recv_len)
 {
-	static struct test_data test_data;
 	int fd, ret;
 
 	test_data.ctx = ctx;
@@ -308,71 +320,95 @@ ZTEST(net_websocket, test_recv_two_msg)
 	test_recv_2(sizeof(frame1) + FRAME1_HDR_SIZE / 2);
 }
 
+/* Called for each chunk of a message sent by websocket_send_msg(), only the
+ * first one comes with the header. The chunks are fed to a receiving context
+ * which must give back the original message.
+ */
 int verify_sent_and_received_msg(struct msghdr *msg, bool split_msg)
 {
 	static struct websocket_context ctx;
+	static uint64_t remaining;
+	const struct iovec *data = &msg->msg_iov[msg->msg_iovlen - 1];
 	uint32_t msg_type = -1;
-	uint64_t remaining = -1;
-	size_t split_len = 0, total_read = 0;
+	size_t hdr_len = 0;
+	size_t fed = 0;
 	int ret;
 
-	memset(&ctx, 0, sizeof(ctx));
+	if (msg->msg_iovlen > 1) {
+		memset(&ctx, 0, sizeof(ctx));
 
-	ctx.recv_buf.buf = temp_recv_buf;
-	ctx.recv_buf.size = sizeof(temp_recv_buf);
+		ctx.recv_buf.buf = temp_recv_buf;
+		ctx.recv_buf.size = sizeof(temp_recv_buf);
 
-	/* Read first the header */
-	ret = test_recv_buf(msg->msg_iov[0].iov_base,
-			    msg->msg_iov[0].iov_len,
-			    &ctx, &msg_type, &remaining,
-			    recv_buf, sizeof(recv_buf));
-	if (remaining > 0) {
-		zassert_equal(ret, -EAGAIN, "Msg header not found");
-	} else {
-		zassert_equal(ret, 0, "Msg header read error (ret %d)", ret);
-	}
+#if defined(CONFIG_WEBSOCKET_DEFLATE)
+		if (test_deflate) {
+			memset(&rx_deflate, 0, sizeof(rx_deflate));
+			ctx.deflate = &rx_deflate;
+			ctx.deflate_enabled = true;
+		}
+#endif
 
-	/* Then the first split if it is enabled */
-	if (split_msg) {
-		split_len = msg->msg_iov[1].iov_len / 2;
+		hdr_len = msg->msg_iov[0].iov_len;
+		remaining = -1;
+		test_chunks = 0;
+		test_received_len = 0;
 
-		ret = test_recv_buf(msg->msg_iov[1].iov_base,
-				    split_len,
+		zassert_equal(!!(((uint8_t *)msg->msg_iov[0].iov_base)[0] & BIT(6)),
+			      test_deflate, "Invalid RSV1 bit");
+
+		/* Read first the header */
+		ret = test_recv_buf(msg->msg_iov[0].iov_base, hdr_len,
 				    &ctx, &msg_type, &remaining,
 				    recv_buf, sizeof(recv_buf));
-		zassert_true(ret > 0, "Cannot read data (%d)", ret);
-
-		total_read = ret;
+		if (remaining > 0) {
+			zassert_equal(ret, -EAGAIN, "Msg header not found");
+		} else {
+			zassert_equal(ret, 0, "Msg header read error (ret %d)", ret);
+		}
 	}
 
-	/* Then the data */
-	while (remaining > 0) {
-		ret = test_recv_buf((uint8_t *)msg->msg_iov[1].iov_base +
-								total_read,
-				    msg->msg_iov[1].iov_len - total_read,
+	test_chunks++;
+
+	/* Then the data, only the first half at first if the split is
+	 * enabled. A compressed message is returned once it is complete.
+	 */
+	while (fed < data->iov_len) {
+		size_t len = data->iov_len - fed;
+
+		if (split_msg && fed == 0) {
+			len = MAX(len / 2, 1);
+		}
+
+		ret = test_recv_buf((uint8_t *)data->iov_base + fed, len,
 				    &ctx, &msg_type, &remaining,
-				    recv_buf, sizeof(recv_buf));
-		zassert_true(ret > 0, "Cannot read data (%d)", ret);
+				    &recv_buf[test_received_len],
+				    sizeof(recv_buf) - test_received_len);
+		zassert_true(ret >= 0 || ret == -EAGAIN,
+			     "Cannot read data (%d)", ret);
+		zassert_true(test_data.input_pos > 0, "Data not consumed");
 
-		if (memcmp(recv_buf, lorem_ipsum + total_read, ret) != 0) {
-			LOG_HEXDUMP_ERR(lorem_ipsum + total_read, ret,
+		fed += test_data.input_pos;
+
+		if (ret <= 0) {
+			continue;
+		}
+
+		if (memcmp(&recv_buf[test_received_len],
+			   lorem_ipsum + test_received_len, ret) != 0) {
+			LOG_HEXDUMP_ERR(lorem_ipsum + test_received_len, ret,
 					"Received message should be");
-			LOG_HEXDUMP_ERR(recv_buf, ret, "but it was instead");
+			LOG_HEXDUMP_ERR(&recv_buf[test_received_len], ret,
+					"but it was instead");
 			zassert_true(false, "Invalid received message "
-				     "after %d bytes", total_read);
+				     "after %zd bytes", test_received_len);
 		}
 
-		total_read += ret;
+		test_received_len += ret;
 	}
 
-	zassert_equal(total_read, test_msg_len,
-		      "Msg body not valid, received %d instead of %zd",
-		      total_read, test_msg_len);
-
-	NET_DBG("Received %zd header and %zd body",
-		msg->msg_iov[0].iov_len, total_read);
+	NET_DBG("Received %zd header and %zd body", hdr_len, data->iov_len);
 
-	return msg->msg_iov[0].iov_len + total_read;
+	return hdr_len + data->iov_len;
 }
 
 ZTEST(net_websocket, test_send_and_recv_lorem_ipsum)
@@ -394,10 +430,201 @@ ZTEST(net_websocket, test_send_and_recv_lorem_ipsum)
 	zassert_equal(ret, test_msg_len,
 		      "Should have sent %zd bytes but sent %d instead",
 		      test_msg_len, ret);
+	zassert_equal(test_received_len, test_msg_len,
+		      "Received %zd bytes instead of %zd",
+		      test_received_len, test_msg_len);
 
 	z_free_fd(fd);
 }
 
+/* A message longer than the TX buffer is masked and sent in several chunks,
+ * the masking key must be rotated to the offset of each chunk.
+ */
+ZTEST(net_websocket, test_send_and_recv_masked_chunks)
+{
+	static struct websocket_context ctx;
+	int fd, ret;
+
+	memset(&ctx, 0, sizeof(ctx));
+
+	ctx.recv_buf.buf = temp_recv_buf;
+	ctx.recv_buf.size = sizeof(temp_recv_buf);
+
+	/* Not a multiple of the chunk size nor of the key length */
+	test_msg_len = MIN(sizeof(lorem_ipsum) - 1,
+			   2 * CONFIG_WEBSOCKET_TX_BUF_SIZE + 3);
+	zassert_true(test_msg_len > CONFIG_WEBSOCKET_TX_BUF_SIZE,
+		     "Message fits in the TX buffer");
+
+	fd = test_fd_alloc(&ctx);
+	ret = websocket_send_msg(fd, lorem_ipsum, test_msg_len,
+				 WEBSOCKET_OPCODE_DATA_BINARY, true, true,
+				 SYS_FOREVER_MS);
+	zassert_equal(ret, test_msg_len,
+		      "Should have sent %zd bytes but sent %d instead",
+		      test_msg_len, ret);
+	zassert_equal(test_chunks,
+		      DIV_ROUND_UP(test_msg_len, CONFIG_WEBSOCKET_TX_BUF_SIZE),
+		      "Invalid number of chunks (%d)", test_chunks);
+	zassert_equal(test_received_len, test_msg_len,
+		      "Received %zd bytes instead of %zd",
+		      test_received_len, test_msg_len);
+
+	z_free_fd(fd);
+}
+
+#if defined(CONFIG_WEBSOCKET_DEFLATE)
+ZTEST(net_websocket, test_send_and_recv_deflate)
+{
+	static struct websocket_context ctx;
+	int fd, ret;
+
+	memset(&ctx, 0, sizeof(ctx));
+
+	ctx.recv_buf.buf = temp_recv_buf;
+	ctx.recv_buf.size = sizeof(temp_recv_buf);
+	ctx.deflate = &tx_deflate;
+	ctx.deflate->client_window_bits = 15;
+	ctx.deflate_enabled = true;
+
+	test_msg_len = sizeof(lorem_ipsum) - 1;
+	test_deflate = true;
+
+	fd = test_fd_alloc(&ctx);
+	ret = websocket_send_msg(fd, lorem_ipsum, test_msg_len,
+				 WEBSOCKET_OPCODE_DATA_TEXT, true, true,
+				 SYS_FOREVER_MS);
+	zassert_equal(ret, test_msg_len,
+		      "Should have sent %zd bytes but sent %d instead",
+		      test_msg_len, ret);
+	zassert_equal(test_received_len, test_msg_len,
+		      "Received %zd bytes instead of %zd",
+		      test_received_len, test_msg_len);
+
+	test_deflate = false;
+
+	z_free_fd(fd);
+}
+
+/* Compressed message generated by zlib, split into two frames with a ping
+ * frame in between.
+ */
+static const char deflate_msg[] =
+	"{\"temperature\":23.5,\"humidity\":41.2,"
+	"\"temperature\":23.5,\"humidity\":41.2}";
+
+static const unsigned char deflate_frames[] = {
+	/* Text, RSV1 set, not final */
+	0xc1, 0x14, 0xaa, 0x56, 0x2a, 0x49, 0xcd, 0x2d, 0x48,
+	0x2d, 0x4a, 0x2c, 0x29, 0x2d, 0x4a, 0x55, 0xb2, 0x32,
+	0x32, 0xd6, 0x33, 0xd5,
+	/* Ping */
+	0x89, 0x00,
+	/* Continuation, final */
+	0x80, 0x15, 0x51, 0xca, 0x28, 0xcd, 0xcd, 0x4c, 0xc9,
+	0x2c, 0xa9, 0x54, 0xb2, 0x32, 0x31, 0xd4, 0x33, 0xd2,
+	0x21, 0xac, 0xa4, 0x16, 0x00
+};
+
+ZTEST(net_websocket, test_recv_deflate_fragmented)
+{
+	static struct websocket_context ctx;
+	const size_t msg_len = sizeof(deflate_msg) - 1;
+	const size_t part_len = 10;
+	uint32_t msg_type = -1;
+	uint64_t remaining = -1;
+	int ret;
+
+	memset(&ctx, 0, sizeof(ctx));
+
+	ctx.recv_buf.buf = temp_recv_buf;
+	ctx.recv_buf.size = sizeof(temp_recv_buf);
+	memset(&rx_deflate, 0, sizeof(rx_deflate));
+	ctx.deflate = &rx_deflate;
+	ctx.deflate_enabled = true;
+
+	memcpy(feed_buf, deflate_frames, sizeof(deflate_frames));
+
+	/* The control frame is returned while the message is incomplete */
+	ret = test_recv_buf(feed_buf, sizeof(deflate_frames), &ctx, &msg_type,
+			    &remaining, recv_buf, sizeof(recv_buf));
+	zassert_equal(ret, 0, "Ping not empty (ret %d)", ret);
+	zassert_equal(msg_type & WEBSOCKET_FLAG_PING, WEBSOCKET_FLAG_PING,
+		      "Msg is not ping");
+
+	/* Then the decompressed message, in a buffer too small for it */
+	ret = test_recv_buf(feed_buf, 0, &ctx, &msg_type, &remaining,
+			    recv_buf, part_len);
+	zassert_equal(ret, part_len, "Invalid amount of data read (%d)", ret);
+	zassert_equal(remaining, msg_len - part_len, "Invalid remaining");
+	zassert_equal(msg_type & WEBSOCKET_FLAG_TEXT, WEBSOCKET_FLAG_TEXT,
+		      "Msg is not text");
+
+	ret = test_recv_buf(feed_buf, 0, &ctx, &msg_type, &remaining,
+			    &recv_buf[part_len], sizeof(recv_buf) - part_len);
+	zassert_equal(ret, msg_len - part_len,
+		      "Invalid amount of data read (%d)", ret);
+	zassert_equal(remaining, 0, "Msg not empty");
+	zassert_true(msg_type & WEBSOCKET_FLAG_FINAL, "Msg is not final");
+	zassert_mem_equal(recv_buf, deflate_msg, msg_len,
+			  "Invalid decompressed message");
+}
+
+/* A compressed message too long to be decompressed is dropped, the next
+ * message must still be received.
+ */
+ZTEST(net_websocket, test_recv_deflate_too_long)
+{
+	static struct websocket_context ctx;
+	static uint8_t input[4 + CONFIG_WEBSOCKET_DEFLATE_BUF_SIZE + 1 +
+			     sizeof(frame1)];
+	const size_t frame1_msg_len = sizeof(frame1_msg) - 1;
+	const size_t too_long = CONFIG_WEBSOCKET_DEFLATE_BUF_SIZE + 1;
+	uint32_t msg_type = -1;
+	uint64_t remaining = -1;
+	size_t pos = 0;
+	int ret;
+
+	memset(&ctx, 0, sizeof(ctx));
+
+	ctx.recv_buf.buf = temp_recv_buf;
+	ctx.recv_buf.size = sizeof(temp_recv_buf);
+	memset(&rx_deflate, 0, sizeof(rx_deflate));
+	ctx.deflate = &rx_deflate;
+	ctx.deflate_enabled = true;
+
+	/* Text, RSV1 set, final, unmasked, 16 bit length. The payload is
+	 * never decompressed, so its content does not matter.
+	 */
+	memset(input, 0, sizeof(input));
+	input[0] = 0xc1;
+	input[1] = 126;
+	input[2] = too_long >> 8;
+	input[3] = too_long;
+	memcpy(&input[4 + too_long], frame1, sizeof(frame1));
+
+	do {
+		ret = test_recv_buf(&input[pos], sizeof(input) - pos, &ctx,
+				    &msg_type, &remaining, recv_buf,
+				    sizeof(recv_buf));
+		pos += test_data.input_pos;
+	} while (ret == -EAGAIN && pos < sizeof(input));
+
+	zassert_equal(ret, -EMSGSIZE, "Too long msg not dropped (ret %d)", ret);
+
+	ret = test_recv_buf(&input[pos], sizeof(input) - pos, &ctx, &msg_type,
+			    &remaining, recv_buf, sizeof(recv_buf));
+	zassert_equal(ret, frame1_msg_len, "Invalid amount of data read (%d)",
+		      ret);
+	zassert_mem_equal(recv_buf, frame1_msg, frame1_msg_len,
+			  "Invalid message, should be '%s' was '%s'",
+			  frame1_msg, recv_buf);
+	zassert_equal(remaining, 0, "Msg not empty");
+	zassert_equal(msg_type & WEBSOCKET_FLAG_TEXT, WEBSOCKET_FLAG_TEXT,
+		      "Msg is not text");
+}
+#endif /* CONFIG_WEBSOCKET_DEFLATE */
+
 ZTEST(net_websocket, test_recv_two_large_split_msg)
 {
 	static struct websocket_context ctx;
@@ -417,6 +644,9 @@ ZTEST(net_websocket, test_recv_two_large_split_msg)
 	zassert_equal(ret, test_msg_len,
 		      "1st should have sent %zd bytes but sent %d instead",
 		      test_msg_len, ret);
+	zassert_equal(test_received_len, test_msg_len,
+		      "Received %zd bytes instead of %zd",
+		      test_received_len, test_msg_len);
 
 	z_free_fd(fd);
 }
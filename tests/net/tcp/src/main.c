@@ -125,6 +125,7 @@ static void handle_syn_resend(void);
 static void handle_client_fin_wait_2_test(sa_family_t af, struct tcphdr *th);
 static void handle_client_closing_test(sa_family_t af, struct tcphdr *th);
 static void handle_server_recv_out_of_order(struct net_pkt *pkt);
+static void handle_client_tx_bulk_test(struct net_pkt *pkt, struct tcphdr *th);
 
 static void verify_flags(struct tcphdr *th, uint8_t flags,
 			 const char *fun, int line)
@@ -269,7 +270,12 @@ static struct net_pkt *tester_prepare_tcp_pkt(sa_family_t af,
 	}
 
 	th->th_flags = flags;
-	th->th_win = NET_IPV6_MTU;
+	if (test_case_no == 10U) {
+		/* Let several full sized segments be in flight */
+		th->th_win = htons(NET_IPV6_MTU);
+	} else {
+		th->th_win = NET_IPV6_MTU;
+	}
 	th->th_seq = htonl(seq);
 
 	if (ACK & flags) {
@@ -420,6 +426,9 @@ static int tester_send(const struct device *dev, struct net_pkt *pkt)
 	case 9:
 		handle_server_recv_out_of_order(pkt);
 		break;
+	case 10:
+		handle_client_tx_bulk_test(pkt, &th);
+		break;
 	default:
 		zassert_true(false, "Undefined test case");
 	}
@@ -1539,4 +1548,178 @@ ZTEST(net_tcp, test_server_out_of_order_data)
 	test_server_timeout_out_of_order_data();
 }
 
+#define TX_BULK_DATA_LEN (sizeof(lorem_ipsum) - 1)
+static uint8_t tx_bulk_data[TX_BULK_DATA_LEN];
+static uint32_t tx_bulk_seq;
+static size_t tx_bulk_received;
+
+static void handle_client_tx_bulk_test(struct net_pkt *pkt, struct tcphdr *th)
+{
+	sa_family_t af = net_pkt_family(pkt);
+	struct net_pkt *reply;
+	size_t offset;
+	size_t len;
+	int ret;
+
+	switch (t_state) {
+	case T_SYN:
+		test_verify_flags(th, SYN);
+		seq = 0U;
+		ack = ntohl(th->th_seq) + 1U;
+		tx_bulk_seq = ack;
+		tx_bulk_received = 0;
+		reply = prepare_syn_ack_packet(af, htons(MY_PORT),
+					       th->th_sport);
+		seq++;
+		t_state = T_SYN_ACK;
+		break;
+	case T_SYN_ACK:
+		test_verify_flags(th, ACK);
+		/* connection is success */
+		t_state = T_DATA;
+		test_sem_give();
+		return;
+	case T_DATA:
+		test_verify_flags(th, PSH | ACK);
+
+		ret = net_pkt_skip(pkt, net_pkt_ip_hdr_len(pkt) +
+				   net_pkt_ip_opts_len(pkt) + th->th_off * 4U);
+		if (ret < 0) {
+			goto fail;
+		}
+
+		len = net_pkt_remaining_data(pkt);
+		offset = ntohl(th->th_seq) - tx_bulk_seq;
+		zassert_true(offset + len <= TX_BULK_DATA_LEN,
+			     "Segment out of the sent data");
+
+		ret = net_pkt_read(pkt, &tx_bulk_data[offset], len);
+		if (ret < 0) {
+			goto fail;
+		}
+
+		tx_bulk_received = MAX(tx_bulk_received, offset + len);
+		ack = tx_bulk_seq + tx_bulk_received;
+		reply = prepare_ack_packet(af, htons(MY_PORT), th->th_sport);
+
+		if (tx_bulk_received == TX_BULK_DATA_LEN) {
+			t_state = T_FIN;
+		}
+		break;
+	case T_FIN:
+		test_verify_flags(th, FIN | ACK);
+		ack = ack + 1U;
+		t_state = T_FIN_ACK;
+		reply = prepare_fin_ack_packet(af, htons(MY_PORT),
+					       th->th_sport);
+		break;
+	case T_FIN_ACK:
+		test_verify_flags(th, ACK);
+		test_sem_give();
+		return;
+	default:
+		zassert_true(false, "%s unexpected state", __func__);
+		return;
+	}
+
+	ret = net_recv_data(iface, reply);
+	if (ret < 0) {
+		goto fail;
+	}
+
+	/* All the data is acknowledged */
+	if (t_state == T_FIN && th->th_flags == (PSH | ACK)) {
+		test_sem_give();
+	}
+
+	return;
+fail:
+	zassert_true(false, "%s failed", __func__);
+}
+
+/* Test case scenario IPv4
+ *   send SYN,
+ *   expect SYN ACK,
+ *   send ACK,
+ *   send data spanning many full sized segments,
+ *   expect ACK for each segment,
+ *   send FIN,
+ *   expect FIN ACK,
+ *   send ACK.
+ *   The data must arrive intact whether or not the segments are allocated
+ *   in bulk, see CONFIG_NET_TCP_TX_BULK_COUNT.
+ */
+ZTEST(net_tcp, test_client_tx_bulk_ipv4)
+{
+	struct net_context *ctx;
+#if defined(CONFIG_NET_STATISTICS_PKT_ALLOC) && CONFIG_NET_TCP_TX_BULK_COUNT > 1
+	net_stats_t bulk_allocs;
+#endif
+	size_t sent;
+	int ret;
+
+	t_state = T_SYN;
+	test_case_no = 10;
+	seq = ack = 0;
+	memset(tx_bulk_data, 0, sizeof(tx_bulk_data));
+
+	ret = net_context_get(AF_INET, SOCK_STREAM, IPPROTO_TCP, &ctx);
+	if (ret < 0) {
+		zassert_true(false, "Failed to get net_context");
+	}
+
+	net_context_ref(ctx);
+
+	ret = net_context_connect(ctx, (struct sockaddr *)&peer_addr_s,
+				  sizeof(struct sockaddr_in),
+				  NULL,
+				  K_MSEC(100), NULL);
+	if (ret < 0) {
+		zassert_true(false, "Failed to connect to peer");
+	}
+
+	/* Peer will release the semaphore after it receives
+	 * proper ACK to SYN | ACK
+	 */
+	test_sem_take(K_MSEC(100), __LINE__);
+
+#if defined(CONFIG_NET_STATISTICS_PKT_ALLOC) && CONFIG_NET_TCP_TX_BULK_COUNT > 1
+	bulk_allocs = net_stats.tx_alloc.bulk_allocs;
+#endif
+
+	/* Each call queues several full sized segments at most */
+	for (sent = 0; sent < TX_BULK_DATA_LEN; sent += ret) {
+		ret = net_context_send(ctx, &lorem_ipsum[sent],
+				       TX_BULK_DATA_LEN - sent, NULL,
+				       K_NO_WAIT, NULL);
+		zassert_true(ret > 0, "Failed to send data to peer (%d)", ret);
+	}
+
+	/* Peer will release the semaphore after it has ACKed all the data */
+	test_sem_take(K_MSEC(1000), __LINE__);
+
+	zassert_mem_equal(tx_bulk_data, lorem_ipsum, TX_BULK_DATA_LEN,
+			  "Invalid data received");
+
+#if defined(CONFIG_NET_STATISTICS_PKT_ALLOC) && CONFIG_NET_TCP_TX_BULK_COUNT > 1
+	zassert_true(net_stats.tx_alloc.bulk_allocs > bulk_allocs,
+		     "Segments not allocated in bulk");
+#endif
+
+	/* Let the receiving thread process the last ACK */
+	k_msleep(50);
+
+	net_context_put(ctx);
+
+	/* Peer will release the semaphore after it receives
+	 * proper ACK to FIN | ACK
+	 */
+	test_sem_take(K_MSEC(100), __LINE__);
+
+	/* Connection is in TIME_WAIT state, context will be released
+	 * after K_MSEC(CONFIG_NET_TCP_TIME_WAIT_DELAY), so wait for it.
+	 */
+	k_sleep(K_MSEC(CONFIG_NET_TCP_TIME_WAIT_DELAY));
+}
+
 ZTEST_SUITE(net_tcp, NULL, presetup, NULL, NULL, NULL);
@@ -921,6 +921,70 @@ ZTEST(test_utils_fn, test_ip_checksum)
 				      "Mismatch between reference and calculated checksum 3\n");
 		}
 	}
+
+	/* All ones data keeps the 64-bit sum close to the wrap around */
+	(void)memset(testdata, 0xff, sizeof(testdata));
+
+	for (int offset = 0; offset < 8; offset++) {
+		for (int length = 1; length <= 64; length++) {
+			sum_got = calc_chksum_ref(0U, testdata + offset, length);
+			sum_exp = calc_chksum(0U, testdata + offset, length);
+
+			zassert_equal(sum_got, sum_exp,
+				      "Mismatch between reference and calculated checksum 4\n");
+		}
+	}
+
+	sum_got = calc_chksum_ref(0U, testdata, CHECKSUM_TEST_LENGTH - 2);
+	sum_exp = calc_chksum(0U, testdata, CHECKSUM_TEST_LENGTH - 2);
+
+	zassert_equal(sum_got, sum_exp,
+		      "Mismatch between reference and calculated checksum 5\n");
+}
+
+#define CHECKSUM_COPY_TEST_LENGTH 64
+
+ZTEST(test_utils_fn, test_ip_checksum_copy)
+{
+	static uint8_t dst[CHECKSUM_TEST_LENGTH + 8];
+	uint16_t sum_got;
+	uint16_t sum_exp;
+
+	for (int i = 0; i < CHECKSUM_TEST_LENGTH; i++) {
+		testdata[i] = (uint8_t)(i + 7) * 29;
+	}
+
+	for (int i = 1; i <= CHECKSUM_TEST_LENGTH; i++) {
+		memset(dst, 0, sizeof(dst));
+
+		sum_exp = calc_chksum_ref(i ^ 0x2a5b, testdata, i);
+		sum_got = calc_chksum_copy(i ^ 0x2a5b, dst, testdata, i);
+
+		zassert_equal(sum_got, sum_exp,
+			      "Mismatch between reference and copy checksum 1\n");
+		zassert_mem_equal(dst, testdata, i, "Data not copied\n");
+		zassert_equal(dst[i], 0, "Data copied past the end\n");
+	}
+
+	/* All combinations of source and destination alignment */
+	for (int src_off = 0; src_off < 8; src_off++) {
+		for (int dst_off = 0; dst_off < 8; dst_off++) {
+			for (int length = 1; length <= CHECKSUM_COPY_TEST_LENGTH;
+			     length++) {
+				memset(dst, 0, sizeof(dst));
+
+				sum_exp = calc_chksum_ref(length, testdata + src_off,
+							  length);
+				sum_got = calc_chksum_copy(length, dst + dst_off,
+							   testdata + src_off, length);
+
+				zassert_equal(sum_got, sum_exp,
+					      "Mismatch between reference and copy checksum 2\n");
+				zassert_mem_equal(dst + dst_off, testdata + src_off,
+						  length, "Data not copied\n");
+			}
+		}
+	}
 }
 
 ZTEST_SUITE(test_utils_fn, NULL, NULL, NULL, NULL, NULL);